@@ -57,6 +57,10 @@ typedef struct SBlockOrderInfo {
 
 #define BitmapLen(_n) (((_n) + ((1 << NBIT) - 1)) >> NBIT)
 
+// version of the block encoding, the first field of an encoded block
+#define BLOCK_VERSION_1          1
+#define BLOCK_VERSION_COMPRESSED 2  // the data of each column is compressed, see blockCompressEncode
+
 #define colDataGetVarData(p1_, r_) ((p1_)->pData + (p1_)->varmeta.offset[(r_)])
 
 #define colDataGetNumData(p1_, r_) ((p1_)->pData + ((r_) * (p1_)->info.bytes))
@@ -233,7 +237,16 @@ size_t blockDataGetRowSize(SSDataBlock* pBlock);
 double blockDataGetSerialRowSize(const SSDataBlock* pBlock);
 size_t blockDataGetSerialMetaSize(uint32_t numOfCols);
 
+typedef struct SSDataBlockSortHelper {
+  SArray*      orderInfo;  // SArray<SBlockOrderInfo>
+  SSDataBlock* pDataBlock;
+} SSDataBlockSortHelper;
+
+int32_t dataBlockCompar(const void* p1, const void* p2, const void* param);
+
 int32_t blockDataSort(SSDataBlock* pDataBlock, SArray* pOrderInfo);
+// rearrange all columns of the block so that row i becomes the original row index[i]
+int32_t blockDataReorder(SSDataBlock* pDataBlock, const int32_t* index);
 int32_t blockDataSort_rv(SSDataBlock* pDataBlock, SArray* pOrderInfo, bool nullFirst);
 
 int32_t colInfoDataEnsureCapacity(SColumnInfoData* pColumn, uint32_t numOfRows, bool clearPayload);
@@ -266,6 +279,12 @@ SColumnInfoData* bdGetColumnInfoData(const SSDataBlock* pBlock, int32_t index);
 int32_t blockEncode(const SSDataBlock* pBlock, char* data, int32_t numOfCols);
 const char* blockDecode(SSDataBlock* pBlock, const char* pData);
 
+// encode with each column compressed by the codec of its type, decoded by blockDecode as well
+int32_t blockCompressEncode(const SSDataBlock* pBlock, char* data, int32_t numOfCols);
+// the length of the block after it is converted into the uncompressed encoding
+int32_t blockGetDecompressedSize(const char* pData);
+int32_t blockDecompressEncode(const char* pData, char* pOut);
+
 void blockDebugShowDataBlock(SSDataBlock* pBlock, const char* flag);
 void blockDebugShowDataBlocks(const SArray* dataBlocks, const char* flag);
 // for debug
@@ -274,12 +293,28 @@ char* dumpBlockData(SSDataBlock* pDataBlock, const char* flag, char** dumpBuf);
 int32_t buildSubmitReqFromDataBlock(SSubmitReq** pReq, const SSDataBlock* pDataBlocks, STSchema* pTSchema, int32_t vgId,
                                     tb_uid_t suid);
 
+// The columnar SSubmitBlk: the bound columns of a table in the order of its schema, led by the primary key, whose
+// rows are in ascending order of the key. tDecodeSubmitColBlk checks the data, and the columns against pTSchema if
+// given, into an empty pBlock, which is to be freed by blockDataFreeRes even on failure.
+int32_t tGetSubmitColBlkSize(const SSDataBlock* pBlock);
+int32_t tEncodeSubmitColBlk(const SSDataBlock* pBlock, char* pBuf);
+int32_t tDecodeSubmitColBlk(const SSubmitColHead* pHead, int32_t dataLen, const STSchema* pTSchema,
+                            SSDataBlock* pBlock);
+// the tuple row of the schema for a row of a decoded block, the columns out of the block being none
+int32_t tGetSubmitColBlkRowLen(const SSDataBlock* pBlock, const STSchema* pTSchema, int32_t iRow);
+void    tGetSubmitColBlkRow(const SSDataBlock* pBlock, const STSchema* pTSchema, int32_t iRow, STSRow* pRow);
+
 char* buildCtbNameByGroupId(const char* stbName, uint64_t groupId);
 
 static FORCE_INLINE int32_t blockGetEncodeSize(const SSDataBlock* pBlock) {
   return blockDataGetSerialMetaSize(taosArrayGetSize(pBlock->pDataBlock)) + blockDataGetSize(pBlock);
 }
 
+static FORCE_INLINE int32_t blockGetCompressEncodeSize(const SSDataBlock* pBlock) {
+  // the raw length of each column, and the codec may exceed the raw data before it falls back to a copy
+  return blockGetEncodeSize(pBlock) + taosArrayGetSize(pBlock->pDataBlock) * (sizeof(int32_t) + COMP_OVERFLOW_BYTES);
+}
+
 static FORCE_INLINE int32_t blockCompressColData(SColumnInfoData* pColRes, int32_t numOfRows, char* data,
                                                  int8_t compressed) {
   int32_t colSize = colDataGetLength(pColRes, numOfRows);
@@ -50,6 +50,7 @@ extern int32_t tsTagFilterResCacheSize;
 // queue & threads
 extern int32_t tsNumOfRpcThreads;
 extern int32_t tsNumOfCommitThreads;
+extern int32_t tsNumOfCommitFsetThreads;
 extern int32_t tsNumOfTaskQueueThreads;
 extern int32_t tsNumOfMnodeQueryThreads;
 extern int32_t tsNumOfMnodeFetchThreads;
@@ -68,9 +69,11 @@ extern int64_t tsRpcQueueMemoryAllowed;
 extern int32_t tsElectInterval;
 extern int32_t tsHeartbeatInterval;
 extern int32_t tsHeartbeatTimeout;
+extern int32_t tsSnapWindowSize;
 
 // vnode
 extern int64_t tsVndCommitMaxIntervalMs;
+extern int64_t tsVndCompactMaxSpeed;
 
 // monitor
 extern bool     tsEnableMonitor;
@@ -93,6 +96,8 @@ extern char*    tsSvrCrashReportUri;
 // query buffer management
 extern int32_t tsQueryBufferSize;  // maximum allowed usage buffer size in MB for each data node during query processing
 extern int64_t tsQueryBufferSizeBytes;  // maximum allowed usage buffer size in byte for each data node
+extern int32_t tsTsdbBlockCacheSize;    // decompressed file blocks cached by each vnode, in MB
+extern int32_t tsTagColCacheSize;       // columnar tags of super tables cached by each vnode, in MB
 
 // query client
 extern int32_t tsQueryPolicy;
@@ -114,6 +119,7 @@ extern bool    tsUseAdapter;
 extern int32_t tsMinSlidingTime;
 extern int32_t tsMinIntervalTime;
 extern int32_t tsMaxMemUsedByInsert;
+extern int32_t tsMaxMemUsedByPrefetch;
 
 // build info
 extern char version[];
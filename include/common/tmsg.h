@@ -246,6 +246,23 @@ typedef struct SSubmitBlk {
   char    data[];
 } SSubmitBlk;
 
+// The data of a columnar SSubmitBlk, after the schema, holds the columns of its rows instead of the rows. It starts
+// with SSubmitColHead, whose leading STSRow is of type TD_ROW_COL so that it is told from the rows of the blocks
+// written before, and goes on with the columns as blockEncode lays them out. The columns are in ascending order of
+// their ids, led by the primary key, and the rows in ascending order of the key. A column of the schema that is not
+// in the block is none in every row.
+#define SUBMIT_COL_BLK_VER_1 1
+
+typedef struct {
+  uint8_t  head[sizeof(STSRow)];  // an STSRow of type TD_ROW_COL, sver the format version, len the length of the data
+                                  // and ts the first key, see SUBMIT_COL_HEAD_ROW
+  TSKEY    ekey;                  // the last key
+  int32_t  numOfCols;
+  col_id_t colId[];
+} SSubmitColHead;
+
+#define SUBMIT_COL_HEAD_ROW(pHead) ((STSRow*)(pHead)->head)
+
 // Submit message for this TSDB
 typedef struct {
   SMsgHead header;
@@ -280,6 +297,8 @@ int32_t tInitSubmitMsgIter(const SSubmitReq* pMsg, SSubmitMsgIter* pIter);
 int32_t tGetSubmitMsgNext(SSubmitMsgIter* pIter, SSubmitBlk** pPBlock);
 int32_t tInitSubmitBlkIter(SSubmitMsgIter* pMsgIter, SSubmitBlk* pBlock, SSubmitBlkIter* pIter);
 STSRow* tGetSubmitBlkNext(SSubmitBlkIter* pIter);
+// the columns of a columnar block, or NULL if the block holds rows. there are no rows to iterate in a columnar block
+SSubmitColHead* tGetSubmitColHead(SSubmitMsgIter* pMsgIter, SSubmitBlk* pBlock);
 // for debug
 int32_t tPrintFixedSchemaSubmitReq(SSubmitReq* pReq, STSchema* pSchema);
 
@@ -1067,6 +1086,9 @@ typedef struct {
   int64_t numOfBatchInsertReqs;
   int64_t numOfBatchInsertSuccessReqs;
   int64_t errors;
+  int64_t bufPoolChunks;
+  int64_t bufPoolWaste;
+  int64_t bufPoolFallbacks;
 } SVnodesStat;
 
 typedef struct {
@@ -1085,6 +1107,9 @@ typedef struct {
   int64_t numOfInsertSuccessReqs;
   int64_t numOfBatchInsertReqs;
   int64_t numOfBatchInsertSuccessReqs;
+  int64_t bufPoolChunks;     // not sent to mnode, only reported by the monitor
+  int64_t bufPoolWaste;
+  int64_t bufPoolFallbacks;
 } SVnodeLoad;
 
 typedef struct {
@@ -53,6 +53,7 @@ typedef struct STSRow {
 // row type
 #define TD_ROW_TP 0x0U  // default
 #define TD_ROW_KV 0x01U
+#define TD_ROW_COL 0x02U  // not a row, but the head of a columnar submit block, see SSubmitColHead
 
 #define TD_VTYPE_PARTS       4  // PARTITIONS: 1 byte / 2 bits
 #define TD_VTYPE_OPTR        3  // OPERATOR: 4 - 1, utilize to get remainder
@@ -311,6 +312,11 @@ int32_t tdAppendColValToKvRow(SRowBuilder *pBuilder, TDRowValT valType, const vo
                               int8_t colType, int16_t colIdx, int32_t offset, col_id_t colId);
 int32_t tdAppendColValToRow(SRowBuilder *pBuilder, col_id_t colId, int8_t colType, TDRowValT valType, const void *val,
                             bool isCopyVarData, int32_t offset, col_id_t colIdx);
+// Put the values of one fixed length column into nRows tuple rows, which lie rowSize bytes apart. A null value is
+// flagged in pRowHasNull[r] if given, or else in pBuilder->hasNull.
+int32_t tdAppendColValsToTpRows(SRowBuilder *pBuilder, void *pRows, int32_t rowSize, int32_t nRows, int8_t colType,
+                                int16_t colIdx, int32_t offset, const void *pVals, int32_t valStride,
+                                const char *pIsNull, bool *pRowHasNull);
 int32_t tdGetTpRowValOfCol(SCellVal *output, STSRow *pRow, void *pBitmap, int8_t colType, int32_t offset,
                            int16_t colIdx);
 int32_t tdGetKvRowValOfCol(SCellVal *output, STSRow *pRow, void *pBitmap, int32_t offset, int16_t colIdx);
@@ -333,6 +339,9 @@ bool tdSTSRowIterNext(STSRowIter *pIter, SCellVal *pVal);
 
 int32_t tdSTSRowNew(SArray *pArray, STSchema *pTSchema, STSRow **ppRow);
 bool    tdSTSRowGetVal(STSRowIter *pIter, col_id_t colId, col_type_t colType, SCellVal *pVal);
+bool    tdSTpRowGetVal(STSRow *pRow, col_id_t colId, col_type_t colType, int32_t flen, uint32_t offset, col_id_t colIdx,
+                       SCellVal *pVal);
+bool    tdSKvRowGetVal(STSRow *pRow, col_id_t colId, col_id_t colIdx, SCellVal *pVal);
 void    tdSRowPrint(STSRow *row, STSchema *pSchema, const char *tag);
 
 #ifdef __cplusplus
@@ -71,6 +71,29 @@ typedef enum {
  */
 qTaskInfo_t qCreateStreamExecTaskInfo(void* msg, SReadHandle* readers);
 
+typedef struct {
+  char     funcName[TSDB_FUNC_NAME_LEN];
+  col_id_t colId;  // the column aggregated
+} SRollupFunc;
+
+typedef struct {
+  SInterval interval;
+  int64_t   watermark;
+  int64_t   deleteMark;
+  bool      igExpired;
+  SArray*   pFuncs;  // SRollupFunc, in the order of the result columns after _wstart
+} SRollupInfo;
+
+/**
+ * Extract the window and the aggregate functions of a rollup plan, so that the rollup can be computed without the
+ * stream task. Fails with TSDB_CODE_OPS_NOT_SUPPORT if the plan is not an interval aggregate of plain columns. The
+ * caller frees pInfo->pFuncs.
+ * @param msg
+ * @param pInfo
+ * @return
+ */
+int32_t qExtractRollupInfo(const char* msg, SRollupInfo* pInfo);
+
 /**
  * Create the exec task for queue mode
  * @param pMsg
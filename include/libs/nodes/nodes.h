@@ -265,7 +265,8 @@ typedef enum ENodeType {
   QUERY_NODE_PHYSICAL_PLAN_DELETE,
   QUERY_NODE_PHYSICAL_SUBPLAN,
   QUERY_NODE_PHYSICAL_PLAN,
-  QUERY_NODE_PHYSICAL_PLAN_TABLE_COUNT_SCAN
+  QUERY_NODE_PHYSICAL_PLAN_TABLE_COUNT_SCAN,
+  QUERY_NODE_PHYSICAL_PLAN_HASH_JOIN
 } ENodeType;
 
 /**
@@ -397,6 +397,15 @@ typedef struct SSortMergeJoinPhysiNode {
   EOrder     inputTsOrder;
 } SSortMergeJoinPhysiNode;
 
+typedef struct SHashJoinPhysiNode {
+  SPhysiNode node;
+  EJoinType  joinType;
+  SNodeList* pLeftKeys;   // equi-join key columns of the probe (left) side
+  SNodeList* pRightKeys;  // equi-join key columns of the build (right) side
+  SNode*     pOnConditions;
+  SNodeList* pTargets;
+} SHashJoinPhysiNode;
+
 typedef struct SAggPhysiNode {
   SPhysiNode node;
   SNodeList* pExprs;  // these are expression list of group_by_clause and parameter expression of aggregate function
@@ -97,6 +97,18 @@ typedef struct {
 } SWalCkHead;
 #pragma pack(pop)
 
+// entries appended in group commit mode, written to the files in one write each and synced once per batch
+typedef struct {
+  char   *pIdx;
+  int64_t idxLen;
+  int64_t idxCap;
+  int64_t idxOffset;  // file offset of the first buffered idx entry
+  char   *pLog;
+  int64_t logLen;
+  int64_t logCap;
+  int64_t logOffset;  // file offset of the first buffered log entry
+} SWalWriteBuf;
+
 typedef struct SWal {
   // cfg
   SWalCfg cfg;
@@ -119,6 +131,12 @@ typedef struct SWal {
   SHashObj *pRefHash;  // refId -> SWalRef
   // path
   char path[WAL_PATH_LEN];
+  // group commit
+  SWalWriteBuf writeBuf;
+  TdThreadCond commitCond;
+  int8_t       committing;  // a fsync is running outside the mutex
+  int64_t      flushedVer;  // entries up to this ver are written to the files
+  int64_t      syncedVer;   // entries up to this ver are synced
   // reusable write head
   SWalCkHead writeHead;
 } SWal;
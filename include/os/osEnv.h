@@ -40,6 +40,7 @@ extern char            tsSIMDBuiltins;
 extern char            tsSSE42Enable;
 extern char            tsAVXEnable;
 extern char            tsAVX2Enable;
+extern char            tsAVX512Enable;
 extern char            tsFMAEnable;
 
 extern char configDir[];
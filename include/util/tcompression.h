@@ -123,6 +123,16 @@ int32_t tsCompressBigint(void *pIn, int32_t nIn, int32_t nEle, void *pOut, int32
 int32_t tsDecompressBigint(void *pIn, int32_t nIn, int32_t nEle, void *pOut, int32_t nOut, uint8_t cmprAlg, void *pBuf,
                            int32_t nBuf);
 
+// lossless codecs of float and double, whether or not the lossy compression of stored data is on
+int32_t tsCompressFloatLossless(void *pIn, int32_t nIn, int32_t nEle, void *pOut, int32_t nOut, uint8_t cmprAlg,
+                                void *pBuf, int32_t nBuf);
+int32_t tsDecompressFloatLossless(void *pIn, int32_t nIn, int32_t nEle, void *pOut, int32_t nOut, uint8_t cmprAlg,
+                                  void *pBuf, int32_t nBuf);
+int32_t tsCompressDoubleLossless(void *pIn, int32_t nIn, int32_t nEle, void *pOut, int32_t nOut, uint8_t cmprAlg,
+                                 void *pBuf, int32_t nBuf);
+int32_t tsDecompressDoubleLossless(void *pIn, int32_t nIn, int32_t nEle, void *pOut, int32_t nOut, uint8_t cmprAlg,
+                                   void *pBuf, int32_t nBuf);
+
 /*************************************************************************
  *                  STREAM COMPRESSION
  *************************************************************************/
@@ -146,7 +146,7 @@ bool isAllDataInMemBuf(const SDiskbasedBuf* pBuf);
 void setBufPageDirty(void* pPage, bool dirty);
 
 /**
- * Set the compress/ no-compress flag for paged buffer, when flushing data in disk.
+ * Set the compress/ no-compress flag for paged buffer, when flushing data in disk. Pages are compressed by default.
  * @param pBuf
  */
 void setBufPageCompressOnDisk(SDiskbasedBuf* pBuf, bool comp);
@@ -33,6 +33,8 @@ Notes:
 1: taosOpenQueue/taosCloseQueue, taosOpenQset/taosCloseQset is NOT multi-thread safe
 2: after taosCloseQueue/taosCloseQset is called, read/write operation APIs are not safe.
 3: read/write operation APIs are multi-thread safe
+4: writers never block, items are linked into an intrusive MPSC list (Dmitry Vyukov's algorithm), readers
+   of the same queue are serialized by the queue mutex; qset readers only touch the semaphore when idle
 
 To remove the limitation and make this set of queue APIs multi-thread safe, REF(tref.c)
 shall be used to set up the protection.
@@ -73,17 +75,20 @@ typedef struct STaosQnode {
 } STaosQnode;
 
 typedef struct STaosQueue {
-  STaosQnode   *head;
-  STaosQnode   *tail;
+  STaosQnode   *head;     // consumer side, protected by mutex
+  STaosQnode   *stub;     // dummy node which keeps the list non-empty
   STaosQueue   *next;     // for queue set
   STaosQset    *qset;     // for queue set
   void         *ahandle;  // for queue set
   FItem         itemFp;
   FItems        itemsFp;
-  TdThreadMutex mutex;
+  TdThreadMutex mutex;    // serializes consumers only
+  int64_t       threadId;
+  char          pad1[64];
+  STaosQnode   *tail;  // producer side, swapped atomically
   int64_t       memOfItems;
   int32_t       numOfItems;
-  int64_t       threadId;
+  char          pad2[64];
 } STaosQueue;
 
 typedef struct STaosQset {
@@ -93,6 +98,8 @@ typedef struct STaosQset {
   tsem_t        sem;
   int32_t       numOfQueues;
   int32_t       numOfItems;
+  int32_t       numOfSleepers;  // readers registered to wait on sem
+  int32_t       numOfResumes;   // pending taosQsetThreadResume calls
 } STaosQset;
 
 typedef struct STaosQall {
@@ -129,6 +136,14 @@ int32_t    taosGetQueueNumber(STaosQset *qset);
 
 int32_t taosReadQitemFromQset(STaosQset *qset, void **ppItem, SQueueInfo *qinfo);
 int32_t taosReadAllQitemsFromQset(STaosQset *qset, STaosQall *qall, SQueueInfo *qinfo);
+
+// for readers which keep their own backlog: read without blocking, block until an item may be
+// ready or pendingFp reports backlog (returns 0 once taosQsetThreadResume is consumed), and wake
+// one blocked reader after adding to the backlog
+typedef bool (*FPending)(void *param);
+int32_t taosTryReadQitemFromQset(STaosQset *qset, void **ppItem, SQueueInfo *qinfo);
+int32_t taosWaitQset(STaosQset *qset, FPending pendingFp, void *param);
+void    taosQsetWakeup(STaosQset *qset);
 void    taosResetQsetThread(STaosQset *qset, void *pItem);
 
 extern int64_t tsRpcQueueMemoryAllowed;
@@ -26,11 +26,36 @@ extern "C" {
 typedef struct SQWorkerPool SQWorkerPool;
 typedef struct SWWorkerPool SWWorkerPool;
 
+typedef enum {
+  QWORKER_LANE_HIGH = 0,  // short, latency sensitive items
+  QWORKER_LANE_LOW,       // long running or background items
+  QWORKER_LANE_MAX,
+} EQWorkerLane;
+
+// returns the lane of an item, items with the same non-zero affinity prefer the same worker
+typedef int32_t (*FItemLane)(void *pItem, int64_t *affinity);
+
+typedef struct {
+  void      *pItem;
+  SQueueInfo qinfo;
+  int32_t    lane;
+} SQWorkItem;
+
+typedef struct {
+  TdThreadMutex mutex;
+  SQWorkItem   *items;  // ring buffer, the owner pops the front, thieves steal the back
+  int32_t       capacity;
+  int32_t       head;
+  int32_t       size;
+} SQWorkDeque;
+
 typedef struct SQWorker {
-  int32_t  id;      // worker id
-  int64_t  pid;     // thread pid
-  TdThread thread;  // thread id
-  void    *pool;
+  int32_t     id;      // worker id
+  int64_t     pid;     // thread pid
+  TdThread    thread;  // thread id
+  void       *pool;
+  int32_t     highInRow;  // high lane items run since the low lane was last looked at
+  SQWorkDeque lanes[QWORKER_LANE_MAX];
 } SQWorker;
 
 typedef struct SQWorkerPool {
@@ -41,6 +66,7 @@ typedef struct SQWorkerPool {
   const char   *name;
   SQWorker     *workers;
   TdThreadMutex mutex;
+  FItemLane     laneFp;  // optional, all items go to the high lane of the reading worker if not set
 } SQWorkerPool;
 
 typedef struct SAutoQWorkerPool {
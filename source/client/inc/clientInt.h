@@ -150,6 +150,7 @@ typedef struct STscObj {
   SAppInstInfo* pAppInfo;
   SHashObj*     pRequests;
   int8_t        schemalessType;  // todo remove it, this attribute should be move to request
+  int64_t       prefetchSize;    // memory held by the results fetched ahead of the application
 } STscObj;
 
 typedef struct SResultColumn {
@@ -180,8 +181,22 @@ typedef struct SReqResultInfo {
   bool           convertUcs4;
   int32_t        payloadLen;
   char*          convertJson;
+  char*          decompBuf;      // the result block after the column data is decompressed
+  int32_t        decompBufSize;
 } SReqResultInfo;
 
+// Results fetched ahead while the application consumes the current one, see maxMemUsedByPrefetch.
+// The scheduler serves one fetch of a job at a time, so at most one fetch is in flight and the next one is
+// sent as soon as it returns, until the job completes or the memory budget of the connection is used up.
+typedef struct SReqPrefetchInfo {
+  TdThreadMutex lock;
+  SArray*       pRsps;     // SArray<SRetrieveTableRsp*>, not consumed by the application yet
+  bool          inFlight;  // a fetch is sent to the scheduler
+  bool          waiting;   // the application waits for the fetch in flight
+  bool          end;       // the last fetched rsp completes the query or failed
+  int32_t       code;      // error of the last fetch, returned after the queued rsps are consumed
+} SReqPrefetchInfo;
+
 typedef struct SRequestSendRecvBody {
   tsem_t            rspSem;  // not used now
   __taos_async_fn_t queryFp;
@@ -192,6 +207,7 @@ typedef struct SRequestSendRecvBody {
   int64_t           queryJob;  // query job, created according to sql query DAG.
   int32_t           subplanNum;
   SReqResultInfo    resInfo;
+  SReqPrefetchInfo  prefetch;
 } SRequestSendRecvBody;
 
 typedef struct {
@@ -267,6 +283,7 @@ int32_t setQueryResultFromRsp(SReqResultInfo* pResultInfo, const SRetrieveTableR
                               bool freeAfterUse);
 void    setResSchemaInfo(SReqResultInfo* pResInfo, const SSchema* pSchema, int32_t numOfCols);
 void    doFreeReqResultInfo(SReqResultInfo* pResInfo);
+void    destroyPrefetchInfo(SRequestObj* pRequest);
 int32_t transferTableNameList(const char* tbList, int32_t acctId, char* dbName, SArray** pReq);
 void    syncCatalogFn(SMetaData* pResult, void* param, int32_t code);
 
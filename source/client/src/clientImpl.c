@@ -1957,6 +1957,32 @@ void resetConnectDB(STscObj* pTscObj) {
   taosThreadMutexUnlock(&pTscObj->mutex);
 }
 
+static int32_t doDecompressBlock(SReqResultInfo* pResultInfo) {
+  const char* p = pResultInfo->pData;
+  if (*(int32_t*)p != BLOCK_VERSION_COMPRESSED) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  int32_t len = blockGetDecompressedSize(p);
+  if (pResultInfo->decompBufSize < len) {
+    char* tmp = taosMemoryRealloc(pResultInfo->decompBuf, len);
+    if (tmp == NULL) {
+      return TSDB_CODE_OUT_OF_MEMORY;
+    }
+
+    pResultInfo->decompBuf = tmp;
+    pResultInfo->decompBufSize = len;
+  }
+
+  if (blockDecompressEncode(p, pResultInfo->decompBuf) < 0) {
+    tscError("failed to decompress result block since %s", terrstr());
+    return terrno;
+  }
+
+  pResultInfo->pData = pResultInfo->decompBuf;
+  return TSDB_CODE_SUCCESS;
+}
+
 int32_t setQueryResultFromRsp(SReqResultInfo* pResultInfo, const SRetrieveTableRsp* pRsp, bool convertUcs4,
                               bool freeAfterUse) {
   assert(pResultInfo != NULL && pRsp != NULL);
@@ -1971,7 +1997,14 @@ int32_t setQueryResultFromRsp(SReqResultInfo* pResultInfo, const SRetrieveTableR
   pResultInfo->payloadLen = htonl(pRsp->compLen);
   pResultInfo->precision = pRsp->precision;
 
-  // TODO handle the compressed case
+  // the column data is compressed by the data sink, convert it back into the uncompressed block encoding
+  if (pRsp->compressed && pResultInfo->numOfRows > 0) {
+    int32_t code = doDecompressBlock(pResultInfo);
+    if (code != TSDB_CODE_SUCCESS) {
+      return code;
+    }
+  }
+
   pResultInfo->totalRows += pResultInfo->numOfRows;
   return setResultDataPtr(pResultInfo, pResultInfo->fields, pResultInfo->numOfCols, pResultInfo->numOfRows,
                           convertUcs4);
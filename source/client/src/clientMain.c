@@ -957,9 +957,7 @@ void doAsyncQuery(SRequestObj *pRequest, bool updateMetaForce) {
   }
 }
 
-static void fetchCallback(void *pResult, void *param, int32_t code) {
-  SRequestObj *pRequest = (SRequestObj *)param;
-
+static void handleFetchRsp(SRequestObj *pRequest, void *pResult, int32_t code) {
   SReqResultInfo *pResultInfo = &pRequest->body.resInfo;
   pRequest->metric.resultReady = taosGetTimestampUs();
 
@@ -1002,6 +1000,142 @@ static void fetchCallback(void *pResult, void *param, int32_t code) {
   pRequest->body.fetchFp(pRequest->body.param, pRequest, pResultInfo->numOfRows);
 }
 
+static void fetchCallback(void *pResult, void *param, int32_t code) {
+  handleFetchRsp((SRequestObj *)param, pResult, code);
+}
+
+static int64_t getPrefetchRspSize(const SRetrieveTableRsp *pRsp) {
+  return sizeof(SRetrieveTableRsp) + htonl(pRsp->compLen);
+}
+
+// the prefetch lock is held
+static bool prefetchAllowed(SRequestObj *pRequest) {
+  SReqPrefetchInfo *pInfo = &pRequest->body.prefetch;
+  if (pInfo->inFlight || pInfo->end || pRequest->code != TSDB_CODE_SUCCESS || pRequest->killed) {
+    return false;
+  }
+
+  return atomic_load_64(&pRequest->pTscObj->prefetchSize) < (int64_t)tsMaxMemUsedByPrefetch * 1024 * 1024;
+}
+
+static void prefetchCallback(void *pResult, void *param, int32_t code);
+
+// inFlight is set by the caller, with the prefetch lock released, since the scheduler may call back at once
+static void launchPrefetch(SRequestObj *pRequest) {
+  // the fetch in flight holds a ref of the request, released in prefetchCallback
+  if (acquireRequest(pRequest->self) == NULL) {
+    tscDebug("0x%" PRIx64 " request is freed, no more fetch, reqId:0x%" PRIx64, pRequest->self, pRequest->requestId);
+    taosThreadMutexLock(&pRequest->body.prefetch.lock);
+    pRequest->body.prefetch.inFlight = false;
+    taosThreadMutexUnlock(&pRequest->body.prefetch.lock);
+    return;
+  }
+
+  SSchedulerReq req = {
+      .syncReq = false,
+      .fetchFp = prefetchCallback,
+      .cbParam = pRequest,
+  };
+
+  tscDebug("0x%" PRIx64 " launch fetch, prefetched size:%" PRId64 ", reqId:0x%" PRIx64, pRequest->self,
+           atomic_load_64(&pRequest->pTscObj->prefetchSize), pRequest->requestId);
+  schedulerFetchRows(pRequest->body.queryJob, &req);
+}
+
+static void prefetchCallback(void *pResult, void *param, int32_t code) {
+  SRequestObj       *pRequest = (SRequestObj *)param;
+  SReqPrefetchInfo  *pInfo = &pRequest->body.prefetch;
+  SRetrieveTableRsp *pRsp = (SRetrieveTableRsp *)pResult;
+  int64_t            rid = pRequest->self;
+
+  if (code == TSDB_CODE_SUCCESS && pRsp == NULL) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  taosThreadMutexLock(&pInfo->lock);
+  pInfo->inFlight = false;
+  if (code != TSDB_CODE_SUCCESS || pRsp->completed) {
+    pInfo->end = true;
+  }
+
+  bool deliver = pInfo->waiting;
+  if (deliver) {
+    pInfo->waiting = false;
+  } else if (code != TSDB_CODE_SUCCESS) {
+    pInfo->code = code;
+    taosMemoryFreeClear(pResult);
+  } else {
+    if (pInfo->pRsps == NULL) {
+      pInfo->pRsps = taosArrayInit(4, POINTER_BYTES);
+    }
+    taosArrayPush(pInfo->pRsps, &pRsp);
+    atomic_add_fetch_64(&pRequest->pTscObj->prefetchSize, getPrefetchRspSize(pRsp));
+  }
+
+  bool launch = prefetchAllowed(pRequest);
+  pInfo->inFlight = launch;
+  taosThreadMutexUnlock(&pInfo->lock);
+
+  // send the next fetch before the application starts on this one
+  if (launch) {
+    launchPrefetch(pRequest);
+  }
+
+  if (deliver) {
+    handleFetchRsp(pRequest, pResult, code);
+  }
+
+  releaseRequest(rid);
+}
+
+static void doPrefetchRows(SRequestObj *pRequest) {
+  SReqPrefetchInfo *pInfo = &pRequest->body.prefetch;
+  void             *pRsp = NULL;
+  int32_t           code = TSDB_CODE_SUCCESS;
+  bool              deliver = false;
+  bool              launch = false;
+
+  taosThreadMutexLock(&pInfo->lock);
+  if (taosArrayGetSize(pInfo->pRsps) > 0) {
+    pRsp = *(void **)taosArrayGet(pInfo->pRsps, 0);
+    taosArrayRemove(pInfo->pRsps, 0);
+    atomic_sub_fetch_64(&pRequest->pTscObj->prefetchSize, getPrefetchRspSize(pRsp));
+    deliver = true;
+  } else if (pInfo->code != TSDB_CODE_SUCCESS) {
+    code = pInfo->code;
+    deliver = true;
+  } else {
+    // nothing fetched ahead, wait for the fetch in flight, or send one regardless of the budget
+    pInfo->waiting = true;
+    launch = !pInfo->inFlight;
+  }
+
+  launch = launch || prefetchAllowed(pRequest);
+  pInfo->inFlight = pInfo->inFlight || launch;
+  taosThreadMutexUnlock(&pInfo->lock);
+
+  if (launch) {
+    launchPrefetch(pRequest);
+  }
+
+  if (deliver) {
+    handleFetchRsp(pRequest, pRsp, code);
+  }
+}
+
+void destroyPrefetchInfo(SRequestObj *pRequest) {
+  SReqPrefetchInfo *pInfo = &pRequest->body.prefetch;
+  for (int32_t i = 0; i < taosArrayGetSize(pInfo->pRsps); ++i) {
+    SRetrieveTableRsp *pRsp = *(SRetrieveTableRsp **)taosArrayGet(pInfo->pRsps, i);
+    atomic_sub_fetch_64(&pRequest->pTscObj->prefetchSize, getPrefetchRspSize(pRsp));
+    taosMemoryFree(pRsp);
+  }
+
+  taosArrayDestroy(pInfo->pRsps);
+  pInfo->pRsps = NULL;
+  taosThreadMutexDestroy(&pInfo->lock);
+}
+
 void taos_fetch_rows_a(TAOS_RES *res, __taos_async_fn_t fp, void *param) {
   ASSERT(res != NULL && fp != NULL);
   ASSERT(TD_RES_QUERY(res));
@@ -1037,6 +1171,11 @@ void taos_fetch_rows_a(TAOS_RES *res, __taos_async_fn_t fp, void *param) {
     return;
   }
 
+  if (tsMaxMemUsedByPrefetch > 0) {
+    doPrefetchRows(pRequest);
+    return;
+  }
+
   SSchedulerReq req = {
       .syncReq = false,
       .fetchFp = fetchCallback,
@@ -2,6 +2,9 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#if __SSE2__
+#include <emmintrin.h>
+#endif
 
 #include "cJSON.h"
 #include "catalog.h"
@@ -55,13 +58,15 @@
 
 #define MOVE_FORWARD_ONE(sql, len) (memmove((void *)((sql)-1), (sql), len))
 
-#define PROCESS_SLASH(key, keyLen)           \
-  for (int i = 1; i < keyLen; ++i) {         \
-    if (IS_SLASH_LETTER(key + i)) {          \
-      MOVE_FORWARD_ONE(key + i, keyLen - i); \
-      i--;                                   \
-      keyLen--;                              \
-    }                                        \
+#define PROCESS_SLASH(key, keyLen)             \
+  if (memchr(key, SLASH, keyLen) != NULL) {    \
+    for (int i = 1; i < keyLen; ++i) {         \
+      if (IS_SLASH_LETTER(key + i)) {          \
+        MOVE_FORWARD_ONE(key + i, keyLen - i); \
+        i--;                                   \
+        keyLen--;                              \
+      }                                        \
+    }                                          \
   }
 
 #define IS_INVALID_COL_LEN(len)   ((len) <= 0 || (len) >= TSDB_COL_NAME_LEN)
@@ -123,6 +128,7 @@ typedef struct {
 
   SArray   *cols;
   SHashObj *colHash;
+  SArray   *colLayout;  // index in cols of every key of the last line, in the order of that line
 
   STableMeta *tableMeta;
 } SSmlSTableMeta;
@@ -214,6 +220,36 @@ static inline bool smlCheckDuplicateKey(const char *key, int32_t keyLen, SHashOb
   return false;
 }
 
+static inline bool smlIsSpecial(char c) {
+  return c == COMMA || c == SPACE || c == EQUAL || c == QUOTE || c == SLASH;
+}
+
+// The first comma, space, equal, quote or slash from sql on, or sqlEnd if there is none. The parsers of the line
+// protocol only look at these letters, so they can jump over all the others.
+static inline const char *smlFindSpecial(const char *sql, const char *sqlEnd) {
+#if __SSE2__
+  const __m128i comma = _mm_set1_epi8(COMMA);
+  const __m128i space = _mm_set1_epi8(SPACE);
+  const __m128i equal = _mm_set1_epi8(EQUAL);
+  const __m128i quote = _mm_set1_epi8(QUOTE);
+  const __m128i slash = _mm_set1_epi8(SLASH);
+  while (sqlEnd - sql >= 16) {
+    __m128i v = _mm_loadu_si128((const __m128i *)sql);
+    __m128i m = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, comma), _mm_cmpeq_epi8(v, space)),
+                             _mm_or_si128(_mm_cmpeq_epi8(v, equal), _mm_cmpeq_epi8(v, quote)));
+    int32_t mask = _mm_movemask_epi8(_mm_or_si128(m, _mm_cmpeq_epi8(v, slash)));
+    if (mask != 0) {
+      return sql + __builtin_ctz(mask);
+    }
+    sql += 16;
+  }
+#endif
+  while (sql < sqlEnd && !smlIsSpecial(*sql)) {
+    sql++;
+  }
+  return sql;
+}
+
 static int32_t smlBuildInvalidDataMsg(SSmlMsgBuf *pBuf, const char *msg1, const char *msg2) {
   if (pBuf->buf) {
     memset(pBuf->buf, 0, pBuf->len);
@@ -944,6 +980,10 @@ static int32_t smlParseInfluxString(const char *sql, const char *sqlEnd, SSmlLin
 
   // parse measure
   while (sql < sqlEnd) {
+    sql = smlFindSpecial(sql, sqlEnd);
+    if (sql == sqlEnd) {
+      break;
+    }
     if ((sql != elements->measure) && IS_SLASH_LETTER(sql)) {
       MOVE_FORWARD_ONE(sql, sqlEnd - sql);
       sqlEnd--;
@@ -971,6 +1011,10 @@ static int32_t smlParseInfluxString(const char *sql, const char *sqlEnd, SSmlLin
     if (*sql == COMMA) sql++;
     elements->tags = sql;
     while (sql < sqlEnd) {
+      sql = smlFindSpecial(sql, sqlEnd);
+      if (sql == sqlEnd) {
+        break;
+      }
       if (IS_SPACE(sql)) {
         break;
       }
@@ -985,6 +1029,10 @@ static int32_t smlParseInfluxString(const char *sql, const char *sqlEnd, SSmlLin
   elements->cols = sql;
   bool isInQuote = false;
   while (sql < sqlEnd) {
+    sql = smlFindSpecial(sql, sqlEnd);
+    if (sql == sqlEnd) {
+      break;
+    }
     if (IS_QUOTE(sql)) {
       isInQuote = !isInQuote;
     }
@@ -1182,6 +1230,10 @@ static int32_t smlParseCols(const char *data, int32_t len, SArray *cols, char *c
 
     while (sql < data + len) {
       // parse key
+      sql = smlFindSpecial(sql, data + len);
+      if (sql == data + len) {
+        break;
+      }
       if (IS_COMMA(sql)) {
         smlBuildInvalidDataMsg(msg, "invalid data", sql);
         return TSDB_CODE_SML_INVALID_DATA;
@@ -1198,7 +1250,7 @@ static int32_t smlParseCols(const char *data, int32_t len, SArray *cols, char *c
       smlBuildInvalidDataMsg(msg, "invalid key or key is too long than 64", key);
       return TSDB_CODE_TSC_INVALID_COLUMN_LENGTH;
     }
-    if (smlCheckDuplicateKey(key, keyLen, dumplicateKey)) {
+    if (dumplicateKey && smlCheckDuplicateKey(key, keyLen, dumplicateKey)) {
       smlBuildInvalidDataMsg(msg, "dumplicate key", key);
       return TSDB_CODE_TSC_DUP_NAMES;
     }
@@ -1209,6 +1261,10 @@ static int32_t smlParseCols(const char *data, int32_t len, SArray *cols, char *c
     bool        isInQuote = false;
     while (sql < data + len) {
       // parse value
+      sql = smlFindSpecial(sql, data + len);
+      if (sql == data + len) {
+        break;
+      }
       if (!isTag && IS_QUOTE(sql)) {
         isInQuote = !isInQuote;
         sql++;
@@ -1306,6 +1362,69 @@ static void smlInsertMeta(SHashObj *metaHash, SArray *metaArray, SArray *cols) {
   }
 }
 
+// the first column is the timestamp, which is not a key of the line
+static int32_t smlCheckDuplicateCols(SArray *cols, SHashObj *dumplicateKey, SSmlMsgBuf *msg) {
+  for (int i = 1; i < taosArrayGetSize(cols); ++i) {
+    SSmlKv *kv = (SSmlKv *)taosArrayGetP(cols, i);
+    if (smlCheckDuplicateKey(kv->key, kv->keyLen, dumplicateKey)) {
+      smlBuildInvalidDataMsg(msg, "dumplicate key", kv->key);
+      return TSDB_CODE_TSC_DUP_NAMES;
+    }
+  }
+  return TSDB_CODE_SUCCESS;
+}
+
+static void smlBuildColLayout(SSmlSTableMeta *meta, SArray *cols) {
+  taosArrayClear(meta->colLayout);
+  for (int i = 0; i < taosArrayGetSize(cols); ++i) {
+    SSmlKv  *kv = (SSmlKv *)taosArrayGetP(cols, i);
+    int16_t *index = (int16_t *)taosHashGet(meta->colHash, kv->key, kv->keyLen);
+    if (index == NULL) {
+      taosArrayClear(meta->colLayout);
+      return;
+    }
+    taosArrayPush(meta->colLayout, index);
+  }
+}
+
+static bool smlMatchColLayout(SSmlSTableMeta *meta, SArray *cols) {
+  if (taosArrayGetSize(meta->colLayout) != taosArrayGetSize(cols)) {
+    return false;
+  }
+  for (int i = 0; i < taosArrayGetSize(cols); ++i) {
+    SSmlKv *kv = (SSmlKv *)taosArrayGetP(cols, i);
+    SSmlKv *pre = (SSmlKv *)taosArrayGetP(meta->cols, *(int16_t *)taosArrayGet(meta->colLayout, i));
+    if (kv->keyLen != pre->keyLen || memcmp(kv->key, pre->key, kv->keyLen) != 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// the meta of every column is found by its position in the layout of the last line, instead of by hash
+static int32_t smlUpdateColMeta(SSmlSTableMeta *meta, SArray *cols, bool layoutHit, SSmlMsgBuf *msg) {
+  if (!layoutHit) {
+    int32_t code = smlUpdateMeta(meta->colHash, meta->cols, cols, msg);
+    if (code == TSDB_CODE_SUCCESS) {
+      smlBuildColLayout(meta, cols);
+    }
+    return code;
+  }
+
+  for (int i = 0; i < taosArrayGetSize(cols); ++i) {
+    SSmlKv  *kv = (SSmlKv *)taosArrayGetP(cols, i);
+    SSmlKv **value = (SSmlKv **)taosArrayGet(meta->cols, *(int16_t *)taosArrayGet(meta->colLayout, i));
+    if (kv->type != (*value)->type) {
+      smlBuildInvalidDataMsg(msg, "the type is not the same like before", kv->key);
+      return TSDB_CODE_SML_NOT_SAME_TYPE;
+    }
+    if (IS_VAR_DATA_TYPE(kv->type) && kv->length > (*value)->length) {  // update string len, if bigger
+      *value = kv;
+    }
+  }
+  return TSDB_CODE_SUCCESS;
+}
+
 static SSmlTableInfo *smlBuildTableInfo() {
   SSmlTableInfo *tag = (SSmlTableInfo *)taosMemoryCalloc(sizeof(SSmlTableInfo), 1);
   if (!tag) {
@@ -1404,8 +1523,14 @@ static int32_t smlKvTimeHashCompare(const void *key1, const void *key2) {
   }
 }
 
+// Rows are kept in the order of time. They mostly come in order, then the row goes to the end without a search.
 static int32_t smlDealCols(SSmlTableInfo *oneTable, bool dataFormat, SArray *cols) {
+  size_t num = taosArrayGetSize(oneTable->cols);
   if (dataFormat) {
+    if (num == 0 || smlKvTimeArrayCompare(taosArrayGetLast(oneTable->cols), &cols) <= 0) {
+      taosArrayPush(oneTable->cols, &cols);
+      return TSDB_CODE_SUCCESS;
+    }
     void *p = taosArraySearch(oneTable->cols, &cols, smlKvTimeArrayCompare, TD_GT);
     if (p == NULL) {
       taosArrayPush(oneTable->cols, &cols);
@@ -1425,6 +1550,10 @@ static int32_t smlDealCols(SSmlTableInfo *oneTable, bool dataFormat, SArray *col
     taosHashPut(kvHash, kv->key, kv->keyLen, &kv, POINTER_BYTES);
   }
 
+  if (num == 0 || smlKvTimeHashCompare(taosArrayGetLast(oneTable->cols), &kvHash) <= 0) {
+    taosArrayPush(oneTable->cols, &kvHash);
+    return TSDB_CODE_SUCCESS;
+  }
   void *p = taosArraySearch(oneTable->cols, &kvHash, smlKvTimeHashCompare, TD_GT);
   if (p == NULL) {
     taosArrayPush(oneTable->cols, &kvHash);
@@ -1462,6 +1591,12 @@ static SSmlSTableMeta *smlBuildSTableMeta() {
     uError("SML:smlBuildSTableMeta failed to allocate memory");
     goto cleanup;
   }
+
+  meta->colLayout = taosArrayInit(32, sizeof(int16_t));
+  if (meta->colLayout == NULL) {
+    uError("SML:smlBuildSTableMeta failed to allocate memory");
+    goto cleanup;
+  }
   return meta;
 
 cleanup:
@@ -1474,6 +1609,7 @@ static void smlDestroySTableMeta(SSmlSTableMeta *meta) {
   taosHashCleanup(meta->colHash);
   taosArrayDestroy(meta->tags);
   taosArrayDestroy(meta->cols);
+  taosArrayDestroy(meta->colLayout);
   taosMemoryFree(meta->tableMeta);
   taosMemoryFree(meta);
 }
@@ -2097,6 +2233,10 @@ static int32_t smlParseInfluxLine(SSmlHandle *info, const char *sql, const int l
     }
   } else {  // if dataFormat is false, cols do not need to save data, there is another new memory to save data
     cols = info->colsContainer;
+    taosArrayClear(cols);  // left by the last line, also when it failed
+  }
+  if (taosHashGetSize(info->dumplicateKey) > 0) {
+    taosHashClear(info->dumplicateKey);
   }
 
   ret = smlParseTS(info, elements.timestamp, elements.timestampLen, cols);
@@ -2105,7 +2245,7 @@ static int32_t smlParseInfluxLine(SSmlHandle *info, const char *sql, const int l
     if (info->dataFormat) taosArrayDestroy(cols);
     return ret;
   }
-  ret = smlParseCols(elements.cols, elements.colsLen, cols, NULL, false, info->dumplicateKey, &info->msgBuf);
+  ret = smlParseCols(elements.cols, elements.colsLen, cols, NULL, false, NULL, &info->msgBuf);
   if (ret != TSDB_CODE_SUCCESS) {
     uError("SML:0x%" PRIx64 " smlParseCols parse cloums fields failed", info->id);
     smlDestroyCols(cols);
@@ -2113,6 +2253,18 @@ static int32_t smlParseInfluxLine(SSmlHandle *info, const char *sql, const int l
     return ret;
   }
 
+  // the keys of a measurement mostly come in the same order line by line, then they are unique like last time
+  SSmlSTableMeta **tableMeta = (SSmlSTableMeta **)taosHashGet(info->superTables, elements.measure, elements.measureLen);
+  bool             layoutHit = (tableMeta != NULL && smlMatchColLayout(*tableMeta, cols));
+  if (!layoutHit) {
+    ret = smlCheckDuplicateCols(cols, info->dumplicateKey, &info->msgBuf);
+    if (ret != TSDB_CODE_SUCCESS) {
+      smlDestroyCols(cols);
+      if (info->dataFormat) taosArrayDestroy(cols);
+      return ret;
+    }
+  }
+
   bool            hasTable = true;
   SSmlTableInfo  *tinfo = NULL;
   SSmlTableInfo **oneTable =
@@ -2135,6 +2287,9 @@ static int32_t smlParseInfluxLine(SSmlHandle *info, const char *sql, const int l
   }
 
   if (!hasTable) {
+    if (layoutHit) {  // tags may not have the name of a column
+      smlCheckDuplicateCols(cols, info->dumplicateKey, &info->msgBuf);
+    }
     ret = smlParseCols(elements.tags, elements.tagsLen, (*oneTable)->tags, (*oneTable)->childTableName, true,
                        info->dumplicateKey, &info->msgBuf);
     if (ret != TSDB_CODE_SUCCESS) {
@@ -2163,9 +2318,8 @@ static int32_t smlParseInfluxLine(SSmlHandle *info, const char *sql, const int l
     (*oneTable)->uid = info->uid++;
   }
 
-  SSmlSTableMeta **tableMeta = (SSmlSTableMeta **)taosHashGet(info->superTables, elements.measure, elements.measureLen);
   if (tableMeta) {  // update meta
-    ret = smlUpdateMeta((*tableMeta)->colHash, (*tableMeta)->cols, cols, &info->msgBuf);
+    ret = smlUpdateColMeta(*tableMeta, cols, layoutHit, &info->msgBuf);
     if (!hasTable && ret == TSDB_CODE_SUCCESS) {
       ret = smlUpdateMeta((*tableMeta)->tagHash, (*tableMeta)->tags, (*oneTable)->tags, &info->msgBuf);
     }
@@ -2177,13 +2331,10 @@ static int32_t smlParseInfluxLine(SSmlHandle *info, const char *sql, const int l
     SSmlSTableMeta *meta = smlBuildSTableMeta();
     smlInsertMeta(meta->tagHash, meta->tags, (*oneTable)->tags);
     smlInsertMeta(meta->colHash, meta->cols, cols);
+    smlBuildColLayout(meta, cols);
     taosHashPut(info->superTables, elements.measure, elements.measureLen, &meta, POINTER_BYTES);
   }
 
-  if (!info->dataFormat) {
-    taosArrayClear(info->colsContainer);
-  }
-  taosHashClear(info->dumplicateKey);
   return TSDB_CODE_SUCCESS;
 }
 
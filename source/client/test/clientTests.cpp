@@ -15,6 +15,7 @@
 
 #include <gtest/gtest.h>
 #include <iostream>
+#include <string>
 #include "clientInt.h"
 #include "taoserror.h"
 #include "tglobal.h"
@@ -162,6 +163,66 @@ void *queryThread(void *arg) {
 }
 
 static int32_t numOfThreads = 1;
+
+const int32_t kPrefetchRows = 50000;
+
+void execQuery(TAOS* pConn, const char* sql) {
+  TAOS_RES* pRes = taos_query(pConn, sql);
+  if (taos_errno(pRes) != 0) {
+    printf("failed to execute %s, reason:%s\n", sql, taos_errstr(pRes));
+  }
+  taos_free_result(pRes);
+}
+
+void preparePrefetchData(TAOS* pConn) {
+  execQuery(pConn, "drop database if exists prefetch_db");
+  execQuery(pConn, "create database prefetch_db vgroups 1");
+  execQuery(pConn, "use prefetch_db");
+  execQuery(pConn, "create table pt (ts timestamp, k int, v binary(64))");
+
+  std::string sql;
+  for (int32_t i = 0; i < kPrefetchRows; ++i) {
+    if (sql.empty()) {
+      sql = "insert into pt values";
+    }
+    char row[128] = {0};
+    sprintf(row, "(%" PRId64 ", %d, 'value of row %d')", (int64_t)1660000000000 + i, i % 1000, i);
+    sql += row;
+    if ((i + 1) % 500 == 0) {
+      execQuery(pConn, sql.c_str());
+      sql.clear();
+    }
+  }
+}
+
+// the rows of pt and the sum of its k column, read by taos_fetch_row or by taos_fetch_block
+void scanPrefetchData(TAOS* pConn, bool byBlock, int64_t* rows, int64_t* sum) {
+  *rows = 0;
+  *sum = 0;
+
+  TAOS_RES* pRes = taos_query(pConn, "select ts, k, v from prefetch_db.pt");
+  ASSERT_EQ(taos_errno(pRes), 0) << taos_errstr(pRes);
+
+  if (byBlock) {
+    TAOS_ROW pBlock = NULL;
+    int32_t  n = 0;
+    while ((n = taos_fetch_block(pRes, &pBlock)) > 0) {
+      for (int32_t i = 0; i < n; ++i) {
+        *sum += ((int32_t*)pBlock[1])[i];
+      }
+      *rows += n;
+    }
+  } else {
+    TAOS_ROW pRow = NULL;
+    while ((pRow = taos_fetch_row(pRes)) != NULL) {
+      *sum += *(int32_t*)pRow[1];
+      *rows += 1;
+    }
+  }
+
+  EXPECT_EQ(taos_errno(pRes), 0);
+  taos_free_result(pRes);
+}
 }  // namespace
 
 int main(int argc, char** argv) {
@@ -790,6 +851,59 @@ TEST(testCase, projection_query_stables) {
   taos_close(pConn);
 }
 
+// results fetched ahead of the application are the same as fetched on demand, by row and by block, and the ones
+// not consumed are released with their request, also when it is freed while a fetch is in flight
+TEST(testCase, prefetch_query_test) {
+  TAOS* pConn = taos_connect("localhost", "root", "taosdata", NULL, 0);
+  ASSERT_NE(pConn, nullptr);
+
+  preparePrefetchData(pConn);
+  int32_t budget = tsMaxMemUsedByPrefetch;
+
+  int64_t rows = 0, sum = 0;
+  tsMaxMemUsedByPrefetch = 0;
+  scanPrefetchData(pConn, false, &rows, &sum);
+  ASSERT_EQ(rows, kPrefetchRows);
+
+  // a budget of 1MB is used up by a few blocks, the prefetch stops and resumes as the application consumes them
+  tsMaxMemUsedByPrefetch = 1;
+  for (int32_t i = 0; i < 2; ++i) {
+    int64_t prefetchRows = 0, prefetchSum = 0;
+    scanPrefetchData(pConn, i == 1, &prefetchRows, &prefetchSum);
+    EXPECT_EQ(prefetchRows, rows);
+    EXPECT_EQ(prefetchSum, sum);
+  }
+
+  // the first row starts a fetch of the next block, the result is freed before it returns
+  for (int32_t i = 0; i < 20; ++i) {
+    TAOS_RES* pRes = taos_query(pConn, "select ts, k, v from prefetch_db.pt");
+    ASSERT_EQ(taos_errno(pRes), 0);
+    ASSERT_NE(taos_fetch_row(pRes), nullptr);
+    if (i % 2 == 1) {
+      TAOS_ROW pBlock = NULL;
+      EXPECT_GT(taos_fetch_block(pRes, &pBlock), 0);
+    }
+    taos_free_result(pRes);
+  }
+
+  STscObj* pObj = acquireTscObj(*(int64_t*)pConn);
+  ASSERT_NE(pObj, nullptr);
+  for (int32_t i = 0; i < 100 && atomic_load_64(&pObj->prefetchSize) != 0; ++i) {
+    taosMsleep(50);
+  }
+  EXPECT_EQ(atomic_load_64(&pObj->prefetchSize), 0);
+  releaseTscObj(*(int64_t*)pConn);
+
+  int64_t prefetchRows = 0, prefetchSum = 0;
+  scanPrefetchData(pConn, false, &prefetchRows, &prefetchSum);
+  EXPECT_EQ(prefetchRows, rows);
+  EXPECT_EQ(prefetchSum, sum);
+
+  tsMaxMemUsedByPrefetch = budget;
+  execQuery(pConn, "drop database if exists prefetch_db");
+  taos_close(pConn);
+}
+
 #if 0
 TEST(testCase, agg_query_tables) {
   TAOS* pConn = taos_connect("localhost", "root", "taosdata", NULL, 0);
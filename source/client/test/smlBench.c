@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Parse throughput of the influxdb line protocol, in lines per second, as taos_schemaless_insert_raw parses them.
+// The lines look like the cpu metrics of telegraf: every host is a child table, and all lines have the same tags and
+// fields in the same order. Only the parsing is timed, there is no server behind it.
+// usage: smlBench [-n lines] [-c hosts] [-r rounds]
+
+#include "../src/clientSml.c"
+
+static char *smlBenchGenLines(int32_t numOfLines, int32_t numOfHosts, int32_t *len) {
+  int32_t cap = numOfLines * 512;
+  char   *lines = taosMemoryMalloc(cap);
+  int32_t pos = 0;
+  for (int32_t i = 0; i < numOfLines; ++i) {
+    pos += snprintf(lines + pos, cap - pos,
+                    "cpu,cpu=cpu-total,host=telegraf-host-%04d,region=us-west-2,datacenter=us-west-2a "
+                    "usage_guest=0,usage_guest_nice=0,usage_idle=%d.%03d,usage_iowait=0.25,usage_irq=0,"
+                    "usage_nice=0,usage_softirq=0.125,usage_steal=0,usage_system=1.5,usage_user=%d.5,"
+                    "state=\"running\",cores=8i %" PRId64 "\n",
+                    i % numOfHosts, 90 + i % 10, i % 1000, i % 7, (int64_t)1626006833639000000 + i);
+  }
+  *len = pos;
+  return lines;
+}
+
+static double smlBenchRun(bool dataFormat, const char *lines, int32_t len, int32_t numOfLines, int32_t rounds) {
+  char   *buf = taosMemoryMalloc(len);
+  int64_t elapsed = 0;
+
+  tsSmlDataFormat = dataFormat;
+  for (int32_t r = 0; r < rounds; ++r) {
+    memcpy(buf, lines, len);  // the parser unescapes in place
+    SSmlHandle *info = smlBuildSmlInfo(NULL, NULL, TSDB_SML_LINE_PROTOCOL, TSDB_SML_TIMESTAMP_NANO_SECONDS);
+    if (info == NULL) {
+      printf("failed to build sml info\n");
+      exit(1);
+    }
+    info->isRawLine = true;
+
+    int64_t start = taosGetTimestampUs();
+    int32_t code = smlParseLine(info, NULL, buf, buf + len, numOfLines);
+    elapsed += taosGetTimestampUs() - start;
+    if (code != TSDB_CODE_SUCCESS) {
+      printf("failed to parse lines since %s\n", tstrerror(code));
+      exit(1);
+    }
+    smlDestroyInfo(info);
+  }
+
+  taosMemoryFree(buf);
+  return (double)numOfLines * rounds * 1000000 / TMAX(elapsed, 1);
+}
+
+int main(int argc, char *argv[]) {
+  int32_t numOfLines = 100000;
+  int32_t numOfHosts = 100;
+  int32_t rounds = 5;
+
+  for (int32_t i = 1; i < argc - 1; i += 2) {
+    if (strcmp(argv[i], "-n") == 0) {
+      numOfLines = atoi(argv[i + 1]);
+    } else if (strcmp(argv[i], "-c") == 0) {
+      numOfHosts = atoi(argv[i + 1]);
+    } else if (strcmp(argv[i], "-r") == 0) {
+      rounds = atoi(argv[i + 1]);
+    }
+  }
+
+  int32_t len = 0;
+  char   *lines = smlBenchGenLines(numOfLines, numOfHosts, &len);
+
+  printf("%12s %16s\n", "dataFormat", "lines/s");
+  printf("%12s %16.0f\n", "true", smlBenchRun(true, lines, len, numOfLines, rounds));
+  printf("%12s %16.0f\n", "false", smlBenchRun(false, lines, len, numOfLines, rounds));
+
+  taosMemoryFree(lines);
+  return 0;
+}
@@ -1008,3 +1008,30 @@ TEST(testCase, sml_col_4096_Test) {
   ASSERT_NE(ret, 0);
   smlDestroyInfo(info);
 }
+
+TEST(testCase, smlParseInfluxLine_layout_Test) {
+  SSmlHandle *info = smlBuildSmlInfo(NULL, NULL, TSDB_SML_LINE_PROTOCOL, TSDB_SML_TIMESTAMP_NANO_SECONDS);
+  ASSERT_NE(info, nullptr);
+
+  // the same keys as the line before, in the same order or not, then a tag named like a column and a repeated key
+  const char *sql[] = {
+      "st,t=1 a=1i,b=2i,c=\"x\" 1626006833639000000",     "st,t=1 a=2i,b=3i,c=\"xyz\" 1626006833639000001",
+      "st,t=1 b=3i,a=2i,c=\"x\" 1626006833639000002",     "st,t=1 a=1i,b=2i,c=\"x\" 1626006833639000003",
+      "st,t=1 a=1i,b=2i,c=1i 1626006833639000004",       "st,t=2,b=1 a=1i,b=2i,c=\"x\" 1626006833639000005",
+      "st,t=1 a=1i,b=2i,a=3i 1626006833639000006",
+  };
+  int32_t codes[] = {0, 0, 0, 0, TSDB_CODE_SML_NOT_SAME_TYPE, TSDB_CODE_TSC_DUP_NAMES, TSDB_CODE_TSC_DUP_NAMES};
+  for (int i = 0; i < sizeof(sql) / sizeof(sql[0]); i++) {
+    int ret = smlParseInfluxLine(info, sql[i], strlen(sql[i]));
+    ASSERT_EQ(ret, codes[i]);
+  }
+
+  SSmlSTableMeta **meta = (SSmlSTableMeta **)taosHashGet(info->superTables, "st", 2);
+  ASSERT_NE(meta, nullptr);
+  ASSERT_EQ(taosArrayGetSize((*meta)->cols), 4);
+  SSmlKv *kv = (SSmlKv *)taosArrayGetP((*meta)->cols, 3);
+  ASSERT_EQ(strncmp(kv->key, "c", kv->keyLen), 0);
+  ASSERT_EQ(kv->length, 3);
+
+  smlDestroyInfo(info);
+}
@@ -717,11 +717,6 @@ double blockDataGetSerialRowSize(const SSDataBlock* pBlock) {
   return rowSize;
 }
 
-typedef struct SSDataBlockSortHelper {
-  SArray*      orderInfo;  // SArray<SBlockOrderInfo>
-  SSDataBlock* pDataBlock;
-} SSDataBlockSortHelper;
-
 int32_t dataBlockCompar(const void* p1, const void* p2, const void* param) {
   const SSDataBlockSortHelper* pHelper = (const SSDataBlockSortHelper*)param;
 
@@ -992,6 +987,22 @@ int32_t blockDataSort(SSDataBlock* pDataBlock, SArray* pOrderInfo) {
   return TSDB_CODE_SUCCESS;
 }
 
+int32_t blockDataReorder(SSDataBlock* pDataBlock, const int32_t* index) {
+  if (pDataBlock->info.rows <= 1) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  SColumnInfoData* pCols = createHelpColInfoData(pDataBlock);
+  if (pCols == NULL) {
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    return terrno;
+  }
+
+  blockDataAssign(pCols, pDataBlock, index);
+  copyBackToBlock(pDataBlock, pCols);
+  return TSDB_CODE_SUCCESS;
+}
+
 typedef struct SHelper {
   int32_t index;
   union {
@@ -2194,6 +2205,201 @@ int32_t buildSubmitReqFromDataBlock(SSubmitReq** pReq, const SSDataBlock* pDataB
   return TSDB_CODE_SUCCESS;
 }
 
+int32_t tGetSubmitColBlkSize(const SSDataBlock* pBlock) {
+  return sizeof(SSubmitColHead) + taosArrayGetSize(pBlock->pDataBlock) * sizeof(col_id_t) + blockGetEncodeSize(pBlock);
+}
+
+int32_t tEncodeSubmitColBlk(const SSDataBlock* pBlock, char* pBuf) {
+  int32_t          numOfCols = taosArrayGetSize(pBlock->pDataBlock);
+  SSubmitColHead*  pHead = (SSubmitColHead*)pBuf;
+  SColumnInfoData* pTsCol = taosArrayGet(pBlock->pDataBlock, 0);
+
+  TD_ROW_SET_INFO(SUBMIT_COL_HEAD_ROW(pHead), 0);
+  TD_ROW_SET_TYPE(SUBMIT_COL_HEAD_ROW(pHead), TD_ROW_COL);
+  TD_ROW_SET_SVER(SUBMIT_COL_HEAD_ROW(pHead), SUBMIT_COL_BLK_VER_1);
+  TD_ROW_KEY(SUBMIT_COL_HEAD_ROW(pHead)) = ((TSKEY*)pTsCol->pData)[0];
+  pHead->ekey = ((TSKEY*)pTsCol->pData)[pBlock->info.rows - 1];
+  pHead->numOfCols = numOfCols;
+  for (int32_t i = 0; i < numOfCols; ++i) {
+    SColumnInfoData* pCol = taosArrayGet(pBlock->pDataBlock, i);
+    pHead->colId[i] = pCol->info.colId;
+  }
+
+  int32_t len = sizeof(SSubmitColHead) + numOfCols * sizeof(col_id_t);
+  len += blockEncode(pBlock, pBuf + len, numOfCols);
+  TD_ROW_SET_LEN(SUBMIT_COL_HEAD_ROW(pHead), len);
+  return len;
+}
+
+// Unlike blockDecode, the data is checked against its length and left as it is, for the body of a submit message is
+// decoded by both tsdb and tq.
+int32_t tDecodeSubmitColBlk(const SSubmitColHead* pHead, int32_t dataLen, const STSchema* pTSchema,
+                            SSDataBlock* pBlock) {
+  if (dataLen < (int32_t)sizeof(SSubmitColHead) || TD_ROW_LEN(SUBMIT_COL_HEAD_ROW(pHead)) != dataLen ||
+      TD_ROW_SVER(SUBMIT_COL_HEAD_ROW(pHead)) != SUBMIT_COL_BLK_VER_1 || pHead->numOfCols < 1 ||
+      pHead->numOfCols > TSDB_MAX_COLUMNS) {
+    return TSDB_CODE_INVALID_MSG;
+  }
+
+  int32_t     numOfCols = pHead->numOfCols;
+  const char* pData = (const char*)pHead + sizeof(SSubmitColHead) + numOfCols * sizeof(col_id_t);
+  const char* pEnd = (const char*)pHead + dataLen;
+  if (pEnd - pData < (int64_t)blockDataGetSerialMetaSize(numOfCols)) {
+    return TSDB_CODE_INVALID_MSG;
+  }
+
+  // | version | total length | total rows | total columns | flag seg| block group id | column schema | column length |
+  const int32_t* pInfo = (const int32_t*)pData;
+  int32_t        numOfRows = pInfo[2];
+  if (pInfo[0] != BLOCK_VERSION_1 || pInfo[1] != pEnd - pData || numOfRows <= 0 || pInfo[3] != numOfCols) {
+    return TSDB_CODE_INVALID_MSG;
+  }
+  pData += sizeof(int32_t) * 5 + sizeof(uint64_t);
+
+  int32_t iSchema = 0;
+  for (int32_t i = 0; i < numOfCols; ++i) {
+    col_id_t colId = pHead->colId[i];
+    int8_t   type = *(int8_t*)pData;
+    int32_t  bytes = *(int32_t*)(pData + sizeof(int8_t));
+    pData += sizeof(int8_t) + sizeof(int32_t);
+
+    if ((i == 0 && (colId != PRIMARYKEY_TIMESTAMP_COL_ID || type != TSDB_DATA_TYPE_TIMESTAMP)) ||
+        (i > 0 && colId <= pHead->colId[i - 1]) || type <= TSDB_DATA_TYPE_NULL || type >= TSDB_DATA_TYPE_MAX ||
+        (!IS_VAR_DATA_TYPE(type) && bytes != TYPE_BYTES[type])) {
+      return TSDB_CODE_INVALID_MSG;
+    }
+
+    if (pTSchema) {
+      while (iSchema < pTSchema->numOfCols && pTSchema->columns[iSchema].colId < colId) ++iSchema;
+      if (iSchema == pTSchema->numOfCols || pTSchema->columns[iSchema].colId != colId ||
+          pTSchema->columns[iSchema].type != type) {
+        return TSDB_CODE_INVALID_MSG;
+      }
+    }
+
+    SColumnInfoData colInfo = createColumnInfoData(type, bytes, colId);
+    if (blockDataAppendColInfo(pBlock, &colInfo) != TSDB_CODE_SUCCESS) {
+      return TSDB_CODE_OUT_OF_MEMORY;
+    }
+  }
+
+  if (blockDataEnsureCapacity(pBlock, numOfRows) != TSDB_CODE_SUCCESS) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  const int32_t* colLen = (const int32_t*)pData;
+  pData += sizeof(int32_t) * numOfCols;
+
+  for (int32_t i = 0; i < numOfCols; ++i) {
+    SColumnInfoData* pCol = taosArrayGet(pBlock->pDataBlock, i);
+    int32_t          len = ntohl(colLen[i]);
+    if (len < 0) {
+      return TSDB_CODE_INVALID_MSG;
+    }
+
+    if (IS_VAR_DATA_TYPE(pCol->info.type)) {
+      if (pEnd - pData < (int64_t)sizeof(int32_t) * numOfRows + len) {
+        return TSDB_CODE_INVALID_MSG;
+      }
+      memcpy(pCol->varmeta.offset, pData, sizeof(int32_t) * numOfRows);
+      pData += sizeof(int32_t) * numOfRows;
+
+      for (int32_t iRow = 0; iRow < numOfRows; ++iRow) {
+        int32_t offset = pCol->varmeta.offset[iRow];
+        if (offset == -1) continue;
+        if (offset < 0 || len - offset < VARSTR_HEADER_SIZE || len - offset < varDataTLen(pData + offset)) {
+          return TSDB_CODE_INVALID_MSG;
+        }
+      }
+
+      if (pCol->varmeta.allocLen < len) {
+        char* tmp = taosMemoryRealloc(pCol->pData, len);
+        if (tmp == NULL) {
+          return TSDB_CODE_OUT_OF_MEMORY;
+        }
+        pCol->pData = tmp;
+        pCol->varmeta.allocLen = len;
+      }
+      pCol->varmeta.length = len;
+    } else {
+      if (len != pCol->info.bytes * numOfRows || pEnd - pData < (int64_t)BitmapLen(numOfRows) + len) {
+        return TSDB_CODE_INVALID_MSG;
+      }
+      memcpy(pCol->nullbitmap, pData, BitmapLen(numOfRows));
+      pData += BitmapLen(numOfRows);
+    }
+
+    if (len > 0) {
+      memcpy(pCol->pData, pData, len);
+    }
+    pCol->hasNull = true;
+    pData += len;
+  }
+
+  if (pData != pEnd) {
+    return TSDB_CODE_INVALID_MSG;
+  }
+
+  pBlock->info.dataLoad = 1;
+  pBlock->info.rows = numOfRows;
+
+  // the keys are neither null nor out of order, and are those of the head
+  SColumnInfoData* pTsCol = taosArrayGet(pBlock->pDataBlock, 0);
+  const TSKEY*     keys = (const TSKEY*)pTsCol->pData;
+  for (int32_t iRow = 0; iRow < numOfRows; ++iRow) {
+    if (colDataIsNull_f(pTsCol->nullbitmap, iRow) || (iRow > 0 && keys[iRow] <= keys[iRow - 1])) {
+      return TSDB_CODE_INVALID_MSG;
+    }
+  }
+  if (keys[0] != TD_ROW_KEY(SUBMIT_COL_HEAD_ROW(pHead)) || keys[numOfRows - 1] != pHead->ekey) {
+    return TSDB_CODE_INVALID_MSG;
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
+int32_t tGetSubmitColBlkRowLen(const SSDataBlock* pBlock, const STSchema* pTSchema, int32_t iRow) {
+  int32_t len = TD_ROW_HEAD_LEN + pTSchema->flen + TD_BITMAP_BYTES(pTSchema->numOfCols - 1);
+  if (pBlock->info.hasVarCol) {
+    int32_t numOfCols = taosArrayGetSize(pBlock->pDataBlock);
+    for (int32_t i = 1; i < numOfCols; ++i) {
+      SColumnInfoData* pCol = taosArrayGet(pBlock->pDataBlock, i);
+      if (IS_VAR_DATA_TYPE(pCol->info.type) && !colDataIsNull_s(pCol, iRow)) {
+        len += varDataTLen(colDataGetVarData(pCol, iRow));
+      }
+    }
+  }
+  return len;
+}
+
+void tGetSubmitColBlkRow(const SSDataBlock* pBlock, const STSchema* pTSchema, int32_t iRow, STSRow* pRow) {
+  SRowBuilder rb = {0};
+  tdSRowInit(&rb, pTSchema->version);
+  tdSRowSetTpInfo(&rb, pTSchema->numOfCols, pTSchema->flen);
+  tdSRowResetBuf(&rb, pRow);
+
+  // the columns of the block are those of the schema, in the same order, with some left out
+  int32_t numOfCols = taosArrayGetSize(pBlock->pDataBlock);
+  int32_t iCol = 0;
+  for (int32_t iSchema = 0; iSchema < pTSchema->numOfCols; ++iSchema) {
+    const STColumn*  pTColumn = &pTSchema->columns[iSchema];
+    SColumnInfoData* pCol = (iCol < numOfCols) ? taosArrayGet(pBlock->pDataBlock, iCol) : NULL;
+    if (pCol == NULL || pCol->info.colId != pTColumn->colId) {
+      tdAppendColValToRow(&rb, pTColumn->colId, pTColumn->type, TD_VTYPE_NONE, NULL, false, pTColumn->offset, iSchema);
+      continue;
+    }
+
+    ++iCol;
+    if (colDataIsNull_s(pCol, iRow)) {
+      tdAppendColValToRow(&rb, pTColumn->colId, pTColumn->type, TD_VTYPE_NULL, NULL, false, pTColumn->offset, iSchema);
+    } else {
+      tdAppendColValToRow(&rb, pTColumn->colId, pTColumn->type, TD_VTYPE_NORM, colDataGetData(pCol, iRow), true,
+                          pTColumn->offset, iSchema);
+    }
+  }
+  tdSRowEnd(&rb);
+}
+
 char* buildCtbNameByGroupId(const char* stbFullName, uint64_t groupId) {
   if (stbFullName[0] == 0) {
     return NULL;
@@ -2242,34 +2448,94 @@ char* buildCtbNameByGroupId(const char* stbFullName, uint64_t groupId) {
   return rname.ctbShortName;
 }
 
-int32_t blockEncode(const SSDataBlock* pBlock, char* data, int32_t numOfCols) {
-  int32_t dataLen = 0;
+typedef int32_t (*FColCodec)(void* pIn, int32_t nIn, int32_t nEle, void* pOut, int32_t nOut, uint8_t cmprAlg,
+                             void* pBuf, int32_t nBuf);
 
-  // todo extract method
-  int32_t* version = (int32_t*)data;
-  *version = 1;
+// The codecs of the column types, except float and double which always take the lossless ones: a block in a
+// query result has to arrive bit for bit, even if the lossy compression of stored data is on.
+static FColCodec blockGetCompFunc(int8_t type) {
+  if (type == TSDB_DATA_TYPE_FLOAT) {
+    return tsCompressFloatLossless;
+  } else if (type == TSDB_DATA_TYPE_DOUBLE) {
+    return tsCompressDoubleLossless;
+  }
+  return tDataTypes[type].compFunc;
+}
+
+static FColCodec blockGetDecompFunc(int8_t type) {
+  if (type == TSDB_DATA_TYPE_FLOAT) {
+    return tsDecompressFloatLossless;
+  } else if (type == TSDB_DATA_TYPE_DOUBLE) {
+    return tsDecompressDoubleLossless;
+  }
+  return tDataTypes[type].decompFunc;
+}
+
+// Compress one column with the codec of its type. The result is kept only if it is smaller than the raw data,
+// otherwise the raw data is copied, so a compressed length equal to the raw length means no compression.
+static int32_t blockCompressColumn(int8_t type, int32_t numOfRows, const char* pIn, int32_t rawLen, char* pOut,
+                                   char* pBuf, int32_t bufLen) {
+  if (pIn == NULL) {
+    memset(pOut, 0, rawLen);
+    return rawLen;
+  }
+
+  int32_t   len = -1;
+  FColCodec compFunc = blockGetCompFunc(type);
+  if (rawLen > 0 && compFunc != NULL) {
+    len = compFunc((void*)pIn, rawLen, numOfRows, pOut, rawLen + COMP_OVERFLOW_BYTES, TWO_STAGE_COMP, pBuf, bufLen);
+  }
+
+  if (len < 0 || len >= rawLen) {
+    memcpy(pOut, pIn, rawLen);
+    return rawLen;
+  }
+
+  return len;
+}
+
+static int32_t blockDecompressColData(int8_t type, int32_t numOfRows, const char* pIn, int32_t len, char* pOut,
+                                      int32_t rawLen) {
+  int32_t bufLen = rawLen + COMP_OVERFLOW_BYTES;
+  char*   pBuf = taosMemoryMalloc(bufLen);
+  if (pBuf == NULL) {
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    return -1;
+  }
+
+  int32_t   code = 0;
+  FColCodec decompFunc = blockGetDecompFunc(type);
+  if (decompFunc == NULL || decompFunc((void*)pIn, len, numOfRows, pOut, rawLen, TWO_STAGE_COMP, pBuf, bufLen) != rawLen) {
+    uError("failed to decompress column data, type:%d, rows:%d, len:%d, raw len:%d", type, numOfRows, len, rawLen);
+    terrno = TSDB_CODE_INVALID_MSG;
+    code = -1;
+  }
+
+  taosMemoryFree(pBuf);
+  return code;
+}
+
+// | version | total length | total rows | total columns | flag seg| block group id | column schema |
+static char* blockEncodeHeader(const SSDataBlock* pBlock, char* data, int32_t numOfCols, int32_t version) {
+  *(int32_t*)data = version;
   data += sizeof(int32_t);
 
-  int32_t* actualLen = (int32_t*)data;
+  // total length, filled in after all columns are encoded
   data += sizeof(int32_t);
 
-  int32_t* rows = (int32_t*)data;
-  *rows = pBlock->info.rows;
+  *(int32_t*)data = pBlock->info.rows;
   data += sizeof(int32_t);
-  ASSERT(*rows > 0);
+  ASSERT(pBlock->info.rows > 0);
 
-  int32_t* cols = (int32_t*)data;
-  *cols = numOfCols;
+  *(int32_t*)data = numOfCols;
   data += sizeof(int32_t);
 
   // flag segment.
   // the inital bit is for column info
-  int32_t* flagSegment = (int32_t*)data;
-  *flagSegment = (1 << 31);
-
+  *(int32_t*)data = (1 << 31);
   data += sizeof(int32_t);
 
-  uint64_t* groupId = (uint64_t*)data;
+  *(uint64_t*)data = pBlock->info.id.groupId;
   data += sizeof(uint64_t);
 
   for (int32_t i = 0; i < numOfCols; ++i) {
@@ -2282,6 +2548,15 @@ int32_t blockEncode(const SSDataBlock* pBlock, char* data, int32_t numOfCols) {
     data += sizeof(int32_t);
   }
 
+  return data;
+}
+
+int32_t blockEncode(const SSDataBlock* pBlock, char* data, int32_t numOfCols) {
+  int32_t dataLen = 0;
+
+  int32_t* actualLen = (int32_t*)(data + sizeof(int32_t));
+  data = blockEncodeHeader(pBlock, data, numOfCols, BLOCK_VERSION_1);
+
   int32_t* colSizes = (int32_t*)data;
   data += numOfCols * sizeof(int32_t);
 
@@ -2315,20 +2590,146 @@ int32_t blockEncode(const SSDataBlock* pBlock, char* data, int32_t numOfCols) {
   }
 
   *actualLen = dataLen;
-  *groupId = pBlock->info.id.groupId;
   ASSERT(dataLen > 0);
 
-  uDebug("build data block, actualLen:%d, rows:%d, cols:%d", dataLen, *rows, *cols);
+  uDebug("build data block, actualLen:%d, rows:%d, cols:%d", dataLen, pBlock->info.rows, numOfCols);
 
   return dataLen;
 }
 
+int32_t blockCompressEncode(const SSDataBlock* pBlock, char* data, int32_t numOfCols) {
+  int32_t numOfRows = pBlock->info.rows;
+  int32_t bufLen = 0;
+  for (int32_t col = 0; col < numOfCols; ++col) {
+    SColumnInfoData* pColRes = (SColumnInfoData*)taosArrayGet(pBlock->pDataBlock, col);
+    bufLen = TMAX(bufLen, colDataGetLength(pColRes, numOfRows) + COMP_OVERFLOW_BYTES);
+  }
+
+  char* pBuf = taosMemoryMalloc(bufLen);
+  if (pBuf == NULL) {
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    return -1;
+  }
+
+  int32_t* actualLen = (int32_t*)(data + sizeof(int32_t));
+  data = blockEncodeHeader(pBlock, data, numOfCols, BLOCK_VERSION_COMPRESSED);
+
+  int32_t* colSizes = (int32_t*)data;
+  data += numOfCols * sizeof(int32_t);
+  int32_t* rawSizes = (int32_t*)data;
+  data += numOfCols * sizeof(int32_t);
+
+  int32_t dataLen = blockDataGetSerialMetaSize(numOfCols) + numOfCols * sizeof(int32_t);
+  int32_t rawDataLen = blockDataGetSerialMetaSize(numOfCols);
+
+  for (int32_t col = 0; col < numOfCols; ++col) {
+    SColumnInfoData* pColRes = (SColumnInfoData*)taosArrayGet(pBlock->pDataBlock, col);
+
+    // the null bitmap and var data offsets are small, and sent as they are
+    size_t metaSize = 0;
+    if (IS_VAR_DATA_TYPE(pColRes->info.type)) {
+      metaSize = numOfRows * sizeof(int32_t);
+      memcpy(data, pColRes->varmeta.offset, metaSize);
+    } else {
+      metaSize = BitmapLen(numOfRows);
+      memcpy(data, pColRes->nullbitmap, metaSize);
+    }
+
+    data += metaSize;
+    dataLen += metaSize;
+
+    int32_t rawLen = colDataGetLength(pColRes, numOfRows);
+    int32_t len = blockCompressColumn(pColRes->info.type, numOfRows, pColRes->pData, rawLen, data, pBuf, bufLen);
+    data += len;
+    dataLen += len;
+    rawDataLen += metaSize + rawLen;
+
+    colSizes[col] = htonl(len);
+    rawSizes[col] = htonl(rawLen);
+  }
+
+  taosMemoryFree(pBuf);
+
+  *actualLen = dataLen;
+  uDebug("build compressed data block, actualLen:%d, rawLen:%d, rows:%d, cols:%d", dataLen, rawDataLen, numOfRows,
+         numOfCols);
+
+  return dataLen;
+}
+
+int32_t blockGetDecompressedSize(const char* pData) {
+  int32_t numOfRows = *(int32_t*)(pData + sizeof(int32_t) * 2);
+  int32_t numOfCols = *(int32_t*)(pData + sizeof(int32_t) * 3);
+  if (*(int32_t*)pData != BLOCK_VERSION_COMPRESSED) {
+    return *(int32_t*)(pData + sizeof(int32_t));
+  }
+
+  const char*    pSchema = pData + sizeof(int32_t) * 5 + sizeof(uint64_t);
+  const int32_t* rawLen = (const int32_t*)(pData + blockDataGetSerialMetaSize(numOfCols));
+
+  int32_t len = blockDataGetSerialMetaSize(numOfCols);
+  for (int32_t i = 0; i < numOfCols; ++i) {
+    int8_t type = *(int8_t*)(pSchema + i * (sizeof(int8_t) + sizeof(int32_t)));
+    len += IS_VAR_DATA_TYPE(type) ? sizeof(int32_t) * numOfRows : BitmapLen(numOfRows);
+    len += htonl(rawLen[i]);
+  }
+
+  return len;
+}
+
+int32_t blockDecompressEncode(const char* pData, char* pOut) {
+  ASSERT(*(int32_t*)pData == BLOCK_VERSION_COMPRESSED);
+
+  int32_t numOfRows = *(int32_t*)(pData + sizeof(int32_t) * 2);
+  int32_t numOfCols = *(int32_t*)(pData + sizeof(int32_t) * 3);
+
+  // the header and the column schema do not change
+  int32_t     metaSize = blockDataGetSerialMetaSize(numOfCols) - numOfCols * sizeof(int32_t);
+  const char* pSchema = pData + sizeof(int32_t) * 5 + sizeof(uint64_t);
+  memcpy(pOut, pData, metaSize);
+  *(int32_t*)pOut = BLOCK_VERSION_1;
+
+  const int32_t* colLen = (const int32_t*)(pData + metaSize);
+  const int32_t* rawLen = colLen + numOfCols;
+  const char*    pStart = (const char*)(rawLen + numOfCols);
+
+  // the length of each column is the raw length in a version 1 block
+  memcpy(pOut + metaSize, rawLen, numOfCols * sizeof(int32_t));
+  char* p = pOut + metaSize + numOfCols * sizeof(int32_t);
+
+  for (int32_t i = 0; i < numOfCols; ++i) {
+    int8_t  type = *(int8_t*)(pSchema + i * (sizeof(int8_t) + sizeof(int32_t)));
+    int32_t len = htonl(colLen[i]);
+    int32_t raw = htonl(rawLen[i]);
+
+    int32_t bitmapLen = IS_VAR_DATA_TYPE(type) ? sizeof(int32_t) * numOfRows : BitmapLen(numOfRows);
+    memcpy(p, pStart, bitmapLen);
+    p += bitmapLen;
+    pStart += bitmapLen;
+
+    if (len != raw) {
+      if (blockDecompressColData(type, numOfRows, pStart, len, p, raw) < 0) {
+        return -1;
+      }
+    } else if (len > 0) {
+      memcpy(p, pStart, len);
+    }
+
+    p += raw;
+    pStart += len;
+  }
+
+  int32_t dataLen = p - pOut;
+  *(int32_t*)(pOut + sizeof(int32_t)) = dataLen;
+  return dataLen;
+}
+
 const char* blockDecode(SSDataBlock* pBlock, const char* pData) {
   const char* pStart = pData;
 
   int32_t version = *(int32_t*)pStart;
   pStart += sizeof(int32_t);
-  ASSERT(version == 1);
+  ASSERT(version == BLOCK_VERSION_1 || version == BLOCK_VERSION_COMPRESSED);
 
   // total length sizeof(int32_t)
   int32_t dataLen = *(int32_t*)pStart;
@@ -2374,32 +2775,45 @@ const char* blockDecode(SSDataBlock* pBlock, const char* pData) {
   int32_t* colLen = (int32_t*)pStart;
   pStart += sizeof(int32_t) * numOfCols;
 
+  // the length of each column before compression
+  const int32_t* rawLen = NULL;
+  if (version == BLOCK_VERSION_COMPRESSED) {
+    rawLen = (const int32_t*)pStart;
+    pStart += sizeof(int32_t) * numOfCols;
+  }
+
   for (int32_t i = 0; i < numOfCols; ++i) {
     colLen[i] = htonl(colLen[i]);
     ASSERT(colLen[i] >= 0);
 
+    int32_t len = (rawLen != NULL) ? htonl(rawLen[i]) : colLen[i];
+
     SColumnInfoData* pColInfoData = taosArrayGet(pBlock->pDataBlock, i);
     if (IS_VAR_DATA_TYPE(pColInfoData->info.type)) {
       memcpy(pColInfoData->varmeta.offset, pStart, sizeof(int32_t) * numOfRows);
       pStart += sizeof(int32_t) * numOfRows;
 
-      if (colLen[i] > 0 && pColInfoData->varmeta.allocLen < colLen[i]) {
-        char* tmp = taosMemoryRealloc(pColInfoData->pData, colLen[i]);
+      if (len > 0 && pColInfoData->varmeta.allocLen < len) {
+        char* tmp = taosMemoryRealloc(pColInfoData->pData, len);
         if (tmp == NULL) {
           return NULL;
         }
 
         pColInfoData->pData = tmp;
-        pColInfoData->varmeta.allocLen = colLen[i];
+        pColInfoData->varmeta.allocLen = len;
       }
 
-      pColInfoData->varmeta.length = colLen[i];
+      pColInfoData->varmeta.length = len;
     } else {
       memcpy(pColInfoData->nullbitmap, pStart, BitmapLen(numOfRows));
       pStart += BitmapLen(numOfRows);
     }
 
-    if (colLen[i] > 0) {
+    if (colLen[i] != len) {
+      if (blockDecompressColData(pColInfoData->info.type, numOfRows, pStart, colLen[i], pColInfoData->pData, len) < 0) {
+        return NULL;
+      }
+    } else if (colLen[i] > 0) {
       memcpy(pColInfoData->pData, pStart, colLen[i]);
     }
 
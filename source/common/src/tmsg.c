@@ -85,12 +85,26 @@ int32_t tGetSubmitMsgNext(SSubmitMsgIter *pIter, SSubmitBlk **pPBlock) {
 
 int32_t tInitSubmitBlkIter(SSubmitMsgIter *pMsgIter, SSubmitBlk *pBlock, SSubmitBlkIter *pIter) {
   if (pMsgIter->dataLen <= 0) return -1;
+  if (tGetSubmitColHead(pMsgIter, pBlock) != NULL) {
+    pIter->totalLen = 0;
+    pIter->len = 0;
+    pIter->row = NULL;
+    return 0;
+  }
   pIter->totalLen = pMsgIter->dataLen;
   pIter->len = 0;
   pIter->row = (STSRow *)(pBlock->data + pMsgIter->schemaLen);
   return 0;
 }
 
+SSubmitColHead *tGetSubmitColHead(SSubmitMsgIter *pMsgIter, SSubmitBlk *pBlock) {
+  if (pMsgIter->dataLen < (int32_t)sizeof(SSubmitColHead)) return NULL;
+
+  SSubmitColHead *pHead = (SSubmitColHead *)(pBlock->data + pMsgIter->schemaLen);
+  if (TD_ROW_TYPE(SUBMIT_COL_HEAD_ROW(pHead)) != TD_ROW_COL) return NULL;
+  return pHead;
+}
+
 STSRow *tGetSubmitBlkNext(SSubmitBlkIter *pIter) {
   STSRow *row = pIter->row;
 
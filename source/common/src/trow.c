@@ -36,9 +36,6 @@ const uint8_t tdVTypeByte[2][3] = {{
 static uint8_t tdGetBitmapByte(uint8_t byte);
 static bool    tdSTSRowIterGetTpVal(STSRowIter *pIter, col_type_t colType, int32_t offset, SCellVal *pVal);
 static bool    tdSTSRowIterGetKvVal(STSRowIter *pIter, col_id_t colId, col_id_t *nIdx, SCellVal *pVal);
-static bool    tdSTpRowGetVal(STSRow *pRow, col_id_t colId, col_type_t colType, int32_t flen, uint32_t offset,
-                              col_id_t colIdx, SCellVal *pVal);
-static bool    tdSKvRowGetVal(STSRow *pRow, col_id_t colId, col_id_t colIdx, SCellVal *pVal);
 static void    tdSCellValPrint(SCellVal *pVal, int8_t colType);
 
 // implementation
@@ -782,6 +779,55 @@ int32_t tdAppendColValToTpRow(SRowBuilder *pBuilder, TDRowValT valType, const vo
   return 0;
 }
 
+int32_t tdAppendColValsToTpRows(SRowBuilder *pBuilder, void *pRows, int32_t rowSize, int32_t nRows, int8_t colType,
+                                int16_t colIdx, int32_t offset, const void *pVals, int32_t valStride,
+                                const char *pIsNull, bool *pRowHasNull) {
+  if (colIdx < 1 || IS_VAR_DATA_TYPE(colType) || !TD_IS_TP_ROW_T(pBuilder->rowType)) {
+    terrno = TSDB_CODE_INVALID_PARA;
+    return terrno;
+  }
+  --colIdx;
+
+  int32_t bytes = TYPE_BYTES[colType];
+  for (int32_t r = 0; r < nRows; ++r) {
+    STSRow     *row = (STSRow *)POINTER_SHIFT(pRows, rowSize * r);
+    const void *val = POINTER_SHIFT(pVals, valStride * r);
+    char       *ptr = (char *)POINTER_SHIFT(TD_ROW_DATA(row), offset);
+
+    if (pIsNull && pIsNull[r]) {
+      tdSetBitmapValTypeII(tdGetBitmapAddrTp(row, pBuilder->flen), colIdx, TD_VTYPE_NULL);
+      if (pRowHasNull) {
+        pRowHasNull[r] = true;
+      } else {
+        pBuilder->hasNull = true;
+      }
+      continue;
+    }
+
+    // constant sizes let the copies be inlined
+    switch (bytes) {
+      case sizeof(int8_t):
+        memcpy(ptr, val, sizeof(int8_t));
+        break;
+      case sizeof(int16_t):
+        memcpy(ptr, val, sizeof(int16_t));
+        break;
+      case sizeof(int32_t):
+        memcpy(ptr, val, sizeof(int32_t));
+        break;
+      case sizeof(int64_t):
+        memcpy(ptr, val, sizeof(int64_t));
+        break;
+      default:
+        memcpy(ptr, val, bytes);
+        break;
+    }
+    tdSetBitmapValTypeII(tdGetBitmapAddrTp(row, pBuilder->flen), colIdx, TD_VTYPE_NORM);
+  }
+
+  return 0;
+}
+
 int32_t tdSRowSetExtendedInfo(SRowBuilder *pBuilder, int32_t nCols, int32_t nBoundCols, int32_t flen,
                               int32_t allNullLen, int32_t boundNullLen) {
   if ((boundNullLen > 0) && (allNullLen > 0) && (nBoundCols > 0)) {
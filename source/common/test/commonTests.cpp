@@ -1,4 +1,5 @@
 #include <gtest/gtest.h>
+#include <algorithm>
 #include <iostream>
 
 #pragma GCC diagnostic push
@@ -12,10 +13,224 @@
 #include "tcommon.h"
 #include "tdatablock.h"
 #include "tdef.h"
+#include "trow.h"
 #include "tvariant.h"
 
 namespace {
-//
+const int32_t kRowBufSize = 128;
+
+// ts timestamp, c1 int, c2 double, c3 binary(16), c4 bigint, c5 tinyint
+STSchema* genRowsSchema() {
+  STSchemaBuilder sb = {0};
+  tdInitTSchemaBuilder(&sb, 1);
+  tdAddColToSchema(&sb, TSDB_DATA_TYPE_TIMESTAMP, 0, 1, 8);
+  tdAddColToSchema(&sb, TSDB_DATA_TYPE_INT, 0, 2, 4);
+  tdAddColToSchema(&sb, TSDB_DATA_TYPE_DOUBLE, 0, 3, 8);
+  tdAddColToSchema(&sb, TSDB_DATA_TYPE_BINARY, 0, 4, 16 + VARSTR_HEADER_SIZE);
+  tdAddColToSchema(&sb, TSDB_DATA_TYPE_BIGINT, 0, 5, 8);
+  tdAddColToSchema(&sb, TSDB_DATA_TYPE_TINYINT, 0, 6, 1);
+  STSchema* pSchema = tdGetSchemaFromBuilder(&sb);
+  tdDestroyTSchemaBuilder(&sb);
+  return pSchema;
+}
+
+bool rowsCellIsNull(int32_t iCol, int32_t r) {
+  switch (iCol) {
+    case 1:
+      return r % 3 == 1;
+    case 2:
+      return r % 4 == 2;
+    case 3:
+      return r % 5 == 3;
+    case 4:
+      return r % 7 == 5;
+    default:
+      return false;
+  }
+}
+
+// the value of column iCol in row r, var data is put in pVarBuf
+void rowsCellValue(int32_t iCol, int32_t r, SValue* pVal, char* pVarBuf) {
+  switch (iCol) {
+    case 0:
+      pVal->val = 1660000000000 + r;
+      break;
+    case 1:
+      pVal->val = r * 10;
+      break;
+    case 2: {
+      double d = r * 0.5;
+      memcpy(&pVal->val, &d, sizeof(d));
+    } break;
+    case 3:
+      varDataSetLen(pVarBuf, sprintf(varDataVal(pVarBuf), "row%d", r));
+      pVal->pData = (uint8_t*)pVarBuf;
+      break;
+    case 4:
+      pVal->val = -r;
+      break;
+    default:
+      pVal->val = r % 100;
+      break;
+  }
+}
+
+void rowsAppendInfo(SRowBuilder* pBuilder, STSchema* pSchema, int32_t iCol, int32_t k, int32_t* offset,
+                    col_id_t* colIdx) {
+  if (TD_IS_TP_ROW_T(pBuilder->rowType)) {
+    *offset = pSchema->columns[iCol].offset;
+    *colIdx = iCol;
+  } else {
+    *offset = k * sizeof(SKvRowIdx);
+    *colIdx = k;
+  }
+}
+
+void rowsAppendCell(SRowBuilder* pBuilder, STSchema* pSchema, int32_t iCol, int32_t k, int32_t r) {
+  STColumn* pCol = &pSchema->columns[iCol];
+  int32_t   offset = 0;
+  col_id_t  colIdx = 0;
+  SValue    val = {0};
+  char      varBuf[32] = {0};
+
+  rowsAppendInfo(pBuilder, pSchema, iCol, k, &offset, &colIdx);
+  if (rowsCellIsNull(iCol, r)) {
+    tdAppendColValToRow(pBuilder, pCol->colId, pCol->type, TD_VTYPE_NULL, NULL, false, offset, colIdx);
+    return;
+  }
+
+  rowsCellValue(iCol, r, &val, varBuf);
+  const void* pData = IS_VAR_DATA_TYPE(pCol->type) ? (const void*)val.pData : (const void*)&val.val;
+  tdAppendColValToRow(pBuilder, pCol->colId, pCol->type, TD_VTYPE_NORM, pData, true, offset, colIdx);
+}
+
+// the way rows are built one after another: every bound cell of a row, then the row is ended
+void buildRowsByRow(SRowBuilder* pBuilder, STSchema* pSchema, const int32_t* pBound, int32_t nBound, char* pRows,
+                    int32_t nRows) {
+  for (int32_t r = 0; r < nRows; ++r) {
+    tdSRowResetBuf(pBuilder, pRows + kRowBufSize * r);
+    for (int32_t k = 0; k < nBound; ++k) {
+      rowsAppendCell(pBuilder, pSchema, pBound[k], k, r);
+    }
+    if (nBound < pSchema->numOfCols && TD_IS_TP_ROW_T(pBuilder->rowType)) {
+      pBuilder->hasNone = true;
+    }
+    tdSRowEnd(pBuilder);
+  }
+}
+
+// the way stmt binds a batch: column after column, fixed length tuple columns in one call
+int32_t buildRowsByCol(SRowBuilder* pBuilder, STSchema* pSchema, const int32_t* pBound, int32_t nBound, char* pRows,
+                       int32_t nRows) {
+  bool    rowHasNull[64] = {0};
+  int64_t vals[64] = {0};
+  char    isNull[64] = {0};
+
+  for (int32_t r = 0; r < nRows; ++r) {
+    tdSRowResetBuf(pBuilder, pRows + kRowBufSize * r);
+  }
+
+  for (int32_t k = 0; k < nBound; ++k) {
+    int32_t   iCol = pBound[k];
+    STColumn* pCol = &pSchema->columns[iCol];
+
+    if (TD_IS_TP_ROW_T(pBuilder->rowType) && iCol > 0 && !IS_VAR_DATA_TYPE(pCol->type)) {
+      int32_t  offset = 0;
+      col_id_t colIdx = 0;
+      rowsAppendInfo(pBuilder, pSchema, iCol, k, &offset, &colIdx);
+      for (int32_t r = 0; r < nRows; ++r) {
+        SValue val = {0};
+        rowsCellValue(iCol, r, &val, NULL);
+        vals[r] = val.val;
+        isNull[r] = rowsCellIsNull(iCol, r);
+      }
+      int32_t code = tdAppendColValsToTpRows(pBuilder, pRows, kRowBufSize, nRows, pCol->type, colIdx, offset, vals,
+                                             sizeof(int64_t), isNull, rowHasNull);
+      if (code != TSDB_CODE_SUCCESS) {
+        return code;
+      }
+      continue;
+    }
+
+    for (int32_t r = 0; r < nRows; ++r) {
+      tdSRowGetBuf(pBuilder, pRows + kRowBufSize * r);
+      pBuilder->hasNull = false;
+      rowsAppendCell(pBuilder, pSchema, iCol, k, r);
+      rowHasNull[r] |= pBuilder->hasNull;
+    }
+  }
+
+  for (int32_t r = 0; r < nRows; ++r) {
+    tdSRowGetBuf(pBuilder, pRows + kRowBufSize * r);
+    pBuilder->hasNull = rowHasNull[r];
+    pBuilder->hasNone = nBound < pSchema->numOfCols && TD_IS_TP_ROW_T(pBuilder->rowType);
+    tdSRowEnd(pBuilder);
+  }
+  return TSDB_CODE_SUCCESS;
+}
+
+void checkRows(STSchema* pSchema, const int32_t* pBound, int32_t nBound, char* pRows, int32_t nRows) {
+  for (int32_t r = 0; r < nRows; ++r) {
+    STSRow* pRow = (STSRow*)(pRows + kRowBufSize * r);
+    bool    hasNull = false;
+    bool    hasNone = false;
+
+    for (int32_t iCol = 0; iCol < pSchema->numOfCols; ++iCol) {
+      bool bound = std::find(pBound, pBound + nBound, iCol) != pBound + nBound;
+      SColVal cv = {0};
+      tTSRowGetVal(pRow, pSchema, iCol, &cv);
+      if (!bound) {
+        ASSERT_TRUE(COL_VAL_IS_NONE(&cv)) << "row " << r << " col " << iCol;
+        hasNone = true;
+        continue;
+      }
+      if (rowsCellIsNull(iCol, r)) {
+        ASSERT_TRUE(COL_VAL_IS_NULL(&cv)) << "row " << r << " col " << iCol;
+        hasNull = true;
+        continue;
+      }
+
+      SValue expect = {0};
+      char   varBuf[32] = {0};
+      rowsCellValue(iCol, r, &expect, varBuf);
+      ASSERT_TRUE(COL_VAL_IS_VALUE(&cv)) << "row " << r << " col " << iCol;
+      if (iCol == 0) {
+        ASSERT_EQ(TD_ROW_KEY(pRow), expect.val);
+      } else if (IS_VAR_DATA_TYPE(pSchema->columns[iCol].type)) {
+        ASSERT_EQ(cv.value.nData, varDataLen(varBuf));
+        ASSERT_EQ(memcmp(cv.value.pData, varDataVal(varBuf), cv.value.nData), 0);
+      } else {
+        ASSERT_EQ(memcmp(&cv.value.val, &expect.val, pSchema->columns[iCol].bytes), 0) << "row " << r << " col " << iCol;
+      }
+    }
+
+    // a kv row leaves its unbound columns out instead of marking them none
+    ASSERT_EQ(pRow->statis, (hasNull || (hasNone && TD_IS_TP_ROW(pRow))) ? 1 : 0) << "row " << r;
+  }
+}
+// a block of the bound columns, in the order of the schema, with the cells of the rows above
+SSDataBlock* genRowsColBlock(STSchema* pSchema, const int32_t* pBound, int32_t nBound, int32_t nRows) {
+  SSDataBlock* pBlock = createDataBlock();
+  for (int32_t k = 0; k < nBound; ++k) {
+    STColumn*       pCol = &pSchema->columns[pBound[k]];
+    SColumnInfoData colInfo = createColumnInfoData(pCol->type, pCol->bytes, pCol->colId);
+    blockDataAppendColInfo(pBlock, &colInfo);
+  }
+  blockDataEnsureCapacity(pBlock, nRows);
+
+  for (int32_t k = 0; k < nBound; ++k) {
+    SColumnInfoData* pColData = (SColumnInfoData*)taosArrayGet(pBlock->pDataBlock, k);
+    for (int32_t r = 0; r < nRows; ++r) {
+      SValue val = {0};
+      char   varBuf[32] = {0};
+      rowsCellValue(pBound[k], r, &val, varBuf);
+      const char* pData = IS_VAR_DATA_TYPE(pColData->info.type) ? (const char*)val.pData : (const char*)&val.val;
+      colDataAppend(pColData, r, pData, rowsCellIsNull(pBound[k], r));
+    }
+  }
+  pBlock->info.rows = nRows;
+  return pBlock;
+}
 }  // namespace
 
 int main(int argc, char** argv) {
@@ -260,4 +475,290 @@ TEST(testCase, var_dataBlock_split_test) {
   }
 }
 
+TEST(testCase, compress_encode_test) {
+  int32_t numOfRows = 4096;
+
+  SSDataBlock* b = createDataBlock();
+
+  SColumnInfoData infoData = createColumnInfoData(TSDB_DATA_TYPE_TIMESTAMP, 8, 1);
+  blockDataAppendColInfo(b, &infoData);
+  infoData = createColumnInfoData(TSDB_DATA_TYPE_INT, 4, 2);
+  blockDataAppendColInfo(b, &infoData);
+  infoData = createColumnInfoData(TSDB_DATA_TYPE_DOUBLE, 8, 3);
+  blockDataAppendColInfo(b, &infoData);
+  infoData = createColumnInfoData(TSDB_DATA_TYPE_BOOL, 1, 4);
+  blockDataAppendColInfo(b, &infoData);
+  infoData = createColumnInfoData(TSDB_DATA_TYPE_BINARY, 40, 5);
+  blockDataAppendColInfo(b, &infoData);
+
+  blockDataEnsureCapacity(b, numOfRows);
+
+  char buf[41] = {0};
+  char buf1[100] = {0};
+  for (int32_t i = 0; i < numOfRows; ++i) {
+    int64_t ts = 1660000000000 + i * 1000;
+    int32_t v = i % 100;
+    double  d = i * 0.5;
+    int8_t  bv = i & 0x01;
+    colDataAppend((SColumnInfoData*)taosArrayGet(b->pDataBlock, 0), i, (const char*)&ts, false);
+    colDataAppend((SColumnInfoData*)taosArrayGet(b->pDataBlock, 1), i, (const char*)&v, (i % 7) == 0);
+    colDataAppend((SColumnInfoData*)taosArrayGet(b->pDataBlock, 2), i, (const char*)&d, false);
+    colDataAppend((SColumnInfoData*)taosArrayGet(b->pDataBlock, 3), i, (const char*)&bv, false);
+
+    sprintf(buf, "the number of row:%d", i % 16);
+    STR_TO_VARSTR(buf1, buf)
+    colDataAppend((SColumnInfoData*)taosArrayGet(b->pDataBlock, 4), i, buf1, (i % 5) == 0);
+    b->info.rows++;
+  }
+
+  int32_t numOfCols = blockDataGetNumOfCols(b);
+  char*   pRaw = (char*)taosMemoryCalloc(1, blockGetEncodeSize(b));
+  char*   pComp = (char*)taosMemoryCalloc(1, blockGetCompressEncodeSize(b));
+  int32_t rawLen = blockEncode(b, pRaw, numOfCols);
+  int32_t compLen = blockCompressEncode(b, pComp, numOfCols);
+  ASSERT_GT(compLen, 0);
+  ASSERT_LT(compLen, rawLen / 2);
+  ASSERT_EQ(*(int32_t*)pComp, BLOCK_VERSION_COMPRESSED);
+
+  // converted back, it is the same as the uncompressed encoding
+  ASSERT_EQ(blockGetDecompressedSize(pComp), rawLen);
+  char* pOut = (char*)taosMemoryCalloc(1, rawLen);
+  ASSERT_EQ(blockDecompressEncode(pComp, pOut), rawLen);
+  ASSERT_EQ(memcmp(pOut, pRaw, rawLen), 0);
+
+  SSDataBlock* pDecoded = createOneDataBlock(b, false);
+  const char*  pEnd = blockDecode(pDecoded, pComp);
+  ASSERT_EQ(pEnd - pComp, compLen);
+  ASSERT_EQ(pDecoded->info.rows, numOfRows);
+  for (int32_t col = 0; col < numOfCols; ++col) {
+    SColumnInfoData* p0 = (SColumnInfoData*)taosArrayGet(b->pDataBlock, col);
+    SColumnInfoData* p1 = (SColumnInfoData*)taosArrayGet(pDecoded->pDataBlock, col);
+    for (int32_t i = 0; i < numOfRows; ++i) {
+      bool isNull = colDataIsNull(p0, numOfRows, i, NULL);
+      ASSERT_EQ(colDataIsNull(p1, numOfRows, i, NULL), isNull);
+      if (isNull) {
+        continue;
+      }
+
+      char* v0 = colDataGetData(p0, i);
+      char* v1 = colDataGetData(p1, i);
+      int32_t len = IS_VAR_DATA_TYPE(p0->info.type) ? varDataTLen(v0) : p0->info.bytes;
+      ASSERT_EQ(memcmp(v0, v1, len), 0);
+    }
+  }
+
+  taosMemoryFree(pRaw);
+  taosMemoryFree(pComp);
+  taosMemoryFree(pOut);
+  blockDataDestroy(pDecoded);
+  blockDataDestroy(b);
+}
+
+// float and double columns come back bit for bit, also when the lossy compression of stored data is on
+TEST(testCase, compress_encode_float_lossless) {
+#ifdef TD_TSZ
+  bool lossy[2] = {lossyFloat, lossyDouble};
+  lossyFloat = true;
+  lossyDouble = true;
+#endif
+  int32_t numOfRows = 4096;
+
+  SSDataBlock* b = createDataBlock();
+
+  SColumnInfoData infoData = createColumnInfoData(TSDB_DATA_TYPE_FLOAT, 4, 1);
+  blockDataAppendColInfo(b, &infoData);
+  infoData = createColumnInfoData(TSDB_DATA_TYPE_DOUBLE, 8, 2);
+  blockDataAppendColInfo(b, &infoData);
+  blockDataEnsureCapacity(b, numOfRows);
+
+  // slowly changing values with noise in the low bits, a lossy codec would not keep them
+  for (int32_t i = 0; i < numOfRows; ++i) {
+    float  f = 20.0f + (i / 64) * 0.1f + (taosRand() % 1000) * 1e-6f;
+    double d = 1e6 + i * 0.001 + (taosRand() % 1000000) * 1e-12;
+    colDataAppend((SColumnInfoData*)taosArrayGet(b->pDataBlock, 0), i, (const char*)&f, (i % 13) == 0);
+    colDataAppend((SColumnInfoData*)taosArrayGet(b->pDataBlock, 1), i, (const char*)&d, false);
+    b->info.rows++;
+  }
+
+  int32_t numOfCols = blockDataGetNumOfCols(b);
+  char*   pComp = (char*)taosMemoryCalloc(1, blockGetCompressEncodeSize(b));
+  int32_t compLen = blockCompressEncode(b, pComp, numOfCols);
+  ASSERT_GT(compLen, 0);
+
+  SSDataBlock* pDecoded = createOneDataBlock(b, false);
+  blockDecode(pDecoded, pComp);
+  ASSERT_EQ(pDecoded->info.rows, numOfRows);
+  for (int32_t col = 0; col < numOfCols; ++col) {
+    SColumnInfoData* p0 = (SColumnInfoData*)taosArrayGet(b->pDataBlock, col);
+    SColumnInfoData* p1 = (SColumnInfoData*)taosArrayGet(pDecoded->pDataBlock, col);
+    for (int32_t i = 0; i < numOfRows; ++i) {
+      bool isNull = colDataIsNull(p0, numOfRows, i, NULL);
+      ASSERT_EQ(colDataIsNull(p1, numOfRows, i, NULL), isNull);
+      if (!isNull) {
+        ASSERT_EQ(memcmp(colDataGetData(p0, i), colDataGetData(p1, i), p0->info.bytes), 0);
+      }
+    }
+  }
+
+  taosMemoryFree(pComp);
+  blockDataDestroy(pDecoded);
+  blockDataDestroy(b);
+#ifdef TD_TSZ
+  lossyFloat = lossy[0];
+  lossyDouble = lossy[1];
+#endif
+}
+
+TEST(testCase, append_col_vals_to_tp_rows) {
+  const int32_t nRows = 40;
+  STSchema*     pSchema = genRowsSchema();
+  char*         pByRow = (char*)taosMemoryCalloc(nRows, kRowBufSize);
+  char*         pByCol = (char*)taosMemoryCalloc(nRows, kRowBufSize);
+
+  // every column bound, then c4 left unbound
+  int32_t allBound[] = {0, 1, 2, 3, 4, 5};
+  int32_t partBound[] = {0, 1, 2, 3, 5};
+  struct {
+    int32_t* pBound;
+    int32_t  nBound;
+  } cases[] = {{allBound, tListLen(allBound)}, {partBound, tListLen(partBound)}};
+
+  for (auto& c : cases) {
+    SRowBuilder rb = {0};
+    tdSRowInit(&rb, pSchema->version);
+    tdSRowSetTpInfo(&rb, pSchema->numOfCols, pSchema->flen);
+
+    memset(pByRow, 0, nRows * kRowBufSize);
+    memset(pByCol, 0, nRows * kRowBufSize);
+    buildRowsByRow(&rb, pSchema, c.pBound, c.nBound, pByRow, nRows);
+    ASSERT_EQ(buildRowsByCol(&rb, pSchema, c.pBound, c.nBound, pByCol, nRows), TSDB_CODE_SUCCESS);
+
+    checkRows(pSchema, c.pBound, c.nBound, pByRow, nRows);
+    checkRows(pSchema, c.pBound, c.nBound, pByCol, nRows);
+    for (int32_t r = 0; r < nRows; ++r) {
+      STSRow* pRow = (STSRow*)(pByRow + kRowBufSize * r);
+      ASSERT_EQ(memcmp(pRow, pByCol + kRowBufSize * r, TD_ROW_LEN(pRow)), 0) << "row " << r;
+    }
+  }
+
+  taosMemoryFree(pByCol);
+  taosMemoryFree(pByRow);
+  taosMemoryFree(pSchema);
+}
+
+TEST(testCase, append_col_vals_to_kv_rows) {
+  const int32_t nRows = 40;
+  STSchema*     pSchema = genRowsSchema();
+  char*         pRows = (char*)taosMemoryCalloc(nRows, kRowBufSize);
+  int32_t       bound[] = {0, 2, 3, 5};
+  int64_t       vals[nRows] = {0};
+
+  SRowBuilder rb = {0};
+  tdSRowInit(&rb, pSchema->version);
+  tdSRowSetInfo(&rb, pSchema->numOfCols, tListLen(bound), pSchema->flen);
+  rb.rowType = TD_ROW_KV;
+
+  // kv rows and var data are not laid out at fixed offsets, so they go cell by cell
+  int32_t offset = 0;
+  col_id_t colIdx = 0;
+  rowsAppendInfo(&rb, pSchema, 5, 3, &offset, &colIdx);
+  ASSERT_EQ(tdAppendColValsToTpRows(&rb, pRows, kRowBufSize, nRows, TSDB_DATA_TYPE_TINYINT, colIdx, offset, vals,
+                                    sizeof(int64_t), NULL, NULL),
+            TSDB_CODE_INVALID_PARA);
+  rb.rowType = TD_ROW_TP;
+  ASSERT_EQ(tdAppendColValsToTpRows(&rb, pRows, kRowBufSize, nRows, TSDB_DATA_TYPE_BINARY, 3,
+                                    pSchema->columns[3].offset, vals, sizeof(int64_t), NULL, NULL),
+            TSDB_CODE_INVALID_PARA);
+  rb.rowType = TD_ROW_KV;
+
+  ASSERT_EQ(buildRowsByCol(&rb, pSchema, bound, tListLen(bound), pRows, nRows), TSDB_CODE_SUCCESS);
+  for (int32_t r = 0; r < nRows; ++r) {
+    ASSERT_TRUE(TD_IS_KV_ROW((STSRow*)(pRows + kRowBufSize * r)));
+  }
+  checkRows(pSchema, bound, tListLen(bound), pRows, nRows);
+
+  taosMemoryFree(pRows);
+  taosMemoryFree(pSchema);
+}
+
+TEST(testCase, submit_col_blk_test) {
+  const int32_t nRows = 40;
+  STSchema*     pSchema = genRowsSchema();
+  char*         pByRow = (char*)taosMemoryCalloc(nRows, kRowBufSize);
+  char*         pByCol = (char*)taosMemoryCalloc(nRows, kRowBufSize);
+
+  // every column bound, then c4 left unbound
+  int32_t allBound[] = {0, 1, 2, 3, 4, 5};
+  int32_t partBound[] = {0, 1, 2, 3, 5};
+  struct {
+    int32_t* pBound;
+    int32_t  nBound;
+  } cases[] = {{allBound, tListLen(allBound)}, {partBound, tListLen(partBound)}};
+
+  for (auto& c : cases) {
+    SSDataBlock* pBlock = genRowsColBlock(pSchema, c.pBound, c.nBound, nRows);
+    int32_t      size = tGetSubmitColBlkSize(pBlock);
+    char*        pBuf = (char*)taosMemoryCalloc(1, size);
+    int32_t      len = tEncodeSubmitColBlk(pBlock, pBuf);
+    ASSERT_GT(len, 0);
+    ASSERT_LE(len, size);
+
+    SSubmitColHead* pHead = (SSubmitColHead*)pBuf;
+    ASSERT_EQ(TD_ROW_TYPE(SUBMIT_COL_HEAD_ROW(pHead)), TD_ROW_COL);
+    ASSERT_EQ(TD_ROW_LEN(SUBMIT_COL_HEAD_ROW(pHead)), len);
+    ASSERT_EQ(TD_ROW_KEY(SUBMIT_COL_HEAD_ROW(pHead)), 1660000000000);
+    ASSERT_EQ(pHead->ekey, 1660000000000 + nRows - 1);
+    ASSERT_EQ(pHead->numOfCols, c.nBound);
+
+    SSDataBlock decoded = {0};
+    ASSERT_EQ(tDecodeSubmitColBlk(pHead, len, pSchema, &decoded), TSDB_CODE_SUCCESS);
+    ASSERT_EQ(decoded.info.rows, nRows);
+    ASSERT_EQ(taosArrayGetSize(decoded.pDataBlock), c.nBound);
+
+    // the rows of the decoded block are those built a row at a time
+    SRowBuilder rb = {0};
+    tdSRowInit(&rb, pSchema->version);
+    tdSRowSetTpInfo(&rb, pSchema->numOfCols, pSchema->flen);
+    buildRowsByRow(&rb, pSchema, c.pBound, c.nBound, pByRow, nRows);
+    for (int32_t r = 0; r < nRows; ++r) {
+      ASSERT_LE(tGetSubmitColBlkRowLen(&decoded, pSchema, r), kRowBufSize);
+      tGetSubmitColBlkRow(&decoded, pSchema, r, (STSRow*)(pByCol + kRowBufSize * r));
+    }
+    checkRows(pSchema, c.pBound, c.nBound, pByCol, nRows);
+    for (int32_t r = 0; r < nRows; ++r) {
+      STSRow* pRow = (STSRow*)(pByRow + kRowBufSize * r);
+      ASSERT_EQ(TD_ROW_LEN((STSRow*)(pByCol + kRowBufSize * r)), TD_ROW_LEN(pRow)) << "row " << r;
+      ASSERT_EQ(tGetSubmitColBlkRowLen(&decoded, pSchema, r), TD_ROW_LEN(pRow)) << "row " << r;
+    }
+    blockDataFreeRes(&decoded);
+
+    // a truncated block, and one whose keys are not in ascending order, are refused
+    memset(&decoded, 0, sizeof(decoded));
+    ASSERT_EQ(tDecodeSubmitColBlk(pHead, len - 1, pSchema, &decoded), TSDB_CODE_INVALID_MSG);
+    blockDataFreeRes(&decoded);
+
+    SColumnInfoData* pTsCol = (SColumnInfoData*)taosArrayGet(pBlock->pDataBlock, 0);
+    ((TSKEY*)pTsCol->pData)[nRows / 2] = ((TSKEY*)pTsCol->pData)[nRows / 2 - 1];
+    ASSERT_EQ(tEncodeSubmitColBlk(pBlock, pBuf), len);
+    memset(&decoded, 0, sizeof(decoded));
+    ASSERT_EQ(tDecodeSubmitColBlk(pHead, len, pSchema, &decoded), TSDB_CODE_INVALID_MSG);
+    blockDataFreeRes(&decoded);
+
+    // nor is a block whose version is not known
+    ((TSKEY*)pTsCol->pData)[nRows / 2] = 1660000000000 + nRows / 2;
+    ASSERT_EQ(tEncodeSubmitColBlk(pBlock, pBuf), len);
+    TD_ROW_SET_SVER(SUBMIT_COL_HEAD_ROW(pHead), SUBMIT_COL_BLK_VER_1 + 1);
+    memset(&decoded, 0, sizeof(decoded));
+    ASSERT_EQ(tDecodeSubmitColBlk(pHead, len, pSchema, &decoded), TSDB_CODE_INVALID_MSG);
+    blockDataFreeRes(&decoded);
+
+    taosMemoryFree(pBuf);
+    blockDataDestroy(pBlock);
+  }
+
+  taosMemoryFree(pByCol);
+  taosMemoryFree(pByRow);
+  taosMemoryFree(pSchema);
+}
+
 #pragma GCC diagnostic pop
\ No newline at end of file
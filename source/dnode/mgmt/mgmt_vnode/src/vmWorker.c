@@ -78,6 +78,16 @@ static void vmProcessQueryQueue(SQueueInfo *pInfo, SRpcMsg *pMsg) {
   taosFreeQitem(pMsg);
 }
 
+// A new query is usually short and latency sensitive, continuations belong to queries which have already
+// used up a time slice. Tasks of one request share the root trace id and are kept on one worker if possible.
+static int32_t vmGetQueryLane(SRpcMsg *pMsg, int64_t *affinity) {
+  *affinity = pMsg->info.traceId.rootId;
+  if (pMsg->msgType == TDMT_SCH_QUERY || pMsg->msgType == TDMT_SCH_MERGE_QUERY) {
+    return QWORKER_LANE_HIGH;
+  }
+  return QWORKER_LANE_LOW;
+}
+
 static void vmProcessStreamQueue(SQueueInfo *pInfo, SRpcMsg *pMsg) {
   SVnodeObj      *pVnode = pInfo->ahandle;
   const STraceId *trace = &pMsg->info.traceId;
@@ -362,6 +372,7 @@ int32_t vmStartWorker(SVnodeMgmt *pMgmt) {
   pQPool->name = "vnode-query";
   pQPool->min = tsNumOfVnodeQueryThreads;
   pQPool->max = tsNumOfVnodeQueryThreads;
+  pQPool->laneFp = (FItemLane)vmGetQueryLane;
   if (tQWorkerInit(pQPool) != 0) return -1;
 
   SAutoQWorkerPool *pStreamPool = &pMgmt->streamPool;
@@ -45,6 +45,7 @@ typedef struct SRSmaFS       SRSmaFS;
 typedef struct SQTaskFile    SQTaskFile;
 typedef struct SQTaskFReader SQTaskFReader;
 typedef struct SQTaskFWriter SQTaskFWriter;
+typedef struct SRSmaAgg      SRSmaAgg;
 
 struct SSmaEnv {
   SRWLatch  lock;
@@ -165,6 +166,8 @@ struct SRSmaInfo {
   void         *iTaskInfo[TSDB_RETENTION_L2];  // immutable qTaskInfo_t
   STaosQueue   *iQueue;                        // immutable buffer queue of SubmitReq
   STaosQall    *iQall;                         // immutable buffer qall of SubmitReq
+  SRSmaAgg     *pAgg[TSDB_RETENTION_L2];       // rollup computed in place of taskInfo
+  STqReader    *pReader;                       // decode SubmitReq for pAgg
 };
 
 #define RSMA_INFO_HEAD_LEN     offsetof(SRSmaInfo, items)
@@ -173,6 +176,7 @@ struct SRSmaInfo {
 #define RSMA_INFO_QTASK(r, i)  ((r)->taskInfo[i])
 #define RSMA_INFO_IQTASK(r, i) ((r)->iTaskInfo[i])
 #define RSMA_INFO_ITEM(r, i)   (&(r)->items[i])
+#define RSMA_INFO_AGG(r, i)    ((r)->pAgg[i])
 
 enum {
   TASK_TRIGGER_STAT_INIT = 0,
@@ -230,6 +234,13 @@ void    tdRSmaQTaskInfoGetFullName(int32_t vgId, int64_t version, const char *pa
 void    tdRSmaQTaskInfoGetFullPath(int32_t vgId, int8_t level, const char *path, char *outputName);
 void    tdRSmaQTaskInfoGetFullPathEx(int32_t vgId, tb_uid_t suid, int8_t level, const char *path, char *outputName);
 
+// rollup of the common functions without qTaskInfo
+int32_t tdRSmaAggCreate(SRSmaAgg **ppAgg, const STSchema *pTSchema, const SRollupInfo *pRollup, SStreamState *pState);
+void   *tdRSmaAggDestroy(SRSmaAgg *pAgg);
+int32_t tdRSmaAggProcess(SRSmaAgg *pAgg, const SSDataBlock *pBlock);
+int32_t tdRSmaAggGetResult(SRSmaAgg *pAgg, bool fetchAll, SArray *pResList);
+int32_t tdRSmaAggPersist(SRSmaAgg *pAgg);
+
 static FORCE_INLINE void tdRefRSmaInfo(SSma *pSma, SRSmaInfo *pRSmaInfo) {
   int32_t ref = T_REF_INC(pRSmaInfo);
   smaDebug("vgId:%d, ref rsma info:%p, val:%d", SMA_VID(pSma), pRSmaInfo, ref);
@@ -207,6 +207,8 @@ int32_t tsdbDecmprColData(uint8_t *pIn, SBlockCol *pBlockCol, int8_t cmprAlg, in
 int32_t  tsdbMemTableCreate(STsdb *pTsdb, SMemTable **ppMemTable);
 void     tsdbMemTableDestroy(SMemTable *pMemTable);
 STbData *tsdbGetTbDataFromMemTable(SMemTable *pMemTable, tb_uid_t suid, tb_uid_t uid);
+int32_t  tsdbMemTablePut(SMemTable *pMemTable, int64_t version, SSubmitMsgIter *pMsgIter, SSubmitBlk *pBlock,
+                         SSubmitBlkRsp *pRsp);
 void     tsdbRefMemTable(SMemTable *pMemTable);
 void     tsdbUnrefMemTable(SMemTable *pMemTable);
 SArray  *tsdbMemTableGetTbDataArray(SMemTable *pMemTable);
@@ -272,6 +274,7 @@ int32_t tsdbReadDataBlk(SDataFReader *pReader, SBlockIdx *pBlockIdx, SMapData *m
 int32_t tsdbReadSttBlk(SDataFReader *pReader, int32_t iStt, SArray *aSttBlk);
 int32_t tsdbReadBlockSma(SDataFReader *pReader, SDataBlk *pBlock, SArray *aColumnDataAgg);
 int32_t tsdbReadDataBlock(SDataFReader *pReader, SDataBlk *pBlock, SBlockData *pBlockData);
+int32_t tsdbReadAheadDataBlock(SDataFReader *pReader, SDataBlk *pDataBlk);
 int32_t tsdbReadSttBlock(SDataFReader *pReader, int32_t iStt, SSttBlk *pSttBlk, SBlockData *pBlockData);
 int32_t tsdbReadSttBlockEx(SDataFReader *pReader, int32_t iStt, SSttBlk *pSttBlk, SBlockData *pBlockData);
 // SDelFWriter
@@ -286,6 +289,11 @@ int32_t tsdbDelFReaderClose(SDelFReader **ppReader);
 int32_t tsdbReadDelData(SDelFReader *pReader, SDelIdx *pDelIdx, SArray *aDelData);
 int32_t tsdbReadDelIdx(SDelFReader *pReader, SArray *aDelIdx);
 // tsdbRead.c ==============================================================================================
+// called for each block a reader reads ahead, with the index of the block being loaded and of the one read ahead in the
+// block list of the file
+typedef void (*FTsdbReadAhead)(STsdbReader *pReader, int32_t order, int32_t index, int32_t raIndex, int32_t numOfBlocks);
+extern FTsdbReadAhead tsdbReadAheadFp;
+
 int32_t tsdbTakeReadSnap(STsdb *pTsdb, STsdbReadSnap **ppSnap, const char *id);
 void    tsdbUntakeReadSnap(STsdb *pTsdb, STsdbReadSnap *pSnap, const char *id);
 // tsdbMerge.c ==============================================================================================
@@ -320,6 +328,21 @@ struct STsdb {
   STsdbFS        fs;
   SLRUCache     *lruCache;
   TdThreadMutex  lruMutex;
+  struct {
+    SLRUCache       *pCache;
+    volatile int32_t gen;  // bumped when a snapshot replaces the files, as file names may be reused
+    volatile int64_t nHit;
+    volatile int64_t nMiss;
+  } blockCache;
+  struct {
+    TdThread         thread;
+    int8_t           threadValid;
+    int64_t          commitID;
+    volatile int8_t  running;
+    volatile int8_t  stop;
+    volatile int32_t nFSet;
+    volatile int32_t nFSetDone;
+  } compact;
 };
 
 struct TSDBKEY {
@@ -355,12 +378,14 @@ struct STbData {
   TSKEY        maxKey;
   SDelData    *pHead;
   SDelData    *pTail;
+  SRWLatch     lock;  // serializes the writers of the table, the readers do not take it
   SMemSkipList sl;
-  STbData     *next;
 };
 
+typedef struct STbDataHash STbDataHash;
+
 struct SMemTable {
-  SRWLatch         latch;
+  SRWLatch         latch;  // serializes the creation of table data, the lookups do not take it
   STsdb           *pTsdb;
   SVBufPool       *pPool;
   volatile int32_t nRef;
@@ -369,9 +394,9 @@ struct SMemTable {
   int64_t          nRow;
   int64_t          nDel;
   struct {
-    int32_t   nTbData;
-    int32_t   nBucket;
-    STbData **aBucket;
+    int32_t      nTbData;
+    STbDataHash *pHash;     // replaced as a whole on rehash
+    STbDataHash *pRetired;  // the replaced ones, the lookups may still be in them until the memtable is destroyed
   };
 };
 
@@ -624,6 +649,8 @@ struct SDataFReader {
   STsdbFD   *pSmaFD;
   STsdbFD   *aSttFD[TSDB_MAX_STT_TRIGGER];
   uint8_t   *aBuf[3];
+  SLRUCache *pBlockCache;  // decompressed blocks shared by the queries of the vnode, NULL to bypass
+  int32_t    cacheGen;
 };
 
 typedef struct {
@@ -739,6 +766,8 @@ typedef struct {
 
 int32_t tsdbOpenCache(STsdb *pTsdb);
 void    tsdbCloseCache(STsdb *pTsdb);
+int32_t tsdbOpenBlockCache(STsdb *pTsdb);
+void    tsdbCloseBlockCache(STsdb *pTsdb);
 int32_t tsdbCacheInsertLast(SLRUCache *pCache, tb_uid_t uid, STSRow *row, STsdb *pTsdb);
 int32_t tsdbCacheInsertLastrow(SLRUCache *pCache, STsdb *pTsdb, tb_uid_t uid, STSRow *row, bool dup);
 int32_t tsdbCacheGetLastH(SLRUCache *pCache, tb_uid_t uid, SCacheRowsReader *pr, LRUHandle **h);
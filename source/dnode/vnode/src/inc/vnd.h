@@ -65,8 +65,15 @@ struct SVBufPool {
   SVnode*           pVnode;
   TdThreadSpinlock* lock;
   volatile int32_t  nRef;
+  int64_t           epoch;  // renewed on reset, so writer threads drop the chunks they took
+  int32_t           arena;  // slot of the writer thread arenas tried first
   int64_t           size;
   uint8_t*          ptr;
+  uint8_t*          nodePtr;  // free space of the last malloced node
+  uint8_t*          nodeEnd;
+  int64_t           nChunk;
+  int64_t           nWaste;
+  int64_t           nFallback;
   SVBufPoolNode*    pTail;
   SVBufPoolNode     node;
 };
@@ -94,6 +101,7 @@ int32_t vnodeLoadInfo(const char* dir, SVnodeInfo* pInfo);
 int32_t vnodeSyncCommit(SVnode* pVnode);
 int32_t vnodeAsyncCommit(SVnode* pVnode);
 bool    vnodeShouldRollback(SVnode* pVnode);
+int32_t vnodeAsyncCompact(SVnode* pVnode);
 
 // vnodeSync.c
 int32_t vnodeSyncOpen(SVnode* pVnode, char* path);
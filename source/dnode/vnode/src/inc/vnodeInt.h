@@ -162,6 +162,9 @@ int32_t tsdbCommit(STsdb* pTsdb, SCommitInfo* pInfo);
 int32_t tsdbFinishCommit(STsdb* pTsdb);
 int32_t tsdbRollbackCommit(STsdb* pTsdb);
 int32_t tsdbDoRetention(STsdb* pTsdb, int64_t now);
+int32_t tsdbAsyncCompact(STsdb* pTsdb, int64_t commitID);
+void    tsdbStopCompact(STsdb* pTsdb);
+int32_t tsdbGetCompactProgress(STsdb* pTsdb);
 int     tsdbScanAndConvertSubmitMsg(STsdb* pTsdb, SSubmitReq* pMsg);
 int     tsdbInsertData(STsdb* pTsdb, int64_t version, SSubmitReq* pMsg, SSubmitRsp* pRsp);
 int32_t tsdbInsertTableData(STsdb* pTsdb, int64_t version, SSubmitMsgIter* pMsgIter, SSubmitBlk* pBlock,
@@ -348,6 +351,11 @@ struct SVnode {
   TdThreadCond  poolNotEmpty;
   SVBufPool*    pPool;
   SVBufPool*    inUse;
+  struct {  // since the last monitor report, see vnodeResetLoad
+    volatile int64_t nChunk;     // chunks taken by writer threads of a shared pool
+    volatile int64_t nWaste;     // bytes left unused at the end of chunks and nodes
+    volatile int64_t nFallback;  // nodes malloced after the anchor is full
+  } bufPoolStatis;
   SMeta*        pMeta;
   SSma*         pSma;
   STsdb*        pTsdb;
@@ -16,6 +16,7 @@
 
 #define META_CACHE_BASE_BUCKET  1024
 #define META_CACHE_STATS_BUCKET 16
+#define META_TAG_COL_MIN_ROWS   1024
 
 // (uid , suid) : child table
 // (uid,     0) : normal table
@@ -37,6 +38,17 @@ typedef struct STagFilterResEntry {
   uint32_t qTimes;  // queried times for current super table
 } STagFilterResEntry;
 
+// the tags of all child tables of a super table, one column per tag and one row per child table.
+// rows of the dropped child tables are reused by the tables created later.
+typedef struct STagColStore {
+  SSDataBlock* pBlock;
+  SArray*      aUid;      // row -> uid, 0 for a free row
+  SArray*      aFreeRow;  // rows that can be reused
+  SHashObj*    pUidRow;   // uid -> row
+  int64_t      nGarbage;  // var data bytes no longer referenced by any row
+  int64_t      size;      // memory held, counted against tagColCacheSize
+} STagColStore;
+
 struct SMetaCache {
   // child, normal, super, table entry cache
   struct SEntryCache {
@@ -58,6 +70,15 @@ struct SMetaCache {
     SHashObj*  pTableEntry;
     SLRUCache* pUidResCache;
   } sTagFilterResCache;
+
+  // columnar tag cache, built on the first tag query of a super table and then kept up to date under the meta
+  // write lock. the lock only serializes the readers, that may build the store of a super table at the same time.
+  // the stores of a vnode hold at most tagColCacheSize MB, a store that does not fit any more is dropped.
+  struct STagColCache {
+    TdThreadMutex lock;
+    SHashObj*     pStores;  // suid -> STagColStore*
+    int64_t       size;     // memory held by all stores
+  } sTagColCache;
 };
 
 static void entryCacheClose(SMeta* pMeta) {
@@ -96,6 +117,20 @@ static void freeCacheEntryFp(void* param) {
   taosMemoryFreeClear(*p);
 }
 
+static void tagColStoreDestroy(STagColStore* pStore) {
+  if (pStore == NULL) {
+    return;
+  }
+
+  blockDataDestroy(pStore->pBlock);
+  taosArrayDestroy(pStore->aUid);
+  taosArrayDestroy(pStore->aFreeRow);
+  taosHashCleanup(pStore->pUidRow);
+  taosMemoryFree(pStore);
+}
+
+static void freeTagColStoreFp(void* param) { tagColStoreDestroy(*(STagColStore**)param); }
+
 int32_t metaCacheOpen(SMeta* pMeta) {
   int32_t     code = 0;
   SMetaCache* pCache = NULL;
@@ -142,6 +177,17 @@ int32_t metaCacheOpen(SMeta* pMeta) {
   taosHashSetFreeFp(pCache->sTagFilterResCache.pTableEntry, freeCacheEntryFp);
   taosThreadMutexInit(&pCache->sTagFilterResCache.lock, NULL);
 
+  pCache->sTagColCache.pStores =
+      taosHashInit(16, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BIGINT), false, HASH_NO_LOCK);
+  if (pCache->sTagColCache.pStores == NULL) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    goto _err2;
+  }
+
+  taosHashSetFreeFp(pCache->sTagColCache.pStores, freeTagColStoreFp);
+  taosThreadMutexInit(&pCache->sTagColCache.lock, NULL);
+  pCache->sTagColCache.size = 0;
+
   pMeta->pCache = pCache;
   return code;
 
@@ -163,6 +209,9 @@ void metaCacheClose(SMeta* pMeta) {
     taosLRUCacheCleanup(pMeta->pCache->sTagFilterResCache.pUidResCache);
     taosThreadMutexDestroy(&pMeta->pCache->sTagFilterResCache.lock);
 
+    taosHashCleanup(pMeta->pCache->sTagColCache.pStores);
+    taosThreadMutexDestroy(&pMeta->pCache->sTagColCache.lock);
+
     taosMemoryFree(pMeta->pCache);
     pMeta->pCache = NULL;
   }
@@ -594,3 +643,437 @@ int32_t metaUidCacheClear(SMeta* pMeta, uint64_t suid) {
   taosThreadMutexUnlock(pLock);
   return TSDB_CODE_SUCCESS;
 }
+
+static int32_t tagColSetVarData(STagColStore* pStore, SColumnInfoData* pCol, int32_t row, const STagVal* pTagVal) {
+  if (pCol->varmeta.offset[row] != -1) {
+    pStore->nGarbage += varDataTLen(colDataGetVarData(pCol, row));
+  }
+
+  int32_t dataLen = pTagVal->nData + VARSTR_HEADER_SIZE;
+  if (pCol->varmeta.allocLen < pCol->varmeta.length + dataLen) {
+    uint32_t newSize = TMAX(pCol->varmeta.allocLen * 2, pCol->varmeta.length + dataLen);
+    char*    buf = taosMemoryRealloc(pCol->pData, newSize);
+    if (buf == NULL) {
+      return TSDB_CODE_OUT_OF_MEMORY;
+    }
+
+    pCol->pData = buf;
+    pCol->varmeta.allocLen = newSize;
+  }
+
+  char* p = pCol->pData + pCol->varmeta.length;
+  varDataSetLen(p, pTagVal->nData);
+  memcpy(varDataVal(p), pTagVal->pData, pTagVal->nData);
+  pCol->varmeta.offset[row] = pCol->varmeta.length;
+  pCol->varmeta.length += dataLen;
+  return TSDB_CODE_SUCCESS;
+}
+
+static void tagColSetNull(STagColStore* pStore, SColumnInfoData* pCol, int32_t row) {
+  if (IS_VAR_DATA_TYPE(pCol->info.type)) {
+    if (pCol->varmeta.offset[row] != -1) {
+      pStore->nGarbage += varDataTLen(colDataGetVarData(pCol, row));
+    }
+    colDataSetNull_var(pCol, row);
+  } else {
+    colDataSetNull_f_s(pCol, row);
+  }
+  pCol->hasNull = true;
+}
+
+static int32_t tagColStoreSetRow(STagColStore* pStore, int32_t row, const STag* pTag) {
+  int32_t numOfCols = taosArrayGetSize(pStore->pBlock->pDataBlock);
+  for (int32_t i = 0; i < numOfCols; ++i) {
+    SColumnInfoData* pCol = taosArrayGet(pStore->pBlock->pDataBlock, i);
+
+    STagVal tagVal = {.cid = pCol->info.colId};
+    if (!tTagGet(pTag, &tagVal)) {
+      tagColSetNull(pStore, pCol, row);
+    } else if (IS_VAR_DATA_TYPE(pCol->info.type)) {
+      int32_t code = tagColSetVarData(pStore, pCol, row, &tagVal);
+      if (code != TSDB_CODE_SUCCESS) {
+        return code;
+      }
+    } else {
+      memcpy(colDataGetNumData(pCol, row), &tagVal.i64, pCol->info.bytes);
+      colDataClearNull_f(pCol->nullbitmap, row);
+    }
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
+static int32_t tagColStoreAddRow(STagColStore* pStore, tb_uid_t uid, const STag* pTag) {
+  int32_t* pRow = taosHashGet(pStore->pUidRow, &uid, sizeof(tb_uid_t));
+  if (pRow != NULL) {
+    return tagColStoreSetRow(pStore, *pRow, pTag);
+  }
+
+  int32_t row = 0;
+  if (taosArrayGetSize(pStore->aFreeRow) > 0) {
+    row = *(int32_t*)taosArrayPop(pStore->aFreeRow);
+    taosArraySet(pStore->aUid, row, &uid);
+  } else {
+    SSDataBlock* pBlock = pStore->pBlock;
+    if (pBlock->info.rows >= pBlock->info.capacity) {
+      int32_t code = blockDataEnsureCapacity(pBlock, TMAX(META_TAG_COL_MIN_ROWS, pBlock->info.capacity * 2));
+      if (code != TSDB_CODE_SUCCESS) {
+        return code;
+      }
+    }
+
+    row = pBlock->info.rows++;
+    for (int32_t i = 0; i < taosArrayGetSize(pBlock->pDataBlock); ++i) {
+      SColumnInfoData* pCol = taosArrayGet(pBlock->pDataBlock, i);
+      if (IS_VAR_DATA_TYPE(pCol->info.type)) {
+        colDataSetNull_var(pCol, row);
+      }
+    }
+    taosArrayPush(pStore->aUid, &uid);
+  }
+
+  if (taosHashPut(pStore->pUidRow, &uid, sizeof(tb_uid_t), &row, sizeof(int32_t)) != 0) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  return tagColStoreSetRow(pStore, row, pTag);
+}
+
+static void tagColStoreRemoveRow(STagColStore* pStore, tb_uid_t uid) {
+  int32_t* pRow = taosHashGet(pStore->pUidRow, &uid, sizeof(tb_uid_t));
+  if (pRow == NULL) {
+    return;
+  }
+
+  int32_t row = *pRow;
+  for (int32_t i = 0; i < taosArrayGetSize(pStore->pBlock->pDataBlock); ++i) {
+    tagColSetNull(pStore, taosArrayGet(pStore->pBlock->pDataBlock, i), row);
+  }
+
+  tb_uid_t freeUid = 0;
+  taosArraySet(pStore->aUid, row, &freeUid);
+  taosArrayPush(pStore->aFreeRow, &row);
+  taosHashRemove(pStore->pUidRow, &uid, sizeof(tb_uid_t));
+}
+
+// the var data of the updated tags is appended, the store is rebuilt once more than half of it is garbage
+static bool tagColStoreNeedRebuild(STagColStore* pStore) {
+  int64_t length = 0;
+  for (int32_t i = 0; i < taosArrayGetSize(pStore->pBlock->pDataBlock); ++i) {
+    SColumnInfoData* pCol = taosArrayGet(pStore->pBlock->pDataBlock, i);
+    if (IS_VAR_DATA_TYPE(pCol->info.type)) {
+      length += pCol->varmeta.length;
+    }
+  }
+
+  return pStore->nGarbage > length / 2;
+}
+
+static int64_t tagColStoreGetSize(STagColStore* pStore) {
+  SSDataBlock* pBlock = pStore->pBlock;
+  int64_t      size = sizeof(STagColStore) + taosArrayGetSize(pStore->aUid) * (sizeof(tb_uid_t) + sizeof(int32_t) * 2);
+  for (int32_t i = 0; i < taosArrayGetSize(pBlock->pDataBlock); ++i) {
+    SColumnInfoData* pCol = taosArrayGet(pBlock->pDataBlock, i);
+    if (IS_VAR_DATA_TYPE(pCol->info.type)) {
+      size += pCol->varmeta.allocLen + (int64_t)pBlock->info.capacity * sizeof(int32_t);
+    } else {
+      size += (int64_t)pBlock->info.capacity * pCol->info.bytes + BitmapLen(pBlock->info.capacity);
+    }
+  }
+  return size;
+}
+
+static bool tagColCacheFits(SMeta* pMeta, int64_t size) {
+  return pMeta->pCache->sTagColCache.size + size <= (int64_t)tsTagColCacheSize * 1024 * 1024;
+}
+
+static void tagColCacheRemoveStore(SMeta* pMeta, tb_uid_t suid) {
+  struct STagColCache* pCache = &pMeta->pCache->sTagColCache;
+  STagColStore**       ppStore = taosHashGet(pCache->pStores, &suid, sizeof(tb_uid_t));
+  if (ppStore != NULL) {
+    pCache->size -= (*ppStore)->size;
+    taosHashRemove(pCache->pStores, &suid, sizeof(tb_uid_t));
+  }
+}
+
+// the meta read lock is held
+static int32_t tagColStoreBuild(SMeta* pMeta, tb_uid_t suid, STagColStore** ppStore) {
+  int32_t       code = TSDB_CODE_SUCCESS;
+  void*         pData = NULL;
+  int           nData = 0;
+  SDecoder      dc = {0};
+  SMetaEntry    me = {0};
+  TBC*          pCur = NULL;
+  STagColStore* pStore = NULL;
+
+  if (tdbTbGet(pMeta->pUidIdx, &suid, sizeof(tb_uid_t), &pData, &nData) < 0) {
+    code = TSDB_CODE_PAR_TABLE_NOT_EXIST;
+    goto _exit;
+  }
+
+  STbDbKey tbDbKey = {.uid = suid, .version = ((SUidIdxVal*)pData)->version};
+  if (tdbTbGet(pMeta->pTbDb, &tbDbKey, sizeof(tbDbKey), &pData, &nData) < 0) {
+    code = TSDB_CODE_PAR_TABLE_NOT_EXIST;
+    goto _exit;
+  }
+
+  tDecoderInit(&dc, pData, nData);
+  if (metaDecodeEntry(&dc, &me) < 0 || me.type != TSDB_SUPER_TABLE) {
+    code = TSDB_CODE_PAR_TABLE_NOT_EXIST;
+    goto _exit;
+  }
+
+  // the json tag is kept as a whole and filtered by the json operators, nothing to gain from a column of it
+  const SSchemaWrapper* pTagSchema = &me.stbEntry.schemaTag;
+  if (pTagSchema->nCols == 0 || pTagSchema->pSchema[0].type == TSDB_DATA_TYPE_JSON) {
+    code = TSDB_CODE_OPS_NOT_SUPPORT;
+    goto _exit;
+  }
+
+  pStore = taosMemoryCalloc(1, sizeof(STagColStore));
+  if (pStore == NULL) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    goto _exit;
+  }
+
+  pStore->pBlock = createDataBlock();
+  pStore->aUid = taosArrayInit(META_TAG_COL_MIN_ROWS, sizeof(tb_uid_t));
+  pStore->aFreeRow = taosArrayInit(4, sizeof(int32_t));
+  pStore->pUidRow = taosHashInit(META_TAG_COL_MIN_ROWS, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BIGINT), false,
+                                 HASH_NO_LOCK);
+  if (pStore->pBlock == NULL || pStore->aUid == NULL || pStore->aFreeRow == NULL || pStore->pUidRow == NULL) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    goto _exit;
+  }
+
+  for (int32_t i = 0; i < pTagSchema->nCols; ++i) {
+    const SSchema*  pSchema = &pTagSchema->pSchema[i];
+    SColumnInfoData colInfo = createColumnInfoData(pSchema->type, pSchema->bytes, pSchema->colId);
+    blockDataAppendColInfo(pStore->pBlock, &colInfo);
+  }
+
+  code = tdbTbcOpen(pMeta->pCtbIdx, &pCur, NULL);
+  if (code < 0) {
+    code = TSDB_CODE_FAILED;
+    goto _exit;
+  }
+
+  int c = 0;
+  tdbTbcMoveTo(pCur, &(SCtbIdxKey){.suid = suid, .uid = INT64_MIN}, sizeof(SCtbIdxKey), &c);
+  if (c > 0) {
+    tdbTbcMoveToNext(pCur);
+  }
+
+  const void* pKey = NULL;
+  const void* pVal = NULL;
+  int         kLen = 0;
+  int         vLen = 0;
+  while (tdbTbcGet(pCur, &pKey, &kLen, &pVal, &vLen) == 0) {
+    const SCtbIdxKey* pCtbIdxKey = pKey;
+    if (pCtbIdxKey->suid != suid) {
+      break;
+    }
+
+    code = tagColStoreAddRow(pStore, pCtbIdxKey->uid, pVal);
+    if (code != TSDB_CODE_SUCCESS) {
+      goto _exit;
+    }
+
+    tdbTbcMoveToNext(pCur);
+  }
+
+  pStore->size = tagColStoreGetSize(pStore);
+  metaDebug("vgId:%d, suid:%" PRId64 " tag column store built, tables:%d, tags:%d, size:%" PRId64,
+            TD_VID(pMeta->pVnode), suid, pStore->pBlock->info.rows, pTagSchema->nCols, pStore->size);
+
+  *ppStore = pStore;
+  pStore = NULL;
+
+_exit:
+  tagColStoreDestroy(pStore);
+  tdbTbcClose(pCur);
+  tDecoderClear(&dc);
+  tdbFree(pData);
+  return code;
+}
+
+// the meta write lock is held by the following three
+void metaTagColCacheUpsert(SMeta* pMeta, tb_uid_t suid, tb_uid_t uid, const STag* pTag) {
+  SHashObj*      pStores = pMeta->pCache->sTagColCache.pStores;
+  STagColStore** ppStore = taosHashGet(pStores, &suid, sizeof(tb_uid_t));
+  if (ppStore == NULL) {
+    return;
+  }
+
+  // drop the whole store if it can not be kept up to date or outgrows the cache, the next query builds it again
+  STagColStore* pStore = *ppStore;
+  if (tagColStoreAddRow(pStore, uid, pTag) != TSDB_CODE_SUCCESS || tagColStoreNeedRebuild(pStore)) {
+    tagColCacheRemoveStore(pMeta, suid);
+    return;
+  }
+
+  int64_t size = tagColStoreGetSize(pStore);
+  pMeta->pCache->sTagColCache.size += size - pStore->size;
+  pStore->size = size;
+  if (!tagColCacheFits(pMeta, 0)) {
+    tagColCacheRemoveStore(pMeta, suid);
+  }
+}
+
+void metaTagColCacheRemove(SMeta* pMeta, tb_uid_t suid, tb_uid_t uid) {
+  STagColStore** ppStore = taosHashGet(pMeta->pCache->sTagColCache.pStores, &suid, sizeof(tb_uid_t));
+  if (ppStore != NULL) {
+    tagColStoreRemoveRow(*ppStore, uid);
+  }
+}
+
+void metaTagColCacheDrop(SMeta* pMeta, tb_uid_t suid) { tagColCacheRemoveStore(pMeta, suid); }
+
+typedef struct {
+  tb_uid_t uid;
+  int32_t  row;
+} STagColRowRef;
+
+static int32_t tagColRowRefCompare(const void* p1, const void* p2) {
+  tb_uid_t uid1 = ((const STagColRowRef*)p1)->uid;
+  tb_uid_t uid2 = ((const STagColRowRef*)p2)->uid;
+  return (uid1 < uid2) ? -1 : ((uid1 > uid2) ? 1 : 0);
+}
+
+static void tagColCopy(STagColStore* pStore, SColumnInfoData* pDst, const SArray* pRefs) {
+  SColumnInfoData* pSrc = NULL;
+  for (int32_t i = 0; i < taosArrayGetSize(pStore->pBlock->pDataBlock); ++i) {
+    SColumnInfoData* p = taosArrayGet(pStore->pBlock->pDataBlock, i);
+    if (p->info.colId == pDst->info.colId && p->info.type == pDst->info.type) {
+      pSrc = p;
+      break;
+    }
+  }
+
+  int32_t rows = taosArrayGetSize(pRefs);
+  if (pSrc == NULL) {
+    colDataAppendNNULL(pDst, 0, rows);
+    return;
+  }
+
+  const STagColRowRef* pRef = pRefs->pData;
+  if (IS_VAR_DATA_TYPE(pSrc->info.type)) {
+    for (int32_t i = 0; i < rows; ++i) {
+      int32_t row = pRef[i].row;
+      colDataAppend(pDst, i, colDataGetVarData(pSrc, row), colDataIsNull_var(pSrc, row));
+    }
+  } else {
+    int32_t bytes = pSrc->info.bytes;
+    for (int32_t i = 0; i < rows; ++i) {
+      int32_t row = pRef[i].row;
+      if (colDataIsNull_f(pSrc->nullbitmap, row)) {
+        colDataSetNull_f_s(pDst, i);
+        pDst->hasNull = true;
+      } else {
+        memcpy(pDst->pData + i * bytes, pSrc->pData + row * bytes, bytes);
+      }
+    }
+  }
+}
+
+int32_t metaGetTableTagCols(SMeta* pMeta, uint64_t suid, SArray* uidList, SSDataBlock* pBlock) {
+  int32_t        code = TSDB_CODE_SUCCESS;
+  TdThreadMutex* pLock = &pMeta->pCache->sTagColCache.lock;
+  SHashObj*      pStores = pMeta->pCache->sTagColCache.pStores;
+  SArray*        pRefs = NULL;
+  STagColStore*  pTmpStore = NULL;  // a store that does not fit in the cache, only used by this query
+
+  if (tsTagColCacheSize <= 0) {
+    return TSDB_CODE_OPS_NOT_SUPPORT;
+  }
+
+  metaRLock(pMeta);
+  taosThreadMutexLock(pLock);
+
+  STagColStore*  pStore = NULL;
+  STagColStore** ppStore = taosHashGet(pStores, &suid, sizeof(tb_uid_t));
+  if (ppStore != NULL) {
+    pStore = *ppStore;
+  } else {
+    code = tagColStoreBuild(pMeta, suid, &pStore);
+    if (code != TSDB_CODE_SUCCESS) {
+      goto _exit;
+    }
+
+    if (!tagColCacheFits(pMeta, pStore->size)) {
+      pTmpStore = pStore;
+    } else if (taosHashPut(pStores, &suid, sizeof(tb_uid_t), &pStore, POINTER_BYTES) != 0) {
+      tagColStoreDestroy(pStore);
+      code = TSDB_CODE_OUT_OF_MEMORY;
+      goto _exit;
+    } else {
+      pMeta->pCache->sTagColCache.size += pStore->size;
+    }
+  }
+
+  pRefs = taosArrayInit(TMAX(taosArrayGetSize(uidList), pStore->pBlock->info.rows), sizeof(STagColRowRef));
+  if (pRefs == NULL) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    goto _exit;
+  }
+
+  size_t len = taosArrayGetSize(uidList);  // len > 0 means there already have uids
+  if (len > 0) {
+    // the tables that do not exist anymore are removed from the list
+    size_t n = 0;
+    for (size_t i = 0; i < len; ++i) {
+      tb_uid_t uid = *(tb_uid_t*)taosArrayGet(uidList, i);
+      int32_t* pRow = taosHashGet(pStore->pUidRow, &uid, sizeof(tb_uid_t));
+      if (pRow != NULL) {
+        taosArrayPush(pRefs, &(STagColRowRef){.uid = uid, .row = *pRow});
+        taosArraySet(uidList, n++, &uid);
+      }
+    }
+    taosArrayPopTailBatch(uidList, len - n);
+  } else {
+    // in the order of uid, as the child table index returns them
+    bool sorted = true;
+    for (int32_t row = 0; row < pStore->pBlock->info.rows; ++row) {
+      tb_uid_t uid = *(tb_uid_t*)taosArrayGet(pStore->aUid, row);
+      if (uid == 0) {
+        continue;
+      }
+
+      size_t n = taosArrayGetSize(pRefs);
+      if (n > 0 && ((STagColRowRef*)taosArrayGet(pRefs, n - 1))->uid > uid) {
+        sorted = false;
+      }
+      taosArrayPush(pRefs, &(STagColRowRef){.uid = uid, .row = row});
+    }
+
+    if (!sorted) {
+      taosArraySort(pRefs, tagColRowRefCompare);
+    }
+
+    for (int32_t i = 0; i < taosArrayGetSize(pRefs); ++i) {
+      taosArrayPush(uidList, &((STagColRowRef*)taosArrayGet(pRefs, i))->uid);
+    }
+  }
+
+  code = blockDataEnsureCapacity(pBlock, taosArrayGetSize(pRefs));
+  if (code != TSDB_CODE_SUCCESS) {
+    goto _exit;
+  }
+
+  for (int32_t i = 0; i < taosArrayGetSize(pBlock->pDataBlock); ++i) {
+    SColumnInfoData* pCol = taosArrayGet(pBlock->pDataBlock, i);
+    if (pCol->info.colId != -1) {  // tbname is not a tag
+      tagColCopy(pStore, pCol, pRefs);
+    }
+  }
+
+_exit:
+  taosThreadMutexUnlock(pLock);
+  metaULock(pMeta);
+
+  if (pTmpStore != NULL) {
+    tagColStoreDestroy(pTmpStore);
+  }
+  taosArrayDestroy(pRefs);
+  return code;
+}
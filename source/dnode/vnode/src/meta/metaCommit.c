@@ -50,6 +50,12 @@ int  metaFinishCommit(SMeta *pMeta, TXN *txn) { return tdbPostCommit(pMeta->pEnv
 int  metaPrepareAsyncCommit(SMeta *pMeta) {
    // return tdbPrepareAsyncCommit(pMeta->pEnv, pMeta->txn);
   int code = 0;
+  // hand the free pages at the tail of meta back to the file system
+  code = tdbVacuum(pMeta->pEnv, pMeta->txn);
+  if (code < 0) {
+    return code;
+  }
+
   code = tdbCommit(pMeta->pEnv, pMeta->txn);
 
   return code;
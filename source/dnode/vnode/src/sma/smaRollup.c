@@ -132,6 +132,10 @@ void *tdFreeRSmaInfo(SSma *pSma, SRSmaInfo *pInfo, bool isDeepFree) {
                  pInfo->suid, i + 1);
       }
 
+      if (isDeepFree && pInfo->pAgg[i]) {
+        pInfo->pAgg[i] = tdRSmaAggDestroy(pInfo->pAgg[i]);
+      }
+
       if (pInfo->iTaskInfo[i]) {
         tdRSmaQTaskInfoFree(&pInfo->iTaskInfo[i], SMA_VID(pSma), i + 1);
       } else {
@@ -141,6 +145,8 @@ void *tdFreeRSmaInfo(SSma *pSma, SRSmaInfo *pInfo, bool isDeepFree) {
     }
     if (isDeepFree) {
       taosMemoryFreeClear(pInfo->pTSchema);
+      if (pInfo->pReader) tqCloseReader(pInfo->pReader);
+      pInfo->pReader = NULL;
     }
 
     if (isDeepFree) {
@@ -306,16 +312,38 @@ static int32_t tdSetRSmaInfoItemParams(SSma *pSma, SRSmaParam *param, SRSmaStat
       return TSDB_CODE_FAILED;
     }
 
-    SReadHandle handle = {
-        .meta = pVnode->pMeta,
-        .vnode = pVnode,
-        .initTqReader = 1,
-        .pStateBackend = pStreamState,
-    };
-    pRSmaInfo->taskInfo[idx] = qCreateStreamExecTaskInfo(param->qmsg[idx], &handle);
-    if (!pRSmaInfo->taskInfo[idx]) {
-      terrno = TSDB_CODE_RSMA_QTASKINFO_CREATE;
-      return TSDB_CODE_FAILED;
+    // compute the rollup in place if its functions are supported, or by the stream task otherwise
+    SRollupInfo rollup = {0};
+    if (qExtractRollupInfo(param->qmsg[idx], &rollup) == TSDB_CODE_SUCCESS) {
+      int32_t code = tdRSmaAggCreate(&pRSmaInfo->pAgg[idx], pRSmaInfo->pTSchema, &rollup, pStreamState);
+      taosArrayDestroy(rollup.pFuncs);
+      if (code < 0 && code != TSDB_CODE_OPS_NOT_SUPPORT) {
+        streamStateClose(pStreamState);
+        terrno = code;
+        return TSDB_CODE_FAILED;
+      }
+    }
+
+    if (pRSmaInfo->pAgg[idx]) {
+      if (!pRSmaInfo->pReader && !(pRSmaInfo->pReader = tqOpenReader(pVnode))) {
+        streamStateClose(pStreamState);
+        terrno = TSDB_CODE_OUT_OF_MEMORY;
+        return TSDB_CODE_FAILED;
+      }
+      smaInfo("vgId:%d, table %" PRIi64 " level %" PRIi8 " rollup computed without qTaskInfo", TD_VID(pVnode),
+              pRSmaInfo->suid, (int8_t)(idx + 1));
+    } else {
+      SReadHandle handle = {
+          .meta = pVnode->pMeta,
+          .vnode = pVnode,
+          .initTqReader = 1,
+          .pStateBackend = pStreamState,
+      };
+      pRSmaInfo->taskInfo[idx] = qCreateStreamExecTaskInfo(param->qmsg[idx], &handle);
+      if (!pRSmaInfo->taskInfo[idx]) {
+        terrno = TSDB_CODE_RSMA_QTASKINFO_CREATE;
+        return TSDB_CODE_FAILED;
+      }
     }
     SRSmaInfoItem *pItem = &(pRSmaInfo->items[idx]);
     pItem->triggerStat = TASK_TRIGGER_STAT_ACTIVE;  // fetch the data when reboot
@@ -667,6 +695,122 @@ static void tdBlockDataDestroy(SArray *pBlockArr) {
   taosArrayDestroy(pBlockArr);
 }
 
+static int32_t tdRSmaSubmitResult(SSma *pSma, SRSmaInfoItem *pItem, STSchema *pTSchema, int64_t suid,
+                                  SArray *pResList) {
+  for (int32_t i = 0; i < taosArrayGetSize(pResList); ++i) {
+    SSDataBlock *output = taosArrayGetP(pResList, i);
+    smaDebug("result block, uid:%" PRIu64 ", groupid:%" PRIu64 ", rows:%d", output->info.id.uid, output->info.id.groupId,
+             output->info.rows);
+
+    STsdb      *sinkTsdb = (pItem->level == TSDB_RETENTION_L1 ? pSma->pRSmaTsdb[0] : pSma->pRSmaTsdb[1]);
+    SSubmitReq *pReq = NULL;
+
+    // TODO: the schema update should be handled later(TD-17965)
+    if (buildSubmitReqFromDataBlock(&pReq, output, pTSchema, SMA_VID(pSma), suid) < 0) {
+      smaError("vgId:%d, build submit req for rsma table suid:%" PRIu64 ", uid:%" PRIu64 ", level %" PRIi8
+               " failed since %s",
+               SMA_VID(pSma), suid, output->info.id.groupId, pItem->level, terrstr());
+      return TSDB_CODE_FAILED;
+    }
+
+    if (pReq && tdProcessSubmitReq(sinkTsdb, output->info.version, pReq) < 0) {
+      taosMemoryFreeClear(pReq);
+      smaError("vgId:%d, process submit req for rsma suid:%" PRIu64 ", uid:%" PRIu64 " level %" PRIi8
+               " failed since %s",
+               SMA_VID(pSma), suid, output->info.id.groupId, pItem->level, terrstr());
+      return TSDB_CODE_FAILED;
+    }
+
+    smaDebug("vgId:%d, process submit req for rsma suid:%" PRIu64 ",uid:%" PRIu64 ", level %" PRIi8 " ver %" PRIi64
+             " len %" PRIu32,
+             SMA_VID(pSma), suid, output->info.id.groupId, pItem->level, output->info.version,
+             pReq ? htonl(pReq->header.contLen) : 0);
+
+    taosMemoryFreeClear(pReq);
+  }
+  return TSDB_CODE_SUCCESS;
+}
+
+/**
+ * @brief Take the closed windows, or all of them for fetchAll, out of the rollup of one level and write them to the
+ * tsdb of the level.
+ *
+ * @param pSma
+ * @param pInfo
+ * @param idx
+ * @param fetchAll
+ * @return int32_t
+ */
+static int32_t tdRSmaAggSubmitResult(SSma *pSma, SRSmaInfo *pInfo, int8_t idx, bool fetchAll) {
+  SArray *pResList = taosArrayInit(1, POINTER_BYTES);
+  if (pResList == NULL) {
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    return TSDB_CODE_FAILED;
+  }
+
+  int32_t code = tdRSmaAggGetResult(RSMA_INFO_AGG(pInfo, idx), fetchAll, pResList);
+  if (code < 0) {
+    terrno = code;
+    smaError("vgId:%d, get rollup result of table %" PRIi64 " level %" PRIi8 " failed since %s", SMA_VID(pSma),
+             pInfo->suid, (int8_t)(idx + 1), terrstr());
+  } else {
+    code = tdRSmaSubmitResult(pSma, RSMA_INFO_ITEM(pInfo, idx), pInfo->pTSchema, pInfo->suid, pResList);
+  }
+
+  tdBlockDataDestroy(pResList);
+  return code;
+}
+
+/**
+ * @brief Decode each SubmitReq once and aggregate its blocks into the rollup of every level computed in place. The
+ * levels with qTaskInfo are left to tdExecuteRSmaImpl.
+ *
+ * @param pSma
+ * @param pInfo
+ * @param pReqs
+ * @param nReqs
+ * @return int32_t
+ */
+static int32_t tdRSmaAggExec(SSma *pSma, SRSmaInfo *pInfo, SSubmitReq **pReqs, int32_t nReqs) {
+  STqReader  *pReader = pInfo->pReader;
+  SSDataBlock block = {0};
+  int32_t     code = TSDB_CODE_SUCCESS;
+
+  for (int32_t i = 0; i < nReqs; ++i) {
+    if (tqReaderSetDataMsg(pReader, pReqs[i], pReqs[i]->version) < 0) {
+      code = TSDB_CODE_INVALID_MSG;
+      goto _err;
+    }
+    while (tqNextDataBlock(pReader)) {
+      if (pReader->msgIter.suid != pInfo->suid) continue;
+      if (tqRetrieveDataBlock(&block, pReader) < 0) {
+        blockDataFreeRes(&block);
+        if (terrno == TSDB_CODE_TQ_TABLE_SCHEMA_NOT_FOUND) continue;  // the table is dropped
+        code = terrno;
+        goto _err;
+      }
+      for (int8_t idx = 0; idx < TSDB_RETENTION_L2; ++idx) {
+        if (RSMA_INFO_AGG(pInfo, idx) && (code = tdRSmaAggProcess(RSMA_INFO_AGG(pInfo, idx), &block)) < 0) {
+          blockDataFreeRes(&block);
+          goto _err;
+        }
+      }
+      blockDataFreeRes(&block);
+    }
+  }
+
+  for (int8_t idx = 0; idx < TSDB_RETENTION_L2; ++idx) {
+    if (RSMA_INFO_AGG(pInfo, idx) && tdRSmaAggSubmitResult(pSma, pInfo, idx, false) < 0) {
+      return TSDB_CODE_FAILED;
+    }
+  }
+  return TSDB_CODE_SUCCESS;
+_err:
+  terrno = code;
+  smaError("vgId:%d, rollup of table %" PRIi64 " failed since %s", SMA_VID(pSma), pInfo->suid, terrstr());
+  return TSDB_CODE_FAILED;
+}
+
 static int32_t tdRSmaExecAndSubmitResult(SSma *pSma, qTaskInfo_t taskInfo, SRSmaInfoItem *pItem, STSchema *pTSchema,
                                          int64_t suid) {
   SArray *pResList = taosArrayInit(1, POINTER_BYTES);
@@ -706,36 +850,8 @@ static int32_t tdRSmaExecAndSubmitResult(SSma *pSma, qTaskInfo_t taskInfo, SRSma
     snprintf(flag, 10, "level %" PRIi8, pItem->level);
     blockDebugShowDataBlocks(pResList, flag);
 #endif
-    for (int32_t i = 0; i < taosArrayGetSize(pResList); ++i) {
-      SSDataBlock *output = taosArrayGetP(pResList, i);
-      smaDebug("result block, uid:%" PRIu64 ", groupid:%" PRIu64 ", rows:%d", output->info.id.uid, output->info.id.groupId,
-               output->info.rows);
-
-      STsdb      *sinkTsdb = (pItem->level == TSDB_RETENTION_L1 ? pSma->pRSmaTsdb[0] : pSma->pRSmaTsdb[1]);
-      SSubmitReq *pReq = NULL;
-
-      // TODO: the schema update should be handled later(TD-17965)
-      if (buildSubmitReqFromDataBlock(&pReq, output, pTSchema, SMA_VID(pSma), suid) < 0) {
-        smaError("vgId:%d, build submit req for rsma table suid:%" PRIu64 ", uid:%" PRIu64 ", level %" PRIi8
-                 " failed since %s",
-                 SMA_VID(pSma), suid, output->info.id.groupId, pItem->level, terrstr());
-        goto _err;
-      }
-
-      if (pReq && tdProcessSubmitReq(sinkTsdb, output->info.version, pReq) < 0) {
-        taosMemoryFreeClear(pReq);
-        smaError("vgId:%d, process submit req for rsma suid:%" PRIu64 ", uid:%" PRIu64 " level %" PRIi8
-                 " failed since %s",
-                 SMA_VID(pSma), suid, output->info.id.groupId, pItem->level, terrstr());
-        goto _err;
-      }
-
-      smaDebug("vgId:%d, process submit req for rsma suid:%" PRIu64 ",uid:%" PRIu64 ", level %" PRIi8 " ver %" PRIi64
-               " len %" PRIu32,
-               SMA_VID(pSma), suid, output->info.id.groupId, pItem->level, output->info.version,
-               htonl(pReq->header.contLen));
-
-      taosMemoryFreeClear(pReq);
+    if (tdRSmaSubmitResult(pSma, pItem, pTSchema, suid, pResList) < 0) {
+      goto _err;
     }
   }
 
@@ -749,6 +865,63 @@ _err:
   return TSDB_CODE_FAILED;
 }
 
+/**
+ * @brief Copy the blocks of one stable out of a submit req into a queue item. A req with blocks of several stables
+ * would otherwise be copied and scanned in full by the rsma tasks of every one of them.
+ *
+ * @param pReq
+ * @param suid
+ * @param isMixed whether pReq holds blocks of other stables
+ * @return void*
+ */
+static void *tdRSmaBuildSubmitItem(const SSubmitReq *pReq, tb_uid_t suid, bool isMixed) {
+  if (!isMixed) {
+    void *qItem = taosAllocateQitem(pReq->header.contLen, DEF_QITEM, 0);
+    if (qItem) {
+      memcpy(qItem, pReq, pReq->header.contLen);
+    }
+    return qItem;
+  }
+
+  SSubmitMsgIter msgIter = {0};
+  SSubmitBlk    *pBlock = NULL;
+  int32_t        msgLen = sizeof(SSubmitReq);
+  int32_t        numOfBlocks = 0;
+
+  if (tInitSubmitMsgIter(pReq, &msgIter) < 0) return NULL;
+  while (true) {
+    if (tGetSubmitMsgNext(&msgIter, &pBlock) < 0) return NULL;
+    if (!pBlock) break;
+    if (msgIter.suid == suid) {
+      msgLen += sizeof(SSubmitBlk) + msgIter.dataLen + msgIter.schemaLen;
+      ++numOfBlocks;
+    }
+  }
+
+  SSubmitReq *qItem = taosAllocateQitem(msgLen, DEF_QITEM, 0);
+  if (!qItem) {
+    return NULL;
+  }
+  memcpy(qItem, pReq, sizeof(SSubmitReq));
+  qItem->header.contLen = msgLen;
+  qItem->length = htonl(msgLen);
+  qItem->numOfBlocks = htonl(numOfBlocks);
+
+  int32_t offset = sizeof(SSubmitReq);
+  tInitSubmitMsgIter(pReq, &msgIter);
+  while (true) {
+    tGetSubmitMsgNext(&msgIter, &pBlock);
+    if (!pBlock) break;
+    if (msgIter.suid == suid) {
+      int32_t blkLen = sizeof(SSubmitBlk) + msgIter.dataLen + msgIter.schemaLen;
+      memcpy(POINTER_SHIFT(qItem, offset), pBlock, blkLen);
+      offset += blkLen;
+    }
+  }
+
+  return qItem;
+}
+
 /**
  * @brief Copy msg to rsmaQueueBuffer for batch process
  *
@@ -757,19 +930,16 @@ _err:
  * @param inputType
  * @param pInfo
  * @param suid
+ * @param isMixed
  * @return int32_t
  */
 static int32_t tdExecuteRSmaImplAsync(SSma *pSma, const void *pMsg, int32_t inputType, SRSmaInfo *pInfo,
-                                      tb_uid_t suid) {
-  const SSubmitReq *pReq = (const SSubmitReq *)pMsg;
-
-  void *qItem = taosAllocateQitem(pReq->header.contLen, DEF_QITEM, 0);
+                                      tb_uid_t suid, bool isMixed) {
+  void *qItem = tdRSmaBuildSubmitItem((const SSubmitReq *)pMsg, suid, isMixed);
   if (!qItem) {
     return TSDB_CODE_FAILED;
   }
 
-  memcpy(qItem, pMsg, pReq->header.contLen);
-
   taosWriteQitem(pInfo->queue, qItem);
 
   pInfo->lastRecv = taosGetTimestampMs();
@@ -984,7 +1154,7 @@ static SRSmaInfo *tdAcquireRSmaInfoBySuid(SSma *pSma, int64_t suid) {
       taosRUnLockLatch(SMA_ENV_LOCK(pEnv));
       return NULL;
     }
-    if (!pRSmaInfo->taskInfo[0]) {
+    if (!pRSmaInfo->taskInfo[0] && !pRSmaInfo->pAgg[0]) {
       if (tdRSmaInfoClone(pSma, pRSmaInfo) < 0) {
         taosRUnLockLatch(SMA_ENV_LOCK(pEnv));
         return NULL;
@@ -1015,7 +1185,7 @@ static FORCE_INLINE void tdReleaseRSmaInfo(SSma *pSma, SRSmaInfo *pInfo) {
  * @param suid
  * @return int32_t
  */
-static int32_t tdExecuteRSmaAsync(SSma *pSma, const void *pMsg, int32_t inputType, tb_uid_t suid) {
+static int32_t tdExecuteRSmaAsync(SSma *pSma, const void *pMsg, int32_t inputType, tb_uid_t suid, bool isMixed) {
   SRSmaInfo *pRSmaInfo = tdAcquireRSmaInfoBySuid(pSma, suid);
   if (!pRSmaInfo) {
     smaDebug("vgId:%d, execute rsma, no rsma info for suid:%" PRIu64, SMA_VID(pSma), suid);
@@ -1023,7 +1193,7 @@ static int32_t tdExecuteRSmaAsync(SSma *pSma, const void *pMsg, int32_t inputTyp
   }
 
   if (inputType == STREAM_INPUT__DATA_SUBMIT) {
-    if (tdExecuteRSmaImplAsync(pSma, pMsg, inputType, pRSmaInfo, suid) < 0) {
+    if (tdExecuteRSmaImplAsync(pSma, pMsg, inputType, pRSmaInfo, suid, isMixed) < 0) {
       tdReleaseRSmaInfo(pSma, pRSmaInfo);
       return TSDB_CODE_FAILED;
     }
@@ -1064,14 +1234,16 @@ int32_t tdProcessRSmaSubmit(SSma *pSma, void *pMsg, int32_t inputType) {
     }
 
     if (uidStore.suid != 0) {
-      if (tdExecuteRSmaAsync(pSma, pMsg, inputType, uidStore.suid) < 0) {
+      bool isMixed = (uidStore.uidHash != NULL);
+      if (tdExecuteRSmaAsync(pSma, pMsg, inputType, uidStore.suid, isMixed) < 0) {
         goto _err;
       }
 
       void *pIter = NULL;
       while ((pIter = taosHashIterate(uidStore.uidHash, pIter))) {
         tb_uid_t *pTbSuid = (tb_uid_t *)taosHashGetKey(pIter, NULL);
-        if (tdExecuteRSmaAsync(pSma, pMsg, inputType, *pTbSuid) < 0) {
+        if (tdExecuteRSmaAsync(pSma, pMsg, inputType, *pTbSuid, isMixed) < 0) {
+          taosHashCancelIterate(uidStore.uidHash, pIter);
           goto _err;
         }
       }
@@ -1252,6 +1424,9 @@ int32_t tdRSmaPersistExecImpl(SRSmaStat *pRSmaStat, SHashObj *pInfoHash) {
     for (int32_t i = 0; i < TSDB_RETENTION_L2; ++i) {
       SRSmaInfoItem *pItem = RSMA_INFO_ITEM(pRSmaInfo, i);
       if (pItem && pItem->pStreamState) {
+        if (pRSmaInfo->pAgg[i] && (terrno = tdRSmaAggPersist(pRSmaInfo->pAgg[i])) < 0) {
+          goto _err;
+        }
         if (streamStateCommit(pItem->pStreamState) < 0) {
           terrno = TSDB_CODE_RSMA_STREAM_STATE_COMMIT;
           goto _err;
@@ -1397,7 +1572,7 @@ static int32_t tdRSmaFetchAllResult(SSma *pSma, SRSmaInfo *pInfo) {
     if (pItem->fetchLevel) {
       pItem->fetchLevel = 0;
       qTaskInfo_t taskInfo = RSMA_INFO_QTASK(pInfo, i - 1);
-      if (!taskInfo) {
+      if (!taskInfo && !RSMA_INFO_AGG(pInfo, i - 1)) {
         continue;
       }
 
@@ -1419,11 +1594,17 @@ static int32_t tdRSmaFetchAllResult(SSma *pSma, SRSmaInfo *pInfo) {
 
       pItem->nScanned = 0;
 
-      if ((terrno = qSetSMAInput(taskInfo, &dataBlock, 1, STREAM_INPUT__DATA_BLOCK)) < 0) {
-        goto _err;
-      }
-      if (tdRSmaExecAndSubmitResult(pSma, taskInfo, pItem, pInfo->pTSchema, pInfo->suid) < 0) {
-        goto _err;
+      if (RSMA_INFO_AGG(pInfo, i - 1)) {
+        if (tdRSmaAggSubmitResult(pSma, pInfo, i - 1, true) < 0) {
+          goto _err;
+        }
+      } else {
+        if ((terrno = qSetSMAInput(taskInfo, &dataBlock, 1, STREAM_INPUT__DATA_BLOCK)) < 0) {
+          goto _err;
+        }
+        if (tdRSmaExecAndSubmitResult(pSma, taskInfo, pItem, pInfo->pTSchema, pInfo->suid) < 0) {
+          goto _err;
+        }
       }
 
       smaDebug("vgId:%d, suid:%" PRIi64 " level:%" PRIi8 " nScanned:%" PRIi16 " maxDelay:%d, fetch finished",
@@ -1458,6 +1639,11 @@ static int32_t tdRSmaBatchExec(SSma *pSma, SRSmaInfo *pInfo, STaosQall *qall, SA
 
   int32_t size = taosArrayGetSize(pSubmitArr);
   if (size > 0) {
+    if ((RSMA_INFO_AGG(pInfo, 0) || RSMA_INFO_AGG(pInfo, 1)) &&
+        tdRSmaAggExec(pSma, pInfo, (SSubmitReq **)pSubmitArr->pData, size) < 0) {
+      tdFreeRSmaSubmitItems(pSubmitArr);
+      goto _err;
+    }
     for (int32_t i = 1; i <= TSDB_RETENTION_L2; ++i) {
       if (tdExecuteRSmaImpl(pSma, pSubmitArr->pData, size, STREAM_INPUT__MERGED_SUBMIT, pInfo, type, i) < 0) {
         tdFreeRSmaSubmitItems(pSubmitArr);
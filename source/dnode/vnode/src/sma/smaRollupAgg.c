@@ -0,0 +1,605 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "sma.h"
+
+/**
+ * The rollup of one rsma level computed without the stream task: the running state of each window of each child table
+ * is kept in a hash keyed by (uid, window start), and updated column by column from the blocks decoded out of the
+ * SubmitReqs. Only functions with a fixed size state are computed here, the level falls back to the stream task
+ * otherwise.
+ */
+
+#define RSMA_AGG_WIN_PENDING 0x01  // updated since the window was last emitted as closed
+#define RSMA_AGG_WIN_UNSAVED 0x02  // updated since the last persist
+
+#define RSMA_AGG_STATE_NUM (-2)  // key space in the stream state, apart from the -1 of the stream interval operator
+
+typedef enum {
+  RSMA_AGG_SUM = 1,
+  RSMA_AGG_COUNT,
+  RSMA_AGG_MIN,
+  RSMA_AGG_MAX,
+  RSMA_AGG_FIRST,
+  RSMA_AGG_LAST,
+} ERSmaAggFunc;
+
+typedef struct {
+  int8_t   func;     // ERSmaAggFunc
+  int8_t   type;     // of the column aggregated
+  int8_t   resType;  // of the result
+  col_id_t colId;
+} SRSmaAggCol;
+
+typedef struct {
+  union {
+    int64_t  i;
+    uint64_t u;
+    double   d;
+  };
+  int64_t ts;   // of the value kept by first/last
+  int64_t cnt;  // of the values aggregated
+} SRSmaAggCell;
+
+typedef struct {
+  int8_t       flag;
+  SRSmaAggCell cells[];
+} SRSmaAggWin;
+
+// the state saved at key (0, INT64_MIN), ahead of all the windows
+typedef struct {
+  int64_t maxTs;
+  int64_t savedTs;
+  int32_t nPending;
+  SWinKey pending[];
+} SRSmaAggMeta;
+
+struct SRSmaAgg {
+  SInterval               interval;
+  int64_t                 watermark;
+  int64_t                 deleteMark;
+  bool                    igExpired;
+  int32_t                 nCols;
+  int32_t                 winSize;
+  int64_t                 maxTs;    // of the data aggregated, by which the windows are closed
+  int64_t                 inMaxTs;  // of the data in process, taken as maxTs once the batch is done
+  int64_t                 savedTs;  // the last window saved to pState, any later window not in winHash is a new one
+  int64_t                 version;  // of the latest SubmitReq aggregated
+  SRSmaAggCol            *cols;
+  const SColumnInfoData **pColDatas;  // of each column, in the block in process
+  SHashObj               *winHash;    // key: SWinKey, value: SRSmaAggWin
+  SArray                 *pending;    // SWinKey of the windows with RSMA_AGG_WIN_PENDING
+  SStreamState           *pState;     // holds the windows once evicted from winHash
+};
+
+static const SWinKey rsmaAggMetaKey = {.ts = INT64_MIN, .groupId = 0};
+
+static int8_t tdRSmaAggGetFunc(const char *funcName) {
+  if (strcasecmp(funcName, "sum") == 0) return RSMA_AGG_SUM;
+  if (strcasecmp(funcName, "count") == 0) return RSMA_AGG_COUNT;
+  if (strcasecmp(funcName, "min") == 0) return RSMA_AGG_MIN;
+  if (strcasecmp(funcName, "max") == 0) return RSMA_AGG_MAX;
+  if (strcasecmp(funcName, "first") == 0) return RSMA_AGG_FIRST;
+  if (strcasecmp(funcName, "last") == 0) return RSMA_AGG_LAST;
+  return 0;
+}
+
+// TSDB_DATA_TYPE_NULL if the function is not computed on the type
+static int8_t tdRSmaAggGetResType(int8_t func, int8_t type) {
+  if (func == RSMA_AGG_COUNT) return TSDB_DATA_TYPE_BIGINT;
+  if (IS_VAR_DATA_TYPE(type) || type == TSDB_DATA_TYPE_JSON || type == TSDB_DATA_TYPE_DECIMAL) {
+    return TSDB_DATA_TYPE_NULL;
+  }
+  if (func != RSMA_AGG_SUM) return type;
+  if (IS_SIGNED_NUMERIC_TYPE(type)) return TSDB_DATA_TYPE_BIGINT;
+  if (IS_UNSIGNED_NUMERIC_TYPE(type)) return TSDB_DATA_TYPE_UBIGINT;
+  if (IS_FLOAT_TYPE(type)) return TSDB_DATA_TYPE_DOUBLE;
+  return TSDB_DATA_TYPE_NULL;
+}
+
+static FORCE_INLINE STimeWindow tdRSmaAggGetWindow(SRSmaAgg *pAgg, TSKEY ts) {
+  STimeWindow w;
+  w.skey = taosTimeTruncate(ts, &pAgg->interval, pAgg->interval.precision);
+  w.ekey = taosTimeAdd(w.skey, pAgg->interval.interval, pAgg->interval.intervalUnit, pAgg->interval.precision) - 1;
+  if (w.ekey < w.skey) w.ekey = INT64_MAX;
+  return w;
+}
+
+static FORCE_INLINE int64_t tdRSmaAggGetWindowEnd(SRSmaAgg *pAgg, TSKEY skey) {
+  int64_t ekey = taosTimeAdd(skey, pAgg->interval.interval, pAgg->interval.intervalUnit, pAgg->interval.precision) - 1;
+  return ekey < skey ? INT64_MAX : ekey;
+}
+
+static FORCE_INLINE bool tdRSmaAggIsClosed(SRSmaAgg *pAgg, int64_t ekey) {
+  return pAgg->maxTs != INT64_MIN && ekey < pAgg->maxTs - pAgg->watermark;
+}
+
+static FORCE_INLINE bool tdRSmaAggIsExpired(SRSmaAgg *pAgg, int64_t ekey) {
+  return pAgg->maxTs != INT64_MIN && ekey < pAgg->maxTs - pAgg->deleteMark;
+}
+
+static int32_t tdRSmaAggKeyCmpr(const void *p1, const void *p2) {
+  const SWinKey *pKey1 = p1;
+  const SWinKey *pKey2 = p2;
+  if (pKey1->groupId != pKey2->groupId) return pKey1->groupId < pKey2->groupId ? -1 : 1;
+  if (pKey1->ts != pKey2->ts) return pKey1->ts < pKey2->ts ? -1 : 1;
+  return 0;
+}
+
+static int32_t tdRSmaAggRestore(SRSmaAgg *pAgg) {
+  SRSmaAggMeta *pMeta = NULL;
+  int32_t       len = 0;
+  if (streamStateGet(pAgg->pState, &rsmaAggMetaKey, (void **)&pMeta, &len) < 0) {
+    return TSDB_CODE_SUCCESS;  // nothing saved yet
+  }
+  if (len < sizeof(SRSmaAggMeta) || len != sizeof(SRSmaAggMeta) + pMeta->nPending * sizeof(SWinKey)) {
+    streamFreeVal(pMeta);
+    return TSDB_CODE_RSMA_INVALID_STAT;
+  }
+
+  pAgg->maxTs = pMeta->maxTs;
+  pAgg->savedTs = pMeta->savedTs;
+  for (int32_t i = 0; i < pMeta->nPending; ++i) {
+    SRSmaAggWin *pWin = NULL;
+    int32_t      winLen = 0;
+    if (streamStateGet(pAgg->pState, &pMeta->pending[i], (void **)&pWin, &winLen) < 0) continue;
+    if (winLen == pAgg->winSize) {
+      pWin->flag = RSMA_AGG_WIN_PENDING;
+      if (taosHashPut(pAgg->winHash, &pMeta->pending[i], sizeof(SWinKey), pWin, winLen) < 0 ||
+          !taosArrayPush(pAgg->pending, &pMeta->pending[i])) {
+        streamFreeVal(pWin);
+        streamFreeVal(pMeta);
+        return TSDB_CODE_OUT_OF_MEMORY;
+      }
+    }
+    streamFreeVal(pWin);
+  }
+  streamFreeVal(pMeta);
+  return TSDB_CODE_SUCCESS;
+}
+
+int32_t tdRSmaAggCreate(SRSmaAgg **ppAgg, const STSchema *pTSchema, const SRollupInfo *pRollup, SStreamState *pState) {
+  int32_t nCols = taosArrayGetSize(pRollup->pFuncs);
+
+  *ppAgg = NULL;
+  if (nCols != pTSchema->numOfCols - 1 || pRollup->interval.interval != pRollup->interval.sliding ||
+      pRollup->interval.intervalUnit != pRollup->interval.slidingUnit) {
+    return TSDB_CODE_OPS_NOT_SUPPORT;
+  }
+
+  SRSmaAgg *pAgg = taosMemoryCalloc(1, sizeof(SRSmaAgg));
+  if (!pAgg) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  int32_t code = TSDB_CODE_SUCCESS;
+  pAgg->cols = taosMemoryCalloc(nCols, sizeof(SRSmaAggCol));
+  pAgg->pColDatas = taosMemoryCalloc(nCols, POINTER_BYTES);
+  if (!pAgg->cols || !pAgg->pColDatas) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    goto _err;
+  }
+
+  for (int32_t i = 0; i < nCols; ++i) {
+    const SRollupFunc *pFunc = taosArrayGet(pRollup->pFuncs, i);
+    const STColumn    *pTCol = &pTSchema->columns[i + 1];
+    SRSmaAggCol       *pCol = &pAgg->cols[i];
+
+    pCol->func = tdRSmaAggGetFunc(pFunc->funcName);
+    pCol->type = pTCol->type;
+    pCol->colId = pTCol->colId;
+    pCol->resType = pCol->func ? tdRSmaAggGetResType(pCol->func, pCol->type) : TSDB_DATA_TYPE_NULL;
+    if (pFunc->colId != pTCol->colId || pCol->resType == TSDB_DATA_TYPE_NULL) {
+      code = TSDB_CODE_OPS_NOT_SUPPORT;
+      goto _err;
+    }
+  }
+
+  pAgg->interval = pRollup->interval;
+  pAgg->watermark = pRollup->watermark;
+  pAgg->deleteMark = pRollup->deleteMark;
+  pAgg->igExpired = pRollup->igExpired;
+  pAgg->nCols = nCols;
+  pAgg->winSize = sizeof(SRSmaAggWin) + nCols * sizeof(SRSmaAggCell);
+  pAgg->maxTs = INT64_MIN;
+  pAgg->inMaxTs = INT64_MIN;
+  pAgg->savedTs = INT64_MIN;
+  pAgg->pState = pState;
+
+  pAgg->winHash = taosHashInit(1024, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BINARY), false, HASH_NO_LOCK);
+  pAgg->pending = taosArrayInit(1024, sizeof(SWinKey));
+  if (!pAgg->winHash || !pAgg->pending) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    goto _err;
+  }
+
+  if (pState) {
+    streamStateSetNumber(pState, RSMA_AGG_STATE_NUM);
+    if ((code = tdRSmaAggRestore(pAgg)) < 0) {
+      goto _err;
+    }
+  }
+
+  *ppAgg = pAgg;
+  return TSDB_CODE_SUCCESS;
+_err:
+  tdRSmaAggDestroy(pAgg);
+  return code;
+}
+
+void *tdRSmaAggDestroy(SRSmaAgg *pAgg) {
+  if (pAgg) {
+    taosHashCleanup(pAgg->winHash);
+    taosArrayDestroy(pAgg->pending);
+    taosMemoryFree(pAgg->cols);
+    taosMemoryFree(pAgg->pColDatas);
+    taosMemoryFree(pAgg);
+  }
+  return NULL;
+}
+
+// the window from winHash, from pState if evicted, or a new one
+static SRSmaAggWin *tdRSmaAggGetWin(SRSmaAgg *pAgg, const SWinKey *pKey) {
+  SRSmaAggWin *pWin = taosHashGet(pAgg->winHash, pKey, sizeof(SWinKey));
+  if (pWin) return pWin;
+
+  SRSmaAggWin *pSaved = NULL;
+  int32_t      len = 0;
+  if (pAgg->pState && pKey->ts <= pAgg->savedTs &&
+      streamStateGet(pAgg->pState, pKey, (void **)&pSaved, &len) == 0 && len == pAgg->winSize) {
+    pSaved->flag = 0;
+    pWin = pSaved;
+  } else {
+    pWin = taosMemoryCalloc(1, pAgg->winSize);
+  }
+
+  if (pWin && taosHashPut(pAgg->winHash, pKey, sizeof(SWinKey), pWin, pAgg->winSize) < 0) {
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+  }
+  if (pSaved) {
+    streamFreeVal(pSaved);
+  } else {
+    taosMemoryFree(pWin);
+  }
+  return taosHashGet(pAgg->winHash, pKey, sizeof(SWinKey));
+}
+
+#define RSMA_AGG_FOREACH(T, stmt)                                             \
+  for (int32_t r = start; r < end; ++r) {                                     \
+    if (pColData->hasNull && colDataIsNull_f(pColData->nullbitmap, r)) continue; \
+    T v = ((const T *)pColData->pData)[r];                                    \
+    stmt                                                                      \
+  }
+
+#define RSMA_AGG_UPDATE(T, F)                                                                                  \
+  do {                                                                                                         \
+    switch (pCol->func) {                                                                                      \
+      case RSMA_AGG_SUM:                                                                                       \
+        RSMA_AGG_FOREACH(T, {                                                                                  \
+          pCell->F += v;                                                                                       \
+          ++pCell->cnt;                                                                                        \
+        })                                                                                                     \
+        break;                                                                                                 \
+      case RSMA_AGG_MIN:                                                                                       \
+        RSMA_AGG_FOREACH(T, {                                                                                  \
+          if (pCell->cnt++ == 0 || v < pCell->F) pCell->F = v;                                                 \
+        })                                                                                                     \
+        break;                                                                                                 \
+      case RSMA_AGG_MAX:                                                                                       \
+        RSMA_AGG_FOREACH(T, {                                                                                  \
+          if (pCell->cnt++ == 0 || v > pCell->F) pCell->F = v;                                                 \
+        })                                                                                                     \
+        break;                                                                                                 \
+      case RSMA_AGG_FIRST:                                                                                     \
+        RSMA_AGG_FOREACH(T, {                                                                                  \
+          if (pCell->cnt++ == 0 || tsList[r] <= pCell->ts) {                                                   \
+            pCell->F = v;                                                                                      \
+            pCell->ts = tsList[r];                                                                             \
+          }                                                                                                    \
+        })                                                                                                     \
+        break;                                                                                                 \
+      case RSMA_AGG_LAST:                                                                                      \
+        RSMA_AGG_FOREACH(T, {                                                                                  \
+          if (pCell->cnt++ == 0 || tsList[r] >= pCell->ts) {                                                   \
+            pCell->F = v;                                                                                      \
+            pCell->ts = tsList[r];                                                                             \
+          }                                                                                                    \
+        })                                                                                                     \
+        break;                                                                                                 \
+      default:                                                                                                 \
+        break;                                                                                                 \
+    }                                                                                                          \
+  } while (0)
+
+// aggregate the rows [start, end) of pColData, which all fall into the window of pCell
+static void tdRSmaAggUpdateCell(const SRSmaAggCol *pCol, SRSmaAggCell *pCell, const SColumnInfoData *pColData,
+                                const TSKEY *tsList, int32_t start, int32_t end) {
+  if (pCol->func == RSMA_AGG_COUNT) {
+    if (!pColData->hasNull) {
+      pCell->cnt += end - start;
+    } else if (IS_VAR_DATA_TYPE(pColData->info.type)) {
+      for (int32_t r = start; r < end; ++r) {
+        if (!colDataIsNull_var(pColData, r)) ++pCell->cnt;
+      }
+    } else {
+      for (int32_t r = start; r < end; ++r) {
+        if (!colDataIsNull_f(pColData->nullbitmap, r)) ++pCell->cnt;
+      }
+    }
+    return;
+  }
+
+  switch (pCol->type) {
+    case TSDB_DATA_TYPE_BOOL:
+    case TSDB_DATA_TYPE_TINYINT:
+      RSMA_AGG_UPDATE(int8_t, i);
+      break;
+    case TSDB_DATA_TYPE_UTINYINT:
+      RSMA_AGG_UPDATE(uint8_t, u);
+      break;
+    case TSDB_DATA_TYPE_SMALLINT:
+      RSMA_AGG_UPDATE(int16_t, i);
+      break;
+    case TSDB_DATA_TYPE_USMALLINT:
+      RSMA_AGG_UPDATE(uint16_t, u);
+      break;
+    case TSDB_DATA_TYPE_INT:
+      RSMA_AGG_UPDATE(int32_t, i);
+      break;
+    case TSDB_DATA_TYPE_UINT:
+      RSMA_AGG_UPDATE(uint32_t, u);
+      break;
+    case TSDB_DATA_TYPE_BIGINT:
+    case TSDB_DATA_TYPE_TIMESTAMP:
+      RSMA_AGG_UPDATE(int64_t, i);
+      break;
+    case TSDB_DATA_TYPE_UBIGINT:
+      RSMA_AGG_UPDATE(uint64_t, u);
+      break;
+    case TSDB_DATA_TYPE_FLOAT:
+      RSMA_AGG_UPDATE(float, d);
+      break;
+    case TSDB_DATA_TYPE_DOUBLE:
+      RSMA_AGG_UPDATE(double, d);
+      break;
+    default:
+      break;
+  }
+}
+
+int32_t tdRSmaAggProcess(SRSmaAgg *pAgg, const SSDataBlock *pBlock) {
+  int32_t rows = pBlock->info.rows;
+  if (rows <= 0) return TSDB_CODE_SUCCESS;
+
+  // the block is decoded with the schema version of its table, so the columns are matched by id
+  int32_t                 nBlockCols = taosArrayGetSize(pBlock->pDataBlock);
+  const SColumnInfoData  *pTsCol = taosArrayGet(pBlock->pDataBlock, 0);
+  const SColumnInfoData **pColDatas = pAgg->pColDatas;
+  for (int32_t c = 0, k = 1; c < pAgg->nCols; ++c) {
+    pColDatas[c] = NULL;
+    for (int32_t n = 1; n < nBlockCols; ++n) {
+      const SColumnInfoData *pColData = taosArrayGet(pBlock->pDataBlock, k);
+      k = (k + 1 < nBlockCols) ? k + 1 : 1;
+      if (pColData->info.colId == pAgg->cols[c].colId && pColData->info.type == pAgg->cols[c].type) {
+        pColDatas[c] = pColData;
+        break;
+      }
+    }
+  }
+
+  const TSKEY *tsList = (const TSKEY *)pTsCol->pData;
+  SWinKey      key = {.groupId = pBlock->info.id.uid};
+  for (int32_t start = 0, end = 0; start < rows; start = end) {
+    STimeWindow w = tdRSmaAggGetWindow(pAgg, tsList[start]);
+    for (end = start + 1; end < rows && tsList[end] >= w.skey && tsList[end] <= w.ekey; ++end) {
+    }
+    for (int32_t r = start; r < end; ++r) {
+      if (tsList[r] > pAgg->inMaxTs) pAgg->inMaxTs = tsList[r];
+    }
+
+    // the state of an expired window is gone, so its late rows can not be aggregated into it anymore
+    if ((pAgg->igExpired && tdRSmaAggIsClosed(pAgg, w.ekey)) || tdRSmaAggIsExpired(pAgg, w.ekey)) {
+      continue;
+    }
+
+    key.ts = w.skey;
+    SRSmaAggWin *pWin = tdRSmaAggGetWin(pAgg, &key);
+    if (!pWin) {
+      return TSDB_CODE_OUT_OF_MEMORY;
+    }
+    for (int32_t c = 0; c < pAgg->nCols; ++c) {
+      if (pColDatas[c]) {
+        tdRSmaAggUpdateCell(&pAgg->cols[c], &pWin->cells[c], pColDatas[c], tsList, start, end);
+      }
+    }
+    if (!(pWin->flag & RSMA_AGG_WIN_PENDING) && !taosArrayPush(pAgg->pending, &key)) {
+      return TSDB_CODE_OUT_OF_MEMORY;
+    }
+    pWin->flag |= (RSMA_AGG_WIN_PENDING | RSMA_AGG_WIN_UNSAVED);
+  }
+
+  if (pBlock->info.version > pAgg->version) pAgg->version = pBlock->info.version;
+  return TSDB_CODE_SUCCESS;
+}
+
+static SSDataBlock *tdRSmaAggCreateBlock(SRSmaAgg *pAgg, tb_uid_t uid, int32_t rows) {
+  SSDataBlock *pBlock = createDataBlock();
+  if (!pBlock) return NULL;
+
+  SColumnInfoData colInfo = createColumnInfoData(TSDB_DATA_TYPE_TIMESTAMP, tDataTypes[TSDB_DATA_TYPE_TIMESTAMP].bytes,
+                                                 PRIMARYKEY_TIMESTAMP_COL_ID);
+  blockDataAppendColInfo(pBlock, &colInfo);
+  for (int32_t c = 0; c < pAgg->nCols; ++c) {
+    colInfo = createColumnInfoData(pAgg->cols[c].resType, tDataTypes[pAgg->cols[c].resType].bytes, pAgg->cols[c].colId);
+    blockDataAppendColInfo(pBlock, &colInfo);
+  }
+  if (blockDataEnsureCapacity(pBlock, rows) < 0) {
+    return blockDataDestroy(pBlock);
+  }
+
+  pBlock->info.id.uid = uid;
+  pBlock->info.id.groupId = uid;
+  pBlock->info.version = pAgg->version;
+  return pBlock;
+}
+
+static void tdRSmaAggSetResult(const SRSmaAggCol *pCol, const SRSmaAggCell *pCell, SColumnInfoData *pColData,
+                               int32_t row) {
+  char buf[sizeof(int64_t)] = {0};
+
+  if (pCol->func == RSMA_AGG_COUNT) {
+    colDataAppend(pColData, row, (const char *)&pCell->cnt, false);
+    return;
+  }
+  if (pCell->cnt == 0) {
+    colDataAppendNULL(pColData, row);
+    return;
+  }
+
+  if (IS_FLOAT_TYPE(pCol->resType)) {
+    SET_TYPED_DATA(buf, pCol->resType, pCell->d);
+  } else if (IS_UNSIGNED_NUMERIC_TYPE(pCol->resType)) {
+    SET_TYPED_DATA(buf, pCol->resType, pCell->u);
+  } else {
+    SET_TYPED_DATA(buf, pCol->resType, pCell->i);
+  }
+  colDataAppend(pColData, row, buf, false);
+}
+
+int32_t tdRSmaAggGetResult(SRSmaAgg *pAgg, bool fetchAll, SArray *pResList) {
+  if (pAgg->inMaxTs > pAgg->maxTs) pAgg->maxTs = pAgg->inMaxTs;
+
+  int32_t nPending = taosArrayGetSize(pAgg->pending);
+  if (nPending <= 0) return TSDB_CODE_SUCCESS;
+
+  taosArraySort(pAgg->pending, tdRSmaAggKeyCmpr);
+
+  // the windows of one table go out in one block, and the ones closed leave the pending list
+  int32_t nKept = 0;
+  for (int32_t i = 0, j = 0; i < nPending; i = j) {
+    SWinKey *pKeys = TARRAY_GET_ELEM(pAgg->pending, 0);
+    int32_t  nRows = 0;
+    for (j = i; j < nPending && pKeys[j].groupId == pKeys[i].groupId; ++j) {
+      if (fetchAll || tdRSmaAggIsClosed(pAgg, tdRSmaAggGetWindowEnd(pAgg, pKeys[j].ts))) ++nRows;
+    }
+    if (nRows == 0) {
+      memmove(&pKeys[nKept], &pKeys[i], (j - i) * sizeof(SWinKey));
+      nKept += j - i;
+      continue;
+    }
+
+    SSDataBlock *pBlock = tdRSmaAggCreateBlock(pAgg, pKeys[i].groupId, nRows);
+    if (!pBlock || !taosArrayPush(pResList, &pBlock)) {
+      blockDataDestroy(pBlock);
+      return TSDB_CODE_OUT_OF_MEMORY;
+    }
+
+    SColumnInfoData *pTsCol = taosArrayGet(pBlock->pDataBlock, 0);
+    for (int32_t k = i; k < j; ++k) {
+      SWinKey      key = pKeys[k];
+      SRSmaAggWin *pWin = taosHashGet(pAgg->winHash, &key, sizeof(SWinKey));
+      bool         closed = tdRSmaAggIsClosed(pAgg, tdRSmaAggGetWindowEnd(pAgg, key.ts));
+      if (!pWin) continue;
+      if (fetchAll || closed) {
+        int32_t row = pBlock->info.rows++;
+        colDataAppend(pTsCol, row, (const char *)&key.ts, false);
+        for (int32_t c = 0; c < pAgg->nCols; ++c) {
+          tdRSmaAggSetResult(&pAgg->cols[c], &pWin->cells[c], taosArrayGet(pBlock->pDataBlock, c + 1), row);
+        }
+      }
+      if (closed) {
+        pWin->flag &= ~RSMA_AGG_WIN_PENDING;
+      } else {
+        pKeys[nKept++] = key;
+      }
+    }
+  }
+  taosArraySetSize(pAgg->pending, nKept);
+
+  return TSDB_CODE_SUCCESS;
+}
+
+/**
+ * @brief Save the windows updated to the stream state, together with maxTs and the pending list, and evict the closed
+ * windows from memory. The stream state is committed by the caller.
+ *
+ * @param pAgg
+ * @return int32_t
+ */
+int32_t tdRSmaAggPersist(SRSmaAgg *pAgg) {
+  if (!pAgg->pState) return TSDB_CODE_SUCCESS;
+
+  SArray *pEvicted = taosArrayInit(64, sizeof(SWinKey));
+  if (!pEvicted) return TSDB_CODE_OUT_OF_MEMORY;
+
+  int32_t code = TSDB_CODE_SUCCESS;
+  void   *pIter = NULL;
+  while ((pIter = taosHashIterate(pAgg->winHash, pIter))) {
+    SRSmaAggWin *pWin = pIter;
+    SWinKey     *pKey = taosHashGetKey(pIter, NULL);
+    int64_t      ekey = tdRSmaAggGetWindowEnd(pAgg, pKey->ts);
+
+    if ((pWin->flag & RSMA_AGG_WIN_UNSAVED) && !tdRSmaAggIsExpired(pAgg, ekey)) {
+      int8_t flag = pWin->flag;
+      pWin->flag = 0;
+      code = streamStatePut(pAgg->pState, pKey, pWin, pAgg->winSize);
+      pWin->flag = flag & ~RSMA_AGG_WIN_UNSAVED;
+      if (code < 0) {
+        taosHashCancelIterate(pAgg->winHash, pIter);
+        goto _end;
+      }
+      if (pKey->ts > pAgg->savedTs) pAgg->savedTs = pKey->ts;
+    }
+    if (!(pWin->flag & RSMA_AGG_WIN_PENDING) && tdRSmaAggIsClosed(pAgg, ekey)) {
+      taosArrayPush(pEvicted, pKey);
+    }
+  }
+  for (int32_t i = 0; i < taosArrayGetSize(pEvicted); ++i) {
+    taosHashRemove(pAgg->winHash, taosArrayGet(pEvicted, i), sizeof(SWinKey));
+  }
+
+  int32_t       nPending = taosArrayGetSize(pAgg->pending);
+  int32_t       metaLen = sizeof(SRSmaAggMeta) + nPending * sizeof(SWinKey);
+  SRSmaAggMeta *pMeta = taosMemoryMalloc(metaLen);
+  if (!pMeta) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    goto _end;
+  }
+  pMeta->maxTs = pAgg->maxTs;
+  pMeta->savedTs = pAgg->savedTs;
+  pMeta->nPending = nPending;
+  if (nPending > 0) memcpy(pMeta->pending, TARRAY_GET_ELEM(pAgg->pending, 0), nPending * sizeof(SWinKey));
+  code = streamStatePut(pAgg->pState, &rsmaAggMetaKey, pMeta, metaLen);
+  taosMemoryFree(pMeta);
+  if (code < 0) goto _end;
+
+  // the saved windows are ordered by start, so the expired ones come right after the meta key
+  taosArrayClear(pEvicted);
+  SStreamStateCur *pCur = streamStateSeekKeyNext(pAgg->pState, &rsmaAggMetaKey);
+  SWinKey          key = {0};
+  while (streamStateGetKVByCur(pCur, &key, NULL, NULL) == 0) {
+    if (!tdRSmaAggIsExpired(pAgg, tdRSmaAggGetWindowEnd(pAgg, key.ts))) break;
+    taosArrayPush(pEvicted, &key);
+    streamStateCurNext(pAgg->pState, pCur);
+  }
+  streamStateFreeCur(pCur);
+  for (int32_t i = 0; i < taosArrayGetSize(pEvicted); ++i) {
+    streamStateDel(pAgg->pState, taosArrayGet(pEvicted, i));
+  }
+
+_end:
+  taosArrayDestroy(pEvicted);
+  return code;
+}
@@ -443,6 +443,82 @@ bool tqNextDataBlockFilterOut(STqReader* pHandle, SHashObj* filterOutUids) {
   return false;
 }
 
+#define TQ_DECODE_ROWS 128  // rows decoded together by tqRetrieveDataBlock
+
+// Decodes one column of the rows [startRow, endRow). Fixed length values of tuples are copied straight into the
+// column, the others go through the iterators of the rows, which are reset per batch of rows.
+static int32_t tqDecodeRowsToCol(SColumnInfoData* pColData, STSchema* pTschema, int32_t iSchema, STSRow** pRows,
+                                 STSRowIter* aIter, int32_t startRow, int32_t endRow) {
+  STColumn* pCol = iSchema < 0 ? NULL : &pTschema->columns[iSchema];
+  col_id_t  colId = pColData->info.colId;
+
+  for (int32_t iRow = startRow; iRow < endRow; iRow++) {
+    STSRow*  pRow = pRows[iRow];
+    SCellVal sVal = {.valType = TD_VTYPE_NONE};
+
+    if (pCol != NULL && TD_IS_TP_ROW(pRow) && !IS_VAR_DATA_TYPE(pCol->type)) {
+      char* pDst = pColData->pData + pColData->info.bytes * iRow;
+      if (colId == PRIMARYKEY_TIMESTAMP_COL_ID) {
+        memcpy(pDst, &pRow->ts, pColData->info.bytes);
+        continue;
+      }
+
+      if (pRow->statis != 0) {
+        tdGetBitmapValTypeII(tdGetBitmapAddrTp(pRow, pTschema->flen), iSchema - 1, &sVal.valType);
+      } else {
+        sVal.valType = TD_VTYPE_NORM;
+      }
+      if (sVal.valType == TD_VTYPE_NORM) {
+        memcpy(pDst, POINTER_SHIFT(TD_ROW_DATA(pRow), pCol->offset), pColData->info.bytes);
+      } else {
+        colDataAppendNULL(pColData, iRow);
+      }
+      continue;
+    }
+
+    // a column missing in this schema version is left null
+    if (pCol == NULL || !tdSTSRowIterFetch(&aIter[iRow - startRow], colId, pCol->type, &sVal)) {
+      sVal.valType = TD_VTYPE_NONE;
+    }
+    if (colDataAppend(pColData, iRow, sVal.val, sVal.valType != TD_VTYPE_NORM) < 0) {
+      return -1;
+    }
+  }
+
+  return 0;
+}
+
+// copy the columns of a decoded columnar block into the ones of pBlock with the same ids, the others being null
+static int32_t tqCopyColBlk(SSDataBlock* pBlock, const SSDataBlock* pColBlock) {
+  int32_t numOfRows = pColBlock->info.rows;
+  int32_t numOfSrcCols = taosArrayGetSize(pColBlock->pDataBlock);
+  int32_t numOfCols = taosArrayGetSize(pBlock->pDataBlock);
+
+  for (int32_t i = 0, j = 0; i < numOfCols; i++) {
+    SColumnInfoData* pColData = taosArrayGet(pBlock->pDataBlock, i);
+    SColumnInfoData* pSrc = NULL;
+    while (j < numOfSrcCols) {
+      pSrc = taosArrayGet(pColBlock->pDataBlock, j);
+      if (pSrc->info.colId >= pColData->info.colId) break;
+      j++;
+    }
+
+    if (j < numOfSrcCols && pSrc->info.colId == pColData->info.colId) {
+      SColumnInfo info = pColData->info;
+      if (colDataAssign(pColData, pSrc, numOfRows, &pBlock->info) != 0) {
+        return TSDB_CODE_INVALID_MSG;
+      }
+      pColData->info = info;
+    } else {
+      colDataAppendNNULL(pColData, 0, numOfRows);
+    }
+  }
+
+  pBlock->info.rows = numOfRows;
+  pBlock->info.dataLoad = 1;
+  return TSDB_CODE_SUCCESS;
+}
+
 int32_t tqRetrieveDataBlock(SSDataBlock* pBlock, STqReader* pReader) {
   // TODO: cache multiple schema
   int32_t sversion = htonl(pReader->pBlock->sversion);
@@ -516,40 +592,84 @@ int32_t tqRetrieveDataBlock(SSDataBlock* pBlock, STqReader* pReader) {
     }
   }
 
+  // a columnar block is copied by column, the rows of old log entries are decoded as below
+  SSubmitColHead* pColHead = tGetSubmitColHead(&pReader->msgIter, pReader->pBlock);
+  if (pColHead) {
+    SSDataBlock colBlock = {0};
+    int32_t     code = tDecodeSubmitColBlk(pColHead, pReader->msgIter.dataLen, pTschema, &colBlock);
+    if (code == TSDB_CODE_SUCCESS) {
+      code = blockDataEnsureCapacity(pBlock, colBlock.info.rows);
+    }
+    if (code == TSDB_CODE_SUCCESS) {
+      code = tqCopyColBlk(pBlock, &colBlock);
+    }
+    blockDataFreeRes(&colBlock);
+    if (code != TSDB_CODE_SUCCESS) {
+      terrno = code;
+      goto FAIL;
+    }
+
+    pBlock->info.id.uid = pReader->msgIter.uid;
+    pBlock->info.version = pReader->pMsg->version;
+    return 0;
+  }
+
   if (blockDataEnsureCapacity(pBlock, pReader->msgIter.numOfRows) < 0) {
     terrno = TSDB_CODE_OUT_OF_MEMORY;
     goto FAIL;
   }
 
-  int32_t colActual = blockDataGetNumOfCols(pBlock);
-
-  STSRowIter iter = {0};
-  tdSTSRowIterInit(&iter, pTschema);
-  STSRow* row;
-  int32_t curRow = 0;
+  int32_t  colActual = blockDataGetNumOfCols(pBlock);
+  int32_t  numOfRows = 0;
+  STSRow** pRows = taosMemoryMalloc(sizeof(STSRow*) * TMAX(pReader->msgIter.numOfRows, 1));
+  int32_t* aSchemaIdx = taosMemoryMalloc(sizeof(int32_t) * TMAX(colActual, 1));
+  if (pRows == NULL || aSchemaIdx == NULL) {
+    taosMemoryFree(pRows);
+    taosMemoryFree(aSchemaIdx);
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    goto FAIL;
+  }
 
   tInitSubmitBlkIter(&pReader->msgIter, pReader->pBlock, &pReader->blkIter);
+  while (numOfRows < pReader->msgIter.numOfRows && (pRows[numOfRows] = tGetSubmitBlkNext(&pReader->blkIter)) != NULL) {
+    numOfRows++;
+  }
 
   pBlock->info.id.uid = pReader->msgIter.uid;
   pBlock->info.rows = pReader->msgIter.numOfRows;
   pBlock->info.version = pReader->pMsg->version;
   pBlock->info.dataLoad = 1;
 
-  while ((row = tGetSubmitBlkNext(&pReader->blkIter)) != NULL) {
-    tdSTSRowIterReset(&iter, row);
-    // get all wanted col of that block
+  // the place of every wanted column in the schema is looked up once per block instead of once per row
+  for (int32_t i = 0, iSchema = 0; i < colActual; i++) {
+    SColumnInfoData* pColData = taosArrayGet(pBlock->pDataBlock, i);
+    while (iSchema < pTschema->numOfCols && pTschema->columns[iSchema].colId < pColData->info.colId) {
+      iSchema++;
+    }
+    aSchemaIdx[i] =
+        (iSchema < pTschema->numOfCols && pTschema->columns[iSchema].colId == pColData->info.colId) ? iSchema : -1;
+  }
+
+  // fill the block column by column, a few rows at a time so that they stay in cache
+  STSRowIter aIter[TQ_DECODE_ROWS];
+  for (int32_t startRow = 0; startRow < numOfRows; startRow += TQ_DECODE_ROWS) {
+    int32_t endRow = TMIN(startRow + TQ_DECODE_ROWS, numOfRows);
+    for (int32_t iRow = startRow; iRow < endRow; iRow++) {
+      tdSTSRowIterInit(&aIter[iRow - startRow], pTschema);
+      tdSTSRowIterReset(&aIter[iRow - startRow], pRows[iRow]);
+    }
     for (int32_t i = 0; i < colActual; i++) {
       SColumnInfoData* pColData = taosArrayGet(pBlock->pDataBlock, i);
-      SCellVal         sVal = {0};
-      if (!tdSTSRowIterFetch(&iter, pColData->info.colId, pColData->info.type, &sVal)) {
-        break;
-      }
-      if (colDataAppend(pColData, curRow, sVal.val, sVal.valType != TD_VTYPE_NORM) < 0) {
+      if (tqDecodeRowsToCol(pColData, pTschema, aSchemaIdx[i], pRows, aIter, startRow, endRow) < 0) {
+        taosMemoryFree(pRows);
+        taosMemoryFree(aSchemaIdx);
         goto FAIL;
       }
     }
-    curRow++;
   }
+
+  taosMemoryFree(pRows);
+  taosMemoryFree(aSchemaIdx);
   return 0;
 
 FAIL:
@@ -557,6 +677,62 @@ FAIL:
   return -1;
 }
 
+// the columns of a columnar block are assigned in all of its rows, which go into one block of just those columns
+static int32_t tqRetrieveTaosxColBlk(STqReader* pReader, SSubmitColHead* pColHead, SArray* blocks, SArray* schemas) {
+  SSchemaWrapper* pSchemaWrapper = pReader->pSchemaWrapper;
+  SSDataBlock     colBlock = {0};
+  SSDataBlock*    pBlock = NULL;
+  SSchemaWrapper* pSW = NULL;
+  char*           assigned = taosMemoryCalloc(1, pSchemaWrapper->nCols);
+  int32_t         code = TSDB_CODE_OUT_OF_MEMORY;
+  if (assigned == NULL) goto _exit;
+
+  code = tDecodeSubmitColBlk(pColHead, pReader->msgIter.dataLen, pReader->pSchema, &colBlock);
+  if (code) goto _exit;
+
+  int32_t numOfCols = taosArrayGetSize(colBlock.pDataBlock);
+  for (int32_t i = 0, j = 0; i < pSchemaWrapper->nCols && j < numOfCols; i++) {
+    SColumnInfoData* pCol = taosArrayGet(colBlock.pDataBlock, j);
+    if (pSchemaWrapper->pSchema[i].colId == pCol->info.colId) {
+      assigned[i] = 1;
+      j++;
+    }
+  }
+
+  pBlock = createDataBlock();
+  pSW = taosMemoryCalloc(1, sizeof(SSchemaWrapper));
+  if (pBlock == NULL || pSW == NULL || tqMaskBlock(pSW, pBlock, pSchemaWrapper, assigned) < 0 ||
+      blockDataEnsureCapacity(pBlock, colBlock.info.rows) < 0) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    goto _exit;
+  }
+
+  code = tqCopyColBlk(pBlock, &colBlock);
+  if (code) goto _exit;
+
+  pBlock->info.id.uid = pReader->msgIter.uid;
+  pBlock->info.version = pReader->pMsg->version;
+  tqDebug("vgId:%d, taosx scan, columnar block of %d rows, col %d", pReader->pWalReader->pWal->cfg.vgId,
+          pBlock->info.rows, (int32_t)taosArrayGetSize(pBlock->pDataBlock));
+
+  taosArrayPush(blocks, pBlock);
+  taosArrayPush(schemas, &pSW);
+  taosMemoryFree(pBlock);
+  pBlock = NULL;
+  pSW = NULL;
+
+_exit:
+  blockDataDestroy(pBlock);
+  tDeleteSSchemaWrapper(pSW);
+  blockDataFreeRes(&colBlock);
+  taosMemoryFree(assigned);
+  if (code) {
+    terrno = code;
+    return -1;
+  }
+  return 0;
+}
+
 int32_t tqRetrieveTaosxBlock(STqReader* pReader, SArray* blocks, SArray* schemas) {
   int32_t sversion = htonl(pReader->pBlock->sversion);
 
@@ -590,6 +766,11 @@ int32_t tqRetrieveTaosxBlock(STqReader* pReader, SArray* blocks, SArray* schemas
   STSchema*       pTschema = pReader->pSchema;
   SSchemaWrapper* pSchemaWrapper = pReader->pSchemaWrapper;
 
+  SSubmitColHead* pColHead = tGetSubmitColHead(&pReader->msgIter, pReader->pBlock);
+  if (pColHead) {
+    return tqRetrieveTaosxColBlk(pReader, pColHead, blocks, schemas);
+  }
+
   int32_t colAtMost = pSchemaWrapper->nCols;
 
   int32_t curRow = 0;
@@ -46,6 +46,37 @@ void tsdbCloseCache(STsdb *pTsdb) {
   }
 }
 
+int32_t tsdbOpenBlockCache(STsdb *pTsdb) {
+  size_t capacity = (size_t)tsTsdbBlockCacheSize * 1024 * 1024;
+
+  pTsdb->blockCache.pCache = NULL;
+  pTsdb->blockCache.gen = 0;
+  pTsdb->blockCache.nHit = 0;
+  pTsdb->blockCache.nMiss = 0;
+  if (capacity == 0) return 0;
+
+  pTsdb->blockCache.pCache = taosLRUCacheInit(capacity, -1, .5);
+  if (pTsdb->blockCache.pCache == NULL) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  // a full cache rejects new blocks instead of growing
+  taosLRUCacheSetStrictCapacity(pTsdb->blockCache.pCache, true);
+  return 0;
+}
+
+void tsdbCloseBlockCache(STsdb *pTsdb) {
+  SLRUCache *pCache = pTsdb->blockCache.pCache;
+  if (pCache) {
+    tsdbDebug("vgId:%d, tsdb block cache closed, hit:%" PRId64 " miss:%" PRId64 " usage:%" PRIzu,
+              TD_VID(pTsdb->pVnode), pTsdb->blockCache.nHit, pTsdb->blockCache.nMiss, taosLRUCacheGetUsage(pCache));
+
+    taosLRUCacheEraseUnrefEntries(pCache);
+    taosLRUCacheCleanup(pCache);
+    pTsdb->blockCache.pCache = NULL;
+  }
+}
+
 static void getTableCacheKey(tb_uid_t uid, int cacheType, char *key, int *len) {
   if (cacheType == 0) {  // last_row
     *(uint64_t *)key = (uint64_t)uid;
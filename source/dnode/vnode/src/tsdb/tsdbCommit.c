@@ -38,6 +38,16 @@ typedef struct {
   };
 } SDataIter;
 
+// the files written for one fileset, upserted into the fs in fid order once all the filesets are committed
+typedef struct {
+  int32_t   fid;
+  SDFileSet wSet;
+  SHeadFile fHead;
+  SDataFile fData;
+  SSmaFile  fSma;
+  SSttFile  aSttF[TSDB_MAX_STT_TRIGGER];
+} SCommitFSet;
+
 typedef struct {
   STsdb *pTsdb;
   /* commit data */
@@ -54,8 +64,9 @@ typedef struct {
   TSKEY   nextKey;  // reset by each table commit
   int32_t commitFid;
   int32_t expLevel;
-  TSKEY   minKey;
-  TSKEY   maxKey;
+  TSKEY        minKey;
+  TSKEY        maxKey;
+  SCommitFSet *pFSet;
   // commit file data
   struct {
     SDataFReader *pReader;
@@ -94,6 +105,15 @@ typedef struct {
   SArray      *aDelData;  // SArray<SDelData>
 } SCommitter;
 
+// the filesets do not share any file, so they are committed in parallel, each by its own committer
+typedef struct {
+  SCommitter      *pCommitter;
+  SCommitFSet     *aFSet;
+  int32_t          nFSet;
+  volatile int32_t iFSet;  // the next one to take
+  volatile int32_t code;
+} SCommitFSetJob;
+
 static int32_t tsdbStartCommit(STsdb *pTsdb, SCommitter *pCommitter, SCommitInfo *pInfo);
 static int32_t tsdbCommitData(SCommitter *pCommitter);
 static int32_t tsdbCommitDel(SCommitter *pCommitter);
@@ -503,13 +523,10 @@ static int32_t tsdbCommitFileDataStart(SCommitter *pCommitter) {
   SDFileSet *pRSet = NULL;
 
   // memory
-  pCommitter->commitFid = tsdbKeyFid(pCommitter->nextKey, pCommitter->minutes, pCommitter->precision);
+  pCommitter->commitFid = pCommitter->pFSet->fid;
   pCommitter->expLevel = tsdbFidLevel(pCommitter->commitFid, &pCommitter->pTsdb->keepCfg, taosGetTimestampSec());
   tsdbFidKeyRange(pCommitter->commitFid, pCommitter->minutes, pCommitter->precision, &pCommitter->minKey,
                   &pCommitter->maxKey);
-#if 0
-  ASSERT(pCommitter->minKey <= pCommitter->nextKey && pCommitter->maxKey >= pCommitter->nextKey);
-#endif
 
   pCommitter->nextKey = TSKEY_MAX;
 
@@ -745,9 +762,22 @@ static int32_t tsdbCommitFileDataEnd(SCommitter *pCommitter) {
   code = tsdbUpdateDFileSetHeader(pCommitter->dWriter.pWriter);
   TSDB_CHECK_CODE(code, lino, _exit);
 
-  // upsert SDFileSet
-  code = tsdbFSUpsertFSet(&pCommitter->fs, &pCommitter->dWriter.pWriter->wSet);
-  TSDB_CHECK_CODE(code, lino, _exit);
+  // keep SDFileSet, it is upserted after all the filesets are committed
+  SCommitFSet *pFSet = pCommitter->pFSet;
+  SDFileSet   *pSet = &pCommitter->dWriter.pWriter->wSet;
+  pFSet->fHead = *pSet->pHeadF;
+  pFSet->fData = *pSet->pDataF;
+  pFSet->fSma = *pSet->pSmaF;
+  pFSet->wSet = (SDFileSet){.diskId = pSet->diskId,
+                            .fid = pSet->fid,
+                            .pHeadF = &pFSet->fHead,
+                            .pDataF = &pFSet->fData,
+                            .pSmaF = &pFSet->fSma,
+                            .nSttF = pSet->nSttF};
+  for (int32_t iStt = 0; iStt < pSet->nSttF; iStt++) {
+    pFSet->aSttF[iStt] = *pSet->aSttF[iStt];
+    pFSet->wSet.aSttF[iStt] = &pFSet->aSttF[iStt];
+  }
 
   // close and sync
   code = tsdbDataFWriterClose(&pCommitter->dWriter.pWriter, 1);
@@ -936,34 +966,162 @@ static void tsdbCommitDataEnd(SCommitter *pCommitter) {
   tDestroyTSchema(pCommitter->skmRow.pTSchema);
 }
 
+// the fids of all the rows in memory, each table is visited once per fileset it has rows in
+static int32_t tsdbCommitGetFids(SCommitter *pCommitter, SArray *aFid) {
+  int32_t code = 0;
+  int32_t lino = 0;
+
+  for (int32_t iTbData = 0; iTbData < taosArrayGetSize(pCommitter->aTbDataP); iTbData++) {
+    STbData    *pTbData = (STbData *)taosArrayGetP(pCommitter->aTbDataP, iTbData);
+    TSDBKEY     tKey = {.ts = pTbData->minKey, .version = VERSION_MIN};
+    STbDataIter iter = {0};
+
+    for (;;) {
+      tsdbTbDataIterOpen(pTbData, &tKey, 0, &iter);
+      TSDBROW *pRow = tsdbTbDataIterGet(&iter);
+      if (pRow == NULL) break;
+
+      int32_t fid = tsdbKeyFid(TSDBROW_TS(pRow), pCommitter->minutes, pCommitter->precision);
+      if (taosArrayPush(aFid, &fid) == NULL) {
+        code = TSDB_CODE_OUT_OF_MEMORY;
+        TSDB_CHECK_CODE(code, lino, _exit);
+      }
+
+      TSKEY minKey, maxKey;
+      tsdbFidKeyRange(fid, pCommitter->minutes, pCommitter->precision, &minKey, &maxKey);
+      if (maxKey == TSKEY_MAX) break;
+      tKey.ts = maxKey + 1;
+    }
+  }
+
+  taosArraySort(aFid, compareInt32Val);
+  taosArrayRemoveDuplicate(aFid, compareInt32Val, NULL);
+
+_exit:
+  if (code) {
+    tsdbError("vgId:%d, %s failed at line %d since %s", TD_VID(pCommitter->pTsdb->pVnode), __func__, lino,
+              tstrerror(code));
+  }
+  return code;
+}
+
+static int32_t tsdbCommitFSets(SCommitFSetJob *pJob) {
+  int32_t     code = 0;
+  SCommitter *pBase = pJob->pCommitter;
+  SCommitter  committer = {0};
+
+  // the fs is only searched until all the filesets are done
+  committer.pTsdb = pBase->pTsdb;
+  committer.commitID = pBase->commitID;
+  committer.minutes = pBase->minutes;
+  committer.precision = pBase->precision;
+  committer.minRow = pBase->minRow;
+  committer.maxRow = pBase->maxRow;
+  committer.cmprAlg = pBase->cmprAlg;
+  committer.sttTrigger = pBase->sttTrigger;
+  committer.aTbDataP = pBase->aTbDataP;
+  committer.fs = pBase->fs;
+
+  code = tsdbCommitDataStart(&committer);
+  while (code == 0 && atomic_load_32(&pJob->code) == 0) {
+    int32_t iFSet = atomic_fetch_add_32(&pJob->iFSet, 1);
+    if (iFSet >= pJob->nFSet) break;
+
+    committer.pFSet = &pJob->aFSet[iFSet];
+    code = tsdbCommitFileData(&committer);
+  }
+  tsdbCommitDataEnd(&committer);
+
+  if (code) {
+    atomic_val_compare_exchange_32(&pJob->code, 0, code);
+  }
+  return code;
+}
+
+static void *tsdbCommitFSetsThreadFp(void *arg) {
+  setThreadName("vnode-commit");
+  tsdbCommitFSets((SCommitFSetJob *)arg);
+  return NULL;
+}
+
 static int32_t tsdbCommitData(SCommitter *pCommitter) {
   int32_t code = 0;
   int32_t lino = 0;
 
-  STsdb     *pTsdb = pCommitter->pTsdb;
-  SMemTable *pMemTable = pTsdb->imem;
+  STsdb         *pTsdb = pCommitter->pTsdb;
+  SMemTable     *pMemTable = pTsdb->imem;
+  SArray        *aFid = NULL;
+  SCommitFSetJob job = {.pCommitter = pCommitter};
+  TdThread      *threads = NULL;
+  int32_t        nThread = 0;
 
   // check
   if (pMemTable->nRow == 0) goto _exit;
 
   // start ====================
-  code = tsdbCommitDataStart(pCommitter);
+  aFid = taosArrayInit(0, sizeof(int32_t));
+  if (aFid == NULL) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    TSDB_CHECK_CODE(code, lino, _exit);
+  }
+
+  code = tsdbCommitGetFids(pCommitter, aFid);
   TSDB_CHECK_CODE(code, lino, _exit);
 
-  // impl ====================
-  pCommitter->nextKey = pMemTable->minKey;
-  while (pCommitter->nextKey < TSKEY_MAX) {
-    code = tsdbCommitFileData(pCommitter);
+  job.nFSet = taosArrayGetSize(aFid);
+  job.aFSet = (SCommitFSet *)taosMemoryCalloc(job.nFSet, sizeof(SCommitFSet));
+  if (job.aFSet == NULL) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
     TSDB_CHECK_CODE(code, lino, _exit);
   }
+  for (int32_t iFSet = 0; iFSet < job.nFSet; iFSet++) {
+    job.aFSet[iFSet].fid = *(int32_t *)taosArrayGet(aFid, iFSet);
+  }
+
+  // impl ====================
+  // the commit thread takes a share as well
+  nThread = TMIN(job.nFSet, tsNumOfCommitFsetThreads) - 1;
+  if (nThread > 0) {
+    threads = (TdThread *)taosMemoryCalloc(nThread, sizeof(TdThread));
+    if (threads == NULL) nThread = 0;
+  }
+
+  TdThreadAttr thAttr;
+  taosThreadAttrInit(&thAttr);
+  taosThreadAttrSetDetachState(&thAttr, PTHREAD_CREATE_JOINABLE);
+  for (int32_t iThread = 0; iThread < nThread; iThread++) {
+    if (taosThreadCreate(&threads[iThread], &thAttr, tsdbCommitFSetsThreadFp, &job) != 0) {
+      tsdbWarn("vgId:%d, failed to create commit thread since %s", TD_VID(pTsdb->pVnode),
+               tstrerror(TAOS_SYSTEM_ERROR(errno)));
+      nThread = iThread;
+      break;
+    }
+  }
+  taosThreadAttrDestroy(&thAttr);
+
+  tsdbCommitFSets(&job);
+  for (int32_t iThread = 0; iThread < nThread; iThread++) {
+    taosThreadJoin(threads[iThread], NULL);
+  }
+
+  code = job.code;
+  TSDB_CHECK_CODE(code, lino, _exit);
 
   // end ====================
-  tsdbCommitDataEnd(pCommitter);
+  for (int32_t iFSet = 0; iFSet < job.nFSet; iFSet++) {
+    code = tsdbFSUpsertFSet(&pCommitter->fs, &job.aFSet[iFSet].wSet);
+    TSDB_CHECK_CODE(code, lino, _exit);
+  }
+
+  tsdbDebug("vgId:%d, commit data done, nFSet:%d nThread:%d", TD_VID(pTsdb->pVnode), job.nFSet, nThread + 1);
 
 _exit:
   if (code) {
     tsdbError("vgId:%d, %s failed at line %d since %s", TD_VID(pTsdb->pVnode), __func__, lino, tstrerror(code));
   }
+  taosMemoryFree(threads);
+  taosMemoryFree(job.aFSet);
+  taosArrayDestroy(aFid);
   return code;
 }
 
@@ -15,13 +15,705 @@
 
 #include "tsdb.h"
 
+typedef enum { COMPACT_DATA_FILE_ITER = 0, COMPACT_STT_FILE_ITER } ECIterT;
+
+typedef struct {
+  SRBTreeNode n;
+  SRowInfo    rInfo;
+  ECIterT     type;
+  union {
+    struct {
+      SArray*    aBlockIdx;
+      int32_t    iBlockIdx;
+      SBlockIdx* pBlockIdx;
+      SMapData   mBlock;
+      int32_t    iBlock;
+    };  // .data file
+    struct {
+      int32_t iStt;
+      SArray* aSttBlk;
+      int32_t iSttBlk;
+    };  // .stt file
+  };
+  SBlockData bData;
+  int32_t    iRow;
+} SCompactIter;
+
 typedef struct {
-  STsdb  *pTsdb;
-  STsdbFS fs;
+  STsdb*  pTsdb;
+  int64_t commitID;
+  int32_t maxRow;
+  int8_t  cmprAlg;
+  int64_t maxSpeed;  // bytes per second, 0 means no limit
+  STsdbFS fs;        // referenced file system
+  // reader
+  SDFileSet     rSet;  // value copy of the file set being compacted
+  SHeadFile     fHead;
+  SDataFile     fData;
+  SSmaFile      fSma;
+  SSttFile      fStt[TSDB_MAX_STT_TRIGGER];
+  SDataFReader* pReader;
+  SCompactIter* pIter;
+  SRBTree       rbt;
+  SCompactIter  aIter[TSDB_MAX_STT_TRIGGER + 1];
+  // writer
+  SDataFWriter* pWriter;
+  SArray*       aBlockIdx;  // SArray<SBlockIdx>
+  SArray*       aSttBlk;    // SArray<SSttBlk>, always empty
+  SMapData      mDataBlk;
+  SBlockData    bData;
+  SSkmInfo      skmTable;
+  // rate limit
+  int64_t sTime;
+  int64_t nWrite;
 } STsdbCompactor;
 
-int32_t tsdbCompact(STsdb *pTsdb) {
+extern int32_t tRowInfoCmprFn(const void* p1, const void* p2);
+extern int32_t tsdbReadDataBlockEx(SDataFReader* pReader, SDataBlk* pDataBlk, SBlockData* pBlockData);
+extern int32_t tsdbUpdateTableSchema(SMeta* pMeta, int64_t suid, int64_t uid, SSkmInfo* pSkmInfo);
+extern int32_t tsdbWriteDataBlock(SDataFWriter* pWriter, SBlockData* pBlockData, SMapData* mDataBlk, int8_t cmprAlg);
+
+static int32_t tCompactIterCmprFn(const SRBTreeNode* pNode1, const SRBTreeNode* pNode2) {
+  SCompactIter* pIter1 = (SCompactIter*)(((uint8_t*)pNode1) - offsetof(SCompactIter, n));
+  SCompactIter* pIter2 = (SCompactIter*)(((uint8_t*)pNode2) - offsetof(SCompactIter, n));
+
+  return tRowInfoCmprFn(&pIter1->rInfo, &pIter2->rInfo);
+}
+
+static bool tsdbShouldCompactFSet(SDFileSet* pSet) {
+  for (int32_t iStt = 0; iStt < pSet->nSttF; iStt++) {
+    if (pSet->aSttF[iStt]->size > pSet->aSttF[iStt]->offset) return true;
+  }
+  return false;
+}
+
+// a commit in between that writes no data block rewrites the .head file and appends a .stt file, the compacted output
+// is still valid for a file set that just changed that way
+static bool tsdbFSetChanged(SDFileSet* pSet, SDFileSet* pRSet) {
+  if (pSet->diskId.level != pRSet->diskId.level || pSet->diskId.id != pRSet->diskId.id) return true;
+  if (pSet->pDataF->commitID != pRSet->pDataF->commitID || pSet->pDataF->size != pRSet->pDataF->size) return true;
+  if (pSet->pSmaF->commitID != pRSet->pSmaF->commitID || pSet->pSmaF->size != pRSet->pSmaF->size) return true;
+  if (pSet->nSttF < pRSet->nSttF) return true;
+  for (int32_t iStt = 0; iStt < pRSet->nSttF; iStt++) {
+    if (pSet->aSttF[iStt]->commitID != pRSet->aSttF[iStt]->commitID) return true;
+    if (pSet->aSttF[iStt]->size != pRSet->aSttF[iStt]->size) return true;
+  }
+  return false;
+}
+
+// iterator ========================================
+static int32_t tsdbCompactIterFirstRow(STsdbCompactor* pCompactor, SCompactIter* pIter, bool* pHasRow) {
+  int32_t code = 0;
+
+  *pHasRow = false;
+  if (pIter->type == COMPACT_DATA_FILE_ITER) {
+    for (; pIter->iBlockIdx < taosArrayGetSize(pIter->aBlockIdx); pIter->iBlockIdx++) {
+      if (pIter->iBlock < 0) {
+        pIter->pBlockIdx = (SBlockIdx*)taosArrayGet(pIter->aBlockIdx, pIter->iBlockIdx);
+        code = tsdbReadDataBlk(pCompactor->pReader, pIter->pBlockIdx, &pIter->mBlock);
+        if (code) goto _exit;
+        pIter->iBlock = 0;
+      }
+
+      if (pIter->iBlock < pIter->mBlock.nItem) {
+        SDataBlk dataBlk;
+        tMapDataGetItemByIdx(&pIter->mBlock, pIter->iBlock, &dataBlk, tGetDataBlk);
+
+        code = tsdbReadDataBlockEx(pCompactor->pReader, &dataBlk, &pIter->bData);
+        if (code) goto _exit;
+
+        pIter->iRow = 0;
+        *pHasRow = (pIter->bData.nRow > 0);
+        goto _exit;
+      }
+
+      pIter->iBlock = -1;
+    }
+  } else {
+    if (pIter->iSttBlk < taosArrayGetSize(pIter->aSttBlk)) {
+      SSttBlk* pSttBlk = (SSttBlk*)taosArrayGet(pIter->aSttBlk, pIter->iSttBlk);
+
+      code = tsdbReadSttBlockEx(pCompactor->pReader, pIter->iStt, pSttBlk, &pIter->bData);
+      if (code) goto _exit;
+
+      pIter->iRow = 0;
+      *pHasRow = (pIter->bData.nRow > 0);
+    }
+  }
+
+_exit:
+  if (*pHasRow) {
+    pIter->rInfo.suid = pIter->bData.suid;
+    pIter->rInfo.uid = pIter->bData.uid ? pIter->bData.uid : pIter->bData.aUid[pIter->iRow];
+    pIter->rInfo.row = tsdbRowFromBlockData(&pIter->bData, pIter->iRow);
+  }
+  return code;
+}
+
+static int32_t tsdbCompactIterNext(STsdbCompactor* pCompactor, SCompactIter* pIter, bool* pHasRow) {
+  int32_t code = 0;
+
+  pIter->iRow++;
+  if (pIter->iRow < pIter->bData.nRow) {
+    pIter->rInfo.suid = pIter->bData.suid;
+    pIter->rInfo.uid = pIter->bData.uid ? pIter->bData.uid : pIter->bData.aUid[pIter->iRow];
+    pIter->rInfo.row = tsdbRowFromBlockData(&pIter->bData, pIter->iRow);
+    *pHasRow = true;
+    return code;
+  }
+
+  // move to next block
+  do {
+    if (pIter->type == COMPACT_DATA_FILE_ITER) {
+      pIter->iBlock++;
+      if (pIter->iBlock >= pIter->mBlock.nItem) {
+        pIter->iBlockIdx++;
+        pIter->iBlock = -1;
+      }
+    } else {
+      pIter->iSttBlk++;
+    }
+
+    code = tsdbCompactIterFirstRow(pCompactor, pIter, pHasRow);
+    if (code) break;
+  } while (!(*pHasRow) && ((pIter->type == COMPACT_DATA_FILE_ITER)
+                               ? (pIter->iBlockIdx < taosArrayGetSize(pIter->aBlockIdx))
+                               : (pIter->iSttBlk < taosArrayGetSize(pIter->aSttBlk))));
+
+  return code;
+}
+
+static int32_t tsdbCompactNextRow(STsdbCompactor* pCompactor) {
+  int32_t code = 0;
+
+  if (pCompactor->pIter) {
+    bool hasRow = false;
+
+    code = tsdbCompactIterNext(pCompactor, pCompactor->pIter, &hasRow);
+    if (code) return code;
+
+    if (hasRow) {
+      SCompactIter* pIter = (SCompactIter*)tRBTreeMin(&pCompactor->rbt);
+      if (pIter && tRowInfoCmprFn(&pCompactor->pIter->rInfo, &pIter->rInfo) > 0) {
+        tRBTreePut(&pCompactor->rbt, (SRBTreeNode*)pCompactor->pIter);
+        pCompactor->pIter = NULL;
+      }
+    } else {
+      pCompactor->pIter = NULL;
+    }
+  }
+
+  if (pCompactor->pIter == NULL) {
+    pCompactor->pIter = (SCompactIter*)tRBTreeMin(&pCompactor->rbt);
+    if (pCompactor->pIter) {
+      tRBTreeDrop(&pCompactor->rbt, (SRBTreeNode*)pCompactor->pIter);
+    }
+  }
+
+  return code;
+}
+
+static SRowInfo* tsdbCompactGetRow(STsdbCompactor* pCompactor) {
+  return pCompactor->pIter ? &pCompactor->pIter->rInfo : NULL;
+}
+
+// reader ========================================
+static int32_t tsdbCompactOpenReader(STsdbCompactor* pCompactor, SDFileSet* pSet) {
+  int32_t code = 0;
+  int32_t lino = 0;
+  STsdb*  pTsdb = pCompactor->pTsdb;
+  bool    hasRow;
+
+  // keep a value copy of the file set to detect concurrent changes later
+  pCompactor->fHead = *pSet->pHeadF;
+  pCompactor->fData = *pSet->pDataF;
+  pCompactor->fSma = *pSet->pSmaF;
+  pCompactor->rSet = (SDFileSet){.diskId = pSet->diskId,
+                                 .fid = pSet->fid,
+                                 .pHeadF = &pCompactor->fHead,
+                                 .pDataF = &pCompactor->fData,
+                                 .pSmaF = &pCompactor->fSma,
+                                 .nSttF = pSet->nSttF};
+  for (int32_t iStt = 0; iStt < pSet->nSttF; iStt++) {
+    pCompactor->fStt[iStt] = *pSet->aSttF[iStt];
+    pCompactor->rSet.aSttF[iStt] = &pCompactor->fStt[iStt];
+  }
+
+  code = tsdbDataFReaderOpen(&pCompactor->pReader, pTsdb, pSet);
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+  pCompactor->pIter = NULL;
+  tRBTreeCreate(&pCompactor->rbt, tCompactIterCmprFn);
+
+  // .data file
+  SCompactIter* pIter = &pCompactor->aIter[0];
+  pIter->type = COMPACT_DATA_FILE_ITER;
+  pIter->iBlockIdx = 0;
+  pIter->iBlock = -1;
+
+  code = tsdbReadBlockIdx(pCompactor->pReader, pIter->aBlockIdx);
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+  code = tsdbCompactIterFirstRow(pCompactor, pIter, &hasRow);
+  TSDB_CHECK_CODE(code, lino, _exit);
+  if (hasRow) {
+    tRBTreePut(&pCompactor->rbt, (SRBTreeNode*)pIter);
+  }
+
+  // .stt files
+  for (int32_t iStt = 0; iStt < pSet->nSttF; iStt++) {
+    pIter = &pCompactor->aIter[iStt + 1];
+    pIter->type = COMPACT_STT_FILE_ITER;
+    pIter->iStt = iStt;
+    pIter->iSttBlk = 0;
+
+    code = tsdbReadSttBlk(pCompactor->pReader, iStt, pIter->aSttBlk);
+    TSDB_CHECK_CODE(code, lino, _exit);
+
+    code = tsdbCompactIterFirstRow(pCompactor, pIter, &hasRow);
+    TSDB_CHECK_CODE(code, lino, _exit);
+    if (hasRow) {
+      tRBTreePut(&pCompactor->rbt, (SRBTreeNode*)pIter);
+    }
+  }
+
+  code = tsdbCompactNextRow(pCompactor);
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+_exit:
+  if (code) {
+    tsdbError("vgId:%d, %s failed at line %d since %s, fid:%d", TD_VID(pTsdb->pVnode), __func__, lino,
+              tstrerror(code), pSet->fid);
+  }
+  return code;
+}
+
+// writer ========================================
+static int32_t tsdbCompactOpenWriter(STsdbCompactor* pCompactor) {
+  int32_t code = 0;
+  int32_t lino = 0;
+  STsdb*  pTsdb = pCompactor->pTsdb;
+
+  SHeadFile fHead = {.commitID = pCompactor->commitID};
+  SDataFile fData = {.commitID = pCompactor->commitID};
+  SSmaFile  fSma = {.commitID = pCompactor->commitID};
+  SSttFile  fStt = {.commitID = pCompactor->commitID};
+  SDFileSet wSet = {.diskId = pCompactor->rSet.diskId,
+                    .fid = pCompactor->rSet.fid,
+                    .pHeadF = &fHead,
+                    .pDataF = &fData,
+                    .pSmaF = &fSma,
+                    .nSttF = 1,
+                    .aSttF = {&fStt}};
+
+  code = tsdbDataFWriterOpen(&pCompactor->pWriter, pTsdb, &wSet);
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+  taosArrayClear(pCompactor->aBlockIdx);
+  taosArrayClear(pCompactor->aSttBlk);
+
+_exit:
+  if (code) {
+    tsdbError("vgId:%d, %s failed at line %d since %s", TD_VID(pTsdb->pVnode), __func__, lino, tstrerror(code));
+  }
+  return code;
+}
+
+static void tsdbCompactRemoveOutput(STsdbCompactor* pCompactor, SDFileSet* pSet) {
+  STsdb* pTsdb = pCompactor->pTsdb;
+  char   fname[TSDB_FILENAME_LEN];
+
+  tsdbHeadFileName(pTsdb, pSet->diskId, pSet->fid, pSet->pHeadF, fname);
+  (void)taosRemoveFile(fname);
+  tsdbDataFileName(pTsdb, pSet->diskId, pSet->fid, pSet->pDataF, fname);
+  (void)taosRemoveFile(fname);
+  tsdbSmaFileName(pTsdb, pSet->diskId, pSet->fid, pSet->pSmaF, fname);
+  (void)taosRemoveFile(fname);
+  tsdbSttFileName(pTsdb, pSet->diskId, pSet->fid, pSet->aSttF[0], fname);
+  (void)taosRemoveFile(fname);
+}
+
+static void tsdbCompactThrottle(STsdbCompactor* pCompactor, int64_t nWrite) {
+  pCompactor->nWrite += nWrite;
+  if (pCompactor->maxSpeed <= 0) return;
+
+  int64_t expect = pCompactor->nWrite * 1000 / pCompactor->maxSpeed;
+  int64_t elapse = taosGetTimestampMs() - pCompactor->sTime;
+  if (expect > elapse) {
+    taosMsleep(expect - elapse);
+  }
+}
+
+static int32_t tsdbCompactWriteBlock(STsdbCompactor* pCompactor) {
+  int32_t code = 0;
+
+  if (pCompactor->bData.nRow == 0) return code;
+
+  int64_t size = pCompactor->pWriter->fData.size + pCompactor->pWriter->fSma.size;
+
+  code = tsdbWriteDataBlock(pCompactor->pWriter, &pCompactor->bData, &pCompactor->mDataBlk, pCompactor->cmprAlg);
+  if (code) return code;
+
+  tsdbCompactThrottle(pCompactor, pCompactor->pWriter->fData.size + pCompactor->pWriter->fSma.size - size);
+  return code;
+}
+
+static int32_t tsdbCompactTableData(STsdbCompactor* pCompactor, SRowInfo* pRowInfo) {
+  int32_t code = 0;
+  int32_t lino = 0;
+  STsdb*  pTsdb = pCompactor->pTsdb;
+  TABLEID id = {.suid = pRowInfo->suid, .uid = pRowInfo->uid};
+
+  code = tsdbUpdateTableSchema(pTsdb->pVnode->pMeta, id.suid, id.uid, &pCompactor->skmTable);
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+  tMapDataReset(&pCompactor->mDataBlk);
+  code = tBlockDataInit(&pCompactor->bData, &id, pCompactor->skmTable.pTSchema, NULL, 0);
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+  while (pRowInfo && pRowInfo->suid == id.suid && pRowInfo->uid == id.uid) {
+    code = tBlockDataAppendRow(&pCompactor->bData, &pRowInfo->row, NULL, pRowInfo->uid);
+    TSDB_CHECK_CODE(code, lino, _exit);
+
+    if (pCompactor->bData.nRow >= pCompactor->maxRow) {
+      code = tsdbCompactWriteBlock(pCompactor);
+      TSDB_CHECK_CODE(code, lino, _exit);
+
+      if (atomic_load_8(&pTsdb->compact.stop)) {
+        code = TSDB_CODE_VND_STOPPED;
+        TSDB_CHECK_CODE(code, lino, _exit);
+      }
+    }
+
+    code = tsdbCompactNextRow(pCompactor);
+    TSDB_CHECK_CODE(code, lino, _exit);
+
+    pRowInfo = tsdbCompactGetRow(pCompactor);
+  }
+
+  code = tsdbCompactWriteBlock(pCompactor);
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+  SBlockIdx blockIdx = {.suid = id.suid, .uid = id.uid};
+  code = tsdbWriteDataBlk(pCompactor->pWriter, &pCompactor->mDataBlk, &blockIdx);
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+  if (taosArrayPush(pCompactor->aBlockIdx, &blockIdx) == NULL) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    TSDB_CHECK_CODE(code, lino, _exit);
+  }
+
+_exit:
+  if (code && code != TSDB_CODE_VND_STOPPED) {
+    tsdbError("vgId:%d, %s failed at line %d since %s, suid:%" PRId64 " uid:%" PRId64, TD_VID(pTsdb->pVnode),
+              __func__, lino, tstrerror(code), id.suid, id.uid);
+  }
+  return code;
+}
+
+// replace the compacted file set in the file system if nothing changed meanwhile
+static int32_t tsdbCompactApplyFSet(STsdbCompactor* pCompactor, SDFileSet* pWSet, bool* pApplied) {
+  int32_t code = 0;
+  int32_t lino = 0;
+  STsdb*  pTsdb = pCompactor->pTsdb;
+  STsdbFS fs = {0};
+
+  *pApplied = false;
+
+  // no commit can change the file system while we are holding this
+  tsem_wait(&pTsdb->pVnode->canCommit);
+
+  taosThreadRwlockRdlock(&pTsdb->rwLock);
+  code = tsdbFSCopy(pTsdb, &fs);
+  taosThreadRwlockUnlock(&pTsdb->rwLock);
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+  SDFileSet* pSet = (SDFileSet*)taosArraySearch(fs.aDFileSet, &pCompactor->rSet, tDFileSetCmprFn, TD_EQ);
+  if (pSet == NULL || tsdbFSetChanged(pSet, &pCompactor->rSet)) {
+    tsdbInfo("vgId:%d, file set changed during compaction, discard output, fid:%d", TD_VID(pTsdb->pVnode),
+             pCompactor->rSet.fid);
+    goto _exit;
+  }
+
+  if (pSet->diskId.level != pWSet->diskId.level || pSet->diskId.id != pWSet->diskId.id) {
+    tsdbInfo("vgId:%d, file set moved during compaction, discard output, fid:%d", TD_VID(pTsdb->pVnode),
+             pCompactor->rSet.fid);
+    goto _exit;
+  }
+
+  // replace the merged files and keep the .stt files committed on top of them
+  int32_t nSttF = pCompactor->rSet.nSttF;
+  *pSet->pHeadF = *pWSet->pHeadF;
+  *pSet->pDataF = *pWSet->pDataF;
+  *pSet->pSmaF = *pWSet->pSmaF;
+  *pSet->aSttF[0] = *pWSet->aSttF[0];
+  for (int32_t iStt = 1; iStt < nSttF; iStt++) {
+    taosMemoryFree(pSet->aSttF[iStt]);
+  }
+  for (int32_t iStt = nSttF; iStt < pSet->nSttF; iStt++) {
+    pSet->aSttF[iStt - nSttF + 1] = pSet->aSttF[iStt];
+  }
+  for (int32_t iStt = pSet->nSttF - nSttF + 1; iStt < pSet->nSttF; iStt++) {
+    pSet->aSttF[iStt] = NULL;
+  }
+  pSet->nSttF = pSet->nSttF - nSttF + 1;
+
+  code = tsdbFSPrepareCommit(pTsdb, &fs);
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+  taosThreadRwlockWrlock(&pTsdb->rwLock);
+  code = tsdbFSCommit(pTsdb);
+  taosThreadRwlockUnlock(&pTsdb->rwLock);
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+  *pApplied = true;
+
+_exit:
+  tsem_post(&pTsdb->pVnode->canCommit);
+  tsdbFSDestroy(&fs);
+  if (code) {
+    tsdbError("vgId:%d, %s failed at line %d since %s", TD_VID(pTsdb->pVnode), __func__, lino, tstrerror(code));
+  }
+  return code;
+}
+
+static int32_t tsdbCompactFSet(STsdbCompactor* pCompactor, SDFileSet* pSet) {
+  int32_t code = 0;
+  int32_t lino = 0;
+  STsdb*  pTsdb = pCompactor->pTsdb;
+  bool    written = false;
+  bool    applied = false;
+
+  SHeadFile fHead;
+  SDataFile fData;
+  SSmaFile  fSma;
+  SSttFile  fStt;
+  SDFileSet wSet = {.pHeadF = &fHead, .pDataF = &fData, .pSmaF = &fSma, .nSttF = 1, .aSttF = {&fStt}};
+
+  code = tsdbCompactOpenReader(pCompactor, pSet);
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+  code = tsdbCompactOpenWriter(pCompactor);
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+  // merge all rows of the file set into the new .data file, table by table
+  for (SRowInfo* pRowInfo = tsdbCompactGetRow(pCompactor); pRowInfo; pRowInfo = tsdbCompactGetRow(pCompactor)) {
+    code = tsdbCompactTableData(pCompactor, pRowInfo);
+    TSDB_CHECK_CODE(code, lino, _exit);
+  }
+
+  code = tsdbWriteBlockIdx(pCompactor->pWriter, pCompactor->aBlockIdx);
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+  code = tsdbWriteSttBlk(pCompactor->pWriter, pCompactor->aSttBlk);
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+  code = tsdbUpdateDFileSetHeader(pCompactor->pWriter);
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+  wSet.diskId = pCompactor->pWriter->wSet.diskId;
+  wSet.fid = pCompactor->pWriter->wSet.fid;
+  fHead = pCompactor->pWriter->fHead;
+  fData = pCompactor->pWriter->fData;
+  fSma = pCompactor->pWriter->fSma;
+  fStt = pCompactor->pWriter->fStt[0];
+
+  code = tsdbDataFWriterClose(&pCompactor->pWriter, 1);
+  TSDB_CHECK_CODE(code, lino, _exit);
+  written = true;
+
+  code = tsdbDataFReaderClose(&pCompactor->pReader);
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+  code = tsdbCompactApplyFSet(pCompactor, &wSet, &applied);
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+  if (!applied) {
+    tsdbCompactRemoveOutput(pCompactor, &wSet);
+  }
+
+_exit:
+  if (code) {
+    if (pCompactor->pWriter) {
+      wSet.diskId = pCompactor->pWriter->wSet.diskId;
+      wSet.fid = pCompactor->pWriter->wSet.fid;
+      fHead = pCompactor->pWriter->fHead;
+      fData = pCompactor->pWriter->fData;
+      fSma = pCompactor->pWriter->fSma;
+      fStt = pCompactor->pWriter->fStt[0];
+      tsdbDataFWriterClose(&pCompactor->pWriter, 0);
+      tsdbCompactRemoveOutput(pCompactor, &wSet);
+    } else if (written && !applied) {
+      tsdbCompactRemoveOutput(pCompactor, &wSet);
+    }
+    tsdbDataFReaderClose(&pCompactor->pReader);
+    if (code != TSDB_CODE_VND_STOPPED) {
+      tsdbError("vgId:%d, %s failed at line %d since %s, fid:%d", TD_VID(pTsdb->pVnode), __func__, lino,
+                tstrerror(code), pSet->fid);
+    }
+  } else {
+    tsdbInfo("vgId:%d, %s done, fid:%d nStt:%d applied:%d", TD_VID(pTsdb->pVnode), __func__, pSet->fid, pSet->nSttF,
+             applied);
+  }
+  return code;
+}
+
+static int32_t tsdbCompactorInit(STsdbCompactor* pCompactor, STsdb* pTsdb, int64_t commitID) {
   int32_t code = 0;
-  // TODO
+
+  memset(pCompactor, 0, sizeof(*pCompactor));
+  pCompactor->pTsdb = pTsdb;
+  pCompactor->commitID = commitID;
+  pCompactor->maxRow = pTsdb->pVnode->config.tsdbCfg.maxRows;
+  pCompactor->cmprAlg = pTsdb->pVnode->config.tsdbCfg.compression;
+  pCompactor->maxSpeed = tsVndCompactMaxSpeed;
+  pCompactor->sTime = taosGetTimestampMs();
+
+  pCompactor->aIter[0].aBlockIdx = taosArrayInit(0, sizeof(SBlockIdx));
+  if (pCompactor->aIter[0].aBlockIdx == NULL) return TSDB_CODE_OUT_OF_MEMORY;
+  for (int32_t iIter = 0; iIter < TSDB_MAX_STT_TRIGGER + 1; iIter++) {
+    if (iIter) {
+      pCompactor->aIter[iIter].aSttBlk = taosArrayInit(0, sizeof(SSttBlk));
+      if (pCompactor->aIter[iIter].aSttBlk == NULL) return TSDB_CODE_OUT_OF_MEMORY;
+    }
+    code = tBlockDataCreate(&pCompactor->aIter[iIter].bData);
+    if (code) return code;
+  }
+
+  code = tBlockDataCreate(&pCompactor->bData);
+  if (code) return code;
+
+  pCompactor->aBlockIdx = taosArrayInit(0, sizeof(SBlockIdx));
+  if (pCompactor->aBlockIdx == NULL) return TSDB_CODE_OUT_OF_MEMORY;
+
+  pCompactor->aSttBlk = taosArrayInit(0, sizeof(SSttBlk));
+  if (pCompactor->aSttBlk == NULL) return TSDB_CODE_OUT_OF_MEMORY;
+
+  taosThreadRwlockRdlock(&pTsdb->rwLock);
+  code = tsdbFSRef(pTsdb, &pCompactor->fs);
+  taosThreadRwlockUnlock(&pTsdb->rwLock);
+
   return code;
 }
+
+static void tsdbCompactorClear(STsdbCompactor* pCompactor) {
+  tBlockDataDestroy(&pCompactor->bData, 1);
+  tMapDataClear(&pCompactor->mDataBlk);
+  taosArrayDestroy(pCompactor->aSttBlk);
+  taosArrayDestroy(pCompactor->aBlockIdx);
+  tDestroyTSchema(pCompactor->skmTable.pTSchema);
+
+  taosArrayDestroy(pCompactor->aIter[0].aBlockIdx);
+  tMapDataClear(&pCompactor->aIter[0].mBlock);
+  for (int32_t iIter = 0; iIter < TSDB_MAX_STT_TRIGGER + 1; iIter++) {
+    if (iIter) taosArrayDestroy(pCompactor->aIter[iIter].aSttBlk);
+    tBlockDataDestroy(&pCompactor->aIter[iIter].bData, 1);
+  }
+
+  if (pCompactor->fs.aDFileSet) {
+    tsdbFSUnref(pCompactor->pTsdb, &pCompactor->fs);
+  }
+}
+
+// Merge the .data and all .stt files of each file set into a fresh .data file, leaving a single empty .stt file.
+// commitID must be reserved by the caller so that new files never clash with the ones of a commit.
+static int32_t tsdbCompact(STsdb* pTsdb, int64_t commitID) {
+  int32_t        code = 0;
+  int32_t        lino = 0;
+  STsdbCompactor compactor;
+
+  code = tsdbCompactorInit(&compactor, pTsdb, commitID);
+  TSDB_CHECK_CODE(code, lino, _exit);
+
+  int32_t nFSet = 0;
+  for (int32_t iSet = 0; iSet < taosArrayGetSize(compactor.fs.aDFileSet); iSet++) {
+    if (tsdbShouldCompactFSet((SDFileSet*)taosArrayGet(compactor.fs.aDFileSet, iSet))) nFSet++;
+  }
+  atomic_store_32(&pTsdb->compact.nFSet, nFSet);
+
+  tsdbInfo("vgId:%d, start to compact, commit ID:%" PRId64 " nFSet:%d", TD_VID(pTsdb->pVnode), commitID, nFSet);
+
+  for (int32_t iSet = 0; iSet < taosArrayGetSize(compactor.fs.aDFileSet); iSet++) {
+    SDFileSet* pSet = (SDFileSet*)taosArrayGet(compactor.fs.aDFileSet, iSet);
+
+    if (!tsdbShouldCompactFSet(pSet)) continue;
+
+    if (atomic_load_8(&pTsdb->compact.stop)) {
+      code = TSDB_CODE_VND_STOPPED;
+      TSDB_CHECK_CODE(code, lino, _exit);
+    }
+
+    code = tsdbCompactFSet(&compactor, pSet);
+    TSDB_CHECK_CODE(code, lino, _exit);
+
+    atomic_add_fetch_32(&pTsdb->compact.nFSetDone, 1);
+  }
+
+_exit:
+  tsdbCompactorClear(&compactor);
+  if (code) {
+    tsdbError("vgId:%d, %s failed at line %d since %s", TD_VID(pTsdb->pVnode), __func__, lino, tstrerror(code));
+  } else {
+    tsdbInfo("vgId:%d, %s done, written:%" PRId64 " bytes, elapsed:%" PRId64 "ms", TD_VID(pTsdb->pVnode), __func__,
+             compactor.nWrite, taosGetTimestampMs() - compactor.sTime);
+  }
+  return code;
+}
+
+// compaction runs on its own thread: it has to wait for canCommit before swapping files, which must not be done
+// from the vnode commit threads
+static void* tsdbCompactThreadFp(void* arg) {
+  STsdb* pTsdb = (STsdb*)arg;
+
+  setThreadName("tsdb-compact");
+  tsdbCompact(pTsdb, pTsdb->compact.commitID);
+  atomic_store_8(&pTsdb->compact.running, 0);
+
+  return NULL;
+}
+
+int32_t tsdbAsyncCompact(STsdb* pTsdb, int64_t commitID) {
+  if (atomic_val_compare_exchange_8(&pTsdb->compact.running, 0, 1) != 0) {
+    return TSDB_CODE_ACTION_IN_PROGRESS;
+  }
+
+  // the previous compaction is finished, reap its thread
+  if (pTsdb->compact.threadValid) {
+    taosThreadJoin(pTsdb->compact.thread, NULL);
+    pTsdb->compact.threadValid = 0;
+  }
+
+  pTsdb->compact.commitID = commitID;
+  atomic_store_8(&pTsdb->compact.stop, 0);
+  atomic_store_32(&pTsdb->compact.nFSet, 0);
+  atomic_store_32(&pTsdb->compact.nFSetDone, 0);
+
+  TdThreadAttr thAttr;
+  taosThreadAttrInit(&thAttr);
+  taosThreadAttrSetDetachState(&thAttr, PTHREAD_CREATE_JOINABLE);
+  if (taosThreadCreate(&pTsdb->compact.thread, &thAttr, tsdbCompactThreadFp, pTsdb) != 0) {
+    taosThreadAttrDestroy(&thAttr);
+    atomic_store_8(&pTsdb->compact.running, 0);
+    return TAOS_SYSTEM_ERROR(errno);
+  }
+  taosThreadAttrDestroy(&thAttr);
+  pTsdb->compact.threadValid = 1;
+
+  return 0;
+}
+
+void tsdbStopCompact(STsdb* pTsdb) {
+  if (pTsdb == NULL || !pTsdb->compact.threadValid) return;
+
+  atomic_store_8(&pTsdb->compact.stop, 1);
+  taosThreadJoin(pTsdb->compact.thread, NULL);
+  pTsdb->compact.threadValid = 0;
+}
+
+int32_t tsdbGetCompactProgress(STsdb* pTsdb) {
+  if (!atomic_load_8(&pTsdb->compact.running)) return 100;
+
+  int32_t nFSet = atomic_load_32(&pTsdb->compact.nFSet);
+  if (nFSet == 0) return 0;
+  return atomic_load_32(&pTsdb->compact.nFSetDone) * 100 / nFSet;
+}
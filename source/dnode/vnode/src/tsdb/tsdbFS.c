@@ -509,89 +509,55 @@ static int32_t tsdbMergeFileSet(STsdb *pTsdb, SDFileSet *pSetOld, SDFileSet *pSe
     pSmaF->nRef = nRef;
   }
 
-  // stt
-  if (sameDisk) {
-    if (pSetNew->nSttF > pSetOld->nSttF) {
-      ASSERT(pSetNew->nSttF == pSetOld->nSttF + 1);
-      pSetOld->aSttF[pSetOld->nSttF] = (SSttFile *)taosMemoryMalloc(sizeof(SSttFile));
-      if (pSetOld->aSttF[pSetOld->nSttF] == NULL) {
-        code = TSDB_CODE_OUT_OF_MEMORY;
-        TSDB_CHECK_CODE(code, lino, _exit);
-      }
-      *pSetOld->aSttF[pSetOld->nSttF] = *pSetNew->aSttF[pSetOld->nSttF];
-      pSetOld->aSttF[pSetOld->nSttF]->nRef = 1;
-      pSetOld->nSttF++;
-    } else if (pSetNew->nSttF < pSetOld->nSttF) {
-      ASSERT(pSetNew->nSttF == 1);
-      for (int32_t iStt = 0; iStt < pSetOld->nSttF; iStt++) {
-        SSttFile *pSttFile = pSetOld->aSttF[iStt];
-        nRef = atomic_sub_fetch_32(&pSttFile->nRef, 1);
-        if (nRef == 0) {
-          tsdbSttFileName(pTsdb, pSetOld->diskId, pSetOld->fid, pSttFile, fname);
-          (void)taosRemoveFile(fname);
-          taosMemoryFree(pSttFile);
-        }
-        pSetOld->aSttF[iStt] = NULL;
-      }
-
-      pSetOld->nSttF = 1;
-      pSetOld->aSttF[0] = (SSttFile *)taosMemoryMalloc(sizeof(SSttFile));
-      if (pSetOld->aSttF[0] == NULL) {
-        code = TSDB_CODE_OUT_OF_MEMORY;
-        TSDB_CHECK_CODE(code, lino, _exit);
-      }
-      *pSetOld->aSttF[0] = *pSetNew->aSttF[0];
-      pSetOld->aSttF[0]->nRef = 1;
-    } else {
-      for (int32_t iStt = 0; iStt < pSetOld->nSttF; iStt++) {
-        if (pSetOld->aSttF[iStt]->commitID != pSetNew->aSttF[iStt]->commitID) {
-          SSttFile *pSttFile = pSetOld->aSttF[iStt];
-          nRef = atomic_sub_fetch_32(&pSttFile->nRef, 1);
-          if (nRef == 0) {
-            tsdbSttFileName(pTsdb, pSetOld->diskId, pSetOld->fid, pSttFile, fname);
-            (void)taosRemoveFile(fname);
-            taosMemoryFree(pSttFile);
-          }
-
-          pSetOld->aSttF[iStt] = (SSttFile *)taosMemoryMalloc(sizeof(SSttFile));
-          if (pSetOld->aSttF[iStt] == NULL) {
-            code = TSDB_CODE_OUT_OF_MEMORY;
-            TSDB_CHECK_CODE(code, lino, _exit);
-          }
-          *pSetOld->aSttF[iStt] = *pSetNew->aSttF[iStt];
-          pSetOld->aSttF[iStt]->nRef = 1;
-        } else {
-          ASSERT(pSetOld->aSttF[iStt]->size == pSetOld->aSttF[iStt]->size);
-          ASSERT(pSetOld->aSttF[iStt]->offset == pSetOld->aSttF[iStt]->offset);
-        }
-      }
-    }
-  } else {
-    for (int32_t iStt = 0; iStt < pSetOld->nSttF; iStt++) {
-      SSttFile *pSttFile = pSetOld->aSttF[iStt];
-      nRef = atomic_sub_fetch_32(&pSttFile->nRef, 1);
-      if (nRef == 0) {
-        tsdbSttFileName(pTsdb, pSetOld->diskId, pSetOld->fid, pSttFile, fname);
-        (void)taosRemoveFile(fname);
-        taosMemoryFree(pSttFile);
+  // stt, matched by commit ID: a commit appends one file or merges all into one, while a compaction replaces the
+  // files it merged and keeps the ones committed meanwhile
+  SSttFile *aSttF[TSDB_MAX_STT_TRIGGER] = {0};
+  bool      reused[TSDB_MAX_STT_TRIGGER] = {0};
+  for (int32_t iStt = 0; iStt < pSetNew->nSttF; iStt++) {
+    for (int32_t jStt = 0; sameDisk && jStt < pSetOld->nSttF; jStt++) {
+      if (!reused[jStt] && pSetOld->aSttF[jStt]->commitID == pSetNew->aSttF[iStt]->commitID) {
+        aSttF[iStt] = pSetOld->aSttF[jStt];
+        reused[jStt] = true;
+        break;
       }
     }
 
-    pSetOld->nSttF = 0;
-    for (int32_t iStt = 0; iStt < pSetNew->nSttF; iStt++) {
-      pSetOld->aSttF[iStt] = (SSttFile *)taosMemoryMalloc(sizeof(SSttFile));
-      if (pSetOld->aSttF[iStt] == NULL) {
+    if (aSttF[iStt] == NULL) {
+      aSttF[iStt] = (SSttFile *)taosMemoryMalloc(sizeof(SSttFile));
+      if (aSttF[iStt] == NULL) {
+        for (int32_t jStt = 0; jStt < iStt; jStt++) {
+          if (aSttF[jStt]->nRef == 0) taosMemoryFree(aSttF[jStt]);
+        }
         code = TSDB_CODE_OUT_OF_MEMORY;
         TSDB_CHECK_CODE(code, lino, _exit);
       }
+      aSttF[iStt]->nRef = 0;
+    }
+  }
 
-      *pSetOld->aSttF[iStt] = *pSetNew->aSttF[iStt];
-      pSetOld->aSttF[iStt]->nRef = 1;
+  for (int32_t jStt = 0; jStt < pSetOld->nSttF; jStt++) {
+    if (reused[jStt]) continue;
 
-      pSetOld->nSttF++;
+    SSttFile *pSttFile = pSetOld->aSttF[jStt];
+    nRef = atomic_sub_fetch_32(&pSttFile->nRef, 1);
+    if (nRef == 0) {
+      tsdbSttFileName(pTsdb, pSetOld->diskId, pSetOld->fid, pSttFile, fname);
+      (void)taosRemoveFile(fname);
+      taosMemoryFree(pSttFile);
     }
   }
 
+  for (int32_t iStt = 0; iStt < pSetNew->nSttF; iStt++) {
+    nRef = aSttF[iStt]->nRef;
+    *aSttF[iStt] = *pSetNew->aSttF[iStt];
+    aSttF[iStt]->nRef = nRef ? nRef : 1;
+    pSetOld->aSttF[iStt] = aSttF[iStt];
+  }
+  for (int32_t iStt = pSetNew->nSttF; iStt < pSetOld->nSttF; iStt++) {
+    pSetOld->aSttF[iStt] = NULL;
+  }
+  pSetOld->nSttF = pSetNew->nSttF;
+
   if (!sameDisk) {
     pSetOld->diskId = pSetNew->diskId;
   }
@@ -30,10 +30,53 @@
 #define SL_MOVE_BACKWARD 0x1
 #define SL_MOVE_FROM_POS 0x2
 
+// open addressing with linear probing, kept at most half full. a slot is set once and never cleared, so the lookups
+// run without any lock, while the creation of table data is serialized by the memtable latch.
+struct STbDataHash {
+  STbDataHash *pRetired;
+  int32_t      nBucket;
+  STbData     *aBucket[];
+};
+
 static void    tbDataMovePosTo(STbData *pTbData, SMemSkipListNode **pos, TSDBKEY *pKey, int32_t flags);
 static int32_t tsdbGetOrCreateTbData(SMemTable *pMemTable, tb_uid_t suid, tb_uid_t uid, STbData **ppTbData);
 static int32_t tsdbInsertTableDataImpl(SMemTable *pMemTable, STbData *pTbData, int64_t version,
                                        SSubmitMsgIter *pMsgIter, SSubmitBlk *pBlock, SSubmitBlkRsp *pRsp);
+static int32_t tsdbInsertColBlkImpl(SMemTable *pMemTable, STbData *pTbData, int64_t version, SSDataBlock *pBlock,
+                                    STSchema *pTSchema, SSubmitBlkRsp *pRsp);
+
+static STbDataHash *tbDataHashCreate(int32_t nBucket) {
+  STbDataHash *pHash = (STbDataHash *)taosMemoryCalloc(1, sizeof(STbDataHash) + sizeof(STbData *) * nBucket);
+  if (pHash) {
+    pHash->nBucket = nBucket;
+  }
+  return pHash;
+}
+
+static void tbDataHashPut(STbDataHash *pHash, STbData *pTbData) {
+  int32_t idx = TABS(pTbData->uid) % pHash->nBucket;
+  while (pHash->aBucket[idx]) {
+    idx = (idx + 1) % pHash->nBucket;
+  }
+  atomic_store_ptr(&pHash->aBucket[idx], pTbData);
+}
+
+// the memtable is shared by several writers and readers, the keys and counters are updated atomically
+static FORCE_INLINE void tsdbMemTableUpdateKey(SMemTable *pMemTable, TSKEY minKey, TSKEY maxKey) {
+  TSKEY key = atomic_load_64(&pMemTable->minKey);
+  while (minKey < key) {
+    TSKEY old = atomic_val_compare_exchange_64(&pMemTable->minKey, key, minKey);
+    if (old == key) break;
+    key = old;
+  }
+
+  key = atomic_load_64(&pMemTable->maxKey);
+  while (maxKey > key) {
+    TSKEY old = atomic_val_compare_exchange_64(&pMemTable->maxKey, key, maxKey);
+    if (old == key) break;
+    key = old;
+  }
+}
 
 int32_t tsdbMemTableCreate(STsdb *pTsdb, SMemTable **ppMemTable) {
   int32_t    code = 0;
@@ -53,9 +96,9 @@ int32_t tsdbMemTableCreate(STsdb *pTsdb, SMemTable **ppMemTable) {
   pMemTable->nRow = 0;
   pMemTable->nDel = 0;
   pMemTable->nTbData = 0;
-  pMemTable->nBucket = MEM_MIN_HASH;
-  pMemTable->aBucket = (STbData **)taosMemoryCalloc(pMemTable->nBucket, sizeof(STbData *));
-  if (pMemTable->aBucket == NULL) {
+  pMemTable->pRetired = NULL;
+  pMemTable->pHash = tbDataHashCreate(MEM_MIN_HASH);
+  if (pMemTable->pHash == NULL) {
     code = TSDB_CODE_OUT_OF_MEMORY;
     taosMemoryFree(pMemTable);
     goto _err;
@@ -73,37 +116,35 @@ _err:
 void tsdbMemTableDestroy(SMemTable *pMemTable) {
   if (pMemTable) {
     vnodeBufPoolUnRef(pMemTable->pPool);
-    taosMemoryFree(pMemTable->aBucket);
+    while (pMemTable->pRetired) {
+      STbDataHash *pHash = pMemTable->pRetired;
+      pMemTable->pRetired = pHash->pRetired;
+      taosMemoryFree(pHash);
+    }
+    taosMemoryFree(pMemTable->pHash);
     taosMemoryFree(pMemTable);
   }
 }
 
 static FORCE_INLINE STbData *tsdbGetTbDataFromMemTableImpl(SMemTable *pMemTable, tb_uid_t suid, tb_uid_t uid) {
-  STbData *pTbData = pMemTable->aBucket[TABS(uid) % pMemTable->nBucket];
+  STbDataHash *pHash = (STbDataHash *)atomic_load_ptr(&pMemTable->pHash);
+  int32_t      idx = TABS(uid) % pHash->nBucket;
 
-  while (pTbData) {
-    if (pTbData->uid == uid) break;
-    pTbData = pTbData->next;
+  for (;;) {
+    STbData *pTbData = (STbData *)atomic_load_ptr(&pHash->aBucket[idx]);
+    if (pTbData == NULL || pTbData->uid == uid) return pTbData;
+    idx = (idx + 1) % pHash->nBucket;
   }
-
-  return pTbData;
 }
 
 STbData *tsdbGetTbDataFromMemTable(SMemTable *pMemTable, tb_uid_t suid, tb_uid_t uid) {
-  STbData *pTbData;
-
-  taosRLockLatch(&pMemTable->latch);
-  pTbData = tsdbGetTbDataFromMemTableImpl(pMemTable, suid, uid);
-  taosRUnLockLatch(&pMemTable->latch);
-
-  return pTbData;
+  return tsdbGetTbDataFromMemTableImpl(pMemTable, suid, uid);
 }
 
 int32_t tsdbInsertTableData(STsdb *pTsdb, int64_t version, SSubmitMsgIter *pMsgIter, SSubmitBlk *pBlock,
                             SSubmitBlkRsp *pRsp) {
   int32_t    code = 0;
   SMemTable *pMemTable = pTsdb->mem;
-  STbData   *pTbData = NULL;
   tb_uid_t   suid = pMsgIter->suid;
   tb_uid_t   uid = pMsgIter->uid;
 
@@ -129,14 +170,7 @@ int32_t tsdbInsertTableData(STsdb *pTsdb, int64_t version, SSubmitMsgIter *pMsgI
 
   pRsp->sver = info.skmVer;
 
-  // create/get STbData to op
-  code = tsdbGetOrCreateTbData(pMemTable, suid, uid, &pTbData);
-  if (code) {
-    goto _err;
-  }
-
-  // do insert impl
-  code = tsdbInsertTableDataImpl(pMemTable, pTbData, version, pMsgIter, pBlock, pRsp);
+  code = tsdbMemTablePut(pMemTable, version, pMsgIter, pBlock, pRsp);
   if (code) {
     goto _err;
   }
@@ -148,6 +182,50 @@ _err:
   return code;
 }
 
+// writers of different tables run in parallel, the ones of the same table are serialized by the table lock
+int32_t tsdbMemTablePut(SMemTable *pMemTable, int64_t version, SSubmitMsgIter *pMsgIter, SSubmitBlk *pBlock,
+                        SSubmitBlkRsp *pRsp) {
+  int32_t         code = 0;
+  STbData        *pTbData = NULL;
+  SSubmitColHead *pColHead = tGetSubmitColHead(pMsgIter, pBlock);
+  STSchema       *pTSchema = NULL;
+  SSDataBlock     colBlock = {0};
+
+  // the columns of a columnar block are checked and decoded out of the table lock
+  if (pColHead) {
+    pTSchema = metaGetTbTSchema(pMemTable->pTsdb->pVnode->pMeta, pMsgIter->uid, pMsgIter->sversion, 1);
+    if (pTSchema == NULL) {
+      code = TSDB_CODE_TDB_INVALID_TABLE_SCHEMA_VER;
+      goto _exit;
+    }
+
+    code = tDecodeSubmitColBlk(pColHead, pMsgIter->dataLen, pTSchema, &colBlock);
+    if (code) {
+      goto _exit;
+    }
+  }
+
+  // create/get STbData to op
+  code = tsdbGetOrCreateTbData(pMemTable, pMsgIter->suid, pMsgIter->uid, &pTbData);
+  if (code) {
+    goto _exit;
+  }
+
+  // do insert impl
+  taosWLockLatch(&pTbData->lock);
+  if (pColHead) {
+    code = tsdbInsertColBlkImpl(pMemTable, pTbData, version, &colBlock, pTSchema, pRsp);
+  } else {
+    code = tsdbInsertTableDataImpl(pMemTable, pTbData, version, pMsgIter, pBlock, pRsp);
+  }
+  taosWUnLockLatch(&pTbData->lock);
+
+_exit:
+  blockDataFreeRes(&colBlock);
+  taosMemoryFree(pTSchema);
+  return code;
+}
+
 int32_t tsdbDeleteTableData(STsdb *pTsdb, int64_t version, tb_uid_t suid, tb_uid_t uid, TSKEY sKey, TSKEY eKey) {
   int32_t    code = 0;
   SMemTable *pMemTable = pTsdb->mem;
@@ -183,15 +261,18 @@ int32_t tsdbDeleteTableData(STsdb *pTsdb, int64_t version, tb_uid_t suid, tb_uid
   pDelData->sKey = sKey;
   pDelData->eKey = eKey;
   pDelData->pNext = NULL;
+  taosWLockLatch(&pTbData->lock);
   if (pTbData->pHead == NULL) {
     ASSERT(pTbData->pTail == NULL);
-    pTbData->pHead = pTbData->pTail = pDelData;
+    pTbData->pTail = pDelData;
+    atomic_store_ptr(&pTbData->pHead, pDelData);
   } else {
-    pTbData->pTail->pNext = pDelData;
+    atomic_store_ptr(&pTbData->pTail->pNext, pDelData);
     pTbData->pTail = pDelData;
   }
+  taosWUnLockLatch(&pTbData->lock);
 
-  pMemTable->nDel++;
+  atomic_add_fetch_64(&pMemTable->nDel, 1);
 
   if (TSDB_CACHE_LAST_ROW(pMemTable->pTsdb->pVnode->config) && tsdbKeyCmprFn(&lastKey, &pTbData->maxKey) >= 0) {
     tsdbCacheDeleteLastrow(pTsdb->lruCache, pTbData->uid, eKey);
@@ -295,33 +376,26 @@ bool tsdbTbDataIterNext(STbDataIter *pIter) {
   return true;
 }
 
+// the memtable latch is held
 static int32_t tsdbMemTableRehash(SMemTable *pMemTable) {
   int32_t code = 0;
 
-  int32_t   nBucket = pMemTable->nBucket * 2;
-  STbData **aBucket = (STbData **)taosMemoryCalloc(nBucket, sizeof(STbData *));
-  if (aBucket == NULL) {
+  STbDataHash *pOld = pMemTable->pHash;
+  STbDataHash *pNew = tbDataHashCreate(pOld->nBucket * 2);
+  if (pNew == NULL) {
     code = TSDB_CODE_OUT_OF_MEMORY;
     goto _exit;
   }
 
-  for (int32_t iBucket = 0; iBucket < pMemTable->nBucket; iBucket++) {
-    STbData *pTbData = pMemTable->aBucket[iBucket];
-
-    while (pTbData) {
-      STbData *pNext = pTbData->next;
-
-      int32_t idx = TABS(pTbData->uid) % nBucket;
-      pTbData->next = aBucket[idx];
-      aBucket[idx] = pTbData;
-
-      pTbData = pNext;
+  for (int32_t iBucket = 0; iBucket < pOld->nBucket; iBucket++) {
+    if (pOld->aBucket[iBucket]) {
+      tbDataHashPut(pNew, pOld->aBucket[iBucket]);
     }
   }
 
-  taosMemoryFree(pMemTable->aBucket);
-  pMemTable->nBucket = nBucket;
-  pMemTable->aBucket = aBucket;
+  atomic_store_ptr(&pMemTable->pHash, pNew);
+  pOld->pRetired = pMemTable->pRetired;
+  pMemTable->pRetired = pOld;
 
 _exit:
   return code;
@@ -334,6 +408,15 @@ static int32_t tsdbGetOrCreateTbData(SMemTable *pMemTable, tb_uid_t suid, tb_uid
   STbData *pTbData = tsdbGetTbDataFromMemTableImpl(pMemTable, suid, uid);
   if (pTbData) goto _exit;
 
+  taosWLockLatch(&pMemTable->latch);
+
+  // created by another writer
+  pTbData = tsdbGetTbDataFromMemTableImpl(pMemTable, suid, uid);
+  if (pTbData) {
+    taosWUnLockLatch(&pMemTable->latch);
+    goto _exit;
+  }
+
   // create
   SVBufPool *pPool = pMemTable->pTsdb->pVnode->inUse;
   int8_t     maxLevel = pMemTable->pTsdb->pVnode->config.tsdbCfg.slLevel;
@@ -342,8 +425,10 @@ static int32_t tsdbGetOrCreateTbData(SMemTable *pMemTable, tb_uid_t suid, tb_uid
   pTbData = vnodeBufPoolMallocAligned(pPool, sizeof(*pTbData) + SL_NODE_SIZE(maxLevel) * 2);
   if (pTbData == NULL) {
     code = TSDB_CODE_OUT_OF_MEMORY;
+    taosWUnLockLatch(&pMemTable->latch);
     goto _err;
   }
+  taosInitRWLatch(&pTbData->lock);
   pTbData->suid = suid;
   pTbData->uid = uid;
   pTbData->minKey = TSKEY_MAX;
@@ -366,9 +451,7 @@ static int32_t tsdbGetOrCreateTbData(SMemTable *pMemTable, tb_uid_t suid, tb_uid
     SL_NODE_FORWARD(pTbData->sl.pTail, iLevel) = NULL;
   }
 
-  taosWLockLatch(&pMemTable->latch);
-
-  if (pMemTable->nTbData >= pMemTable->nBucket) {
+  if ((pMemTable->nTbData + 1) * 2 > pMemTable->pHash->nBucket) {
     code = tsdbMemTableRehash(pMemTable);
     if (code) {
       taosWUnLockLatch(&pMemTable->latch);
@@ -376,9 +459,7 @@ static int32_t tsdbGetOrCreateTbData(SMemTable *pMemTable, tb_uid_t suid, tb_uid
     }
   }
 
-  int32_t idx = TABS(uid) % pMemTable->nBucket;
-  pTbData->next = pMemTable->aBucket[idx];
-  pMemTable->aBucket[idx] = pTbData;
+  tbDataHashPut(pMemTable->pHash, pTbData);
   pMemTable->nTbData++;
 
   taosWUnLockLatch(&pMemTable->latch);
@@ -398,20 +479,21 @@ static void tbDataMovePosTo(STbData *pTbData, SMemSkipListNode **pos, TSDBKEY *p
   TSDBKEY           tKey = {0};
   int32_t           backward = flags & SL_MOVE_BACKWARD;
   int32_t           fromPos = flags & SL_MOVE_FROM_POS;
+  int8_t            level = atomic_load_8(&pTbData->sl.level);  // may grow under the readers
 
   if (backward) {
     px = pTbData->sl.pTail;
 
     if (!fromPos) {
-      for (int8_t iLevel = pTbData->sl.level; iLevel < pTbData->sl.maxLevel; iLevel++) {
+      for (int8_t iLevel = level; iLevel < pTbData->sl.maxLevel; iLevel++) {
         pos[iLevel] = px;
       }
     }
 
-    if (pTbData->sl.level) {
-      if (fromPos) px = pos[pTbData->sl.level - 1];
+    if (level) {
+      if (fromPos) px = pos[level - 1];
 
-      for (int8_t iLevel = pTbData->sl.level - 1; iLevel >= 0; iLevel--) {
+      for (int8_t iLevel = level - 1; iLevel >= 0; iLevel--) {
         pn = SL_GET_NODE_BACKWARD(px, iLevel);
         while (pn != pTbData->sl.pHead) {
           tKey.version = pn->version;
@@ -433,15 +515,15 @@ static void tbDataMovePosTo(STbData *pTbData, SMemSkipListNode **pos, TSDBKEY *p
     px = pTbData->sl.pHead;
 
     if (!fromPos) {
-      for (int8_t iLevel = pTbData->sl.level; iLevel < pTbData->sl.maxLevel; iLevel++) {
+      for (int8_t iLevel = level; iLevel < pTbData->sl.maxLevel; iLevel++) {
         pos[iLevel] = px;
       }
     }
 
-    if (pTbData->sl.level) {
-      if (fromPos) px = pos[pTbData->sl.level - 1];
+    if (level) {
+      if (fromPos) px = pos[level - 1];
 
-      for (int8_t iLevel = pTbData->sl.level - 1; iLevel >= 0; iLevel--) {
+      for (int8_t iLevel = level - 1; iLevel >= 0; iLevel--) {
         pn = SL_GET_NODE_FORWARD(px, iLevel);
         while (pn != pTbData->sl.pTail) {
           tKey.version = pn->version;
@@ -472,26 +554,23 @@ static FORCE_INLINE int8_t tsdbMemSkipListRandLevel(SMemSkipList *pSl) {
 
   return level;
 }
-static int32_t tbDataDoPut(SMemTable *pMemTable, STbData *pTbData, SMemSkipListNode **pos, int64_t version,
-                           STSRow *pRow, int8_t forward) {
-  int32_t           code = 0;
-  int8_t            level;
-  SMemSkipListNode *pNode;
+static SMemSkipListNode *tbDataNewNode(SMemTable *pMemTable, STbData *pTbData, int64_t version, int32_t rowLen) {
   SVBufPool        *pPool = pMemTable->pTsdb->pVnode->inUse;
-  int64_t           nSize;
-
-  // create node
-  level = tsdbMemSkipListRandLevel(&pTbData->sl);
-  nSize = SL_NODE_SIZE(level);
-  pNode = (SMemSkipListNode *)vnodeBufPoolMallocAligned(pPool, nSize + pRow->len);
+  int8_t            level = tsdbMemSkipListRandLevel(&pTbData->sl);
+  int64_t           nSize = SL_NODE_SIZE(level);
+  SMemSkipListNode *pNode = (SMemSkipListNode *)vnodeBufPoolMallocAligned(pPool, nSize + rowLen);
   if (pNode == NULL) {
-    code = TSDB_CODE_OUT_OF_MEMORY;
-    goto _exit;
+    return NULL;
   }
+
   pNode->level = level;
   pNode->version = version;
   pNode->pTSRow = (STSRow *)((char *)pNode + nSize);
-  memcpy(pNode->pTSRow, pRow, pRow->len);
+  return pNode;
+}
+
+static void tbDataLinkNode(STbData *pTbData, SMemSkipListNode **pos, SMemSkipListNode *pNode, int8_t forward) {
+  int8_t level = pNode->level;
 
   // set node
   if (forward) {
@@ -527,13 +606,53 @@ static int32_t tbDataDoPut(SMemTable *pMemTable, STbData *pTbData, SMemSkipListN
     }
   }
 
-  pTbData->sl.size++;
+  atomic_add_fetch_64(&pTbData->sl.size, 1);
   if (pTbData->sl.level < pNode->level) {
-    pTbData->sl.level = pNode->level;
+    atomic_store_8(&pTbData->sl.level, pNode->level);
   }
+}
 
-_exit:
-  return code;
+static int32_t tbDataDoPut(SMemTable *pMemTable, STbData *pTbData, SMemSkipListNode **pos, int64_t version,
+                           STSRow *pRow, int8_t forward) {
+  SMemSkipListNode *pNode = tbDataNewNode(pMemTable, pTbData, version, pRow->len);
+  if (pNode == NULL) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  memcpy(pNode->pTSRow, pRow, pRow->len);
+  tbDataLinkNode(pTbData, pos, pNode, forward);
+  return 0;
+}
+
+// after the first row is put backward, the positions of the levels above it are moved to the ones before it
+static FORCE_INLINE void tbDataPosAfterFirstPut(STbData *pTbData, SMemSkipListNode **pos) {
+  for (int8_t iLevel = pos[0]->level; iLevel < pTbData->sl.maxLevel; iLevel++) {
+    pos[iLevel] = SL_NODE_BACKWARD(pos[iLevel], iLevel);
+  }
+}
+
+static void tsdbInsertTableDataEnd(SMemTable *pMemTable, STbData *pTbData, TSKEY lastKey, STSRow *pLastRow,
+                                   int32_t nRow, SSubmitBlkRsp *pRsp) {
+  if (lastKey >= pTbData->maxKey) {
+    if (lastKey > pTbData->maxKey) {
+      pTbData->maxKey = lastKey;
+    }
+
+    if (TSDB_CACHE_LAST_ROW(pMemTable->pTsdb->pVnode->config) && pLastRow != NULL) {
+      tsdbCacheInsertLastrow(pMemTable->pTsdb->lruCache, pMemTable->pTsdb, pTbData->uid, pLastRow, true);
+    }
+  }
+
+  if (TSDB_CACHE_LAST(pMemTable->pTsdb->pVnode->config)) {
+    tsdbCacheInsertLast(pMemTable->pTsdb->lruCache, pTbData->uid, pLastRow, pMemTable->pTsdb);
+  }
+
+  // SMemTable
+  tsdbMemTableUpdateKey(pMemTable, pTbData->minKey, pTbData->maxKey);
+  atomic_add_fetch_64(&pMemTable->nRow, nRow);
+
+  pRsp->numOfRows = nRow;
+  pRsp->affectedRows = nRow;
 }
 
 static int32_t tsdbInsertTableDataImpl(SMemTable *pMemTable, STbData *pTbData, int64_t version,
@@ -567,9 +686,7 @@ static int32_t tsdbInsertTableDataImpl(SMemTable *pMemTable, STbData *pTbData, i
   // forward put rest data
   row.pTSRow = tGetSubmitBlkNext(&blkIter);
   if (row.pTSRow) {
-    for (int8_t iLevel = pos[0]->level; iLevel < pTbData->sl.maxLevel; iLevel++) {
-      pos[iLevel] = SL_NODE_BACKWARD(pos[iLevel], iLevel);
-    }
+    tbDataPosAfterFirstPut(pTbData, pos);
     do {
       key.ts = row.pTSRow->ts;
       nRow++;
@@ -587,35 +704,53 @@ static int32_t tsdbInsertTableDataImpl(SMemTable *pMemTable, STbData *pTbData, i
     } while (row.pTSRow);
   }
 
-  if (key.ts >= pTbData->maxKey) {
-    if (key.ts > pTbData->maxKey) {
-      pTbData->maxKey = key.ts;
-    }
+  tsdbInsertTableDataEnd(pMemTable, pTbData, key.ts, pLastRow, nRow, pRsp);
 
-    if (TSDB_CACHE_LAST_ROW(pMemTable->pTsdb->pVnode->config) && pLastRow != NULL) {
-      tsdbCacheInsertLastrow(pMemTable->pTsdb->lruCache, pMemTable->pTsdb, pTbData->uid, pLastRow, true);
-    }
-  }
+  return code;
 
-  if (TSDB_CACHE_LAST(pMemTable->pTsdb->pVnode->config)) {
-    tsdbCacheInsertLast(pMemTable->pTsdb->lruCache, pTbData->uid, pLastRow, pMemTable->pTsdb);
-  }
+_err:
+  return code;
+}
 
-  // SMemTable
-  pMemTable->minKey = TMIN(pMemTable->minKey, pTbData->minKey);
-  pMemTable->maxKey = TMAX(pMemTable->maxKey, pTbData->maxKey);
-  pMemTable->nRow += nRow;
+// the rows of a columnar block are built from its columns right in the nodes of the skiplist, in ascending order of
+// the key as the rows of a row block are mostly
+static int32_t tsdbInsertColBlkImpl(SMemTable *pMemTable, STbData *pTbData, int64_t version, SSDataBlock *pBlock,
+                                    STSchema *pTSchema, SSubmitBlkRsp *pRsp) {
+  SColumnInfoData  *pTsCol = taosArrayGet(pBlock->pDataBlock, 0);
+  const TSKEY      *keys = (const TSKEY *)pTsCol->pData;
+  int32_t           nRow = pBlock->info.rows;
+  TSDBKEY           key = {.version = version, .ts = keys[0]};
+  SMemSkipListNode *pos[SL_MAX_LEVEL];
+  SMemSkipListNode *pNode = NULL;
 
-  pRsp->numOfRows = nRow;
-  pRsp->affectedRows = nRow;
+  tbDataMovePosTo(pTbData, pos, &key, SL_MOVE_BACKWARD);
+  for (int32_t iRow = 0; iRow < nRow; iRow++) {
+    pNode = tbDataNewNode(pMemTable, pTbData, version, tGetSubmitColBlkRowLen(pBlock, pTSchema, iRow));
+    if (pNode == NULL) {
+      return TSDB_CODE_OUT_OF_MEMORY;
+    }
+    tGetSubmitColBlkRow(pBlock, pTSchema, iRow, pNode->pTSRow);
 
-  return code;
+    if (iRow == 0) {
+      // backward put first data
+      tbDataLinkNode(pTbData, pos, pNode, 0);
+      pTbData->minKey = TMIN(pTbData->minKey, key.ts);
+      tbDataPosAfterFirstPut(pTbData, pos);
+    } else {
+      // forward put rest data
+      key.ts = keys[iRow];
+      if (SL_NODE_FORWARD(pos[0], 0) != pTbData->sl.pTail) {
+        tbDataMovePosTo(pTbData, pos, &key, SL_MOVE_FROM_POS);
+      }
+      tbDataLinkNode(pTbData, pos, pNode, 1);
+    }
+  }
 
-_err:
-  return code;
+  tsdbInsertTableDataEnd(pMemTable, pTbData, key.ts, pNode->pTSRow, nRow, pRsp);
+  return 0;
 }
 
-int32_t tsdbGetNRowsInTbData(STbData *pTbData) { return pTbData->sl.size; }
+int32_t tsdbGetNRowsInTbData(STbData *pTbData) { return atomic_load_64(&pTbData->sl.size); }
 
 void tsdbRefMemTable(SMemTable *pMemTable) {
   int32_t nRef = atomic_fetch_add_32(&pMemTable->nRef, 1);
@@ -652,12 +787,12 @@ SArray *tsdbMemTableGetTbDataArray(SMemTable *pMemTable) {
   SArray *aTbDataP = taosArrayInit(pMemTable->nTbData, sizeof(STbData *));
   if (aTbDataP == NULL) goto _exit;
 
-  for (int32_t iBucket = 0; iBucket < pMemTable->nBucket; iBucket++) {
-    STbData *pTbData = pMemTable->aBucket[iBucket];
+  STbDataHash *pHash = pMemTable->pHash;
+  for (int32_t iBucket = 0; iBucket < pHash->nBucket; iBucket++) {
+    STbData *pTbData = pHash->aBucket[iBucket];
 
-    while (pTbData) {
+    if (pTbData) {
       taosArrayPush(aTbDataP, &pTbData);
-      pTbData = pTbData->next;
     }
   }
 
@@ -70,10 +70,21 @@ int tsdbOpen(SVnode *pVnode, STsdb **ppTsdb, const char *dir, STsdbKeepCfg *pKee
     goto _err;
   }
 
+  // files written by compaction take a commit ID which may not be persisted in vnode state yet
+  for (int32_t iSet = 0; iSet < taosArrayGetSize(pTsdb->fs.aDFileSet); iSet++) {
+    SDFileSet *pSet = (SDFileSet *)taosArrayGet(pTsdb->fs.aDFileSet, iSet);
+    pVnode->state.commitID = TMAX(pVnode->state.commitID, pSet->pHeadF->commitID);
+  }
+
   if (tsdbOpenCache(pTsdb) < 0) {
     goto _err;
   }
 
+  if (tsdbOpenBlockCache(pTsdb) < 0) {
+    tsdbCloseCache(pTsdb);
+    goto _err;
+  }
+
   tsdbDebug("vgId:%d, tsdb is opened at %s, days:%d, keep:%d,%d,%d", TD_VID(pVnode), pTsdb->path, pTsdb->keepCfg.days,
             pTsdb->keepCfg.keep0, pTsdb->keepCfg.keep1, pTsdb->keepCfg.keep2);
 
@@ -96,6 +107,7 @@ int tsdbClose(STsdb **pTsdb) {
 
     tsdbFSClose(*pTsdb);
     tsdbCloseCache(*pTsdb);
+    tsdbCloseBlockCache(*pTsdb);
     taosMemoryFreeClear(*pTsdb);
   }
   return 0;
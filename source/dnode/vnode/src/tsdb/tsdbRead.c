@@ -17,6 +17,7 @@
 #include "tsdb.h"
 
 #define ASCENDING_TRAVERSE(o) (o == TSDB_ORDER_ASC)
+#define READ_AHEAD_BLOCKS     4  // blocks ahead of the loaded one in scan order whose reads are in flight
 
 typedef enum {
   EXTERNAL_ROWS_PREV = 0x1,
@@ -117,6 +118,7 @@ typedef struct SFileDataBlockInfo {
 typedef struct SDataBlockIter {
   int32_t   numOfBlocks;
   int32_t   index;
+  int32_t   raIndex;  // the last block in scan order which is read ahead
   SArray*   blockList;  // SArray<SFileDataBlockInfo>
   int32_t   order;
   SDataBlk  block;  // current SDataBlk data
@@ -501,6 +503,9 @@ static bool filesetIteratorNext(SFilesetIter* pIter, STsdbReader* pReader) {
       goto _err;
     }
 
+    // the blocks decompressed by one query are reused by the others, the stt blocks of the merge tree included
+    pReader->pFileReader->pBlockCache = pReader->pTsdb->blockCache.pCache;
+
     pReader->cost.headFileLoad += 1;
 
     int32_t fid = pReader->status.pCurrentFileset->fid;
@@ -533,6 +538,7 @@ _err:
 static void resetDataBlockIterator(SDataBlockIter* pIter, int32_t order) {
   pIter->order = order;
   pIter->index = -1;
+  pIter->raIndex = -1;
   pIter->numOfBlocks = 0;
   if (pIter->blockList == NULL) {
     pIter->blockList = taosArrayInit(4, sizeof(SFileDataBlockInfo));
@@ -1119,6 +1125,45 @@ static int32_t copyBlockDataToSDataBlock(STsdbReader* pReader, STableBlockScanIn
   return TSDB_CODE_SUCCESS;
 }
 
+FTsdbReadAhead tsdbReadAheadFp = NULL;
+
+// the reads of the next blocks are issued before the current one is loaded, so the disk works on them while the
+// current block is decompressed and merged
+static void doReadAheadFileBlocks(STsdbReader* pReader, SDataBlockIter* pBlockIter) {
+  int32_t step = ASCENDING_TRAVERSE(pBlockIter->order) ? 1 : -1;
+  int32_t index = pBlockIter->raIndex;
+
+  // nothing is read ahead yet, or the blocks in between are skipped without being loaded
+  if (index < 0 || (index - pBlockIter->index) * step < 0) {
+    index = pBlockIter->index;
+  }
+
+  for (index += step; (index - pBlockIter->index) * step <= READ_AHEAD_BLOCKS; index += step) {
+    if (index < 0 || index >= pBlockIter->numOfBlocks) break;
+
+    SFileDataBlockInfo*   pBlockInfo = taosArrayGet(pBlockIter->blockList, index);
+    STableBlockScanInfo** pScanInfo = taosHashGet(pBlockIter->pTableMap, &pBlockInfo->uid, sizeof(pBlockInfo->uid));
+    if (pScanInfo == NULL) break;
+
+    SDataBlk     block = {0};
+    SBlockIndex* pIndex = taosArrayGet((*pScanInfo)->pBlockList, pBlockInfo->tbBlockIdx);
+    tMapDataGetItemByIdx(&(*pScanInfo)->mapData, pIndex->ordinalIndex, &block, tGetDataBlk);
+
+    // it is only a hint, the block is read as usual when it is its turn
+    int32_t code = tsdbReadAheadDataBlock(pReader->pFileReader, &block);
+    if (code != TSDB_CODE_SUCCESS) {
+      tsdbDebug("%p failed to read ahead file block, global index:%d, code:%s %s", pReader, index, tstrerror(code),
+                pReader->idStr);
+      break;
+    }
+    pBlockIter->raIndex = index;
+
+    if (tsdbReadAheadFp) {
+      tsdbReadAheadFp(pReader, pBlockIter->order, pBlockIter->index, index, pBlockIter->numOfBlocks);
+    }
+  }
+}
+
 static int32_t doLoadFileBlockData(STsdbReader* pReader, SDataBlockIter* pBlockIter, SBlockData* pBlockData,
                                    uint64_t uid) {
   int64_t st = taosGetTimestampUs();
@@ -1134,6 +1179,8 @@ static int32_t doLoadFileBlockData(STsdbReader* pReader, SDataBlockIter* pBlockI
   SFileDataBlockInfo* pBlockInfo = getCurrentBlockInfo(pBlockIter);
   SFileBlockDumpInfo* pDumpInfo = &pReader->status.fBlockDumpInfo;
 
+  doReadAheadFileBlocks(pReader, pBlockIter);
+
   SDataBlk* pBlock = getCurrentBlock(pBlockIter);
   code = tsdbReadDataBlock(pReader->pFileReader, pBlock, pBlockData);
   if (code != TSDB_CODE_SUCCESS) {
@@ -1230,6 +1277,7 @@ static int32_t initBlockIterator(STsdbReader* pReader, SDataBlockIter* pBlockIte
 
   SBlockOrderSupporter sup = {0};
   pBlockIter->numOfBlocks = numOfBlocks;
+  pBlockIter->raIndex = -1;
   taosArrayClear(pBlockIter->blockList);
   pBlockIter->pTableMap = pReader->status.pTableMap;
 
@@ -1404,6 +1452,11 @@ static int32_t setFileBlockActiveInBlockIter(SDataBlockIter* pBlockIter, int32_t
   SFileDataBlockInfo fblock = *(SFileDataBlockInfo*)taosArrayGet(pBlockIter->blockList, index);
   pBlockIter->index += step;
 
+  // a block from beyond the read ahead ones is moved before them, so they are one step further now
+  if (pBlockIter->raIndex >= 0 && (index - pBlockIter->raIndex) * step > 0) {
+    pBlockIter->raIndex += step;
+  }
+
   if (index != pBlockIter->index) {
     taosArrayRemove(pBlockIter->blockList, index);
     taosArrayInsert(pBlockIter->blockList, pBlockIter->index, &fblock);
@@ -4002,11 +4055,13 @@ void tsdbReaderClose(STsdbReader* pReader) {
             ", fileBlocks-load-time:%.2f ms, "
             "build in-memory-block-time:%.2f ms, lastBlocks:%" PRId64
             ", lastBlocks-time:%.2f ms, composed-blocks:%" PRId64
-            ", composed-blocks-time:%.2fms, STableBlockScanInfo size:%.2f Kb, creatTime:%.2f ms, %s",
+            ", composed-blocks-time:%.2fms, STableBlockScanInfo size:%.2f Kb, creatTime:%.2f ms, block-cache hit:%" PRId64
+            " miss:%" PRId64 ", %s",
             pReader, pCost->headFileLoad, pCost->headFileLoadTime, pCost->smaDataLoad, pCost->smaLoadTime,
             pCost->numOfBlocks, pCost->blockLoadTime, pCost->buildmemBlock, pCost->lastBlockLoad,
             pCost->lastBlockLoadTime, pCost->composedBlocks, pCost->buildComposedBlockTime,
-            numOfTables * sizeof(STableBlockScanInfo) / 1000.0, pCost->createScanInfoList, pReader->idStr);
+            numOfTables * sizeof(STableBlockScanInfo) / 1000.0, pCost->createScanInfoList,
+            pReader->pTsdb->blockCache.nHit, pReader->pTsdb->blockCache.nMiss, pReader->idStr);
 
   taosMemoryFree(pReader->idStr);
   taosMemoryFree(pReader->pSchema);
@@ -196,6 +196,24 @@ _exit:
   return code;
 }
 
+// the pages of the range are brought into the page cache in the background, the read of them later does not wait
+static int32_t tsdbReadAheadFile(STsdbFD *pFD, int64_t offset, int64_t size) {
+  int32_t code = 0;
+  int64_t pgno = OFFSET_PGNO(LOGIC_TO_FILE_OFFSET(offset, pFD->szPage), pFD->szPage);
+  int64_t pgnoEnd = OFFSET_PGNO(LOGIC_TO_FILE_OFFSET(offset + size - 1, pFD->szPage), pFD->szPage);
+
+  if (size <= 0 || pgno > pFD->szFile) goto _exit;
+  pgnoEnd = TMIN(pgnoEnd, pFD->szFile);
+
+  if (taosReadAheadFile(pFD->pFD, PAGE_OFFSET(pgno, pFD->szPage), (pgnoEnd - pgno + 1) * pFD->szPage) < 0) {
+    code = TAOS_SYSTEM_ERROR(errno);
+    goto _exit;
+  }
+
+_exit:
+  return code;
+}
+
 static int32_t tsdbFsyncFile(STsdbFD *pFD) {
   int32_t code = 0;
 
@@ -856,6 +874,7 @@ int32_t tsdbDataFReaderOpen(SDataFReader **ppReader, STsdb *pTsdb, SDFileSet *pS
   }
   pReader->pTsdb = pTsdb;
   pReader->pSet = pSet;
+  pReader->cacheGen = atomic_load_32(&pTsdb->blockCache.gen);
 
   // head
   tsdbHeadFileName(pTsdb, pSet->diskId, pSet->fid, pSet->pHeadF, fname);
@@ -1062,68 +1081,241 @@ _err:
   return code;
 }
 
-static int32_t tsdbReadBlockDataImpl(SDataFReader *pReader, SBlockInfo *pBlkInfo, SBlockData *pBlockData,
-                                     int32_t iStt) {
+// block cache ==============================================
+// file names are made of fid and commit ID, and written blocks never change, so a block is identified by its offset
+typedef struct {
+  int32_t gen;
+  int32_t fid;
+  int64_t commitID;
+  int64_t offset;
+  int16_t cid;  // 0 for the key part
+  int8_t  inStt;
+} SBlockCacheKey;
+
+typedef struct {
+  SDiskDataHdr hdr;
+  int64_t     *aUid;
+  int64_t     *aVersion;
+  TSKEY       *aTSKEY;
+} SBlockCacheKeys;
+
+static void tsdbBlockCacheKey(SDataFReader *pReader, int32_t iStt, int64_t offset, int16_t cid, SBlockCacheKey *pKey) {
+  memset(pKey, 0, sizeof(*pKey));
+  pKey->gen = pReader->cacheGen;
+  pKey->fid = pReader->pSet->fid;
+  pKey->commitID = (iStt < 0) ? pReader->pSet->pDataF->commitID : pReader->pSet->aSttF[iStt]->commitID;
+  pKey->offset = offset;
+  pKey->cid = cid;
+  pKey->inStt = (iStt >= 0);
+}
+
+static void tsdbBlockCacheFreeKeys(const void *key, size_t keyLen, void *value) { taosMemoryFree(value); }
+
+static void tsdbBlockCacheFreeColData(const void *key, size_t keyLen, void *value) {
+  tColDataDestroy(value);
+  taosMemoryFree(value);
+}
+
+static int32_t tsdbBlockCacheCopyColData(SColData *pSrc, SColData *pDest) {
   int32_t code = 0;
 
-  tBlockDataClear(pBlockData);
+  pDest->nVal = pSrc->nVal;
+  pDest->flag = pSrc->flag;
+  pDest->nData = pSrc->nData;
 
-  STsdbFD *pFD = (iStt < 0) ? pReader->pDataFD : pReader->aSttFD[iStt];
+  // a bitmap is only there for mixed values
+  if (pSrc->flag & (pSrc->flag - 1)) {
+    int32_t size = (pSrc->flag == (HAS_VALUE | HAS_NULL | HAS_NONE)) ? BIT2_SIZE(pSrc->nVal) : BIT1_SIZE(pSrc->nVal);
+    code = tRealloc(&pDest->pBitMap, size);
+    if (code) return code;
+    memcpy(pDest->pBitMap, pSrc->pBitMap, size);
+  }
 
-  // uid + version + tskey
-  code = tRealloc(&pReader->aBuf[0], pBlkInfo->szKey);
-  if (code) goto _err;
+  if (pSrc->flag & HAS_VALUE) {
+    if (IS_VAR_DATA_TYPE(pSrc->type)) {
+      code = tRealloc((uint8_t **)&pDest->aOffset, sizeof(int32_t) * pSrc->nVal);
+      if (code) return code;
+      memcpy(pDest->aOffset, pSrc->aOffset, sizeof(int32_t) * pSrc->nVal);
+    }
 
-  code = tsdbReadFile(pFD, pBlkInfo->offset, pReader->aBuf[0], pBlkInfo->szKey);
-  if (code) goto _err;
+    if (pSrc->nData) {
+      code = tRealloc(&pDest->pData, pSrc->nData);
+      if (code) return code;
+      memcpy(pDest->pData, pSrc->pData, pSrc->nData);
+    }
+  }
+
+  return code;
+}
+
+static int32_t tsdbBlockCacheGetKeys(SDataFReader *pReader, int32_t iStt, int64_t offset, SDiskDataHdr *pHdr,
+                                     SBlockData *pBlockData, bool *hit) {
+  int32_t        code = 0;
+  SBlockCacheKey key;
+
+  *hit = false;
+  tsdbBlockCacheKey(pReader, iStt, offset, 0, &key);
+  LRUHandle *h = taosLRUCacheLookup(pReader->pBlockCache, &key, sizeof(key));
+  if (h == NULL) return code;
+
+  SBlockCacheKeys *pKeys = taosLRUCacheValue(pReader->pBlockCache, h);
+  int32_t          size = sizeof(int64_t) * pKeys->hdr.nRow;
+
+  if (pKeys->aUid) {
+    code = tRealloc((uint8_t **)&pBlockData->aUid, size);
+    if (code) goto _exit;
+    memcpy(pBlockData->aUid, pKeys->aUid, size);
+  }
+
+  code = tRealloc((uint8_t **)&pBlockData->aVersion, size);
+  if (code) goto _exit;
+  memcpy(pBlockData->aVersion, pKeys->aVersion, size);
+
+  code = tRealloc((uint8_t **)&pBlockData->aTSKEY, size);
+  if (code) goto _exit;
+  memcpy(pBlockData->aTSKEY, pKeys->aTSKEY, size);
+
+  *pHdr = pKeys->hdr;
+  *hit = true;
+
+_exit:
+  taosLRUCacheRelease(pReader->pBlockCache, h, false);
+  return code;
+}
+
+static void tsdbBlockCachePutKeys(SDataFReader *pReader, int32_t iStt, int64_t offset, SDiskDataHdr *pHdr,
+                                  SBlockData *pBlockData) {
+  int32_t          size = sizeof(int64_t) * pHdr->nRow;
+  size_t           charge = sizeof(SBlockCacheKeys) + size * ((pHdr->uid == 0) ? 3 : 2);
+  SBlockCacheKeys *pKeys = taosMemoryMalloc(charge);
+  SBlockCacheKey   key;
+
+  // failing to cache is not an error, the block is read anyway
+  if (pKeys == NULL) return;
+
+  pKeys->hdr = *pHdr;
+  pKeys->aVersion = (int64_t *)&pKeys[1];
+  pKeys->aTSKEY = pKeys->aVersion + pHdr->nRow;
+  pKeys->aUid = (pHdr->uid == 0) ? pKeys->aTSKEY + pHdr->nRow : NULL;
+  if (pKeys->aUid) memcpy(pKeys->aUid, pBlockData->aUid, size);
+  memcpy(pKeys->aVersion, pBlockData->aVersion, size);
+  memcpy(pKeys->aTSKEY, pBlockData->aTSKEY, size);
+
+  // every read of the block needs the key part, so it is the last to go
+  tsdbBlockCacheKey(pReader, iStt, offset, 0, &key);
+  taosLRUCacheInsert(pReader->pBlockCache, &key, sizeof(key), pKeys, charge, tsdbBlockCacheFreeKeys, NULL,
+                     TAOS_LRU_PRIORITY_HIGH);
+}
+
+static int32_t tsdbBlockCacheGetColData(SDataFReader *pReader, int32_t iStt, int64_t offset, SColData *pColData,
+                                        bool *hit) {
+  int32_t        code = 0;
+  SBlockCacheKey key;
+
+  *hit = false;
+  tsdbBlockCacheKey(pReader, iStt, offset, pColData->cid, &key);
+  LRUHandle *h = taosLRUCacheLookup(pReader->pBlockCache, &key, sizeof(key));
+  if (h == NULL) return code;
+
+  SColData *pCached = taosLRUCacheValue(pReader->pBlockCache, h);
+  if (pCached->type == pColData->type) {
+    code = tsdbBlockCacheCopyColData(pCached, pColData);
+    *hit = (code == 0);
+  }
+
+  taosLRUCacheRelease(pReader->pBlockCache, h, false);
+  return code;
+}
+
+static void tsdbBlockCachePutColData(SDataFReader *pReader, int32_t iStt, int64_t offset, SColData *pColData) {
+  SColData      *pCached = taosMemoryCalloc(1, sizeof(*pCached));
+  SBlockCacheKey key;
 
+  if (pCached == NULL) return;
+
+  tColDataInit(pCached, pColData->cid, pColData->type, pColData->smaOn);
+  if (tsdbBlockCacheCopyColData(pColData, pCached)) {
+    tsdbBlockCacheFreeColData(NULL, 0, pCached);
+    return;
+  }
+
+  size_t charge = sizeof(*pCached) + pCached->nData;
+  if (pCached->pBitMap) charge += BIT2_SIZE(pCached->nVal);
+  if (pCached->aOffset) charge += sizeof(int32_t) * pCached->nVal;
+
+  tsdbBlockCacheKey(pReader, iStt, offset, pColData->cid, &key);
+  taosLRUCacheInsert(pReader->pBlockCache, &key, sizeof(key), pCached, charge, tsdbBlockCacheFreeColData, NULL,
+                     TAOS_LRU_PRIORITY_LOW);
+}
+
+static int32_t tsdbReadBlockDataImpl(SDataFReader *pReader, SBlockInfo *pBlkInfo, SBlockData *pBlockData,
+                                     int32_t iStt) {
+  int32_t      code = 0;
+  STsdb       *pTsdb = pReader->pTsdb;
   SDiskDataHdr hdr;
-  uint8_t     *p = pReader->aBuf[0] + tGetDiskDataHdr(pReader->aBuf[0], &hdr);
+  bool         hit = false;
 
-  ASSERT(hdr.delimiter == TSDB_FILE_DLMT);
-  ASSERT(pBlockData->suid == hdr.suid);
+  tBlockDataClear(pBlockData);
 
-  pBlockData->uid = hdr.uid;
-  pBlockData->nRow = hdr.nRow;
+  STsdbFD *pFD = (iStt < 0) ? pReader->pDataFD : pReader->aSttFD[iStt];
 
-  // uid
-  if (hdr.uid == 0) {
-    ASSERT(hdr.szUid);
-    code = tsdbDecmprData(p, hdr.szUid, TSDB_DATA_TYPE_BIGINT, hdr.cmprAlg, (uint8_t **)&pBlockData->aUid,
-                          sizeof(int64_t) * hdr.nRow, &pReader->aBuf[1]);
+  // uid + version + tskey
+  if (pReader->pBlockCache) {
+    code = tsdbBlockCacheGetKeys(pReader, iStt, pBlkInfo->offset, &hdr, pBlockData, &hit);
     if (code) goto _err;
-  } else {
-    ASSERT(!hdr.szUid);
   }
-  p += hdr.szUid;
 
-  // version
-  code = tsdbDecmprData(p, hdr.szVer, TSDB_DATA_TYPE_BIGINT, hdr.cmprAlg, (uint8_t **)&pBlockData->aVersion,
-                        sizeof(int64_t) * hdr.nRow, &pReader->aBuf[1]);
-  if (code) goto _err;
-  p += hdr.szVer;
+  if (!hit) {
+    code = tRealloc(&pReader->aBuf[0], pBlkInfo->szKey);
+    if (code) goto _err;
 
-  // TSKEY
-  code = tsdbDecmprData(p, hdr.szKey, TSDB_DATA_TYPE_TIMESTAMP, hdr.cmprAlg, (uint8_t **)&pBlockData->aTSKEY,
-                        sizeof(TSKEY) * hdr.nRow, &pReader->aBuf[1]);
-  if (code) goto _err;
-  p += hdr.szKey;
+    code = tsdbReadFile(pFD, pBlkInfo->offset, pReader->aBuf[0], pBlkInfo->szKey);
+    if (code) goto _err;
 
-  ASSERT(p - pReader->aBuf[0] == pBlkInfo->szKey);
+    uint8_t *p = pReader->aBuf[0] + tGetDiskDataHdr(pReader->aBuf[0], &hdr);
 
-  // read and decode columns
-  if (pBlockData->nColData == 0) goto _exit;
+    ASSERT(hdr.delimiter == TSDB_FILE_DLMT);
 
-  if (hdr.szBlkCol > 0) {
-    int64_t offset = pBlkInfo->offset + pBlkInfo->szKey;
+    // uid
+    if (hdr.uid == 0) {
+      ASSERT(hdr.szUid);
+      code = tsdbDecmprData(p, hdr.szUid, TSDB_DATA_TYPE_BIGINT, hdr.cmprAlg, (uint8_t **)&pBlockData->aUid,
+                            sizeof(int64_t) * hdr.nRow, &pReader->aBuf[1]);
+      if (code) goto _err;
+    } else {
+      ASSERT(!hdr.szUid);
+    }
+    p += hdr.szUid;
 
-    code = tRealloc(&pReader->aBuf[0], hdr.szBlkCol);
+    // version
+    code = tsdbDecmprData(p, hdr.szVer, TSDB_DATA_TYPE_BIGINT, hdr.cmprAlg, (uint8_t **)&pBlockData->aVersion,
+                          sizeof(int64_t) * hdr.nRow, &pReader->aBuf[1]);
     if (code) goto _err;
+    p += hdr.szVer;
 
-    code = tsdbReadFile(pFD, offset, pReader->aBuf[0], hdr.szBlkCol);
+    // TSKEY
+    code = tsdbDecmprData(p, hdr.szKey, TSDB_DATA_TYPE_TIMESTAMP, hdr.cmprAlg, (uint8_t **)&pBlockData->aTSKEY,
+                          sizeof(TSKEY) * hdr.nRow, &pReader->aBuf[1]);
     if (code) goto _err;
+    p += hdr.szKey;
+
+    ASSERT(p - pReader->aBuf[0] == pBlkInfo->szKey);
+
+    if (pReader->pBlockCache) {
+      tsdbBlockCachePutKeys(pReader, iStt, pBlkInfo->offset, &hdr, pBlockData);
+    }
   }
 
+  ASSERT(pBlockData->suid == hdr.suid);
+
+  pBlockData->uid = hdr.uid;
+  pBlockData->nRow = hdr.nRow;
+
+  // read and decode columns
+  if (pBlockData->nColData == 0) goto _exit;
+
+  // the column list is only read when a column is not in cache
+  bool       blkColLoaded = (hdr.szBlkCol == 0);
   SBlockCol  blockCol = {.cid = 0};
   SBlockCol *pBlockCol = &blockCol;
   int32_t    n = 0;
@@ -1131,6 +1323,29 @@ static int32_t tsdbReadBlockDataImpl(SDataFReader *pReader, SBlockInfo *pBlkInfo
   for (int32_t iColData = 0; iColData < pBlockData->nColData; iColData++) {
     SColData *pColData = tBlockDataGetColDataByIdx(pBlockData, iColData);
 
+    if (pReader->pBlockCache) {
+      code = tsdbBlockCacheGetColData(pReader, iStt, pBlkInfo->offset, pColData, &hit);
+      if (code) goto _err;
+
+      if (hit) {
+        atomic_add_fetch_64(&pTsdb->blockCache.nHit, 1);
+        continue;
+      }
+      atomic_add_fetch_64(&pTsdb->blockCache.nMiss, 1);
+    }
+
+    if (!blkColLoaded) {
+      int64_t offset = pBlkInfo->offset + pBlkInfo->szKey;
+
+      code = tRealloc(&pReader->aBuf[0], hdr.szBlkCol);
+      if (code) goto _err;
+
+      code = tsdbReadFile(pFD, offset, pReader->aBuf[0], hdr.szBlkCol);
+      if (code) goto _err;
+
+      blkColLoaded = true;
+    }
+
     while (pBlockCol && pBlockCol->cid < pColData->cid) {
       if (n < hdr.szBlkCol) {
         n += tGetBlockCol(pReader->aBuf[0] + n, pBlockCol);
@@ -1171,13 +1386,17 @@ static int32_t tsdbReadBlockDataImpl(SDataFReader *pReader, SBlockInfo *pBlkInfo
         if (code) goto _err;
       }
     }
+
+    if (pReader->pBlockCache) {
+      tsdbBlockCachePutColData(pReader, iStt, pBlkInfo->offset, pColData);
+    }
   }
 
 _exit:
   return code;
 
 _err:
-  tsdbError("vgId:%d, tsdb read block data impl failed since %s", TD_VID(pReader->pTsdb->pVnode), tstrerror(code));
+  tsdbError("vgId:%d, tsdb read block data impl failed since %s", TD_VID(pTsdb->pVnode), tstrerror(code));
   return code;
 }
 
@@ -1219,6 +1438,18 @@ _err:
   return code;
 }
 
+int32_t tsdbReadAheadDataBlock(SDataFReader *pReader, SDataBlk *pDataBlk) {
+  int32_t code = 0;
+
+  for (int32_t iSubBlock = 0; iSubBlock < pDataBlk->nSubBlock; iSubBlock++) {
+    SBlockInfo *pBlkInfo = &pDataBlk->aSubBlock[iSubBlock];
+    code = tsdbReadAheadFile(pReader->pDataFD, pBlkInfo->offset, pBlkInfo->szBlock);
+    if (code) break;
+  }
+
+  return code;
+}
+
 int32_t tsdbReadSttBlock(SDataFReader *pReader, int32_t iStt, SSttBlk *pSttBlk, SBlockData *pBlockData) {
   int32_t code = 0;
   int32_t lino = 0;
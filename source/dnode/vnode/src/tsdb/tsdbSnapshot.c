@@ -1411,6 +1411,9 @@ int32_t tsdbSnapWriterClose(STsdbSnapWriter** ppWriter, int8_t rollback) {
       goto _err;
     }
 
+    // the received files may reuse the names of the replaced ones
+    atomic_add_fetch_32(&pTsdb->blockCache.gen, 1);
+
     // unlock
     taosThreadRwlockUnlock(&pTsdb->rwLock);
   }
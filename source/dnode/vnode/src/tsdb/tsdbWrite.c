@@ -82,9 +82,8 @@ static FORCE_INLINE int tsdbCheckRowRange(STsdb *pTsdb, STable *pTable, STSRow *
 }
 #endif
 
-static FORCE_INLINE int tsdbCheckRowRange(STsdb *pTsdb, tb_uid_t uid, STSRow *row, TSKEY minKey, TSKEY maxKey,
+static FORCE_INLINE int tsdbCheckRowRange(STsdb *pTsdb, tb_uid_t uid, TSKEY rowKey, TSKEY minKey, TSKEY maxKey,
                                           TSKEY now) {
-  TSKEY rowKey = TD_ROW_KEY(row);
   if (rowKey < minKey || rowKey > maxKey) {
     tsdbError("vgId:%d, table uid %" PRIu64 " timestamp is out of range! now %" PRId64 " minKey %" PRId64
               " maxKey %" PRId64 " row key %" PRId64,
@@ -155,9 +154,19 @@ int tsdbScanAndConvertSubmitMsg(STsdb *pTsdb, SSubmitReq *pMsg) {
       }
     }
 #endif
+    // the keys of a columnar block are in ascending order, as tsdbMemTablePut checks
+    SSubmitColHead *pColHead = tGetSubmitColHead(&msgIter, pBlock);
+    if (pColHead) {
+      if (tsdbCheckRowRange(pTsdb, msgIter.uid, TD_ROW_KEY(SUBMIT_COL_HEAD_ROW(pColHead)), minKey, maxKey, now) < 0 ||
+          tsdbCheckRowRange(pTsdb, msgIter.uid, pColHead->ekey, minKey, maxKey, now) < 0) {
+        return -1;
+      }
+      continue;
+    }
+
     tInitSubmitBlkIter(&msgIter, pBlock, &blkIter);
     while ((row = tGetSubmitBlkNext(&blkIter)) != NULL) {
-      if (tsdbCheckRowRange(pTsdb, msgIter.uid, row, minKey, maxKey, now) < 0) {
+      if (tsdbCheckRowRange(pTsdb, msgIter.uid, TD_ROW_KEY(row), minKey, maxKey, now) < 0) {
         return -1;
       }
     }
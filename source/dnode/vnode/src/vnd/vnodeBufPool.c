@@ -16,7 +16,55 @@
 #include "vnd.h"
 
 /* ------------------------ STRUCTURES ------------------------ */
-#define VNODE_BUFPOOL_SEGMENTS 3
+#define VNODE_BUFPOOL_SEGMENTS   3
+#define VNODE_BUFPOOL_CHUNK_SIZE (64 * 1024)    // taken at once by a writer thread of a shared pool
+#define VNODE_BUFPOOL_NODE_SIZE  (1024 * 1024)  // malloced at once after the anchor is full
+#define VNODE_BUFPOOL_ARENAS     8
+#define VNODE_BUFPOOL_WASTES     1024
+
+#define VNODE_BUFPOOL_ALIGN(p) ((uint8_t *)(((uintptr_t)(p) + 7) & ~(uintptr_t)7))
+
+typedef struct {
+  SVBufPool *pPool;
+  int64_t    epoch;
+  uint8_t   *ptr;
+  uint8_t   *end;
+} SVBufPoolArena;
+
+// the waste of a pool epoch, kept out of the pool as a thread may drop its chunk after the pool is gone
+typedef struct {
+  volatile int64_t epoch;
+  volatile int64_t nWaste;
+} SVBufPoolWaste;
+
+// the chunks this thread is allocating from, one slot per pool it writes to
+static threadlocal SVBufPoolArena vnodeBufPoolArenas[VNODE_BUFPOOL_ARENAS];
+static threadlocal int32_t        vnodeBufPoolArenaNext = 0;
+static volatile int64_t           vnodeBufPoolEpoch = 0;
+static SVBufPoolWaste             vnodeBufPoolWastes[VNODE_BUFPOOL_WASTES];
+
+static void vnodeBufPoolWasteOpen(int64_t epoch) {
+  SVBufPoolWaste *pWaste = &vnodeBufPoolWastes[epoch % VNODE_BUFPOOL_WASTES];
+  atomic_store_64(&pWaste->epoch, 0);
+  atomic_store_64(&pWaste->nWaste, 0);
+  atomic_store_64(&pWaste->epoch, epoch);
+}
+
+// the count is dropped if the slot is taken by a later epoch
+static void vnodeBufPoolWasteAdd(int64_t epoch, int64_t nWaste) {
+  SVBufPoolWaste *pWaste = &vnodeBufPoolWastes[epoch % VNODE_BUFPOOL_WASTES];
+  if (atomic_load_64(&pWaste->epoch) == epoch) {
+    atomic_add_fetch_64(&pWaste->nWaste, nWaste);
+  }
+}
+
+static int64_t vnodeBufPoolWasteClose(int64_t epoch) {
+  SVBufPoolWaste *pWaste = &vnodeBufPoolWastes[epoch % VNODE_BUFPOOL_WASTES];
+  if (atomic_val_compare_exchange_64(&pWaste->epoch, epoch, 0) != epoch) {
+    return 0;
+  }
+  return atomic_exchange_64(&pWaste->nWaste, 0);
+}
 
 static int vnodeBufPoolCreate(SVnode *pVnode, int64_t size, SVBufPool **ppPool) {
   SVBufPool *pPool;
@@ -47,12 +95,20 @@ static int vnodeBufPoolCreate(SVnode *pVnode, int64_t size, SVBufPool **ppPool)
   pPool->next = NULL;
   pPool->pVnode = pVnode;
   pPool->nRef = 0;
+  pPool->epoch = atomic_add_fetch_64(&vnodeBufPoolEpoch, 1);
+  pPool->arena = pPool->epoch % VNODE_BUFPOOL_ARENAS;
   pPool->size = 0;
   pPool->ptr = pPool->node.data;
+  pPool->nodePtr = NULL;
+  pPool->nodeEnd = NULL;
+  pPool->nChunk = 0;
+  pPool->nWaste = 0;
+  pPool->nFallback = 0;
   pPool->pTail = &pPool->node;
   pPool->node.prev = NULL;
   pPool->node.pnext = &pPool->pTail;
   pPool->node.size = size;
+  if (pPool->lock) vnodeBufPoolWasteOpen(pPool->epoch);
 
   *ppPool = pPool;
   return 0;
@@ -61,6 +117,7 @@ static int vnodeBufPoolCreate(SVnode *pVnode, int64_t size, SVBufPool **ppPool)
 static int vnodeBufPoolDestroy(SVBufPool *pPool) {
   vnodeBufPoolReset(pPool);
   if (pPool->lock) {
+    vnodeBufPoolWasteClose(pPool->epoch);
     taosThreadSpinDestroy(pPool->lock);
     taosMemoryFree((void *)pPool->lock);
   }
@@ -119,83 +176,153 @@ void vnodeBufPoolReset(SVBufPool *pPool) {
 
   ASSERT(pPool->size == pPool->ptr - pPool->node.data);
 
+  if (pPool->lock) {
+    pPool->nWaste += vnodeBufPoolWasteClose(pPool->epoch);
+  }
+
+  if (pPool->nChunk || pPool->nFallback) {
+    SVnode *pVnode = pPool->pVnode;
+    atomic_add_fetch_64(&pVnode->bufPoolStatis.nChunk, pPool->nChunk);
+    atomic_add_fetch_64(&pVnode->bufPoolStatis.nWaste, pPool->nWaste);
+    atomic_add_fetch_64(&pVnode->bufPoolStatis.nFallback, pPool->nFallback);
+    vDebug("vgId:%d, vnode buffer pool reset, chunks:%" PRId64 " waste:%" PRId64 " fallback:%" PRId64, TD_VID(pVnode),
+           pPool->nChunk, pPool->nWaste, pPool->nFallback);
+  }
+
+  pPool->epoch = atomic_add_fetch_64(&vnodeBufPoolEpoch, 1);
   pPool->size = 0;
   pPool->ptr = pPool->node.data;
+  pPool->nodePtr = NULL;
+  pPool->nodeEnd = NULL;
+  pPool->nChunk = 0;
+  pPool->nWaste = 0;
+  pPool->nFallback = 0;
+  if (pPool->lock) vnodeBufPoolWasteOpen(pPool->epoch);
 }
 
-void *vnodeBufPoolMallocAligned(SVBufPool *pPool, int size) {
+// allocate from the anchor node, then from nodes of VNODE_BUFPOOL_NODE_SIZE once it is full
+// the caller holds the lock of a shared pool
+static void *vnodeBufPoolMallocImpl(SVBufPool *pPool, int64_t size, bool aligned) {
   SVBufPoolNode *pNode;
-  void          *p = NULL;
-  uint8_t       *ptr = NULL;
-  int            paddingLen = 0;
-  ASSERT(pPool != NULL);
+  uint8_t       *p;
+
+  // allocate from the anchor node
+  p = aligned ? VNODE_BUFPOOL_ALIGN(pPool->ptr) : pPool->ptr;
+  if (p + size <= pPool->node.data + pPool->node.size) {
+    pPool->size += p + size - pPool->ptr;
+    pPool->ptr = p + size;
+    return p;
+  }
+
+  // allocate from the last node
+  if (pPool->nodePtr) {
+    p = aligned ? VNODE_BUFPOOL_ALIGN(pPool->nodePtr) : pPool->nodePtr;
+    if (p + size <= pPool->nodeEnd) {
+      pPool->nodePtr = p + size;
+      return p;
+    }
+  }
 
-  if (pPool->lock) taosThreadSpinLock(pPool->lock);
+  // allocate a new node, a large request takes one of its own
+  bool    shared = (size <= VNODE_BUFPOOL_NODE_SIZE / 2);
+  int64_t nodeSize = shared ? VNODE_BUFPOOL_NODE_SIZE : size;
 
-  ptr = pPool->ptr;
-  paddingLen = (((long)ptr + 7) & ~7) - (long)ptr;
+  pNode = taosMemoryMalloc(sizeof(*pNode) + nodeSize);
+  if (pNode == NULL) {
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    return NULL;
+  }
 
-  if (pPool->node.size >= pPool->ptr - pPool->node.data + size + paddingLen) {
-    // allocate from the anchor node
-    p = pPool->ptr + paddingLen;
-    size += paddingLen;
-    pPool->ptr = pPool->ptr + size;
-    pPool->size += size;
-  } else {
-    // allocate a new node
-    pNode = taosMemoryMalloc(sizeof(*pNode) + size);
-    if (pNode == NULL) {
-      terrno = TSDB_CODE_OUT_OF_MEMORY;
-      if (pPool->lock) taosThreadSpinUnlock(pPool->lock);
-      return NULL;
-    }
+  p = pNode->data;
+  pNode->size = nodeSize;
+  pNode->prev = pPool->pTail;
+  pNode->pnext = &pPool->pTail;
+  pPool->pTail->pnext = &pNode->prev;
+  pPool->pTail = pNode;
 
-    p = pNode->data;
-    pNode->size = size;
-    pNode->prev = pPool->pTail;
-    pNode->pnext = &pPool->pTail;
-    pPool->pTail->pnext = &pNode->prev;
-    pPool->pTail = pNode;
+  pPool->size = pPool->size + sizeof(*pNode) + nodeSize;
+  pPool->nFallback++;
 
-    pPool->size = pPool->size + sizeof(*pNode) + size;
+  if (shared) {
+    if (pPool->nodePtr) pPool->nWaste += pPool->nodeEnd - pPool->nodePtr;
+    pPool->nodePtr = p + size;
+    pPool->nodeEnd = p + nodeSize;
   }
-  if (pPool->lock) taosThreadSpinUnlock(pPool->lock);
+
   return p;
 }
 
-void *vnodeBufPoolMalloc(SVBufPool *pPool, int size) {
-  SVBufPoolNode *pNode;
-  void          *p = NULL;
-  ASSERT(pPool != NULL);
+// a writer thread of a shared pool allocates from a chunk of its own, and only locks the pool for a new chunk
+static void *vnodeBufPoolArenaMalloc(SVBufPool *pPool, int size, bool aligned) {
+  SVBufPoolArena *pArena = &vnodeBufPoolArenas[pPool->arena];
+  uint8_t        *p;
+
+  // the slot of the pool may be taken by another one, then its chunk is kept in any other slot
+  if (pArena->pPool != pPool) {
+    SVBufPoolArena *pVictim = (pArena->pPool == NULL) ? pArena : NULL;
+    for (int32_t i = 0; i < VNODE_BUFPOOL_ARENAS; i++) {
+      if (vnodeBufPoolArenas[i].pPool == pPool) {
+        pVictim = &vnodeBufPoolArenas[i];
+        break;
+      }
+      if (pVictim == NULL && vnodeBufPoolArenas[i].pPool == NULL) {
+        pVictim = &vnodeBufPoolArenas[i];
+      }
+    }
+    pArena = pVictim ? pVictim : &vnodeBufPoolArenas[vnodeBufPoolArenaNext++ % VNODE_BUFPOOL_ARENAS];
+  }
 
-  if (pPool->lock) taosThreadSpinLock(pPool->lock);
-  if (pPool->node.size >= pPool->ptr - pPool->node.data + size) {
-    // allocate from the anchor node
-    p = pPool->ptr;
-    pPool->ptr = pPool->ptr + size;
-    pPool->size += size;
-  } else {
-    // allocate a new node
-    pNode = taosMemoryMalloc(sizeof(*pNode) + size);
-    if (pNode == NULL) {
-      terrno = TSDB_CODE_OUT_OF_MEMORY;
-      if (pPool->lock) taosThreadSpinUnlock(pPool->lock);
-      return NULL;
+  bool owned = (pArena->pPool == pPool && pArena->epoch == pPool->epoch);
+  if (owned) {
+    p = aligned ? VNODE_BUFPOOL_ALIGN(pArena->ptr) : pArena->ptr;
+    if (p + size <= pArena->end) {
+      pArena->ptr = p + size;
+      return p;
     }
+  }
 
-    p = pNode->data;
-    pNode->size = size;
-    pNode->prev = pPool->pTail;
-    pNode->pnext = &pPool->pTail;
-    pPool->pTail->pnext = &pNode->prev;
-    pPool->pTail = pNode;
+  taosThreadSpinLock(pPool->lock);
+  if (size > VNODE_BUFPOOL_CHUNK_SIZE / 4) {
+    p = vnodeBufPoolMallocImpl(pPool, size, aligned);
+  } else {
+    p = vnodeBufPoolMallocImpl(pPool, VNODE_BUFPOOL_CHUNK_SIZE, true);
+    if (p) {
+      if (owned) {
+        pPool->nWaste += pArena->end - pArena->ptr;
+      } else if (pArena->pPool) {
+        vnodeBufPoolWasteAdd(pArena->epoch, pArena->end - pArena->ptr);
+      }
+      pPool->nChunk++;
 
-    pPool->size = pPool->size + sizeof(*pNode) + size;
+      pArena->pPool = pPool;
+      pArena->epoch = pPool->epoch;
+      pArena->ptr = p + size;
+      pArena->end = p + VNODE_BUFPOOL_CHUNK_SIZE;
+    }
   }
-  if (pPool->lock) taosThreadSpinUnlock(pPool->lock);
+  taosThreadSpinUnlock(pPool->lock);
+
   return p;
 }
 
+void *vnodeBufPoolMallocAligned(SVBufPool *pPool, int size) {
+  ASSERT(pPool != NULL);
+
+  if (pPool->lock) {
+    return vnodeBufPoolArenaMalloc(pPool, size, true);
+  }
+  return vnodeBufPoolMallocImpl(pPool, size, true);
+}
+
+void *vnodeBufPoolMalloc(SVBufPool *pPool, int size) {
+  ASSERT(pPool != NULL);
+
+  if (pPool->lock) {
+    return vnodeBufPoolArenaMalloc(pPool, size, false);
+  }
+  return vnodeBufPoolMallocImpl(pPool, size, false);
+}
+
 void vnodeBufPoolFree(SVBufPool *pPool, void *p) {
   // uint8_t       *ptr = (uint8_t *)p;
   // SVBufPoolNode *pNode;
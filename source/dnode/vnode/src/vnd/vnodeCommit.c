@@ -305,6 +305,30 @@ int vnodeSyncCommit(SVnode *pVnode) {
   return 0;
 }
 
+int32_t vnodeAsyncCompact(SVnode *pVnode) {
+  int32_t code = 0;
+
+  if (pVnode->pTsdb == NULL) return code;
+
+  // reserve a commit ID for the compacted files, the in-use memtable will be committed with a newer one
+  int64_t commitID = pVnode->state.commitID + 1;
+
+  code = tsdbAsyncCompact(pVnode->pTsdb, commitID);
+  if (code == TSDB_CODE_ACTION_IN_PROGRESS) {
+    vInfo("vgId:%d, vnode compact already in progress, progress:%d%%", TD_VID(pVnode),
+          tsdbGetCompactProgress(pVnode->pTsdb));
+    return 0;
+  } else if (code) {
+    vError("vgId:%d, vnode async compact failed since %s", TD_VID(pVnode), tstrerror(code));
+    return code;
+  }
+
+  pVnode->state.commitID += 2;
+
+  vInfo("vgId:%d, vnode async compact started, commitId:%" PRId64, TD_VID(pVnode), commitID);
+  return code;
+}
+
 static int vnodeCommitImpl(SCommitInfo *pInfo) {
   int32_t code = 0;
   int32_t lino = 0;
@@ -392,6 +392,9 @@ int32_t vnodeGetLoad(SVnode *pVnode, SVnodeLoad *pLoad) {
   pLoad->numOfInsertSuccessReqs = atomic_load_64(&pVnode->statis.nInsertSuccess);
   pLoad->numOfBatchInsertReqs = atomic_load_64(&pVnode->statis.nBatchInsert);
   pLoad->numOfBatchInsertSuccessReqs = atomic_load_64(&pVnode->statis.nBatchInsertSuccess);
+  pLoad->bufPoolChunks = atomic_load_64(&pVnode->bufPoolStatis.nChunk);
+  pLoad->bufPoolWaste = atomic_load_64(&pVnode->bufPoolStatis.nWaste);
+  pLoad->bufPoolFallbacks = atomic_load_64(&pVnode->bufPoolStatis.nFallback);
   return 0;
 }
 
@@ -406,6 +409,9 @@ void vnodeResetLoad(SVnode *pVnode, SVnodeLoad *pLoad) {
   VNODE_GET_LOAD_RESET_VALS(pVnode->statis.nInsertSuccess, pLoad->numOfInsertSuccessReqs, 64, "nInsertSuccess");
   VNODE_GET_LOAD_RESET_VALS(pVnode->statis.nBatchInsert, pLoad->numOfBatchInsertReqs, 64, "nBatchInsert");
   VNODE_GET_LOAD_RESET_VALS(pVnode->statis.nBatchInsertSuccess, pLoad->numOfBatchInsertSuccessReqs, 64, "nBatchInsertSuccess");
+  VNODE_GET_LOAD_RESET_VALS(pVnode->bufPoolStatis.nChunk, pLoad->bufPoolChunks, 64, "nChunk");
+  VNODE_GET_LOAD_RESET_VALS(pVnode->bufPoolStatis.nWaste, pLoad->bufPoolWaste, 64, "nWaste");
+  VNODE_GET_LOAD_RESET_VALS(pVnode->bufPoolStatis.nFallback, pLoad->bufPoolFallbacks, 64, "nFallback");
 }
 
 void vnodeGetInfo(SVnode *pVnode, const char **dbname, int32_t *vgId) {
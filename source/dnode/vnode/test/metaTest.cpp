@@ -0,0 +1,362 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "vnodeTestUtil.h"
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wwrite-strings"
+#pragma GCC diagnostic ignored "-Wsign-compare"
+
+// The tags of a child table as the test expects them, a missing tag is NULL.
+struct STestTags {
+  bool        t1Null = true;
+  int32_t     t1 = 0;
+  bool        t2Null = true;
+  std::string t2;
+};
+
+// A vnode with just meta open, driven the way vnodeSvr drives it. Tables are children of one super table with the
+// tags (t1 int, t2 varchar(16)), the tags read through metaGetTableTagCols are checked against the ones written.
+class MetaTest : public VnodeMetaTest {
+ protected:
+  static constexpr tb_uid_t kSuid = 100;
+
+  int32_t                       tagColCacheSize = 0;
+  std::map<tb_uid_t, STestTags> expect;
+
+  MetaTest() : VnodeMetaTest(TD_TMP_DIR_PATH "metaTest") {}
+
+  void SetUp() override {
+    tagColCacheSize = tsTagColCacheSize;
+    VnodeMetaTest::SetUp();
+    if (HasFatalFailure()) return;
+
+    createSuperTable(1);
+  }
+
+  void TearDown() override {
+    VnodeMetaTest::TearDown();
+    tsTagColCacheSize = tagColCacheSize;
+  }
+
+  // version 1 has the tags (t1, t2), version 2 adds t3 int
+  void createSuperTable(int32_t tagVer, bool alter = false) {
+    SSchema schemaRow[2] = {{.type = TSDB_DATA_TYPE_TIMESTAMP, .colId = 1, .bytes = 8, .name = "ts"},
+                            {.type = TSDB_DATA_TYPE_INT, .colId = 2, .bytes = 4, .name = "v"}};
+    SSchema schemaTag[3] = {{.type = TSDB_DATA_TYPE_INT, .colId = 3, .bytes = 4, .name = "t1"},
+                            {.type = TSDB_DATA_TYPE_VARCHAR, .colId = 4, .bytes = 16 + VARSTR_HEADER_SIZE, .name = "t2"},
+                            {.type = TSDB_DATA_TYPE_INT, .colId = 5, .bytes = 4, .name = "t3"}};
+
+    SVCreateStbReq req = {0};
+    req.name = (char *)"stb";
+    req.suid = kSuid;
+    req.schemaRow = {.nCols = 2, .version = 1, .pSchema = schemaRow};
+    req.schemaTag = {.nCols = tagVer + 1, .version = tagVer, .pSchema = schemaTag};
+    if (alter) {
+      ASSERT_EQ(metaAlterSTable(pVnode->pMeta, ++version, &req), 0);
+    } else {
+      ASSERT_EQ(metaCreateSTable(pVnode->pMeta, ++version, &req), 0);
+    }
+  }
+
+  void createTable(tb_uid_t uid, const STestTags &tags) {
+    std::vector<STagVal> tagVals;
+    if (!tags.t1Null) {
+      tagVals.push_back({.cid = 3, .type = TSDB_DATA_TYPE_INT, .i64 = tags.t1});
+    }
+    if (!tags.t2Null) {
+      STagVal tagVal = {.cid = 4, .type = TSDB_DATA_TYPE_VARCHAR};
+      tagVal.pData = (uint8_t *)tags.t2.data();
+      tagVal.nData = tags.t2.size();
+      tagVals.push_back(tagVal);
+    }
+    VnodeMetaTest::createTable(uid, kSuid, tagVals);
+
+    expect[uid] = tags;
+  }
+
+  // as the alter table ... set tag statement does, pVal NULL sets the tag to NULL
+  void alterTag(tb_uid_t uid, const char *tagName, int8_t type, const void *pVal, uint32_t nVal) {
+    char name[TSDB_TABLE_NAME_LEN];
+    snprintf(name, sizeof(name), "ctb%" PRId64, uid);
+
+    SVAlterTbReq req = {0};
+    req.tbName = name;
+    req.action = TSDB_ALTER_TABLE_UPDATE_TAG_VAL;
+    req.tagName = (char *)tagName;
+    req.isNull = (pVal == NULL);
+    req.tagType = type;
+    req.nTagVal = nVal;
+    req.pTagVal = (uint8_t *)pVal;
+    ASSERT_EQ(metaAlterTable(pVnode->pMeta, ++version, &req, NULL), 0);
+  }
+
+  void setT1(tb_uid_t uid, int32_t t1) {
+    alterTag(uid, "t1", TSDB_DATA_TYPE_INT, &t1, sizeof(t1));
+    expect[uid].t1Null = false;
+    expect[uid].t1 = t1;
+  }
+
+  void setT2(tb_uid_t uid, const std::string &t2) {
+    alterTag(uid, "t2", TSDB_DATA_TYPE_VARCHAR, t2.data(), t2.size());
+    expect[uid].t2Null = false;
+    expect[uid].t2 = t2;
+  }
+
+  void dropTable(tb_uid_t uid) {
+    char name[TSDB_TABLE_NAME_LEN];
+    snprintf(name, sizeof(name), "ctb%" PRId64, uid);
+
+    SVDropTbReq req = {.name = name, .suid = kSuid};
+    ASSERT_EQ(metaDropTable(pVnode->pMeta, ++version, &req, NULL, NULL), 0);
+    expect.erase(uid);
+  }
+
+  // the block of the tag scan: tbname, then the tags in the given order
+  SSDataBlock *createTagBlock(const std::vector<std::pair<int16_t, int8_t>> &tags) {
+    SSDataBlock    *pBlock = createDataBlock();
+    SColumnInfoData tbname = createColumnInfoData(TSDB_DATA_TYPE_VARCHAR, TSDB_TABLE_NAME_LEN + VARSTR_HEADER_SIZE, -1);
+    blockDataAppendColInfo(pBlock, &tbname);
+    for (auto &tag : tags) {
+      int32_t         bytes = IS_VAR_DATA_TYPE(tag.second) ? 16 + VARSTR_HEADER_SIZE : tDataTypes[tag.second].bytes;
+      SColumnInfoData col = createColumnInfoData(tag.second, bytes, tag.first);
+      blockDataAppendColInfo(pBlock, &col);
+    }
+    return pBlock;
+  }
+
+  // the tags of all the children, or of the ones in uids, as returned by metaGetTableTagCols
+  int32_t getTagCols(SArray *uidList, SSDataBlock *pBlock, std::map<tb_uid_t, STestTags> &res) {
+    int32_t code = metaGetTableTagCols(pVnode->pMeta, kSuid, uidList, pBlock);
+    if (code != TSDB_CODE_SUCCESS) {
+      return code;
+    }
+
+    SColumnInfoData *pT1 = (SColumnInfoData *)taosArrayGet(pBlock->pDataBlock, 1);
+    SColumnInfoData *pT2 = (SColumnInfoData *)taosArrayGet(pBlock->pDataBlock, 2);
+    for (int32_t i = 0; i < taosArrayGetSize(uidList); ++i) {
+      tb_uid_t  uid = *(tb_uid_t *)taosArrayGet(uidList, i);
+      STestTags tags;
+      tags.t1Null = colDataIsNull_s(pT1, i);
+      if (!tags.t1Null) {
+        tags.t1 = *(int32_t *)colDataGetData(pT1, i);
+      }
+      tags.t2Null = colDataIsNull_s(pT2, i);
+      if (!tags.t2Null) {
+        char *p = colDataGetData(pT2, i);
+        tags.t2.assign(varDataVal(p), varDataLen(p));
+      }
+      EXPECT_TRUE(res.emplace(uid, tags).second) << "duplicated uid " << uid;
+    }
+    return code;
+  }
+
+  void checkTagCols() {
+    SArray      *uidList = taosArrayInit(8, sizeof(tb_uid_t));
+    SSDataBlock *pBlock = createTagBlock({{3, TSDB_DATA_TYPE_INT}, {4, TSDB_DATA_TYPE_VARCHAR}});
+
+    std::map<tb_uid_t, STestTags> res;
+    ASSERT_EQ(getTagCols(uidList, pBlock, res), TSDB_CODE_SUCCESS);
+    ASSERT_EQ(res.size(), expect.size());
+    for (int32_t i = 1; i < taosArrayGetSize(uidList); ++i) {
+      ASSERT_LT(*(tb_uid_t *)taosArrayGet(uidList, i - 1), *(tb_uid_t *)taosArrayGet(uidList, i));
+    }
+    for (auto &e : expect) {
+      auto it = res.find(e.first);
+      ASSERT_NE(it, res.end()) << "uid " << e.first;
+      ASSERT_EQ(it->second.t1Null, e.second.t1Null) << "uid " << e.first;
+      if (!e.second.t1Null) ASSERT_EQ(it->second.t1, e.second.t1) << "uid " << e.first;
+      ASSERT_EQ(it->second.t2Null, e.second.t2Null) << "uid " << e.first;
+      if (!e.second.t2Null) ASSERT_EQ(it->second.t2, e.second.t2) << "uid " << e.first;
+    }
+
+    blockDataDestroy(pBlock);
+    taosArrayDestroy(uidList);
+  }
+
+  static STestTags makeTags(tb_uid_t uid) {
+    STestTags tags;
+    tags.t1Null = (uid % 5 == 0);
+    tags.t1 = uid * 10;
+    tags.t2Null = (uid % 7 == 0);
+    tags.t2 = "tag" + std::to_string(uid);
+    return tags;
+  }
+};
+
+TEST_F(MetaTest, tag_cols_create_alter_drop_child) {
+  for (tb_uid_t uid = 1000; uid < 1100; ++uid) {
+    createTable(uid, makeTags(uid));
+  }
+  checkTagCols();
+
+  // the store is kept up to date once built
+  for (tb_uid_t uid = 1000; uid < 1100; uid += 3) {
+    setT1(uid, -uid);
+  }
+  setT2(1001, "a longer value");
+  setT2(1002, "");
+  alterTag(1003, "t2", TSDB_DATA_TYPE_VARCHAR, NULL, 0);
+  expect[1003].t2Null = true;
+  checkTagCols();
+
+  for (tb_uid_t uid = 1000; uid < 1100; uid += 2) {
+    dropTable(uid);
+  }
+  checkTagCols();
+
+  // the rows of the dropped tables are reused
+  for (tb_uid_t uid = 2000; uid < 2060; ++uid) {
+    createTable(uid, makeTags(uid));
+  }
+  createTable(1000, makeTags(7));
+  checkTagCols();
+}
+
+TEST_F(MetaTest, tag_cols_uid_list) {
+  for (tb_uid_t uid = 1; uid <= 20; ++uid) {
+    createTable(uid, makeTags(uid));
+  }
+  checkTagCols();
+  dropTable(4);
+
+  // the dropped tables are removed from the list, the order of the list is kept
+  std::vector<tb_uid_t> uids = {17, 4, 3, 9, 100};
+  SArray               *uidList = taosArrayInit(uids.size(), sizeof(tb_uid_t));
+  for (auto uid : uids) {
+    taosArrayPush(uidList, &uid);
+  }
+
+  // the tags are filled in the order of the block, a tag not in the store is NULL
+  SSDataBlock *pBlock = createTagBlock({{4, TSDB_DATA_TYPE_VARCHAR}, {3, TSDB_DATA_TYPE_INT}, {6, TSDB_DATA_TYPE_INT}});
+  ASSERT_EQ(metaGetTableTagCols(pVnode->pMeta, kSuid, uidList, pBlock), TSDB_CODE_SUCCESS);
+  ASSERT_EQ(taosArrayGetSize(uidList), 3);
+
+  std::vector<tb_uid_t> left = {17, 3, 9};
+  SColumnInfoData      *pT2 = (SColumnInfoData *)taosArrayGet(pBlock->pDataBlock, 1);
+  SColumnInfoData      *pT1 = (SColumnInfoData *)taosArrayGet(pBlock->pDataBlock, 2);
+  SColumnInfoData      *pT3 = (SColumnInfoData *)taosArrayGet(pBlock->pDataBlock, 3);
+  for (int32_t i = 0; i < left.size(); ++i) {
+    STestTags tags = makeTags(left[i]);
+    ASSERT_EQ(*(tb_uid_t *)taosArrayGet(uidList, i), left[i]);
+    ASSERT_EQ(*(int32_t *)colDataGetData(pT1, i), tags.t1);
+    ASSERT_EQ(colDataIsNull_s(pT2, i), tags.t2Null);
+    ASSERT_TRUE(colDataIsNull_s(pT3, i));
+  }
+
+  blockDataDestroy(pBlock);
+  taosArrayDestroy(uidList);
+}
+
+TEST_F(MetaTest, tag_cols_alter_drop_stable) {
+  for (tb_uid_t uid = 1; uid <= 50; ++uid) {
+    createTable(uid, makeTags(uid));
+  }
+  checkTagCols();
+
+  // the store is built again with the new tag schema, the new tag is NULL in the existing tables
+  createSuperTable(2, true);
+  SArray      *uidList = taosArrayInit(8, sizeof(tb_uid_t));
+  SSDataBlock *pBlock = createTagBlock({{3, TSDB_DATA_TYPE_INT}, {4, TSDB_DATA_TYPE_VARCHAR}, {5, TSDB_DATA_TYPE_INT}});
+  ASSERT_EQ(metaGetTableTagCols(pVnode->pMeta, kSuid, uidList, pBlock), TSDB_CODE_SUCCESS);
+  ASSERT_EQ(taosArrayGetSize(uidList), 50);
+  SColumnInfoData *pT3 = (SColumnInfoData *)taosArrayGet(pBlock->pDataBlock, 3);
+  for (int32_t i = 0; i < 50; ++i) {
+    ASSERT_TRUE(colDataIsNull_s(pT3, i));
+  }
+  blockDataDestroy(pBlock);
+  taosArrayDestroy(uidList);
+
+  int32_t t3 = 33;
+  alterTag(10, "t3", TSDB_DATA_TYPE_INT, &t3, sizeof(t3));
+  checkTagCols();
+
+  // the store goes away with the super table
+  SArray      *tbUidList = taosArrayInit(8, sizeof(tb_uid_t));
+  SVDropStbReq req = {.name = (char *)"stb", .suid = kSuid};
+  ASSERT_EQ(metaDropSTable(pVnode->pMeta, ++version, &req, tbUidList), 0);
+  ASSERT_EQ(taosArrayGetSize(tbUidList), 50);
+  taosArrayDestroy(tbUidList);
+
+  uidList = taosArrayInit(8, sizeof(tb_uid_t));
+  pBlock = createTagBlock({{3, TSDB_DATA_TYPE_INT}, {4, TSDB_DATA_TYPE_VARCHAR}});
+  ASSERT_NE(metaGetTableTagCols(pVnode->pMeta, kSuid, uidList, pBlock), TSDB_CODE_SUCCESS);
+  blockDataDestroy(pBlock);
+  taosArrayDestroy(uidList);
+
+  // and a super table of the same uid starts from an empty store
+  expect.clear();
+  createSuperTable(1);
+  checkTagCols();
+  createTable(7, makeTags(8));
+  checkTagCols();
+}
+
+TEST_F(MetaTest, tag_cols_var_garbage) {
+  for (tb_uid_t uid = 1; uid <= 10; ++uid) {
+    createTable(uid, makeTags(uid));
+  }
+  checkTagCols();
+
+  // each update leaves the old var data behind until the store is rebuilt
+  for (int32_t i = 0; i < 200; ++i) {
+    tb_uid_t uid = 1 + i % 10;
+    setT2(uid, std::string(1 + i % 16, 'a' + i % 26));
+    if (i % 37 == 0) {
+      checkTagCols();
+    }
+  }
+  checkTagCols();
+}
+
+TEST_F(MetaTest, tag_cols_cache_size) {
+  for (tb_uid_t uid = 1; uid <= 30; ++uid) {
+    createTable(uid, makeTags(uid));
+  }
+
+  // disabled, the caller falls back to decode the tags of each table
+  tsTagColCacheSize = 0;
+  SArray      *uidList = taosArrayInit(8, sizeof(tb_uid_t));
+  SSDataBlock *pBlock = createTagBlock({{3, TSDB_DATA_TYPE_INT}, {4, TSDB_DATA_TYPE_VARCHAR}});
+  ASSERT_EQ(metaGetTableTagCols(pVnode->pMeta, kSuid, uidList, pBlock), TSDB_CODE_OPS_NOT_SUPPORT);
+  ASSERT_EQ(taosArrayGetSize(uidList), 0);
+  blockDataDestroy(pBlock);
+  taosArrayDestroy(uidList);
+
+  tsTagColCacheSize = 1;
+  checkTagCols();
+
+  // a store that outgrows the cache is dropped and then only built for each query
+  for (tb_uid_t uid = 1000; uid < 1000 + 30000; ++uid) {
+    createTable(uid, makeTags(uid));
+  }
+  checkTagCols();
+  setT1(1000, 1);
+  dropTable(1001);
+  checkTagCols();
+
+  tsTagColCacheSize = tagColCacheSize;
+  checkTagCols();
+  setT2(1002, "kept");
+  checkTagCols();
+}
+
+#pragma GCC diagnostic pop
@@ -0,0 +1,510 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "sma.h"
+#include "vnodeTestUtil.h"
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wwrite-strings"
+#pragma GCC diagnostic ignored "-Wsign-compare"
+
+// A vnode with just meta open and a super table (ts, c1 int, c2 double, c3 bigint, c4 smallint unsigned, c5 float,
+// c6 tinyint) of two child tables. Submits of the children are decoded through the tq reader and rolled up by
+// SRSmaAgg, the windows it emits are checked against the ones computed row by row here.
+class RSmaAggTest : public VnodeMetaTest {
+ protected:
+  static constexpr tb_uid_t kSuid = 100;
+  static constexpr tb_uid_t kUid1 = 101;
+  static constexpr tb_uid_t kUid2 = 102;
+  static constexpr int32_t  kNumOfCols = 7;
+  static constexpr int64_t  kInterval = 1000;  // ms
+  static constexpr int64_t  kBaseTs = 1660000000000;
+
+  struct SRow {
+    tb_uid_t uid;
+    int64_t  ts;
+    int32_t  s;  // seed of the values
+    int32_t  r;
+  };
+
+  // the running aggregate of one column of one window, computed row by row
+  struct SAcc {
+    int64_t cnt = 0;
+    double  sum = 0;
+    double  min = 0;
+    double  max = 0;
+    int64_t firstTs = INT64_MAX;
+    double  first = 0;
+    int64_t lastTs = INT64_MIN;
+    double  last = 0;
+  };
+
+  typedef std::pair<tb_uid_t, int64_t>             SKey;  // uid, window start
+  typedef std::map<SKey, std::vector<SAcc>>        SExpect;
+  typedef std::map<SKey, std::vector<std::string>> SResult;  // a value per column, "NULL" for null
+
+  STqReader    *pReader = nullptr;
+  STSchema     *pTSchema = nullptr;
+  SStreamState *pState = nullptr;
+
+  RSmaAggTest() : VnodeMetaTest(TD_TMP_DIR_PATH "rsmaTest") {}
+
+  void SetUp() override {
+    VnodeMetaTest::SetUp();
+    if (HasFatalFailure()) return;
+
+    SSchema schemaRow[kNumOfCols] = {{.type = TSDB_DATA_TYPE_TIMESTAMP, .colId = 1, .bytes = 8, .name = "ts"},
+                                     {.type = TSDB_DATA_TYPE_INT, .colId = 2, .bytes = 4, .name = "c1"},
+                                     {.type = TSDB_DATA_TYPE_DOUBLE, .colId = 3, .bytes = 8, .name = "c2"},
+                                     {.type = TSDB_DATA_TYPE_BIGINT, .colId = 4, .bytes = 8, .name = "c3"},
+                                     {.type = TSDB_DATA_TYPE_USMALLINT, .colId = 5, .bytes = 2, .name = "c4"},
+                                     {.type = TSDB_DATA_TYPE_FLOAT, .colId = 6, .bytes = 4, .name = "c5"},
+                                     {.type = TSDB_DATA_TYPE_TINYINT, .colId = 7, .bytes = 1, .name = "c6"}};
+    SSchema schemaTag[1] = {{.type = TSDB_DATA_TYPE_INT, .colId = 8, .bytes = 4, .name = "t1"}};
+    SVCreateStbReq req = {0};
+    req.name = (char *)"stb";
+    req.suid = kSuid;
+    req.schemaRow = {.nCols = kNumOfCols, .version = 1, .pSchema = schemaRow};
+    req.schemaTag = {.nCols = 1, .version = 1, .pSchema = schemaTag};
+    ASSERT_EQ(metaCreateSTable(pVnode->pMeta, ++version, &req), 0);
+    for (tb_uid_t uid : {kUid1, kUid2}) {
+      createTable(uid, kSuid, {{.cid = 8, .type = TSDB_DATA_TYPE_INT, .i64 = uid}});
+    }
+    pTSchema = metaGetTbTSchema(pVnode->pMeta, kSuid, -1, 1);
+    ASSERT_NE(pTSchema, nullptr);
+
+    // the reader is only fed submit messages here, so it goes without a wal reader
+    pReader = (STqReader *)taosMemoryCalloc(1, sizeof(STqReader));
+    pReader->pVnodeMeta = pVnode->pMeta;
+  }
+
+  void TearDown() override {
+    if (pState) streamStateClose(pState);
+    if (pReader) tqCloseReader(pReader);
+    taosMemoryFree(pTSchema);
+    VnodeMetaTest::TearDown();
+  }
+
+  void openState() {
+    char path[TSDB_FILENAME_LEN];
+    snprintf(path, sizeof(path), "%s%srsma", kDir, TD_DIRSEP);
+    pState = streamStateOpen(path, NULL, true, -1, -1);
+    ASSERT_NE(pState, nullptr);
+  }
+
+  void closeState() {
+    streamStateClose(pState);
+    pState = nullptr;
+  }
+
+  static SRollupInfo rollupInfo(const char *funcName, int64_t watermark = 0) {
+    SRollupInfo info = {0};
+    info.interval = {.intervalUnit = 'a',
+                     .slidingUnit = 'a',
+                     .precision = TSDB_TIME_PRECISION_MILLI,
+                     .interval = kInterval,
+                     .sliding = kInterval};
+    info.watermark = watermark;
+    info.deleteMark = TSDB_DEFAULT_ROLLUP_DELETE_MARK;
+    info.pFuncs = taosArrayInit(kNumOfCols - 1, sizeof(SRollupFunc));
+    for (int32_t iCol = 1; iCol < kNumOfCols; ++iCol) {
+      SRollupFunc func = {.colId = (col_id_t)(iCol + 1)};
+      tstrncpy(func.funcName, funcName, sizeof(func.funcName));
+      taosArrayPush(info.pFuncs, &func);
+    }
+    return info;
+  }
+
+  SRSmaAgg *createAgg(const SRollupInfo &info) {
+    SRSmaAgg *pAgg = nullptr;
+    EXPECT_EQ(tdRSmaAggCreate(&pAgg, pTSchema, &info, pState), 0);
+    taosArrayDestroy(info.pFuncs);
+    return pAgg;
+  }
+
+  // c6 is null all over the submits of seed 1, so some of its windows have only null values
+  static bool cellIsNull(int32_t iCol, const SRow &row) {
+    return (row.r + iCol + row.s) % 7 == 0 || (iCol == 6 && row.s == 1);
+  }
+
+  static double cellVal(int32_t iCol, const SRow &row) {
+    switch (iCol) {
+      case 1:
+        return (row.r * 13 + row.s) % 101 - 50;
+      case 2:
+        return row.r * 0.25 - row.s;
+      case 3:
+        return (double)(row.r - 25) * 1000000007LL;
+      case 4:
+        return (row.r * 7 + row.s) % 1000;
+      case 5:
+        return row.r * 0.5 - 3;
+      default:
+        return row.r % 50 - 25;
+    }
+  }
+
+  // nRows rows of each of the tables, their timestamps shuffled and spread over 3 windows from the seed * 2500ms on
+  static std::vector<SRow> genRows(int32_t s, int32_t nRows = 50) {
+    std::vector<SRow> rows;
+    for (tb_uid_t uid : {kUid1, kUid2}) {
+      for (int32_t r = 0; r < nRows; ++r) {
+        rows.push_back({uid, kBaseTs + s * 2500 + ((r * 37) % nRows) * 60, s, r});
+      }
+    }
+    return rows;
+  }
+
+  void appendCell(SRowBuilder *pBuilder, int32_t iCol, const SRow &row) {
+    if (iCol > 0 && cellIsNull(iCol, row)) {
+      VnodeMetaTest::appendCell(pBuilder, pTSchema, iCol, iCol, NULL);
+      return;
+    }
+
+    double   v = cellVal(iCol, row);
+    int8_t   i8 = (int8_t)v;
+    uint16_t u16 = (uint16_t)v;
+    int32_t  i32 = (int32_t)v;
+    int64_t  i64 = (iCol == 0) ? row.ts : (int64_t)v;
+    float    f = (float)v;
+    void    *pVal = &i64;
+    switch (pTSchema->columns[iCol].type) {
+      case TSDB_DATA_TYPE_TINYINT:
+        pVal = &i8;
+        break;
+      case TSDB_DATA_TYPE_USMALLINT:
+        pVal = &u16;
+        break;
+      case TSDB_DATA_TYPE_INT:
+        pVal = &i32;
+        break;
+      case TSDB_DATA_TYPE_FLOAT:
+        pVal = &f;
+        break;
+      case TSDB_DATA_TYPE_DOUBLE:
+        pVal = &v;
+        break;
+      default:
+        break;
+    }
+    VnodeMetaTest::appendCell(pBuilder, pTSchema, iCol, iCol, pVal);
+  }
+
+  // a submit of a block per table, the rows of a table in the order given
+  SSubmitReq *genSubmit(const std::vector<SRow> &rows) {
+    std::vector<STestBlk> blks;
+    for (tb_uid_t uid : {kUid1, kUid2}) {
+      std::vector<const SRow *> tbRows;
+      for (const SRow &row : rows) {
+        if (row.uid == uid) tbRows.push_back(&row);
+      }
+      auto buildRow = [this, tbRows](STSRow *pRow, int32_t r) {
+        SRowBuilder rb = {0};
+        tdSRowInit(&rb, pTSchema->version);
+        tdSRowSetTpInfo(&rb, pTSchema->numOfCols, pTSchema->flen);
+        tdSRowResetBuf(&rb, pRow);
+        for (int32_t iCol = 0; iCol < kNumOfCols; ++iCol) {
+          appendCell(&rb, iCol, *tbRows[r]);
+        }
+        tdSRowEnd(&rb);
+      };
+      blks.push_back({uid, kSuid, (int32_t)tbRows.size(), buildRow});
+    }
+
+    SSubmitReq *pMsg = VnodeMetaTest::genSubmit(pTSchema, blks);
+    pMsg->version = ++version;
+    return pMsg;
+  }
+
+  void feed(SRSmaAgg *pAgg, const std::vector<SRow> &rows) {
+    SSubmitReq *pMsg = genSubmit(rows);
+    ASSERT_EQ(tqReaderSetDataMsg(pReader, pMsg, pMsg->version), 0);
+    while (tqNextDataBlock(pReader)) {
+      SSDataBlock block = {0};
+      ASSERT_EQ(tqRetrieveDataBlock(&block, pReader), 0);
+      ASSERT_EQ(tdRSmaAggProcess(pAgg, &block), 0);
+      blockDataFreeRes(&block);
+    }
+    taosMemoryFree(pMsg);
+  }
+
+  // the windows emitted, later results of a window replace the earlier ones as they do in the tsdb
+  void collect(SRSmaAgg *pAgg, bool fetchAll, SResult &result, int64_t *pMaxWEnd = nullptr) {
+    SArray *pResList = taosArrayInit(1, POINTER_BYTES);
+    ASSERT_EQ(tdRSmaAggGetResult(pAgg, fetchAll, pResList), 0);
+    for (int32_t i = 0; i < taosArrayGetSize(pResList); ++i) {
+      SSDataBlock *pBlock = (SSDataBlock *)taosArrayGetP(pResList, i);
+      ASSERT_EQ(pBlock->info.id.groupId, pBlock->info.id.uid);
+      ASSERT_EQ(pBlock->info.version, version);
+      ASSERT_EQ(blockDataGetNumOfCols(pBlock), (size_t)kNumOfCols);
+      SColumnInfoData *pTsCol = (SColumnInfoData *)taosArrayGet(pBlock->pDataBlock, 0);
+      for (int32_t r = 0; r < pBlock->info.rows; ++r) {
+        int64_t                  ts = ((int64_t *)pTsCol->pData)[r];
+        std::vector<std::string> vals;
+        for (int32_t iCol = 1; iCol < kNumOfCols; ++iCol) {
+          SColumnInfoData *pColData = (SColumnInfoData *)taosArrayGet(pBlock->pDataBlock, iCol);
+          if (colDataIsNull(pColData, pBlock->info.rows, r, NULL)) {
+            vals.push_back("NULL");
+          } else {
+            double v = 0;
+            GET_TYPED_DATA(v, double, pColData->info.type, colDataGetData(pColData, r));
+            vals.push_back(std::to_string(v));
+          }
+        }
+        result[{(tb_uid_t)pBlock->info.id.uid, ts}] = vals;
+        if (pMaxWEnd && ts + kInterval - 1 > *pMaxWEnd) *pMaxWEnd = ts + kInterval - 1;
+      }
+      blockDataDestroy(pBlock);
+    }
+    taosArrayDestroy(pResList);
+  }
+
+  static void accumulate(SExpect &expect, const std::vector<SRow> &rows) {
+    for (const SRow &row : rows) {
+      std::vector<SAcc> &accs = expect[{row.uid, row.ts - (row.ts % kInterval)}];
+      accs.resize(kNumOfCols);
+      for (int32_t iCol = 1; iCol < kNumOfCols; ++iCol) {
+        if (cellIsNull(iCol, row)) continue;
+        SAcc  &acc = accs[iCol];
+        double v = cellVal(iCol, row);
+        acc.sum += v;
+        acc.min = (acc.cnt == 0 || v < acc.min) ? v : acc.min;
+        acc.max = (acc.cnt == 0 || v > acc.max) ? v : acc.max;
+        if (row.ts < acc.firstTs) {
+          acc.firstTs = row.ts;
+          acc.first = v;
+        }
+        if (row.ts > acc.lastTs) {
+          acc.lastTs = row.ts;
+          acc.last = v;
+        }
+        ++acc.cnt;
+      }
+    }
+  }
+
+  static void check(const SExpect &expect, const SResult &result, const std::string &func) {
+    ASSERT_EQ(result.size(), expect.size());
+    for (const auto &it : expect) {
+      auto res = result.find(it.first);
+      ASSERT_NE(res, result.end()) << "uid " << it.first.first << " window " << it.first.second;
+      for (int32_t iCol = 1; iCol < kNumOfCols; ++iCol) {
+        const SAcc &acc = it.second[iCol];
+        std::string val = "NULL";
+        if (func == "count") {
+          val = std::to_string((double)acc.cnt);
+        } else if (acc.cnt > 0) {
+          double v = func == "sum" ? acc.sum
+                     : func == "min" ? acc.min
+                     : func == "max" ? acc.max
+                     : func == "first" ? acc.first
+                                       : acc.last;
+          val = std::to_string(v);
+        }
+        ASSERT_EQ(res->second[iCol - 1], val)
+            << func << " of c" << iCol << " uid " << it.first.first << " window " << it.first.second;
+      }
+    }
+  }
+};
+
+// Late rows of each submit fall into the windows the submit before closed, so the closed windows are emitted again
+TEST_F(RSmaAggTest, aggregate) {
+  for (const char *func : {"sum", "count", "min", "max", "first", "last"}) {
+    SRSmaAgg *pAgg = createAgg(rollupInfo(func));
+    ASSERT_NE(pAgg, nullptr);
+
+    SExpect expect;
+    SResult result;
+    int64_t maxTs = INT64_MIN;
+    for (int32_t s = 0; s < 4; ++s) {
+      std::vector<SRow> rows = genRows(s);
+      feed(pAgg, rows);
+      accumulate(expect, rows);
+      for (const SRow &row : rows) maxTs = TMAX(maxTs, row.ts);
+
+      int64_t maxWEnd = INT64_MIN;
+      collect(pAgg, false, result, &maxWEnd);
+      ASSERT_LT(maxWEnd, maxTs) << func << " emits a window not closed yet";
+    }
+    ASSERT_LT(result.size(), expect.size());
+
+    collect(pAgg, true, result);
+    check(expect, result, func);
+    tdRSmaAggDestroy(pAgg);
+  }
+}
+
+// The windows are emitted once they end before the max timestamp minus the watermark, or all of them by fetch all
+TEST_F(RSmaAggTest, watermark) {
+  SRSmaAgg *pAgg = createAgg(rollupInfo("sum", 2 * kInterval));
+  SResult   result;
+
+  feed(pAgg, genRows(0));  // up to 2940ms
+  collect(pAgg, false, result);
+  ASSERT_EQ(result.size(), 0);
+
+  feed(pAgg, genRows(1));  // up to 5440ms, so the window of 2000ms is closed
+  collect(pAgg, false, result);
+  ASSERT_EQ(result.size(), 2 * 3);
+
+  collect(pAgg, true, result);
+  ASSERT_EQ(result.size(), 2 * 6);
+
+  // fetch all does not take the open windows from the pending ones, so those of 3000ms to 5000ms are emitted again
+  // along with the one of 7000ms
+  result.clear();
+  feed(pAgg, genRows(3));  // up to 10440ms
+  collect(pAgg, false, result);
+  ASSERT_EQ(result.size(), 2 * 4);
+  ASSERT_NE(result.find({(tb_uid_t)kUid1, kBaseTs + 3000}), result.end());
+  tdRSmaAggDestroy(pAgg);
+}
+
+// Late rows of closed windows are dropped when the expired data is ignored
+TEST_F(RSmaAggTest, ignore_expired) {
+  SRollupInfo info = rollupInfo("count");
+  info.igExpired = true;
+  SRSmaAgg *pAgg = createAgg(info);
+  SExpect   expect;
+  SResult   result;
+
+  std::vector<SRow> rows = genRows(0);
+  feed(pAgg, rows);
+  accumulate(expect, rows);
+  collect(pAgg, false, result);
+
+  // the rows up to 2500ms are late and fall into closed windows, the others into the one still open
+  rows = genRows(1);
+  feed(pAgg, rows);
+  std::vector<SRow> kept;
+  for (const SRow &row : rows) {
+    if (row.ts >= kBaseTs + 2000) kept.push_back(row);
+  }
+  accumulate(expect, kept);
+  collect(pAgg, true, result);
+  check(expect, result, "count");
+  tdRSmaAggDestroy(pAgg);
+}
+
+// The state is saved at persist and restored at create, the closed windows are evicted from memory and loaded back
+// for late rows
+TEST_F(RSmaAggTest, persist_restore) {
+  openState();
+  SRSmaAgg *pAgg = createAgg(rollupInfo("sum"));
+  SExpect   expect;
+  SResult   result;
+
+  for (int32_t s = 0; s < 2; ++s) {
+    std::vector<SRow> rows = genRows(s);
+    feed(pAgg, rows);
+    accumulate(expect, rows);
+    collect(pAgg, false, result);
+  }
+  ASSERT_EQ(tdRSmaAggPersist(pAgg), 0);
+  ASSERT_EQ(streamStateCommit(pState), 0);
+  tdRSmaAggDestroy(pAgg);
+  closeState();
+
+  // the windows pending at persist are emitted once closed after the restore
+  openState();
+  pAgg = createAgg(rollupInfo("sum"));
+  ASSERT_NE(pAgg, nullptr);
+  std::vector<SRow> rows = genRows(3);
+  feed(pAgg, rows);
+  accumulate(expect, rows);
+  collect(pAgg, false, result);
+  for (const auto &it : expect) {
+    if (it.first.second + kInterval < kBaseTs + 7500) {
+      ASSERT_NE(result.find(it.first), result.end()) << "window " << it.first.second;
+    }
+  }
+
+  // late rows of the windows saved before the restore
+  rows = genRows(0, 10);
+  for (SRow &row : rows) row.s = 5;
+  feed(pAgg, rows);
+  accumulate(expect, rows);
+  collect(pAgg, true, result);
+  check(expect, result, "sum");
+
+  // and of the windows evicted at persist
+  ASSERT_EQ(tdRSmaAggPersist(pAgg), 0);
+  rows = genRows(1, 10);
+  for (SRow &row : rows) row.s = 6;
+  feed(pAgg, rows);
+  accumulate(expect, rows);
+  collect(pAgg, true, result);
+  check(expect, result, "sum");
+  tdRSmaAggDestroy(pAgg);
+}
+
+// The state of a window is dropped once it ends before the max timestamp minus the delete mark, so are its late rows
+TEST_F(RSmaAggTest, delete_mark) {
+  SRollupInfo info = rollupInfo("count");
+  info.deleteMark = 3 * kInterval;
+  SRSmaAgg *pAgg = createAgg(info);
+  SExpect   expect;
+  SResult   result;
+
+  for (int32_t s : {0, 2}) {
+    std::vector<SRow> rows = genRows(s);
+    feed(pAgg, rows);
+    accumulate(expect, rows);
+    collect(pAgg, false, result);
+  }
+
+  // up to 7940ms, the windows before 4000ms are deleted
+  std::vector<SRow> rows = genRows(1);
+  for (SRow &row : rows) row.s = 7;
+  feed(pAgg, rows);
+  std::vector<SRow> kept;
+  for (const SRow &row : rows) {
+    if (row.ts >= kBaseTs + 4000) kept.push_back(row);
+  }
+  accumulate(expect, kept);
+  collect(pAgg, true, result);
+  check(expect, result, "count");
+  tdRSmaAggDestroy(pAgg);
+}
+
+// The rollup falls back to the stream task for the functions or windows not computed in place
+TEST_F(RSmaAggTest, not_supported) {
+  SRSmaAgg   *pAgg = nullptr;
+  SRollupInfo info = rollupInfo("avg");
+  ASSERT_EQ(tdRSmaAggCreate(&pAgg, pTSchema, &info, NULL), TSDB_CODE_OPS_NOT_SUPPORT);
+  ASSERT_EQ(pAgg, nullptr);
+  taosArrayDestroy(info.pFuncs);
+
+  info = rollupInfo("sum");
+  info.interval.sliding = kInterval / 2;
+  ASSERT_EQ(tdRSmaAggCreate(&pAgg, pTSchema, &info, NULL), TSDB_CODE_OPS_NOT_SUPPORT);
+  taosArrayDestroy(info.pFuncs);
+
+  // the functions must follow the columns of the table
+  info = rollupInfo("sum");
+  ((SRollupFunc *)taosArrayGet(info.pFuncs, 0))->colId = 3;
+  ASSERT_EQ(tdRSmaAggCreate(&pAgg, pTSchema, &info, NULL), TSDB_CODE_OPS_NOT_SUPPORT);
+  taosArrayDestroy(info.pFuncs);
+}
+
+#pragma GCC diagnostic pop
@@ -0,0 +1,314 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "vnodeTestUtil.h"
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wwrite-strings"
+#pragma GCC diagnostic ignored "-Wsign-compare"
+
+// A vnode with just meta open and a normal table (ts, c1 int, c2 double, c3 varchar(16), c4 bigint). Submit blocks
+// of that table are decoded through tqRetrieveDataBlock and the columns are checked cell by cell against the rows.
+class TqReaderTest : public VnodeMetaTest {
+ protected:
+  static constexpr tb_uid_t kUid = 200;
+  static constexpr int32_t  kNumOfCols = 5;
+
+  STqReader *pReader = nullptr;
+  STSchema  *pTSchema = nullptr;
+
+  TqReaderTest() : VnodeMetaTest(TD_TMP_DIR_PATH "tqTest") {}
+
+  void SetUp() override {
+    VnodeMetaTest::SetUp();
+    if (HasFatalFailure()) return;
+
+    SSchema schemaRow[kNumOfCols] = {
+        {.type = TSDB_DATA_TYPE_TIMESTAMP, .colId = 1, .bytes = 8, .name = "ts"},
+        {.type = TSDB_DATA_TYPE_INT, .colId = 2, .bytes = 4, .name = "c1"},
+        {.type = TSDB_DATA_TYPE_DOUBLE, .colId = 3, .bytes = 8, .name = "c2"},
+        {.type = TSDB_DATA_TYPE_VARCHAR, .colId = 4, .bytes = 16 + VARSTR_HEADER_SIZE, .name = "c3"},
+        {.type = TSDB_DATA_TYPE_BIGINT, .colId = 5, .bytes = 8, .name = "c4"}};
+    SVCreateTbReq req = {0};
+    req.name = (char *)"ntb";
+    req.uid = kUid;
+    req.type = TSDB_NORMAL_TABLE;
+    req.ntb.schemaRow = {.nCols = kNumOfCols, .version = 1, .pSchema = schemaRow};
+    ASSERT_EQ(metaCreateTable(pVnode->pMeta, ++version, &req, NULL), 0);
+    ASSERT_EQ(metaGetTbTSchemaEx(pVnode->pMeta, 0, kUid, -1, &pTSchema), 0);
+
+    // the reader is only fed submit messages here, so it goes without a wal reader
+    pReader = (STqReader *)taosMemoryCalloc(1, sizeof(STqReader));
+    pReader->pVnodeMeta = pVnode->pMeta;
+  }
+
+  void TearDown() override {
+    if (pReader) tqCloseReader(pReader);
+    taosMemoryFree(pTSchema);
+    VnodeMetaTest::TearDown();
+  }
+
+  // kv rows carry only ts, c1 and c3, so c2 and c4 are missing from them
+  static bool isKvRow(int32_t r) { return r % 2 == 1; }
+  static bool inKvRow(int32_t iCol) { return iCol == 0 || iCol == 1 || iCol == 3; }
+
+  static bool cellIsNull(int32_t iCol, int32_t r) {
+    if (isKvRow(r) && !inKvRow(iCol)) return true;
+    switch (iCol) {
+      case 1:
+        return r % 3 == 1;
+      case 2:
+        return r % 4 == 2;
+      case 3:
+        return r % 5 == 3;
+      case 4:
+        return r % 7 == 4;
+      default:
+        return false;
+    }
+  }
+
+  static int64_t cellInt(int32_t iCol, int32_t r) {
+    switch (iCol) {
+      case 0:
+        return 1660000000000 + r;
+      case 1:
+        return r * 10;
+      default:
+        return -r;
+    }
+  }
+  static double      cellDouble(int32_t r) { return r * 0.5; }
+  static std::string cellStr(int32_t r) { return "row" + std::to_string(r); }
+
+  // the value of a cell as it is bound, held in *pCell
+  struct SCell {
+    int64_t i64;
+    int32_t i32;
+    double  d;
+    char    varBuf[32];
+  };
+  const void *cellValue(int32_t iCol, int32_t r, SCell *pCell) {
+    int8_t type = pTSchema->columns[iCol].type;
+    pCell->i64 = cellInt(iCol, r);
+    pCell->i32 = (int32_t)pCell->i64;
+    pCell->d = cellDouble(r);
+    if (type == TSDB_DATA_TYPE_INT) {
+      return &pCell->i32;
+    } else if (type == TSDB_DATA_TYPE_DOUBLE) {
+      return &pCell->d;
+    } else if (IS_VAR_DATA_TYPE(type)) {
+      std::string s = cellStr(r);
+      STR_WITH_SIZE_TO_VARSTR(pCell->varBuf, s.data(), s.size());
+      return pCell->varBuf;
+    }
+    return &pCell->i64;
+  }
+
+  void appendCell(SRowBuilder *pBuilder, int32_t iCol, int32_t k, int32_t r) {
+    SCell cell;
+    VnodeMetaTest::appendCell(pBuilder, pTSchema, iCol, k, cellIsNull(iCol, r) ? NULL : cellValue(iCol, r, &cell));
+  }
+
+  // one submit block of nRows rows of the table, tuples and kv rows interleaved
+  SSubmitReq *genSubmit(int32_t nRows) {
+    auto buildRow = [&](STSRow *pRow, int32_t r) {
+      SRowBuilder rb = {0};
+      tdSRowInit(&rb, pTSchema->version);
+      if (isKvRow(r)) {
+        tdSRowSetInfo(&rb, pTSchema->numOfCols, 3, pTSchema->flen);
+        rb.rowType = TD_ROW_KV;
+      } else {
+        tdSRowSetTpInfo(&rb, pTSchema->numOfCols, pTSchema->flen);
+      }
+      tdSRowResetBuf(&rb, pRow);
+      for (int32_t iCol = 0, k = 0; iCol < kNumOfCols; ++iCol) {
+        if (isKvRow(r) && !inKvRow(iCol)) continue;
+        appendCell(&rb, iCol, k++, r);
+      }
+      tdSRowEnd(&rb);
+    };
+    return VnodeMetaTest::genSubmit(pTSchema, {{kUid, 0, nRows, buildRow}});
+  }
+
+  // one columnar submit block of nRows rows of the table, holding the columns cols only
+  SSubmitReq *genColSubmit(int32_t nRows, const std::vector<int32_t> &cols) {
+    SSDataBlock *pBlock = createDataBlock();
+    for (int32_t iCol : cols) {
+      STColumn       *pCol = &pTSchema->columns[iCol];
+      SColumnInfoData colInfo = createColumnInfoData(pCol->type, pCol->bytes, pCol->colId);
+      blockDataAppendColInfo(pBlock, &colInfo);
+    }
+    blockDataEnsureCapacity(pBlock, nRows);
+    for (int32_t i = 0; i < cols.size(); ++i) {
+      SColumnInfoData *pColData = (SColumnInfoData *)taosArrayGet(pBlock->pDataBlock, i);
+      for (int32_t r = 0; r < nRows; ++r) {
+        SCell cell;
+        colDataAppend(pColData, r, (const char *)cellValue(cols[i], r, &cell), cellIsNull(cols[i], r));
+      }
+    }
+    pBlock->info.rows = nRows;
+
+    int32_t     msgLen = sizeof(SSubmitReq) + sizeof(SSubmitBlk) + tGetSubmitColBlkSize(pBlock);
+    SSubmitReq *pMsg = (SSubmitReq *)taosMemoryCalloc(1, msgLen);
+    SSubmitBlk *pBlk = (SSubmitBlk *)POINTER_SHIFT(pMsg, sizeof(SSubmitReq));
+    int32_t     dataLen = tEncodeSubmitColBlk(pBlock, pBlk->data);
+    blockDataDestroy(pBlock);
+
+    pBlk->uid = htobe64(kUid);
+    pBlk->suid = 0;
+    pBlk->sversion = htonl(pTSchema->version);
+    pBlk->dataLen = htonl(dataLen);
+    pBlk->numOfRows = htonl(nRows);
+    pMsg->length = htonl(sizeof(SSubmitReq) + sizeof(SSubmitBlk) + dataLen);
+    pMsg->numOfBlocks = htonl(1);
+    return pMsg;
+  }
+
+  void checkBlock(SSDataBlock *pBlock, int32_t nRows, const std::vector<int32_t> &cols) {
+    ASSERT_EQ(pBlock->info.id.uid, (int64_t)kUid);
+    ASSERT_EQ(pBlock->info.rows, nRows);
+    ASSERT_EQ(blockDataGetNumOfCols(pBlock), cols.size());
+
+    for (int32_t i = 0; i < cols.size(); ++i) {
+      int32_t          iCol = cols[i];
+      SColumnInfoData *pColData = (SColumnInfoData *)taosArrayGet(pBlock->pDataBlock, i);
+      ASSERT_EQ(pColData->info.colId, pTSchema->columns[iCol].colId);
+
+      for (int32_t r = 0; r < nRows; ++r) {
+        bool isNull = colDataIsNull(pColData, nRows, r, NULL);
+        ASSERT_EQ(isNull, cellIsNull(iCol, r)) << "row " << r << " col " << iCol;
+        if (isNull) continue;
+
+        char *pData = colDataGetData(pColData, r);
+        switch (pColData->info.type) {
+          case TSDB_DATA_TYPE_INT:
+            ASSERT_EQ(*(int32_t *)pData, cellInt(iCol, r));
+            break;
+          case TSDB_DATA_TYPE_DOUBLE:
+            ASSERT_EQ(*(double *)pData, cellDouble(r));
+            break;
+          case TSDB_DATA_TYPE_VARCHAR:
+            ASSERT_EQ(std::string(varDataVal(pData), varDataLen(pData)), cellStr(r));
+            break;
+          default:
+            ASSERT_EQ(*(int64_t *)pData, cellInt(iCol, r)) << "row " << r << " col " << iCol;
+            break;
+        }
+      }
+    }
+  }
+
+  void retrieve(SSubmitReq *pMsg, int32_t nRows, const std::vector<int32_t> &cols) {
+    SSDataBlock block = {0};
+    ASSERT_EQ(tqReaderSetDataMsg(pReader, pMsg, version), 0);
+    ASSERT_TRUE(tqNextDataBlock(pReader));
+    ASSERT_EQ(tqRetrieveDataBlock(&block, pReader), 0);
+    checkBlock(&block, nRows, cols);
+    blockDataFreeRes(&block);
+    ASSERT_FALSE(tqNextDataBlock(pReader));
+  }
+};
+
+// more rows than are decoded together, so the last batch of rows is a partial one
+TEST_F(TqReaderTest, retrieve_all_cols) {
+  const int32_t nRows = 300;
+  SSubmitReq   *pMsg = genSubmit(nRows);
+  retrieve(pMsg, nRows, {0, 1, 2, 3, 4});
+  taosMemoryFree(pMsg);
+}
+
+TEST_F(TqReaderTest, retrieve_some_cols) {
+  const int32_t nRows = 129;
+  SSubmitReq   *pMsg = genSubmit(nRows);
+
+  SArray *pColIdList = taosArrayInit(3, sizeof(int16_t));
+  for (int16_t colId : {1, 3, 5}) {
+    taosArrayPush(pColIdList, &colId);
+  }
+  tqReaderSetColIdList(pReader, pColIdList);
+  retrieve(pMsg, nRows, {0, 2, 4});
+  taosMemoryFree(pMsg);
+}
+
+TEST_F(TqReaderTest, retrieve_col_blk_all_cols) {
+  const int32_t nRows = 300;
+  SSubmitReq   *pMsg = genColSubmit(nRows, {0, 1, 2, 3, 4});
+  retrieve(pMsg, nRows, {0, 1, 2, 3, 4});
+  taosMemoryFree(pMsg);
+}
+
+// c4 is not in the block, so it is null in every row retrieved
+TEST_F(TqReaderTest, retrieve_col_blk_some_cols) {
+  const int32_t nRows = 129;
+  SSubmitReq   *pMsg = genColSubmit(nRows, {0, 1, 2, 3});
+
+  SArray *pColIdList = taosArrayInit(3, sizeof(int16_t));
+  for (int16_t colId : {1, 3, 5}) {
+    taosArrayPush(pColIdList, &colId);
+  }
+  tqReaderSetColIdList(pReader, pColIdList);
+
+  SSDataBlock block = {0};
+  ASSERT_EQ(tqReaderSetDataMsg(pReader, pMsg, version), 0);
+  ASSERT_TRUE(tqNextDataBlock(pReader));
+  ASSERT_EQ(tqRetrieveDataBlock(&block, pReader), 0);
+  SColumnInfoData *pC4 = (SColumnInfoData *)taosArrayGet(block.pDataBlock, 2);
+  ASSERT_EQ(pC4->info.colId, 5);
+  for (int32_t r = 0; r < nRows; ++r) {
+    ASSERT_TRUE(colDataIsNull(pC4, nRows, r, NULL)) << "row " << r;
+  }
+  taosArrayPop(block.pDataBlock);
+  checkBlock(&block, nRows, {0, 2});
+  colDataDestroy(pC4);
+  blockDataFreeRes(&block);
+  ASSERT_FALSE(tqNextDataBlock(pReader));
+  taosMemoryFree(pMsg);
+}
+
+// the taosx block of a columnar block has the columns of the block, with the schema of them
+TEST_F(TqReaderTest, retrieve_col_blk_taosx) {
+  const int32_t nRows = 50;
+  SSubmitReq   *pMsg = genColSubmit(nRows, {0, 1, 3});
+  SArray       *blocks = taosArrayInit(1, sizeof(SSDataBlock));
+  SArray       *schemas = taosArrayInit(1, sizeof(void *));
+
+  ASSERT_EQ(tqReaderSetDataMsg(pReader, pMsg, version), 0);
+  ASSERT_TRUE(tqNextDataBlock(pReader));
+  ASSERT_EQ(tqRetrieveTaosxBlock(pReader, blocks, schemas), 0);
+  ASSERT_EQ(taosArrayGetSize(blocks), 1);
+  ASSERT_EQ(taosArrayGetSize(schemas), 1);
+
+  SSchemaWrapper *pSW = *(SSchemaWrapper **)taosArrayGet(schemas, 0);
+  ASSERT_EQ(pSW->nCols, 3);
+  for (int32_t i = 0; i < pSW->nCols; ++i) {
+    ASSERT_EQ(pSW->pSchema[i].colId, pTSchema->columns[i == 0 ? 0 : 2 * i - 1].colId);
+  }
+  checkBlock((SSDataBlock *)taosArrayGet(blocks, 0), nRows, {0, 1, 3});
+  ASSERT_FALSE(tqNextDataBlock(pReader));
+
+  blockDataFreeRes((SSDataBlock *)taosArrayGet(blocks, 0));
+  tDeleteSSchemaWrapper(pSW);
+  taosArrayDestroy(blocks);
+  taosArrayDestroy(schemas);
+  taosMemoryFree(pMsg);
+}
+
+#pragma GCC diagnostic pop
@@ -0,0 +1,220 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Insert and scan throughput of one memtable under 1 to N writer threads and as many reader threads.
+// Every writer puts blocks of rows into its own tables, while the readers look up random tables and iterate them
+// from the head, as the queries on the memtable do. Rows are only a timestamp, so the skiplist dominates the cost.
+// usage: tsdbMemTableBench [-t max threads] [-c tables per writer] [-n rows per table] [-b rows per block]
+
+#include "tsdb.h"
+#include "vnd.h"
+
+typedef struct {
+  SMemTable *pMemTable;
+  int32_t    iWriter;
+  int32_t    numOfTables;
+  int32_t    numOfRows;
+  int32_t    blockRows;
+} SWriterArg;
+
+typedef struct {
+  SMemTable      *pMemTable;
+  int32_t         numOfTables;
+  volatile int8_t stop;
+  int64_t         numOfScanned;
+} SReaderArg;
+
+static tb_uid_t benchUid(int32_t iWriter, int32_t numOfTables, int32_t iTable) {
+  return (tb_uid_t)iWriter * numOfTables + iTable + 1;
+}
+
+static void *benchWriter(void *param) {
+  SWriterArg *pArg = param;
+  int32_t     msgLen = sizeof(SSubmitReq) + sizeof(SSubmitBlk) + pArg->blockRows * sizeof(STSRow);
+  SSubmitReq *pMsg = taosMemoryCalloc(1, msgLen);
+  SSubmitBlk *pBlk = POINTER_SHIFT(pMsg, sizeof(SSubmitReq));
+  int64_t     version = 0;
+
+  pMsg->numOfBlocks = htonl(1);
+  pMsg->length = htonl(msgLen);
+  pBlk->numOfRows = htonl(pArg->blockRows);
+  pBlk->dataLen = htonl(pArg->blockRows * sizeof(STSRow));
+
+  for (int32_t iRow = 0; iRow < pArg->numOfRows; iRow += pArg->blockRows) {
+    for (int32_t iTable = 0; iTable < pArg->numOfTables; ++iTable) {
+      pBlk->uid = htobe64(benchUid(pArg->iWriter, pArg->numOfTables, iTable));
+      for (int32_t r = 0; r < pArg->blockRows; ++r) {
+        STSRow *pRow = POINTER_SHIFT(pBlk, sizeof(SSubmitBlk) + r * sizeof(STSRow));
+        pRow->len = sizeof(STSRow);
+        pRow->ts = 1600000000000 + iRow + r;
+      }
+
+      SSubmitMsgIter msgIter = {0};
+      SSubmitBlk    *pBlock = NULL;
+      SSubmitBlkRsp  rsp = {0};
+      tInitSubmitMsgIter(pMsg, &msgIter);
+      tGetSubmitMsgNext(&msgIter, &pBlock);
+      if (tsdbMemTablePut(pArg->pMemTable, ++version, &msgIter, pBlock, &rsp) != 0) {
+        printf("failed to put rows into memtable\n");
+        exit(1);
+      }
+    }
+  }
+
+  taosMemoryFree(pMsg);
+  return NULL;
+}
+
+static void *benchReader(void *param) {
+  SReaderArg *pArg = param;
+  uint32_t    seed = taosSafeRand();
+
+  while (!atomic_load_8(&pArg->stop)) {
+    tb_uid_t uid = taosRandR(&seed) % pArg->numOfTables + 1;
+    STbData *pTbData = tsdbGetTbDataFromMemTable(pArg->pMemTable, 0, uid);
+    if (pTbData == NULL) continue;
+
+    STbDataIter iter = {0};
+    TSKEY       lastTs = TSKEY_MIN;
+    tsdbTbDataIterOpen(pTbData, NULL, 0, &iter);
+    for (TSDBROW *pRow = tsdbTbDataIterGet(&iter); pRow; pRow = tsdbTbDataIterGet(&iter)) {
+      TSKEY ts = TSDBROW_TS(pRow);
+      if (ts < lastTs) {
+        printf("rows out of order in table uid:%" PRId64 "\n", uid);
+        exit(1);
+      }
+      lastTs = ts;
+      pArg->numOfScanned++;
+      tsdbTbDataIterNext(&iter);
+    }
+  }
+
+  return NULL;
+}
+
+static void benchRun(SVnode *pVnode, int32_t numOfThreads, int32_t numOfTables, int32_t numOfRows,
+                     int32_t blockRows) {
+  STsdb      tsdb = {.pVnode = pVnode};
+  SMemTable *pMemTable = NULL;
+
+  // take a buffer pool as vnodeBegin does
+  pVnode->inUse = pVnode->pPool;
+  pVnode->inUse->nRef = 1;
+  pVnode->pPool = pVnode->inUse->next;
+  pVnode->inUse->next = NULL;
+  if (tsdbMemTableCreate(&tsdb, &pMemTable) != 0) {
+    printf("failed to create memtable\n");
+    exit(1);
+  }
+
+  TdThread   *writers = taosMemoryCalloc(numOfThreads, sizeof(TdThread));
+  TdThread   *readers = taosMemoryCalloc(numOfThreads, sizeof(TdThread));
+  SWriterArg *wArgs = taosMemoryCalloc(numOfThreads, sizeof(SWriterArg));
+  SReaderArg *rArgs = taosMemoryCalloc(numOfThreads, sizeof(SReaderArg));
+
+  int64_t start = taosGetTimestampUs();
+  for (int32_t i = 0; i < numOfThreads; ++i) {
+    rArgs[i] = (SReaderArg){.pMemTable = pMemTable, .numOfTables = numOfThreads * numOfTables};
+    taosThreadCreate(&readers[i], NULL, benchReader, &rArgs[i]);
+  }
+  for (int32_t i = 0; i < numOfThreads; ++i) {
+    wArgs[i] = (SWriterArg){.pMemTable = pMemTable,
+                            .iWriter = i,
+                            .numOfTables = numOfTables,
+                            .numOfRows = numOfRows,
+                            .blockRows = blockRows};
+    taosThreadCreate(&writers[i], NULL, benchWriter, &wArgs[i]);
+  }
+  for (int32_t i = 0; i < numOfThreads; ++i) {
+    taosThreadJoin(writers[i], NULL);
+  }
+  int64_t elapsed = TMAX(taosGetTimestampUs() - start, 1);
+
+  int64_t numOfScanned = 0;
+  for (int32_t i = 0; i < numOfThreads; ++i) {
+    atomic_store_8(&rArgs[i].stop, 1);
+    taosThreadJoin(readers[i], NULL);
+    numOfScanned += rArgs[i].numOfScanned;
+  }
+
+  // every row is in place
+  int64_t expected = (int64_t)numOfThreads * numOfTables * (numOfRows / blockRows * blockRows);
+  if (pMemTable->nRow != expected || pMemTable->nTbData != numOfThreads * numOfTables) {
+    printf("unexpected rows:%" PRId64 " tables:%d\n", pMemTable->nRow, pMemTable->nTbData);
+    exit(1);
+  }
+  for (int32_t i = 0; i < numOfThreads * numOfTables; ++i) {
+    STbData *pTbData = tsdbGetTbDataFromMemTable(pMemTable, 0, i + 1);
+    if (pTbData == NULL || tsdbGetNRowsInTbData(pTbData) != numOfRows / blockRows * blockRows) {
+      printf("unexpected rows in table uid:%d\n", i + 1);
+      exit(1);
+    }
+  }
+
+  printf("%8d %16.0f %16.0f\n", numOfThreads, (double)expected * 1000000 / elapsed,
+         (double)numOfScanned * 1000000 / elapsed);
+
+  // hand the pool back as vnodeCommit does
+  vnodeBufPoolUnRef(pVnode->inUse);
+  pVnode->inUse = NULL;
+  tsdbUnrefMemTable(pMemTable);
+  taosMemoryFree(writers);
+  taosMemoryFree(readers);
+  taosMemoryFree(wArgs);
+  taosMemoryFree(rArgs);
+}
+
+int main(int argc, char *argv[]) {
+  int32_t maxThreads = 16;
+  int32_t numOfTables = 100;
+  int32_t numOfRows = 2000;
+  int32_t blockRows = 100;
+
+  for (int32_t i = 1; i < argc - 1; i += 2) {
+    if (strcmp(argv[i], "-t") == 0) {
+      maxThreads = atoi(argv[i + 1]);
+    } else if (strcmp(argv[i], "-c") == 0) {
+      numOfTables = atoi(argv[i + 1]);
+    } else if (strcmp(argv[i], "-n") == 0) {
+      numOfRows = atoi(argv[i + 1]);
+    } else if (strcmp(argv[i], "-b") == 0) {
+      blockRows = atoi(argv[i + 1]);
+    }
+  }
+
+  // the pools of a rsma vnode are locked, as several threads put into its memtables
+  SVnode *pVnode = taosMemoryCalloc(1, sizeof(SVnode));
+  pVnode->config.vgId = 1;
+  pVnode->config.isRsma = 1;
+  pVnode->config.szBuf = (int64_t)3 * 256 * 1024 * 1024;
+  pVnode->config.tsdbCfg.slLevel = 5;
+  taosThreadMutexInit(&pVnode->mutex, NULL);
+  taosThreadCondInit(&pVnode->poolNotEmpty, NULL);
+  if (vnodeOpenBufPool(pVnode) != 0) {
+    printf("failed to open buffer pool\n");
+    return 1;
+  }
+
+  printf("%8s %16s %16s\n", "threads", "rows put/s", "rows scanned/s");
+  for (int32_t threads = 1; threads <= maxThreads; threads *= 2) {
+    benchRun(pVnode, threads, numOfTables, numOfRows, blockRows);
+  }
+
+  vnodeCloseBufPool(pVnode);
+  taosThreadCondDestroy(&pVnode->poolNotEmpty);
+  taosThreadMutexDestroy(&pVnode->mutex);
+  taosMemoryFree(pVnode);
+  return 0;
+}
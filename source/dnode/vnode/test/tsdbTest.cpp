@@ -0,0 +1,725 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include <functional>
+#include <map>
+#include <vector>
+
+#include "tsdb.h"
+#include "vnd.h"
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wwrite-strings"
+#pragma GCC diagnostic ignored "-Wsign-compare"
+
+// A vnode with just meta and tsdb open on a single disk, driven the way vnodeSvr and vnodeCommit drive it.
+// Tables are children of one super table with the schema (ts timestamp, v int).
+class TsdbTest : public ::testing::Test {
+ protected:
+  static constexpr const char *kDir = TD_TMP_DIR_PATH "tsdbTest";
+  static constexpr tb_uid_t    kSuid = 100;
+
+  SVnode *pVnode = nullptr;
+  int64_t version = 0;
+
+  void SetUp() override {
+    taosRemoveDir(kDir);
+    taosMkDir(kDir);
+
+    SDiskCfg diskCfg = {.level = 0, .primary = 1};
+    tstrncpy(diskCfg.dir, kDir, TSDB_FILENAME_LEN);
+
+    pVnode = (SVnode *)taosMemoryCalloc(1, sizeof(SVnode));
+    pVnode->path = tstrdup("vnode2");
+    pVnode->config = vnodeCfgDefault;
+    pVnode->config.vgId = 2;
+    pVnode->config.szBuf = 3 * 16 * 1024 * 1024;
+    pVnode->config.tsdbCfg.minRows = 10;
+    pVnode->config.tsdbCfg.maxRows = 200;
+    pVnode->config.sttTrigger = 8;
+    pVnode->pTfs = tfsOpen(&diskCfg, 1);
+    ASSERT_NE(pVnode->pTfs, nullptr);
+    tfsMkdir(pVnode->pTfs, pVnode->path);
+
+    taosThreadMutexInit(&pVnode->mutex, NULL);
+    taosThreadCondInit(&pVnode->poolNotEmpty, NULL);
+    tsem_init(&pVnode->canCommit, 0, 1);
+    ASSERT_EQ(vnodeOpenBufPool(pVnode), 0);
+    ASSERT_EQ(metaOpen(pVnode, &pVnode->pMeta, 0), 0);
+    ASSERT_EQ(tsdbOpen(pVnode, &pVnode->pTsdb, VNODE_TSDB_DIR, NULL, 0), 0);
+    begin();
+
+    createSuperTable();
+  }
+
+  void TearDown() override {
+    tsdbStopCompact(pVnode->pTsdb);
+    tsdbClose(&pVnode->pTsdb);
+    metaClose(pVnode->pMeta);
+    vnodeBufPoolUnRef(pVnode->inUse);
+    pVnode->inUse = NULL;
+    vnodeCloseBufPool(pVnode);
+    tsem_destroy(&pVnode->canCommit);
+    taosThreadCondDestroy(&pVnode->poolNotEmpty);
+    taosThreadMutexDestroy(&pVnode->mutex);
+    tfsClose(pVnode->pTfs);
+    taosMemoryFree(pVnode->path);
+    taosMemoryFree(pVnode);
+    taosRemoveDir(kDir);
+  }
+
+  // as vnodeBegin does
+  void begin() {
+    taosThreadMutexLock(&pVnode->mutex);
+    pVnode->inUse = pVnode->pPool;
+    pVnode->inUse->nRef = 1;
+    pVnode->pPool = pVnode->inUse->next;
+    pVnode->inUse->next = NULL;
+    taosThreadMutexUnlock(&pVnode->mutex);
+
+    pVnode->state.commitID++;
+    ASSERT_EQ(metaBegin(pVnode->pMeta, META_BEGIN_HEAP_OS), 0);
+    ASSERT_EQ(tsdbBegin(pVnode->pTsdb), 0);
+  }
+
+  // as vnodeAsyncCommit and vnodeCommitImpl do, on the calling thread
+  void commit(bool holdCanCommit = false) {
+    SCommitInfo info = {0};
+
+    if (!holdCanCommit) tsem_wait(&pVnode->canCommit);
+    info.info.config = pVnode->config;
+    info.info.state.commitID = pVnode->state.commitID;
+    info.info.state.committed = version;
+    info.pVnode = pVnode;
+    info.txn = metaGetTxn(pVnode->pMeta);
+    tsdbPrepareCommit(pVnode->pTsdb);
+    metaPrepareAsyncCommit(pVnode->pMeta);
+    vnodeBufPoolUnRef(pVnode->inUse);
+    pVnode->inUse = NULL;
+
+    ASSERT_EQ(tsdbCommit(pVnode->pTsdb, &info), 0);
+    ASSERT_EQ(tsdbFinishCommit(pVnode->pTsdb), 0);
+    ASSERT_EQ(metaFinishCommit(pVnode->pMeta, info.txn), 0);
+    if (!holdCanCommit) tsem_post(&pVnode->canCommit);
+
+    begin();
+  }
+
+  void compact() {
+    int64_t commitID = pVnode->state.commitID + 1;
+    ASSERT_EQ(tsdbAsyncCompact(pVnode->pTsdb, commitID), 0);
+    pVnode->state.commitID += 2;
+    while (atomic_load_8(&pVnode->pTsdb->compact.running)) {
+      taosMsleep(5);
+    }
+  }
+
+  void createSuperTable() {
+    SSchema schemaRow[2] = {{.type = TSDB_DATA_TYPE_TIMESTAMP, .colId = 1, .bytes = 8, .name = "ts"},
+                            {.type = TSDB_DATA_TYPE_INT, .colId = 2, .bytes = 4, .name = "v"}};
+    SSchema schemaTag[1] = {{.type = TSDB_DATA_TYPE_INT, .colId = 3, .bytes = 4, .name = "t"}};
+
+    SVCreateStbReq req = {0};
+    req.name = (char *)"stb";
+    req.suid = kSuid;
+    req.schemaRow = {.nCols = 2, .version = 1, .pSchema = schemaRow};
+    req.schemaTag = {.nCols = 1, .version = 1, .pSchema = schemaTag};
+    ASSERT_EQ(metaCreateSTable(pVnode->pMeta, ++version, &req), 0);
+  }
+
+  void createTable(tb_uid_t uid) {
+    char    name[TSDB_TABLE_NAME_LEN];
+    STagVal tagVal = {.cid = 3, .type = TSDB_DATA_TYPE_INT, .i64 = uid};
+    SArray *pTagVals = taosArrayInit(1, sizeof(STagVal));
+    STag   *pTag = NULL;
+    taosArrayPush(pTagVals, &tagVal);
+    ASSERT_EQ(tTagNew(pTagVals, 1, false, &pTag), 0);
+    taosArrayDestroy(pTagVals);
+
+    snprintf(name, sizeof(name), "ctb%" PRId64, uid);
+    SVCreateTbReq req = {0};
+    req.name = name;
+    req.uid = uid;
+    req.type = TSDB_CHILD_TABLE;
+    req.ctb.stbName = (char *)"stb";
+    req.ctb.suid = kSuid;
+    req.ctb.pTag = (uint8_t *)pTag;
+    ASSERT_EQ(metaCreateTable(pVnode->pMeta, ++version, &req, NULL), 0);
+    tTagFree(pTag);
+  }
+
+  // rows (ts, v) of one table in one submit, with one new version. A columnar block takes rows in ascending order of
+  // ts, as the client sorts them.
+  void insert(tb_uid_t uid, const std::vector<std::pair<TSKEY, int32_t>> &rows, bool columnar = false) {
+    STSchema *pTSchema = NULL;
+    ASSERT_EQ(metaGetTbTSchemaEx(pVnode->pMeta, kSuid, uid, -1, &pTSchema), 0);
+
+    SSDataBlock *pColBlock = createDataBlock();
+    for (int32_t iCol = 0; iCol < pTSchema->numOfCols; iCol++) {
+      STColumn       *pCol = &pTSchema->columns[iCol];
+      SColumnInfoData colInfo = createColumnInfoData(pCol->type, pCol->bytes, pCol->colId);
+      blockDataAppendColInfo(pColBlock, &colInfo);
+    }
+    blockDataEnsureCapacity(pColBlock, rows.size());
+    for (int32_t i = 0; i < rows.size(); i++) {
+      colDataAppend((SColumnInfoData *)taosArrayGet(pColBlock->pDataBlock, 0), i, (const char *)&rows[i].first, false);
+      colDataAppend((SColumnInfoData *)taosArrayGet(pColBlock->pDataBlock, 1), i, (const char *)&rows[i].second, false);
+    }
+    pColBlock->info.rows = rows.size();
+
+    int32_t     rowLen = TD_ROW_MAX_BYTES_FROM_SCHEMA(pTSchema);
+    int32_t     msgLen = sizeof(SSubmitReq) + sizeof(SSubmitBlk) + rowLen * rows.size() + tGetSubmitColBlkSize(pColBlock);
+    SSubmitReq *pMsg = (SSubmitReq *)taosMemoryCalloc(1, msgLen);
+    SSubmitBlk *pBlk = (SSubmitBlk *)POINTER_SHIFT(pMsg, sizeof(SSubmitReq));
+    STSRow     *pRow = (STSRow *)pBlk->data;
+    int32_t     dataLen = columnar ? tEncodeSubmitColBlk(pColBlock, pBlk->data) : 0;
+    blockDataDestroy(pColBlock);
+
+    for (auto &r : rows) {
+      if (columnar) break;
+      SRowBuilder rb = {0};
+      tdSRowInit(&rb, pTSchema->version);
+      tdSRowSetTpInfo(&rb, pTSchema->numOfCols, pTSchema->flen);
+      tdSRowResetBuf(&rb, pRow);
+      tdAppendColValToRow(&rb, 1, TSDB_DATA_TYPE_TIMESTAMP, TD_VTYPE_NORM, &r.first, true, pTSchema->columns[0].offset,
+                          0);
+      tdAppendColValToRow(&rb, 2, TSDB_DATA_TYPE_INT, TD_VTYPE_NORM, &r.second, true, pTSchema->columns[1].offset, 1);
+      tdSRowEnd(&rb);
+      dataLen += TD_ROW_LEN(pRow);
+      pRow = (STSRow *)POINTER_SHIFT(pRow, TD_ROW_LEN(pRow));
+    }
+    pBlk->uid = htobe64(uid);
+    pBlk->suid = htobe64(kSuid);
+    pBlk->sversion = htonl(pTSchema->version);
+    pBlk->dataLen = htonl(dataLen);
+    pBlk->numOfRows = htonl(rows.size());
+    msgLen = sizeof(SSubmitReq) + sizeof(SSubmitBlk) + dataLen;
+    pMsg->length = htonl(msgLen);
+    pMsg->numOfBlocks = htonl(1);
+
+    SSubmitMsgIter msgIter = {0};
+    SSubmitBlk    *pBlock = NULL;
+    SSubmitBlkRsp  rsp = {0};
+    ASSERT_EQ(tInitSubmitMsgIter(pMsg, &msgIter), 0);
+    ASSERT_EQ(tGetSubmitMsgNext(&msgIter, &pBlock), 0);
+    ASSERT_EQ(tsdbInsertTableData(pVnode->pTsdb, ++version, &msgIter, pBlock, &rsp), 0);
+    ASSERT_EQ(rsp.numOfRows, rows.size());
+    pVnode->state.applied = version;
+
+    taosMemoryFree(pMsg);
+    tDestroyTSchema(pTSchema);
+  }
+
+  void remove(tb_uid_t uid, TSKEY sKey, TSKEY eKey) {
+    ASSERT_EQ(tsdbDeleteTableData(pVnode->pTsdb, ++version, kSuid, uid, sKey, eKey), 0);
+    pVnode->state.applied = version;
+  }
+
+  // what a query on the table returns, ts -> v
+  std::map<TSKEY, int32_t> scan(tb_uid_t uid) {
+    std::map<TSKEY, int32_t> res;
+
+    SColumnInfo colList[2] = {{.colId = 1, .bytes = 8, .type = TSDB_DATA_TYPE_TIMESTAMP},
+                              {.colId = 2, .bytes = 4, .type = TSDB_DATA_TYPE_INT}};
+    int32_t     slotList[2] = {0, 1};
+
+    SQueryTableDataCond cond = {0};
+    cond.suid = kSuid;
+    cond.order = TSDB_ORDER_ASC;
+    cond.type = TIMEWINDOW_RANGE_CONTAINED;
+    cond.numOfCols = 2;
+    cond.colList = colList;
+    cond.pSlotList = slotList;
+    cond.twindows = {.skey = TSKEY_MIN, .ekey = TSKEY_MAX};
+    cond.startVersion = -1;
+    cond.endVersion = -1;
+
+    SSDataBlock *pBlock = createDataBlock();
+    for (int32_t i = 0; i < 2; i++) {
+      SColumnInfoData colInfo = createColumnInfoData(colList[i].type, colList[i].bytes, colList[i].colId);
+      blockDataAppendColInfo(pBlock, &colInfo);
+    }
+    blockDataEnsureCapacity(pBlock, 4096);
+
+    STableKeyInfo tableKey = {.uid = (uint64_t)uid, .groupId = 0};
+    STsdbReader  *pReader = NULL;
+    EXPECT_EQ(tsdbReaderOpen(pVnode, &cond, &tableKey, 1, pBlock, &pReader, "tsdbTest"), 0);
+    while (pReader && tsdbNextDataBlock(pReader)) {
+      SSDataBlock     *pRes = tsdbRetrieveDataBlock(pReader, NULL);
+      SColumnInfoData *pTs = (SColumnInfoData *)taosArrayGet(pRes->pDataBlock, 0);
+      SColumnInfoData *pV = (SColumnInfoData *)taosArrayGet(pRes->pDataBlock, 1);
+      for (int32_t i = 0; i < pRes->info.rows; i++) {
+        TSKEY ts = *(TSKEY *)colDataGetData(pTs, i);
+        EXPECT_EQ(res.count(ts), 0) << "ts:" << ts << " returned twice";
+        res[ts] = *(int32_t *)colDataGetData(pV, i);
+      }
+    }
+    tsdbReaderClose(pReader);
+    blockDataDestroy(pBlock);
+    return res;
+  }
+
+  // the rows of the blocks of a scan over the tables in the given order, each block retrieved unless skip says no
+  std::map<std::pair<tb_uid_t, TSKEY>, int32_t> scanBlocks(const std::vector<tb_uid_t> &uids, int32_t order,
+                                                           const std::function<bool(int32_t)> &skip = nullptr) {
+    std::map<std::pair<tb_uid_t, TSKEY>, int32_t> res;
+
+    SColumnInfo colList[2] = {{.colId = 1, .bytes = 8, .type = TSDB_DATA_TYPE_TIMESTAMP},
+                              {.colId = 2, .bytes = 4, .type = TSDB_DATA_TYPE_INT}};
+    int32_t     slotList[2] = {0, 1};
+
+    SQueryTableDataCond cond = {0};
+    cond.suid = kSuid;
+    cond.order = order;
+    cond.type = TIMEWINDOW_RANGE_CONTAINED;
+    cond.numOfCols = 2;
+    cond.colList = colList;
+    cond.pSlotList = slotList;
+    cond.twindows = {.skey = TSKEY_MIN, .ekey = TSKEY_MAX};
+    cond.startVersion = -1;
+    cond.endVersion = -1;
+
+    SSDataBlock *pBlock = createDataBlock();
+    for (int32_t i = 0; i < 2; i++) {
+      SColumnInfoData colInfo = createColumnInfoData(colList[i].type, colList[i].bytes, colList[i].colId);
+      blockDataAppendColInfo(pBlock, &colInfo);
+    }
+    blockDataEnsureCapacity(pBlock, 4096);
+
+    std::vector<STableKeyInfo> tableKeys;
+    for (tb_uid_t uid : uids) {
+      tableKeys.push_back({.uid = (uint64_t)uid, .groupId = 0});
+    }
+    STsdbReader *pReader = NULL;
+    EXPECT_EQ(tsdbReaderOpen(pVnode, &cond, tableKeys.data(), tableKeys.size(), pBlock, &pReader, "tsdbTest"), 0);
+    for (int32_t iBlock = 0; pReader && tsdbNextDataBlock(pReader); iBlock++) {
+      if (skip && skip(iBlock)) continue;
+
+      int32_t     rows = 0;
+      uint64_t    uid = 0;
+      STimeWindow win = {0};
+      tsdbRetrieveDataBlockInfo(pReader, &rows, &uid, &win);
+
+      SSDataBlock     *pRes = tsdbRetrieveDataBlock(pReader, NULL);
+      SColumnInfoData *pTs = (SColumnInfoData *)taosArrayGet(pRes->pDataBlock, 0);
+      SColumnInfoData *pV = (SColumnInfoData *)taosArrayGet(pRes->pDataBlock, 1);
+      for (int32_t i = 0; i < pRes->info.rows; i++) {
+        TSKEY ts = *(TSKEY *)colDataGetData(pTs, i);
+        EXPECT_EQ(res.count({(tb_uid_t)uid, ts}), 0) << "uid:" << uid << " ts:" << ts << " returned twice";
+        res[{(tb_uid_t)uid, ts}] = *(int32_t *)colDataGetData(pV, i);
+      }
+    }
+    tsdbReaderClose(pReader);
+    blockDataDestroy(pBlock);
+    return res;
+  }
+
+  SDFileSet *fileSet(int32_t fid) {
+    SDFileSet tSet = {.fid = fid};
+    return (SDFileSet *)taosArraySearch(pVnode->pTsdb->fs.aDFileSet, &tSet, tDFileSetCmprFn, TD_EQ);
+  }
+};
+
+// rows in ms, one file set covers 10 days
+static constexpr TSKEY kDay = 86400000LL;
+static constexpr TSKEY kBase = 1600000000000LL / (10 * kDay) * (10 * kDay);
+
+static TSKEY ts(int32_t i) { return kBase + i * 1000LL; }
+
+// A commit merges the rows of a table into the .data file, except for a tail of less than minRows rows beyond the
+// last data block which goes to a new .stt file. Small batches past the end of the .data file stack up in .stt files.
+TEST_F(TsdbTest, compact_overlap_and_delete) {
+  const int32_t nTable = 4;
+
+  for (tb_uid_t uid = kSuid + 1; uid <= kSuid + nTable; uid++) {
+    createTable(uid);
+  }
+
+  std::map<tb_uid_t, std::map<TSKEY, int32_t>> expect;
+  auto write = [&](tb_uid_t uid, int32_t from, int32_t to, int32_t step, int32_t value) {
+    std::vector<std::pair<TSKEY, int32_t>> rows;
+    for (int32_t i = from; i < to; i += step) {
+      rows.push_back({ts(i), value + i});
+      expect[uid][ts(i)] = value + i;
+    }
+    insert(uid, rows);
+  };
+
+  for (tb_uid_t uid = kSuid + 1; uid <= kSuid + nTable; uid++) {
+    write(uid, 0, 200, 1, 0);
+  }
+  commit();
+
+  // every round rewrites half of the rows of the previous one
+  for (int32_t round = 1; round <= 4; round++) {
+    for (tb_uid_t uid = kSuid + 1; uid <= kSuid + nTable; uid++) {
+      write(uid, 200 + round * 4, 216 + round * 4, 2, round * 10000);
+    }
+
+    // a range of the second table across the .data and the .stt files goes away, rows rewritten later are back
+    if (round == 2) {
+      remove(kSuid + 2, ts(190), ts(215));
+      for (int32_t i = 190; i <= 215; i++) {
+        expect[kSuid + 2].erase(ts(i));
+      }
+    }
+    commit();
+  }
+
+  int32_t    fid = tsdbKeyFid(kBase, pVnode->pTsdb->keepCfg.days, pVnode->pTsdb->keepCfg.precision);
+  SDFileSet *pSet = fileSet(fid);
+  ASSERT_NE(pSet, nullptr);
+  ASSERT_EQ(pSet->nSttF, 5);
+  ASSERT_GT(pSet->aSttF[4]->size, pSet->aSttF[4]->offset);
+
+  for (tb_uid_t uid = kSuid + 1; uid <= kSuid + nTable; uid++) {
+    ASSERT_EQ(scan(uid), expect[uid]) << "uid:" << uid;
+  }
+
+  int64_t dataSize = pSet->pDataF->size;
+  compact();
+
+  // all rows are in the .data file now, the only .stt file is empty
+  pSet = fileSet(fid);
+  ASSERT_NE(pSet, nullptr);
+  ASSERT_EQ(pSet->nSttF, 1);
+  ASSERT_EQ(pSet->aSttF[0]->size, pSet->aSttF[0]->offset);
+  ASSERT_EQ(pSet->pHeadF->commitID, pSet->pDataF->commitID);
+  ASSERT_GT(pSet->pDataF->size, dataSize);
+
+  for (tb_uid_t uid = kSuid + 1; uid <= kSuid + nTable; uid++) {
+    ASSERT_EQ(scan(uid), expect[uid]) << "uid:" << uid;
+  }
+
+  // the tombstones are kept, a row written after the compaction shows on top of the merged data
+  write(kSuid + 2, 195, 196, 1, -1000);
+  commit();
+  ASSERT_EQ(scan(kSuid + 2), expect[kSuid + 2]);
+
+  // nothing to do for a file set without .stt data
+  compact();
+  ASSERT_EQ(fileSet(fid)->nSttF, 2);
+  ASSERT_EQ(tsdbGetCompactProgress(pVnode->pTsdb), 100);
+  for (tb_uid_t uid = kSuid + 1; uid <= kSuid + nTable; uid++) {
+    ASSERT_EQ(scan(uid), expect[uid]) << "uid:" << uid;
+  }
+}
+
+TEST_F(TsdbTest, compact_keeps_stt_committed_meanwhile) {
+  createTable(kSuid + 1);
+
+  std::map<TSKEY, int32_t> expect;
+  for (int32_t round = 0; round < 3; round++) {
+    std::vector<std::pair<TSKEY, int32_t>> rows;
+    for (int32_t i = 0; i < 5; i++) {
+      rows.push_back({ts(i * 3 + round), round});
+      expect[ts(i * 3 + round)] = round;
+    }
+    insert(kSuid + 1, rows);
+    commit();
+  }
+
+  int32_t fid = tsdbKeyFid(kBase, pVnode->pTsdb->keepCfg.days, pVnode->pTsdb->keepCfg.precision);
+  int32_t nSttF = fileSet(fid)->nSttF;
+  ASSERT_EQ(nSttF, 3);
+
+  // hold the commit back until the compaction has merged the file set and waits to swap it in
+  tsem_wait(&pVnode->canCommit);
+  int64_t commitID = pVnode->state.commitID + 1;
+  ASSERT_EQ(tsdbAsyncCompact(pVnode->pTsdb, commitID), 0);
+  pVnode->state.commitID += 2;
+  while (atomic_load_32(&pVnode->pTsdb->compact.nFSet) == 0) {
+    taosMsleep(5);
+  }
+  taosMsleep(100);
+
+  // a commit appends one more .stt file to the file set under compaction
+  insert(kSuid + 1, {{ts(1), 100}, {ts(20), 101}});
+  expect[ts(1)] = 100;
+  expect[ts(20)] = 101;
+  commit(true);
+  ASSERT_EQ(fileSet(fid)->nSttF, nSttF + 1);
+  tsem_post(&pVnode->canCommit);
+
+  while (atomic_load_8(&pVnode->pTsdb->compact.running)) {
+    taosMsleep(5);
+  }
+
+  // the compacted files took the place of the old ones, the new .stt file stayed
+  SDFileSet *pSet = fileSet(fid);
+  ASSERT_EQ(pSet->nSttF, 2);
+  ASSERT_EQ(pSet->pDataF->commitID, commitID);
+  ASSERT_EQ(pSet->aSttF[0]->commitID, commitID);
+  ASSERT_EQ(pSet->aSttF[0]->size, pSet->aSttF[0]->offset);
+  ASSERT_GT(pSet->aSttF[1]->size, pSet->aSttF[1]->offset);
+  ASSERT_EQ(scan(kSuid + 1), expect);
+}
+
+// The file sets touched by a memtable are committed by several threads at once, each thread writing whole file sets.
+TEST_F(TsdbTest, commit_file_sets_in_parallel) {
+  const int32_t nTable = 3;
+  const int32_t nFSet = 9;
+  int32_t       nThread = tsNumOfCommitFsetThreads;
+
+  for (tb_uid_t uid = kSuid + 1; uid <= kSuid + nTable; uid++) {
+    createTable(uid);
+  }
+
+  // each table has rows in every other file set, some sets get more rows than maxRows to span several blocks
+  std::map<tb_uid_t, std::map<TSKEY, int32_t>> expect;
+  auto write = [&](int32_t round) {
+    for (tb_uid_t uid = kSuid + 1; uid <= kSuid + nTable; uid++) {
+      std::vector<std::pair<TSKEY, int32_t>> rows;
+      for (int32_t iFSet = (uid + round) % 2; iFSet < nFSet; iFSet += 2) {
+        int32_t nRow = (iFSet % 3 == 0) ? 450 : 30;
+        for (int32_t i = round; i < nRow; i += round + 1) {
+          TSKEY key = kBase + iFSet * 10 * kDay + i * 1000LL;
+          rows.push_back({key, round * 100000 + iFSet * 1000 + i});
+          expect[uid][key] = round * 100000 + iFSet * 1000 + i;
+        }
+      }
+      insert(uid, rows);
+    }
+  };
+
+  tsNumOfCommitFsetThreads = 4;
+  write(0);
+  commit();
+
+  // the file sets are in the fs in fid order, each one written in this commit
+  SArray *aDFileSet = pVnode->pTsdb->fs.aDFileSet;
+  ASSERT_EQ(taosArrayGetSize(aDFileSet), nFSet);
+  int32_t fid = tsdbKeyFid(kBase, pVnode->pTsdb->keepCfg.days, pVnode->pTsdb->keepCfg.precision);
+  for (int32_t iFSet = 0; iFSet < nFSet; iFSet++) {
+    SDFileSet *pSet = (SDFileSet *)taosArrayGet(aDFileSet, iFSet);
+    ASSERT_EQ(pSet->fid, fid + iFSet);
+    ASSERT_EQ(pSet->pHeadF->commitID, pVnode->state.commitID - 1);
+  }
+  for (tb_uid_t uid = kSuid + 1; uid <= kSuid + nTable; uid++) {
+    ASSERT_EQ(scan(uid), expect[uid]) << "uid:" << uid;
+  }
+
+  // rows merged into the existing file sets, from more threads than there are file sets with new rows
+  tsNumOfCommitFsetThreads = 16;
+  write(1);
+  commit();
+  ASSERT_EQ(taosArrayGetSize(aDFileSet), nFSet);
+  for (tb_uid_t uid = kSuid + 1; uid <= kSuid + nTable; uid++) {
+    ASSERT_EQ(scan(uid), expect[uid]) << "uid:" << uid;
+  }
+
+  // and the same once more on the commit thread alone
+  tsNumOfCommitFsetThreads = 1;
+  write(2);
+  commit();
+  for (tb_uid_t uid = kSuid + 1; uid <= kSuid + nTable; uid++) {
+    ASSERT_EQ(scan(uid), expect[uid]) << "uid:" << uid;
+  }
+
+  tsNumOfCommitFsetThreads = nThread;
+}
+
+// Decompressed blocks are shared by the queries of the vnode and keyed by the commit ID of their file, so rows
+// rewritten by a commit or a compaction, or files brought by a snapshot, never come back stale.
+TEST_F(TsdbTest, block_cache_keys) {
+  ASSERT_NE(pVnode->pTsdb->blockCache.pCache, nullptr);
+  createTable(kSuid + 1);
+
+  std::map<TSKEY, int32_t> expect;
+  auto write = [&](int32_t from, int32_t to, int32_t value) {
+    std::vector<std::pair<TSKEY, int32_t>> rows;
+    for (int32_t i = from; i < to; i++) {
+      rows.push_back({ts(i), value + i});
+      expect[ts(i)] = value + i;
+    }
+    insert(kSuid + 1, rows);
+  };
+  auto &cache = pVnode->pTsdb->blockCache;
+
+  // the .data blocks and a tail in a .stt file
+  write(0, 405, 0);
+  commit();
+  int32_t    fid = tsdbKeyFid(kBase, pVnode->pTsdb->keepCfg.days, pVnode->pTsdb->keepCfg.precision);
+  SDFileSet *pSet = fileSet(fid);
+  ASSERT_NE(pSet, nullptr);
+  ASSERT_GT(pSet->pDataF->size, 0);
+  ASSERT_GT(pSet->aSttF[0]->size, pSet->aSttF[0]->offset);
+
+  int64_t nMiss = cache.nMiss;
+  ASSERT_EQ(scan(kSuid + 1), expect);
+  ASSERT_GT(cache.nMiss, nMiss);
+
+  // read again, all from the cache
+  int64_t nHit = cache.nHit;
+  nMiss = cache.nMiss;
+  ASSERT_EQ(scan(kSuid + 1), expect);
+  ASSERT_GT(cache.nHit, nHit);
+  ASSERT_EQ(cache.nMiss, nMiss);
+
+  // rows overwritten in the middle of the .data blocks, the merged blocks are written at new offsets or files
+  write(100, 300, 10000);
+  commit();
+  ASSERT_EQ(scan(kSuid + 1), expect);
+  ASSERT_EQ(scan(kSuid + 1), expect);
+
+  // the compacted files have a new commit ID, their blocks may sit at the offsets of the old ones
+  write(400, 410, 20000);
+  commit();
+  int64_t commitID = fileSet(fid)->pDataF->commitID;
+  ASSERT_EQ(scan(kSuid + 1), expect);
+  compact();
+  ASSERT_NE(fileSet(fid)->pDataF->commitID, commitID);
+  nMiss = cache.nMiss;
+  ASSERT_EQ(scan(kSuid + 1), expect);
+  ASSERT_GT(cache.nMiss, nMiss);
+
+  // a new generation, as after applying a snapshot, misses everything cached before
+  nHit = cache.nHit;
+  nMiss = cache.nMiss;
+  ASSERT_EQ(scan(kSuid + 1), expect);
+  int64_t nRead = cache.nHit - nHit;
+  ASSERT_GT(nRead, 0);
+  ASSERT_EQ(cache.nMiss, nMiss);
+
+  atomic_add_fetch_32(&cache.gen, 1);
+  nHit = cache.nHit;
+  ASSERT_EQ(scan(kSuid + 1), expect);
+  ASSERT_EQ(cache.nHit, nHit);
+  ASSERT_EQ(cache.nMiss - nMiss, nRead);
+}
+
+// The blocks read ahead while a block is loaded, checked against the ones before. Within the blocks of a file each
+// block is read ahead at most once, in scan order, and only while it is one of the 4 blocks past the loaded one.
+static struct {
+  int32_t nCall;
+  int32_t nBlock;
+  int32_t numOfBlocks;
+  int32_t index;
+  int32_t raIndex;
+} raTrace;
+
+static void traceReadAhead(STsdbReader *pReader, int32_t order, int32_t index, int32_t raIndex, int32_t numOfBlocks) {
+  int32_t step = (order == TSDB_ORDER_ASC) ? 1 : -1;
+
+  // the blocks of the next file
+  if (raTrace.nBlock == 0 || numOfBlocks != raTrace.numOfBlocks || (index - raTrace.index) * step < 0) {
+    raTrace.raIndex = -1;
+  }
+  if (raTrace.nBlock == 0 || index != raTrace.index) raTrace.nCall++;
+  raTrace.nBlock++;
+
+  EXPECT_TRUE(raIndex >= 0 && raIndex < numOfBlocks) << "raIndex:" << raIndex;
+  EXPECT_GE((raIndex - index) * step, 1) << "index:" << index << " raIndex:" << raIndex << " order:" << order;
+  EXPECT_LE((raIndex - index) * step, 4) << "index:" << index << " raIndex:" << raIndex << " order:" << order;
+  if (raTrace.raIndex >= 0) {
+    EXPECT_GT((raIndex - raTrace.raIndex) * step, 0) << "index:" << index << " raIndex:" << raIndex << " order:" << order;
+  }
+
+  raTrace.numOfBlocks = numOfBlocks;
+  raTrace.index = index;
+  raTrace.raIndex = raIndex;
+}
+
+// The blocks of three tables in two file sets are read ahead in both orders, with some of them merged with the rows
+// in the memtable and some of them skipped by the scan without being loaded.
+TEST_F(TsdbTest, read_ahead_in_scan_order) {
+  std::vector<tb_uid_t> uids = {kSuid + 1, kSuid + 2, kSuid + 3};
+  for (tb_uid_t uid : uids) {
+    createTable(uid);
+  }
+
+  std::map<std::pair<tb_uid_t, TSKEY>, int32_t> expect;
+  auto write = [&](tb_uid_t uid, TSKEY from, int32_t nRow, int32_t value) {
+    std::vector<std::pair<TSKEY, int32_t>> rows;
+    for (int32_t i = 0; i < nRow; i++) {
+      rows.push_back({from + i * 1000LL, value + i});
+      expect[{uid, from + i * 1000LL}] = value + i;
+    }
+    insert(uid, rows);
+  };
+
+  for (tb_uid_t uid : uids) {
+    write(uid, kBase, 1000, uid * 10000);
+    write(uid, kBase + 10 * kDay, 600, uid * 20000);
+  }
+  commit();
+
+  tsdbReadAheadFp = traceReadAhead;
+  for (int32_t order : {TSDB_ORDER_ASC, TSDB_ORDER_DESC}) {
+    raTrace = {0};
+    ASSERT_EQ(scanBlocks(uids, order), expect) << "order:" << order;
+    ASSERT_GT(raTrace.nCall, 0);
+    int32_t nCall = raTrace.nCall;
+
+    // every other block is skipped, and runs of blocks too, so the loaded block is at times past the read ahead ones
+    raTrace = {0};
+    auto res = scanBlocks(uids, order, [](int32_t iBlock) { return iBlock % 2 == 1 || (iBlock / 4) % 3 == 1; });
+    ASSERT_GT(raTrace.nCall, 0);
+    ASSERT_LT(raTrace.nCall, nCall);
+    ASSERT_FALSE(res.empty());
+    for (auto &it : res) {
+      ASSERT_EQ(expect.count(it.first), 1);
+      ASSERT_EQ(expect[it.first], it.second);
+    }
+  }
+
+  // rows in the memtable in the middle of the blocks of a table, so those blocks are merged with them
+  write(kSuid + 2, kBase + 300 * 1000LL, 50, -100000);
+  write(kSuid + 3, kBase + 10 * kDay + 150 * 1000LL, 100, -200000);
+  for (int32_t order : {TSDB_ORDER_ASC, TSDB_ORDER_DESC}) {
+    raTrace = {0};
+    ASSERT_EQ(scanBlocks(uids, order), expect) << "order:" << order;
+    ASSERT_GT(raTrace.nCall, 0);
+  }
+  tsdbReadAheadFp = NULL;
+}
+
+// A columnar block goes into the memtable as its rows would, over the rows of the files and of the memtable
+TEST_F(TsdbTest, insert_col_blk) {
+  const tb_uid_t uid = kSuid + 1;
+  createTable(uid);
+
+  std::map<TSKEY, int32_t> expect;
+  auto write = [&](int32_t from, int32_t to, int32_t step, int32_t value, bool columnar) {
+    std::vector<std::pair<TSKEY, int32_t>> rows;
+    for (int32_t i = from; i < to; i += step) {
+      rows.push_back({ts(i), value + i});
+      expect[ts(i)] = value + i;
+    }
+    insert(uid, rows, columnar);
+  };
+
+  write(0, 300, 1, 0, false);
+  commit();
+
+  // over the rows committed, then over the rows of the memtable, then before the first row of the table in it
+  write(100, 500, 2, 1000, true);
+  ASSERT_EQ(scan(uid), expect);
+  write(99, 400, 3, 2000, true);
+  ASSERT_EQ(scan(uid), expect);
+  write(-50, 1, 1, 3000, true);
+  ASSERT_EQ(scan(uid), expect);
+
+  // one row, the last one of the memtable
+  write(499, 500, 1, 4000, true);
+  ASSERT_EQ(scan(uid), expect);
+
+  commit();
+  ASSERT_EQ(scan(uid), expect);
+}
+
+#pragma GCC diagnostic pop
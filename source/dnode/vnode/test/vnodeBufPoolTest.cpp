@@ -0,0 +1,180 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <functional>
+#include <utility>
+#include <vector>
+
+#include "vnd.h"
+
+// Rsma vnodes of three shared (locked) buffer pools each, written by threads that take chunks of their own. A new
+// thread is started for a case that needs the slots of its arenas empty.
+class VnodeBufPoolTest : public ::testing::Test {
+ protected:
+  static const int32_t kChunkSize = 64 * 1024;  // VNODE_BUFPOOL_CHUNK_SIZE
+  static const int32_t kNumOfThreads = 4;
+
+  std::vector<SVnode *> vnodes;
+
+  void TearDown() override {
+    for (SVnode *pVnode : vnodes) {
+      vnodeCloseBufPool(pVnode);
+      taosMemoryFree(pVnode);
+    }
+  }
+
+  SVnode *openVnode() {
+    SVnode *pVnode = (SVnode *)taosMemoryCalloc(1, sizeof(SVnode));
+    pVnode->config = vnodeCfgDefault;
+    pVnode->config.vgId = 2 + vnodes.size();
+    pVnode->config.isRsma = 1;
+    pVnode->config.szBuf = 3 * 1024 * 1024;
+    vnodes.push_back(pVnode);
+    EXPECT_EQ(vnodeOpenBufPool(pVnode), 0);
+    EXPECT_NE(pVnode->pPool->lock, nullptr);
+    return pVnode;
+  }
+
+  // the pools of the vnodes opened, in the order they are created
+  std::vector<SVBufPool *> pools() {
+    std::vector<SVBufPool *> result;
+    for (SVnode *pVnode : vnodes) {
+      std::vector<SVBufPool *> vnodePools;
+      for (SVBufPool *pPool = pVnode->pPool; pPool; pPool = pPool->next) vnodePools.insert(vnodePools.begin(), pPool);
+      result.insert(result.end(), vnodePools.begin(), vnodePools.end());
+    }
+    return result;
+  }
+
+  static void *runFn(void *param) {
+    (*(std::function<void()> *)param)();
+    return NULL;
+  }
+
+  static void runInThreads(int32_t nThread, std::function<void(int32_t)> fn) {
+    std::vector<TdThread>              threads(nThread);
+    std::vector<std::function<void()>> fns;
+    for (int32_t i = 0; i < nThread; i++) fns.push_back([fn, i]() { fn(i); });
+    for (int32_t i = 0; i < nThread; i++) taosThreadCreate(&threads[i], NULL, runFn, &fns[i]);
+    for (int32_t i = 0; i < nThread; i++) taosThreadJoin(threads[i], NULL);
+  }
+};
+
+TEST_F(VnodeBufPoolTest, shared_pool_threads) {
+  SVBufPool *pPool = openVnode()->pPool;
+
+  // small rows from the chunks, and now and then one too large for a chunk
+  typedef std::pair<uint8_t *, int32_t> SAlloc;
+  std::vector<std::vector<SAlloc>>      allocs(kNumOfThreads);
+  runInThreads(kNumOfThreads, [&](int32_t iThread) {
+    for (int32_t i = 0; i < 5000; i++) {
+      int32_t  size = (i % 500 == 499) ? kChunkSize / 2 : (i * 37 + iThread) % 200 + 1;
+      uint8_t *p = (uint8_t *)vnodeBufPoolMallocAligned(pPool, size);
+      ASSERT_NE(p, nullptr);
+      memset(p, iThread + 1, size);
+      allocs[iThread].push_back({p, size});
+    }
+  });
+
+  std::vector<SAlloc> all;
+  for (int32_t iThread = 0; iThread < kNumOfThreads; iThread++) {
+    for (SAlloc &alloc : allocs[iThread]) {
+      ASSERT_EQ((uintptr_t)alloc.first % 8, 0);
+      for (int32_t i = 0; i < alloc.second; i++) ASSERT_EQ(alloc.first[i], iThread + 1);
+      all.push_back(alloc);
+    }
+  }
+  std::sort(all.begin(), all.end());
+  for (size_t i = 1; i < all.size(); i++) {
+    ASSERT_LE(all[i - 1].first + all[i - 1].second, all[i].first);
+  }
+
+  EXPECT_GE(pPool->nChunk, (int64_t)kNumOfThreads);
+  EXPECT_LT(pPool->nChunk, kNumOfThreads * 5000 * 200 / kChunkSize);
+}
+
+TEST_F(VnodeBufPoolTest, alternate_pools) {
+  openVnode();
+  std::vector<SVBufPool *> vPools = pools();
+  SVBufPool               *pPool1 = vPools[0];
+  SVBufPool               *pPool2 = vPools[1];
+
+  // the two pools try the same slot first
+  pPool2->arena = pPool1->arena;
+
+  runInThreads(1, [&](int32_t iThread) {
+    for (int32_t i = 0; i < 20000; i++) {
+      ASSERT_NE(vnodeBufPoolMallocAligned((i % 2) ? pPool2 : pPool1, 64), nullptr);
+    }
+  });
+
+  // 10000 rows of 64 bytes fill ten chunks of each pool, with nothing left over
+  EXPECT_EQ(pPool1->nChunk, 10);
+  EXPECT_EQ(pPool2->nChunk, 10);
+  EXPECT_EQ(pPool1->nWaste, 0);
+  EXPECT_EQ(pPool2->nWaste, 0);
+}
+
+TEST_F(VnodeBufPoolTest, evicted_waste) {
+  for (int32_t i = 0; i < 3; i++) openVnode();
+  std::vector<SVBufPool *> vPools = pools();
+  ASSERT_EQ(vPools.size(), 9);
+
+  // nine pools for the eight slots of a thread, the last one takes the chunk of another
+  runInThreads(1, [&](int32_t iThread) {
+    for (SVBufPool *pPool : vPools) ASSERT_NE(vnodeBufPoolMallocAligned(pPool, 64), nullptr);
+  });
+
+  for (SVBufPool *pPool : vPools) {
+    EXPECT_EQ(pPool->nChunk, 1);
+    EXPECT_EQ(pPool->nWaste, 0);
+    vnodeBufPoolReset(pPool);
+  }
+
+  int64_t nChunk = 0;
+  int64_t nWaste = 0;
+  for (SVnode *pVnode : vnodes) {
+    nChunk += pVnode->bufPoolStatis.nChunk;
+    nWaste += pVnode->bufPoolStatis.nWaste;
+  }
+  EXPECT_EQ(nChunk, 9);
+  EXPECT_EQ(nWaste, kChunkSize - 64);
+}
+
+TEST_F(VnodeBufPoolTest, reset_epoch) {
+  SVnode    *pVnode = openVnode();
+  SVBufPool *pPool = pVnode->pPool;
+
+  uint8_t *p1 = (uint8_t *)vnodeBufPoolMallocAligned(pPool, 100);
+  uint8_t *p2 = (uint8_t *)vnodeBufPoolMallocAligned(pPool, 100);
+  ASSERT_NE(p1, nullptr);
+  EXPECT_EQ(p2, p1 + 104);
+  EXPECT_EQ(pPool->nChunk, 1);
+
+  // the chunk of this thread is dropped with the epoch, the next row is from a new one at the start of the pool
+  int64_t epoch = pPool->epoch;
+  vnodeBufPoolReset(pPool);
+  EXPECT_NE(pPool->epoch, epoch);
+  EXPECT_EQ(pPool->nChunk, 0);
+  EXPECT_EQ(pVnode->bufPoolStatis.nChunk, 1);
+
+  uint8_t *p3 = (uint8_t *)vnodeBufPoolMallocAligned(pPool, 100);
+  EXPECT_EQ(p3, p1);
+  EXPECT_EQ(pPool->nChunk, 1);
+  EXPECT_EQ(pPool->size, (int64_t)kChunkSize);
+}
@@ -0,0 +1,138 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef VNODE_TEST_UTIL_H
+#define VNODE_TEST_UTIL_H
+
+#include <gtest/gtest.h>
+
+#include <functional>
+#include <vector>
+
+#include "vnd.h"
+
+// A vnode with just meta open in its own directory, driven the way vnodeSvr drives it. Every request takes a new
+// version. Submits are built here for the tables created, for the tests to feed them to the tq reader or the tsdb.
+class VnodeMetaTest : public ::testing::Test {
+ protected:
+  // builds row r of a block into pRow, from tdSRowInit to tdSRowEnd
+  typedef std::function<void(STSRow *pRow, int32_t r)> FBuildRow;
+
+  // the rows of a block of a submit
+  struct STestBlk {
+    tb_uid_t  uid;
+    tb_uid_t  suid;
+    int32_t   nRows;
+    FBuildRow buildRow;
+  };
+
+  explicit VnodeMetaTest(const char *dir) : kDir(dir) {}
+
+  const char *const kDir;
+  SVnode           *pVnode = nullptr;
+  int64_t           version = 0;
+
+  void SetUp() override {
+    taosRemoveDir(kDir);
+    taosMkDir(kDir);
+
+    pVnode = (SVnode *)taosMemoryCalloc(1, sizeof(SVnode));
+    pVnode->path = tstrdup(kDir);
+    pVnode->config = vnodeCfgDefault;
+    pVnode->config.vgId = 2;
+    ASSERT_EQ(metaOpen(pVnode, &pVnode->pMeta, 0), 0);
+    ASSERT_EQ(metaBegin(pVnode->pMeta, META_BEGIN_HEAP_OS), 0);
+  }
+
+  void TearDown() override {
+    if (pVnode->pMeta) metaClose(pVnode->pMeta);
+    taosMemoryFree(pVnode->path);
+    taosMemoryFree(pVnode);
+    taosRemoveDir(kDir);
+  }
+
+  // the child table ctb<uid> of the super table stb
+  void createTable(tb_uid_t uid, tb_uid_t suid, const std::vector<STagVal> &tagVals) {
+    char    name[TSDB_TABLE_NAME_LEN];
+    SArray *pTagVals = taosArrayInit(tagVals.size() + 1, sizeof(STagVal));
+    STag   *pTag = NULL;
+    for (const STagVal &tagVal : tagVals) {
+      taosArrayPush(pTagVals, &tagVal);
+    }
+    ASSERT_EQ(tTagNew(pTagVals, 1, false, &pTag), 0);
+    taosArrayDestroy(pTagVals);
+
+    snprintf(name, sizeof(name), "ctb%" PRId64, uid);
+    SVCreateTbReq req = {0};
+    req.name = name;
+    req.uid = uid;
+    req.type = TSDB_CHILD_TABLE;
+    req.ctb.stbName = (char *)"stb";
+    req.ctb.suid = suid;
+    req.ctb.pTag = (uint8_t *)pTag;
+    ASSERT_EQ(metaCreateTable(pVnode->pMeta, ++version, &req, NULL), 0);
+    tTagFree(pTag);
+  }
+
+  // appends the value of column iCol, the k-th cell of the row, pVal NULL for null
+  static void appendCell(SRowBuilder *pBuilder, const STSchema *pTSchema, int32_t iCol, int32_t k, const void *pVal) {
+    const STColumn *pCol = &pTSchema->columns[iCol];
+    int32_t         offset = TD_IS_TP_ROW_T(pBuilder->rowType) ? pCol->offset : k * (int32_t)sizeof(SKvRowIdx);
+    col_id_t        colIdx = TD_IS_TP_ROW_T(pBuilder->rowType) ? iCol : k;
+
+    if (pVal == NULL) {
+      tdAppendColValToRow(pBuilder, pCol->colId, pCol->type, TD_VTYPE_NULL, NULL, false, offset, colIdx);
+    } else {
+      tdAppendColValToRow(pBuilder, pCol->colId, pCol->type, TD_VTYPE_NORM, pVal, true, offset, colIdx);
+    }
+  }
+
+  // a submit of the blocks, with the rows of the schema. The blocks with no rows are left out.
+  static SSubmitReq *genSubmit(const STSchema *pTSchema, const std::vector<STestBlk> &blks) {
+    int32_t nRows = 0;
+    for (const STestBlk &blk : blks) nRows += blk.nRows;
+
+    int32_t     rowLen = TD_ROW_MAX_BYTES_FROM_SCHEMA(pTSchema);
+    int32_t     msgLen = sizeof(SSubmitReq) + blks.size() * sizeof(SSubmitBlk) + rowLen * nRows;
+    SSubmitReq *pMsg = (SSubmitReq *)taosMemoryCalloc(1, msgLen);
+    int32_t     offset = sizeof(SSubmitReq);
+    int32_t     numOfBlocks = 0;
+
+    for (const STestBlk &blk : blks) {
+      if (blk.nRows == 0) continue;
+
+      SSubmitBlk *pBlk = (SSubmitBlk *)POINTER_SHIFT(pMsg, offset);
+      STSRow     *pRow = (STSRow *)pBlk->data;
+      int32_t     dataLen = 0;
+      for (int32_t r = 0; r < blk.nRows; ++r) {
+        blk.buildRow(pRow, r);
+        dataLen += TD_ROW_LEN(pRow);
+        pRow = (STSRow *)POINTER_SHIFT(pRow, TD_ROW_LEN(pRow));
+      }
+      pBlk->uid = htobe64(blk.uid);
+      pBlk->suid = htobe64(blk.suid);
+      pBlk->sversion = htonl(pTSchema->version);
+      pBlk->dataLen = htonl(dataLen);
+      pBlk->numOfRows = htonl(blk.nRows);
+      offset += sizeof(SSubmitBlk) + dataLen;
+      ++numOfBlocks;
+    }
+    pMsg->length = htonl(offset);
+    pMsg->numOfBlocks = htonl(numOfBlocks);
+    return pMsg;
+  }
+};
+
+#endif  // VNODE_TEST_UTIL_H
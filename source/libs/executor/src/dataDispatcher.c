@@ -27,6 +27,7 @@ extern SDataSinkStat gDataSinkStat;
 typedef struct SDataDispatchBuf {
   int32_t useSize;
   int32_t allocSize;
+  int8_t  compressed;
   char*   pData;
 } SDataDispatchBuf;
 
@@ -59,8 +60,25 @@ typedef struct SDataDispatchHandle {
 // +----------------+------------------+--------------+--------------+------------------+--------------------------------------------+------------------------------------+-------------+-----------+-------------+-----------+
 // The length of bitmap is decided by number of rows of this data block, and the length of each column data is
 // recorded in the first segment, next to the struct header
+// A block with any column larger than compressColData is encoded with each column compressed, see
+// blockCompressEncode.
 // clang-format on
-static void toDataCacheEntry(SDataDispatchHandle* pHandle, const SInputData* pInput, SDataDispatchBuf* pBuf) {
+static bool needCompress(const SSDataBlock* pData, int32_t numOfCols) {
+  if (tsCompressColData < 0 || 0 == pData->info.rows) {
+    return false;
+  }
+
+  for (int32_t col = 0; col < numOfCols; ++col) {
+    SColumnInfoData* pColRes = taosArrayGet(pData->pDataBlock, col);
+    if (colDataGetLength(pColRes, pData->info.rows) > tsCompressColData) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+static int32_t getNumOfOutputCols(SDataDispatchHandle* pHandle) {
   int32_t numOfCols = 0;
   SNode*  pNode;
   FOREACH(pNode, pHandle->pSchema->pSlots) {
@@ -69,14 +87,28 @@ static void toDataCacheEntry(SDataDispatchHandle* pHandle, const SInputData* pIn
       ++numOfCols;
     }
   }
+  return numOfCols;
+}
+
+static void toDataCacheEntry(SDataDispatchHandle* pHandle, const SInputData* pInput, SDataDispatchBuf* pBuf) {
+  int32_t          numOfCols = getNumOfOutputCols(pHandle);
   SDataCacheEntry* pEntry = (SDataCacheEntry*)pBuf->pData;
-  pEntry->compressed = 0;
+  pEntry->compressed = pBuf->compressed;
   pEntry->numOfRows = pInput->pData->info.rows;
   pEntry->numOfCols = numOfCols;
   pEntry->dataLen = 0;
 
   pBuf->useSize = sizeof(SDataCacheEntry);
-  pEntry->dataLen = blockEncode(pInput->pData, pEntry->data, numOfCols);
+  if (pEntry->compressed) {
+    pEntry->dataLen = blockCompressEncode(pInput->pData, pEntry->data, numOfCols);
+    if (pEntry->dataLen < 0) {
+      qWarn("failed to compress data block since %s, send it uncompressed", terrstr());
+      pEntry->compressed = 0;
+    }
+  }
+  if (!pEntry->compressed) {
+    pEntry->dataLen = blockEncode(pInput->pData, pEntry->data, numOfCols);
+  }
 //  ASSERT(pEntry->numOfRows == *(int32_t*)(pEntry->data + 8));
 //  ASSERT(pEntry->numOfCols == *(int32_t*)(pEntry->data + 8 + 4));
 
@@ -96,7 +128,9 @@ static bool allocBuf(SDataDispatchHandle* pDispatcher, const SInputData* pInput,
     }
   */
 
-  pBuf->allocSize = sizeof(SDataCacheEntry) + blockGetEncodeSize(pInput->pData);
+  pBuf->compressed = needCompress(pInput->pData, getNumOfOutputCols(pDispatcher));
+  pBuf->allocSize = sizeof(SDataCacheEntry) +
+                    (pBuf->compressed ? blockGetCompressEncodeSize(pInput->pData) : blockGetEncodeSize(pInput->pData));
 
   pBuf->pData = taosMemoryMalloc(pBuf->allocSize);
   if (pBuf->pData == NULL) {
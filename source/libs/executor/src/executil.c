@@ -430,8 +430,14 @@ static SColumnInfoData* getColInfoResult(void* metaHandle, int64_t suid, SArray*
   //  int64_t stt = taosGetTimestampUs();
   tags = taosHashInit(32, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BIGINT), false, HASH_NO_LOCK);
 
+  // the tags are copied from the columnar tag cache of the super table if possible, without decoding them per table
+  bool    tagColFilled = false;
   int32_t filter = optimizeTbnameInCond(metaHandle, suid, uidList, pTagCond, tags);
-  if (filter == -1) {
+  if (filter == -1 && suid != 0) {
+    tagColFilled = (metaGetTableTagCols(metaHandle, suid, uidList, pResBlock) == TSDB_CODE_SUCCESS);
+  }
+
+  if (filter == -1 && !tagColFilled) {
     code = metaGetTableTags(metaHandle, suid, uidList, tags);
     if (code != TSDB_CODE_SUCCESS) {
       qError("failed to get table tags from meta, reason:%s, suid:%" PRIu64, tstrerror(code), suid);
@@ -439,7 +445,7 @@ static SColumnInfoData* getColInfoResult(void* metaHandle, int64_t suid, SArray*
       goto end;
     }
   }
-  if (suid != 0) {
+  if (suid != 0 && !tagColFilled) {
     removeInvalidTable(uidList, tags);
   }
 
@@ -466,7 +472,7 @@ static SColumnInfoData* getColInfoResult(void* metaHandle, int64_t suid, SArray*
 #if TAG_FILTER_DEBUG
         qDebug("tagfilter uid:%ld, tbname:%s", *uid, str + 2);
 #endif
-      } else {
+      } else if (!tagColFilled) {
         void* tag = taosHashGet(tags, uid, sizeof(int64_t));
         if (tag == NULL) {
           continue;
@@ -598,9 +604,22 @@ int32_t getColInfoResultForGroupby(void* metaHandle, SNodeList* group, STableLis
 
   //  int64_t stt = taosGetTimestampUs();
   tags = taosHashInit(32, taosGetDefaultHashFunction(TSDB_DATA_TYPE_BIGINT), false, HASH_NO_LOCK);
-  code = metaGetTableTags(metaHandle, pTableListInfo->suid, uidList, tags);
-  if (code != TSDB_CODE_SUCCESS) {
-    goto end;
+
+  bool tagColFilled = false;
+  if (pTableListInfo->suid != 0) {
+    tagColFilled =
+        (metaGetTableTagCols(metaHandle, pTableListInfo->suid, uidList, pResBlock) == TSDB_CODE_SUCCESS);
+    if (tagColFilled && taosArrayGetSize(uidList) != rows) {  // some tables are dropped
+      code = TSDB_CODE_PAR_TABLE_NOT_EXIST;
+      goto end;
+    }
+  }
+
+  if (!tagColFilled) {
+    code = metaGetTableTags(metaHandle, pTableListInfo->suid, uidList, tags);
+    if (code != TSDB_CODE_SUCCESS) {
+      goto end;
+    }
   }
 
   //  int64_t stt1 = taosGetTimestampUs();
@@ -624,7 +643,7 @@ int32_t getColInfoResultForGroupby(void* metaHandle, SNodeList* group, STableLis
 #if TAG_FILTER_DEBUG
         qDebug("tagfilter uid:%ld, tbname:%s", *uid, str + 2);
 #endif
-      } else {
+      } else if (!tagColFilled) {
         void* tag = taosHashGet(tags, uid, sizeof(int64_t));
         ASSERT(tag);
 
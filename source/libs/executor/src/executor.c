@@ -15,6 +15,7 @@
 
 #include "executor.h"
 #include "executorimpl.h"
+#include "functionMgt.h"
 #include "planner.h"
 #include "tdatablock.h"
 #include "tref.h"
@@ -278,6 +279,130 @@ qTaskInfo_t qCreateStreamExecTaskInfo(void* msg, SReadHandle* readers) {
   return pTaskInfo;
 }
 
+// the input of a rollup is the stream scan of the super table, partitioned by tbname and not filtered
+static bool isRollupInput(SPhysiNode* pNode) {
+  while (pNode->pConditions == NULL && LIST_LENGTH(pNode->pChildren) == 1) {
+    pNode = (SPhysiNode*)nodesListGetNode(pNode->pChildren, 0);
+    if (pNode->pConditions != NULL) {
+      return false;
+    }
+    if (nodeType(pNode) == QUERY_NODE_PHYSICAL_PLAN_STREAM_SCAN) {
+      return LIST_LENGTH(pNode->pChildren) == 0;
+    }
+    if (nodeType(pNode) != QUERY_NODE_PHYSICAL_PLAN_PARTITION &&
+        nodeType(pNode) != QUERY_NODE_PHYSICAL_PLAN_STREAM_PARTITION) {
+      return false;
+    }
+    SPartitionPhysiNode* pPartNode = (SPartitionPhysiNode*)pNode;
+    SNode*               pKey = nodesListGetNode(pPartNode->pPartitionKeys, 0);
+    if (pPartNode->pExprs != NULL || LIST_LENGTH(pPartNode->pPartitionKeys) != 1 ||
+        nodeType(pKey) != QUERY_NODE_FUNCTION || ((SFunctionNode*)pKey)->funcType != FUNCTION_TYPE_TBNAME) {
+      return false;
+    }
+  }
+  return false;
+}
+
+// the function aggregates one column, and the implicit primary key parameter of first/last if any
+static bool extractRollupFunc(SFunctionNode* pFunc, SRollupFunc* pRollupFunc) {
+  SColumnNode* pCol = (SColumnNode*)nodesListGetNode(pFunc->pParameterList, 0);
+  if (pCol == NULL || nodeType(pCol) != QUERY_NODE_COLUMN || pCol->colType != COLUMN_TYPE_COLUMN ||
+      pCol->colId == PRIMARYKEY_TIMESTAMP_COL_ID) {
+    return false;
+  }
+
+  SNode* pParam = NULL;
+  FOREACH(pParam, pFunc->pParameterList) {
+    if (pParam == (SNode*)pCol) continue;
+    if (nodeType(pParam) != QUERY_NODE_COLUMN || ((SColumnNode*)pParam)->colId != PRIMARYKEY_TIMESTAMP_COL_ID) {
+      return false;
+    }
+  }
+
+  tstrncpy(pRollupFunc->funcName, pFunc->functionName, sizeof(pRollupFunc->funcName));
+  pRollupFunc->colId = pCol->colId;
+  return true;
+}
+
+int32_t qExtractRollupInfo(const char* msg, SRollupInfo* pInfo) {
+  if (msg == NULL || pInfo == NULL) {
+    return TSDB_CODE_INVALID_PARA;
+  }
+
+  memset(pInfo, 0, sizeof(SRollupInfo));
+
+  SSubplan* pPlan = NULL;
+  int32_t   code = qStringToSubplan(msg, &pPlan);
+  if (code != TSDB_CODE_SUCCESS) {
+    return code;
+  }
+
+  code = TSDB_CODE_OPS_NOT_SUPPORT;
+  SPhysiNode* pNode = pPlan->pNode;
+  if (nodeType(pNode) != QUERY_NODE_PHYSICAL_PLAN_STREAM_INTERVAL || !isRollupInput(pNode)) {
+    goto _end;
+  }
+
+  SStreamIntervalPhysiNode* pIntervalNode = (SStreamIntervalPhysiNode*)pNode;
+  int32_t                   numOfFuncs = LIST_LENGTH(pIntervalNode->window.pFuncs);
+  if (pIntervalNode->window.pExprs != NULL || numOfFuncs < 2) {
+    goto _end;
+  }
+
+  pInfo->pFuncs = taosArrayInit(numOfFuncs - 1, sizeof(SRollupFunc));
+  if (pInfo->pFuncs == NULL) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    goto _end;
+  }
+  taosArraySetSize(pInfo->pFuncs, numOfFuncs - 1);
+  memset(pInfo->pFuncs->pData, 0, taosArrayGetSize(pInfo->pFuncs) * sizeof(SRollupFunc));
+
+  // _wstart is the first result column, and each of the others is an aggregate of one column
+  bool   hasWstart = false;
+  SNode* pNodeT = NULL;
+  FOREACH(pNodeT, pIntervalNode->window.pFuncs) {
+    STargetNode*   pTarget = (STargetNode*)pNodeT;
+    SFunctionNode* pFunc = (SFunctionNode*)pTarget->pExpr;
+    if (nodeType(pTarget) != QUERY_NODE_TARGET || nodeType(pFunc) != QUERY_NODE_FUNCTION || pTarget->slotId < 0 ||
+        pTarget->slotId >= numOfFuncs) {
+      goto _end;
+    }
+    if (pTarget->slotId == 0) {
+      if (pFunc->funcType != FUNCTION_TYPE_WSTART || hasWstart) goto _end;
+      hasWstart = true;
+      continue;
+    }
+    SRollupFunc* pRollupFunc = taosArrayGet(pInfo->pFuncs, pTarget->slotId - 1);
+    if (pRollupFunc->funcName[0] != 0 || !extractRollupFunc(pFunc, pRollupFunc)) {
+      goto _end;
+    }
+  }
+  if (!hasWstart) {
+    goto _end;
+  }
+
+  pInfo->interval = (SInterval){
+      .interval = pIntervalNode->interval,
+      .sliding = pIntervalNode->sliding,
+      .intervalUnit = pIntervalNode->intervalUnit,
+      .slidingUnit = pIntervalNode->slidingUnit,
+      .offset = pIntervalNode->offset,
+      .precision = ((SColumnNode*)pIntervalNode->window.pTspk)->node.resType.precision,
+  };
+  pInfo->watermark = pIntervalNode->window.watermark;
+  pInfo->deleteMark = getDeleteMark(pIntervalNode);
+  pInfo->igExpired = pIntervalNode->window.igExpired;
+  code = TSDB_CODE_SUCCESS;
+
+_end:
+  if (code != TSDB_CODE_SUCCESS) {
+    taosArrayDestroy(pInfo->pFuncs);
+    pInfo->pFuncs = NULL;
+  }
+  nodesDestroyNode((SNode*)pPlan);
+  return code;
+}
+
 static SArray* filterUnqualifiedTables(const SStreamScanInfo* pScanInfo, const SArray* tableIdList, const char* idstr) {
   SArray* qa = taosArrayInit(4, sizeof(tb_uid_t));
 
@@ -27,6 +27,28 @@
 #include "thash.h"
 #include "ttypes.h"
 
+#define GROUP_BATCH_SLOTS      4096  // open addressing slots of the per block group table, power of 2
+#define GROUP_BATCH_MAX_GROUPS (GROUP_BATCH_SLOTS / 4)
+#define GROUP_BATCH_MIN_ROWS   64
+#define GROUP_BATCH_MAX_KEYLEN 64
+
+// Per block state of the batched group by path: all keys of a block are hashed column by column, rows are
+// assigned to groups through an open addressing table and regrouped, and the aggregate functions then run
+// once per group over a contiguous range instead of once per key change.
+typedef struct SGroupBatchSup {
+  bool         enabled;     // all group by columns are fixed length
+  int32_t      keyWidth;    // null flag + value bytes of each group by column
+  int32_t      capacity;    // rows the buffers below can hold
+  char*        pKeys;       // keyWidth bytes for each row
+  uint32_t*    pHash;       // hash value of each row
+  int32_t*     pRowGroup;   // group of each row
+  int32_t*     pRowIndex;   // rows ordered by group
+  int32_t      slots[GROUP_BATCH_SLOTS];  // group + 1, 0 for an empty slot
+  int32_t      groupRow[GROUP_BATCH_MAX_GROUPS];    // first row of each group
+  int32_t      groupStart[GROUP_BATCH_MAX_GROUPS + 1];
+  SSDataBlock* pGrouped;    // rows of the input block ordered by group
+} SGroupBatchSup;
+
 typedef struct SGroupbyOperatorInfo {
   SOptrBasicInfo binfo;
   SAggSupporter  aggSup;
@@ -37,6 +59,7 @@ typedef struct SGroupbyOperatorInfo {
   int32_t        groupKeyLen;    // total group by column width
   SGroupResInfo  groupResInfo;
   SExprSupp      scalarSup;
+  SGroupBatchSup batchSup;
 } SGroupbyOperatorInfo;
 
 // The sort in partition may be needed later.
@@ -63,6 +86,8 @@ static int32_t  setGroupResultOutputBuf(SOperatorInfo* pOperator, SOptrBasicInfo
                                         int16_t bytes, uint64_t groupId, SDiskbasedBuf* pBuf, SAggSupporter* pAggSup);
 static SArray*  extractColumnInfo(SNodeList* pNodeList);
 
+static void cleanupGroupBatchSup(SGroupBatchSup* pSup);
+
 static void freeGroupKey(void* param) {
   SGroupKeys* pKey = (SGroupKeys*)param;
   taosMemoryFree(pKey->pData);
@@ -82,6 +107,7 @@ static void destroyGroupOperatorInfo(void* param) {
 
   cleanupGroupResInfo(&pInfo->groupResInfo);
   cleanupAggSup(&pInfo->aggSup);
+  cleanupGroupBatchSup(&pInfo->batchSup);
   taosMemoryFreeClear(param);
 }
 
@@ -263,6 +289,306 @@ static void doAssignGroupKeys(SqlFunctionCtx* pCtx, int32_t numOfOutput, int32_t
   }
 }
 
+static void initGroupBatchSup(SGroupBatchSup* pSup, const SArray* pGroupCols) {
+  int32_t numOfGroupCols = taosArrayGetSize(pGroupCols);
+
+  pSup->enabled = numOfGroupCols > 0;
+  pSup->keyWidth = 0;
+  for (int32_t i = 0; i < numOfGroupCols; ++i) {
+    SColumn* pCol = taosArrayGet(pGroupCols, i);
+    if (IS_VAR_DATA_TYPE(pCol->type) || pCol->type == TSDB_DATA_TYPE_JSON) {
+      pSup->enabled = false;
+    }
+    pSup->keyWidth += sizeof(int8_t) + pCol->bytes;
+  }
+
+  if (pSup->keyWidth > GROUP_BATCH_MAX_KEYLEN) {
+    pSup->enabled = false;
+  }
+}
+
+static void cleanupGroupBatchSup(SGroupBatchSup* pSup) {
+  taosMemoryFreeClear(pSup->pKeys);
+  taosMemoryFreeClear(pSup->pHash);
+  taosMemoryFreeClear(pSup->pRowGroup);
+  taosMemoryFreeClear(pSup->pRowIndex);
+  pSup->pGrouped = blockDataDestroy(pSup->pGrouped);
+  pSup->capacity = 0;
+}
+
+static int32_t ensureGroupBatchCapacity(SGroupBatchSup* pSup, int32_t rows) {
+  if (pSup->capacity >= rows) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  char*     pKeys = taosMemoryRealloc(pSup->pKeys, (int64_t)rows * pSup->keyWidth);
+  uint32_t* pHash = taosMemoryRealloc(pSup->pHash, rows * sizeof(uint32_t));
+  int32_t*  pRowGroup = taosMemoryRealloc(pSup->pRowGroup, rows * sizeof(int32_t));
+  int32_t*  pRowIndex = taosMemoryRealloc(pSup->pRowIndex, rows * sizeof(int32_t));
+  if (pKeys != NULL) pSup->pKeys = pKeys;
+  if (pHash != NULL) pSup->pHash = pHash;
+  if (pRowGroup != NULL) pSup->pRowGroup = pRowGroup;
+  if (pRowIndex != NULL) pSup->pRowIndex = pRowIndex;
+  if (pKeys == NULL || pHash == NULL || pRowGroup == NULL || pRowIndex == NULL) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  pSup->capacity = rows;
+  return TSDB_CODE_SUCCESS;
+}
+
+#define GROUP_HASH_MIX(h_, v_) (((h_) ^ (uint32_t)(v_)) * 0x9E3779B1u)
+
+// copy the key columns into fixed width row keys and hash them, one column at a time
+static void buildGroupBatchKeys(SGroupBatchSup* pSup, SArray* pGroupCols, SSDataBlock* pBlock) {
+  int32_t   rows = pBlock->info.rows;
+  int32_t   width = pSup->keyWidth;
+  int32_t   offset = 0;
+  uint32_t* pHash = pSup->pHash;
+
+  memset(pHash, 0, rows * sizeof(uint32_t));
+  for (int32_t i = 0; i < taosArrayGetSize(pGroupCols); ++i) {
+    SColumn*         pCol = taosArrayGet(pGroupCols, i);
+    SColumnInfoData* pColInfoData = taosArrayGet(pBlock->pDataBlock, pCol->slotId);
+    int32_t          bytes = pColInfoData->info.bytes;
+    char*            pKey = pSup->pKeys + offset;
+    const char*      pData = pColInfoData->pData;
+
+    for (int32_t j = 0; j < rows; ++j) {
+      pKey[(int64_t)j * width] = 0;
+      memcpy(pKey + (int64_t)j * width + 1, pData + (int64_t)j * bytes, bytes);
+    }
+
+    if (pColInfoData->hasNull && pColInfoData->nullbitmap != NULL) {
+      // a null row hashes and compares the same whatever is left in its data slot, so hash the row keys
+      for (int32_t j = 0; j < rows; ++j) {
+        char* pRowKey = pKey + (int64_t)j * width;
+        if (colDataIsNull_f(pColInfoData->nullbitmap, j)) {
+          pRowKey[0] = 1;
+          memset(pRowKey + 1, 0, bytes);
+          pHash[j] = GROUP_HASH_MIX(pHash[j], 0x5bd1e995u);
+        } else {
+          pHash[j] = GROUP_HASH_MIX(pHash[j], MurmurHash3_32(pRowKey + 1, bytes));
+        }
+      }
+    } else {
+      switch (bytes) {
+        case sizeof(int8_t):
+          for (int32_t j = 0; j < rows; ++j) {
+            pHash[j] = GROUP_HASH_MIX(pHash[j], ((const uint8_t*)pData)[j]);
+          }
+          break;
+        case sizeof(int16_t):
+          for (int32_t j = 0; j < rows; ++j) {
+            pHash[j] = GROUP_HASH_MIX(pHash[j], ((const uint16_t*)pData)[j]);
+          }
+          break;
+        case sizeof(int32_t):
+          for (int32_t j = 0; j < rows; ++j) {
+            pHash[j] = GROUP_HASH_MIX(pHash[j], ((const uint32_t*)pData)[j]);
+          }
+          break;
+        case sizeof(int64_t):
+          for (int32_t j = 0; j < rows; ++j) {
+            uint64_t v = ((const uint64_t*)pData)[j];
+            pHash[j] = GROUP_HASH_MIX(pHash[j], v ^ (v >> 32));
+          }
+          break;
+        default:
+          for (int32_t j = 0; j < rows; ++j) {
+            pHash[j] = GROUP_HASH_MIX(pHash[j], MurmurHash3_32(pData + (int64_t)j * bytes, bytes));
+          }
+          break;
+      }
+    }
+
+    offset += sizeof(int8_t) + bytes;
+  }
+}
+
+// returns the number of groups in the block, or -1 if there are too many for the batched path to pay off
+static int32_t assignGroupBatchRows(SGroupBatchSup* pSup, int32_t rows) {
+  int32_t width = pSup->keyWidth;
+  int32_t numOfGroups = 0;
+  int32_t maxGroups = TMIN(GROUP_BATCH_MAX_GROUPS, rows / 4);
+
+  memset(pSup->slots, 0, sizeof(pSup->slots));
+  for (int32_t j = 0; j < rows; ++j) {
+    const char* pKey = pSup->pKeys + (int64_t)j * width;
+    uint32_t    slot = pSup->pHash[j] & (GROUP_BATCH_SLOTS - 1);
+
+    while (1) {
+      int32_t g = pSup->slots[slot];
+      if (g == 0) {
+        if (numOfGroups >= maxGroups) {
+          return -1;
+        }
+
+        pSup->groupRow[numOfGroups] = j;
+        pSup->groupStart[numOfGroups] = 0;
+        pSup->slots[slot] = ++numOfGroups;
+        pSup->pRowGroup[j] = numOfGroups - 1;
+        break;
+      }
+
+      if (pSup->pHash[pSup->groupRow[g - 1]] == pSup->pHash[j] &&
+          memcmp(pSup->pKeys + (int64_t)pSup->groupRow[g - 1] * width, pKey, width) == 0) {
+        pSup->pRowGroup[j] = g - 1;
+        break;
+      }
+
+      slot = (slot + 1) & (GROUP_BATCH_SLOTS - 1);
+    }
+
+    pSup->groupStart[pSup->pRowGroup[j]]++;
+  }
+
+  // counts to start positions, the rows keep their order inside each group
+  int32_t start = 0;
+  for (int32_t g = 0; g < numOfGroups; ++g) {
+    int32_t count = pSup->groupStart[g];
+    pSup->groupStart[g] = start;
+    start += count;
+  }
+  pSup->groupStart[numOfGroups] = start;
+
+  for (int32_t j = 0; j < rows; ++j) {
+    pSup->pRowIndex[pSup->groupStart[pSup->pRowGroup[j]]++] = j;
+  }
+  for (int32_t g = numOfGroups; g > 0; --g) {
+    pSup->groupStart[g] = pSup->groupStart[g - 1];
+  }
+  pSup->groupStart[0] = 0;
+
+  return numOfGroups;
+}
+
+static int32_t gatherGroupBatchRows(SGroupBatchSup* pSup, SSDataBlock* pBlock) {
+  int32_t rows = pBlock->info.rows;
+
+  if (pSup->pGrouped == NULL) {
+    pSup->pGrouped = createOneDataBlock(pBlock, false);
+    if (pSup->pGrouped == NULL) {
+      return TSDB_CODE_OUT_OF_MEMORY;
+    }
+  }
+
+  SSDataBlock* pDst = pSup->pGrouped;
+  blockDataCleanup(pDst);
+  if (blockDataEnsureCapacity(pDst, rows) != TSDB_CODE_SUCCESS) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  const int32_t* pRowIndex = pSup->pRowIndex;
+  for (int32_t i = 0; i < taosArrayGetSize(pBlock->pDataBlock); ++i) {
+    SColumnInfoData* pSrc = taosArrayGet(pBlock->pDataBlock, i);
+    SColumnInfoData* pCol = taosArrayGet(pDst->pDataBlock, i);
+
+    if (IS_VAR_DATA_TYPE(pSrc->info.type)) {
+      for (int32_t j = 0; j < rows; ++j) {
+        int32_t r = pRowIndex[j];
+        bool    isNull = colDataIsNull_s(pSrc, r);
+        colDataAppend(pCol, j, isNull ? NULL : colDataGetVarData(pSrc, r), isNull);
+      }
+      continue;
+    }
+
+    int32_t bytes = pSrc->info.bytes;
+    switch (bytes) {
+      case sizeof(int8_t):
+        for (int32_t j = 0; j < rows; ++j) ((int8_t*)pCol->pData)[j] = ((int8_t*)pSrc->pData)[pRowIndex[j]];
+        break;
+      case sizeof(int16_t):
+        for (int32_t j = 0; j < rows; ++j) ((int16_t*)pCol->pData)[j] = ((int16_t*)pSrc->pData)[pRowIndex[j]];
+        break;
+      case sizeof(int32_t):
+        for (int32_t j = 0; j < rows; ++j) ((int32_t*)pCol->pData)[j] = ((int32_t*)pSrc->pData)[pRowIndex[j]];
+        break;
+      case sizeof(int64_t):
+        for (int32_t j = 0; j < rows; ++j) ((int64_t*)pCol->pData)[j] = ((int64_t*)pSrc->pData)[pRowIndex[j]];
+        break;
+      default:
+        for (int32_t j = 0; j < rows; ++j) {
+          memcpy(pCol->pData + (int64_t)j * bytes, pSrc->pData + (int64_t)pRowIndex[j] * bytes, bytes);
+        }
+        break;
+    }
+
+    pCol->hasNull = pSrc->hasNull;
+    if (pSrc->hasNull && pSrc->nullbitmap != NULL) {
+      memset(pCol->nullbitmap, 0, BitmapLen(rows));
+      for (int32_t j = 0; j < rows; ++j) {
+        if (colDataIsNull_f(pSrc->nullbitmap, pRowIndex[j])) {
+          colDataSetNull_f(pCol->nullbitmap, j);
+        }
+      }
+    }
+  }
+
+  pDst->info.rows = rows;
+  pDst->info.id = pBlock->info.id;
+  pDst->info.type = pBlock->info.type;
+  pDst->info.window = pBlock->info.window;
+  pDst->info.version = pBlock->info.version;
+  pDst->info.dataLoad = pBlock->info.dataLoad;
+  return TSDB_CODE_SUCCESS;
+}
+
+// returns false if the block is left to the row by row path, nothing has been aggregated in that case
+static bool doHashGroupbyAggBatch(SOperatorInfo* pOperator, SSDataBlock* pBlock, int32_t order, int32_t scanFlag) {
+  SExecTaskInfo*        pTaskInfo = pOperator->pTaskInfo;
+  SGroupbyOperatorInfo* pInfo = pOperator->info;
+  SGroupBatchSup*       pSup = &pInfo->batchSup;
+  SqlFunctionCtx*       pCtx = pOperator->exprSupp.pCtx;
+  int32_t               rows = pBlock->info.rows;
+
+  if (!pSup->enabled || pBlock->pBlockAgg != NULL || rows < GROUP_BATCH_MIN_ROWS) {
+    return false;
+  }
+
+  if (ensureGroupBatchCapacity(pSup, rows) != TSDB_CODE_SUCCESS) {
+    return false;
+  }
+
+  buildGroupBatchKeys(pSup, pInfo->pGroupCols, pBlock);
+  int32_t numOfGroups = assignGroupBatchRows(pSup, rows);
+  if (numOfGroups <= 0) {
+    return false;
+  }
+
+  // rows of one group are contiguous already if the order by group is the identity
+  SSDataBlock* pSrc = pBlock;
+  for (int32_t j = 0; j < rows; ++j) {
+    if (pSup->pRowIndex[j] != j) {
+      if (gatherGroupBatchRows(pSup, pBlock) != TSDB_CODE_SUCCESS) {
+        T_LONG_JMP(pTaskInfo->env, TSDB_CODE_OUT_OF_MEMORY);
+      }
+      pSrc = pSup->pGrouped;
+      setInputDataBlock(&pOperator->exprSupp, pSrc, order, scanFlag, true);
+      break;
+    }
+  }
+
+  for (int32_t g = 0; g < numOfGroups; ++g) {
+    int32_t rowIndex = pSup->groupStart[g];
+    int32_t num = pSup->groupStart[g + 1] - rowIndex;
+
+    recordNewGroupKeys(pInfo->pGroupCols, pInfo->pGroupColVals, pSrc, rowIndex);
+    int32_t len = buildGroupKeys(pInfo->keyBuf, pInfo->pGroupColVals);
+    int32_t ret = setGroupResultOutputBuf(pOperator, &(pInfo->binfo), pOperator->exprSupp.numOfExprs, pInfo->keyBuf,
+                                          len, pBlock->info.id.groupId, pInfo->aggSup.pResultBuf, &pInfo->aggSup);
+    if (ret != TSDB_CODE_SUCCESS) {
+      T_LONG_JMP(pTaskInfo->env, TSDB_CODE_APP_ERROR);
+    }
+
+    applyAggFunctionOnPartialTuples(pTaskInfo, pCtx, NULL, rowIndex, num, rows, pOperator->exprSupp.numOfExprs);
+    doAssignGroupKeys(pCtx, pOperator->exprSupp.numOfExprs, rows, rowIndex);
+  }
+
+  pInfo->isInit = true;
+  return true;
+}
+
 static void doHashGroupbyAgg(SOperatorInfo* pOperator, SSDataBlock* pBlock) {
   SExecTaskInfo*        pTaskInfo = pOperator->pTaskInfo;
   SGroupbyOperatorInfo* pInfo = pOperator->info;
@@ -401,7 +727,9 @@ static SSDataBlock* hashGroupbyAggregate(SOperatorInfo* pOperator) {
       }
     }
 
-    doHashGroupbyAgg(pOperator, pBlock);
+    if (!doHashGroupbyAggBatch(pOperator, pBlock, order, scanFlag)) {
+      doHashGroupbyAgg(pOperator, pBlock);
+    }
   }
 
   pOperator->status = OP_RES_TO_RETURN;
@@ -455,6 +783,7 @@ SOperatorInfo* createGroupOperatorInfo(SOperatorInfo* downstream, SAggPhysiNode*
   if (code != TSDB_CODE_SUCCESS) {
     goto _error;
   }
+  initGroupBatchSup(&pInfo->batchSup, pInfo->pGroupCols);
 
   int32_t    num = 0;
   SExprInfo* pExprInfo = createExprInfo(pAggNode->pAggFuncs, pAggNode->pGroupKeys, &num);
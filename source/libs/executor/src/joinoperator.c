@@ -22,6 +22,7 @@
 #include "tdatablock.h"
 #include "thash.h"
 #include "tmsg.h"
+#include "tpagedbuf.h"
 #include "ttypes.h"
 
 typedef struct SJoinOperatorInfo {
@@ -430,3 +431,455 @@ SSDataBlock* doMergeJoin(struct SOperatorInfo* pOperator) {
   }
   return (pRes->info.rows > 0) ? pRes : NULL;
 }
+
+#define HJOIN_INVALID_PAGE (-1)
+
+// location of a build row in the paged buffer
+typedef struct SHJoinRowRef {
+  int32_t pageId;
+  int32_t offset;
+} SHJoinRowRef;
+
+typedef struct SHJoinColMap {
+  int32_t srcSlot;
+  int32_t dstSlot;
+  int16_t type;
+  int32_t bytes;
+} SHJoinColMap;
+
+typedef struct SHashJoinOperatorInfo {
+  SSDataBlock*   pRes;
+  int32_t        numOfKeys;
+  SColumnInfo*   pLeftKeys;
+  SColumnInfo*   pRightKeys;
+  char*          keyBuf;
+  int32_t        numOfProbeCols;
+  SHJoinColMap*  pProbeCols;  // left columns copied from the probe block
+  int32_t        numOfBuildCols;
+  SHJoinColMap*  pBuildCols;  // right columns kept in the build rows
+  int32_t        maxRowSize;
+  SHashObj*      pBuildTable;  // key -> SHJoinRowRef of the latest build row, older ones are chained by the row
+  SDiskbasedBuf* pBuf;         // build rows, spilled to disk when they do not fit in memory
+  int32_t        writePageId;
+  int32_t        writeOffset;
+  char*          pWritePage;
+  int32_t        readPageId;
+  char*          pReadPage;
+  int64_t        numOfBuildRows;
+  bool           built;
+  SSDataBlock*   pProbe;
+  int32_t        probeRow;
+  SHJoinRowRef   nextMatch;
+  SNode*         pCondAfterJoin;
+} SHashJoinOperatorInfo;
+
+static SSDataBlock* doHashJoin(struct SOperatorInfo* pOperator);
+static void         destroyHashJoinOperator(void* param);
+
+static int32_t hashJoinInitKeys(SColumnInfo** ppKeys, SNodeList* pKeyList, int32_t* keyLen) {
+  *ppKeys = taosMemoryCalloc(LIST_LENGTH(pKeyList), sizeof(SColumnInfo));
+  if (*ppKeys == NULL) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  int32_t i = 0;
+  SNode*  pNode = NULL;
+  *keyLen = 0;
+  FOREACH(pNode, pKeyList) {
+    setJoinColumnInfo(&(*ppKeys)[i++], (SColumnNode*)pNode);
+    *keyLen += ((SColumnNode*)pNode)->node.resType.bytes;
+  }
+  return TSDB_CODE_SUCCESS;
+}
+
+static int32_t hashJoinInitColMap(SHashJoinOperatorInfo* pInfo, SExprInfo* pExprInfo, int32_t numOfExprs,
+                                  int32_t leftBlockId) {
+  pInfo->pProbeCols = taosMemoryCalloc(numOfExprs, sizeof(SHJoinColMap));
+  pInfo->pBuildCols = taosMemoryCalloc(numOfExprs, sizeof(SHJoinColMap));
+  if (pInfo->pProbeCols == NULL || pInfo->pBuildCols == NULL) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  pInfo->maxRowSize = sizeof(SHJoinRowRef);
+  for (int32_t i = 0; i < numOfExprs; ++i) {
+    SColumn*     pCol = pExprInfo[i].base.pParam[0].pCol;
+    SHJoinColMap col = {.srcSlot = pCol->slotId, .dstSlot = i, .type = pCol->type, .bytes = pCol->bytes};
+    if (pCol->dataBlockId == leftBlockId) {
+      pInfo->pProbeCols[pInfo->numOfProbeCols++] = col;
+    } else {
+      pInfo->pBuildCols[pInfo->numOfBuildCols++] = col;
+      pInfo->maxRowSize += sizeof(int8_t) + pCol->bytes;
+    }
+  }
+  return TSDB_CODE_SUCCESS;
+}
+
+SOperatorInfo* createHashJoinOperatorInfo(SOperatorInfo** pDownstream, int32_t numOfDownstream,
+                                          SHashJoinPhysiNode* pJoinNode, SExecTaskInfo* pTaskInfo) {
+  SHashJoinOperatorInfo* pInfo = taosMemoryCalloc(1, sizeof(SHashJoinOperatorInfo));
+  SOperatorInfo*         pOperator = taosMemoryCalloc(1, sizeof(SOperatorInfo));
+
+  int32_t code = TSDB_CODE_SUCCESS;
+  if (pOperator == NULL || pInfo == NULL) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    goto _error;
+  }
+
+  int32_t numOfCols = 0;
+  pInfo->pRes = createDataBlockFromDescNode(pJoinNode->node.pOutputDataBlockDesc);
+
+  SExprInfo* pExprInfo = createExprInfo(pJoinNode->pTargets, NULL, &numOfCols);
+  initResultSizeInfo(&pOperator->resultInfo, 4096);
+  blockDataEnsureCapacity(pInfo->pRes, pOperator->resultInfo.capacity);
+
+  setOperatorInfo(pOperator, "HashJoinOperator", QUERY_NODE_PHYSICAL_PLAN_HASH_JOIN, false, OP_NOT_OPENED, pInfo,
+                  pTaskInfo);
+  pOperator->exprSupp.pExprInfo = pExprInfo;
+  pOperator->exprSupp.numOfExprs = numOfCols;
+
+  // both sides build their keys into keyBuf, and the key columns of the two sides may differ in width
+  int32_t leftKeyLen = 0;
+  int32_t rightKeyLen = 0;
+  pInfo->numOfKeys = LIST_LENGTH(pJoinNode->pLeftKeys);
+  code = hashJoinInitKeys(&pInfo->pLeftKeys, pJoinNode->pLeftKeys, &leftKeyLen);
+  if (code == TSDB_CODE_SUCCESS) {
+    code = hashJoinInitKeys(&pInfo->pRightKeys, pJoinNode->pRightKeys, &rightKeyLen);
+  }
+  if (code == TSDB_CODE_SUCCESS) {
+    code = hashJoinInitColMap(pInfo, pExprInfo, numOfCols, pDownstream[0]->resultDataBlockId);
+  }
+  if (code != TSDB_CODE_SUCCESS) {
+    goto _error;
+  }
+
+  pInfo->keyBuf = taosMemoryMalloc(TMAX(leftKeyLen, rightKeyLen));
+  _hash_fn_t hashFn = taosGetDefaultHashFunction(TSDB_DATA_TYPE_BINARY);
+  pInfo->pBuildTable = taosHashInit(1024, hashFn, false, HASH_NO_LOCK);
+  if (pInfo->keyBuf == NULL || pInfo->pBuildTable == NULL) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    goto _error;
+  }
+
+  if (!osTempSpaceAvailable()) {
+    code = TSDB_CODE_NO_AVAIL_DISK;
+    qError("Create hash join operator info failed since %s, %s", tstrerror(code), GET_TASKID(pTaskInfo));
+    goto _error;
+  }
+
+  uint32_t defaultPgsz = 0;
+  uint32_t defaultBufsz = 0;
+  getBufferPgSize(pInfo->maxRowSize, &defaultPgsz, &defaultBufsz);
+  code = createDiskbasedBuf(&pInfo->pBuf, defaultPgsz, defaultBufsz, pTaskInfo->id.str, tsTempDir);
+  if (code != TSDB_CODE_SUCCESS) {
+    goto _error;
+  }
+  pInfo->writePageId = HJOIN_INVALID_PAGE;
+  pInfo->readPageId = HJOIN_INVALID_PAGE;
+  pInfo->nextMatch.pageId = HJOIN_INVALID_PAGE;
+
+  if (pJoinNode->pOnConditions != NULL && pJoinNode->node.pConditions != NULL) {
+    SLogicConditionNode* pLogicCond = (SLogicConditionNode*)nodesMakeNode(QUERY_NODE_LOGIC_CONDITION);
+    if (pLogicCond == NULL) {
+      code = TSDB_CODE_OUT_OF_MEMORY;
+      goto _error;
+    }
+    pInfo->pCondAfterJoin = (SNode*)pLogicCond;
+    pLogicCond->condType = LOGIC_COND_TYPE_AND;
+    nodesListMakeAppend(&pLogicCond->pParameterList, nodesCloneNode(pJoinNode->pOnConditions));
+    nodesListMakeAppend(&pLogicCond->pParameterList, nodesCloneNode(pJoinNode->node.pConditions));
+  } else if (pJoinNode->pOnConditions != NULL) {
+    pInfo->pCondAfterJoin = nodesCloneNode(pJoinNode->pOnConditions);
+  } else if (pJoinNode->node.pConditions != NULL) {
+    pInfo->pCondAfterJoin = nodesCloneNode(pJoinNode->node.pConditions);
+  }
+
+  code = filterInitFromNode(pInfo->pCondAfterJoin, &pOperator->exprSupp.pFilterInfo, 0);
+  if (code != TSDB_CODE_SUCCESS) {
+    goto _error;
+  }
+
+  pOperator->fpSet =
+      createOperatorFpSet(optrDummyOpenFn, doHashJoin, NULL, destroyHashJoinOperator, optrDefaultBufFn, NULL);
+  code = appendDownstream(pOperator, pDownstream, numOfDownstream);
+  if (code != TSDB_CODE_SUCCESS) {
+    goto _error;
+  }
+
+  return pOperator;
+
+_error:
+  if (pInfo != NULL) {
+    destroyHashJoinOperator(pInfo);
+  }
+
+  taosMemoryFree(pOperator);
+  pTaskInfo->code = code;
+  return NULL;
+}
+
+static void hashJoinReleasePages(SHashJoinOperatorInfo* pInfo) {
+  if (pInfo->pWritePage != NULL) {
+    setBufPageDirty(pInfo->pWritePage, true);
+    releaseBufPage(pInfo->pBuf, pInfo->pWritePage);
+    pInfo->pWritePage = NULL;
+  }
+  if (pInfo->pReadPage != NULL) {
+    releaseBufPage(pInfo->pBuf, pInfo->pReadPage);
+    pInfo->pReadPage = NULL;
+    pInfo->readPageId = HJOIN_INVALID_PAGE;
+  }
+}
+
+void destroyHashJoinOperator(void* param) {
+  SHashJoinOperatorInfo* pInfo = (SHashJoinOperatorInfo*)param;
+  if (pInfo->pBuf != NULL) {
+    hashJoinReleasePages(pInfo);
+    destroyDiskbasedBuf(pInfo->pBuf);
+  }
+  taosHashCleanup(pInfo->pBuildTable);
+  nodesDestroyNode(pInfo->pCondAfterJoin);
+  taosMemoryFree(pInfo->pLeftKeys);
+  taosMemoryFree(pInfo->pRightKeys);
+  taosMemoryFree(pInfo->pProbeCols);
+  taosMemoryFree(pInfo->pBuildCols);
+  taosMemoryFree(pInfo->keyBuf);
+
+  pInfo->pRes = blockDataDestroy(pInfo->pRes);
+  taosMemoryFreeClear(param);
+}
+
+// return the length of the key, or -1 if any key column of the row is null, which never matches.
+static int32_t hashJoinBuildKey(SHashJoinOperatorInfo* pInfo, SColumnInfo* pKeys, SSDataBlock* pBlock,
+                                int32_t rowIndex) {
+  int32_t len = 0;
+  for (int32_t i = 0; i < pInfo->numOfKeys; ++i) {
+    SColumnInfoData* pCol = taosArrayGet(pBlock->pDataBlock, pKeys[i].slotId);
+    if (colDataIsNull_s(pCol, rowIndex)) {
+      return -1;
+    }
+
+    char* p = colDataGetData(pCol, rowIndex);
+    if (IS_VAR_DATA_TYPE(pKeys[i].type)) {
+      memcpy(pInfo->keyBuf + len, p, varDataTLen(p));
+      len += varDataTLen(p);
+    } else {
+      memcpy(pInfo->keyBuf + len, p, pKeys[i].bytes);
+      len += pKeys[i].bytes;
+    }
+  }
+  return len;
+}
+
+static char* hashJoinAllocRow(SHashJoinOperatorInfo* pInfo, SHJoinRowRef* pRef) {
+  if (pInfo->pWritePage == NULL || pInfo->writeOffset + pInfo->maxRowSize > getBufPageSize(pInfo->pBuf)) {
+    if (pInfo->pWritePage != NULL) {
+      setBufPageDirty(pInfo->pWritePage, true);
+      releaseBufPage(pInfo->pBuf, pInfo->pWritePage);
+    }
+    pInfo->pWritePage = getNewBufPage(pInfo->pBuf, &pInfo->writePageId);
+    pInfo->writeOffset = 0;
+    if (pInfo->pWritePage == NULL) {
+      return NULL;
+    }
+  }
+
+  pRef->pageId = pInfo->writePageId;
+  pRef->offset = pInfo->writeOffset;
+  return pInfo->pWritePage + pInfo->writeOffset;
+}
+
+static int32_t hashJoinAddBuildBlock(SHashJoinOperatorInfo* pInfo, SSDataBlock* pBlock) {
+  for (int32_t j = 0; j < pBlock->info.rows; ++j) {
+    int32_t keyLen = hashJoinBuildKey(pInfo, pInfo->pRightKeys, pBlock, j);
+    if (keyLen < 0) {
+      continue;
+    }
+
+    SHJoinRowRef ref = {0};
+    char*        pRow = hashJoinAllocRow(pInfo, &ref);
+    if (pRow == NULL) {
+      return terrno;
+    }
+
+    SHJoinRowRef* pHead = taosHashGet(pInfo->pBuildTable, pInfo->keyBuf, keyLen);
+    if (pHead != NULL) {
+      *(SHJoinRowRef*)pRow = *pHead;
+      *pHead = ref;
+    } else {
+      ((SHJoinRowRef*)pRow)->pageId = HJOIN_INVALID_PAGE;
+      if (taosHashPut(pInfo->pBuildTable, pInfo->keyBuf, keyLen, &ref, sizeof(SHJoinRowRef)) != 0) {
+        return TSDB_CODE_OUT_OF_MEMORY;
+      }
+    }
+
+    char* p = pRow + sizeof(SHJoinRowRef);
+    for (int32_t i = 0; i < pInfo->numOfBuildCols; ++i) {
+      SHJoinColMap*    pMap = &pInfo->pBuildCols[i];
+      SColumnInfoData* pSrc = taosArrayGet(pBlock->pDataBlock, pMap->srcSlot);
+      if (colDataIsNull_s(pSrc, j)) {
+        *p++ = 1;
+        continue;
+      }
+
+      *p++ = 0;
+      char*   pData = colDataGetData(pSrc, j);
+      int32_t len = IS_VAR_DATA_TYPE(pMap->type) ? varDataTLen(pData) : pMap->bytes;
+      memcpy(p, pData, len);
+      p += len;
+    }
+
+    pInfo->writeOffset += (int32_t)(p - pRow);
+    pInfo->numOfBuildRows += 1;
+  }
+  return TSDB_CODE_SUCCESS;
+}
+
+static int32_t hashJoinBuild(SOperatorInfo* pOperator) {
+  SHashJoinOperatorInfo* pInfo = pOperator->info;
+  SOperatorInfo*         pBuildSide = pOperator->pDownstream[1];
+
+  while (1) {
+    SSDataBlock* pBlock = pBuildSide->fpSet.getNextFn(pBuildSide);
+    if (pBlock == NULL) {
+      break;
+    }
+
+    int32_t code = hashJoinAddBuildBlock(pInfo, pBlock);
+    if (code != TSDB_CODE_SUCCESS) {
+      return code;
+    }
+  }
+
+  hashJoinReleasePages(pInfo);
+  pInfo->built = true;
+  qDebug("%s hash join build side completed, rows:%" PRId64 ", keys:%d, pages:%d, in memory:%d",
+         GET_TASKID(pOperator->pTaskInfo), pInfo->numOfBuildRows, taosHashGetSize(pInfo->pBuildTable),
+         (int32_t)taosArrayGetSize(getDataBufPagesIdList(pInfo->pBuf)), isAllDataInMemBuf(pInfo->pBuf));
+  return TSDB_CODE_SUCCESS;
+}
+
+static char* hashJoinGetRow(SHashJoinOperatorInfo* pInfo, const SHJoinRowRef* pRef) {
+  if (pInfo->readPageId != pRef->pageId) {
+    if (pInfo->pReadPage != NULL) {
+      releaseBufPage(pInfo->pBuf, pInfo->pReadPage);
+    }
+    pInfo->pReadPage = getBufPage(pInfo->pBuf, pRef->pageId);
+    pInfo->readPageId = (pInfo->pReadPage != NULL) ? pRef->pageId : HJOIN_INVALID_PAGE;
+    if (pInfo->pReadPage == NULL) {
+      return NULL;
+    }
+  }
+  return pInfo->pReadPage + pRef->offset;
+}
+
+static void hashJoinAppendRow(SHashJoinOperatorInfo* pInfo, SSDataBlock* pRes, const char* pRow) {
+  int32_t row = pRes->info.rows;
+  for (int32_t i = 0; i < pInfo->numOfProbeCols; ++i) {
+    SHJoinColMap*    pMap = &pInfo->pProbeCols[i];
+    SColumnInfoData* pSrc = taosArrayGet(pInfo->pProbe->pDataBlock, pMap->srcSlot);
+    SColumnInfoData* pDst = taosArrayGet(pRes->pDataBlock, pMap->dstSlot);
+    if (colDataIsNull_s(pSrc, pInfo->probeRow)) {
+      colDataAppendNULL(pDst, row);
+    } else {
+      colDataAppend(pDst, row, colDataGetData(pSrc, pInfo->probeRow), false);
+    }
+  }
+
+  const char* p = pRow + sizeof(SHJoinRowRef);
+  for (int32_t i = 0; i < pInfo->numOfBuildCols; ++i) {
+    SHJoinColMap*    pMap = &pInfo->pBuildCols[i];
+    SColumnInfoData* pDst = taosArrayGet(pRes->pDataBlock, pMap->dstSlot);
+    if (*p++) {
+      colDataAppendNULL(pDst, row);
+      continue;
+    }
+
+    colDataAppend(pDst, row, p, false);
+    p += IS_VAR_DATA_TYPE(pMap->type) ? varDataTLen(p) : pMap->bytes;
+  }
+  pRes->info.rows += 1;
+}
+
+static int32_t hashJoinProbe(SOperatorInfo* pOperator, SSDataBlock* pRes) {
+  SHashJoinOperatorInfo* pInfo = pOperator->info;
+  SOperatorInfo*         pProbeSide = pOperator->pDownstream[0];
+
+  while (pRes->info.rows < pOperator->resultInfo.threshold) {
+    // the build rows with the same key are emitted before moving on, they may not fit in one result block
+    while (pInfo->nextMatch.pageId != HJOIN_INVALID_PAGE) {
+      const char* pRow = hashJoinGetRow(pInfo, &pInfo->nextMatch);
+      if (pRow == NULL) {
+        return terrno;
+      }
+      hashJoinAppendRow(pInfo, pRes, pRow);
+      pInfo->nextMatch = *(SHJoinRowRef*)pRow;
+      if (pRes->info.rows >= pOperator->resultInfo.threshold) {
+        return TSDB_CODE_SUCCESS;
+      }
+    }
+
+    if (pInfo->pProbe != NULL) {
+      pInfo->probeRow += 1;
+    }
+    if (pInfo->pProbe == NULL || pInfo->probeRow >= pInfo->pProbe->info.rows) {
+      pInfo->pProbe = pProbeSide->fpSet.getNextFn(pProbeSide);
+      pInfo->probeRow = 0;
+      if (pInfo->pProbe == NULL) {
+        setOperatorCompleted(pOperator);
+        break;
+      }
+    }
+
+    int32_t keyLen = hashJoinBuildKey(pInfo, pInfo->pLeftKeys, pInfo->pProbe, pInfo->probeRow);
+    if (keyLen >= 0) {
+      SHJoinRowRef* pHead = taosHashGet(pInfo->pBuildTable, pInfo->keyBuf, keyLen);
+      if (pHead != NULL) {
+        pInfo->nextMatch = *pHead;
+      }
+    }
+  }
+  return TSDB_CODE_SUCCESS;
+}
+
+SSDataBlock* doHashJoin(struct SOperatorInfo* pOperator) {
+  if (pOperator->status == OP_EXEC_DONE) {
+    return NULL;
+  }
+
+  SHashJoinOperatorInfo* pInfo = pOperator->info;
+  SExecTaskInfo*         pTaskInfo = pOperator->pTaskInfo;
+
+  int32_t code = TSDB_CODE_SUCCESS;
+  if (!pInfo->built) {
+    code = hashJoinBuild(pOperator);
+    if (code != TSDB_CODE_SUCCESS) {
+      T_LONG_JMP(pTaskInfo->env, code);
+    }
+    if (pInfo->numOfBuildRows == 0) {
+      setOperatorCompleted(pOperator);
+      return NULL;
+    }
+  }
+
+  SSDataBlock* pRes = pInfo->pRes;
+  blockDataCleanup(pRes);
+
+  while (pOperator->status != OP_EXEC_DONE) {
+    code = hashJoinProbe(pOperator, pRes);
+    if (code != TSDB_CODE_SUCCESS) {
+      T_LONG_JMP(pTaskInfo->env, code);
+    }
+    pRes->info.dataLoad = 1;
+    if (pOperator->exprSupp.pFilterInfo != NULL) {
+      doFilter(pRes, pOperator->exprSupp.pFilterInfo, NULL);
+    }
+    if (pRes->info.rows >= pOperator->resultInfo.threshold) {
+      break;
+    }
+  }
+
+  if (pOperator->status == OP_EXEC_DONE) {
+    hashJoinReleasePages(pInfo);
+  }
+  return (pRes->info.rows > 0) ? pRes : NULL;
+}
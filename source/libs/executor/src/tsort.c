@@ -21,6 +21,7 @@
 #include "tdef.h"
 #include "tlosertree.h"
 #include "tpagedbuf.h"
+#include "tsched.h"
 #include "tsort.h"
 #include "tutil.h"
 
@@ -633,6 +634,330 @@ int32_t getProperSortPageSize(size_t rowSize, uint32_t numOfCols) {
   return pgSize;
 }
 
+#define SORT_PARALLEL_MIN_ROWS  32768
+#define SORT_MAX_PARALLEL       8
+#define SORT_SAMPLES_PER_CHUNK  32
+#define SORT_MAX_KEY_LEN        64
+
+/*
+ * Blocks that are large enough are sorted by several threads: every thread sorts one chunk of the row index, the
+ * sorted chunks are then cut into key ranges and every thread merges one range into its own slice of the output.
+ * When all the order columns are fixed length integers, each row is encoded as a normalized binary key first, so
+ * that all the comparisons are plain memcmp.
+ */
+typedef struct SSortParallelCtx {
+  SSDataBlockSortHelper helper;
+  int32_t               numOfTasks;
+  int32_t*              pIndex;       // sorted index chunks
+  int32_t*              pOutput;      // merged index
+  char*                 pKeys;        // normalized keys, NULL if the row comparator is used
+  int32_t               keyLen;
+  int32_t*              pChunkStart;  // [numOfTasks + 1]
+  int32_t*              pBounds;      // [numOfTasks + 1][numOfTasks], start of range p in chunk c
+  int32_t*              pOutStart;    // [numOfTasks]
+  void (*fp)(struct SSortParallelCtx* pCtx, int32_t task);
+  int32_t remain;
+  tsem_t  done;
+} SSortParallelCtx;
+
+static SSchedQueue  sortPool = {0};
+static TdThreadOnce sortPoolInit = PTHREAD_ONCE_INIT;
+static int32_t      sortPoolThreads = 0;
+
+static void initSortPool() {
+  // the caller always takes one share of the work itself
+  int32_t numOfThreads = TMIN(TMAX((int32_t)tsNumOfCores / 2, 1), SORT_MAX_PARALLEL) - 1;
+  if (numOfThreads > 0 && taosInitScheduler(numOfThreads * 4, numOfThreads, "tsort", &sortPool) != NULL) {
+    sortPoolThreads = numOfThreads;
+  }
+}
+
+static void sortParallelTaskFp(SSchedMsg* pMsg) {
+  SSortParallelCtx* pCtx = pMsg->ahandle;
+  pCtx->fp(pCtx, (int32_t)(intptr_t)pMsg->thandle);
+  if (atomic_sub_fetch_32(&pCtx->remain, 1) == 0) {
+    tsem_post(&pCtx->done);
+  }
+}
+
+static void sortParallelRun(SSortParallelCtx* pCtx, void (*fp)(SSortParallelCtx*, int32_t)) {
+  pCtx->fp = fp;
+  pCtx->remain = pCtx->numOfTasks - 1;
+
+  for (int32_t i = 1; i < pCtx->numOfTasks; ++i) {
+    SSchedMsg msg = {.fp = sortParallelTaskFp, .ahandle = pCtx, .thandle = (void*)(intptr_t)i};
+    taosScheduleTask(&sortPool, &msg);
+  }
+
+  fp(pCtx, 0);
+  tsem_wait(&pCtx->done);
+}
+
+static bool isNormalizedKeyType(int32_t type) {
+  return type == TSDB_DATA_TYPE_BOOL || type == TSDB_DATA_TYPE_TIMESTAMP || IS_INTEGER_TYPE(type);
+}
+
+static int32_t getNormalizedKeyLen(SSDataBlock* pBlock, SArray* pOrderInfo) {
+  int32_t len = 0;
+  for (int32_t i = 0; i < taosArrayGetSize(pOrderInfo); ++i) {
+    SBlockOrderInfo* pOrder = taosArrayGet(pOrderInfo, i);
+    SColumnInfoData* pCol = taosArrayGet(pBlock->pDataBlock, pOrder->slotId);
+    if (!isNormalizedKeyType(pCol->info.type)) {
+      return 0;
+    }
+    len += 1 + pCol->info.bytes;
+  }
+
+  return (len <= SORT_MAX_KEY_LEN) ? len : 0;
+}
+
+// null marker first, then the value in big endian with the sign bit flipped, all inverted for descending order
+static void encodeNormalizedKeys(SSortParallelCtx* pCtx, int32_t start, int32_t end) {
+  SSDataBlock* pBlock = pCtx->helper.pDataBlock;
+  SArray*      pOrderInfo = pCtx->helper.orderInfo;
+  int32_t      offset = 0;
+
+  for (int32_t i = 0; i < taosArrayGetSize(pOrderInfo); ++i) {
+    SBlockOrderInfo* pOrder = taosArrayGet(pOrderInfo, i);
+    SColumnInfoData* pCol = pOrder->pColData;
+    int32_t          bytes = pCol->info.bytes;
+    bool             isSigned = IS_SIGNED_NUMERIC_TYPE(pCol->info.type) || pCol->info.type == TSDB_DATA_TYPE_TIMESTAMP;
+    uint8_t          mask = (pOrder->order == TSDB_ORDER_DESC) ? 0xFF : 0;
+
+    for (int32_t j = start; j < end; ++j) {
+      uint8_t* pKey = (uint8_t*)pCtx->pKeys + (int64_t)j * pCtx->keyLen + offset;
+      if (pCol->hasNull && colDataIsNull(pCol, pBlock->info.rows, j, NULL)) {
+        pKey[0] = pOrder->nullFirst ? 0 : 2;
+        memset(pKey + 1, 0, bytes);
+        continue;
+      }
+
+      const uint8_t* pVal = (const uint8_t*)pCol->pData + (int64_t)j * bytes;
+      pKey[0] = 1;
+      for (int32_t k = 0; k < bytes; ++k) {
+        pKey[1 + k] = pVal[bytes - 1 - k] ^ mask;
+      }
+      if (isSigned) {
+        pKey[1] ^= 0x80;
+      }
+    }
+
+    offset += 1 + bytes;
+  }
+}
+
+static int32_t normalizedKeyCompar(const void* p1, const void* p2, const void* param) {
+  const SSortParallelCtx* pCtx = param;
+
+  // taosqsort only accepts -1, 0 and 1
+  int32_t ret = memcmp(pCtx->pKeys + (int64_t)(*(int32_t*)p1) * pCtx->keyLen,
+                       pCtx->pKeys + (int64_t)(*(int32_t*)p2) * pCtx->keyLen, pCtx->keyLen);
+  return (ret > 0) - (ret < 0);
+}
+
+static int32_t sortRowCompar(SSortParallelCtx* pCtx, int32_t left, int32_t right) {
+  if (pCtx->pKeys != NULL) {
+    return normalizedKeyCompar(&left, &right, pCtx);
+  }
+  return dataBlockCompar(&left, &right, &pCtx->helper);
+}
+
+static void sortIndexArray(SSortParallelCtx* pCtx, int32_t* pIndex, int32_t num) {
+  if (pCtx->pKeys != NULL) {
+    taosqsort(pIndex, num, sizeof(int32_t), pCtx, normalizedKeyCompar);
+  } else {
+    taosqsort(pIndex, num, sizeof(int32_t), &pCtx->helper, dataBlockCompar);
+  }
+}
+
+static void sortChunkTask(SSortParallelCtx* pCtx, int32_t task) {
+  int32_t start = pCtx->pChunkStart[task];
+  int32_t end = pCtx->pChunkStart[task + 1];
+
+  if (pCtx->pKeys != NULL) {
+    encodeNormalizedKeys(pCtx, start, end);
+  }
+
+  for (int32_t i = start; i < end; ++i) {
+    pCtx->pIndex[i] = i;
+  }
+  sortIndexArray(pCtx, pCtx->pIndex + start, end - start);
+}
+
+static void mergeRangeTask(SSortParallelCtx* pCtx, int32_t task) {
+  int32_t  n = pCtx->numOfTasks;
+  int32_t  pos[SORT_MAX_PARALLEL];
+  int32_t  end[SORT_MAX_PARALLEL];
+  int32_t* pOut = pCtx->pOutput + pCtx->pOutStart[task];
+
+  for (int32_t c = 0; c < n; ++c) {
+    pos[c] = pCtx->pBounds[task * n + c];
+    end[c] = pCtx->pBounds[(task + 1) * n + c];
+  }
+
+  // the number of runs is small, a linear scan of the run heads is cheaper than a tree
+  while (1) {
+    int32_t min = -1;
+    for (int32_t c = 0; c < n; ++c) {
+      if (pos[c] < end[c] && (min == -1 || sortRowCompar(pCtx, pCtx->pIndex[pos[c]], pCtx->pIndex[pos[min]]) < 0)) {
+        min = c;
+      }
+    }
+
+    if (min == -1) {
+      break;
+    }
+    *pOut++ = pCtx->pIndex[pos[min]++];
+  }
+}
+
+// the first position in [start, end) of the sorted chunk whose row is greater than the given row
+static int32_t sortUpperBound(SSortParallelCtx* pCtx, int32_t start, int32_t end, int32_t row) {
+  while (start < end) {
+    int32_t mid = start + (end - start) / 2;
+    if (sortRowCompar(pCtx, pCtx->pIndex[mid], row) <= 0) {
+      start = mid + 1;
+    } else {
+      end = mid;
+    }
+  }
+  return start;
+}
+
+static int32_t splitSortedChunks(SSortParallelCtx* pCtx) {
+  int32_t  n = pCtx->numOfTasks;
+  int32_t* pSamples = taosMemoryMalloc(sizeof(int32_t) * n * SORT_SAMPLES_PER_CHUNK);
+  if (pSamples == NULL) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  int32_t numOfSamples = 0;
+  for (int32_t c = 0; c < n; ++c) {
+    int32_t len = pCtx->pChunkStart[c + 1] - pCtx->pChunkStart[c];
+    int32_t num = TMIN(len, SORT_SAMPLES_PER_CHUNK);
+    for (int32_t i = 0; i < num; ++i) {
+      pSamples[numOfSamples++] = pCtx->pIndex[pCtx->pChunkStart[c] + (int64_t)len * i / num];
+    }
+  }
+  sortIndexArray(pCtx, pSamples, numOfSamples);
+
+  for (int32_t c = 0; c < n; ++c) {
+    pCtx->pBounds[c] = pCtx->pChunkStart[c];
+    pCtx->pBounds[n * n + c] = pCtx->pChunkStart[c + 1];
+  }
+
+  for (int32_t p = 1; p < n; ++p) {
+    int32_t splitter = pSamples[(int64_t)numOfSamples * p / n];
+    for (int32_t c = 0; c < n; ++c) {
+      pCtx->pBounds[p * n + c] = sortUpperBound(pCtx, pCtx->pBounds[(p - 1) * n + c], pCtx->pChunkStart[c + 1], splitter);
+    }
+  }
+
+  int32_t offset = 0;
+  for (int32_t p = 0; p < n; ++p) {
+    pCtx->pOutStart[p] = offset;
+    for (int32_t c = 0; c < n; ++c) {
+      offset += pCtx->pBounds[(p + 1) * n + c] - pCtx->pBounds[p * n + c];
+    }
+  }
+
+  taosMemoryFree(pSamples);
+  return TSDB_CODE_SUCCESS;
+}
+
+static void destroySortParallelCtx(SSortParallelCtx* pCtx) {
+  taosMemoryFree(pCtx->pIndex);
+  taosMemoryFree(pCtx->pOutput);
+  taosMemoryFree(pCtx->pKeys);
+  taosMemoryFree(pCtx->pChunkStart);
+  taosMemoryFree(pCtx->pBounds);
+  taosMemoryFree(pCtx->pOutStart);
+  tsem_destroy(&pCtx->done);
+}
+
+static bool sortHasJsonKey(SSDataBlock* pBlock, SArray* pOrderInfo) {
+  for (int32_t i = 0; i < taosArrayGetSize(pOrderInfo); ++i) {
+    SBlockOrderInfo* pOrder = taosArrayGet(pOrderInfo, i);
+    SColumnInfoData* pCol = taosArrayGet(pBlock->pDataBlock, pOrder->slotId);
+    if (pCol->info.type == TSDB_DATA_TYPE_JSON) {
+      return true;
+    }
+  }
+  return false;
+}
+
+static int32_t sortBlockInParallel(SSortHandle* pHandle, SSDataBlock* pBlock) {
+  int32_t rows = pBlock->info.rows;
+  int32_t n = sortPoolThreads + 1;
+
+  SSortParallelCtx ctx = {.helper = {.pDataBlock = pBlock, .orderInfo = pHandle->pSortInfo}, .numOfTasks = n};
+  tsem_init(&ctx.done, 0, 0);
+
+  for (int32_t i = 0; i < taosArrayGetSize(pHandle->pSortInfo); ++i) {
+    SBlockOrderInfo* pOrder = taosArrayGet(pHandle->pSortInfo, i);
+    pOrder->pColData = taosArrayGet(pBlock->pDataBlock, pOrder->slotId);
+  }
+
+  int32_t code = TSDB_CODE_SUCCESS;
+  ctx.keyLen = getNormalizedKeyLen(pBlock, pHandle->pSortInfo);
+  ctx.pIndex = taosMemoryMalloc(sizeof(int32_t) * rows);
+  ctx.pOutput = taosMemoryMalloc(sizeof(int32_t) * rows);
+  ctx.pChunkStart = taosMemoryMalloc(sizeof(int32_t) * (n + 1));
+  ctx.pBounds = taosMemoryMalloc(sizeof(int32_t) * (n + 1) * n);
+  ctx.pOutStart = taosMemoryMalloc(sizeof(int32_t) * n);
+  if (ctx.keyLen > 0) {
+    ctx.pKeys = taosMemoryMalloc((int64_t)ctx.keyLen * rows);
+  }
+
+  if (ctx.pIndex == NULL || ctx.pOutput == NULL || ctx.pChunkStart == NULL || ctx.pBounds == NULL ||
+      ctx.pOutStart == NULL || (ctx.keyLen > 0 && ctx.pKeys == NULL)) {
+    code = TSDB_CODE_OUT_OF_MEMORY;
+    goto _end;
+  }
+
+  for (int32_t i = 0; i <= n; ++i) {
+    ctx.pChunkStart[i] = (int64_t)rows * i / n;
+  }
+
+  int64_t p0 = taosGetTimestampUs();
+  sortParallelRun(&ctx, sortChunkTask);
+
+  code = splitSortedChunks(&ctx);
+  if (code != TSDB_CODE_SUCCESS) {
+    goto _end;
+  }
+
+  int64_t p1 = taosGetTimestampUs();
+  sortParallelRun(&ctx, mergeRangeTask);
+
+  int64_t p2 = taosGetTimestampUs();
+  code = blockDataReorder(pBlock, ctx.pOutput);
+
+  qDebug("%s parallel sort rows:%d, tasks:%d, key len:%d, sort:%" PRId64 "us, merge:%" PRId64 "us, reorder:%" PRId64
+         "us",
+         pHandle->idStr, rows, n, ctx.keyLen, p1 - p0, p2 - p1, taosGetTimestampUs() - p2);
+
+_end:
+  destroySortParallelCtx(&ctx);
+  if (code != TSDB_CODE_SUCCESS) {
+    terrno = code;
+  }
+  return code;
+}
+
+static int32_t sortBlock(SSortHandle* pHandle, SSDataBlock* pBlock) {
+  if (pBlock->info.rows < SORT_PARALLEL_MIN_ROWS) {
+    return blockDataSort(pBlock, pHandle->pSortInfo);
+  }
+
+  taosThreadOnce(&sortPoolInit, initSortPool);
+  if (sortPoolThreads == 0 || sortHasJsonKey(pBlock, pHandle->pSortInfo)) {
+    return blockDataSort(pBlock, pHandle->pSortInfo);
+  }
+
+  return sortBlockInParallel(pHandle, pBlock);
+}
+
 static int32_t createInitialSources(SSortHandle* pHandle) {
   size_t sortBufSize = pHandle->numOfPages * pHandle->pageSize;
 
@@ -680,7 +1005,7 @@ static int32_t createInitialSources(SSortHandle* pHandle) {
       if (size > sortBufSize) {
         // Perform the in-memory sort and then flush data in the buffer into disk.
         int64_t p = taosGetTimestampUs();
-        code = blockDataSort(pHandle->pDataBlock, pHandle->pSortInfo);
+        code = sortBlock(pHandle, pHandle->pDataBlock);
         if (code != 0) {
           if (source->param && !source->onlyRef) {
             taosMemoryFree(source->param);
@@ -711,7 +1036,7 @@ static int32_t createInitialSources(SSortHandle* pHandle) {
       // Perform the in-memory sort and then flush data in the buffer into disk.
       int64_t p = taosGetTimestampUs();
 
-      int32_t code = blockDataSort(pHandle->pDataBlock, pHandle->pSortInfo);
+      int32_t code = sortBlock(pHandle, pHandle->pDataBlock);
       if (code != 0) {
         return code;
       }
@@ -0,0 +1,519 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <map>
+#include <string>
+#include <vector>
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wwrite-strings"
+#pragma GCC diagnostic ignored "-Wunused-function"
+#pragma GCC diagnostic ignored "-Wunused-variable"
+#pragma GCC diagnostic ignored "-Wsign-compare"
+#include "os.h"
+
+#include "executorimpl.h"
+#include "functionMgt.h"
+#include "plannodes.h"
+#include "querynodes.h"
+#include "tdatablock.h"
+
+namespace {
+
+// Operators are driven directly from physical plan nodes built here, on top of an input operator that returns
+// prepared blocks. Results are compared as sorted lists of formatted rows.
+
+typedef std::vector<std::string> SRows;
+
+SNode* optMakeColumn(int16_t dataBlockId, int16_t slotId, int8_t type, int32_t bytes) {
+  SColumnNode* pCol = (SColumnNode*)nodesMakeNode(QUERY_NODE_COLUMN);
+  pCol->node.resType.type = type;
+  pCol->node.resType.bytes = bytes;
+  pCol->dataBlockId = dataBlockId;
+  pCol->slotId = slotId;
+  pCol->colId = slotId + 1;
+  pCol->colType = COLUMN_TYPE_COLUMN;
+  snprintf(pCol->colName, sizeof(pCol->colName), "c%d", slotId);
+  return (SNode*)pCol;
+}
+
+SNode* optMakeFunction(const char* name, SNode* pParam) {
+  SFunctionNode* pFunc = (SFunctionNode*)nodesMakeNode(QUERY_NODE_FUNCTION);
+  tstrncpy(pFunc->functionName, name, sizeof(pFunc->functionName));
+  nodesListMakeAppend(&pFunc->pParameterList, pParam);
+  char msg[128] = {0};
+  EXPECT_EQ(fmGetFuncInfo(pFunc, msg, sizeof(msg)), 0) << msg;
+  return (SNode*)pFunc;
+}
+
+SNode* optMakeTarget(int16_t dataBlockId, int16_t slotId, SNode* pExpr) {
+  STargetNode* pTarget = (STargetNode*)nodesMakeNode(QUERY_NODE_TARGET);
+  pTarget->dataBlockId = dataBlockId;
+  pTarget->slotId = slotId;
+  pTarget->pExpr = pExpr;
+  return (SNode*)pTarget;
+}
+
+// one output slot for each target, of the type of its expression
+SDataBlockDescNode* optMakeBlockDesc(int16_t dataBlockId, SNodeList* pTargets) {
+  SDataBlockDescNode* pDesc = (SDataBlockDescNode*)nodesMakeNode(QUERY_NODE_DATABLOCK_DESC);
+  pDesc->dataBlockId = dataBlockId;
+  pDesc->pSlots = nodesMakeList();
+
+  SNode* pNode = NULL;
+  FOREACH(pNode, pTargets) {
+    STargetNode*   pTarget = (STargetNode*)pNode;
+    SSlotDescNode* pSlot = (SSlotDescNode*)nodesMakeNode(QUERY_NODE_SLOT_DESC);
+    pSlot->slotId = pTarget->slotId;
+    pSlot->dataType = ((SExprNode*)pTarget->pExpr)->resType;
+    pSlot->output = true;
+    nodesListAppend(pDesc->pSlots, (SNode*)pSlot);
+    pDesc->totalRowSize += pSlot->dataType.bytes;
+    pDesc->outputRowSize += pSlot->dataType.bytes;
+  }
+  return pDesc;
+}
+
+typedef struct SBlockListInfo {
+  std::vector<SSDataBlock*>* pBlocks;
+  size_t                     next;
+} SBlockListInfo;
+
+SSDataBlock* optGetNextListBlock(SOperatorInfo* pOperator) {
+  SBlockListInfo* pInfo = (SBlockListInfo*)pOperator->info;
+  if (pInfo->next >= pInfo->pBlocks->size()) {
+    return NULL;
+  }
+  return (*pInfo->pBlocks)[pInfo->next++];
+}
+
+void optDestroyListInfo(void* param) {
+  SBlockListInfo* pInfo = (SBlockListInfo*)param;
+  for (SSDataBlock* pBlock : *pInfo->pBlocks) {
+    blockDataDestroy(pBlock);
+  }
+  delete pInfo->pBlocks;
+  delete pInfo;
+}
+
+// returns the blocks in order and frees them with the operator tree
+SOperatorInfo* optCreateListOperator(const std::vector<SSDataBlock*>& blocks, int16_t dataBlockId) {
+  SOperatorInfo*  pOperator = (SOperatorInfo*)taosMemoryCalloc(1, sizeof(SOperatorInfo));
+  SBlockListInfo* pInfo = new SBlockListInfo{new std::vector<SSDataBlock*>(blocks), 0};
+  pOperator->name = (char*)"blockListOperator4Test";
+  pOperator->operatorType = QUERY_NODE_PHYSICAL_PLAN_EXCHANGE;
+  pOperator->resultDataBlockId = dataBlockId;
+  pOperator->info = pInfo;
+  pOperator->fpSet.getNextFn = optGetNextListBlock;
+  pOperator->fpSet.closeFn = optDestroyListInfo;
+  return pOperator;
+}
+
+SExecTaskInfo* optCreateTaskInfo() {
+  SExecTaskInfo* pTaskInfo = (SExecTaskInfo*)taosMemoryCalloc(1, sizeof(SExecTaskInfo));
+  pTaskInfo->id.str = tstrdup("operatorTest");
+  pTaskInfo->execModel = OPTR_EXEC_MODEL_BATCH;
+  return pTaskInfo;
+}
+
+void optDestroyTaskInfo(SExecTaskInfo* pTaskInfo) {
+  taosMemoryFree(pTaskInfo->id.str);
+  taosMemoryFree(pTaskInfo);
+}
+
+std::string optFormatCell(SColumnInfoData* pCol, int32_t row) {
+  if (colDataIsNull_s(pCol, row)) {
+    return "NULL";
+  }
+
+  char* p = colDataGetData(pCol, row);
+  char  buf[128] = {0};
+  switch (pCol->info.type) {
+    case TSDB_DATA_TYPE_BOOL:
+    case TSDB_DATA_TYPE_TINYINT:
+      snprintf(buf, sizeof(buf), "%d", *(int8_t*)p);
+      break;
+    case TSDB_DATA_TYPE_SMALLINT:
+      snprintf(buf, sizeof(buf), "%d", *(int16_t*)p);
+      break;
+    case TSDB_DATA_TYPE_INT:
+      snprintf(buf, sizeof(buf), "%d", *(int32_t*)p);
+      break;
+    case TSDB_DATA_TYPE_BIGINT:
+    case TSDB_DATA_TYPE_TIMESTAMP:
+      snprintf(buf, sizeof(buf), "%" PRId64, *(int64_t*)p);
+      break;
+    case TSDB_DATA_TYPE_UBIGINT:
+      snprintf(buf, sizeof(buf), "%" PRIu64, *(uint64_t*)p);
+      break;
+    case TSDB_DATA_TYPE_DOUBLE:
+      snprintf(buf, sizeof(buf), "%.6f", *(double*)p);
+      break;
+    case TSDB_DATA_TYPE_BINARY:
+      return std::string(varDataVal(p), varDataLen(p));
+    default:
+      snprintf(buf, sizeof(buf), "type%d", pCol->info.type);
+      break;
+  }
+  return buf;
+}
+
+// all rows the operator returns, formatted and sorted
+SRows optDrainOperator(SOperatorInfo* pOperator) {
+  SRows          rows;
+  SExecTaskInfo* pTaskInfo = pOperator->pTaskInfo;
+
+  int32_t code = setjmp(pTaskInfo->env);
+  if (code != 0) {
+    ADD_FAILURE() << "operator failed since " << tstrerror(code);
+    return rows;
+  }
+
+  for (SSDataBlock* pRes = pOperator->fpSet.getNextFn(pOperator); pRes != NULL;
+       pRes = pOperator->fpSet.getNextFn(pOperator)) {
+    for (int32_t i = 0; i < pRes->info.rows; ++i) {
+      std::string row;
+      for (int32_t j = 0; j < taosArrayGetSize(pRes->pDataBlock); ++j) {
+        row += (j ? "|" : "") + optFormatCell((SColumnInfoData*)taosArrayGet(pRes->pDataBlock, j), i);
+      }
+      rows.push_back(row);
+    }
+  }
+
+  std::sort(rows.begin(), rows.end());
+  return rows;
+}
+
+class OperatorTest : public ::testing::Test {
+ protected:
+  static void SetUpTestSuite() {
+    // the result rows of the aggregate operators spill into a paged buffer under tsTempDir
+    osDefaultInit();
+    osUpdate();
+    ASSERT_EQ(fmFuncMgtInit(), 0);
+  }
+};
+
+// group by ========================================
+
+// input of the group by: k1 int and k2 tinyint as keys with nulls in k1, v bigint with nulls and d double
+struct SGroupInput {
+  std::vector<int32_t> k1;
+  std::vector<int8_t>  k2;
+  std::vector<int64_t> v;
+  std::vector<double>  d;
+  std::vector<bool>    k1Null;
+  std::vector<bool>    vNull;
+
+  void add(int32_t i, int32_t key1, int8_t key2) {
+    k1.push_back(key1);
+    k2.push_back(key2);
+    v.push_back(i * 3 - 100);
+    d.push_back(i / 4.0);
+    k1Null.push_back(key1 % 11 == 10);
+    vNull.push_back(i % 17 == 0);
+  }
+  size_t size() const { return k1.size(); }
+};
+
+const int16_t kInputBlockId = 1;
+const int16_t kOutputBlockId = 2;
+
+// the input in blocks of at most blockRows rows
+std::vector<SSDataBlock*> optMakeGroupBlocks(const SGroupInput& in, int32_t blockRows) {
+  std::vector<SSDataBlock*> blocks;
+  for (int32_t start = 0; start < (int32_t)in.size(); start += blockRows) {
+    int32_t      rows = std::min(blockRows, (int32_t)in.size() - start);
+    SSDataBlock* pBlock = createDataBlock();
+    pBlock->info.id.blockId = kInputBlockId;
+
+    int8_t  types[] = {TSDB_DATA_TYPE_INT, TSDB_DATA_TYPE_TINYINT, TSDB_DATA_TYPE_BIGINT, TSDB_DATA_TYPE_DOUBLE};
+    for (int32_t c = 0; c < 4; ++c) {
+      SColumnInfoData col = createColumnInfoData(types[c], tDataTypes[types[c]].bytes, c + 1);
+      blockDataAppendColInfo(pBlock, &col);
+    }
+    blockDataEnsureCapacity(pBlock, rows);
+
+    for (int32_t i = 0; i < rows; ++i) {
+      int32_t r = start + i;
+      colDataAppend((SColumnInfoData*)taosArrayGet(pBlock->pDataBlock, 0), i, (const char*)&in.k1[r], in.k1Null[r]);
+      colDataAppend((SColumnInfoData*)taosArrayGet(pBlock->pDataBlock, 1), i, (const char*)&in.k2[r], false);
+      colDataAppend((SColumnInfoData*)taosArrayGet(pBlock->pDataBlock, 2), i, (const char*)&in.v[r], in.vNull[r]);
+      colDataAppend((SColumnInfoData*)taosArrayGet(pBlock->pDataBlock, 3), i, (const char*)&in.d[r], false);
+    }
+    pBlock->info.rows = rows;
+    blocks.push_back(pBlock);
+  }
+  return blocks;
+}
+
+// select count(v), sum(v), min(v), max(d), avg(d), k1, k2 ... group by k1, k2
+SRows optRunGroupBy(const SGroupInput& in, int32_t blockRows) {
+  SAggPhysiNode* pAggNode = (SAggPhysiNode*)nodesMakeNode(QUERY_NODE_PHYSICAL_PLAN_HASH_AGG);
+
+  const char* funcs[] = {"count", "sum", "min", "max", "avg"};
+  int16_t     params[] = {2, 2, 2, 3, 3};
+  int16_t     slot = 0;
+  for (int32_t i = 0; i < 5; ++i) {
+    int8_t type = params[i] == 2 ? TSDB_DATA_TYPE_BIGINT : TSDB_DATA_TYPE_DOUBLE;
+    SNode* pFunc = optMakeFunction(funcs[i], optMakeColumn(kInputBlockId, params[i], type, 8));
+    nodesListMakeAppend(&pAggNode->pAggFuncs, optMakeTarget(kOutputBlockId, slot++, pFunc));
+  }
+  nodesListMakeAppend(&pAggNode->pGroupKeys,
+                      optMakeTarget(kOutputBlockId, slot++, optMakeColumn(kInputBlockId, 0, TSDB_DATA_TYPE_INT, 4)));
+  nodesListMakeAppend(&pAggNode->pGroupKeys,
+                      optMakeTarget(kOutputBlockId, slot++, optMakeColumn(kInputBlockId, 1, TSDB_DATA_TYPE_TINYINT, 1)));
+
+  SNodeList* pTargets = nodesCloneList(pAggNode->pAggFuncs);
+  nodesListAppendList(pTargets, nodesCloneList(pAggNode->pGroupKeys));
+  pAggNode->node.pOutputDataBlockDesc = optMakeBlockDesc(kOutputBlockId, pTargets);
+  nodesDestroyList(pTargets);
+
+  SExecTaskInfo* pTaskInfo = optCreateTaskInfo();
+  SOperatorInfo* pDownstream = optCreateListOperator(optMakeGroupBlocks(in, blockRows), kInputBlockId);
+  SOperatorInfo* pOperator = createGroupOperatorInfo(pDownstream, pAggNode, pTaskInfo);
+  EXPECT_NE(pOperator, nullptr);
+
+  SRows rows;
+  if (pOperator != NULL) {
+    rows = optDrainOperator(pOperator);
+    destroyOperatorInfo(pOperator);
+  }
+
+  optDestroyTaskInfo(pTaskInfo);
+  nodesDestroyNode((SNode*)pAggNode);
+  return rows;
+}
+
+// hash join ========================================
+
+// one side of the join: a varchar key with nulls, a bigint and an optional varchar payload
+struct SJoinInput {
+  int32_t                  keyBytes;
+  int32_t                  padBytes;
+  std::vector<std::string> key;
+  std::vector<bool>        keyNull;
+  std::vector<int64_t>     val;
+  std::vector<std::string> pad;
+
+  SJoinInput(int32_t keyLen, int32_t padLen)
+      : keyBytes(keyLen + VARSTR_HEADER_SIZE), padBytes(padLen > 0 ? padLen + VARSTR_HEADER_SIZE : 0) {}
+
+  void add(const std::string& k, bool isNull, int64_t v, const std::string& p = "") {
+    key.push_back(k);
+    keyNull.push_back(isNull);
+    val.push_back(v);
+    pad.push_back(p);
+  }
+  size_t size() const { return key.size(); }
+  int32_t numOfCols() const { return padBytes > 0 ? 3 : 2; }
+};
+
+const int16_t kBuildBlockId = 3;
+
+void optAppendVarData(SColumnInfoData* pCol, int32_t row, const std::string& s, bool isNull) {
+  std::vector<char> buf(VARSTR_HEADER_SIZE + s.size());
+  STR_WITH_SIZE_TO_VARSTR(buf.data(), s.c_str(), s.size());
+  colDataAppend(pCol, row, buf.data(), isNull);
+}
+
+std::vector<SSDataBlock*> optMakeJoinBlocks(const SJoinInput& in, int16_t dataBlockId, int32_t blockRows) {
+  std::vector<SSDataBlock*> blocks;
+  for (int32_t start = 0; start < (int32_t)in.size(); start += blockRows) {
+    int32_t      rows = std::min(blockRows, (int32_t)in.size() - start);
+    SSDataBlock* pBlock = createDataBlock();
+    pBlock->info.id.blockId = dataBlockId;
+
+    SColumnInfoData key = createColumnInfoData(TSDB_DATA_TYPE_VARCHAR, in.keyBytes, 1);
+    SColumnInfoData val = createColumnInfoData(TSDB_DATA_TYPE_BIGINT, 8, 2);
+    blockDataAppendColInfo(pBlock, &key);
+    blockDataAppendColInfo(pBlock, &val);
+    if (in.padBytes > 0) {
+      SColumnInfoData pad = createColumnInfoData(TSDB_DATA_TYPE_VARCHAR, in.padBytes, 3);
+      blockDataAppendColInfo(pBlock, &pad);
+    }
+    blockDataEnsureCapacity(pBlock, rows);
+
+    for (int32_t i = 0; i < rows; ++i) {
+      int32_t r = start + i;
+      optAppendVarData((SColumnInfoData*)taosArrayGet(pBlock->pDataBlock, 0), i, in.key[r], in.keyNull[r]);
+      colDataAppend((SColumnInfoData*)taosArrayGet(pBlock->pDataBlock, 1), i, (const char*)&in.val[r], false);
+      if (in.padBytes > 0) {
+        optAppendVarData((SColumnInfoData*)taosArrayGet(pBlock->pDataBlock, 2), i, in.pad[r], false);
+      }
+    }
+    pBlock->info.rows = rows;
+    blocks.push_back(pBlock);
+  }
+  return blocks;
+}
+
+// select probe.key, probe.val, build.* from probe join build on probe.key = build.key
+SRows optRunHashJoin(const SJoinInput& probe, const SJoinInput& build, int32_t blockRows) {
+  SHashJoinPhysiNode* pJoinNode = (SHashJoinPhysiNode*)nodesMakeNode(QUERY_NODE_PHYSICAL_PLAN_HASH_JOIN);
+  pJoinNode->joinType = JOIN_TYPE_INNER;
+  nodesListMakeAppend(&pJoinNode->pLeftKeys,
+                      optMakeColumn(kInputBlockId, 0, TSDB_DATA_TYPE_VARCHAR, probe.keyBytes));
+  nodesListMakeAppend(&pJoinNode->pRightKeys,
+                      optMakeColumn(kBuildBlockId, 0, TSDB_DATA_TYPE_VARCHAR, build.keyBytes));
+
+  int16_t slot = 0;
+  nodesListMakeAppend(&pJoinNode->pTargets, optMakeTarget(kOutputBlockId, slot++,
+                                                          optMakeColumn(kInputBlockId, 0, TSDB_DATA_TYPE_VARCHAR,
+                                                                        probe.keyBytes)));
+  nodesListMakeAppend(&pJoinNode->pTargets, optMakeTarget(kOutputBlockId, slot++,
+                                                          optMakeColumn(kInputBlockId, 1, TSDB_DATA_TYPE_BIGINT, 8)));
+  nodesListMakeAppend(&pJoinNode->pTargets, optMakeTarget(kOutputBlockId, slot++,
+                                                          optMakeColumn(kBuildBlockId, 1, TSDB_DATA_TYPE_BIGINT, 8)));
+  if (build.padBytes > 0) {
+    nodesListMakeAppend(&pJoinNode->pTargets,
+                        optMakeTarget(kOutputBlockId, slot++,
+                                      optMakeColumn(kBuildBlockId, 2, TSDB_DATA_TYPE_VARCHAR, build.padBytes)));
+  }
+  pJoinNode->node.pOutputDataBlockDesc = optMakeBlockDesc(kOutputBlockId, pJoinNode->pTargets);
+
+  SExecTaskInfo* pTaskInfo = optCreateTaskInfo();
+  SOperatorInfo* pDownstream[2] = {
+      optCreateListOperator(optMakeJoinBlocks(probe, kInputBlockId, blockRows), kInputBlockId),
+      optCreateListOperator(optMakeJoinBlocks(build, kBuildBlockId, blockRows), kBuildBlockId)};
+  SOperatorInfo* pOperator = createHashJoinOperatorInfo(pDownstream, 2, pJoinNode, pTaskInfo);
+  EXPECT_NE(pOperator, nullptr);
+
+  SRows rows;
+  if (pOperator != NULL) {
+    rows = optDrainOperator(pOperator);
+    destroyOperatorInfo(pOperator);
+  }
+
+  optDestroyTaskInfo(pTaskInfo);
+  nodesDestroyNode((SNode*)pJoinNode);
+  return rows;
+}
+
+// the expected join result, from an ordered index of the build rows
+SRows optExpectJoin(const SJoinInput& probe, const SJoinInput& build) {
+  std::multimap<std::string, size_t> index;
+  for (size_t j = 0; j < build.size(); ++j) {
+    if (!build.keyNull[j]) {
+      index.emplace(build.key[j], j);
+    }
+  }
+
+  SRows rows;
+  for (size_t i = 0; i < probe.size(); ++i) {
+    if (probe.keyNull[i]) {
+      continue;
+    }
+    auto range = index.equal_range(probe.key[i]);
+    for (auto it = range.first; it != range.second; ++it) {
+      std::string row = probe.key[i] + "|" + std::to_string(probe.val[i]) + "|" + std::to_string(build.val[it->second]);
+      if (build.padBytes > 0) {
+        row += "|" + build.pad[it->second];
+      }
+      rows.push_back(row);
+    }
+  }
+  std::sort(rows.begin(), rows.end());
+  return rows;
+}
+
+}  // namespace
+
+// Blocks of at least 64 rows with few groups are aggregated group by group, smaller blocks row by row. The same
+// rows fed in both shapes give the same result.
+TEST_F(OperatorTest, group_by_batch_vs_row) {
+  SGroupInput in;
+
+  // unordered keys, every group spans all blocks
+  for (int32_t i = 0; i < 3000; ++i) {
+    in.add(i, (i * 7) % 13, i % 3);
+  }
+  // already grouped rows, a group crosses the block boundaries
+  for (int32_t i = 0; i < 1500; ++i) {
+    in.add(i, i / 500, 1);
+  }
+  // too many groups for the batched path, the block falls back to the row path
+  for (int32_t i = 0; i < 1000; ++i) {
+    in.add(i, i % 400, 2);
+  }
+
+  SRows batch = optRunGroupBy(in, 1000);
+  SRows row = optRunGroupBy(in, 50);
+
+  ASSERT_FALSE(row.empty());
+  ASSERT_EQ(batch, row);
+}
+
+TEST_F(OperatorTest, group_by_null_keys) {
+  SGroupInput in;
+  for (int32_t i = 0; i < 640; ++i) {
+    in.add(i, (i % 2) ? 10 : 20, i % 2);
+  }
+
+  // k1 is null where k1 % 11 == 10, so the groups are (NULL, 1) and (20, 0)
+  SRows batch = optRunGroupBy(in, 640);
+  SRows row = optRunGroupBy(in, 40);
+  ASSERT_EQ(batch.size(), 2);
+  ASSERT_EQ(batch, row);
+  ASSERT_TRUE(std::any_of(batch.begin(), batch.end(),
+                          [](const std::string& r) { return r.find("|NULL|1") != std::string::npos; }));
+}
+
+// The build side is far beyond the in-memory pages of the row buffer, so most build rows are read back from disk.
+// Keys repeat on the build side and a probe row matches more rows than fit in one result block.
+TEST_F(OperatorTest, hash_join_build_probe_spill) {
+  SJoinInput build(20, 1000);
+  for (int32_t i = 0; i < 12000; ++i) {
+    build.add("k" + std::to_string(i % 4000), i % 97 == 0, i, std::string(1000, 'a' + i % 26));
+  }
+  for (int32_t i = 0; i < 5000; ++i) {
+    build.add("hot", false, -i, std::string(1000, 'h'));
+  }
+
+  SJoinInput probe(20, 0);
+  for (int32_t i = 0; i < 3000; ++i) {
+    probe.add("k" + std::to_string(i * 3 % 6000), i % 89 == 0, i);
+  }
+  probe.add("hot", false, 3000);
+
+  SRows expect = optExpectJoin(probe, build);
+  ASSERT_GT(expect.size(), 4096 * 2);
+  ASSERT_EQ(optRunHashJoin(probe, build, 1000), expect);
+}
+
+// The probe keys are much wider than the build keys, the key buffer takes the longer of both.
+TEST_F(OperatorTest, hash_join_wider_probe_keys) {
+  SJoinInput build(10, 0);
+  for (int32_t i = 0; i < 200; ++i) {
+    build.add(std::to_string(i * 1000003 % 1000000000), i % 13 == 0, i);
+  }
+
+  SJoinInput probe(100, 0);
+  for (int32_t i = 0; i < 400; ++i) {
+    std::string key = std::to_string(i * 1000003 % 1000000000);
+    if (i % 2 == 1) {
+      key = std::string(100 - key.size(), 'x') + key;
+    }
+    probe.add(key, false, i);
+  }
+
+  SRows expect = optExpectJoin(probe, build);
+  ASSERT_FALSE(expect.empty());
+  ASSERT_EQ(optRunHashJoin(probe, build, 64), expect);
+}
+
+#pragma GCC diagnostic pop
@@ -193,8 +193,84 @@ int32_t docomp(const void* p1, const void* p2, void* param) {
 
   return 0;
 }
+
+SSDataBlock* getRandIntBlock(void* param) {
+  _info* pInfo = (_info*)param;
+  if (--pInfo->count < 0) {
+    return NULL;
+  }
+
+  SSDataBlock*    pBlock = createDataBlock();
+  SColumnInfoData colInfo = createColumnInfoData(TSDB_DATA_TYPE_INT, sizeof(int32_t), 1);
+  blockDataAppendColInfo(pBlock, &colInfo);
+  blockDataEnsureCapacity(pBlock, pInfo->pageRows);
+
+  SColumnInfoData* pColInfo = static_cast<SColumnInfoData*>(TARRAY_GET_ELEM(pBlock->pDataBlock, 0));
+  for (int32_t i = 0; i < pInfo->pageRows; ++i) {
+    if (i % 97 == 0) {
+      colDataAppendNULL(pColInfo, i);
+    } else {
+      int32_t v = taosRand() % 100000 - 50000;
+      colDataAppend(pColInfo, i, reinterpret_cast<const char*>(&v), false);
+    }
+  }
+
+  pBlock->info.rows = pInfo->pageRows;
+  return pBlock;
+}
 }  // namespace
 
+// large blocks are sorted by the parallel path with normalized keys
+TEST(testCase, parallel_block_sort_Test) {
+  tsNumOfCores = 8;
+
+  SBlockOrderInfo oi = {0};
+  oi.order = TSDB_ORDER_DESC;
+  oi.slotId = 0;
+  oi.nullFirst = true;
+  SArray* orderInfo = taosArrayInit(1, sizeof(SBlockOrderInfo));
+  taosArrayPush(orderInfo, &oi);
+
+  SSortHandle* phandle = tsortCreateSortHandle(orderInfo, SORT_SINGLESOURCE_SORT, 1024, 5, NULL, "test_parallel");
+  tsortSetFetchRawDataFp(phandle, getRandIntBlock, NULL, NULL);
+
+  _info info = {0};
+  info.pageRows = 10000;
+  info.count = 20;
+
+  SSortSource* ps = static_cast<SSortSource*>(taosMemoryCalloc(1, sizeof(SSortSource)));
+  ps->param = &info;
+  ps->onlyRef = true;
+  tsortAddSource(phandle, ps);
+
+  ASSERT_EQ(tsortOpen(phandle), 0);
+
+  int32_t rows = 0;
+  int32_t prev = INT32_MAX;
+  bool    nullDone = false;
+  while (1) {
+    STupleHandle* pTupleHandle = tsortNextTuple(phandle);
+    if (pTupleHandle == NULL) {
+      break;
+    }
+
+    rows += 1;
+    if (tsortIsNullVal(pTupleHandle, 0)) {
+      ASSERT_FALSE(nullDone);
+      continue;
+    }
+
+    nullDone = true;
+    int32_t v = *(int32_t*)tsortGetValue(pTupleHandle, 0);
+    ASSERT_LE(v, prev);
+    prev = v;
+  }
+
+  ASSERT_EQ(rows, 200000);
+  taosArrayDestroy(orderInfo);
+  tsortDestroySortHandle(phandle);
+}
+
 #if 0
 TEST(testCase, inMem_sort_Test) {
   SBlockOrderInfo oi = {0};
@@ -396,6 +396,9 @@ static void monGenDnodeJson(SMonInfo *pMonitor) {
   tjsonAddDoubleToObject(pJson, "req_insert_batch", pStat->numOfBatchInsertReqs);
   tjsonAddDoubleToObject(pJson, "req_insert_batch_success", pStat->numOfBatchInsertSuccessReqs);
   tjsonAddDoubleToObject(pJson, "req_insert_batch_rate", req_insert_batch_rate);
+  tjsonAddDoubleToObject(pJson, "buf_pool_chunks", pStat->bufPoolChunks);
+  tjsonAddDoubleToObject(pJson, "buf_pool_waste", pStat->bufPoolWaste);
+  tjsonAddDoubleToObject(pJson, "buf_pool_fallbacks", pStat->bufPoolFallbacks);
   tjsonAddDoubleToObject(pJson, "errors", pStat->errors);
   tjsonAddDoubleToObject(pJson, "vnodes_num", pStat->totalVnodes);
   tjsonAddDoubleToObject(pJson, "masters", pStat->masterNum);
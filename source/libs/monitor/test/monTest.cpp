@@ -173,6 +173,9 @@ void MonitorTest::GetVnodeStat(SVnodesStat *pInfo) {
   pInfo->numOfInsertSuccessReqs = 10;
   pInfo->numOfBatchInsertReqs = 11;
   pInfo->numOfBatchInsertSuccessReqs = 12;
+  pInfo->bufPoolChunks = 13;
+  pInfo->bufPoolWaste = 14;
+  pInfo->bufPoolFallbacks = 15;
   pInfo->errors = 4;
   pInfo->totalVnodes = 5;
   pInfo->masterNum = 6;
@@ -21,6 +21,8 @@
 struct SToken;
 
 #define IS_DATA_COL_ORDERED(spd) ((spd->orderStatus) == (int8_t)ORDER_STATUS_ORDERED)
+// the column of a bound column in STableDataBlocks.pColBlock, where they are in the order of the schema
+#define INS_COL_BLOCK_IDX(spd, idx) (IS_DATA_COL_ORDERED(spd) ? (idx) : (spd)->colIdxInfo[idx].finalIdx)
 
 #define NEXT_TOKEN(pSql, sToken)                \
   do {                                          \
@@ -115,9 +117,17 @@ typedef struct STableDataBlocks {
   int32_t            createTbReqLen;
   SParsedDataColInfo boundColumnInfo;
   SRowBuilder        rowBuilder;
+  // the rows bound by column, by the stmt batch bind and schemaless, which are sent as a columnar submit block
+  // instead of the rows in pData
+  SSDataBlock       *pColBlock;
 } STableDataBlocks;
 
 int32_t insGetExtendedRowSize(STableDataBlocks *pBlock);
+bool    insUseColBlock(STableDataBlocks *pDataBlock);
+int32_t insInitColBlock(STableDataBlocks *pDataBlock, int32_t numOfRows);
+int32_t insColBlockAppend(SMsgBuf *pMsgBuf, SColumnInfoData *pCol, int32_t iRow, SSchema *pSchema, const void *value,
+                          int32_t len, char *pVarBuf);
+int32_t insColBlockToRows(STableDataBlocks *pDataBlock);
 void insGetSTSRowAppendInfo(uint8_t rowType, SParsedDataColInfo *spd, col_id_t idx, int32_t *toffset, col_id_t *colIdx);
 int32_t insSetBlockInfo(SSubmitBlk *pBlocks, STableDataBlocks *dataBuf, int32_t numOfRows, SMsgBuf *pMsg);
 int32_t insSchemaIdxCompar(const void *lhs, const void *rhs);
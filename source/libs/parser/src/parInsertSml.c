@@ -16,6 +16,7 @@
 #include "parInsertUtil.h"
 #include "parInt.h"
 #include "parToken.h"
+#include "tdatablock.h"
 #include "ttime.h"
 
 int32_t qCreateSName(SName* pName, const char* pTableName, int32_t acctId, char* dbName, char* msgBuf,
@@ -207,6 +208,98 @@ end:
   return code;
 }
 
+// the value of the bound column in a row, the kvs of a formatted row are taken in order from the j-th one
+static SSmlKv* smlGetColKv(void* rowData, size_t rowDataSize, bool format, SParsedDataColInfo* spd, SSchema* pColSchema,
+                           int* j) {
+  SSmlKv* kv = NULL;
+  if (format) {
+    if (*j < rowDataSize) {
+      kv = taosArrayGetP(rowData, *j);
+      if (rowDataSize != spd->numOfBound && *j != 0 &&
+          (kv->keyLen != strlen(pColSchema->name) || strncmp(kv->key, pColSchema->name, kv->keyLen) != 0)) {
+        kv = NULL;
+      } else {
+        (*j)++;
+      }
+    }
+  } else {
+    void** p = taosHashGet(rowData, pColSchema->name, strlen(pColSchema->name));
+    if (p) kv = *p;
+  }
+  return kv;
+}
+
+// The rows are bound into the column block of the table when each of them gives every bound column, otherwise
+// *pBound is false and the rows are left to be bound as rows.
+static int32_t smlBindColsToColBlock(STableDataBlocks* pDataBlock, SArray* cols, bool format, SMsgBuf* pBuf,
+                                     bool* pBound) {
+  SSchema*            pSchema = getTableColumnSchema(pDataBlock->pTableMeta);
+  SParsedDataColInfo* spd = &pDataBlock->boundColumnInfo;
+  int32_t             rowNum = taosArrayGetSize(cols);
+  int32_t             precision = pDataBlock->pTableMeta->tableInfo.precision;
+
+  *pBound = false;
+  if (((SSubmitBlk*)pDataBlock->pData)->numOfRows != 0 || pDataBlock->pColBlock != NULL ||
+      !insUseColBlock(pDataBlock)) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  SSmlKv** pKvs = taosMemoryMalloc(rowNum * spd->numOfBound * sizeof(SSmlKv*));
+  if (NULL == pKvs) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+  for (int32_t r = 0; r < rowNum; ++r) {
+    void*  rowData = taosArrayGetP(cols, r);
+    size_t rowDataSize = format ? taosArrayGetSize(rowData) : 0;
+    for (int c = 0, j = 0; c < spd->numOfBound; ++c) {
+      SSchema* pColSchema = &pSchema[spd->boundColumns[c]];
+      SSmlKv*  kv = smlGetColKv(rowData, rowDataSize, format, spd, pColSchema, &j);
+      if (NULL == kv || IS_VAR_DATA_TYPE(kv->type) != IS_VAR_DATA_TYPE(pColSchema->type)) {
+        taosMemoryFree(pKvs);
+        return TSDB_CODE_SUCCESS;
+      }
+      pKvs[r * spd->numOfBound + c] = kv;
+    }
+  }
+
+  int32_t maxVarBytes = 0;
+  for (int c = 0; c < spd->numOfBound; ++c) {
+    SSchema* pColSchema = &pSchema[spd->boundColumns[c]];
+    if (IS_VAR_DATA_TYPE(pColSchema->type)) {
+      maxVarBytes = TMAX(maxVarBytes, pColSchema->bytes);
+    }
+  }
+  char*   pVarBuf = taosMemoryMalloc(TMAX(maxVarBytes, 1));
+  int32_t code = (NULL == pVarBuf) ? TSDB_CODE_OUT_OF_MEMORY : insInitColBlock(pDataBlock, rowNum);
+  for (int c = 0; TSDB_CODE_SUCCESS == code && c < spd->numOfBound; ++c) {
+    SSchema*         pColSchema = &pSchema[spd->boundColumns[c]];
+    SColumnInfoData* pCol = taosArrayGet(pDataBlock->pColBlock->pDataBlock, INS_COL_BLOCK_IDX(spd, c));
+    bool             isPrimaryKey = (PRIMARYKEY_TIMESTAMP_COL_ID == pColSchema->colId);
+
+    for (int32_t r = 0; TSDB_CODE_SUCCESS == code && r < rowNum; ++r) {
+      SSmlKv* kv = pKvs[r * spd->numOfBound + c];
+      if (isPrimaryKey) {
+        kv->i = convertTimePrecision(kv->i, TSDB_TIME_PRECISION_NANO, precision);
+        insCheckTimestamp(pDataBlock, (const char*)&kv->i);
+      }
+      const void* value = IS_VAR_DATA_TYPE(pColSchema->type) ? (const void*)kv->value : (const void*)&kv->value;
+      code = insColBlockAppend(pBuf, pCol, r, pColSchema, value, kv->length, pVarBuf);
+    }
+  }
+
+  if (TSDB_CODE_SUCCESS == code) {
+    code = insSetBlockInfo((SSubmitBlk*)pDataBlock->pData, pDataBlock, rowNum, pBuf);
+  }
+  if (TSDB_CODE_SUCCESS == code) {
+    pDataBlock->pColBlock->info.rows = rowNum;
+    *pBound = true;
+  }
+
+  taosMemoryFree(pKvs);
+  taosMemoryFree(pVarBuf);
+  return code;
+}
+
 int32_t smlBindData(void* handle, SArray* tags, SArray* colsSchema, SArray* cols, bool format, STableMeta* pTableMeta,
                     char* tableName, const char* sTableName, int32_t sTableNameLen, int32_t ttl, char* msgBuf, int16_t msgBufLen) {
   SMsgBuf pBuf = {.buf = msgBuf, .len = msgBufLen};
@@ -257,12 +350,23 @@ int32_t smlBindData(void* handle, SArray* tags, SArray* colsSchema, SArray* cols
   SRowBuilder*        pBuilder = &pDataBlock->rowBuilder;
   SMemParam           param = {.rb = pBuilder};
 
-  insInitRowBuilder(&pDataBlock->rowBuilder, pDataBlock->pTableMeta->sversion, &pDataBlock->boundColumnInfo);
-
   int32_t rowNum = taosArrayGetSize(cols);
   if (rowNum <= 0) {
     return buildInvalidOperationMsg(&pBuf, "cols size <= 0");
   }
+
+  bool bound = false;
+  ret = smlBindColsToColBlock(pDataBlock, cols, format, &pBuf, &bound);
+  if (ret != TSDB_CODE_SUCCESS || bound) {
+    return ret;
+  }
+  ret = insColBlockToRows(pDataBlock);
+  if (ret != TSDB_CODE_SUCCESS) {
+    return ret;
+  }
+
+  insInitRowBuilder(&pDataBlock->rowBuilder, pDataBlock->pTableMeta->sversion, &pDataBlock->boundColumnInfo);
+
   ret = insAllocateMemForSize(pDataBlock, extendedRowSize * rowNum);
   if (ret != TSDB_CODE_SUCCESS) {
     buildInvalidOperationMsg(&pBuf, "allocate memory error");
@@ -284,21 +388,7 @@ int32_t smlBindData(void* handle, SArray* tags, SArray* colsSchema, SArray* cols
       param.schema = pColSchema;
       insGetSTSRowAppendInfo(pBuilder->rowType, spd, c, &param.toffset, &param.colIdx);
 
-      SSmlKv* kv = NULL;
-      if (format) {
-        if (j < rowDataSize) {
-          kv = taosArrayGetP(rowData, j);
-          if (rowDataSize != spd->numOfBound && j != 0 &&
-              (kv->keyLen != strlen(pColSchema->name) || strncmp(kv->key, pColSchema->name, kv->keyLen) != 0)) {
-            kv = NULL;
-          } else {
-            j++;
-          }
-        }
-      } else {
-        void** p = taosHashGet(rowData, pColSchema->name, strlen(pColSchema->name));
-        if (p) kv = *p;
-      }
+      SSmlKv* kv = smlGetColKv(rowData, rowDataSize, format, spd, pColSchema, &j);
 
       if (kv) {
         int32_t colLen = kv->length;
@@ -18,6 +18,7 @@
 #include "parInt.h"
 #include "parToken.h"
 #include "query.h"
+#include "tdatablock.h"
 #include "tglobal.h"
 #include "ttime.h"
 #include "ttypes.h"
@@ -154,74 +155,242 @@ end:
   return code;
 }
 
-int32_t qBindStmtColsValue(void* pBlock, TAOS_MULTI_BIND* bind, char* msgBuf, int32_t msgBufLen) {
-  STableDataBlocks*   pDataBlock = (STableDataBlocks*)pBlock;
+// The batch goes into the column block of the table, a bound column into a column of it. The fixed length values of
+// a column are copied at once, and the rows are built by the vnode right in its memtable.
+static int32_t stmtBindColsToColBlock(STableDataBlocks* pDataBlock, TAOS_MULTI_BIND* bind, SMsgBuf* pBuf) {
+  SSchema*            pSchema = getTableColumnSchema(pDataBlock->pTableMeta);
+  SParsedDataColInfo* spd = &pDataBlock->boundColumnInfo;
+  int32_t             rowNum = bind->num;
+
+  CHECK_CODE(insInitColBlock(pDataBlock, rowNum));
+
+  SSDataBlock* pColBlock = pDataBlock->pColBlock;
+  int32_t      startRow = pColBlock->info.rows;
+  int32_t      maxVarBytes = 0;
+  for (int c = 0; c < spd->numOfBound; ++c) {
+    SSchema* pColSchema = &pSchema[spd->boundColumns[c]];
+    if (IS_VAR_DATA_TYPE(pColSchema->type)) {
+      maxVarBytes = TMAX(maxVarBytes, pColSchema->bytes);
+    }
+  }
+
+  // the var data and nulls of a batch that fails are dropped, as the rows of the block stay those of the batches before
+  int32_t* aVarLen = taosMemoryMalloc(spd->numOfBound * sizeof(int32_t));
+  char*    pVarBuf = taosMemoryMalloc(TMAX(maxVarBytes, 1));
+  if (NULL == aVarLen || NULL == pVarBuf) {
+    taosMemoryFree(aVarLen);
+    taosMemoryFree(pVarBuf);
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+  for (int c = 0; c < spd->numOfBound; ++c) {
+    aVarLen[c] = ((SColumnInfoData*)taosArrayGet(pColBlock->pDataBlock, c))->varmeta.length;
+  }
+
+  int32_t code = TSDB_CODE_SUCCESS;
+  for (int c = 0; c < spd->numOfBound; ++c) {
+    SSchema*         pColSchema = &pSchema[spd->boundColumns[c]];
+    SColumnInfoData* pCol = taosArrayGet(pColBlock->pDataBlock, INS_COL_BLOCK_IDX(spd, c));
+    bool             isPrimaryKey = (PRIMARYKEY_TIMESTAMP_COL_ID == pColSchema->colId);
+    bool             isVarData = IS_VAR_DATA_TYPE(pColSchema->type);
+
+    // fixed length values of the type of the column are copied at once, the nulls are flagged after
+    if (!isVarData && bind[c].buffer_type == pColSchema->type) {
+      char* pDst = pCol->pData + pColSchema->bytes * startRow;
+      if (bind[c].buffer_length == pColSchema->bytes) {
+        memcpy(pDst, bind[c].buffer, pColSchema->bytes * rowNum);
+      } else {
+        for (int32_t r = 0; r < rowNum; ++r) {
+          memcpy(pDst + pColSchema->bytes * r, (char*)bind[c].buffer + bind[c].buffer_length * r, pColSchema->bytes);
+        }
+      }
+
+      for (int32_t r = 0; bind[c].is_null && r < rowNum; ++r) {
+        if (bind[c].is_null[r]) {
+          if (isPrimaryKey) {
+            code = buildInvalidOperationMsg(pBuf, "primary timestamp should not be NULL");
+            goto end;
+          }
+          colDataAppendNULL(pCol, startRow + r);
+        }
+      }
+    } else {
+      for (int32_t r = 0; r < rowNum; ++r) {
+        if (bind[c].is_null && bind[c].is_null[r]) {
+          if (isPrimaryKey) {
+            code = buildInvalidOperationMsg(pBuf, "primary timestamp should not be NULL");
+            goto end;
+          }
+
+          code = insColBlockAppend(pBuf, pCol, startRow + r, pColSchema, NULL, 0, pVarBuf);
+        } else {
+          if (bind[c].buffer_type != pColSchema->type) {
+            code = buildInvalidOperationMsg(pBuf, "column type mis-match with buffer type");
+            goto end;
+          }
+
+          int32_t colLen = isVarData ? bind[c].length[r] : pColSchema->bytes;
+          code = insColBlockAppend(pBuf, pCol, startRow + r, pColSchema,
+                                   (char*)bind[c].buffer + bind[c].buffer_length * r, colLen, pVarBuf);
+        }
+        if (TSDB_CODE_SUCCESS != code) {
+          goto end;
+        }
+      }
+    }
+
+    if (isPrimaryKey) {
+      const TSKEY* pTs = (const TSKEY*)pCol->pData;
+      for (int32_t r = startRow; r < startRow + rowNum; ++r) {
+        insCheckTimestamp(pDataBlock, (const char*)&pTs[r]);
+      }
+    }
+  }
+
+  SSubmitBlk* pBlocks = (SSubmitBlk*)(pDataBlock->pData);
+  code = insSetBlockInfo(pBlocks, pDataBlock, rowNum, pBuf);
+  if (TSDB_CODE_SUCCESS == code) {
+    pColBlock->info.rows += rowNum;
+  }
+
+end:
+  if (TSDB_CODE_SUCCESS != code) {
+    for (int c = 0; c < spd->numOfBound; ++c) {
+      SColumnInfoData* pCol = taosArrayGet(pColBlock->pDataBlock, c);
+      if (IS_VAR_DATA_TYPE(pCol->info.type)) {
+        pCol->varmeta.length = aVarLen[c];
+      } else {
+        for (int32_t r = startRow; r < startRow + rowNum; ++r) {
+          colDataClearNull_f(pCol->nullbitmap, r);
+        }
+      }
+    }
+  }
+  taosMemoryFree(aVarLen);
+  taosMemoryFree(pVarBuf);
+  return code;
+}
+
+// The batch is bound column by column: all rows are laid out first, then the checks and the append info of a column
+// are worked out once and its values are copied into every row, so a wide table does not redo them for every cell.
+static int32_t stmtBindColsToRows(STableDataBlocks* pDataBlock, TAOS_MULTI_BIND* bind, SMsgBuf* pBuf) {
   SSchema*            pSchema = getTableColumnSchema(pDataBlock->pTableMeta);
   int32_t             extendedRowSize = insGetExtendedRowSize(pDataBlock);
   SParsedDataColInfo* spd = &pDataBlock->boundColumnInfo;
   SRowBuilder*        pBuilder = &pDataBlock->rowBuilder;
   SMemParam           param = {.rb = pBuilder};
-  SMsgBuf             pBuf = {.buf = msgBuf, .len = msgBufLen};
   int32_t             rowNum = bind->num;
 
   CHECK_CODE(
       insInitRowBuilder(&pDataBlock->rowBuilder, pDataBlock->pTableMeta->sversion, &pDataBlock->boundColumnInfo));
 
-  CHECK_CODE(insAllocateMemForSize(pDataBlock, extendedRowSize * bind->num));
+  CHECK_CODE(insAllocateMemForSize(pDataBlock, extendedRowSize * rowNum));
 
-  for (int32_t r = 0; r < bind->num; ++r) {
-    STSRow* row = (STSRow*)(pDataBlock->pData + pDataBlock->size);  // skip the SSubmitBlk header
-    tdSRowResetBuf(pBuilder, row);
+  // the rows are filled a column at a time, so whether a row holds a null is kept per row rather than in the builder
+  bool* rowHasNull = taosMemoryCalloc(rowNum > 0 ? rowNum : 1, sizeof(bool));
+  if (NULL == rowHasNull) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
 
-    for (int c = 0; c < spd->numOfBound; ++c) {
-      SSchema* pColSchema = &pSchema[spd->boundColumns[c]];
+  int32_t code = TSDB_CODE_SUCCESS;
+  char*   pRows = pDataBlock->pData + pDataBlock->size;  // skip the SSubmitBlk header
+  for (int32_t r = 0; r < rowNum; ++r) {
+    tdSRowResetBuf(pBuilder, pRows + extendedRowSize * r);
+  }
+
+  for (int c = 0; c < spd->numOfBound; ++c) {
+    SSchema* pColSchema = &pSchema[spd->boundColumns[c]];
+    bool     isPrimaryKey = (PRIMARYKEY_TIMESTAMP_COL_ID == pColSchema->colId);
+    bool     isVarData = IS_VAR_DATA_TYPE(pColSchema->type);
 
-      if (bind[c].num != rowNum) {
-        return buildInvalidOperationMsg(&pBuf, "row number in each bind param should be the same");
+    param.schema = pColSchema;
+    insGetSTSRowAppendInfo(pBuilder->rowType, spd, c, &param.toffset, &param.colIdx);
+
+    // fixed length values go into the tuples in one pass over the column
+    if (TD_IS_TP_ROW_T(pBuilder->rowType) && !isPrimaryKey && !isVarData &&
+        bind[c].buffer_type == pColSchema->type) {
+      code = tdAppendColValsToTpRows(pBuilder, pRows, extendedRowSize, rowNum, pColSchema->type, param.colIdx,
+                                     param.toffset, bind[c].buffer, bind[c].buffer_length, bind[c].is_null,
+                                     rowHasNull);
+      if (TSDB_CODE_SUCCESS != code) {
+        goto end;
       }
+      continue;
+    }
 
-      param.schema = pColSchema;
-      insGetSTSRowAppendInfo(pBuilder->rowType, spd, c, &param.toffset, &param.colIdx);
+    for (int32_t r = 0; r < rowNum; ++r) {
+      STSRow* row = (STSRow*)(pRows + extendedRowSize * r);
+      tdSRowGetBuf(pBuilder, row);
+      pBuilder->hasNull = false;
 
       if (bind[c].is_null && bind[c].is_null[r]) {
-        if (pColSchema->colId == PRIMARYKEY_TIMESTAMP_COL_ID) {
-          return buildInvalidOperationMsg(&pBuf, "primary timestamp should not be NULL");
+        if (isPrimaryKey) {
+          code = buildInvalidOperationMsg(pBuf, "primary timestamp should not be NULL");
+          goto end;
         }
 
-        CHECK_CODE(insMemRowAppend(&pBuf, NULL, 0, &param));
+        code = insMemRowAppend(pBuf, NULL, 0, &param);
       } else {
         if (bind[c].buffer_type != pColSchema->type) {
-          return buildInvalidOperationMsg(&pBuf, "column type mis-match with buffer type");
-        }
-
-        int32_t colLen = pColSchema->bytes;
-        if (IS_VAR_DATA_TYPE(pColSchema->type)) {
-          colLen = bind[c].length[r];
+          code = buildInvalidOperationMsg(pBuf, "column type mis-match with buffer type");
+          goto end;
         }
 
-        CHECK_CODE(insMemRowAppend(&pBuf, (char*)bind[c].buffer + bind[c].buffer_length * r, colLen, &param));
+        int32_t colLen = isVarData ? bind[c].length[r] : pColSchema->bytes;
+        code = insMemRowAppend(pBuf, (char*)bind[c].buffer + bind[c].buffer_length * r, colLen, &param);
       }
+      if (TSDB_CODE_SUCCESS != code) {
+        goto end;
+      }
+      rowHasNull[r] |= pBuilder->hasNull;
 
-      if (PRIMARYKEY_TIMESTAMP_COL_ID == pColSchema->colId) {
+      if (isPrimaryKey) {
         TSKEY tsKey = TD_ROW_KEY(row);
         insCheckTimestamp(pDataBlock, (const char*)&tsKey);
       }
     }
-    // set the null value for the columns that do not assign values
-    if ((spd->numOfBound < spd->numOfCols) && TD_IS_TP_ROW(row)) {
-      pBuilder->hasNone = true;
-    }
+  }
+
+  // set the null value for the columns that do not assign values
+  bool hasNone = (spd->numOfBound < spd->numOfCols) && TD_IS_TP_ROW_T(pBuilder->rowType);
+  for (int32_t r = 0; r < rowNum; ++r) {
+    STSRow* row = (STSRow*)(pRows + extendedRowSize * r);
+    tdSRowGetBuf(pBuilder, row);
+    pBuilder->hasNull = rowHasNull[r];
+    pBuilder->hasNone = hasNone;
     tdSRowEnd(pBuilder);
 #ifdef TD_DEBUG_PRINT_ROW
     STSchema* pSTSchema = tdGetSTSChemaFromSSChema(pSchema, spd->numOfCols, 1);
     tdSRowPrint(row, pSTSchema, __func__);
     taosMemoryFree(pSTSchema);
 #endif
-    pDataBlock->size += extendedRowSize;
   }
+  pDataBlock->size += extendedRowSize * rowNum;
 
   SSubmitBlk* pBlocks = (SSubmitBlk*)(pDataBlock->pData);
-  return insSetBlockInfo(pBlocks, pDataBlock, bind->num, &pBuf);
+  code = insSetBlockInfo(pBlocks, pDataBlock, rowNum, pBuf);
+
+end:
+  taosMemoryFree(rowHasNull);
+  return code;
+}
+
+int32_t qBindStmtColsValue(void* pBlock, TAOS_MULTI_BIND* bind, char* msgBuf, int32_t msgBufLen) {
+  STableDataBlocks*   pDataBlock = (STableDataBlocks*)pBlock;
+  SParsedDataColInfo* spd = &pDataBlock->boundColumnInfo;
+  SMsgBuf             pBuf = {.buf = msgBuf, .len = msgBufLen};
+  int32_t             rowNum = bind->num;
+
+  for (int c = 0; c < spd->numOfBound; ++c) {
+    if (bind[c].num != rowNum) {
+      return buildInvalidOperationMsg(&pBuf, "row number in each bind param should be the same");
+    }
+  }
+
+  // the rows bound one column at a time before are kept as rows
+  if (insUseColBlock(pDataBlock)) {
+    return stmtBindColsToColBlock(pDataBlock, bind, &pBuf);
+  }
+  return stmtBindColsToRows(pDataBlock, bind, &pBuf);
 }
 
 int32_t qBindStmtSingleColValue(void* pBlock, TAOS_MULTI_BIND* bind, char* msgBuf, int32_t msgBufLen, int32_t colIdx,
@@ -237,6 +406,7 @@ int32_t qBindStmtSingleColValue(void* pBlock, TAOS_MULTI_BIND* bind, char* msgBu
   bool                rowEnd = ((colIdx + 1) == spd->numOfBound);
 
   if (rowStart) {
+    CHECK_CODE(insColBlockToRows(pDataBlock));
     CHECK_CODE(
         insInitRowBuilder(&pDataBlock->rowBuilder, pDataBlock->pTableMeta->sversion, &pDataBlock->boundColumnInfo));
     CHECK_CODE(insAllocateMemForSize(pDataBlock, extendedRowSize * bind->num));
@@ -402,6 +572,12 @@ int32_t qResetStmtDataBlock(void* block, bool keepBuf) {
 
   memset(&pBlock->rowBuilder, 0, sizeof(pBlock->rowBuilder));
 
+  if (keepBuf) {
+    if (pBlock->pColBlock) blockDataCleanup(pBlock->pColBlock);
+  } else {
+    pBlock->pColBlock = NULL;
+  }
+
   return TSDB_CODE_SUCCESS;
 }
 
@@ -460,6 +636,7 @@ void qFreeStmtDataBlock(void* pDataBlock) {
     return;
   }
 
+  blockDataDestroy(((STableDataBlocks*)pDataBlock)->pColBlock);
   taosMemoryFreeClear(((STableDataBlocks*)pDataBlock)->pTableMeta);
   taosMemoryFreeClear(((STableDataBlocks*)pDataBlock)->pData);
   taosMemoryFreeClear(pDataBlock);
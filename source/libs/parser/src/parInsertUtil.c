@@ -20,6 +20,7 @@
 #include "parUtil.h"
 #include "querynodes.h"
 #include "tRealloc.h"
+#include "tdatablock.h"
 
 typedef struct SBlockKeyTuple {
   TSKEY   skey;
@@ -32,6 +33,11 @@ typedef struct SBlockKeyInfo {
   SBlockKeyTuple* pKeyTuple;
 } SBlockKeyInfo;
 
+typedef struct SColBlockKey {
+  TSKEY   skey;
+  int32_t index;
+} SColBlockKey;
+
 typedef struct {
   int32_t   index;
   SArray*   rowArray;  // array of merged rows(mem allocated by tRealloc/free by tFree)
@@ -78,6 +84,16 @@ static int32_t rowDataComparStable(const void* lhs, const void* rhs) {
   }
 }
 
+static int32_t colBlockKeyCompar(const void* lhs, const void* rhs) {
+  const SColBlockKey* left = lhs;
+  const SColBlockKey* right = rhs;
+  if (left->skey == right->skey) {
+    return left->index - right->index;
+  } else {
+    return left->skey > right->skey ? 1 : -1;
+  }
+}
+
 int32_t insGetExtendedRowSize(STableDataBlocks* pBlock) {
   STableComInfo* pTableInfo = &pBlock->pTableMeta->tableInfo;
   ASSERT(pBlock->rowSize == pTableInfo->rowSize);
@@ -194,8 +210,8 @@ void destroyBoundColumnInfo(void* pBoundInfo) {
   taosMemoryFreeClear(pColList->colIdxInfo);
 }
 
-static int32_t createDataBlock(size_t defaultSize, int32_t rowSize, int32_t startOffset, STableMeta* pTableMeta,
-                               STableDataBlocks** dataBlocks) {
+static int32_t createTableDataBlock(size_t defaultSize, int32_t rowSize, int32_t startOffset, STableMeta* pTableMeta,
+                                    STableDataBlocks** dataBlocks) {
   STableDataBlocks* dataBuf = (STableDataBlocks*)taosMemoryCalloc(1, sizeof(STableDataBlocks));
   if (dataBuf == NULL) {
     return TSDB_CODE_OUT_OF_MEMORY;
@@ -269,6 +285,7 @@ void insDestroyDataBlock(STableDataBlocks* pDataBlock) {
     return;
   }
 
+  blockDataDestroy(pDataBlock->pColBlock);
   taosMemoryFreeClear(pDataBlock->pData);
   taosMemoryFreeClear(pDataBlock->pTableMeta);
   destroyBoundColumnInfo(&pDataBlock->boundColumnInfo);
@@ -285,7 +302,7 @@ int32_t insGetDataBlockFromList(SHashObj* pHashList, void* id, int32_t idLen, in
   }
 
   if (*dataBlocks == NULL) {
-    int32_t ret = createDataBlock((size_t)size, rowSize, startOffset, pTableMeta, dataBlocks);
+    int32_t ret = createTableDataBlock((size_t)size, rowSize, startOffset, pTableMeta, dataBlocks);
     if (ret != TSDB_CODE_SUCCESS) {
       return ret;
     }
@@ -338,6 +355,177 @@ void insDestroyBlockHashmap(SHashObj* pDataBlockHash) {
   taosHashCleanup(pDataBlockHash);
 }
 
+// The rows bound by column go into the column block as long as the primary key is bound and no row of the table is
+// bound otherwise, which keeps all the rows of the table in one of the two forms.
+bool insUseColBlock(STableDataBlocks* pDataBlock) {
+  SParsedDataColInfo* spd = &pDataBlock->boundColumnInfo;
+  SSubmitBlk*         pBlocks = (SSubmitBlk*)pDataBlock->pData;
+  int32_t             numOfRows = (pDataBlock->pColBlock != NULL) ? pDataBlock->pColBlock->info.rows : 0;
+  if (pBlocks->numOfRows != numOfRows) {
+    return false;
+  }
+
+  for (col_id_t c = 0; c < spd->numOfBound; ++c) {
+    if (spd->boundColumns[c] == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+int32_t insInitColBlock(STableDataBlocks* pDataBlock, int32_t numOfRows) {
+  SParsedDataColInfo* spd = &pDataBlock->boundColumnInfo;
+
+  if (pDataBlock->pColBlock == NULL) {
+    SSchema*     pSchema = getTableColumnSchema(pDataBlock->pTableMeta);
+    SSDataBlock* pBlock = createDataBlock();
+    if (pBlock == NULL) {
+      return TSDB_CODE_OUT_OF_MEMORY;
+    }
+
+    pBlock->pDataBlock = taosArrayInit(spd->numOfBound, sizeof(SColumnInfoData));
+    if (pBlock->pDataBlock == NULL) {
+      blockDataDestroy(pBlock);
+      return TSDB_CODE_OUT_OF_MEMORY;
+    }
+    taosArraySetSize(pBlock->pDataBlock, spd->numOfBound);
+    for (col_id_t c = 0; c < spd->numOfBound; ++c) {
+      SSchema*         pColSchema = &pSchema[spd->boundColumns[c]];
+      SColumnInfoData* pCol = taosArrayGet(pBlock->pDataBlock, INS_COL_BLOCK_IDX(spd, c));
+      *pCol = createColumnInfoData(pColSchema->type, pColSchema->bytes, pColSchema->colId);
+      pBlock->info.hasVarCol |= IS_VAR_DATA_TYPE(pColSchema->type);
+      pBlock->info.rowSize += pColSchema->bytes;
+    }
+    pDataBlock->pColBlock = pBlock;
+  }
+
+  // the batches of a table are appended, the capacity is doubled so that they are not copied for each batch
+  SDataBlockInfo* pInfo = &pDataBlock->pColBlock->info;
+  uint32_t        capacity = pInfo->rows + numOfRows;
+  if (capacity > pInfo->capacity) {
+    capacity = TMAX(capacity, pInfo->capacity * 2);
+  }
+  return blockDataEnsureCapacity(pDataBlock->pColBlock, capacity);
+}
+
+// the value is taken as insMemRowAppend takes it, pVarBuf holds a var value of the column
+int32_t insColBlockAppend(SMsgBuf* pMsgBuf, SColumnInfoData* pCol, int32_t iRow, SSchema* pSchema, const void* value,
+                          int32_t len, char* pVarBuf) {
+  if (value == NULL) {
+    colDataAppendNULL(pCol, iRow);
+    return TSDB_CODE_SUCCESS;
+  }
+
+  if (TSDB_DATA_TYPE_BINARY == pSchema->type) {
+    if (len + VARSTR_HEADER_SIZE > pSchema->bytes) {
+      return generateSyntaxErrMsg(pMsgBuf, TSDB_CODE_PAR_VALUE_TOO_LONG, pSchema->name);
+    }
+    STR_WITH_SIZE_TO_VARSTR(pVarBuf, value, len);
+    value = pVarBuf;
+  } else if (TSDB_DATA_TYPE_NCHAR == pSchema->type) {
+    int32_t output = 0;
+    if (!taosMbsToUcs4(value, len, (TdUcs4*)varDataVal(pVarBuf), pSchema->bytes - VARSTR_HEADER_SIZE, &output)) {
+      if (errno == E2BIG) {
+        return generateSyntaxErrMsg(pMsgBuf, TSDB_CODE_PAR_VALUE_TOO_LONG, pSchema->name);
+      }
+      char buf[512] = {0};
+      snprintf(buf, tListLen(buf), "%s", strerror(errno));
+      return buildSyntaxErrMsg(pMsgBuf, buf, value);
+    }
+    varDataSetLen(pVarBuf, output);
+    value = pVarBuf;
+  }
+
+  return colDataAppend(pCol, iRow, value, false);
+}
+
+// The rows of the column block are put into pData as rows, for the rows to be bound otherwise to follow them.
+int32_t insColBlockToRows(STableDataBlocks* pDataBlock) {
+  SSDataBlock* pColBlock = pDataBlock->pColBlock;
+  if (pColBlock == NULL || pColBlock->info.rows == 0) {
+    return TSDB_CODE_SUCCESS;
+  }
+
+  STableMeta* pTableMeta = pDataBlock->pTableMeta;
+  int32_t     extendedRowSize = insGetExtendedRowSize(pDataBlock);
+  int32_t     numOfRows = pColBlock->info.rows;
+  STSchema*   pTSchema =
+      tdGetSTSChemaFromSSChema(pTableMeta->schema, pTableMeta->tableInfo.numOfColumns, pTableMeta->sversion);
+  if (pTSchema == NULL) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  int32_t code = insAllocateMemForSize(pDataBlock, extendedRowSize * numOfRows);
+  if (TSDB_CODE_SUCCESS == code) {
+    for (int32_t r = 0; r < numOfRows; ++r) {
+      tGetSubmitColBlkRow(pColBlock, pTSchema, r, (STSRow*)(pDataBlock->pData + pDataBlock->size));
+      pDataBlock->size += extendedRowSize;
+    }
+    blockDataCleanup(pColBlock);
+  }
+
+  taosMemoryFree(pTSchema);
+  return code;
+}
+
+// Sort the rows of the column block in ascending order of the key. Each bound column is given in every row, so of the
+// rows of a key the last one is what sortMergeDataBlockDupRows would merge them into.
+static int32_t sortColBlockDupRows(STableDataBlocks* dataBuf) {
+  SSubmitBlk*  pBlocks = (SSubmitBlk*)dataBuf->pData;
+  SSDataBlock* pBlock = dataBuf->pColBlock;
+  int32_t      nRows = pBlock->info.rows;
+
+  if (!dataBuf->ordered) {
+    SColBlockKey* pKeys = taosMemoryMalloc(nRows * sizeof(SColBlockKey));
+    SSDataBlock*  pSorted = createOneDataBlock(pBlock, false);
+    if (pKeys == NULL || pSorted == NULL || blockDataEnsureCapacity(pSorted, nRows) != TSDB_CODE_SUCCESS) {
+      taosMemoryFree(pKeys);
+      blockDataDestroy(pSorted);
+      return TSDB_CODE_OUT_OF_MEMORY;
+    }
+
+    const TSKEY* pTs = (const TSKEY*)((SColumnInfoData*)taosArrayGet(pBlock->pDataBlock, 0))->pData;
+    for (int32_t r = 0; r < nRows; ++r) {
+      pKeys[r].skey = pTs[r];
+      pKeys[r].index = r;
+    }
+    taosSort(pKeys, nRows, sizeof(SColBlockKey), colBlockKeyCompar);
+
+    int32_t n = 0;
+    for (int32_t r = 0; r < nRows; ++r) {
+      if (r + 1 < nRows && pKeys[r + 1].skey == pKeys[r].skey) {
+        continue;
+      }
+      pKeys[n++] = pKeys[r];
+    }
+
+    int32_t code = TSDB_CODE_SUCCESS;
+    int32_t numOfCols = taosArrayGetSize(pBlock->pDataBlock);
+    for (int32_t i = 0; i < numOfCols && TSDB_CODE_SUCCESS == code; ++i) {
+      SColumnInfoData* pSrc = taosArrayGet(pBlock->pDataBlock, i);
+      SColumnInfoData* pDst = taosArrayGet(pSorted->pDataBlock, i);
+      for (int32_t r = 0; r < n && TSDB_CODE_SUCCESS == code; ++r) {
+        bool isNull = colDataIsNull_s(pSrc, pKeys[r].index);
+        code = colDataAppend(pDst, r, isNull ? NULL : colDataGetData(pSrc, pKeys[r].index), isNull);
+      }
+    }
+    taosMemoryFree(pKeys);
+    if (TSDB_CODE_SUCCESS != code) {
+      blockDataDestroy(pSorted);
+      return code;
+    }
+
+    pSorted->info.rows = n;
+    blockDataDestroy(pBlock);
+    dataBuf->pColBlock = pSorted;
+    dataBuf->ordered = true;
+    pBlocks->numOfRows = n;
+  }
+
+  dataBuf->prevTS = INT64_MIN;
+  return TSDB_CODE_SUCCESS;
+}
+
 // data block is disordered, sort it in ascending order
 static int sortRemoveDataBlockDupRows(STableDataBlocks* dataBuf, SBlockKeyInfo* pBlkKeyInfo) {
   SSubmitBlk* pBlocks = (SSubmitBlk*)dataBuf->pData;
@@ -625,6 +813,17 @@ static int trimDataBlock(void* pDataBlock, STableDataBlocks* pTableDataBlock, SB
   return pBlock->dataLen + pBlock->schemaLen;
 }
 
+static int trimColDataBlock(void* pDataBlock, STableDataBlocks* pTableDataBlock) {
+  int32_t     nonDataLen = sizeof(SSubmitBlk) + pTableDataBlock->createTbReqLen;
+  SSubmitBlk* pBlock = pDataBlock;
+  memcpy(pDataBlock, pTableDataBlock->pData, nonDataLen);
+
+  pBlock->schemaLen = pTableDataBlock->createTbReqLen;
+  pBlock->dataLen = tEncodeSubmitColBlk(pTableDataBlock->pColBlock, (char*)pDataBlock + nonDataLen);
+
+  return pBlock->dataLen + pBlock->schemaLen;
+}
+
 int32_t insMergeTableDataBlocks(SHashObj* pHashObj, SArray** pVgDataBlocks) {
   const int INSERT_HEAD_SIZE = sizeof(SSubmitReq);
   int       code = 0;
@@ -653,9 +852,13 @@ int32_t insMergeTableDataBlocks(SHashObj* pHashObj, SArray** pVgDataBlocks) {
       }
       ASSERT(pOneTableBlock->pTableMeta->tableInfo.rowSize > 0);
       // the maximum expanded size in byte when a row-wise data is converted to SDataRow format
+      bool    isColBlock = (pOneTableBlock->pColBlock != NULL && pOneTableBlock->pColBlock->info.rows > 0);
       int64_t destSize = dataBuf->size + pOneTableBlock->size +
                          sizeof(STColumn) * getNumOfColumns(pOneTableBlock->pTableMeta) +
                          pOneTableBlock->createTbReqLen;
+      if (isColBlock) {
+        destSize += tGetSubmitColBlkSize(pOneTableBlock->pColBlock);
+      }
 
       if (dataBuf->nAllocSize < destSize) {
         dataBuf->nAllocSize = (uint32_t)(destSize * 1.5);
@@ -672,7 +875,12 @@ int32_t insMergeTableDataBlocks(SHashObj* pHashObj, SArray** pVgDataBlocks) {
         }
       }
 
-      if ((code = sortMergeDataBlockDupRows(pOneTableBlock, &blkKeyInfo, &pBlkRowMerger)) != 0) {
+      if (isColBlock) {
+        code = sortColBlockDupRows(pOneTableBlock);
+      } else {
+        code = sortMergeDataBlockDupRows(pOneTableBlock, &blkKeyInfo, &pBlkRowMerger);
+      }
+      if (code != 0) {
         tdFreeSBlockRowMerger(pBlkRowMerger);
         taosHashCleanup(pVnodeDataBlockHashList);
         insDestroyBlockArrayList(pVnodeDataBlockList);
@@ -680,10 +888,16 @@ int32_t insMergeTableDataBlocks(SHashObj* pHashObj, SArray** pVgDataBlocks) {
         taosMemoryFreeClear(blkKeyInfo.pKeyTuple);
         return code;
       }
-      ASSERT(blkKeyInfo.pKeyTuple != NULL && pBlocks->numOfRows > 0);
 
-      // erase the empty space reserved for binary data
-      int32_t finalLen = trimDataBlock(dataBuf->pData + dataBuf->size, pOneTableBlock, blkKeyInfo.pKeyTuple);
+      int32_t finalLen = 0;
+      if (isColBlock) {
+        finalLen = trimColDataBlock(dataBuf->pData + dataBuf->size, pOneTableBlock);
+      } else {
+        ASSERT(blkKeyInfo.pKeyTuple != NULL && pBlocks->numOfRows > 0);
+
+        // erase the empty space reserved for binary data
+        finalLen = trimDataBlock(dataBuf->pData + dataBuf->size, pOneTableBlock, blkKeyInfo.pKeyTuple);
+      }
 
       dataBuf->size += (finalLen + sizeof(SSubmitBlk));
       assert(dataBuf->size <= dataBuf->nAllocSize);
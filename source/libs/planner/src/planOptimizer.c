@@ -669,11 +669,45 @@ static bool pushDownCondOptContainPriKeyEqualCond(SJoinLogicNode* pJoin, SNode*
   }
 }
 
+static bool pushDownCondOptIsColEqualCond(SJoinLogicNode* pJoin, SNode* pCond) {
+  if (!isEquiJoinKeyCond(pCond)) {
+    return false;
+  }
+
+  SOperatorNode* pOper = (SOperatorNode*)pCond;
+  SNodeList*     pLeftCols = ((SLogicNode*)nodesListGetNode(pJoin->node.pChildren, 0))->pTargets;
+  SNodeList*     pRightCols = ((SLogicNode*)nodesListGetNode(pJoin->node.pChildren, 1))->pTargets;
+  if (pushDownCondOptBelongThisTable(pOper->pLeft, pLeftCols)) {
+    return pushDownCondOptBelongThisTable(pOper->pRight, pRightCols);
+  } else if (pushDownCondOptBelongThisTable(pOper->pLeft, pRightCols)) {
+    return pushDownCondOptBelongThisTable(pOper->pRight, pLeftCols);
+  }
+  return false;
+}
+
+static bool pushDownCondOptContainColEqualCond(SJoinLogicNode* pJoin, SNode* pCond) {
+  if (QUERY_NODE_LOGIC_CONDITION == nodeType(pCond)) {
+    SLogicConditionNode* pLogicCond = (SLogicConditionNode*)pCond;
+    if (LOGIC_COND_TYPE_AND != pLogicCond->condType) {
+      return false;
+    }
+    SNode* pParam = NULL;
+    FOREACH(pParam, pLogicCond->pParameterList) {
+      if (pushDownCondOptIsColEqualCond(pJoin, pParam)) {
+        return true;
+      }
+    }
+    return false;
+  }
+  return pushDownCondOptIsColEqualCond(pJoin, pCond);
+}
+
 static int32_t pushDownCondOptCheckJoinOnCond(SOptimizeContext* pCxt, SJoinLogicNode* pJoin) {
   if (NULL == pJoin->pOnConditions) {
     return generateUsageErrMsg(pCxt->pPlanCxt->pMsg, pCxt->pPlanCxt->msgLen, TSDB_CODE_PLAN_NOT_SUPPORT_CROSS_JOIN);
   }
-  if (!pushDownCondOptContainPriKeyEqualCond(pJoin, pJoin->pOnConditions)) {
+  if (!pushDownCondOptContainPriKeyEqualCond(pJoin, pJoin->pOnConditions) &&
+      !pushDownCondOptContainColEqualCond(pJoin, pJoin->pOnConditions)) {
     return generateUsageErrMsg(pCxt->pPlanCxt->pMsg, pCxt->pPlanCxt->msgLen, TSDB_CODE_PLAN_EXPECTED_TS_EQUAL);
   }
   return TSDB_CODE_SUCCESS;
@@ -729,6 +763,10 @@ static int32_t pushDownCondOptPartJoinOnCond(SJoinLogicNode* pJoin, SNode** ppMe
 
 static int32_t pushDownCondOptJoinExtractMergeCond(SOptimizeContext* pCxt, SJoinLogicNode* pJoin) {
   int32_t code = pushDownCondOptCheckJoinOnCond(pCxt, pJoin);
+  if (TSDB_CODE_SUCCESS == code && !pushDownCondOptContainPriKeyEqualCond(pJoin, pJoin->pOnConditions)) {
+    // without left.ts = right.ts the join is done by hashing the column equal conditions, see createJoinPhysiNode
+    return TSDB_CODE_SUCCESS;
+  }
   SNode*  pJoinMergeCond = NULL;
   SNode*  pJoinOnCond = NULL;
   if (TSDB_CODE_SUCCESS == code) {
@@ -1098,6 +1136,11 @@ static int32_t sortPriKeyOptGetSequencingNodesImpl(SLogicNode* pNode, bool* pNot
       return nodesListMakeAppend(pSequencingNodes, (SNode*)pNode);
     }
     case QUERY_NODE_LOGIC_PLAN_JOIN: {
+      if (NULL == ((SJoinLogicNode*)pNode)->pMergeCondition) {
+        // the output of a hash join is not ordered by the primary key of both sides
+        *pNotOptimize = true;
+        return TSDB_CODE_SUCCESS;
+      }
       int32_t code = sortPriKeyOptGetSequencingNodesImpl((SLogicNode*)nodesListGetNode(pNode->pChildren, 0),
                                                          pNotOptimize, pSequencingNodes);
       if (TSDB_CODE_SUCCESS == code) {
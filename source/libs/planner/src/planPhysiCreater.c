@@ -661,8 +661,133 @@ static int32_t createScanPhysiNode(SPhysiPlanContext* pCxt, SSubplan* pSubplan,
   return TSDB_CODE_FAILED;
 }
 
+static int32_t addHashJoinKey(SPhysiPlanContext* pCxt, int16_t leftDataBlockId, int16_t rightDataBlockId,
+                              SNode* pCond, SHashJoinPhysiNode* pJoin, bool* pIsKey) {
+  SOperatorNode* pOper = NULL;
+  int32_t        code = setNodeSlotId(pCxt, leftDataBlockId, rightDataBlockId, pCond, (SNode**)&pOper);
+  if (TSDB_CODE_SUCCESS != code) {
+    return code;
+  }
+
+  SNode* pLeftKey = pOper->pLeft;
+  SNode* pRightKey = pOper->pRight;
+  if (((SColumnNode*)pLeftKey)->dataBlockId != leftDataBlockId) {
+    TSWAP(pLeftKey, pRightKey);
+  }
+  *pIsKey = (((SColumnNode*)pLeftKey)->dataBlockId == leftDataBlockId &&
+             ((SColumnNode*)pRightKey)->dataBlockId == rightDataBlockId);
+  if (*pIsKey) {
+    code = nodesListMakeStrictAppend(&pJoin->pLeftKeys, nodesCloneNode(pLeftKey));
+    if (TSDB_CODE_SUCCESS == code) {
+      code = nodesListMakeStrictAppend(&pJoin->pRightKeys, nodesCloneNode(pRightKey));
+    }
+  }
+  nodesDestroyNode((SNode*)pOper);
+  return code;
+}
+
+// Split the on conditions into the equal conditions used as the hash key and the ones evaluated after the join.
+static int32_t setHashJoinKeys(SPhysiPlanContext* pCxt, int16_t leftDataBlockId, int16_t rightDataBlockId,
+                               SNode* pOnCond, SHashJoinPhysiNode* pJoin, SNode** pOtherCond) {
+  SNodeList* pOtherConds = NULL;
+  int32_t    code = TSDB_CODE_SUCCESS;
+  if (QUERY_NODE_LOGIC_CONDITION == nodeType(pOnCond) &&
+      LOGIC_COND_TYPE_AND == ((SLogicConditionNode*)pOnCond)->condType) {
+    SNode* pCond = NULL;
+    FOREACH(pCond, ((SLogicConditionNode*)pOnCond)->pParameterList) {
+      bool isKey = false;
+      if (isEquiJoinKeyCond(pCond)) {
+        code = addHashJoinKey(pCxt, leftDataBlockId, rightDataBlockId, pCond, pJoin, &isKey);
+      }
+      if (TSDB_CODE_SUCCESS == code && !isKey) {
+        code = nodesListMakeStrictAppend(&pOtherConds, nodesCloneNode(pCond));
+      }
+      if (TSDB_CODE_SUCCESS != code) {
+        break;
+      }
+    }
+  } else {
+    bool isKey = false;
+    if (isEquiJoinKeyCond(pOnCond)) {
+      code = addHashJoinKey(pCxt, leftDataBlockId, rightDataBlockId, pOnCond, pJoin, &isKey);
+    }
+    if (TSDB_CODE_SUCCESS == code && !isKey) {
+      code = nodesListMakeStrictAppend(&pOtherConds, nodesCloneNode(pOnCond));
+    }
+  }
+
+  if (TSDB_CODE_SUCCESS == code && NULL == pJoin->pLeftKeys) {
+    planError("hash join without equal condition on columns of both sides");
+    code = TSDB_CODE_PLAN_INTERNAL_ERROR;
+  }
+  if (TSDB_CODE_SUCCESS == code) {
+    code = nodesMergeConds(pOtherCond, &pOtherConds);
+  }
+  nodesDestroyList(pOtherConds);
+  return code;
+}
+
+static int32_t createHashJoinPhysiNode(SPhysiPlanContext* pCxt, SNodeList* pChildren, SJoinLogicNode* pJoinLogicNode,
+                                       SPhysiNode** pPhyNode) {
+  SHashJoinPhysiNode* pJoin =
+      (SHashJoinPhysiNode*)makePhysiNode(pCxt, (SLogicNode*)pJoinLogicNode, QUERY_NODE_PHYSICAL_PLAN_HASH_JOIN);
+  if (NULL == pJoin) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+
+  SDataBlockDescNode* pLeftDesc = ((SPhysiNode*)nodesListGetNode(pChildren, 0))->pOutputDataBlockDesc;
+  SDataBlockDescNode* pRightDesc = ((SPhysiNode*)nodesListGetNode(pChildren, 1))->pOutputDataBlockDesc;
+  SNode*              pOtherCond = NULL;
+
+  pJoin->joinType = pJoinLogicNode->joinType;
+  int32_t code = setHashJoinKeys(pCxt, pLeftDesc->dataBlockId, pRightDesc->dataBlockId,
+                                 pJoinLogicNode->pOnConditions, pJoin, &pOtherCond);
+  if (TSDB_CODE_SUCCESS == code) {
+    code = setListSlotId(pCxt, pLeftDesc->dataBlockId, pRightDesc->dataBlockId, pJoinLogicNode->node.pTargets,
+                         &pJoin->pTargets);
+  }
+  if (TSDB_CODE_SUCCESS == code) {
+    code = addDataBlockSlots(pCxt, pJoin->pTargets, pJoin->node.pOutputDataBlockDesc);
+  }
+
+  if (TSDB_CODE_SUCCESS == code && NULL != pOtherCond) {
+    SNodeList* pCondCols = nodesMakeList();
+    if (NULL == pCondCols) {
+      code = TSDB_CODE_OUT_OF_MEMORY;
+    } else {
+      code = nodesCollectColumnsFromNode(pOtherCond, NULL, COLLECT_COL_TYPE_ALL, &pCondCols);
+    }
+    if (TSDB_CODE_SUCCESS == code) {
+      code = addDataBlockSlots(pCxt, pCondCols, pJoin->node.pOutputDataBlockDesc);
+    }
+    nodesDestroyList(pCondCols);
+  }
+
+  if (TSDB_CODE_SUCCESS == code && NULL != pOtherCond) {
+    code = setNodeSlotId(pCxt, ((SPhysiNode*)pJoin)->pOutputDataBlockDesc->dataBlockId, -1, pOtherCond,
+                         &pJoin->pOnConditions);
+  }
+  nodesDestroyNode(pOtherCond);
+
+  if (TSDB_CODE_SUCCESS == code) {
+    code = setConditionsSlotId(pCxt, (const SLogicNode*)pJoinLogicNode, (SPhysiNode*)pJoin);
+  }
+
+  if (TSDB_CODE_SUCCESS == code) {
+    *pPhyNode = (SPhysiNode*)pJoin;
+  } else {
+    nodesDestroyNode((SNode*)pJoin);
+  }
+
+  return code;
+}
+
 static int32_t createJoinPhysiNode(SPhysiPlanContext* pCxt, SNodeList* pChildren, SJoinLogicNode* pJoinLogicNode,
                                    SPhysiNode** pPhyNode) {
+  if (NULL == pJoinLogicNode->pMergeCondition) {
+    return createHashJoinPhysiNode(pCxt, pChildren, pJoinLogicNode, pPhyNode);
+  }
+
   SSortMergeJoinPhysiNode* pJoin =
       (SSortMergeJoinPhysiNode*)makePhysiNode(pCxt, (SLogicNode*)pJoinLogicNode, QUERY_NODE_PHYSICAL_PLAN_MERGE_JOIN);
   if (NULL == pJoin) {
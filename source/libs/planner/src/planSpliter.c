@@ -1150,11 +1150,25 @@ static int32_t stbSplSplitScanNode(SSplitContext* pCxt, SStableSplitInfo* pInfo)
   return stbSplSplitScanNodeWithoutPartTags(pCxt, pInfo);
 }
 
+// The build side of a hash join is consumed as a whole, so it is exchanged without merging by timestamp.
+static int32_t stbSplSplitHashJoinBuildNode(SSplitContext* pCxt, SLogicSubplan* pSubplan, SLogicNode* pScan) {
+  int32_t code = splCreateExchangeNodeForSubplan(pCxt, pSubplan, pScan, SUBPLAN_TYPE_MERGE);
+  if (TSDB_CODE_SUCCESS == code) {
+    code = nodesListMakeStrictAppend(&pSubplan->pChildren,
+                                     (SNode*)splCreateScanSubplan(pCxt, pScan, SPLIT_FLAG_STABLE_SPLIT));
+  }
+  ++(pCxt->groupId);
+  return code;
+}
+
 static int32_t stbSplSplitJoinNodeImpl(SSplitContext* pCxt, SLogicSubplan* pSubplan, SJoinLogicNode* pJoin) {
   int32_t code = TSDB_CODE_SUCCESS;
   SNode*  pChild = NULL;
   FOREACH(pChild, pJoin->node.pChildren) {
-    if (QUERY_NODE_LOGIC_PLAN_SCAN == nodeType(pChild)) {
+    if (QUERY_NODE_LOGIC_PLAN_SCAN == nodeType(pChild) && NULL == pJoin->pMergeCondition &&
+        pChild == nodesListGetNode(pJoin->node.pChildren, 1)) {
+      code = stbSplSplitHashJoinBuildNode(pCxt, pSubplan, (SLogicNode*)pChild);
+    } else if (QUERY_NODE_LOGIC_PLAN_SCAN == nodeType(pChild)) {
       code = stbSplSplitMergeScanNode(pCxt, pSubplan, (SScanLogicNode*)pChild, false);
     } else if (QUERY_NODE_LOGIC_PLAN_JOIN == nodeType(pChild)) {
       code = stbSplSplitJoinNodeImpl(pCxt, pSubplan, (SJoinLogicNode*)pChild);
@@ -124,6 +124,22 @@ int32_t replaceLogicNode(SLogicSubplan* pSubplan, SLogicNode* pOld, SLogicNode*
   return TSDB_CODE_PLAN_INTERNAL_ERROR;
 }
 
+// col1 = col2 of the same type, which can be used as the key of a hash join
+bool isEquiJoinKeyCond(SNode* pCond) {
+  if (QUERY_NODE_OPERATOR != nodeType(pCond) || OP_TYPE_EQUAL != ((SOperatorNode*)pCond)->opType) {
+    return false;
+  }
+  SOperatorNode* pOper = (SOperatorNode*)pCond;
+  if (NULL == pOper->pLeft || NULL == pOper->pRight || QUERY_NODE_COLUMN != nodeType(pOper->pLeft) ||
+      QUERY_NODE_COLUMN != nodeType(pOper->pRight)) {
+    return false;
+  }
+  uint8_t leftType = ((SExprNode*)pOper->pLeft)->resType.type;
+  uint8_t rightType = ((SExprNode*)pOper->pRight)->resType.type;
+  // keys are compared by their bytes, so float and json values are left to the filter
+  return leftType == rightType && !IS_FLOAT_TYPE(leftType) && TSDB_DATA_TYPE_JSON != leftType;
+}
+
 static int32_t adjustScanDataRequirement(SScanLogicNode* pScan, EDataOrderLevel requirement) {
   if ((SCAN_TYPE_TABLE != pScan->scanType && SCAN_TYPE_TABLE_MERGE != pScan->scanType) ||
       DATA_ORDER_LEVEL_GLOBAL == pScan->node.requireDataOrder) {
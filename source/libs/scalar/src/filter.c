@@ -3326,6 +3326,249 @@ bool filterExecuteImpl(void *pinfo, int32_t numOfRows, SColumnInfoData *pRes, SC
   return all;
 }
 
+/*
+ * Columnar execution for units on fixed-width numeric columns. Every unit is evaluated over the whole block into a
+ * 0/1 byte mask by a type-specialized loop, then the masks of a group are AND-ed and the groups are OR-ed. The final
+ * mask is the bool result column that block trimming consumes. The comparisons keep the semantics of gDataCompare,
+ * including the tolerance and NaN ordering of float/double.
+ */
+enum {
+  FLT_VEC_MODE_EQ = 8,  // 0 ~ 7 are the same as the index of gRangeCompare
+  FLT_VEC_MODE_NE,
+};
+
+#define FLT_VEC_CMP_INT(_x, _y, _op) ((_x)_op(_y))
+#define FLT_VEC_CMP_FLT(_x, _y, _op) (fltVecCompareFloat(_x, _y) _op 0)
+#define FLT_VEC_CMP_DBL(_x, _y, _op) (fltVecCompareDouble(_x, _y) _op 0)
+
+static FORCE_INLINE int32_t fltVecCompareFloat(float p1, float p2) {
+  if (isnan(p1) || isnan(p2)) {
+    return isnan(p1) ? (isnan(p2) ? 0 : -1) : 1;
+  }
+  return FLT_EQUAL(p1, p2) ? 0 : (FLT_GREATER(p1, p2) ? 1 : -1);
+}
+
+static FORCE_INLINE int32_t fltVecCompareDouble(double p1, double p2) {
+  if (isnan(p1) || isnan(p2)) {
+    return isnan(p1) ? (isnan(p2) ? 0 : -1) : 1;
+  }
+  return FLT_EQUAL(p1, p2) ? 0 : (FLT_GREATER(p1, p2) ? 1 : -1);
+}
+
+#define FLT_VEC_LOOP(_expr)                    \
+  do {                                         \
+    for (int32_t k = 0; k < numOfRows; ++k) {  \
+      res[k] = (_expr);                        \
+    }                                          \
+  } while (0)
+
+#define FLT_VEC_DEF_KERNEL(_name, _type, _cmp)                                                                     \
+  static void _name(const void *pData, int32_t numOfRows, const void *pVal, const void *pVal2, int32_t mode,       \
+                    uint8_t *res) {                                                                                \
+    const _type *p = (const _type *)pData;                                                                         \
+    _type        a = *(const _type *)pVal;                                                                         \
+    _type        b = *(const _type *)pVal2;                                                                        \
+    switch (mode) {                                                                                                \
+      case 0:                                                                                                      \
+        FLT_VEC_LOOP(_cmp(p[k], a, >) & _cmp(p[k], b, <));                                                         \
+        break;                                                                                                     \
+      case 1:                                                                                                      \
+        FLT_VEC_LOOP(_cmp(p[k], a, >) & _cmp(p[k], b, <=));                                                        \
+        break;                                                                                                     \
+      case 2:                                                                                                      \
+        FLT_VEC_LOOP(_cmp(p[k], a, >=) & _cmp(p[k], b, <));                                                        \
+        break;                                                                                                     \
+      case 3:                                                                                                      \
+        FLT_VEC_LOOP(_cmp(p[k], a, >=) & _cmp(p[k], b, <=));                                                       \
+        break;                                                                                                     \
+      case 4:                                                                                                      \
+        FLT_VEC_LOOP(_cmp(p[k], a, >));                                                                            \
+        break;                                                                                                     \
+      case 5:                                                                                                      \
+        FLT_VEC_LOOP(_cmp(p[k], a, >=));                                                                           \
+        break;                                                                                                     \
+      case 6:                                                                                                      \
+        FLT_VEC_LOOP(_cmp(p[k], b, <));                                                                            \
+        break;                                                                                                     \
+      case 7:                                                                                                      \
+        FLT_VEC_LOOP(_cmp(p[k], b, <=));                                                                           \
+        break;                                                                                                     \
+      case FLT_VEC_MODE_EQ:                                                                                        \
+        FLT_VEC_LOOP(_cmp(p[k], a, ==));                                                                           \
+        break;                                                                                                     \
+      case FLT_VEC_MODE_NE:                                                                                        \
+        FLT_VEC_LOOP(_cmp(p[k], a, !=));                                                                           \
+        break;                                                                                                     \
+      default:                                                                                                     \
+        break;                                                                                                     \
+    }                                                                                                              \
+  }
+
+FLT_VEC_DEF_KERNEL(fltVecCompareI8, int8_t, FLT_VEC_CMP_INT)
+FLT_VEC_DEF_KERNEL(fltVecCompareI16, int16_t, FLT_VEC_CMP_INT)
+FLT_VEC_DEF_KERNEL(fltVecCompareI32, int32_t, FLT_VEC_CMP_INT)
+FLT_VEC_DEF_KERNEL(fltVecCompareI64, int64_t, FLT_VEC_CMP_INT)
+FLT_VEC_DEF_KERNEL(fltVecCompareU8, uint8_t, FLT_VEC_CMP_INT)
+FLT_VEC_DEF_KERNEL(fltVecCompareU16, uint16_t, FLT_VEC_CMP_INT)
+FLT_VEC_DEF_KERNEL(fltVecCompareU32, uint32_t, FLT_VEC_CMP_INT)
+FLT_VEC_DEF_KERNEL(fltVecCompareU64, uint64_t, FLT_VEC_CMP_INT)
+FLT_VEC_DEF_KERNEL(fltVecCompareF32, float, FLT_VEC_CMP_FLT)
+FLT_VEC_DEF_KERNEL(fltVecCompareF64, double, FLT_VEC_CMP_DBL)
+
+typedef void (*_filter_vec_fn_t)(const void *pData, int32_t numOfRows, const void *pVal, const void *pVal2,
+                                 int32_t mode, uint8_t *res);
+
+// indexed by the comparator index of gDataCompare
+static _filter_vec_fn_t fltGetVecCompareFn(int8_t func) {
+  switch (func) {
+    case 0:
+      return fltVecCompareI32;
+    case 1:
+      return fltVecCompareI8;
+    case 2:
+      return fltVecCompareI16;
+    case 3:
+      return fltVecCompareI64;
+    case 4:
+      return fltVecCompareF32;
+    case 5:
+      return fltVecCompareF64;
+    case 11:
+      return fltVecCompareU8;
+    case 12:
+      return fltVecCompareU16;
+    case 13:
+      return fltVecCompareU32;
+    case 14:
+      return fltVecCompareU64;
+    default:
+      return NULL;
+  }
+}
+
+static bool fltVecUnitSupported(SFilterComUnit *cunit) {
+  if (IS_VAR_DATA_TYPE(cunit->dataType)) {
+    return false;
+  }
+
+  if (cunit->optr == OP_TYPE_IS_NULL || cunit->optr == OP_TYPE_IS_NOT_NULL) {
+    return true;
+  }
+
+  if (cunit->valData == NULL || fltGetVecCompareFn(cunit->func) == NULL) {
+    return false;
+  }
+
+  return cunit->rfunc >= 0 || cunit->optr == OP_TYPE_EQUAL || cunit->optr == OP_TYPE_NOT_EQUAL;
+}
+
+static bool filterVecSupported(SFilterInfo *info) {
+  for (uint32_t i = 0; i < info->unitNum; ++i) {
+    if (!fltVecUnitSupported(&info->cunits[i])) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+static void fltVecExecUnit(SFilterComUnit *cunit, int32_t numOfRows, uint8_t *res) {
+  SColumnInfoData *pCol = (SColumnInfoData *)cunit->colData;
+  bool             hasNull = pCol->hasNull && pCol->nullbitmap != NULL;
+  uint8_t          optr = cunit->optr;
+
+  if (optr == OP_TYPE_IS_NULL || optr == OP_TYPE_IS_NOT_NULL) {
+    uint8_t v = (optr == OP_TYPE_IS_NULL) ? 0 : 1;
+    memset(res, v, numOfRows);
+    if (hasNull) {
+      for (int32_t k = 0; k < numOfRows; ++k) {
+        if (colDataIsNull_f(pCol->nullbitmap, k)) {
+          res[k] = !v;
+        }
+      }
+    }
+    return;
+  }
+
+  int32_t mode = cunit->rfunc >= 0 ? cunit->rfunc : (optr == OP_TYPE_EQUAL ? FLT_VEC_MODE_EQ : FLT_VEC_MODE_NE);
+  (*fltGetVecCompareFn(cunit->func))(pCol->pData, numOfRows, cunit->valData, cunit->valData2, mode, res);
+
+  if (hasNull) {
+    const uint8_t *bm = (const uint8_t *)pCol->nullbitmap;
+    for (int32_t k = 0; k < numOfRows; k += 8) {
+      if (bm[k >> 3] == 0) {
+        continue;
+      }
+
+      int32_t end = TMIN(k + 8, numOfRows);
+      for (int32_t j = k; j < end; ++j) {
+        if (colDataIsNull_f(pCol->nullbitmap, j)) {
+          res[j] = 0;
+        }
+      }
+    }
+  }
+}
+
+bool filterExecuteImplVector(void *pinfo, int32_t numOfRows, SColumnInfoData *pRes, SColumnDataAgg *statis,
+                             int16_t numOfCols, int32_t *numOfQualified) {
+  SFilterInfo *info = (SFilterInfo *)pinfo;
+  bool         all = true;
+
+  if (filterExecuteBasedOnStatis(info, numOfRows, pRes, statis, numOfCols, &all) == 0) {
+    return all;
+  }
+
+  for (uint32_t i = 0; i < info->unitNum; ++i) {
+    SColumnInfoData *pCol = (SColumnInfoData *)info->cunits[i].colData;
+    if (pCol == NULL || pCol->pData == NULL) {
+      return filterExecuteImpl(pinfo, numOfRows, pRes, statis, numOfCols, numOfQualified);
+    }
+  }
+
+  uint8_t *p = (uint8_t *)pRes->pData;
+  uint8_t *pBuf = taosMemoryMalloc(numOfRows * 2);
+  if (pBuf == NULL) {
+    return filterExecuteImpl(pinfo, numOfRows, pRes, statis, numOfCols, numOfQualified);
+  }
+
+  uint8_t *pGroupRes = pBuf;
+  uint8_t *pUnitRes = pBuf + numOfRows;
+
+  for (uint32_t g = 0; g < info->groupNum; ++g) {
+    SFilterGroup *group = &info->groups[g];
+    uint8_t      *gRes = (g == 0) ? p : pGroupRes;
+
+    for (uint32_t u = 0; u < group->unitNum; ++u) {
+      SFilterComUnit *cunit = &info->cunits[group->unitIdxs[u]];
+      if (u == 0) {
+        fltVecExecUnit(cunit, numOfRows, gRes);
+      } else {
+        fltVecExecUnit(cunit, numOfRows, pUnitRes);
+        for (int32_t k = 0; k < numOfRows; ++k) {
+          gRes[k] &= pUnitRes[k];
+        }
+      }
+    }
+
+    if (g > 0) {
+      for (int32_t k = 0; k < numOfRows; ++k) {
+        p[k] |= gRes[k];
+      }
+    }
+  }
+
+  taosMemoryFree(pBuf);
+
+  int32_t num = 0;
+  for (int32_t k = 0; k < numOfRows; ++k) {
+    num += p[k];
+  }
+
+  *numOfQualified += num;
+  return num == numOfRows;
+}
+
 int32_t filterSetExecFunc(SFilterInfo *info) {
   if (FILTER_ALL_RES(info)) {
     info->func = filterExecuteImplAll;
@@ -3337,6 +3580,11 @@ int32_t filterSetExecFunc(SFilterInfo *info) {
     return TSDB_CODE_SUCCESS;
   }
 
+  if (filterVecSupported(info)) {
+    info->func = filterExecuteImplVector;
+    return TSDB_CODE_SUCCESS;
+  }
+
   if (info->unitNum > 1) {
     info->func = filterExecuteImpl;
     return TSDB_CODE_SUCCESS;
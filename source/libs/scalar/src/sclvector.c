@@ -998,6 +998,242 @@ enum {
   VECTOR_UN_CONVERT = 0x2,
 };
 
+/*
+ * Type-specialized math kernels for fixed-width numeric columns. Each kernel is a plain loop over typed arrays that
+ * the compiler can vectorize: the value of every row is computed, and the null bitmaps of the inputs are merged
+ * into the output afterwards, so there is neither a per-row branch nor an indirect call.
+ * The order of the list must match vectorMathTypeIndex(), TIMESTAMP shares the BIGINT kernels.
+ */
+#define VECTOR_MATH_TYPE_NUM 11
+
+#define FOREACH_VECTOR_MATH_LTYPE(_, ...) \
+  _(__VA_ARGS__, TINYINT, int8_t)         \
+  _(__VA_ARGS__, UTINYINT, uint8_t)       \
+  _(__VA_ARGS__, SMALLINT, int16_t)       \
+  _(__VA_ARGS__, USMALLINT, uint16_t)     \
+  _(__VA_ARGS__, INT, int32_t)            \
+  _(__VA_ARGS__, UINT, uint32_t)          \
+  _(__VA_ARGS__, BIGINT, int64_t)         \
+  _(__VA_ARGS__, UBIGINT, uint64_t)       \
+  _(__VA_ARGS__, FLOAT, float)            \
+  _(__VA_ARGS__, DOUBLE, double)          \
+  _(__VA_ARGS__, BOOL, bool)
+
+#define FOREACH_VECTOR_MATH_RTYPE(_, ...) \
+  _(__VA_ARGS__, TINYINT, int8_t)         \
+  _(__VA_ARGS__, UTINYINT, uint8_t)       \
+  _(__VA_ARGS__, SMALLINT, int16_t)       \
+  _(__VA_ARGS__, USMALLINT, uint16_t)     \
+  _(__VA_ARGS__, INT, int32_t)            \
+  _(__VA_ARGS__, UINT, uint32_t)          \
+  _(__VA_ARGS__, BIGINT, int64_t)         \
+  _(__VA_ARGS__, UBIGINT, uint64_t)       \
+  _(__VA_ARGS__, FLOAT, float)            \
+  _(__VA_ARGS__, DOUBLE, double)          \
+  _(__VA_ARGS__, BOOL, bool)
+
+static FORCE_INLINE int32_t vectorMathTypeIndex(int32_t type) {
+  switch (type) {
+    case TSDB_DATA_TYPE_TINYINT:
+      return 0;
+    case TSDB_DATA_TYPE_UTINYINT:
+      return 1;
+    case TSDB_DATA_TYPE_SMALLINT:
+      return 2;
+    case TSDB_DATA_TYPE_USMALLINT:
+      return 3;
+    case TSDB_DATA_TYPE_INT:
+      return 4;
+    case TSDB_DATA_TYPE_UINT:
+      return 5;
+    case TSDB_DATA_TYPE_BIGINT:
+    case TSDB_DATA_TYPE_TIMESTAMP:
+      return 6;
+    case TSDB_DATA_TYPE_UBIGINT:
+      return 7;
+    case TSDB_DATA_TYPE_FLOAT:
+      return 8;
+    case TSDB_DATA_TYPE_DOUBLE:
+      return 9;
+    case TSDB_DATA_TYPE_BOOL:
+      return 10;
+    default:
+      return -1;
+  }
+}
+
+typedef void (*_math_vv_fn_t)(const void *pLeft, const void *pRight, double *output, int32_t numOfRows);
+typedef void (*_math_vc_fn_t)(const void *pVec, double c, double *output, int32_t numOfRows);
+typedef void (*_math_unary_fn_t)(const void *pVec, double *output, int32_t numOfRows);
+
+typedef struct SVectorMathKernel {
+  _math_vv_fn_t vv[VECTOR_MATH_TYPE_NUM][VECTOR_MATH_TYPE_NUM];  // column op column
+  _math_vc_fn_t vc[VECTOR_MATH_TYPE_NUM];                        // column op constant
+  _math_vc_fn_t cv[VECTOR_MATH_TYPE_NUM];                        // constant op column
+  bool          nullIfZero;                                      // null when the right operand is 0
+} SVectorMathKernel;
+
+// the expressions are evaluated on lx/rx as doubles, exactly as the generic path does
+#define VECTOR_MATH_DEF_VV(OP, EXPR, LN, LT, RN, RT)                                                                   \
+  static void vectorMath##OP##_##LN##_##RN(const void *pLeft, const void *pRight, double *output, int32_t numOfRows) { \
+    const LT *pl = (const LT *)pLeft;                                                                                  \
+    const RT *pr = (const RT *)pRight;                                                                                 \
+    for (int32_t k = 0; k < numOfRows; ++k) {                                                                          \
+      double lx = (double)pl[k];                                                                                       \
+      double rx = (double)pr[k];                                                                                       \
+      output[k] = EXPR;                                                                                                \
+    }                                                                                                                  \
+  }
+#define VECTOR_MATH_DEF_VV_ROW(OP, EXPR, LN, LT) FOREACH_VECTOR_MATH_RTYPE(VECTOR_MATH_DEF_VV, OP, EXPR, LN, LT)
+
+#define VECTOR_MATH_DEF_VC(OP, EXPR, CV_EXPR, N, T)                                                   \
+  static void vectorMath##OP##VC_##N(const void *pVec, double c, double *output, int32_t numOfRows) { \
+    const T *p = (const T *)pVec;                                                                     \
+    for (int32_t k = 0; k < numOfRows; ++k) {                                                         \
+      double lx = (double)p[k];                                                                       \
+      double rx = c;                                                                                  \
+      output[k] = EXPR;                                                                               \
+    }                                                                                                 \
+  }                                                                                                   \
+  static void vectorMath##OP##CV_##N(const void *pVec, double c, double *output, int32_t numOfRows) { \
+    const T *p = (const T *)pVec;                                                                     \
+    for (int32_t k = 0; k < numOfRows; ++k) {                                                         \
+      double lx = c;                                                                                  \
+      double rx = (double)p[k];                                                                       \
+      output[k] = CV_EXPR;                                                                            \
+    }                                                                                                 \
+  }
+
+#define VECTOR_MATH_DEF_OP(OP, EXPR, CV_EXPR)                      \
+  FOREACH_VECTOR_MATH_LTYPE(VECTOR_MATH_DEF_VV_ROW, OP, EXPR)      \
+  FOREACH_VECTOR_MATH_LTYPE(VECTOR_MATH_DEF_VC, OP, EXPR, CV_EXPR)
+
+#define VECTOR_MATH_VV_ENTRY(OP, LN, LT, RN, RT) vectorMath##OP##_##LN##_##RN,
+#define VECTOR_MATH_VV_ROW(OP, LN, LT)           {FOREACH_VECTOR_MATH_RTYPE(VECTOR_MATH_VV_ENTRY, OP, LN, LT)},
+#define VECTOR_MATH_VC_ENTRY(OP, N, T)           vectorMath##OP##VC_##N,
+#define VECTOR_MATH_CV_ENTRY(OP, N, T)           vectorMath##OP##CV_##N,
+
+#define VECTOR_MATH_KERNEL(OP, NULL_IF_ZERO)                       \
+  static const SVectorMathKernel vectorMath##OP##Kernel = {        \
+      .vv = {FOREACH_VECTOR_MATH_LTYPE(VECTOR_MATH_VV_ROW, OP)},   \
+      .vc = {FOREACH_VECTOR_MATH_LTYPE(VECTOR_MATH_VC_ENTRY, OP)}, \
+      .cv = {FOREACH_VECTOR_MATH_LTYPE(VECTOR_MATH_CV_ENTRY, OP)}, \
+      .nullIfZero = NULL_IF_ZERO,                                  \
+  }
+
+// the constant-on-the-left forms mirror the operand order of the helpers, down to the sign of a zero result
+VECTOR_MATH_DEF_OP(Add, lx + rx, rx + lx)
+VECTOR_MATH_DEF_OP(Sub, lx - rx, (rx - lx) * -1)
+VECTOR_MATH_DEF_OP(Mul, lx * rx, rx * lx)
+VECTOR_MATH_DEF_OP(Div, lx / rx, lx / rx)
+
+VECTOR_MATH_KERNEL(Add, false);
+VECTOR_MATH_KERNEL(Sub, false);
+VECTOR_MATH_KERNEL(Mul, false);
+VECTOR_MATH_KERNEL(Div, true);
+
+#define VECTOR_MATH_DEF_UNARY(D, N, T)                                                                       \
+  static void vectorMathMinus_##N(const void *pVec, double *output, int32_t numOfRows) {                   \
+    const T *p = (const T *)pVec;                                                                          \
+    for (int32_t k = 0; k < numOfRows; ++k) {                                                              \
+      double x = (double)p[k];                                                                             \
+      output[k] = (x == 0) ? 0 : -x;                                                                       \
+    }                                                                                                      \
+  }                                                                                                        \
+  static void vectorMathZeroToNull_##N(SColumnInfoData *pOutputCol, const void *pVec, int32_t numOfRows) { \
+    const T *p = (const T *)pVec;                                                                          \
+    for (int32_t k = 0; k < numOfRows; ++k) {                                                              \
+      if ((double)p[k] == 0) {                                                                             \
+        colDataAppendNULL(pOutputCol, k);                                                                  \
+      }                                                                                                    \
+    }                                                                                                      \
+  }
+
+FOREACH_VECTOR_MATH_LTYPE(VECTOR_MATH_DEF_UNARY, _)
+
+#define VECTOR_MATH_UNARY_ENTRY(PREFIX, N, T) PREFIX##N,
+
+static const _math_unary_fn_t vectorMathMinusKernel[VECTOR_MATH_TYPE_NUM] = {
+    FOREACH_VECTOR_MATH_LTYPE(VECTOR_MATH_UNARY_ENTRY, vectorMathMinus_)};
+
+static void (*const vectorMathZeroToNull[VECTOR_MATH_TYPE_NUM])(SColumnInfoData *, const void *, int32_t) = {
+    FOREACH_VECTOR_MATH_LTYPE(VECTOR_MATH_UNARY_ENTRY, vectorMathZeroToNull_)};
+
+// output null bitmap |= null bitmap of pCol, for the first numOfRows rows
+static void vectorMathMergeNull(SColumnInfoData *pOutputCol, const SColumnInfoData *pCol, int32_t numOfRows) {
+  if (!pCol->hasNull || pCol->nullbitmap == NULL || numOfRows <= 0) {
+    return;
+  }
+
+  const uint8_t *src = (const uint8_t *)pCol->nullbitmap;
+  uint8_t       *dst = (uint8_t *)pOutputCol->nullbitmap;
+  int32_t        len = BitmapLen(numOfRows);
+  uint8_t        tail = (numOfRows & 0x7) ? (uint8_t)(0xFF << (8 - (numOfRows & 0x7))) : 0xFF;
+  uint8_t        any = 0;
+
+  for (int32_t k = 0; k < len - 1; ++k) {
+    dst[k] |= src[k];
+    any |= src[k];
+  }
+
+  dst[len - 1] |= (src[len - 1] & tail);
+  any |= (src[len - 1] & tail);
+
+  if (any) {
+    pOutputCol->hasNull = true;
+  }
+}
+
+// Returns false if the inputs are not covered by the kernels, the caller then takes the generic path.
+static bool vectorMathBinaryKernel(const SVectorMathKernel *pKernel, SScalarParam *pLeft, SScalarParam *pRight,
+                                   SScalarParam *pOut, int32_t _ord) {
+  SColumnInfoData *pLeftCol = pLeft->columnData;
+  SColumnInfoData *pRightCol = pRight->columnData;
+  SColumnInfoData *pOutputCol = pOut->columnData;
+
+  int32_t lidx = vectorMathTypeIndex(pLeftCol->info.type);
+  int32_t ridx = vectorMathTypeIndex(pRightCol->info.type);
+  if (_ord != TSDB_ORDER_ASC || lidx < 0 || ridx < 0 || pOutputCol->info.type != TSDB_DATA_TYPE_DOUBLE) {
+    return false;
+  }
+
+  double *output = (double *)pOutputCol->pData;
+  if (pLeft->numOfRows == pRight->numOfRows) {
+    int32_t numOfRows = pLeft->numOfRows;
+    pKernel->vv[lidx][ridx](pLeftCol->pData, pRightCol->pData, output, numOfRows);
+    vectorMathMergeNull(pOutputCol, pLeftCol, numOfRows);
+    vectorMathMergeNull(pOutputCol, pRightCol, numOfRows);
+    if (pKernel->nullIfZero) {
+      vectorMathZeroToNull[ridx](pOutputCol, pRightCol->pData, numOfRows);
+    }
+  } else if (pLeft->numOfRows == 1) {
+    int32_t numOfRows = pRight->numOfRows;
+    if (colDataIsNull_s(pLeftCol, 0)) {
+      colDataAppendNNULL(pOutputCol, 0, numOfRows);
+      return true;
+    }
+
+    double lx = getVectorDoubleValueFn(pLeftCol->info.type)(pLeftCol->pData, 0);
+    pKernel->cv[ridx](pRightCol->pData, lx, output, numOfRows);
+    vectorMathMergeNull(pOutputCol, pRightCol, numOfRows);
+    if (pKernel->nullIfZero) {
+      vectorMathZeroToNull[ridx](pOutputCol, pRightCol->pData, numOfRows);
+    }
+  } else if (pRight->numOfRows == 1) {
+    int32_t numOfRows = pLeft->numOfRows;
+    double  rx = getVectorDoubleValueFn(pRightCol->info.type)(pRightCol->pData, 0);
+    if (colDataIsNull_s(pRightCol, 0) || (pKernel->nullIfZero && rx == 0)) {
+      colDataAppendNNULL(pOutputCol, 0, numOfRows);
+      return true;
+    }
+
+    pKernel->vc[lidx](pLeftCol->pData, rx, output, numOfRows);
+    vectorMathMergeNull(pOutputCol, pLeftCol, numOfRows);
+  }
+
+  return true;
+}
+
 // TODO not correct for descending order scan
 static void vectorMathAddHelper(SColumnInfoData *pLeftCol, SColumnInfoData *pRightCol, SColumnInfoData *pOutputCol,
                                 int32_t numOfRows, int32_t step, int32_t i) {
@@ -1109,7 +1345,7 @@ void vectorMathAdd(SScalarParam *pLeft, SScalarParam *pRight, SScalarParam *pOut
         *output = getVectorBigintValueFnLeft(pLeftCol->pData, i) + getVectorBigintValueFnRight(pRightCol->pData, i);
       }
     }
-  } else {
+  } else if (!vectorMathBinaryKernel(&vectorMathAddKernel, pLeft, pRight, pOut, _ord)) {
     double              *output = (double *)pOutputCol->pData;
     _getDoubleValue_fn_t getVectorDoubleValueFnLeft = getVectorDoubleValueFn(pLeftCol->info.type);
     _getDoubleValue_fn_t getVectorDoubleValueFnRight = getVectorDoubleValueFn(pRightCol->info.type);
@@ -1210,7 +1446,7 @@ void vectorMathSub(SScalarParam *pLeft, SScalarParam *pRight, SScalarParam *pOut
         *output = getVectorBigintValueFnLeft(pLeftCol->pData, i) - getVectorBigintValueFnRight(pRightCol->pData, i);
       }
     }
-  } else {
+  } else if (!vectorMathBinaryKernel(&vectorMathSubKernel, pLeft, pRight, pOut, _ord)) {
     double              *output = (double *)pOutputCol->pData;
     _getDoubleValue_fn_t getVectorDoubleValueFnLeft = getVectorDoubleValueFn(pLeftCol->info.type);
     _getDoubleValue_fn_t getVectorDoubleValueFnRight = getVectorDoubleValueFn(pRightCol->info.type);
@@ -1259,6 +1495,10 @@ void vectorMathMultiply(SScalarParam *pLeft, SScalarParam *pRight, SScalarParam
   SColumnInfoData *pOutputCol = pOut->columnData;
   pOut->numOfRows = TMAX(pLeft->numOfRows, pRight->numOfRows);
 
+  if (vectorMathBinaryKernel(&vectorMathMulKernel, pLeft, pRight, pOut, _ord)) {
+    return;
+  }
+
   int32_t i = ((_ord) == TSDB_ORDER_ASC) ? 0 : TMAX(pLeft->numOfRows, pRight->numOfRows) - 1;
   int32_t step = ((_ord) == TSDB_ORDER_ASC) ? 1 : -1;
 
@@ -1292,6 +1532,10 @@ void vectorMathDivide(SScalarParam *pLeft, SScalarParam *pRight, SScalarParam *p
   SColumnInfoData *pOutputCol = pOut->columnData;
   pOut->numOfRows = TMAX(pLeft->numOfRows, pRight->numOfRows);
 
+  if (vectorMathBinaryKernel(&vectorMathDivKernel, pLeft, pRight, pOut, _ord)) {
+    return;
+  }
+
   int32_t i = ((_ord) == TSDB_ORDER_ASC) ? 0 : TMAX(pLeft->numOfRows, pRight->numOfRows) - 1;
   int32_t step = ((_ord) == TSDB_ORDER_ASC) ? 1 : -1;
 
@@ -1425,6 +1669,13 @@ void vectorMathMinus(SScalarParam *pLeft, SScalarParam *pRight, SScalarParam *pO
 
   pOut->numOfRows = pLeft->numOfRows;
 
+  int32_t idx = vectorMathTypeIndex(pLeft->columnData->info.type);
+  if (_ord == TSDB_ORDER_ASC && idx >= 0 && pOutputCol->info.type == TSDB_DATA_TYPE_DOUBLE) {
+    vectorMathMinusKernel[idx](pLeft->columnData->pData, (double *)pOutputCol->pData, pLeft->numOfRows);
+    vectorMathMergeNull(pOutputCol, pLeft->columnData, pLeft->numOfRows);
+    return;
+  }
+
   int32_t i = ((_ord) == TSDB_ORDER_ASC) ? 0 : (pLeft->numOfRows - 1);
   int32_t step = ((_ord) == TSDB_ORDER_ASC) ? 1 : -1;
 
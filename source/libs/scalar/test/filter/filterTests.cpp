@@ -33,6 +33,7 @@
 #include "os.h"
 
 #include "filter.h"
+#include "filterInt.h"
 #include "nodes.h"
 #include "scalar.h"
 #include "stub.h"
@@ -43,6 +44,13 @@
 #include "tlog.h"
 #include "tvariant.h"
 
+extern "C" {
+bool filterExecuteImpl(void *pinfo, int32_t numOfRows, SColumnInfoData *pRes, SColumnDataAgg *statis,
+                       int16_t numOfCols, int32_t *numOfQualified);
+bool filterExecuteImplVector(void *pinfo, int32_t numOfRows, SColumnInfoData *pRes, SColumnDataAgg *statis,
+                             int16_t numOfCols, int32_t *numOfQualified);
+}
+
 namespace {
 
 int64_t flttLeftV = 21, flttRightV = 10;
@@ -1338,6 +1346,184 @@ TEST(scalarModelogicTest, diff_columns_or_and_or) {
   blockDataDestroy(src);
 }
 
+namespace {
+
+// one column of the given type, a NULL on every 7th row and a NaN on every 13th row of float/double
+SSDataBlock *flttMakeVecBlock(int32_t type, int32_t rowNum) {
+  SSDataBlock    *pBlock = createDataBlock();
+  SColumnInfoData idata = createColumnInfoData(type, tDataTypes[type].bytes, 1);
+  blockDataAppendColInfo(pBlock, &idata);
+  blockDataEnsureCapacity(pBlock, rowNum);
+
+  SColumnInfoData *pCol = (SColumnInfoData *)taosArrayGet(pBlock->pDataBlock, 0);
+  for (int32_t i = 0; i < rowNum; ++i) {
+    if (i % 7 == 3) {
+      colDataAppendNULL(pCol, i);
+      continue;
+    }
+
+    char    buf[8] = {0};
+    int64_t iv = IS_UNSIGNED_NUMERIC_TYPE(type) ? (i % 41) : (i % 41) - 20;
+    double  dv = (i % 13 == 5) ? NAN : iv / 2.0;
+    if (IS_FLOAT_TYPE(type)) {
+      SET_TYPED_DATA(buf, type, dv);
+    } else {
+      SET_TYPED_DATA(buf, type, iv);
+    }
+    colDataAppend(pCol, i, buf, false);
+  }
+  pBlock->info.rows = rowNum;
+
+  return pBlock;
+}
+
+SNode *flttMakeVecColumn(int32_t type) {
+  SColumnNode *pCol = (SColumnNode *)nodesMakeNode(QUERY_NODE_COLUMN);
+  pCol->node.resType.type = type;
+  pCol->node.resType.bytes = tDataTypes[type].bytes;
+  pCol->dataBlockId = 0;
+  pCol->slotId = 0;
+  pCol->colId = 1;
+  return (SNode *)pCol;
+}
+
+SNode *flttMakeVecCompare(EOperatorType opType, int32_t type, int64_t v) {
+  SNode *pVal = NULL, *pOp = NULL;
+  char   buf[8] = {0};
+  if (IS_FLOAT_TYPE(type)) {
+    SET_TYPED_DATA(buf, type, v / 2.0);
+  } else {
+    SET_TYPED_DATA(buf, type, v);
+  }
+  flttMakeValueNode(&pVal, type, buf);
+  flttMakeOpNode(&pOp, opType, TSDB_DATA_TYPE_BOOL, flttMakeVecColumn(type), pVal);
+  return pOp;
+}
+
+SNode *flttMakeVecIsNull(EOperatorType opType, int32_t type) {
+  SNode *pOp = NULL;
+  flttMakeOpNode(&pOp, opType, TSDB_DATA_TYPE_BOOL, flttMakeVecColumn(type), NULL);
+  return pOp;
+}
+
+SNode *flttMakeVecLogic(ELogicConditionType condType, SNode *pLeft, SNode *pRight) {
+  SNode *pList[2] = {pLeft, pRight};
+  SNode *pLogic = NULL;
+  flttMakeLogicNode(&pLogic, condType, pList, 2);
+  return pLogic;
+}
+
+// the filter runs column-wise and returns the same result as the unit-by-unit row path
+void flttCheckVecAgainstRow(SNode *pNode, SSDataBlock *pBlock, int32_t type) {
+  SFilterInfo *filter = NULL;
+  ASSERT_EQ(filterInitFromNode(pNode, &filter, 0), 0);
+
+  SFilterColumnParam param = {(int32_t)taosArrayGetSize(pBlock->pDataBlock), pBlock->pDataBlock};
+  ASSERT_EQ(filterSetDataFromSlotId(filter, &param), 0);
+  ASSERT_TRUE(filter->func == filterExecuteImplVector) << "type:" << type;
+
+  int32_t         rowNum = pBlock->info.rows;
+  SColumnInfoData vecRes = createColumnInfoData(TSDB_DATA_TYPE_BOOL, sizeof(bool), 0);
+  SColumnInfoData rowRes = createColumnInfoData(TSDB_DATA_TYPE_BOOL, sizeof(bool), 0);
+  colInfoDataEnsureCapacity(&vecRes, rowNum, true);
+  colInfoDataEnsureCapacity(&rowRes, rowNum, true);
+
+  int32_t vecNum = 0, rowNumQualified = 0;
+  bool    vecAll = filterExecuteImplVector(filter, rowNum, &vecRes, NULL, 1, &vecNum);
+  bool    rowAll = filterExecuteImpl(filter, rowNum, &rowRes, NULL, 1, &rowNumQualified);
+
+  EXPECT_EQ(vecAll, rowAll) << "type:" << type;
+  EXPECT_EQ(vecNum, rowNumQualified) << "type:" << type;
+  for (int32_t i = 0; i < rowNum; ++i) {
+    ASSERT_EQ(((int8_t *)vecRes.pData)[i], ((int8_t *)rowRes.pData)[i]) << "type:" << type << " row:" << i;
+  }
+
+  colDataDestroy(&vecRes);
+  colDataDestroy(&rowRes);
+  filterFreeInfo(filter);
+}
+
+const int32_t flttVecTypes[] = {TSDB_DATA_TYPE_TINYINT,  TSDB_DATA_TYPE_SMALLINT, TSDB_DATA_TYPE_INT,
+                                TSDB_DATA_TYPE_BIGINT,   TSDB_DATA_TYPE_UTINYINT, TSDB_DATA_TYPE_USMALLINT,
+                                TSDB_DATA_TYPE_UINT,     TSDB_DATA_TYPE_UBIGINT,  TSDB_DATA_TYPE_FLOAT,
+                                TSDB_DATA_TYPE_DOUBLE,   TSDB_DATA_TYPE_TIMESTAMP};
+
+// not a multiple of 8, so that the last byte of the null bitmap is partly used
+const int32_t flttVecRows = 1003;
+
+}  // namespace
+
+TEST(vectorTest, compare_value) {
+  // NOT_EQUAL always runs in scalar mode
+  EOperatorType ops[] = {OP_TYPE_GREATER_THAN, OP_TYPE_GREATER_EQUAL, OP_TYPE_LOWER_THAN, OP_TYPE_LOWER_EQUAL,
+                         OP_TYPE_EQUAL};
+  for (int32_t type : flttVecTypes) {
+    SSDataBlock *pBlock = flttMakeVecBlock(type, flttVecRows);
+    for (EOperatorType op : ops) {
+      SNode *pNode = flttMakeVecCompare(op, type, 6);
+      flttCheckVecAgainstRow(pNode, pBlock, type);
+      nodesDestroyNode(pNode);
+    }
+    blockDataDestroy(pBlock);
+  }
+}
+
+TEST(vectorTest, range) {
+  EOperatorType lowOps[] = {OP_TYPE_GREATER_THAN, OP_TYPE_GREATER_EQUAL};
+  EOperatorType highOps[] = {OP_TYPE_LOWER_THAN, OP_TYPE_LOWER_EQUAL};
+  for (int32_t type : flttVecTypes) {
+    SSDataBlock *pBlock = flttMakeVecBlock(type, flttVecRows);
+    for (EOperatorType low : lowOps) {
+      for (EOperatorType high : highOps) {
+        SNode *pNode = flttMakeVecLogic(LOGIC_COND_TYPE_AND, flttMakeVecCompare(low, type, 4),
+                                        flttMakeVecCompare(high, type, 12));
+        flttCheckVecAgainstRow(pNode, pBlock, type);
+        nodesDestroyNode(pNode);
+      }
+    }
+    blockDataDestroy(pBlock);
+  }
+}
+
+TEST(vectorTest, is_null) {
+  for (int32_t type : flttVecTypes) {
+    SSDataBlock *pBlock = flttMakeVecBlock(type, flttVecRows);
+
+    SNode *pNode = flttMakeVecIsNull(OP_TYPE_IS_NULL, type);
+    flttCheckVecAgainstRow(pNode, pBlock, type);
+    nodesDestroyNode(pNode);
+
+    pNode = flttMakeVecIsNull(OP_TYPE_IS_NOT_NULL, type);
+    flttCheckVecAgainstRow(pNode, pBlock, type);
+    nodesDestroyNode(pNode);
+
+    blockDataDestroy(pBlock);
+  }
+}
+
+TEST(vectorTest, groups) {
+  for (int32_t type : flttVecTypes) {
+    SSDataBlock *pBlock = flttMakeVecBlock(type, flttVecRows);
+
+    // two groups of one unit
+    SNode *pNode = flttMakeVecLogic(LOGIC_COND_TYPE_OR, flttMakeVecCompare(OP_TYPE_LOWER_THAN, type, 2),
+                                    flttMakeVecCompare(OP_TYPE_GREATER_EQUAL, type, 16));
+    flttCheckVecAgainstRow(pNode, pBlock, type);
+    nodesDestroyNode(pNode);
+
+    // a null test, a range and an equal test each in a group
+    SNode *pOr = flttMakeVecLogic(LOGIC_COND_TYPE_OR,
+                                  flttMakeVecLogic(LOGIC_COND_TYPE_AND, flttMakeVecCompare(OP_TYPE_GREATER_EQUAL, type, 0),
+                                                   flttMakeVecCompare(OP_TYPE_LOWER_EQUAL, type, 10)),
+                                  flttMakeVecCompare(OP_TYPE_EQUAL, type, 36));
+    pNode = flttMakeVecLogic(LOGIC_COND_TYPE_OR, flttMakeVecIsNull(OP_TYPE_IS_NULL, type), pOr);
+    flttCheckVecAgainstRow(pNode, pBlock, type);
+    nodesDestroyNode(pNode);
+
+    blockDataDestroy(pBlock);
+  }
+}
+
 int main(int argc, char **argv) {
   taosSeedRand(taosGetTimestampSec());
   testing::InitGoogleTest(&argc, argv);
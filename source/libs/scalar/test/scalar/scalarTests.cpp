@@ -1542,6 +1542,84 @@ TEST(columnTest, bigint_column_multi_binary_column) {
   nodesDestroyNode(opNode);
 }
 
+TEST(columnTest, int_column_sub_bigint_column_with_null) {
+  SNode       *pLeft = NULL, *pRight = NULL, *opNode = NULL;
+  int32_t      leftv[10] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+  int64_t      rightv[10] = {10, 0, -3, 4, 5, 100, 7, 8, 9, -10};
+  double       eRes[10] = {-9, 2, 6, 0, 0, -94, 0, 0, 0, 20};
+  bool         eNull[10] = {false, false, true, false, false, false, true, false, false, false};
+  SSDataBlock *src = NULL;
+  int32_t      rowNum = sizeof(leftv) / sizeof(leftv[0]);
+  scltMakeColumnNode(&pLeft, &src, TSDB_DATA_TYPE_INT, sizeof(int32_t), rowNum, leftv);
+  SColumnInfoData *pcolumn = (SColumnInfoData *)taosArrayGetLast(src->pDataBlock);
+  colDataAppend(pcolumn, 2, NULL, true);
+  scltMakeColumnNode(&pRight, &src, TSDB_DATA_TYPE_BIGINT, sizeof(int64_t), rowNum, rightv);
+  pcolumn = (SColumnInfoData *)taosArrayGetLast(src->pDataBlock);
+  colDataAppend(pcolumn, 6, NULL, true);
+  scltMakeOpNode(&opNode, OP_TYPE_SUB, TSDB_DATA_TYPE_DOUBLE, pLeft, pRight);
+
+  SArray *blockList = taosArrayInit(1, POINTER_BYTES);
+  taosArrayPush(blockList, &src);
+
+  SColumnInfo colInfo = createColumnInfo(1, TSDB_DATA_TYPE_DOUBLE, sizeof(double));
+  int16_t     dataBlockId = 0, slotId = 0;
+  scltAppendReservedSlot(blockList, &dataBlockId, &slotId, false, rowNum, &colInfo);
+  scltMakeTargetNode(&opNode, dataBlockId, slotId, opNode);
+
+  int32_t code = scalarCalculate(opNode, blockList, NULL);
+  ASSERT_EQ(code, 0);
+
+  SSDataBlock *res = *(SSDataBlock **)taosArrayGetLast(blockList);
+  ASSERT_EQ(res->info.rows, rowNum);
+  SColumnInfoData *column = (SColumnInfoData *)taosArrayGetLast(res->pDataBlock);
+  ASSERT_EQ(column->info.type, TSDB_DATA_TYPE_DOUBLE);
+  for (int32_t i = 0; i < rowNum; ++i) {
+    ASSERT_EQ(colDataIsNull_s(column, i), eNull[i]);
+    if (!eNull[i]) {
+      ASSERT_EQ(*((double *)colDataGetData(column, i)), eRes[i]);
+    }
+  }
+  taosArrayDestroyEx(blockList, scltFreeDataBlock);
+  nodesDestroyNode(opNode);
+}
+
+TEST(columnTest, double_value_divide_smallint_column) {
+  SNode       *pLeft = NULL, *pRight = NULL, *opNode = NULL;
+  double       leftv = 12;
+  int16_t      rightv[5] = {1, 0, -4, 3, 0};
+  double       eRes[5] = {12, 0, -3, 4, 0};
+  bool         eNull[5] = {false, true, false, false, true};
+  SSDataBlock *src = NULL;
+  int32_t      rowNum = sizeof(rightv) / sizeof(rightv[0]);
+  scltMakeValueNode(&pLeft, TSDB_DATA_TYPE_DOUBLE, &leftv);
+  scltMakeColumnNode(&pRight, &src, TSDB_DATA_TYPE_SMALLINT, sizeof(int16_t), rowNum, rightv);
+  scltMakeOpNode(&opNode, OP_TYPE_DIV, TSDB_DATA_TYPE_DOUBLE, pLeft, pRight);
+
+  SArray *blockList = taosArrayInit(1, POINTER_BYTES);
+  taosArrayPush(blockList, &src);
+
+  SColumnInfo colInfo = createColumnInfo(1, TSDB_DATA_TYPE_DOUBLE, sizeof(double));
+  int16_t     dataBlockId = 0, slotId = 0;
+  scltAppendReservedSlot(blockList, &dataBlockId, &slotId, false, rowNum, &colInfo);
+  scltMakeTargetNode(&opNode, dataBlockId, slotId, opNode);
+
+  int32_t code = scalarCalculate(opNode, blockList, NULL);
+  ASSERT_EQ(code, 0);
+
+  SSDataBlock *res = *(SSDataBlock **)taosArrayGetLast(blockList);
+  ASSERT_EQ(res->info.rows, rowNum);
+  SColumnInfoData *column = (SColumnInfoData *)taosArrayGetLast(res->pDataBlock);
+  ASSERT_EQ(column->info.type, TSDB_DATA_TYPE_DOUBLE);
+  for (int32_t i = 0; i < rowNum; ++i) {
+    ASSERT_EQ(colDataIsNull_s(column, i), eNull[i]);
+    if (!eNull[i]) {
+      ASSERT_EQ(*((double *)colDataGetData(column, i)), eRes[i]);
+    }
+  }
+  taosArrayDestroyEx(blockList, scltFreeDataBlock);
+  nodesDestroyNode(opNode);
+}
+
 TEST(columnTest, smallint_column_and_binary_column) {
   SNode  *pLeft = NULL, *pRight = NULL, *opNode = NULL;
   int16_t leftv[5] = {1, 2, 3, 4, 5};
@@ -200,7 +200,7 @@ typedef struct SyncSnapshotSend {
   SSyncCfg  lastConfig;
   int64_t   startTime;
   int32_t   seq;
-  int16_t   reserved;
+  int16_t   cmprType;  // SYNC_SNAPSHOT_CMPR_*
   uint32_t  dataLen;
   char      data[];
 } SyncSnapshotSend;
@@ -219,7 +219,7 @@ typedef struct SyncSnapshotRsp {
   int32_t   ack;
   int32_t   code;
   SyncIndex snapBeginIndex;  // when ack = SYNC_SNAPSHOT_SEQ_BEGIN, it's valid
-  int16_t   reserved;
+  int16_t   features;        // SYNC_SNAPSHOT_FEATURE_* of the receiver, 0 for old versions
 } SyncSnapshotRsp;
 
 typedef struct SyncLeaderTransfer {
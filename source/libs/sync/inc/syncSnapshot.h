@@ -30,13 +30,33 @@ extern "C" {
 
 #define SYNC_SNAPSHOT_RETRY_MS 5000
 
+// blocks sent ahead of the ack, the window of a sender is set by tsSnapWindowSize
+#define SYNC_SNAPSHOT_WINDOW_MAX 64
+
+// what a receiver supports, announced in its pre-snapshot rsp
+#define SYNC_SNAPSHOT_FEATURE_PIPELINE 0x1
+#define SYNC_SNAPSHOT_FEATURE_COMPRESS 0x2
+
+// a compressed block is its raw length followed by the lz4 string
+#define SYNC_SNAPSHOT_CMPR_NONE 0
+#define SYNC_SNAPSHOT_CMPR_LZ4  1
+
+typedef struct SSyncSnapBlock {
+  int32_t seq;
+  int16_t cmprType;
+  int32_t dataLen;
+  void   *pData;
+} SSyncSnapBlock;
+
 typedef struct SSyncSnapshotSender {
   bool           start;
-  int32_t        seq;
+  int32_t        seq;  // last seq sent, blocks in (ack, seq] are kept until acked
   int32_t        ack;
   void          *pReader;
-  void          *pCurrentBlock;
-  int32_t        blockLen;
+  bool           readEnd;
+  int16_t        features;
+  int32_t        window;
+  SSyncSnapBlock aBlock[SYNC_SNAPSHOT_WINDOW_MAX];
   SSnapshotParam snapshotParam;
   SSnapshot      snapshot;
   SSyncCfg       lastConfig;
@@ -72,6 +92,9 @@ typedef struct SSyncSnapshotReceiver {
   SSnapshotParam snapshotParam;
   SSnapshot      snapshot;
 
+  // blocks arrived ahead of ack + 1
+  SSyncSnapBlock aBlock[SYNC_SNAPSHOT_WINDOW_MAX];
+
   // init when create
   SSyncNode *pSyncNode;
 } SSyncSnapshotReceiver;
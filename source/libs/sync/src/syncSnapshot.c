@@ -22,6 +22,36 @@
 #include "syncRaftStore.h"
 #include "syncReplication.h"
 #include "syncUtil.h"
+#include "tcompression.h"
+#include "tglobal.h"
+
+static void snapshotClearBlocks(SSyncSnapBlock *aBlock) {
+  for (int32_t i = 0; i < SYNC_SNAPSHOT_WINDOW_MAX; ++i) {
+    taosMemoryFreeClear(aBlock[i].pData);
+    aBlock[i].seq = 0;
+    aBlock[i].dataLen = 0;
+  }
+}
+
+// keep the raw block when it does not get smaller
+static void snapshotCompressBlock(SSyncSnapBlock *pBlock) {
+  int32_t nOut = pBlock->dataLen + 1;
+  char   *pCmpr = taosMemoryMalloc(sizeof(int32_t) + nOut);
+  if (pCmpr == NULL) return;
+
+  memcpy(pCmpr, &pBlock->dataLen, sizeof(int32_t));
+  int32_t len = tsCompressString(pBlock->pData, pBlock->dataLen, 1, pCmpr + sizeof(int32_t), nOut, ONE_STAGE_COMP,
+                                 NULL, 0);
+  if (len <= 0 || sizeof(int32_t) + len >= pBlock->dataLen) {
+    taosMemoryFree(pCmpr);
+    return;
+  }
+
+  taosMemoryFree(pBlock->pData);
+  pBlock->pData = pCmpr;
+  pBlock->dataLen = sizeof(int32_t) + len;
+  pBlock->cmprType = SYNC_SNAPSHOT_CMPR_LZ4;
+}
 
 SSyncSnapshotSender *snapshotSenderCreate(SSyncNode *pSyncNode, int32_t replicaIndex) {
   bool condition = (pSyncNode->pFsm->FpSnapshotStartRead != NULL) && (pSyncNode->pFsm->FpSnapshotStopRead != NULL) &&
@@ -38,8 +68,9 @@ SSyncSnapshotSender *snapshotSenderCreate(SSyncNode *pSyncNode, int32_t replicaI
   pSender->seq = SYNC_SNAPSHOT_SEQ_INVALID;
   pSender->ack = SYNC_SNAPSHOT_SEQ_INVALID;
   pSender->pReader = NULL;
-  pSender->pCurrentBlock = NULL;
-  pSender->blockLen = 0;
+  pSender->readEnd = false;
+  pSender->features = 0;
+  pSender->window = 1;
   pSender->sendingMS = SYNC_SNAPSHOT_RETRY_MS;
   pSender->pSyncNode = pSyncNode;
   pSender->replicaIndex = replicaIndex;
@@ -55,11 +86,8 @@ SSyncSnapshotSender *snapshotSenderCreate(SSyncNode *pSyncNode, int32_t replicaI
 void snapshotSenderDestroy(SSyncSnapshotSender *pSender) {
   if (pSender == NULL) return;
 
-  // free current block
-  if (pSender->pCurrentBlock != NULL) {
-    taosMemoryFree(pSender->pCurrentBlock);
-    pSender->pCurrentBlock = NULL;
-  }
+  // free blocks in flight
+  snapshotClearBlocks(pSender->aBlock);
 
   // close reader
   if (pSender->pReader != NULL) {
@@ -78,8 +106,10 @@ int32_t snapshotSenderStart(SSyncSnapshotSender *pSender) {
   pSender->seq = SYNC_SNAPSHOT_SEQ_BEGIN;
   pSender->ack = SYNC_SNAPSHOT_SEQ_INVALID;
   pSender->pReader = NULL;
-  pSender->pCurrentBlock = NULL;
-  pSender->blockLen = 0;
+  pSender->readEnd = false;
+  pSender->features = 0;
+  pSender->window = 1;
+  snapshotClearBlocks(pSender->aBlock);
   pSender->snapshotParam.start = SYNC_INDEX_INVALID;
   pSender->snapshotParam.end = SYNC_INDEX_INVALID;
   pSender->snapshot.data = NULL;
@@ -140,45 +170,18 @@ void snapshotSenderStop(SSyncSnapshotSender *pSender, bool finish) {
     pSender->pReader = NULL;
   }
 
-  // free current block
-  if (pSender->pCurrentBlock != NULL) {
-    taosMemoryFree(pSender->pCurrentBlock);
-    pSender->pCurrentBlock = NULL;
-    pSender->blockLen = 0;
-  }
+  // free blocks in flight
+  snapshotClearBlocks(pSender->aBlock);
 }
 
-// when sender receive ack, call this function to send msg from seq
-// seq = ack + 1, already updated
-static int32_t snapshotSend(SSyncSnapshotSender *pSender) {
-  // free memory last time (current seq - 1)
-  if (pSender->pCurrentBlock != NULL) {
-    taosMemoryFree(pSender->pCurrentBlock);
-    pSender->pCurrentBlock = NULL;
-    pSender->blockLen = 0;
-  }
-
-  // read data
-  int32_t ret = pSender->pSyncNode->pFsm->FpSnapshotDoRead(pSender->pSyncNode->pFsm, pSender->pReader,
-                                                           &pSender->pCurrentBlock, &pSender->blockLen);
-  if (ret != 0) {
-    sSError(pSender, "snapshot sender read failed since %s", terrstr());
-    return -1;
-  }
-
-  if (pSender->blockLen > 0) {
-    // has read data
-    sSDebug(pSender, "snapshot sender continue to read, blockLen:%d seq:%d", pSender->blockLen, pSender->seq);
-  } else {
-    // read finish, update seq to end
-    pSender->seq = SYNC_SNAPSHOT_SEQ_END;
-    sSInfo(pSender, "snapshot sender read to the end, blockLen:%d seq:%d", pSender->blockLen, pSender->seq);
-  }
+// send one msg of seq, pBlock is NULL for the begin and end msg
+static int32_t snapshotSendBlock(SSyncSnapshotSender *pSender, int32_t seq, SSyncSnapBlock *pBlock, const char *event) {
+  int32_t dataLen = (pBlock != NULL) ? pBlock->dataLen : 0;
 
   // build msg
   SRpcMsg rpcMsg = {0};
-  if (syncBuildSnapshotSend(&rpcMsg, pSender->blockLen, pSender->pSyncNode->vgId) != 0) {
-    sSError(pSender, "snapshot sender build msg failed since %s", pSender->pSyncNode->vgId, terrstr());
+  if (syncBuildSnapshotSend(&rpcMsg, dataLen, pSender->pSyncNode->vgId) != 0) {
+    sSError(pSender, "snapshot sender build msg failed since %s", terrstr());
     return -1;
   }
 
@@ -191,18 +194,16 @@ static int32_t snapshotSend(SSyncSnapshotSender *pSender) {
   pMsg->lastTerm = pSender->snapshot.lastApplyTerm;
   pMsg->lastConfigIndex = pSender->snapshot.lastConfigIndex;
   pMsg->lastConfig = pSender->lastConfig;
-  pMsg->seq = pSender->seq;
+  pMsg->startTime = pSender->startTime;
+  pMsg->seq = seq;
 
-  if (pSender->pCurrentBlock != NULL) {
-    memcpy(pMsg->data, pSender->pCurrentBlock, pSender->blockLen);
+  if (dataLen > 0) {
+    pMsg->cmprType = pBlock->cmprType;
+    memcpy(pMsg->data, pBlock->pData, dataLen);
   }
 
   // event log
-  if (pSender->seq == SYNC_SNAPSHOT_SEQ_END) {
-    syncLogSendSyncSnapshotSend(pSender->pSyncNode, pMsg, "snapshot sender finish");
-  } else {
-    syncLogSendSyncSnapshotSend(pSender->pSyncNode, pMsg, "snapshot sender sending");
-  }
+  syncLogSendSyncSnapshotSend(pSender->pSyncNode, pMsg, event);
 
   // send msg
   if (syncNodeSendMsgById(&pMsg->destId, pSender->pSyncNode, &rpcMsg) != 0) {
@@ -214,54 +215,105 @@ static int32_t snapshotSend(SSyncSnapshotSender *pSender) {
   return 0;
 }
 
-// send snapshot data from cache
-int32_t snapshotReSend(SSyncSnapshotSender *pSender) {
-  // build msg
-  SRpcMsg rpcMsg = {0};
-  if (syncBuildSnapshotSend(&rpcMsg, pSender->blockLen, pSender->pSyncNode->vgId) != 0) {
-    sSError(pSender, "snapshot sender build msg failed since %s", terrstr());
+// read the next block into the window, *ppBlock is NULL at the end of the snapshot
+static int32_t snapshotSenderReadBlock(SSyncSnapshotSender *pSender, SSyncSnapBlock **ppBlock) {
+  void   *pData = NULL;
+  int32_t dataLen = 0;
+
+  *ppBlock = NULL;
+  int32_t ret = pSender->pSyncNode->pFsm->FpSnapshotDoRead(pSender->pSyncNode->pFsm, pSender->pReader, &pData, &dataLen);
+  if (ret != 0) {
+    sSError(pSender, "snapshot sender read failed since %s", terrstr());
     return -1;
   }
 
-  SyncSnapshotSend *pMsg = rpcMsg.pCont;
-  pMsg->srcId = pSender->pSyncNode->myRaftId;
-  pMsg->destId = pSender->pSyncNode->replicasId[pSender->replicaIndex];
-  pMsg->term = pSender->pSyncNode->raftStore.currentTerm;
-  pMsg->beginIndex = pSender->snapshotParam.start;
-  pMsg->lastIndex = pSender->snapshot.lastApplyIndex;
-  pMsg->lastTerm = pSender->snapshot.lastApplyTerm;
-  pMsg->lastConfigIndex = pSender->snapshot.lastConfigIndex;
-  pMsg->lastConfig = pSender->lastConfig;
-  pMsg->seq = pSender->seq;
+  if (dataLen <= 0) {
+    taosMemoryFree(pData);
+    pSender->readEnd = true;
+    sSInfo(pSender, "snapshot sender read to the end, seq:%d ack:%d", pSender->seq, pSender->ack);
+    return 0;
+  }
 
-  if (pSender->pCurrentBlock != NULL && pSender->blockLen > 0) {
-    memcpy(pMsg->data, pSender->pCurrentBlock, pSender->blockLen);
+  SSyncSnapBlock *pBlock = &pSender->aBlock[(pSender->seq + 1) % SYNC_SNAPSHOT_WINDOW_MAX];
+  taosMemoryFreeClear(pBlock->pData);
+  pBlock->seq = pSender->seq + 1;
+  pBlock->cmprType = SYNC_SNAPSHOT_CMPR_NONE;
+  pBlock->pData = pData;
+  pBlock->dataLen = dataLen;
+  if (pSender->features & SYNC_SNAPSHOT_FEATURE_COMPRESS) {
+    snapshotCompressBlock(pBlock);
   }
 
-  // event log
-  syncLogSendSyncSnapshotSend(pSender->pSyncNode, pMsg, "snapshot sender resend");
+  pSender->seq = pBlock->seq;
+  sSDebug(pSender, "snapshot sender continue to read, blockLen:%d sendLen:%d seq:%d", dataLen, pBlock->dataLen,
+          pSender->seq);
 
-  // send msg
-  if (syncNodeSendMsgById(&pMsg->destId, pSender->pSyncNode, &rpcMsg) != 0) {
-    sSError(pSender, "snapshot sender resend msg failed since %s", terrstr());
-    return -1;
+  *ppBlock = pBlock;
+  return 0;
+}
+
+// when sender receive ack, call this function to send blocks after it until the window is full
+// the end msg is only sent once every block is acked, so the receiver applies the snapshot in order
+static int32_t snapshotSend(SSyncSnapshotSender *pSender) {
+  while (!pSender->readEnd && pSender->seq - pSender->ack < pSender->window) {
+    SSyncSnapBlock *pBlock = NULL;
+    if (snapshotSenderReadBlock(pSender, &pBlock) != 0) {
+      return -1;
+    }
+    if (pBlock == NULL) break;
+
+    if (snapshotSendBlock(pSender, pBlock->seq, pBlock, "snapshot sender sending") != 0) {
+      return -1;
+    }
+  }
+
+  if (pSender->readEnd && pSender->ack == pSender->seq) {
+    pSender->seq = SYNC_SNAPSHOT_SEQ_END;
+    return snapshotSendBlock(pSender, SYNC_SNAPSHOT_SEQ_END, NULL, "snapshot sender finish");
+  }
+
+  return 0;
+}
+
+// send the blocks not acked yet, so a transfer goes on from the last ack after the peer comes back
+int32_t snapshotReSend(SSyncSnapshotSender *pSender) {
+  if (pSender->seq <= SYNC_SNAPSHOT_SEQ_BEGIN || pSender->seq == SYNC_SNAPSHOT_SEQ_END) {
+    return snapshotSendBlock(pSender, pSender->seq, NULL, "snapshot sender resend");
+  }
+
+  for (int32_t seq = pSender->ack + 1; seq <= pSender->seq; ++seq) {
+    SSyncSnapBlock *pBlock = &pSender->aBlock[seq % SYNC_SNAPSHOT_WINDOW_MAX];
+    if (pBlock->seq != seq || pBlock->pData == NULL) {
+      sSError(pSender, "snapshot sender resend failed since block of seq:%d is lost", seq);
+      terrno = TSDB_CODE_SYN_INTERNAL_ERROR;
+      return -1;
+    }
+
+    if (snapshotSendBlock(pSender, seq, pBlock, "snapshot sender resend") != 0) {
+      return -1;
+    }
   }
 
-  pSender->lastSendTime = taosGetTimestampMs();
   return 0;
 }
 
 static int32_t snapshotSenderUpdateProgress(SSyncSnapshotSender *pSender, SyncSnapshotRsp *pMsg) {
-  if (pMsg->ack != pSender->seq) {
+  if (pMsg->ack < pSender->ack || pMsg->ack > pSender->seq) {
     sSError(pSender, "snapshot sender update seq failed, ack:%d seq:%d", pMsg->ack, pSender->seq);
     terrno = TSDB_CODE_SYN_INTERNAL_ERROR;
     return -1;
   }
 
+  // acks are cumulative, every block up to it is applied
+  for (int32_t seq = TMAX(pSender->ack + 1, SYNC_SNAPSHOT_SEQ_BEGIN + 1); seq <= pMsg->ack; ++seq) {
+    SSyncSnapBlock *pBlock = &pSender->aBlock[seq % SYNC_SNAPSHOT_WINDOW_MAX];
+    taosMemoryFreeClear(pBlock->pData);
+    pBlock->seq = 0;
+    pBlock->dataLen = 0;
+  }
   pSender->ack = pMsg->ack;
-  pSender->seq++;
 
-  sSDebug(pSender, "snapshot sender update seq:%d", pSender->seq);
+  sSDebug(pSender, "snapshot sender update ack:%d seq:%d", pSender->ack, pSender->seq);
   return 0;
 }
 
@@ -336,6 +388,9 @@ void snapshotReceiverDestroy(SSyncSnapshotReceiver *pReceiver) {
     pReceiver->pWriter = NULL;
   }
 
+  // free blocks kept
+  snapshotClearBlocks(pReceiver->aBlock);
+
   // free receiver
   taosMemoryFree(pReceiver);
 }
@@ -351,6 +406,7 @@ static int32_t snapshotReceiverStartWriter(SSyncSnapshotReceiver *pReceiver, Syn
 
   // update ack
   pReceiver->ack = SYNC_SNAPSHOT_SEQ_BEGIN;
+  snapshotClearBlocks(pReceiver->aBlock);
 
   // update snapshot
   pReceiver->snapshot.lastApplyIndex = pBeginMsg->lastIndex;
@@ -404,9 +460,55 @@ void snapshotReceiverStop(SSyncSnapshotReceiver *pReceiver) {
     sRInfo(pReceiver, "snapshot receiver stop, writer is null");
   }
 
+  snapshotClearBlocks(pReceiver->aBlock);
   pReceiver->start = false;
 }
 
+// write one block into the fsm, decompressing it first if needed
+static int32_t snapshotReceiverWriteBlock(SSyncSnapshotReceiver *pReceiver, int16_t cmprType, void *pData,
+                                          int32_t dataLen) {
+  void   *pRaw = pData;
+  int32_t rawLen = dataLen;
+
+  if (dataLen <= 0) return 0;
+
+  if (cmprType == SYNC_SNAPSHOT_CMPR_LZ4) {
+    if (dataLen <= sizeof(int32_t)) {
+      rawLen = -1;
+    } else {
+      memcpy(&rawLen, pData, sizeof(int32_t));
+    }
+    if (rawLen <= 0) {
+      sRError(pReceiver, "snapshot receiver invalid compressed block, len:%d", dataLen);
+      terrno = TSDB_CODE_SYN_INVALID_SNAPSHOT_MSG;
+      return -1;
+    }
+
+    pRaw = taosMemoryMalloc(rawLen);
+    if (pRaw == NULL) {
+      terrno = TSDB_CODE_OUT_OF_MEMORY;
+      return -1;
+    }
+
+    if (tsDecompressString((char *)pData + sizeof(int32_t), dataLen - sizeof(int32_t), 1, pRaw, rawLen,
+                           ONE_STAGE_COMP, NULL, 0) != rawLen) {
+      sRError(pReceiver, "snapshot receiver failed to decompress block, len:%d raw:%d", dataLen, rawLen);
+      taosMemoryFree(pRaw);
+      terrno = TSDB_CODE_SYN_INVALID_SNAPSHOT_MSG;
+      return -1;
+    }
+  } else if (cmprType != SYNC_SNAPSHOT_CMPR_NONE) {
+    sRError(pReceiver, "snapshot receiver invalid compress type:%d", cmprType);
+    terrno = TSDB_CODE_SYN_INVALID_SNAPSHOT_MSG;
+    return -1;
+  }
+
+  int32_t code = pReceiver->pSyncNode->pFsm->FpSnapshotDoWrite(pReceiver->pSyncNode->pFsm, pReceiver->pWriter, pRaw,
+                                                               rawLen);
+  if (pRaw != pData) taosMemoryFree(pRaw);
+  return code;
+}
+
 // when recv last snapshot block, apply data into snapshot
 static int32_t snapshotReceiverFinish(SSyncSnapshotReceiver *pReceiver, SyncSnapshotSend *pMsg) {
   int32_t code = 0;
@@ -414,8 +516,7 @@ static int32_t snapshotReceiverFinish(SSyncSnapshotReceiver *pReceiver, SyncSnap
     // write data
     sRInfo(pReceiver, "snapshot receiver write finish, blockLen:%d seq:%d", pMsg->dataLen, pMsg->seq);
     if (pMsg->dataLen > 0) {
-      code = pReceiver->pSyncNode->pFsm->FpSnapshotDoWrite(pReceiver->pSyncNode->pFsm, pReceiver->pWriter, pMsg->data,
-                                                           pMsg->dataLen);
+      code = snapshotReceiverWriteBlock(pReceiver, pMsg->cmprType, pMsg->data, pMsg->dataLen);
       if (code != 0) {
         sRError(pReceiver, "failed to finish snapshot receiver write since %s", terrstr());
         return -1;
@@ -465,38 +566,76 @@ static int32_t snapshotReceiverFinish(SSyncSnapshotReceiver *pReceiver, SyncSnap
   return 0;
 }
 
-// apply data block
+// apply data block in seq order, keep the ones arrived ahead
 // update progress
 static int32_t snapshotReceiverGotData(SSyncSnapshotReceiver *pReceiver, SyncSnapshotSend *pMsg) {
-  if (pMsg->seq != pReceiver->ack + 1) {
+  if (pReceiver->pWriter == NULL) {
+    sRError(pReceiver, "snapshot receiver failed to write data since writer is null");
+    terrno = TSDB_CODE_SYN_INTERNAL_ERROR;
+    return -1;
+  }
+
+  // resent by the sender, the ack in reply tells it where to go on
+  if (pMsg->seq <= pReceiver->ack) {
+    sRDebug(pReceiver, "snapshot receiver ignore block already written, ack:%d seq:%d", pReceiver->ack, pMsg->seq);
+    return 0;
+  }
+
+  if (pMsg->seq - pReceiver->ack >= SYNC_SNAPSHOT_WINDOW_MAX) {
     sRError(pReceiver, "snapshot receiver invalid seq, ack:%d seq:%d", pReceiver->ack, pMsg->seq);
     terrno = TSDB_CODE_SYN_INVALID_SNAPSHOT_MSG;
     return -1;
   }
 
-  if (pReceiver->pWriter == NULL) {
-    sRError(pReceiver, "snapshot receiver failed to write data since writer is null");
-    terrno = TSDB_CODE_SYN_INTERNAL_ERROR;
-    return -1;
+  if (pMsg->seq > pReceiver->ack + 1) {
+    SSyncSnapBlock *pBlock = &pReceiver->aBlock[pMsg->seq % SYNC_SNAPSHOT_WINDOW_MAX];
+    if (pBlock->seq != pMsg->seq) {
+      taosMemoryFreeClear(pBlock->pData);
+      if (pMsg->dataLen > 0) {
+        pBlock->pData = taosMemoryMalloc(pMsg->dataLen);
+        if (pBlock->pData == NULL) {
+          terrno = TSDB_CODE_OUT_OF_MEMORY;
+          return -1;
+        }
+        memcpy(pBlock->pData, pMsg->data, pMsg->dataLen);
+      }
+      pBlock->seq = pMsg->seq;
+      pBlock->cmprType = pMsg->cmprType;
+      pBlock->dataLen = pMsg->dataLen;
+    }
+
+    sRDebug(pReceiver, "snapshot receiver keep block ahead, blockLen:%d ack:%d seq:%d", pMsg->dataLen, pReceiver->ack,
+            pMsg->seq);
+    return 0;
   }
 
   sRDebug(pReceiver, "snapshot receiver continue to write, blockLen:%d seq:%d", pMsg->dataLen, pMsg->seq);
 
-  if (pMsg->dataLen > 0) {
-    // apply data block
-    int32_t code = pReceiver->pSyncNode->pFsm->FpSnapshotDoWrite(pReceiver->pSyncNode->pFsm, pReceiver->pWriter,
-                                                                 pMsg->data, pMsg->dataLen);
+  // apply data block
+  if (snapshotReceiverWriteBlock(pReceiver, pMsg->cmprType, pMsg->data, pMsg->dataLen) != 0) {
+    sRError(pReceiver, "snapshot receiver continue write failed since %s", terrstr());
+    return -1;
+  }
+  pReceiver->ack = pMsg->seq;
+
+  // and the ones it was holding back
+  while (1) {
+    SSyncSnapBlock *pBlock = &pReceiver->aBlock[(pReceiver->ack + 1) % SYNC_SNAPSHOT_WINDOW_MAX];
+    if (pBlock->seq != pReceiver->ack + 1) break;
+
+    int32_t code = snapshotReceiverWriteBlock(pReceiver, pBlock->cmprType, pBlock->pData, pBlock->dataLen);
+    taosMemoryFreeClear(pBlock->pData);
+    pBlock->seq = 0;
+    pBlock->dataLen = 0;
     if (code != 0) {
       sRError(pReceiver, "snapshot receiver continue write failed since %s", terrstr());
       return -1;
     }
+    pReceiver->ack++;
   }
 
-  // update progress
-  pReceiver->ack = pMsg->seq;
-
   // event log
-  sRDebug(pReceiver, "snapshot receiver continue to write finish");
+  sRDebug(pReceiver, "snapshot receiver continue to write finish, ack:%d", pReceiver->ack);
   return 0;
 }
 
@@ -599,6 +738,7 @@ _SEND_REPLY:
   pRspMsg->ack = pMsg->seq;  // receiver maybe already closed
   pRspMsg->code = code;
   pRspMsg->snapBeginIndex = syncNodeGetSnapBeginIndex(pSyncNode);
+  pRspMsg->features = SYNC_SNAPSHOT_FEATURE_PIPELINE | SYNC_SNAPSHOT_FEATURE_COMPRESS;
 
   // send msg
   syncLogSendSyncSnapshotRsp(pSyncNode, pRspMsg, "snapshot receiver pre-snapshot");
@@ -866,8 +1006,10 @@ static int32_t syncNodeOnSnapshotPreRsp(SSyncNode *pSyncNode, SSyncSnapshotSende
     return -1;
   }
 
-  // update sender
+  // update sender, a receiver of an old version takes one uncompressed block at a time
   pSender->snapshot = snapshot;
+  pSender->features = pMsg->features;
+  pSender->window = (pMsg->features & SYNC_SNAPSHOT_FEATURE_PIPELINE) ? TMIN(tsSnapWindowSize, SYNC_SNAPSHOT_WINDOW_MAX) : 1;
 
   // start reader
   int32_t code = pSyncNode->pFsm->FpSnapshotStartRead(pSyncNode->pFsm, &pSender->snapshotParam, &pSender->pReader);
@@ -914,8 +1056,9 @@ static int32_t syncNodeOnSnapshotPreRsp(SSyncNode *pSyncNode, SSyncSnapshotSende
 // sender on message
 //
 // condition 1 sender receives SYNC_SNAPSHOT_SEQ_END, close sender
-// condition 2 sender receives ack, set seq = ack + 1, send msg from seq
-// condition 3 sender receives error msg, just print error log
+// condition 2 sender receives ack, release blocks up to ack, send more until the window is full
+// condition 3 sender receives a stale ack of a resent block, ignore it
+// condition 4 sender receives error msg, just print error log
 //
 int32_t syncNodeOnSnapshotRsp(SSyncNode *pSyncNode, const SRpcMsg *pRpcMsg) {
   SyncSnapshotRsp *pMsg = pRpcMsg->pCont;
@@ -979,18 +1122,6 @@ int32_t syncNodeOnSnapshotRsp(SSyncNode *pSyncNode, const SRpcMsg *pRpcMsg) {
     goto _ERROR;
   }
 
-  if (pMsg->ack == SYNC_SNAPSHOT_SEQ_BEGIN) {
-    syncLogRecvSyncSnapshotRsp(pSyncNode, pMsg, "process seq begin");
-    if (snapshotSenderUpdateProgress(pSender, pMsg) != 0) {
-      return -1;
-    }
-
-    if (snapshotSend(pSender) != 0) {
-      return -1;
-    }
-    return 0;
-  }
-
   // receive ack is finish, close sender
   if (pMsg->ack == SYNC_SNAPSHOT_SEQ_END) {
     syncLogRecvSyncSnapshotRsp(pSyncNode, pMsg, "process seq end");
@@ -1000,9 +1131,16 @@ int32_t syncNodeOnSnapshotRsp(SSyncNode *pSyncNode, const SRpcMsg *pRpcMsg) {
     return 0;
   }
 
-  // send next msg
-  if (pMsg->ack == pSender->seq) {
-    syncLogRecvSyncSnapshotRsp(pSyncNode, pMsg, "process seq data");
+  // the reply of a resent block
+  if (pMsg->ack < pSender->ack) {
+    syncLogRecvSyncSnapshotRsp(pSyncNode, pMsg, "ignore stale ack");
+    return 0;
+  }
+
+  // send next msgs
+  if (pMsg->ack <= pSender->seq) {
+    syncLogRecvSyncSnapshotRsp(pSyncNode, pMsg,
+                               (pMsg->ack == SYNC_SNAPSHOT_SEQ_BEGIN) ? "process seq begin" : "process seq data");
     // update sender ack
     if (snapshotSenderUpdateProgress(pSender, pMsg) != 0) {
       return -1;
@@ -1010,12 +1148,6 @@ int32_t syncNodeOnSnapshotRsp(SSyncNode *pSyncNode, const SRpcMsg *pRpcMsg) {
     if (snapshotSend(pSender) != 0) {
       return -1;
     }
-  } else if (pMsg->ack == pSender->seq - 1) {
-    // maybe resend
-    syncLogRecvSyncSnapshotRsp(pSyncNode, pMsg, "process seq and resend");
-    if (snapshotReSend(pSender) != 0) {
-      return -1;
-    }
   } else {
     // error log
     syncLogRecvSyncSnapshotRsp(pSyncNode, pMsg, "receive error ack");
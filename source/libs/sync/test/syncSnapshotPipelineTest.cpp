@@ -0,0 +1,422 @@
+#include <gtest/gtest.h>
+#include <deque>
+#include <string>
+#include <vector>
+#include "syncPipeline.h"
+#include "syncTest.h"
+#include "tglobal.h"
+
+// a leader and a follower of vgId 1 sending a snapshot to each other, msgs go into a queue the test delivers from
+namespace {
+
+const int32_t  kVgId = 1;
+const SyncTerm kTerm = 3;
+
+struct SnapNode {
+  SSyncNode     node;
+  SSyncFSM      fsm;
+  SSyncLogStore logStore;
+
+  SSnapshot                snapshot;
+  std::vector<std::string> blocks;  // handed out by the reader
+  size_t                   nRead;
+  std::vector<std::string> written;  // got by the writer
+  bool                     applied;
+  SyncIndex                restoreIndex;
+};
+
+std::deque<SRpcMsg> msgs;
+
+int32_t snapSendMsg(const SEpSet *pEpSet, SRpcMsg *pMsg) {
+  SMsgHead *pHead = (SMsgHead *)pMsg->pCont;
+  pHead->contLen = ntohl(pHead->contLen);
+  pHead->vgId = ntohl(pHead->vgId);
+  msgs.push_back(*pMsg);
+  return 0;
+}
+
+SnapNode *snapNode(const SSyncFSM *pFsm) { return (SnapNode *)pFsm->data; }
+
+void snapGetSnapshotInfo(const SSyncFSM *pFsm, SSnapshot *pSnapshot) { *pSnapshot = snapNode(pFsm)->snapshot; }
+
+int32_t snapStartRead(const SSyncFSM *pFsm, void *pParam, void **ppReader) {
+  snapNode(pFsm)->nRead = 0;
+  *ppReader = pFsm->data;
+  return 0;
+}
+
+void snapStopRead(const SSyncFSM *pFsm, void *pReader) {}
+
+int32_t snapDoRead(const SSyncFSM *pFsm, void *pReader, void **ppBuf, int32_t *len) {
+  SnapNode *pNode = snapNode(pFsm);
+  *ppBuf = NULL;
+  *len = 0;
+  if (pNode->nRead < pNode->blocks.size()) {
+    const std::string &block = pNode->blocks[pNode->nRead++];
+    *ppBuf = taosMemoryMalloc(block.size());
+    memcpy(*ppBuf, block.data(), block.size());
+    *len = block.size();
+  }
+  return 0;
+}
+
+int32_t snapStartWrite(const SSyncFSM *pFsm, void *pParam, void **ppWriter) {
+  snapNode(pFsm)->written.clear();
+  *ppWriter = pFsm->data;
+  return 0;
+}
+
+int32_t snapStopWrite(const SSyncFSM *pFsm, void *pWriter, bool isApply, SSnapshot *pSnapshot) {
+  if (isApply) {
+    snapNode(pFsm)->applied = true;
+    snapNode(pFsm)->snapshot = *pSnapshot;
+  }
+  return 0;
+}
+
+int32_t snapDoWrite(const SSyncFSM *pFsm, void *pWriter, void *pBuf, int32_t len) {
+  snapNode(pFsm)->written.push_back(std::string((char *)pBuf, len));
+  return 0;
+}
+
+SnapNode *logNode(SSyncLogStore *pLogStore) { return (SnapNode *)pLogStore->data; }
+
+SyncIndex snapLogBeginIndex(SSyncLogStore *pLogStore) { return logNode(pLogStore)->restoreIndex + 1; }
+SyncIndex snapLogLastIndex(SSyncLogStore *pLogStore) { return logNode(pLogStore)->restoreIndex; }
+
+int32_t snapLogRestoreFromSnapshot(SSyncLogStore *pLogStore, SyncIndex index) {
+  logNode(pLogStore)->restoreIndex = index;
+  return 0;
+}
+
+SRaftId snapRaftId(int32_t dnodeId) { return {.addr = (uint64_t)dnodeId, .vgId = kVgId}; }
+
+SnapNode *createSnapNode(int32_t myId, int32_t peerId, ESyncState state) {
+  SnapNode *pNode = new SnapNode();
+  pNode->restoreIndex = SYNC_INDEX_INVALID;
+  pNode->snapshot = {.data = NULL, .lastApplyIndex = SYNC_INDEX_INVALID, .lastApplyTerm = 0, .lastConfigIndex = -1};
+
+  SSyncFSM *pFsm = &pNode->fsm;
+  pFsm->data = pNode;
+  pFsm->FpGetSnapshotInfo = snapGetSnapshotInfo;
+  pFsm->FpSnapshotStartRead = snapStartRead;
+  pFsm->FpSnapshotStopRead = snapStopRead;
+  pFsm->FpSnapshotDoRead = snapDoRead;
+  pFsm->FpSnapshotStartWrite = snapStartWrite;
+  pFsm->FpSnapshotStopWrite = snapStopWrite;
+  pFsm->FpSnapshotDoWrite = snapDoWrite;
+
+  SSyncLogStore *pLogStore = &pNode->logStore;
+  pLogStore->data = pNode;
+  pLogStore->syncLogBeginIndex = snapLogBeginIndex;
+  pLogStore->syncLogLastIndex = snapLogLastIndex;
+  pLogStore->syncLogRestoreFromSnapshot = snapLogRestoreFromSnapshot;
+
+  SSyncNode *pSyncNode = &pNode->node;
+  pSyncNode->vgId = kVgId;
+  pSyncNode->state = state;
+  pSyncNode->raftStore.currentTerm = kTerm;
+  pSyncNode->electBaseLine = 1000;
+  pSyncNode->commitIndex = SYNC_INDEX_INVALID;
+  pSyncNode->myRaftId = snapRaftId(myId);
+  pSyncNode->replicaNum = 2;
+  pSyncNode->replicasId[0] = snapRaftId(myId);
+  pSyncNode->replicasId[1] = snapRaftId(peerId);
+  pSyncNode->peersNum = 1;
+  pSyncNode->peersId[0] = snapRaftId(peerId);
+  addEpIntoEpSet(&pSyncNode->peersEpset[0], "localhost", 7000 + peerId);
+  pSyncNode->syncSendMSg = snapSendMsg;
+  pSyncNode->pFsm = pFsm;
+  pSyncNode->pLogStore = pLogStore;
+  pSyncNode->pLogBuf = syncLogBufferCreate();
+  pSyncNode->pNextIndex = syncIndexMgrCreate(pSyncNode);
+  pSyncNode->pMatchIndex = syncIndexMgrCreate(pSyncNode);
+  for (int32_t i = 0; i < pSyncNode->replicaNum; ++i) {
+    pSyncNode->logReplMgrs[i] = syncLogReplMgrCreate();
+  }
+  pSyncNode->senders[1] = snapshotSenderCreate(pSyncNode, 1);
+  pSyncNode->pNewNodeReceiver = snapshotReceiverCreate(pSyncNode, snapRaftId(peerId));
+  return pNode;
+}
+
+void destroySnapNode(SnapNode *pNode) {
+  SSyncNode *pSyncNode = &pNode->node;
+  snapshotSenderDestroy(pSyncNode->senders[1]);
+  snapshotReceiverDestroy(pSyncNode->pNewNodeReceiver);
+  for (int32_t i = 0; i < pSyncNode->replicaNum; ++i) {
+    syncLogReplMgrDestroy(pSyncNode->logReplMgrs[i]);
+  }
+  syncIndexMgrDestroy(pSyncNode->pNextIndex);
+  syncIndexMgrDestroy(pSyncNode->pMatchIndex);
+  syncLogBufferDestroy(pSyncNode->pLogBuf);
+  delete pNode;
+}
+
+}  // namespace
+
+class SyncSnapshotPipelineTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    windowSize = tsSnapWindowSize;
+    tsSnapWindowSize = 4;
+
+    pLeader = createSnapNode(1, 2, TAOS_SYNC_STATE_LEADER);
+    pFollower = createSnapNode(2, 1, TAOS_SYNC_STATE_FOLLOWER);
+    pLeader->snapshot = {.data = NULL, .lastApplyIndex = 100, .lastApplyTerm = kTerm, .lastConfigIndex = -1};
+    pSender = pLeader->node.senders[1];
+    pReceiver = pFollower->node.pNewNodeReceiver;
+    ASSERT_NE(pSender, nullptr);
+    ASSERT_NE(pReceiver, nullptr);
+  }
+
+  void TearDown() override {
+    while (!msgs.empty()) {
+      rpcFreeCont(msgs.front().pCont);
+      msgs.pop_front();
+    }
+    destroySnapNode(pLeader);
+    destroySnapNode(pFollower);
+    tsSnapWindowSize = windowSize;
+  }
+
+  // blocks the leader reads, a repeated pattern so lz4 shrinks them
+  void genBlocks(int32_t nBlock) {
+    for (int32_t i = 0; i < nBlock; ++i) {
+      std::string block;
+      while (block.size() < 2048) block += "snapshot block " + std::to_string(i) + ";";
+      pLeader->blocks.push_back(block);
+    }
+  }
+
+  SRpcMsg popMsg() {
+    SRpcMsg rpcMsg = msgs.front();
+    msgs.pop_front();
+    return rpcMsg;
+  }
+
+  // deliver a msg to the node it is for and free it
+  void deliver(SRpcMsg rpcMsg) {
+    if (rpcMsg.msgType == TDMT_SYNC_SNAPSHOT_SEND) {
+      syncNodeOnSnapshot(&pFollower->node, &rpcMsg);
+    } else {
+      syncNodeOnSnapshotRsp(&pLeader->node, &rpcMsg);
+    }
+    rpcFreeCont(rpcMsg.pCont);
+  }
+
+  // the receiver announces no features, as one of a version before the window
+  void deliverAsOldPeer(SRpcMsg rpcMsg) {
+    if (rpcMsg.msgType == TDMT_SYNC_SNAPSHOT_RSP) {
+      ((SyncSnapshotRsp *)rpcMsg.pCont)->features = 0;
+    }
+    deliver(rpcMsg);
+  }
+
+  // go through pre-snapshot and begin, until the leader gets the ack of begin
+  void startSnapshot(bool oldPeer = false) {
+    ASSERT_EQ(syncNodeStartSnapshot(&pLeader->node, &pFollower->node.myRaftId), 0);
+    for (int32_t i = 0; i < 3; ++i) {
+      ASSERT_EQ(msgs.size(), 1);
+      oldPeer ? deliverAsOldPeer(popMsg()) : deliver(popMsg());
+    }
+    ASSERT_EQ(msgs.size(), 1);
+    ASSERT_EQ(msgs.front().msgType, TDMT_SYNC_SNAPSHOT_RSP);
+    ASSERT_EQ(((SyncSnapshotRsp *)msgs.front().pCont)->ack, SYNC_SNAPSHOT_SEQ_BEGIN);
+  }
+
+  // deliver every msg in order until none is left
+  void drain(bool oldPeer = false) {
+    while (!msgs.empty()) {
+      if (pSender->start && pSender->seq != SYNC_SNAPSHOT_SEQ_END) {
+        ASSERT_LE(pSender->seq - pSender->ack, pSender->window);
+      }
+      oldPeer ? deliverAsOldPeer(popMsg()) : deliver(popMsg());
+    }
+  }
+
+  void checkFinished() {
+    EXPECT_TRUE(pSender->finish);
+    EXPECT_FALSE(pSender->start);
+    EXPECT_FALSE(pReceiver->start);
+    EXPECT_TRUE(pFollower->applied);
+    EXPECT_EQ(pFollower->written, pLeader->blocks);
+    EXPECT_EQ(pFollower->restoreIndex, 100);
+    EXPECT_EQ(pFollower->node.commitIndex, 100);
+  }
+
+  int32_t windowSize;
+
+  SnapNode              *pLeader;
+  SnapNode              *pFollower;
+  SSyncSnapshotSender   *pSender;
+  SSyncSnapshotReceiver *pReceiver;
+};
+
+TEST_F(SyncSnapshotPipelineTest, window_in_flight) {
+  genBlocks(10);
+  startSnapshot();
+  EXPECT_EQ(pSender->window, 4);
+  EXPECT_EQ(pSender->features, SYNC_SNAPSHOT_FEATURE_PIPELINE | SYNC_SNAPSHOT_FEATURE_COMPRESS);
+
+  // the ack of begin fills the window
+  deliver(popMsg());
+  ASSERT_EQ(msgs.size(), 4);
+  for (int32_t i = 0; i < 4; ++i) {
+    EXPECT_EQ(((SyncSnapshotSend *)msgs[i].pCont)->seq, i + 1);
+  }
+  EXPECT_EQ(pSender->ack, SYNC_SNAPSHOT_SEQ_BEGIN);
+  EXPECT_EQ(pSender->seq, 4);
+
+  // each ack of a block lets one more out
+  deliver(popMsg());
+  ASSERT_EQ(msgs.size(), 4);
+  deliver(msgs[3]);
+  msgs.erase(msgs.begin() + 3);
+  EXPECT_EQ(pSender->ack, 1);
+  EXPECT_EQ(pSender->seq, 5);
+  ASSERT_EQ(msgs.size(), 4);
+  EXPECT_EQ(((SyncSnapshotSend *)msgs[3].pCont)->seq, 5);
+
+  drain();
+  checkFinished();
+}
+
+TEST_F(SyncSnapshotPipelineTest, ack_out_of_order) {
+  genBlocks(10);
+  startSnapshot();
+  deliver(popMsg());
+
+  // the receiver acks blocks 1 to 4
+  for (int32_t i = 0; i < 4; ++i) deliver(popMsg());
+  ASSERT_EQ(msgs.size(), 4);
+  std::vector<SRpcMsg> rsps(msgs.begin(), msgs.end());
+  msgs.clear();
+  for (int32_t i = 0; i < 4; ++i) {
+    ASSERT_EQ(((SyncSnapshotRsp *)rsps[i].pCont)->ack, i + 1);
+  }
+
+  // the ack of 3 comes first, blocks 5 to 7 are sent
+  deliver(rsps[2]);
+  EXPECT_EQ(pSender->ack, 3);
+  EXPECT_EQ(pSender->seq, 7);
+  EXPECT_EQ(msgs.size(), 3);
+
+  // the acks of 1 and 2 are stale then
+  deliver(rsps[0]);
+  deliver(rsps[1]);
+  EXPECT_EQ(pSender->ack, 3);
+  EXPECT_EQ(pSender->seq, 7);
+  EXPECT_EQ(msgs.size(), 3);
+  EXPECT_TRUE(pSender->start);
+
+  deliver(rsps[3]);
+  EXPECT_EQ(pSender->ack, 4);
+  EXPECT_EQ(pSender->seq, 8);
+  EXPECT_EQ(msgs.size(), 4);
+
+  drain();
+  checkFinished();
+}
+
+TEST_F(SyncSnapshotPipelineTest, receiver_reorder_duplicate) {
+  genBlocks(6);
+  startSnapshot();
+  deliver(popMsg());
+  ASSERT_EQ(msgs.size(), 4);
+  std::vector<SRpcMsg> blocks(msgs.begin(), msgs.end());
+  msgs.clear();
+
+  // blocks of seq 3, 2, 3, 1, 4, 1, every one is answered with the ack of the blocks written in order
+  int32_t order[] = {2, 1, 2, 0, 3, 0};
+  int32_t acks[] = {0, 0, 0, 3, 4, 4};
+  size_t  nWritten[] = {0, 0, 0, 3, 4, 4};
+  for (int32_t i = 0; i < 6; ++i) {
+    syncNodeOnSnapshot(&pFollower->node, &blocks[order[i]]);
+    ASSERT_EQ(msgs.size(), 1);
+    SRpcMsg rpcMsg = popMsg();
+    EXPECT_EQ(((SyncSnapshotRsp *)rpcMsg.pCont)->code, 0);
+    EXPECT_EQ(((SyncSnapshotRsp *)rpcMsg.pCont)->ack, acks[i]);
+    EXPECT_EQ(pReceiver->ack, acks[i]);
+    EXPECT_EQ(pFollower->written.size(), nWritten[i]);
+    rpcFreeCont(rpcMsg.pCont);
+  }
+  for (int32_t i = 0; i < 4; ++i) {
+    EXPECT_EQ(pFollower->written[i], pLeader->blocks[i]);
+    rpcFreeCont(blocks[i].pCont);
+  }
+
+  // a block beyond the window is refused
+  SRpcMsg rpcMsg = {0};
+  ASSERT_EQ(syncBuildSnapshotSend(&rpcMsg, 0, kVgId), 0);
+  SyncSnapshotSend *pMsg = (SyncSnapshotSend *)rpcMsg.pCont;
+  pMsg->srcId = pLeader->node.myRaftId;
+  pMsg->destId = pFollower->node.myRaftId;
+  pMsg->term = kTerm;
+  pMsg->startTime = pReceiver->startTime;
+  pMsg->seq = pReceiver->ack + SYNC_SNAPSHOT_WINDOW_MAX;
+  EXPECT_NE(syncNodeOnSnapshot(&pFollower->node, &rpcMsg), 0);
+  rpcFreeCont(rpcMsg.pCont);
+  ASSERT_EQ(msgs.size(), 1);
+  rpcMsg = popMsg();
+  EXPECT_NE(((SyncSnapshotRsp *)rpcMsg.pCont)->code, 0);
+  EXPECT_EQ(((SyncSnapshotRsp *)rpcMsg.pCont)->ack, 4);
+  rpcFreeCont(rpcMsg.pCont);
+  EXPECT_EQ(pReceiver->ack, 4);
+}
+
+TEST_F(SyncSnapshotPipelineTest, compressed_block) {
+  genBlocks(5);
+  pLeader->blocks.push_back("tiny");  // does not get smaller, sent as it is
+  startSnapshot();
+  deliver(popMsg());
+
+  int32_t nLz4 = 0;
+  int32_t nRaw = 0;
+  while (!msgs.empty()) {
+    SRpcMsg rpcMsg = popMsg();
+    if (rpcMsg.msgType == TDMT_SYNC_SNAPSHOT_SEND) {
+      SyncSnapshotSend *pMsg = (SyncSnapshotSend *)rpcMsg.pCont;
+      if (pMsg->seq > SYNC_SNAPSHOT_SEQ_BEGIN && pMsg->seq < SYNC_SNAPSHOT_SEQ_END) {
+        const std::string &block = pLeader->blocks[pMsg->seq - 1];
+        if (pMsg->cmprType == SYNC_SNAPSHOT_CMPR_LZ4) {
+          int32_t rawLen = 0;
+          memcpy(&rawLen, pMsg->data, sizeof(int32_t));
+          EXPECT_EQ(rawLen, block.size());
+          EXPECT_LT(pMsg->dataLen, block.size());
+          nLz4++;
+        } else {
+          EXPECT_EQ(pMsg->cmprType, SYNC_SNAPSHOT_CMPR_NONE);
+          EXPECT_EQ(std::string(pMsg->data, pMsg->dataLen), block);
+          nRaw++;
+        }
+      }
+    }
+    deliver(rpcMsg);
+  }
+
+  EXPECT_EQ(nLz4, 5);
+  EXPECT_EQ(nRaw, 1);
+  checkFinished();
+}
+
+TEST_F(SyncSnapshotPipelineTest, peer_without_features) {
+  genBlocks(5);
+  startSnapshot(true);
+  EXPECT_EQ(pSender->features, 0);
+  EXPECT_EQ(pSender->window, 1);
+
+  // one block at a time, none compressed
+  while (!msgs.empty()) {
+    ASSERT_EQ(msgs.size(), 1);
+    SRpcMsg rpcMsg = popMsg();
+    if (rpcMsg.msgType == TDMT_SYNC_SNAPSHOT_SEND) {
+      EXPECT_EQ(((SyncSnapshotSend *)rpcMsg.pCont)->cmprType, SYNC_SNAPSHOT_CMPR_NONE);
+    }
+    deliverAsOldPeer(rpcMsg);
+    if (pSender->start && pSender->seq != SYNC_SNAPSHOT_SEQ_END) {
+      EXPECT_LE(pSender->seq - pSender->ack, 1);
+    }
+  }
+
+  checkFinished();
+}
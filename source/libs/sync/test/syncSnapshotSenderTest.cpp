@@ -44,9 +44,10 @@ SSyncSnapshotSender* createSender() {
   pSender->seq = 10;
   pSender->ack = 20;
   pSender->pReader = (void*)0x11;
-  pSender->blockLen = 20;
-  pSender->pCurrentBlock = taosMemoryMalloc(pSender->blockLen);
-  snprintf((char*)(pSender->pCurrentBlock), pSender->blockLen, "%s", "hello");
+  pSender->aBlock[10].seq = 10;
+  pSender->aBlock[10].dataLen = 20;
+  pSender->aBlock[10].pData = taosMemoryMalloc(pSender->aBlock[10].dataLen);
+  snprintf((char*)(pSender->aBlock[10].pData), pSender->aBlock[10].dataLen, "%s", "hello");
 
   pSender->snapshot.lastApplyIndex = 99;
   pSender->snapshot.lastApplyTerm = 88;
@@ -600,7 +600,8 @@ static int tdbBtreeBalanceNonRoot(SBTree *pBt, SPage *pParent, int idx, TXN *pTx
     for (int i = 0; i < nOlds; i++) {
       nCells = TDB_PAGE_TOTAL_CELLS(pParent);
       if (sIdx < nCells) {
-        tdbPageDropCell(pParent, sIdx, pTxn, pBt);
+        // divider cells of interior children are moved down as is, keep their overflow pages
+        tdbPageDropCell(pParent, sIdx, pTxn, pBt, !childNotLeaf);
       } else {
         ((SIntHdr *)pParent->pData)->pgno = 0;
       }
@@ -854,6 +855,19 @@ static int tdbBtreeBalanceNonRoot(SBTree *pBt, SPage *pParent, int idx, TXN *pTx
     if (!TDB_BTREE_PAGE_IS_LEAF(pNews[0])) {
       ((SIntHdr *)(pParent->pData))->pgno = ((SIntHdr *)(pNews[0]->pData))->pgno;
     }
+
+    ret = tdbPagerInsertFreePage(pBt->pPager, pNews[0], pTxn);
+    if (ret < 0) {
+      return -1;
+    }
+  }
+
+  // old pages left empty by the redistribution
+  for (pageIdx = nNews; pageIdx < nOlds; ++pageIdx) {
+    ret = tdbPagerInsertFreePage(pBt->pPager, pOlds[pageIdx], pTxn);
+    if (ret < 0) {
+      return -1;
+    }
   }
 
   for (int i = 0; i < 3; i++) {
@@ -1527,7 +1541,11 @@ static int tdbBtreeCellSize(const SPage *pPage, SCell *pCell, int dropOfp, TXN *
 
         memcpy(&pgno, ofpCell + bytes, sizeof(pgno));
 
+        ret = tdbPagerInsertFreePage(pPage->pPager, ofp, pTxn);
         tdbPagerReturnPage(pPage->pPager, ofp, pTxn);
+        if (ret < 0) {
+          return -1;
+        }
 
         nLeft -= bytes;
       }
@@ -1987,7 +2005,7 @@ int tdbBtcDelete(SBTC *pBtc) {
     return -1;
   }
 
-  tdbPageDropCell(pBtc->pPage, idx, pBtc->pTxn, pBtc->pBt);
+  tdbPageDropCell(pBtc->pPage, idx, pBtc->pTxn, pBtc->pBt, 1);
 
   // update interior page or do balance
   if (idx == nCells - 1) {
@@ -15,6 +15,19 @@
 
 #include "tdbInt.h"
 
+static int tdbPgnoCmprFn(const void *pKey1, int kLen1, const void *pKey2, int kLen2) {
+  SPgno pgno1 = *(SPgno *)pKey1;
+  SPgno pgno2 = *(SPgno *)pKey2;
+
+  if (pgno1 < pgno2) {
+    return -1;
+  } else if (pgno1 > pgno2) {
+    return 1;
+  } else {
+    return 0;
+  }
+}
+
 int32_t tdbOpen(const char *dbname, int32_t szPage, int32_t pages, TDB **ppDb, int8_t rollback) {
   TDB *pDb;
   int  dsize;
@@ -70,6 +83,12 @@ int32_t tdbOpen(const char *dbname, int32_t szPage, int32_t pages, TDB **ppDb, i
   if (ret < 0) {
     return -1;
   }
+
+  // open free page db, keyed by page number
+  ret = tdbTbOpen(TDB_FREEDB_NAME, sizeof(SPgno), 0, tdbPgnoCmprFn, pDb, &pDb->pFreeDb, rollback);
+  if (ret < 0) {
+    return -1;
+  }
 #endif
 
   *ppDb = pDb;
@@ -82,6 +101,7 @@ int tdbClose(TDB *pDb) {
   if (pDb) {
 #ifdef USE_MAINDB
     if (pDb->pMainDb) tdbTbClose(pDb->pMainDb);
+    if (pDb->pFreeDb) tdbTbClose(pDb->pFreeDb);
 #endif
 
     for (pPager = pDb->pgrList; pPager; pPager = pDb->pgrList) {
@@ -183,6 +203,22 @@ int32_t tdbPrepareAsyncCommit(TDB *pDb, TXN *pTxn) {
   return 0;
 }
 
+int32_t tdbVacuum(TDB *pDb, TXN *pTxn) {
+  SPager *pPager;
+  int     ret;
+
+  for (pPager = pDb->pgrList; pPager; pPager = pPager->pNext) {
+    ret = tdbPagerVacuum(pPager, pTxn);
+    if (ret < 0) {
+      tdbError("failed to vacuum pager since %s. dbName:%s, txnId:%" PRId64, tstrerror(terrno), pDb->dbName,
+               pTxn->txnId);
+      return -1;
+    }
+  }
+
+  return 0;
+}
+
 int32_t tdbAbort(TDB *pDb, TXN *pTxn) {
   SPager *pPager;
   int     ret;
@@ -311,6 +311,7 @@ int tdbPagerBegin(SPager *pPager, TXN *pTxn) {
 
 int tdbPagerCommit(SPager *pPager, TXN *pTxn) {
   SPage *pPage;
+  bool   vacuumed;
   int    ret;
 
   // sync the journal file
@@ -328,6 +329,11 @@ int tdbPagerCommit(SPager *pPager, TXN *pTxn) {
     pPage = (SPage *)pNode;
 
     ASSERT(pPage->nOverflow == 0);
+    if (TDB_PAGE_PGNO(pPage) > pPager->dbFileSize) {
+      // freed page cut off by vacuum
+      continue;
+    }
+
     ret = tdbPagerPWritePageToDB(pPager, pPage);
     if (ret < 0) {
       tdbError("failed to write page to db since %s", tstrerror(terrno));
@@ -337,6 +343,7 @@ int tdbPagerCommit(SPager *pPager, TXN *pTxn) {
 
   tdbDebug("pager/commit: %p, %d/%d, txnId:%" PRId64, pPager, pPager->dbOrigSize, pPager->dbFileSize, pTxn->txnId);
 
+  vacuumed = pPager->dbFileSize < pPager->dbOrigSize;
   pPager->dbOrigSize = pPager->dbFileSize;
 
   // release the page
@@ -363,6 +370,17 @@ int tdbPagerCommit(SPager *pPager, TXN *pTxn) {
     return -1;
   }
 
+  // the free db no longer refers to the vacuumed tail, give it back to the file system
+  if (vacuumed) {
+    i64 size = (i64)pPager->pageSize * pPager->dbFileSize;
+    if (tdbOsFTruncate(pPager->fd, size) < 0) {
+      tdbError("failed to truncate file due to %s. file:%s, size:%" PRId64, strerror(errno), pPager->dbFileName,
+               size);
+      terrno = TAOS_SYSTEM_ERROR(errno);
+      return -1;
+    }
+  }
+
   return 0;
 }
 
@@ -411,6 +429,7 @@ int tdbPagerPrepareAsyncCommit(SPager *pPager, TXN *pTxn) {
     if (pPage->isLocal) continue;
 
     SPgno pgno = TDB_PAGE_PGNO(pPage);
+    if (pgno > pPager->dbFileSize) continue;
     if (pgno > maxPgno) {
       maxPgno = pgno;
     }
@@ -552,6 +571,11 @@ int tdbPagerAbort(SPager *pPager, TXN *pTxn) {
   tdbTrace("pager/abort: reset dirty tree: %p", &pPager->rbt);
   tRBTreeCreate(&pPager->rbt, pageCmpFn);
 
+  // undo a vacuum, the free db is restored from the journal and lists the tail pages again
+  if (pPager->dbFileSize < pPager->dbOrigSize) {
+    pPager->dbFileSize = pPager->dbOrigSize;
+  }
+
   // 4, remove the journal file
   if (tdbOsClose(pTxn->jfd) < 0) {
     tdbError("failed to close jfd: %s. file:%s, %" PRId64, strerror(errno), pPager->jFileName, pTxn->txnId);
@@ -650,7 +674,7 @@ int tdbPagerFetchPage(SPager *pPager, SPgno *ppgno, SPage **ppPage, int (*initPa
   // alloc new page
   if (pgno == 0) {
     loadPage = 0;
-    ret = tdbPagerAllocPage(pPager, &pgno);
+    ret = tdbPagerAllocPage(pPager, &pgno, pTxn);
     if (ret < 0) {
       ASSERT(0);
       return -1;
@@ -674,6 +698,13 @@ int tdbPagerFetchPage(SPager *pPager, SPgno *ppgno, SPage **ppPage, int (*initPa
       ASSERT(0);
       return -1;
     }
+  } else if (!loadPage) {
+    // a page recycled from the free list may still be cached with its old content
+    ret = (*initPage)(pPage, arg, 0);
+    if (ret < 0) {
+      ASSERT(0);
+      return -1;
+    }
   }
 
   // printf("thread %" PRId64 " pager fetch page %d pgno %d ppage %p\n", taosGetSelfPthreadId(), pPage->id,
@@ -693,9 +724,111 @@ void tdbPagerReturnPage(SPager *pPager, SPage *pPage, TXN *pTxn) {
   //        TDB_PAGE_PGNO(pPage), pPage);
 }
 
-static int tdbPagerAllocFreePage(SPager *pPager, SPgno *ppgno) {
-  // TODO: Allocate a page from the free list
-  return 0;
+// Move the pages freed while the free db was busy into the free db. pPager->frps stays set during the loop, so the
+// free db neither recycles pages for itself nor recurses into this function.
+static int tdbPagerFlushFreePages(SPager *pPager, TXN *pTxn) {
+  int ret = 0;
+
+  while (taosArrayGetSize(pPager->frps) > 0) {
+    SPgno pgno = *(SPgno *)taosArrayPop(pPager->frps);
+
+    ret = tdbTbInsert(pPager->pEnv->pFreeDb, &pgno, sizeof(pgno), NULL, 0, pTxn);
+    if (ret < 0) {
+      tdbError("tdb/free-page: failed to insert pgno:%d into free db since %s", pgno, tstrerror(terrno));
+      break;
+    }
+  }
+
+  taosArrayDestroy(pPager->frps);
+  pPager->frps = NULL;
+  return ret;
+}
+
+int tdbPagerInsertFreePage(SPager *pPager, SPage *pPage, TXN *pTxn) {
+  SPgno pgno = TDB_PAGE_PGNO(pPage);
+  int   ret;
+
+  if (pPager->pEnv == NULL || pPager->pEnv->pFreeDb == NULL) {
+    // the free db is not opened yet, the page is leaked as before
+    return 0;
+  }
+
+  // Journal the page before it can be recycled, otherwise an abort after reuse in the same transaction would restore
+  // the re-initialized content instead of the original one.
+  ret = tdbPagerWrite(pPager, pPage);
+  if (ret < 0) {
+    tdbError("failed to write page since %s", terrstr());
+    return -1;
+  }
+
+  tdbTrace("tdb/free-page: pager:%p, pgno:%d", pPager, pgno);
+
+  if (pPager->frps) {
+    if (taosArrayPush(pPager->frps, &pgno) == NULL) {
+      return -1;
+    }
+    return 0;
+  }
+
+  pPager->frps = taosArrayInit(8, sizeof(SPgno));
+  if (pPager->frps == NULL || taosArrayPush(pPager->frps, &pgno) == NULL) {
+    taosArrayDestroy(pPager->frps);
+    pPager->frps = NULL;
+    return -1;
+  }
+
+  return tdbPagerFlushFreePages(pPager, pTxn);
+}
+
+static int tdbPagerAllocFreePage(SPager *pPager, SPgno *ppgno, TXN *pTxn) {
+  TBC        *pCur = NULL;
+  const void *pKey = NULL;
+  int         nKey = 0;
+  int         ret;
+
+  // extend the file when called from inside the free db itself
+  if (pPager->pEnv == NULL || pPager->pEnv->pFreeDb == NULL || pPager->frps != NULL || pTxn == NULL) {
+    return 0;
+  }
+
+  pPager->frps = taosArrayInit(8, sizeof(SPgno));
+  if (pPager->frps == NULL) {
+    return -1;
+  }
+
+  ret = tdbTbcOpen(pPager->pEnv->pFreeDb, &pCur, pTxn);
+  if (ret < 0) {
+    goto _exit;
+  }
+
+  // take the smallest free page so that the tail of the file stays free and can be vacuumed
+  ret = tdbTbcMoveToFirst(pCur);
+  if (ret < 0 || !tdbTbcIsValid(pCur)) {
+    goto _exit;
+  }
+
+  ret = tdbTbcGet(pCur, &pKey, &nKey, NULL, NULL);
+  if (ret < 0) {
+    goto _exit;
+  }
+
+  ASSERT(nKey == sizeof(SPgno));
+  *ppgno = *(SPgno *)pKey;
+
+  ret = tdbTbcDelete(pCur);
+  if (ret < 0) {
+    *ppgno = 0;
+    goto _exit;
+  }
+
+  tdbTrace("tdb/alloc-free-page: pager:%p, pgno:%d", pPager, *ppgno);
+
+_exit:
+  tdbTbcClose(pCur);
+  if (tdbPagerFlushFreePages(pPager, pTxn) < 0) {
+    ret = -1;
+  }
+  return ret < 0 ? -1 : 0;
 }
 
 static int tdbPagerAllocNewPage(SPager *pPager, SPgno *ppgno) {
@@ -703,13 +836,13 @@ static int tdbPagerAllocNewPage(SPager *pPager, SPgno *ppgno) {
   return 0;
 }
 
-int tdbPagerAllocPage(SPager *pPager, SPgno *ppgno) {
+int tdbPagerAllocPage(SPager *pPager, SPgno *ppgno, TXN *pTxn) {
   int ret;
 
   *ppgno = 0;
 
   // Try to allocate from the free list of the pager
-  ret = tdbPagerAllocFreePage(pPager, ppgno);
+  ret = tdbPagerAllocFreePage(pPager, ppgno, pTxn);
   if (ret < 0) {
     return -1;
   }
@@ -727,6 +860,61 @@ int tdbPagerAllocPage(SPager *pPager, SPgno *ppgno) {
   return 0;
 }
 
+// Drop the free pages at the tail of the file from the free db and shrink the pager. The file itself is truncated
+// when the transaction commits.
+int tdbPagerVacuum(SPager *pPager, TXN *pTxn) {
+  TBC        *pCur = NULL;
+  const void *pKey = NULL;
+  int         nKey = 0;
+  SPgno       nPages = pPager->dbFileSize;
+  int         ret = 0;
+
+  if (pPager->pEnv == NULL || pPager->pEnv->pFreeDb == NULL || pPager->frps != NULL) {
+    return 0;
+  }
+
+  pPager->frps = taosArrayInit(8, sizeof(SPgno));
+  if (pPager->frps == NULL) {
+    return -1;
+  }
+
+  for (;;) {
+    ret = tdbTbcOpen(pPager->pEnv->pFreeDb, &pCur, pTxn);
+    if (ret < 0) {
+      break;
+    }
+
+    ret = tdbTbcMoveToLast(pCur);
+    if (ret < 0 || !tdbTbcIsValid(pCur)) {
+      break;
+    }
+
+    ret = tdbTbcGet(pCur, &pKey, &nKey, NULL, NULL);
+    if (ret < 0 || *(SPgno *)pKey != pPager->dbFileSize) {
+      break;
+    }
+
+    ret = tdbTbcDelete(pCur);
+    if (ret < 0) {
+      break;
+    }
+
+    pPager->dbFileSize--;
+
+    tdbTbcClose(pCur);
+    pCur = NULL;
+  }
+
+  tdbTbcClose(pCur);
+  if (tdbPagerFlushFreePages(pPager, pTxn) < 0) {
+    ret = -1;
+  }
+
+  tdbDebug("tdb/vacuum: pager:%p, pages:%d -> %d", pPager, nPages, pPager->dbFileSize);
+
+  return ret < 0 ? -1 : 0;
+}
+
 static int tdbPagerInitPage(SPager *pPager, SPage *pPage, int (*initPage)(SPage *, void *, int), void *arg,
                             u8 loadPage) {
   int   ret;
@@ -18,6 +18,7 @@
 
 #include "tdb.h"
 
+#include "tarray.h"
 #include "tlog.h"
 #include "trbtree.h"
 
@@ -196,7 +197,9 @@ int  tdbPagerAbort(SPager *pPager, TXN *pTxn);
 int  tdbPagerFetchPage(SPager *pPager, SPgno *ppgno, SPage **ppPage, int (*initPage)(SPage *, void *, int), void *arg,
                        TXN *pTxn);
 void tdbPagerReturnPage(SPager *pPager, SPage *pPage, TXN *pTxn);
-int  tdbPagerAllocPage(SPager *pPager, SPgno *ppgno);
+int  tdbPagerAllocPage(SPager *pPager, SPgno *ppgno, TXN *pTxn);
+int  tdbPagerInsertFreePage(SPager *pPager, SPage *pPage, TXN *pTxn);
+int  tdbPagerVacuum(SPager *pPager, TXN *pTxn);
 int  tdbPagerRestoreJournals(SPager *pPager);
 int  tdbPagerRollback(SPager *pPager);
 
@@ -338,7 +341,7 @@ int  tdbPageDestroy(SPage *pPage, void (*xFree)(void *arg, void *ptr), void *arg
 void tdbPageZero(SPage *pPage, u8 szAmHdr, int (*xCellSize)(const SPage *, SCell *, int, TXN *, SBTree *pBt));
 void tdbPageInit(SPage *pPage, u8 szAmHdr, int (*xCellSize)(const SPage *, SCell *, int, TXN *, SBTree *pBt));
 int  tdbPageInsertCell(SPage *pPage, int idx, SCell *pCell, int szCell, u8 asOvfl);
-int  tdbPageDropCell(SPage *pPage, int idx, TXN *pTxn, SBTree *pBt);
+int  tdbPageDropCell(SPage *pPage, int idx, TXN *pTxn, SBTree *pBt, u8 dropOfp);
 int  tdbPageUpdateCell(SPage *pPage, int idx, SCell *pCell, int szCell, TXN *pTxn, SBTree *pBt);
 void tdbPageCopy(SPage *pFromPage, SPage *pToPage, int copyOvflCells);
 int  tdbPageCapacity(int pageSize, int amHdrSize);
@@ -371,6 +374,7 @@ static inline SCell *tdbPageGetCell(SPage *pPage, int idx) {
 
 #ifdef USE_MAINDB
 #define TDB_MAINDB_NAME "main.tdb"
+#define TDB_FREEDB_NAME "_free.db"
 #endif
 
 struct STDB {
@@ -384,6 +388,7 @@ struct STDB {
   SPager **pgrHash;
 #ifdef USE_MAINDB
   TTB *pMainDb;
+  TTB *pFreeDb;
 #endif
   int64_t txnId;
 };
@@ -403,6 +408,7 @@ struct SPager {
   TXN    *pActiveTxn;
   SPager *pNext;      // used by TDB
   SPager *pHashNext;  // used by TDB
+  SArray *frps;       // pages freed while the free db is being modified
 #ifdef USE_MAINDB
   TDB *pEnv;
 #endif
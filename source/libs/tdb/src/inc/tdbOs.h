@@ -54,6 +54,7 @@ typedef TdFilePtr tdb_fd_t;
 #define tdbOsPWrite                   taosPWriteFile
 #define tdbOsFSync                    taosFsyncFile
 #define tdbOsLSeek                    taosLSeekFile
+#define tdbOsFTruncate                taosFtruncateFile
 #define tdbDirPtr                     TdDirPtr
 #define tdbDirEntryPtr                TdDirEntryPtr
 #define tdbReadDir                    taosReadDir
@@ -116,9 +117,10 @@ i64 tdbOsRead(tdb_fd_t fd, void *pData, i64 nBytes);
 i64 tdbOsPRead(tdb_fd_t fd, void *pData, i64 nBytes, i64 offset);
 i64 tdbOsWrite(tdb_fd_t fd, const void *pData, i64 nBytes);
 
-#define tdbOsFSync  fsync
-#define tdbOsLSeek  lseek
-#define tdbOsRemove remove
+#define tdbOsFSync     fsync
+#define tdbOsLSeek     lseek
+#define tdbOsFTruncate ftruncate
+#define tdbOsRemove    remove
 #define tdbOsFileSize(FD, PSIZE)
 
 /* directory */
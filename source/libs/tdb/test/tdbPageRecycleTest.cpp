@@ -0,0 +1,112 @@
+#include <gtest/gtest.h>
+
+#define ALLOW_FORBID_FUNC
+#include "os.h"
+#include "tdb.h"
+
+#include <string>
+
+static const char *kDbDir = "tdb_recycle";
+static const int   kPageSize = 4096;
+static const int   kNumOfRows = 2000;
+
+static void *testMalloc(void *arg, size_t size) { return taosMemoryMalloc(size); }
+static void  testFree(void *arg, void *ptr) { taosMemoryFree(ptr); }
+
+static int64_t dbFileSize() {
+  int64_t     size = 0;
+  std::string fname = std::string(kDbDir) + "/main.tdb";
+  taosStatFile(fname.c_str(), &size, NULL);
+  return size;
+}
+
+// every 10th value does not fit in one page, so overflow pages are recycled as well
+static std::string genVal(int i) { return std::string(i % 10 ? 100 : 3 * kPageSize, 'a' + i % 26); }
+
+static void insertRows(TDB *pEnv, TTB *pTb, int from, int to) {
+  TXN *txn = NULL;
+  ASSERT_EQ(tdbBegin(pEnv, &txn, testMalloc, testFree, NULL, TDB_TXN_WRITE | TDB_TXN_READ_UNCOMMITTED), 0);
+  for (int i = from; i < to; i++) {
+    std::string val = genVal(i);
+    ASSERT_EQ(tdbTbInsert(pTb, &i, sizeof(i), val.c_str(), val.size(), txn), 0);
+  }
+  ASSERT_EQ(tdbCommit(pEnv, txn), 0);
+  ASSERT_EQ(tdbPostCommit(pEnv, txn), 0);
+}
+
+static void deleteRows(TDB *pEnv, TTB *pTb, int from, int to, bool vacuum) {
+  TXN *txn = NULL;
+  ASSERT_EQ(tdbBegin(pEnv, &txn, testMalloc, testFree, NULL, TDB_TXN_WRITE | TDB_TXN_READ_UNCOMMITTED), 0);
+  for (int i = from; i < to; i++) {
+    ASSERT_EQ(tdbTbDelete(pTb, &i, sizeof(i), txn), 0);
+  }
+  if (vacuum) {
+    ASSERT_EQ(tdbVacuum(pEnv, txn), 0);
+  }
+  ASSERT_EQ(tdbCommit(pEnv, txn), 0);
+  ASSERT_EQ(tdbPostCommit(pEnv, txn), 0);
+}
+
+static void checkRows(TTB *pTb, int from, int to) {
+  for (int i = from; i < to; i++) {
+    void *pVal = NULL;
+    int   vLen = 0;
+    ASSERT_EQ(tdbTbGet(pTb, &i, sizeof(i), &pVal, &vLen), 0);
+
+    std::string val = genVal(i);
+    ASSERT_EQ(vLen, (int)val.size());
+    ASSERT_EQ(memcmp(pVal, val.c_str(), vLen), 0);
+    tdbFree(pVal);
+  }
+}
+
+TEST(TdbPageRecycleTest, reuse_and_vacuum) {
+  TDB *pEnv = NULL;
+  TTB *pTb = NULL;
+
+  taosRemoveDir(kDbDir);
+  ASSERT_EQ(tdbOpen(kDbDir, kPageSize, 64, &pEnv, 0), 0);
+  ASSERT_EQ(tdbTbOpen("recycle.db", sizeof(int), -1, NULL, pEnv, &pTb, 0), 0);
+
+  insertRows(pEnv, pTb, 0, kNumOfRows);
+  int64_t full = dbFileSize();
+
+  // the same data set written again after a delete must fit into the freed pages
+  for (int round = 0; round < 3; round++) {
+    deleteRows(pEnv, pTb, 0, kNumOfRows, false);
+    insertRows(pEnv, pTb, 0, kNumOfRows);
+    ASSERT_LE(dbFileSize(), full + full / 10);
+  }
+  checkRows(pTb, 0, kNumOfRows);
+
+  // drop the upper half, the pages at the tail are returned to the file system
+  deleteRows(pEnv, pTb, kNumOfRows / 2, kNumOfRows, true);
+  int64_t half = dbFileSize();
+  ASSERT_LT(half, full);
+  checkRows(pTb, 0, kNumOfRows / 2);
+
+  // an aborted vacuum leaves the file usable
+  TXN *txn = NULL;
+  ASSERT_EQ(tdbBegin(pEnv, &txn, testMalloc, testFree, NULL, TDB_TXN_WRITE | TDB_TXN_READ_UNCOMMITTED), 0);
+  for (int i = 0; i < kNumOfRows / 4; i++) {
+    ASSERT_EQ(tdbTbDelete(pTb, &i, sizeof(i), txn), 0);
+  }
+  ASSERT_EQ(tdbVacuum(pEnv, txn), 0);
+  ASSERT_EQ(tdbAbort(pEnv, txn), 0);
+
+  tdbTbClose(pTb);
+  tdbClose(pEnv);
+
+  // the free list survives a reopen
+  ASSERT_EQ(tdbOpen(kDbDir, kPageSize, 64, &pEnv, 0), 0);
+  ASSERT_EQ(tdbTbOpen("recycle.db", sizeof(int), -1, NULL, pEnv, &pTb, 0), 0);
+  checkRows(pTb, 0, kNumOfRows / 2);
+
+  insertRows(pEnv, pTb, kNumOfRows / 2, kNumOfRows);
+  ASSERT_LE(dbFileSize(), full + full / 10);
+  checkRows(pTb, 0, kNumOfRows);
+
+  tdbTbClose(pTb);
+  tdbClose(pEnv);
+  taosRemoveDir(kDbDir);
+}
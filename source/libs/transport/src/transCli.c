@@ -32,6 +32,7 @@ typedef struct SCliConn {
 
   SConnBuffer readBuf;
   STransQueue cliMsgs;
+  bool        writing;  // a write is in flight, msgs queued meanwhile are sent in one batch on its completion
 
   queue      q;
   SConnList* list;
@@ -750,23 +751,37 @@ static void cliDestroy(uv_handle_t* handle) {
   transDestroyBuffer(&conn->readBuf);
   taosMemoryFree(conn);
 }
+static bool cliHasMsgWaitResp(SCliConn* conn) {
+  for (int i = 0; i < transQueueSize(&conn->cliMsgs); i++) {
+    SCliMsg* pMsg = transQueueGet(&conn->cliMsgs, i);
+    if (pMsg->sent == 1 && !REQUEST_NO_RESP(&pMsg->msg)) {
+      return true;
+    }
+  }
+  return false;
+}
 static bool cliHandleNoResp(SCliConn* conn) {
   bool res = false;
-  if (!transQueueEmpty(&conn->cliMsgs)) {
-    SCliMsg* pMsg = transQueueGet(&conn->cliMsgs, 0);
-    if (REQUEST_NO_RESP(&pMsg->msg)) {
-      transQueuePop(&conn->cliMsgs);
+  // every sent msg has been written out by now, the ones that need no resp are done
+  for (int i = 0; i < transQueueSize(&conn->cliMsgs);) {
+    SCliMsg* pMsg = transQueueGet(&conn->cliMsgs, i);
+    if (pMsg->sent == 1 && REQUEST_NO_RESP(&pMsg->msg)) {
+      transQueueRm(&conn->cliMsgs, i);
       destroyCmsg(pMsg);
       res = true;
+    } else {
+      i++;
     }
-    if (res == true) {
-      if (cliMaySendCachedMsg(conn) == false) {
-        SCliThrd* thrd = conn->hostThrd;
-        addConnToPool(thrd->pool, conn);
-        res = false;
-      } else {
-        res = true;
-      }
+  }
+  if (res == true && cliHasMsgWaitResp(conn)) {
+    res = false;
+  } else if (res == true) {
+    if (cliMaySendCachedMsg(conn) == false) {
+      SCliThrd* thrd = conn->hostThrd;
+      addConnToPool(thrd->pool, conn);
+      res = false;
+    } else {
+      res = true;
     }
   }
   return res;
@@ -774,6 +789,7 @@ static bool cliHandleNoResp(SCliConn* conn) {
 static void cliSendCb(uv_write_t* req, int status) {
   SCliConn* pConn = transReqQueueRemove(req);
   if (pConn == NULL) return;
+  pConn->writing = false;
 
   SCliMsg* pMsg = !transQueueEmpty(&pConn->cliMsgs) ? transQueueGet(&pConn->cliMsgs, 0) : NULL;
   if (pMsg != NULL) {
@@ -796,20 +812,11 @@ static void cliSendCb(uv_write_t* req, int status) {
     tTrace("%s conn %p no resp required", CONN_GET_INST_LABEL(pConn), pConn);
     return;
   }
+  cliMaySendCachedMsg(pConn);
   uv_read_start((uv_stream_t*)pConn->stream, cliAllocRecvBufferCb, cliRecvCb);
 }
 
-void cliSend(SCliConn* pConn) {
-  bool empty = transQueueEmpty(&pConn->cliMsgs);
-  ASSERTS(empty == false, "trans-cli get invalid msg");
-  if (empty == true) {
-    return;
-  }
-
-  SCliMsg* pCliMsg = NULL;
-  CONN_GET_NEXT_SENDMSG(pConn);
-  pCliMsg->sent = 1;
-
+static void cliPrepareSendMsg(SCliConn* pConn, SCliMsg* pCliMsg, uv_buf_t* wb) {
   STransConnCtx* pCtx = pCliMsg->ctx;
 
   SCliThrd* pThrd = pConn->hostThrd;
@@ -844,7 +851,10 @@ void cliSend(SCliConn* pConn) {
   STraceId* trace = &pMsg->info.traceId;
 
   if (pTransInst->startTimer != NULL && pTransInst->startTimer(0, pMsg->msgType)) {
-    uv_timer_t* timer = taosArrayGetSize(pThrd->timerList) > 0 ? *(uv_timer_t**)taosArrayPop(pThrd->timerList) : NULL;
+    uv_timer_t* timer = pConn->timer;
+    if (timer == NULL) {
+      timer = taosArrayGetSize(pThrd->timerList) > 0 ? *(uv_timer_t**)taosArrayPop(pThrd->timerList) : NULL;
+    }
     if (timer == NULL) {
       timer = taosMemoryCalloc(1, sizeof(uv_timer_t));
       tDebug("no available timer, create a timer %p", timer);
@@ -869,13 +879,49 @@ void cliSend(SCliConn* pConn) {
   tGDebug("%s conn %p %s is sent to %s, local info %s, len:%d", CONN_GET_INST_LABEL(pConn), pConn,
           TMSG_INFO(pHead->msgType), pConn->dst, pConn->src, msgLen);
 
-  uv_buf_t    wb = uv_buf_init((char*)pHead, msgLen);
+  *wb = uv_buf_init((char*)pHead, msgLen);
+}
+
+void cliSend(SCliConn* pConn) {
+  bool empty = transQueueEmpty(&pConn->cliMsgs);
+  ASSERTS(empty == false, "trans-cli get invalid msg");
+  if (empty == true) {
+    return;
+  }
+
+  // msgs queued while a write is in flight are sent together once it completes
+  if (pConn->writing) {
+    return;
+  }
+
+  SCliMsg* pCliMsg = NULL;
+  CONN_GET_NEXT_SENDMSG(pConn);
+
+  uv_buf_t wb[TRANS_SEND_BATCH];
+  int32_t  num = 0;
+  for (int i = 0; i < transQueueSize(&pConn->cliMsgs) && num < TRANS_SEND_BATCH; i++) {
+    pCliMsg = transQueueGet(&pConn->cliMsgs, i);
+    if (pCliMsg->sent != 0) {
+      continue;
+    }
+
+    pCliMsg->sent = 1;
+    cliPrepareSendMsg(pConn, pCliMsg, &wb[num++]);
+
+    // a conn not persisted by app matches the resp to the head msg, so it carries one msg waiting for resp at a time
+    if (CONN_NO_PERSIST_BY_APP(pConn) && !REQUEST_NO_RESP(&pCliMsg->msg)) {
+      break;
+    }
+  }
+
+  pConn->writing = true;
   uv_write_t* req = transReqQueuePush(&pConn->wreqQueue);
 
-  int status = uv_write(req, (uv_stream_t*)pConn->stream, &wb, 1, cliSendCb);
+  int status = uv_write(req, (uv_stream_t*)pConn->stream, wb, num, cliSendCb);
   if (status != 0) {
-    tGError("%s conn %p failed to send msg:%s, errmsg:%s", CONN_GET_INST_LABEL(pConn), pConn, TMSG_INFO(pMsg->msgType),
-            uv_err_name(status));
+    tError("%s conn %p failed to send %d msgs, errmsg:%s", CONN_GET_INST_LABEL(pConn), pConn, num,
+           uv_err_name(status));
+    pConn->writing = false;
     cliHandleExcept(pConn);
   }
   return;
@@ -39,6 +39,7 @@ typedef struct SSvrConn {
   void*       ahandle;     //
   void*       hostThrd;
   STransQueue srvMsgs;
+  int32_t     nSending;  // msgs at the head of srvMsgs covered by the write in flight
 
   SSvrRegArg regArg;
   bool       broken;  // conn broken;
@@ -127,7 +128,7 @@ static void uvFreeCb(uv_handle_t* handle);
 
 static FORCE_INLINE void uvStartSendRespImpl(SSvrMsg* smsg);
 
-static int  uvPrepareSendData(SSvrMsg* msg, uv_buf_t* wb);
+static int  uvPrepareSendData(SSvrMsg* msg, int32_t idx, uv_buf_t* wb);
 static void uvStartSendResp(SSvrMsg* msg);
 
 static void uvNotifyLinkBrokenToApp(SSvrConn* conn);
@@ -348,11 +349,15 @@ void uvOnSendCb(uv_write_t* req, int status) {
   if (status == 0) {
     tTrace("conn %p data already was written on stream", conn);
     if (!transQueueEmpty(&conn->srvMsgs)) {
-      SSvrMsg*  msg = transQueuePop(&conn->srvMsgs);
-      STraceId* trace = &msg->msg.info.traceId;
-      tGDebug("conn %p write data out", conn);
+      SSvrMsg* msg = NULL;
+      for (int32_t i = 0; i < conn->nSending; i++) {
+        msg = transQueuePop(&conn->srvMsgs);
+        STraceId* trace = &msg->msg.info.traceId;
+        tGDebug("conn %p write data out", conn);
+        destroySmsg(msg);
+      }
+      conn->nSending = 0;
 
-      destroySmsg(msg);
       // send cached data
       if (!transQueueEmpty(&conn->srvMsgs)) {
         msg = (SSvrMsg*)transQueueGet(&conn->srvMsgs, 0);
@@ -400,7 +405,7 @@ static void uvOnPipeWriteCb(uv_write_t* req, int status) {
   taosMemoryFree(req);
 }
 
-static int uvPrepareSendData(SSvrMsg* smsg, uv_buf_t* wb) {
+static int uvPrepareSendData(SSvrMsg* smsg, int32_t idx, uv_buf_t* wb) {
   SSvrConn*  pConn = smsg->pConn;
   STransMsg* pMsg = &smsg->msg;
   if (pMsg->pCont == 0) {
@@ -415,7 +420,7 @@ static int uvPrepareSendData(SSvrMsg* smsg, uv_buf_t* wb) {
 
   // handle invalid drop_task resp, TD-20098
   if (pConn->inType == TDMT_SCH_DROP_TASK && pMsg->code == TSDB_CODE_VND_INVALID_VGROUP_ID) {
-    transQueuePop(&pConn->srvMsgs);
+    transQueueRm(&pConn->srvMsgs, idx);
     destroySmsg(smsg);
     return -1;
   }
@@ -463,14 +468,31 @@ static FORCE_INLINE void uvStartSendRespImpl(SSvrMsg* smsg) {
     return;
   }
 
-  uv_buf_t wb;
-  if (uvPrepareSendData(smsg, &wb) < 0) {
+  // smsg is the head of srvMsgs, the resps queued behind it while the last write was in flight go out in the same
+  // write, up to the next register msg
+  uv_buf_t wb[TRANS_SEND_BATCH];
+  int32_t  num = 0;
+
+  transRefSrvHandle(pConn);
+  while (num < TRANS_SEND_BATCH) {
+    SSvrMsg* msg = transQueueGet(&pConn->srvMsgs, num);
+    if (msg == NULL || (num > 0 && msg->type == Register)) {
+      break;
+    }
+    if (uvPrepareSendData(msg, num, &wb[num]) < 0) {
+      continue;
+    }
+    num++;
+  }
+
+  if (num == 0) {
+    transUnrefSrvHandle(pConn);
     return;
   }
 
-  transRefSrvHandle(pConn);
+  pConn->nSending = num;
   uv_write_t* req = transReqQueuePush(&pConn->wreqQueue);
-  uv_write(req, (uv_stream_t*)pConn->pTcp, &wb, 1, uvOnSendCb);
+  uv_write(req, (uv_stream_t*)pConn->pTcp, wb, num, uvOnSendCb);
 }
 static void uvStartSendResp(SSvrMsg* smsg) {
   // impl
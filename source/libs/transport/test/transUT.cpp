@@ -13,8 +13,10 @@
  * along with this program. If not, see <http://www.gnu.org/licenses/>.
  */
 #include <gtest/gtest.h>
+#include <algorithm>
 #include <cstdio>
 #include <cstring>
+#include <vector>
 #include "tdatablock.h"
 #include "tglobal.h"
 #include "tlog.h"
@@ -40,8 +42,11 @@ static void processContinueSend(void *parent, SRpcMsg *pMsg, SEpSet *pEpSet);
 static void processReleaseHandleCb(void *parent, SRpcMsg *pMsg, SEpSet *pEpSet);
 static void processRegisterFailure(void *parent, SRpcMsg *pMsg, SEpSet *pEpSet);
 static void processReq(void *parent, SRpcMsg *pMsg, SEpSet *pEpSet);
+static void processEchoReq(void *parent, SRpcMsg *pMsg, SEpSet *pEpSet);
+static void processDeferReq(void *parent, SRpcMsg *pMsg, SEpSet *pEpSet);
 // client process;
 static void processResp(void *parent, SRpcMsg *pMsg, SEpSet *pEpSet);
+static void processCollectResp(void *parent, SRpcMsg *pMsg, SEpSet *pEpSet);
 class Client {
  public:
   void Init(int nThread) {
@@ -82,6 +87,13 @@ class Client {
     SemWait();
     *resp = this->resp;
   }
+  void Send(SRpcMsg *req) {
+    SEpSet epSet = {0};
+    epSet.inUse = 0;
+    addEpIntoEpSet(&epSet, "127.0.0.1", 7000);
+
+    rpcSendRequest(this->transCli, &epSet, req, NULL);
+  }
   void SendAndRecvNoHandle(SRpcMsg *req, SRpcMsg *resp) {
     if (req->info.handle != NULL) {
       rpcReleaseHandle(req->info.handle, TAOS_CONN_CLIENT);
@@ -197,6 +209,56 @@ static void processRegisterFailure(void *parent, SRpcMsg *pMsg, SEpSet *pEpSet)
   rpcMsg.code = 0;
   rpcSendResponse(&rpcMsg);
 }
+// seqs of the reqs in the order the server reads them
+static TdThreadMutex        echoMtx;
+static std::vector<int64_t> echoSeqs;
+// resp carries the int64 seq at the head of the req
+static void processEchoReq(void *parent, SRpcMsg *pMsg, SEpSet *pEpSet) {
+  taosThreadMutexLock(&echoMtx);
+  echoSeqs.push_back(*(int64_t *)pMsg->pCont);
+  taosThreadMutexUnlock(&echoMtx);
+
+  SRpcMsg rpcMsg = {0};
+  rpcMsg.pCont = rpcMallocCont(pMsg->contLen);
+  rpcMsg.contLen = pMsg->contLen;
+  memcpy(rpcMsg.pCont, pMsg->pCont, pMsg->contLen);
+  rpcMsg.info = pMsg->info;
+  rpcMsg.code = 0;
+  rpcFreeCont(pMsg->pCont);
+  rpcSendResponse(&rpcMsg);
+}
+
+// reqs after the first one are held until kDeferReqs of them arrived, then all resps are sent back to back. The
+// resps queue on the server conn while the first one is written, and go out together in the next write.
+static const int kDeferReqs = 32;
+static TdThreadMutex deferMtx;
+static std::vector<std::pair<SRpcHandleInfo, int64_t>> deferReqs;
+static void processDeferReq(void *parent, SRpcMsg *pMsg, SEpSet *pEpSet) {
+  if (*(int64_t *)pMsg->pCont == 1) {
+    processEchoReq(parent, pMsg, pEpSet);
+    return;
+  }
+
+  std::vector<std::pair<SRpcHandleInfo, int64_t>> reqs;
+
+  taosThreadMutexLock(&deferMtx);
+  deferReqs.push_back(std::make_pair(pMsg->info, *(int64_t *)pMsg->pCont));
+  if (deferReqs.size() == kDeferReqs) {
+    reqs.swap(deferReqs);
+  }
+  taosThreadMutexUnlock(&deferMtx);
+  rpcFreeCont(pMsg->pCont);
+
+  for (auto &req : reqs) {
+    SRpcMsg rpcMsg = {0};
+    rpcMsg.pCont = rpcMallocCont(sizeof(int64_t));
+    rpcMsg.contLen = sizeof(int64_t);
+    *(int64_t *)rpcMsg.pCont = req.second;
+    rpcMsg.info = req.first;
+    rpcMsg.code = 0;
+    rpcSendResponse(&rpcMsg);
+  }
+}
 // client process;
 static void processResp(void *parent, SRpcMsg *pMsg, SEpSet *pEpSet) {
   Client *client = (Client *)parent;
@@ -205,6 +267,51 @@ static void processResp(void *parent, SRpcMsg *pMsg, SEpSet *pEpSet) {
   tDebug("received resp");
 }
 
+// resps received by processCollectResp, in the order they arrive
+class RespCollector {
+ public:
+  RespCollector() {
+    taosThreadMutexInit(&mtx, NULL);
+    tsem_init(&sem, 0, 0);
+  }
+  void Reset(int n) {
+    taosThreadMutexLock(&mtx);
+    expect = n;
+    seqs.clear();
+    codes.clear();
+    handle = NULL;
+    taosThreadMutexUnlock(&mtx);
+  }
+  void Add(SRpcMsg *pMsg) {
+    taosThreadMutexLock(&mtx);
+    // a resp matched to the wrong req carries another seq than the ahandle of the req
+    int64_t seq = (pMsg->code == 0 && pMsg->contLen >= sizeof(int64_t)) ? *(int64_t *)pMsg->pCont : -1;
+    if (pMsg->code == 0 && seq != (int64_t)pMsg->info.ahandle) {
+      seq = -2;
+    }
+    seqs.push_back(seq);
+    codes.push_back(pMsg->code);
+    handle = pMsg->info.handle;
+    bool done = ((int)seqs.size() == expect);
+    taosThreadMutexUnlock(&mtx);
+    if (done) tsem_post(&sem);
+  }
+  bool Wait(int64_t ms) { return tsem_timewait(&sem, ms) == 0; }
+
+  TdThreadMutex        mtx;
+  tsem_t               sem;
+  int                  expect = 0;
+  std::vector<int64_t> seqs;
+  std::vector<int32_t> codes;
+  void                *handle = NULL;
+};
+static RespCollector collector;
+
+static void processCollectResp(void *parent, SRpcMsg *pMsg, SEpSet *pEpSet) {
+  collector.Add(pMsg);
+  rpcFreeCont(pMsg->pCont);
+}
+
 static void initEnv() {
   dDebugFlag = 143;
   vDebugFlag = 0;
@@ -260,6 +367,7 @@ class TransObj {
     cli->Stop();
   }
   void cliSendAndRecv(SRpcMsg *req, SRpcMsg *resp) { cli->SendAndRecv(req, resp); }
+  void cliSend(SRpcMsg *req) { cli->Send(req); }
   void cliSendAndRecvNoHandle(SRpcMsg *req, SRpcMsg *resp) { cli->SendAndRecvNoHandle(req, resp); }
 
   ~TransObj() {
@@ -500,3 +608,133 @@ TEST_F(TransEnv, noResp) {
 
   // no resp
 }
+
+static SRpcMsg makeSeqReq(int64_t seq, void *handle) {
+  SRpcMsg req = {0};
+  req.msgType = 1;
+  req.info.ahandle = (void *)seq;
+  req.info.handle = handle;
+  req.info.persistHandle = 1;
+  req.pCont = rpcMallocCont(sizeof(int64_t));
+  req.contLen = sizeof(int64_t);
+  *(int64_t *)req.pCont = seq;
+  return req;
+}
+
+// open a persisted conn, the reqs sent on its handle all go through one conn
+static void *openPersistHandle(TransObj *tr) {
+  collector.Reset(1);
+  SRpcMsg req = makeSeqReq(1, NULL);
+  tr->cliSend(&req);
+  EXPECT_TRUE(collector.Wait(10000));
+  EXPECT_EQ(collector.codes[0], 0);
+  return collector.handle;
+}
+
+// reqs sent on one conn while a write is in flight are queued and written together once it completes. Each resp
+// is still matched to its own req.
+TEST_F(TransEnv, cliBatchSendInFlight) {
+  taosThreadMutexInit(&echoMtx, NULL);
+  echoSeqs.clear();
+  tr->SetSrvContinueSend(processEchoReq);
+  tr->RestartCli(processCollectResp);
+
+  void *handle = openPersistHandle(tr);
+  ASSERT_TRUE(handle != NULL);
+
+  const int kBurst = 200;
+  for (int round = 0; round < 3; round++) {
+    collector.Reset(kBurst);
+    for (int i = 0; i < kBurst; i++) {
+      SRpcMsg req = makeSeqReq(2 + i, handle);
+      tr->cliSend(&req);
+    }
+    ASSERT_TRUE(collector.Wait(10000));
+
+    std::vector<int64_t> expect;
+    for (int i = 0; i < kBurst; i++) expect.push_back(2 + i);
+    std::vector<int64_t> seqs = collector.seqs;
+    std::sort(seqs.begin(), seqs.end());
+    EXPECT_EQ(seqs, expect);
+    EXPECT_EQ(collector.codes, std::vector<int32_t>(kBurst, 0));
+
+    // the client thread takes msgs from kCliAsyncs async handles, in order within each of them. A conn writes its
+    // queued msgs in the order they were queued, so the reqs of one handle reach the server in the order sent.
+    const int            kCliAsyncs = 8;
+    std::vector<int64_t> pos(2 + kBurst, -1);
+    taosThreadMutexLock(&echoMtx);
+    for (size_t i = 0; i < echoSeqs.size(); i++) pos[echoSeqs[i]] = i;
+    echoSeqs.clear();
+    taosThreadMutexUnlock(&echoMtx);
+    for (int i = 2; i + kCliAsyncs < 2 + kBurst; i++) {
+      EXPECT_LT(pos[i], pos[i + kCliAsyncs]) << "seq " << i;
+    }
+  }
+  rpcReleaseHandle(handle, TAOS_CONN_CLIENT);
+  tr->StopCli();
+  taosThreadMutexDestroy(&echoMtx);
+}
+
+// resps queued on a server conn behind a write in flight are written together, and all of them are released
+// once that write completes
+TEST_F(TransEnv, srvBatchSendResp) {
+  taosThreadMutexInit(&deferMtx, NULL);
+  tr->SetSrvContinueSend(processDeferReq);
+  tr->RestartCli(processCollectResp);
+
+  void *handle = openPersistHandle(tr);
+  ASSERT_TRUE(handle != NULL);
+
+  for (int round = 0; round < 3; round++) {
+    collector.Reset(kDeferReqs);
+    for (int i = 0; i < kDeferReqs; i++) {
+      SRpcMsg req = makeSeqReq(2 + i, handle);
+      tr->cliSend(&req);
+    }
+    ASSERT_TRUE(collector.Wait(10000));
+
+    // each resp is delivered once, to its own req
+    std::vector<int64_t> expect;
+    for (int i = 0; i < kDeferReqs; i++) expect.push_back(2 + i);
+    std::vector<int64_t> seqs = collector.seqs;
+    std::sort(seqs.begin(), seqs.end());
+    EXPECT_EQ(seqs, expect);
+    EXPECT_EQ(collector.codes, std::vector<int32_t>(kDeferReqs, 0));
+  }
+  rpcReleaseHandle(handle, TAOS_CONN_CLIENT);
+  tr->StopCli();
+  taosThreadMutexDestroy(&deferMtx);
+}
+
+// closing the client with msgs still queued behind a write in flight releases them without a crash
+TEST_F(TransEnv, cliCloseWithPendingMsgs) {
+  taosThreadMutexInit(&echoMtx, NULL);
+  tr->SetSrvContinueSend(processEchoReq);
+  tr->RestartCli(processCollectResp);
+
+  void *handle = openPersistHandle(tr);
+  ASSERT_TRUE(handle != NULL);
+
+  collector.Reset(-1);
+  for (int i = 0; i < 500; i++) {
+    SRpcMsg req = makeSeqReq(2 + i, handle);
+    tr->cliSend(&req);
+  }
+  tr->StopCli();
+
+  // every resp received before the close belongs to its own req, and no req gets two of them
+  taosThreadMutexLock(&collector.mtx);
+  std::vector<int64_t> seqs;
+  for (size_t i = 0; i < collector.seqs.size(); i++) {
+    if (collector.codes[i] == 0) seqs.push_back(collector.seqs[i]);
+  }
+  taosThreadMutexUnlock(&collector.mtx);
+  std::sort(seqs.begin(), seqs.end());
+  EXPECT_TRUE(std::adjacent_find(seqs.begin(), seqs.end()) == seqs.end());
+  for (int64_t seq : seqs) {
+    EXPECT_TRUE(seq >= 2 && seq < 2 + 500) << "seq " << seq;
+  }
+  tr->StopSrv();
+  echoSeqs.clear();
+  taosThreadMutexDestroy(&echoMtx);
+}
@@ -166,6 +166,16 @@ int64_t walGetSeq();
 int     walSeekWriteVer(SWal* pWal, int64_t ver);
 int32_t walRollImpl(SWal* pWal);
 
+// group commit section
+static inline bool walGroupCommitOn(SWal* pWal) {
+  return pWal->cfg.level == TAOS_WAL_FSYNC && pWal->cfg.fsyncPeriod == 0;
+}
+
+int32_t walFlushWriteBuf(SWal* pWal);
+void    walFlushForRead(SWal* pWal, int64_t ver);
+void    walDestroyWriteBuf(SWal* pWal);
+// group commit section end
+
 #ifdef __cplusplus
 }
 #endif
@@ -87,6 +87,13 @@ SWal *walOpen(const char *path, SWalCfg *pCfg) {
     return NULL;
   }
 
+  if (taosThreadCondInit(&pWal->commitCond, NULL) < 0) {
+    terrno = TAOS_SYSTEM_ERROR(errno);
+    taosThreadMutexDestroy(&pWal->mutex);
+    taosMemoryFree(pWal);
+    return NULL;
+  }
+
   // set config
   memcpy(&pWal->cfg, pCfg, sizeof(SWalCfg));
 
@@ -156,6 +163,9 @@ SWal *walOpen(const char *path, SWalCfg *pCfg) {
     goto _err;
   }
 
+  pWal->flushedVer = pWal->vers.lastVer;
+  pWal->syncedVer = pWal->vers.lastVer;
+
   // add ref
   pWal->refId = taosAddRef(tsWal.refSetId, pWal);
   if (pWal->refId < 0) {
@@ -170,6 +180,7 @@ SWal *walOpen(const char *path, SWalCfg *pCfg) {
 _err:
   taosArrayDestroy(pWal->fileInfoSet);
   taosHashCleanup(pWal->pRefHash);
+  taosThreadCondDestroy(&pWal->commitCond);
   taosThreadMutexDestroy(&pWal->mutex);
   taosMemoryFree(pWal);
   pWal = NULL;
@@ -188,10 +199,19 @@ int32_t walAlter(SWal *pWal, SWalCfg *pCfg) {
   wInfo("vgId:%d, change old walLevel:%d fsync:%d, new walLevel:%d fsync:%d", pWal->cfg.vgId, pWal->cfg.level,
         pWal->cfg.fsyncPeriod, pCfg->level, pCfg->fsyncPeriod);
 
+  // entries buffered by group commit are written out before the mode may change
+  taosThreadMutexLock(&pWal->mutex);
+  if (walFlushWriteBuf(pWal) < 0) {
+    taosThreadMutexUnlock(&pWal->mutex);
+    return terrno;
+  }
+
   pWal->cfg.level = pCfg->level;
   pWal->cfg.fsyncPeriod = pCfg->fsyncPeriod;
   pWal->fsyncSeq = pCfg->fsyncPeriod / 1000;
   if (pWal->fsyncSeq <= 0) pWal->fsyncSeq = 1;
+  pWal->syncedVer = pWal->flushedVer;
+  taosThreadMutexUnlock(&pWal->mutex);
 
   return 0;
 }
@@ -205,6 +225,10 @@ int32_t walPersist(SWal *pWal) {
 
 void walClose(SWal *pWal) {
   taosThreadMutexLock(&pWal->mutex);
+  if (walFlushWriteBuf(pWal) < 0) {
+    wError("vgId:%d, failed to flush wal buffer before close since %s", pWal->cfg.vgId, terrstr());
+  }
+  walDestroyWriteBuf(pWal);
   (void)walSaveMeta(pWal);
   taosCloseFile(&pWal->pLogFile);
   pWal->pLogFile = NULL;
@@ -233,6 +257,7 @@ static void walFreeObj(void *wal) {
   SWal *pWal = wal;
   wDebug("vgId:%d, wal:%p is freed", pWal->cfg.vgId, pWal);
 
+  taosThreadCondDestroy(&pWal->commitCond);
   taosThreadMutexDestroy(&pWal->mutex);
   taosMemoryFreeClear(pWal);
 }
@@ -238,6 +238,7 @@ static int32_t walFetchHeadNew(SWalReader *pRead, int64_t fetchVer) {
   bool    seeked = false;
 
   wDebug("vgId:%d, wal starts to fetch head, index:%" PRId64, pRead->pWal->cfg.vgId, fetchVer);
+  walFlushForRead(pRead->pWal, fetchVer);
 
   if (pRead->curInvalid || pRead->curVersion != fetchVer) {
     if (walReadSeekVer(pRead, fetchVer) < 0) {
@@ -359,6 +360,7 @@ int32_t walFetchHead(SWalReader *pRead, int64_t ver, SWalCkHead *pHead) {
   if (ver > pRead->pWal->vers.appliedVer) {
     return -1;
   }
+  walFlushForRead(pRead->pWal, ver);
 
   if (pRead->curInvalid || pRead->curVersion != ver) {
     code = walReadSeekVer(pRead, ver);
@@ -501,6 +503,7 @@ int32_t walReadVer(SWalReader *pReader, int64_t ver) {
     return -1;
   }
 
+  walFlushForRead(pReader->pWal, ver);
   taosThreadMutexLock(&pReader->mutex);
 
   if (pReader->curInvalid || pReader->curVersion != ver) {
@@ -36,6 +36,11 @@ int32_t walRestoreFromSnapshot(SWal *pWal, int64_t ver) {
     }
   }
 
+  if (walFlushWriteBuf(pWal) < 0) {
+    taosThreadMutexUnlock(&pWal->mutex);
+    return -1;
+  }
+
   taosCloseFile(&pWal->pLogFile);
   taosCloseFile(&pWal->pIdxFile);
 
@@ -75,6 +80,8 @@ int32_t walRestoreFromSnapshot(SWal *pWal, int64_t ver) {
   pWal->vers.commitVer = ver;
   pWal->vers.snapshotVer = ver;
   pWal->vers.verInSnapshotting = -1;
+  pWal->flushedVer = ver;
+  pWal->syncedVer = ver;
 
   taosThreadMutexUnlock(&pWal->mutex);
   return 0;
@@ -111,6 +118,11 @@ int32_t walRollback(SWal *pWal, int64_t ver) {
     return -1;
   }
 
+  if (walFlushWriteBuf(pWal) < 0) {
+    taosThreadMutexUnlock(&pWal->mutex);
+    return -1;
+  }
+
   // find correct file
   if (ver < walGetLastFileFirstVer(pWal)) {
     // change current files
@@ -215,6 +227,8 @@ int32_t walRollback(SWal *pWal, int64_t ver) {
     return -1;
   }
   pWal->vers.lastVer = ver - 1;
+  pWal->flushedVer = ver - 1;
+  pWal->syncedVer = TMIN(pWal->syncedVer, ver - 1);
   if (pWal->vers.lastVer < pWal->vers.firstVer) {
     ASSERT(pWal->vers.lastVer == pWal->vers.firstVer - 1);
   }
@@ -397,7 +411,21 @@ END:
 }
 
 int32_t walRollImpl(SWal *pWal) {
-  int32_t code = 0;
+  int32_t code = walFlushWriteBuf(pWal);
+  if (code != 0) {
+    goto END;
+  }
+
+  // entries left in the old file are not covered by the fsync of the new one
+  if (walGroupCommitOn(pWal) && pWal->pLogFile != NULL && pWal->syncedVer < pWal->flushedVer) {
+    code = taosFsyncFile(pWal->pLogFile);
+    if (code != 0) {
+      terrno = TAOS_SYSTEM_ERROR(errno);
+      goto END;
+    }
+    pWal->syncedVer = pWal->flushedVer;
+  }
+
   if (pWal->pIdxFile != NULL) {
     code = taosCloseFile(&pWal->pIdxFile);
     if (code != 0) {
@@ -455,6 +483,146 @@ END:
   return code;
 }
 
+#define WAL_WRITE_BUF_SIZE (4 * 1024 * 1024)
+
+static int32_t walWriteBufAppend(char **ppBuf, int64_t *pLen, int64_t *pCap, const void *data, int64_t size) {
+  if (*pLen + size > *pCap) {
+    int64_t cap = TMAX(*pCap * 2, *pLen + size);
+    cap = TMAX(cap, 4096);
+    char *pBuf = taosMemoryRealloc(*ppBuf, cap);
+    if (pBuf == NULL) {
+      terrno = TSDB_CODE_OUT_OF_MEMORY;
+      return -1;
+    }
+    *ppBuf = pBuf;
+    *pCap = cap;
+  }
+
+  memcpy(*ppBuf + *pLen, data, size);
+  *pLen += size;
+  return 0;
+}
+
+void walDestroyWriteBuf(SWal *pWal) {
+  taosMemoryFreeClear(pWal->writeBuf.pIdx);
+  taosMemoryFreeClear(pWal->writeBuf.pLog);
+  memset(&pWal->writeBuf, 0, sizeof(SWalWriteBuf));
+}
+
+static void walWaitCommit(SWal *pWal) {
+  while (pWal->committing) {
+    taosThreadCondWait(&pWal->commitCond, &pWal->mutex);
+  }
+}
+
+// called with the mutex held, writes all buffered entries with one write per file
+int32_t walFlushWriteBuf(SWal *pWal) {
+  SWalWriteBuf *pBuf = &pWal->writeBuf;
+
+  // the file may be switched by the caller
+  walWaitCommit(pWal);
+  if (pBuf->idxLen == 0 && pBuf->logLen == 0) {
+    return 0;
+  }
+
+  if (taosWriteFile(pWal->pIdxFile, pBuf->pIdx, pBuf->idxLen) != pBuf->idxLen ||
+      taosWriteFile(pWal->pLogFile, pBuf->pLog, pBuf->logLen) != pBuf->logLen) {
+    terrno = TAOS_SYSTEM_ERROR(errno);
+    wError("vgId:%d, file:%" PRId64 ".log, failed to write %" PRId64 " buffered bytes since %s", pWal->cfg.vgId,
+           walGetLastFileFirstVer(pWal), pBuf->logLen, strerror(errno));
+
+    // the entries are kept in the buffer, cut the partial write to retry later
+    if (taosFtruncateFile(pWal->pLogFile, pBuf->logOffset) < 0 ||
+        taosFtruncateFile(pWal->pIdxFile, pBuf->idxOffset) < 0) {
+      wFatal("vgId:%d, failed to ftruncate wal files during recovery due to %s", pWal->cfg.vgId, strerror(errno));
+      ASSERT(0 && "failed to recover from error");
+    }
+    return -1;
+  }
+
+  wTrace("vgId:%d, flush wal buffer, ver:%" PRId64 "~%" PRId64 ", len:%" PRId64, pWal->cfg.vgId,
+         pWal->flushedVer + 1, pWal->vers.lastVer, pBuf->logLen);
+  pBuf->idxLen = 0;
+  pBuf->logLen = 0;
+  atomic_store_64(&pWal->flushedVer, pWal->vers.lastVer);
+  return 0;
+}
+
+void walFlushForRead(SWal *pWal, int64_t ver) {
+  if (ver <= atomic_load_64(&pWal->flushedVer)) {
+    return;
+  }
+
+  taosThreadMutexLock(&pWal->mutex);
+  if (ver > pWal->flushedVer) {
+    (void)walFlushWriteBuf(pWal);
+  }
+  taosThreadMutexUnlock(&pWal->mutex);
+}
+
+/*
+ * Called with the mutex held. Waiters queue up behind the fsync in flight, the first one to wake up flushes all
+ * entries appended meanwhile and syncs them once for everybody.
+ */
+static int32_t walGroupCommit(SWal *pWal, int64_t ver) {
+  while (pWal->syncedVer < ver) {
+    if (pWal->committing) {
+      taosThreadCondWait(&pWal->commitCond, &pWal->mutex);
+      continue;
+    }
+
+    if (walFlushWriteBuf(pWal) < 0) {
+      return -1;
+    }
+
+    int64_t   target = pWal->flushedVer;
+    TdFilePtr pLogFile = pWal->pLogFile;
+    pWal->committing = 1;
+
+    taosThreadMutexUnlock(&pWal->mutex);
+    int32_t code = taosFsyncFile(pLogFile);
+    taosThreadMutexLock(&pWal->mutex);
+
+    pWal->committing = 0;
+    taosThreadCondBroadcast(&pWal->commitCond);
+    if (code < 0) {
+      terrno = TAOS_SYSTEM_ERROR(errno);
+      wError("vgId:%d, file:%" PRId64 ".log, fsync failed since %s", pWal->cfg.vgId, walGetCurFileFirstVer(pWal),
+             strerror(errno));
+      return -1;
+    }
+
+    wTrace("vgId:%d, group commit to ver:%" PRId64, pWal->cfg.vgId, target);
+    pWal->syncedVer = TMAX(pWal->syncedVer, target);
+  }
+
+  return 0;
+}
+
+static int32_t walBufferEntry(SWal *pWal, int64_t index, int64_t offset, const void *body, int32_t bodyLen) {
+  SWalWriteBuf *pBuf = &pWal->writeBuf;
+  SWalFileInfo *pFileInfo = walGetCurFileInfo(pWal);
+  int64_t       idxLen = pBuf->idxLen;
+  int64_t       logLen = pBuf->logLen;
+
+  if (idxLen == 0 && logLen == 0) {
+    pBuf->idxOffset = (index - pFileInfo->firstVer) * sizeof(SWalIdxEntry);
+    pBuf->logOffset = offset;
+  }
+
+  SWalIdxEntry entry = {.ver = index, .offset = offset};
+  if (walWriteBufAppend(&pBuf->pIdx, &pBuf->idxLen, &pBuf->idxCap, &entry, sizeof(SWalIdxEntry)) < 0 ||
+      walWriteBufAppend(&pBuf->pLog, &pBuf->logLen, &pBuf->logCap, &pWal->writeHead, sizeof(SWalCkHead)) < 0 ||
+      walWriteBufAppend(&pBuf->pLog, &pBuf->logLen, &pBuf->logCap, body, bodyLen) < 0) {
+    pBuf->idxLen = idxLen;
+    pBuf->logLen = logLen;
+    wError("vgId:%d, failed to buffer wal entry since %s, ver:%" PRId64, pWal->cfg.vgId, terrstr(), index);
+    return -1;
+  }
+
+  return 0;
+}
+
 static int32_t walWriteIndex(SWal *pWal, int64_t ver, int64_t offset) {
   SWalIdxEntry  entry = {.ver = ver, .offset = offset};
   SWalFileInfo *pFileInfo = walGetCurFileInfo(pWal);
@@ -502,6 +670,13 @@ static FORCE_INLINE int32_t walWriteImpl(SWal *pWal, int64_t index, tmsg_t msgTy
   wDebug("vgId:%d, wal write log %" PRId64 ", msgType: %s, cksum head %u cksum body %u", pWal->cfg.vgId, index,
          TMSG_INFO(msgType), pWal->writeHead.cksumHead, pWal->writeHead.cksumBody);
 
+  if (walGroupCommitOn(pWal)) {
+    if (walBufferEntry(pWal, index, offset, body, bodyLen) < 0) {
+      return -1;
+    }
+    goto _UPDATE;
+  }
+
   code = walWriteIndex(pWal, index, offset);
   if (code < 0) {
     goto END;
@@ -522,7 +697,9 @@ static FORCE_INLINE int32_t walWriteImpl(SWal *pWal, int64_t index, tmsg_t msgTy
     code = -1;
     goto END;
   }
+  atomic_store_64(&pWal->flushedVer, index);
 
+_UPDATE:
   // set status
   if (pWal->vers.firstVer == -1) {
     ASSERT(index == 0);
@@ -533,6 +710,11 @@ static FORCE_INLINE int32_t walWriteImpl(SWal *pWal, int64_t index, tmsg_t msgTy
   pFileInfo->lastVer = index;
   pFileInfo->fileSize += sizeof(SWalCkHead) + bodyLen;
 
+  if (pWal->writeBuf.logLen >= WAL_WRITE_BUF_SIZE) {
+    // the entries stay buffered on failure, and are retried by the next flush
+    (void)walFlushWriteBuf(pWal);
+  }
+
   return 0;
 
 END:
@@ -636,7 +818,9 @@ int32_t walWrite(SWal *pWal, int64_t index, tmsg_t msgType, const void *body, in
 
 void walFsync(SWal *pWal, bool forceFsync) {
   taosThreadMutexLock(&pWal->mutex);
-  if (forceFsync || (pWal->cfg.level == TAOS_WAL_FSYNC && pWal->cfg.fsyncPeriod == 0)) {
+  if (walGroupCommitOn(pWal)) {
+    (void)walGroupCommit(pWal, pWal->vers.lastVer);
+  } else if (forceFsync || (pWal->cfg.level == TAOS_WAL_FSYNC && pWal->cfg.fsyncPeriod == 0)) {
     wTrace("vgId:%d, fileId:%" PRId64 ".log, do fsync", pWal->cfg.vgId, walGetCurFileFirstVer(pWal));
     if (taosFsyncFile(pWal->pLogFile) < 0) {
       wError("vgId:%d, file:%" PRId64 ".log, fsync failed since %s", pWal->cfg.vgId, walGetCurFileFirstVer(pWal),
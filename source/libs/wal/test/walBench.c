@@ -0,0 +1,137 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Durable append throughput of one wal under 1 to N writer threads, in entries per second.
+// Every writer appends an entry and waits until it is on disk before the next one, as the sync log store does.
+// "fsync each" forces one fsync per entry under the wal mutex, "group commit" runs with wal_level 2 and
+// fsync period 0, where concurrent writers share one write and one fsync per batch.
+// usage: walBench [-n entries per thread] [-t max threads] [-s body size] [-d dir]
+
+#include "os.h"
+#include "walInt.h"
+
+typedef struct {
+  SWal          *pWal;
+  TdThreadMutex *pMutex;
+  bool           group;
+  int32_t        numOfEntries;
+  int32_t        bodyLen;
+  char          *body;
+} SBenchArg;
+
+static void *walBenchWriter(void *param) {
+  SBenchArg *pArg = param;
+  for (int32_t i = 0; i < pArg->numOfEntries; ++i) {
+    // versions have to be consecutive, so picking one and appending is serialized like in the raft log store
+    taosThreadMutexLock(pArg->pMutex);
+    int64_t ver = walGetLastVer(pArg->pWal) + 1;
+    if (walWrite(pArg->pWal, ver, TDMT_VND_SUBMIT, pArg->body, pArg->bodyLen) != 0) {
+      printf("failed to write ver:%" PRId64 " since %s\n", ver, terrstr());
+      exit(1);
+    }
+    taosThreadMutexUnlock(pArg->pMutex);
+
+    walFsync(pArg->pWal, !pArg->group);
+  }
+  return NULL;
+}
+
+static double walBenchRun(const char *path, bool group, int32_t numOfThreads, int32_t numOfEntries, int32_t bodyLen) {
+  SWalCfg cfg = {0};
+  cfg.rollPeriod = -1;
+  cfg.segSize = -1;
+  cfg.level = group ? TAOS_WAL_FSYNC : TAOS_WAL_WRITE;
+  cfg.fsyncPeriod = 0;
+
+  taosRemoveDir(path);
+  SWal *pWal = walOpen(path, &cfg);
+  if (pWal == NULL) {
+    printf("failed to open wal at %s since %s\n", path, terrstr());
+    exit(1);
+  }
+
+  TdThreadMutex mutex;
+  taosThreadMutexInit(&mutex, NULL);
+
+  char *body = taosMemoryMalloc(bodyLen);
+  memset(body, 'w', bodyLen);
+
+  TdThread  *threads = taosMemoryCalloc(numOfThreads, sizeof(TdThread));
+  SBenchArg *args = taosMemoryCalloc(numOfThreads, sizeof(SBenchArg));
+
+  int64_t start = taosGetTimestampUs();
+  for (int32_t i = 0; i < numOfThreads; ++i) {
+    args[i] = (SBenchArg){.pWal = pWal,
+                          .pMutex = &mutex,
+                          .group = group,
+                          .numOfEntries = numOfEntries,
+                          .bodyLen = bodyLen,
+                          .body = body};
+    taosThreadCreate(&threads[i], NULL, walBenchWriter, &args[i]);
+  }
+  for (int32_t i = 0; i < numOfThreads; ++i) {
+    taosThreadJoin(threads[i], NULL);
+  }
+  int64_t elapsed = taosGetTimestampUs() - start;
+
+  int64_t lastVer = walGetLastVer(pWal);
+  if (lastVer != (int64_t)numOfThreads * numOfEntries - 1) {
+    printf("unexpected last ver:%" PRId64 "\n", lastVer);
+    exit(1);
+  }
+
+  walClose(pWal);
+  taosRemoveDir(path);
+  taosThreadMutexDestroy(&mutex);
+  taosMemoryFree(threads);
+  taosMemoryFree(args);
+  taosMemoryFree(body);
+
+  return (double)numOfThreads * numOfEntries * 1000000 / TMAX(elapsed, 1);
+}
+
+int main(int argc, char *argv[]) {
+  int32_t     numOfEntries = 2000;
+  int32_t     maxThreads = 32;
+  int32_t     bodyLen = 256;
+  const char *path = TD_TMP_DIR_PATH "wal_bench";
+
+  for (int32_t i = 1; i < argc - 1; i += 2) {
+    if (strcmp(argv[i], "-n") == 0) {
+      numOfEntries = atoi(argv[i + 1]);
+    } else if (strcmp(argv[i], "-t") == 0) {
+      maxThreads = atoi(argv[i + 1]);
+    } else if (strcmp(argv[i], "-s") == 0) {
+      bodyLen = atoi(argv[i + 1]);
+    } else if (strcmp(argv[i], "-d") == 0) {
+      path = argv[i + 1];
+    }
+  }
+
+  if (walInit() != 0) {
+    printf("failed to init wal since %s\n", terrstr());
+    return 1;
+  }
+
+  printf("%8s %16s %16s %8s\n", "threads", "fsync each", "group commit", "ratio");
+  for (int32_t threads = 1; threads <= maxThreads; threads *= 2) {
+    double each = walBenchRun(path, false, threads, numOfEntries, bodyLen);
+    double group = walBenchRun(path, true, threads, numOfEntries, bodyLen);
+    printf("%8d %16.0f %16.0f %8.2f\n", threads, each, group, group / each);
+  }
+
+  walCleanUp();
+  return 0;
+}
@@ -1,7 +1,10 @@
 #include <gtest/gtest.h>
 #include <cstring>
 #include <iostream>
+#include <mutex>
 #include <queue>
+#include <thread>
+#include <vector>
 
 #include "walInt.h"
 
@@ -234,6 +237,49 @@ TEST_F(WalCleanEnv, write) {
   ASSERT_EQ(code, 0);
 }
 
+TEST_F(WalCleanEnv, groupCommit) {
+  const int  numOfThreads = 8;
+  const int  numOfEntries = 200;
+  std::mutex verMutex;
+
+  ASSERT_TRUE(walGroupCommitOn(pWal));
+  std::vector<std::thread> writers;
+  for (int t = 0; t < numOfThreads; t++) {
+    writers.emplace_back([&]() {
+      for (int i = 0; i < numOfEntries; i++) {
+        char newStr[100];
+        {
+          std::lock_guard<std::mutex> guard(verMutex);
+          int64_t                     ver = walGetLastVer(pWal) + 1;
+          sprintf(newStr, "%s-%" PRId64, ranStr, ver);
+          ASSERT_EQ(walWrite(pWal, ver, 0, newStr, strlen(newStr)), 0);
+        }
+        walFsync(pWal, false);
+      }
+    });
+  }
+  for (auto& writer : writers) {
+    writer.join();
+  }
+
+  int64_t lastVer = walGetLastVer(pWal);
+  ASSERT_EQ(lastVer, numOfThreads * numOfEntries - 1);
+  ASSERT_EQ(pWal->syncedVer, lastVer);
+  ASSERT_EQ(pWal->writeBuf.logLen, 0);
+
+  SWalReader* pRead = walOpenReader(pWal, NULL);
+  ASSERT(pRead != NULL);
+  for (int64_t ver = 0; ver <= lastVer; ver++) {
+    ASSERT_EQ(walReadVer(pRead, ver), 0);
+    ASSERT_EQ(pRead->pHead->head.version, ver);
+    char newStr[100];
+    sprintf(newStr, "%s-%" PRId64, ranStr, ver);
+    ASSERT_EQ(pRead->pHead->head.bodyLen, (int32_t)strlen(newStr));
+    ASSERT_EQ(memcmp(newStr, pRead->pHead->head.body, strlen(newStr)), 0);
+  }
+  walCloseReader(pRead);
+}
+
 TEST_F(WalCleanEnv, rollback) {
   int code;
   for (int i = 0; i < 10; i++) {
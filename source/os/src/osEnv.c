@@ -41,6 +41,7 @@ char tsSIMDBuiltins = 0;
 char tsSSE42Enable = 0;
 char tsAVXEnable = 0;
 char tsAVX2Enable = 0;
+char tsAVX512Enable = 0;
 char tsFMAEnable = 0;
 
 void osDefaultInit() {
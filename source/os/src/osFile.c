@@ -423,6 +423,23 @@ int64_t taosPReadFile(TdFilePtr pFile, void *buf, int64_t count, int64_t offset)
   return ret;
 }
 
+// asks the kernel to start reading the range into the page cache and returns without waiting for it
+int32_t taosReadAheadFile(TdFilePtr pFile, int64_t offset, int64_t count) {
+  if (pFile == NULL || pFile->fd < 0) {
+    return 0;
+  }
+#if defined(WINDOWS) || defined(_TD_DARWIN_64)
+  return 0;
+#else
+  int32_t ret = posix_fadvise(pFile->fd, offset, count, POSIX_FADV_WILLNEED);
+  if (ret != 0) {
+    errno = ret;
+    return -1;
+  }
+  return 0;
+#endif
+}
+
 int64_t taosWriteFile(TdFilePtr pFile, const void *buf, int64_t count) {
   if (pFile == NULL) {
     return 0;
@@ -129,4 +129,37 @@ TEST(osTest, osFile) {
   //printf("remove file success");
 }
 
+
+// read ahead is only a hint, ranges at and past the end of the file, and of an empty file, are taken as they are
+TEST(osTest, osReadAheadFile) {
+  char *fname = "./osfiletest2.txt";
+  char  buf[4096 * 3] = {0};
+
+  TdFilePtr pFile = taosOpenFile(fname, TD_FILE_CREATE | TD_FILE_WRITE | TD_FILE_READ | TD_FILE_TRUNC);
+  ASSERT_NE(pFile, nullptr);
+  ASSERT_EQ(taosReadAheadFile(pFile, 0, 4096), 0);
+
+  for (int32_t i = 0; i < sizeof(buf); i++) {
+    buf[i] = i % 127;
+  }
+  ASSERT_EQ(taosWriteFile(pFile, buf, sizeof(buf)), sizeof(buf));
+
+  ASSERT_EQ(taosReadAheadFile(pFile, 0, sizeof(buf)), 0);
+  ASSERT_EQ(taosReadAheadFile(pFile, 4096, 100), 0);
+  ASSERT_EQ(taosReadAheadFile(pFile, 4096 * 2, 4096 * 4), 0);
+  ASSERT_EQ(taosReadAheadFile(pFile, sizeof(buf), 4096), 0);
+  ASSERT_EQ(taosReadAheadFile(pFile, sizeof(buf) * 100, 4096), 0);
+  ASSERT_EQ(taosReadAheadFile(pFile, 0, 0), 0);
+  ASSERT_EQ(taosReadAheadFile(NULL, 0, 4096), 0);
+
+  // the file reads the same afterwards
+  char rbuf[sizeof(buf)] = {0};
+  ASSERT_EQ(taosPReadFile(pFile, rbuf, sizeof(rbuf), 0), sizeof(rbuf));
+  ASSERT_EQ(memcmp(buf, rbuf, sizeof(buf)), 0);
+  ASSERT_EQ(taosPReadFile(pFile, rbuf, sizeof(rbuf), sizeof(buf)), 0);
+
+  ASSERT_EQ(taosCloseFile(&pFile), 0);
+  ASSERT_EQ(taosRemoveFile(fname), 0);
+}
+
 #pragma GCC diagnostic pop
@@ -227,6 +227,336 @@ int32_t tsCompressINTImp(const char *const input, const int32_t nelements, char
   return opos;
 }
 
+/* ----------------------------------------------SIMD decode kernels
+ * ----------------------------------------------
+ * The scalar loops below are the reference implementation. The kernels here produce bit-identical output and are
+ * chosen at runtime when the CPU supports them, the binary was built with the matching -m flags and SIMD-builtins
+ * is enabled. Serial dependencies (running sum of deltas, XOR with the previous value) are resolved with in-register
+ * prefix scans.
+ */
+#define DECOMP_SIMD_NONE   0
+#define DECOMP_SIMD_AVX2   1
+#define DECOMP_SIMD_AVX512 2
+
+// a simple8b word holds at most 240 values, leave room for a full vector after it
+#define SIMPLE8B_DECODE_BUF (240 + 8)
+
+#if __AVX2__
+static FORCE_INLINE int8_t tsDecompSIMDLevel() {
+  if (!tsSIMDBuiltins) return DECOMP_SIMD_NONE;
+#if __AVX512F__
+  if (tsAVX512Enable) return DECOMP_SIMD_AVX512;
+#endif
+  if (tsAVX2Enable) return DECOMP_SIMD_AVX2;
+  return DECOMP_SIMD_NONE;
+}
+
+static FORCE_INLINE __m256i tPrefixAddI64AVX2(__m256i x) {
+  const __m256i zero = _mm256_setzero_si256();
+  x = _mm256_add_epi64(x, _mm256_blend_epi32(_mm256_permute4x64_epi64(x, 0x90), zero, 0x03));
+  x = _mm256_add_epi64(x, _mm256_permute2x128_si256(x, x, 0x08));
+  return x;
+}
+
+static FORCE_INLINE __m256i tPrefixXorI64AVX2(__m256i x) {
+  const __m256i zero = _mm256_setzero_si256();
+  x = _mm256_xor_si256(x, _mm256_blend_epi32(_mm256_permute4x64_epi64(x, 0x90), zero, 0x03));
+  x = _mm256_xor_si256(x, _mm256_permute2x128_si256(x, x, 0x08));
+  return x;
+}
+
+static FORCE_INLINE __m256i tPrefixXorI32AVX2(__m256i x) {
+  const __m256i zero = _mm256_setzero_si256();
+  x = _mm256_xor_si256(
+      x, _mm256_blend_epi32(_mm256_permutevar8x32_epi32(x, _mm256_setr_epi32(0, 0, 1, 2, 3, 4, 5, 6)), zero, 0x01));
+  x = _mm256_xor_si256(
+      x, _mm256_blend_epi32(_mm256_permutevar8x32_epi32(x, _mm256_setr_epi32(0, 0, 0, 1, 2, 3, 4, 5)), zero, 0x03));
+  x = _mm256_xor_si256(x, _mm256_permute2x128_si256(x, x, 0x08));
+  return x;
+}
+
+// decode one simple8b word into out[0, elems), out must have room for elems rounded up to 4
+static void tsSimple8bDecodeAVX2(uint64_t w, int32_t bit, int32_t elems, int64_t *prev, int64_t *out) {
+  const __m256i zero = _mm256_setzero_si256();
+  const __m256i one = _mm256_set1_epi64x(1);
+  const __m256i mask = _mm256_set1_epi64x(INT64MASK(bit));
+  const __m256i step = _mm256_set1_epi64x(4 * bit);
+  const __m256i vw = _mm256_set1_epi64x(w);
+  __m256i       shift = _mm256_setr_epi64x(4, 4 + bit, 4 + 2 * bit, 4 + 3 * bit);
+  __m256i       carry = _mm256_set1_epi64x(*prev);
+
+  for (int32_t i = 0; i < elems; i += 4) {
+    __m256i z = _mm256_and_si256(_mm256_srlv_epi64(vw, shift), mask);
+    __m256i d = _mm256_xor_si256(_mm256_srli_epi64(z, 1), _mm256_sub_epi64(zero, _mm256_and_si256(z, one)));
+    __m256i v = _mm256_add_epi64(tPrefixAddI64AVX2(d), carry);
+    _mm256_storeu_si256((__m256i *)(out + i), v);
+    carry = _mm256_permute4x64_epi64(v, 0xFF);
+    shift = _mm256_add_epi64(shift, step);
+  }
+
+  *prev = out[elems - 1];
+}
+
+// out[i] holds delta-of-delta for i > 0 and the first value for i == 0
+static void tsDeltaOfDeltaDecodeAVX2(int64_t *out, int32_t nele) {
+  __m256i carryD = _mm256_setzero_si256();
+  __m256i carryV = _mm256_set1_epi64x(out[0]);
+  int32_t i = 1;
+
+  for (; i + 4 <= nele; i += 4) {
+    __m256i d = _mm256_add_epi64(tPrefixAddI64AVX2(_mm256_loadu_si256((__m256i *)(out + i))), carryD);
+    __m256i v = _mm256_add_epi64(tPrefixAddI64AVX2(d), carryV);
+    _mm256_storeu_si256((__m256i *)(out + i), v);
+    carryD = _mm256_permute4x64_epi64(d, 0xFF);
+    carryV = _mm256_permute4x64_epi64(v, 0xFF);
+  }
+
+  if (i < nele) {
+    uint64_t delta = (uint64_t)_mm256_extract_epi64(carryD, 0);
+    uint64_t value = (uint64_t)_mm256_extract_epi64(carryV, 0);
+    for (; i < nele; i++) {
+      delta += (uint64_t)out[i];
+      value += delta;
+      out[i] = (int64_t)value;
+    }
+  }
+}
+
+static void tsPrefixXorI64AVX2(uint64_t *out, int32_t nele) {
+  __m256i carry = _mm256_setzero_si256();
+  int32_t i = 0;
+
+  for (; i + 4 <= nele; i += 4) {
+    __m256i v = _mm256_xor_si256(tPrefixXorI64AVX2(_mm256_loadu_si256((__m256i *)(out + i))), carry);
+    _mm256_storeu_si256((__m256i *)(out + i), v);
+    carry = _mm256_permute4x64_epi64(v, 0xFF);
+  }
+
+  uint64_t prev = (uint64_t)_mm256_extract_epi64(carry, 0);
+  for (; i < nele; i++) {
+    out[i] ^= prev;
+    prev = out[i];
+  }
+}
+
+static void tsPrefixXorI32AVX2(uint32_t *out, int32_t nele) {
+  const __m256i last = _mm256_set1_epi32(7);
+  __m256i       carry = _mm256_setzero_si256();
+  int32_t       i = 0;
+
+  for (; i + 8 <= nele; i += 8) {
+    __m256i v = _mm256_xor_si256(tPrefixXorI32AVX2(_mm256_loadu_si256((__m256i *)(out + i))), carry);
+    _mm256_storeu_si256((__m256i *)(out + i), v);
+    carry = _mm256_permutevar8x32_epi32(v, last);
+  }
+
+  uint32_t prev = (uint32_t)_mm256_extract_epi32(carry, 0);
+  for (; i < nele; i++) {
+    out[i] ^= prev;
+    prev = out[i];
+  }
+}
+
+#if __AVX512F__
+static FORCE_INLINE __m512i tPrefixAddI64AVX512(__m512i x) {
+  const __m512i zero = _mm512_setzero_si512();
+  x = _mm512_add_epi64(x, _mm512_alignr_epi64(x, zero, 7));
+  x = _mm512_add_epi64(x, _mm512_alignr_epi64(x, zero, 6));
+  x = _mm512_add_epi64(x, _mm512_alignr_epi64(x, zero, 4));
+  return x;
+}
+
+static FORCE_INLINE __m512i tPrefixXorI64AVX512(__m512i x) {
+  const __m512i zero = _mm512_setzero_si512();
+  x = _mm512_xor_si512(x, _mm512_alignr_epi64(x, zero, 7));
+  x = _mm512_xor_si512(x, _mm512_alignr_epi64(x, zero, 6));
+  x = _mm512_xor_si512(x, _mm512_alignr_epi64(x, zero, 4));
+  return x;
+}
+
+static FORCE_INLINE __m512i tPrefixXorI32AVX512(__m512i x) {
+  const __m512i zero = _mm512_setzero_si512();
+  x = _mm512_xor_si512(x, _mm512_alignr_epi32(x, zero, 15));
+  x = _mm512_xor_si512(x, _mm512_alignr_epi32(x, zero, 14));
+  x = _mm512_xor_si512(x, _mm512_alignr_epi32(x, zero, 12));
+  x = _mm512_xor_si512(x, _mm512_alignr_epi32(x, zero, 8));
+  return x;
+}
+
+// decode one simple8b word into out[0, elems), out must have room for elems rounded up to 8
+static void tsSimple8bDecodeAVX512(uint64_t w, int32_t bit, int32_t elems, int64_t *prev, int64_t *out) {
+  const __m512i zero = _mm512_setzero_si512();
+  const __m512i one = _mm512_set1_epi64(1);
+  const __m512i mask = _mm512_set1_epi64(INT64MASK(bit));
+  const __m512i step = _mm512_set1_epi64(8 * bit);
+  const __m512i vw = _mm512_set1_epi64(w);
+  const __m512i last = _mm512_set1_epi64(7);
+  __m512i       shift = _mm512_setr_epi64(4, 4 + bit, 4 + 2 * bit, 4 + 3 * bit, 4 + 4 * bit, 4 + 5 * bit, 4 + 6 * bit,
+                                          4 + 7 * bit);
+  __m512i       carry = _mm512_set1_epi64(*prev);
+
+  for (int32_t i = 0; i < elems; i += 8) {
+    __m512i z = _mm512_and_si512(_mm512_srlv_epi64(vw, shift), mask);
+    __m512i d = _mm512_xor_si512(_mm512_srli_epi64(z, 1), _mm512_sub_epi64(zero, _mm512_and_si512(z, one)));
+    __m512i v = _mm512_add_epi64(tPrefixAddI64AVX512(d), carry);
+    _mm512_storeu_si512((void *)(out + i), v);
+    carry = _mm512_permutexvar_epi64(last, v);
+    shift = _mm512_add_epi64(shift, step);
+  }
+
+  *prev = out[elems - 1];
+}
+
+static void tsDeltaOfDeltaDecodeAVX512(int64_t *out, int32_t nele) {
+  const __m512i last = _mm512_set1_epi64(7);
+  __m512i       carryD = _mm512_setzero_si512();
+  __m512i       carryV = _mm512_set1_epi64(out[0]);
+  int32_t       i = 1;
+
+  for (; i + 8 <= nele; i += 8) {
+    __m512i d = _mm512_add_epi64(tPrefixAddI64AVX512(_mm512_loadu_si512((void *)(out + i))), carryD);
+    __m512i v = _mm512_add_epi64(tPrefixAddI64AVX512(d), carryV);
+    _mm512_storeu_si512((void *)(out + i), v);
+    carryD = _mm512_permutexvar_epi64(last, d);
+    carryV = _mm512_permutexvar_epi64(last, v);
+  }
+
+  if (i < nele) {
+    uint64_t delta = (uint64_t)_mm_cvtsi128_si64(_mm512_castsi512_si128(carryD));
+    uint64_t value = (uint64_t)_mm_cvtsi128_si64(_mm512_castsi512_si128(carryV));
+    for (; i < nele; i++) {
+      delta += (uint64_t)out[i];
+      value += delta;
+      out[i] = (int64_t)value;
+    }
+  }
+}
+
+static void tsPrefixXorI64AVX512(uint64_t *out, int32_t nele) {
+  const __m512i last = _mm512_set1_epi64(7);
+  __m512i       carry = _mm512_setzero_si512();
+  int32_t       i = 0;
+
+  for (; i + 8 <= nele; i += 8) {
+    __m512i v = _mm512_xor_si512(tPrefixXorI64AVX512(_mm512_loadu_si512((void *)(out + i))), carry);
+    _mm512_storeu_si512((void *)(out + i), v);
+    carry = _mm512_permutexvar_epi64(last, v);
+  }
+
+  uint64_t prev = (uint64_t)_mm_cvtsi128_si64(_mm512_castsi512_si128(carry));
+  for (; i < nele; i++) {
+    out[i] ^= prev;
+    prev = out[i];
+  }
+}
+
+static void tsPrefixXorI32AVX512(uint32_t *out, int32_t nele) {
+  const __m512i last = _mm512_set1_epi32(15);
+  __m512i       carry = _mm512_setzero_si512();
+  int32_t       i = 0;
+
+  for (; i + 16 <= nele; i += 16) {
+    __m512i v = _mm512_xor_si512(tPrefixXorI32AVX512(_mm512_loadu_si512((void *)(out + i))), carry);
+    _mm512_storeu_si512((void *)(out + i), v);
+    carry = _mm512_permutexvar_epi32(last, v);
+  }
+
+  uint32_t prev = (uint32_t)_mm_cvtsi128_si32(_mm512_castsi512_si128(carry));
+  for (; i < nele; i++) {
+    out[i] ^= prev;
+    prev = out[i];
+  }
+}
+#endif
+
+#define SIMPLE8B_DECODE_WORD(T, w, bit, elems, prev, output, count)      \
+  do {                                                                   \
+    for (int32_t i = 0; i < (elems); i++) {                              \
+      uint64_t zigzag_value = (((w) >> (4 + (bit)*i)) & INT64MASK(bit)); \
+      (prev) = ZIGZAG_DECODE(int64_t, zigzag_value) + (prev);            \
+      ((T *)(output))[(count) + i] = (T)(prev);                          \
+    }                                                                    \
+  } while (0)
+
+static int32_t tsDecompressINTSIMD(const char *const input, const int32_t nelements, char *const output,
+                                   const char type, int32_t word_length, int8_t level) {
+  static const char    bit_per_integer[] = {0, 0, 1, 2, 3, 4, 5, 6, 7, 8, 10, 12, 15, 20, 30, 60};
+  static const int32_t selector_to_elems[] = {240, 120, 60, 30, 20, 15, 12, 10, 8, 7, 6, 5, 4, 3, 2, 1};
+
+  const char *ip = input + 1;
+  int32_t     count = 0;
+  int64_t     prev_value = 0;
+  int64_t     buf[SIMPLE8B_DECODE_BUF];
+
+  while (count < nelements) {
+    uint64_t w = 0;
+    memcpy(&w, ip, LONG_BYTES);
+    ip += LONG_BYTES;
+
+    int32_t selector = (int32_t)(w & INT64MASK(4));
+    int32_t bit = bit_per_integer[selector];
+    int32_t elems = TMIN(selector_to_elems[selector], nelements - count);
+
+    if (elems < 8 && selector > 1) {
+      // too few values per word to amortize the vector setup
+      switch (type) {
+        case TSDB_DATA_TYPE_BIGINT:
+          SIMPLE8B_DECODE_WORD(int64_t, w, bit, elems, prev_value, output, count);
+          break;
+        case TSDB_DATA_TYPE_INT:
+          SIMPLE8B_DECODE_WORD(int32_t, w, bit, elems, prev_value, output, count);
+          break;
+        case TSDB_DATA_TYPE_SMALLINT:
+          SIMPLE8B_DECODE_WORD(int16_t, w, bit, elems, prev_value, output, count);
+          break;
+        case TSDB_DATA_TYPE_TINYINT:
+          SIMPLE8B_DECODE_WORD(int8_t, w, bit, elems, prev_value, output, count);
+          break;
+      }
+      count += elems;
+      continue;
+    }
+
+    int64_t *pDec = buf;
+    if (type == TSDB_DATA_TYPE_BIGINT && nelements - count >= SIMPLE8B_DECODE_BUF) {
+      pDec = (int64_t *)output + count;  // enough room for the vector tail, decode in place
+    }
+
+    if (selector == 0 || selector == 1) {
+      for (int32_t i = 0; i < elems; i++) pDec[i] = prev_value;
+    } else {
+#if __AVX512F__
+      if (level == DECOMP_SIMD_AVX512) {
+        tsSimple8bDecodeAVX512(w, bit, elems, &prev_value, pDec);
+      } else
+#endif
+      {
+        tsSimple8bDecodeAVX2(w, bit, elems, &prev_value, pDec);
+      }
+    }
+
+    switch (type) {
+      case TSDB_DATA_TYPE_BIGINT:
+        if (pDec == buf) memcpy((int64_t *)output + count, buf, elems * sizeof(int64_t));
+        break;
+      case TSDB_DATA_TYPE_INT:
+        for (int32_t i = 0; i < elems; i++) ((int32_t *)output)[count + i] = (int32_t)pDec[i];
+        break;
+      case TSDB_DATA_TYPE_SMALLINT:
+        for (int32_t i = 0; i < elems; i++) ((int16_t *)output)[count + i] = (int16_t)pDec[i];
+        break;
+      case TSDB_DATA_TYPE_TINYINT:
+        for (int32_t i = 0; i < elems; i++) ((int8_t *)output)[count + i] = (int8_t)pDec[i];
+        break;
+    }
+
+    count += elems;
+  }
+
+  return nelements * word_length;
+}
+#endif
+
 int32_t tsDecompressINTImp(const char *const input, const int32_t nelements, char *const output, const char type) {
   int32_t word_length = 0;
   switch (type) {
@@ -253,6 +583,13 @@ int32_t tsDecompressINTImp(const char *const input, const int32_t nelements, cha
     return nelements * word_length;
   }
 
+#if __AVX2__
+  int8_t level = tsDecompSIMDLevel();
+  if (level != DECOMP_SIMD_NONE) {
+    return tsDecompressINTSIMD(input, nelements, output, type, word_length, level);
+  }
+#endif
+
   // Selector value:              0    1   2   3   4   5   6   7   8  9  10  11
   // 12  13  14  15
   char    bit_per_integer[] = {0, 0, 1, 2, 3, 4, 5, 6, 7, 8, 10, 12, 15, 20, 30, 60};
@@ -612,6 +949,58 @@ _exit_over:
   return nelements * LONG_BYTES + 1;
 }
 
+#if __AVX2__
+static int32_t tsDecompressTimestampSIMD(const char *const input, const int32_t nelements, char *const output,
+                                         int8_t level) {
+  int64_t *ostream = (int64_t *)output;
+  int32_t  ipos = 1;
+  int32_t  opos = 0;
+
+  // parse the variable length delta-of-deltas first, then resolve the two running sums with vector scans.
+  // While at least 8 more flag bytes follow, a full 8-byte load can not run past the end of the input.
+  for (; opos + 18 <= nelements; opos += 2) {
+    uint8_t  flags = input[ipos++];
+    uint64_t dd;
+    int8_t   nbytes = flags & INT8MASK(4);
+    memcpy(&dd, input + ipos, LONG_BYTES);
+    ipos += nbytes;
+    dd = nbytes ? (dd & (UINT64_MAX >> (64 - nbytes * BITS_PER_BYTE))) : 0;
+    ostream[opos] = ZIGZAG_DECODE(int64_t, dd);
+
+    nbytes = (flags >> 4) & INT8MASK(4);
+    memcpy(&dd, input + ipos, LONG_BYTES);
+    ipos += nbytes;
+    dd = nbytes ? (dd & (UINT64_MAX >> (64 - nbytes * BITS_PER_BYTE))) : 0;
+    ostream[opos + 1] = ZIGZAG_DECODE(int64_t, dd);
+  }
+
+  for (; opos < nelements; opos += 2) {
+    uint8_t  flags = input[ipos++];
+    uint64_t dd = 0;
+    int8_t   nbytes = flags & INT8MASK(4);
+    memcpy(&dd, input + ipos, nbytes);
+    ipos += nbytes;
+    ostream[opos] = ZIGZAG_DECODE(int64_t, dd);
+    if (opos + 1 == nelements) break;
+
+    dd = 0;
+    nbytes = (flags >> 4) & INT8MASK(4);
+    memcpy(&dd, input + ipos, nbytes);
+    ipos += nbytes;
+    ostream[opos + 1] = ZIGZAG_DECODE(int64_t, dd);
+  }
+
+#if __AVX512F__
+  if (level == DECOMP_SIMD_AVX512) {
+    tsDeltaOfDeltaDecodeAVX512(ostream, nelements);
+    return nelements * LONG_BYTES;
+  }
+#endif
+  tsDeltaOfDeltaDecodeAVX2(ostream, nelements);
+  return nelements * LONG_BYTES;
+}
+#endif
+
 int32_t tsDecompressTimestampImp(const char *const input, const int32_t nelements, char *const output) {
   ASSERTS(nelements >= 0, "nelements is negative");
   if (nelements == 0) return 0;
@@ -620,6 +1009,12 @@ int32_t tsDecompressTimestampImp(const char *const input, const int32_t nelement
     memcpy(output, input + 1, nelements * LONG_BYTES);
     return nelements * LONG_BYTES;
   } else if (input[0] == 1) {  // Decompress
+#if __AVX2__
+    int8_t level = tsDecompSIMDLevel();
+    if (level != DECOMP_SIMD_NONE && !is_bigendian()) {
+      return tsDecompressTimestampSIMD(input, nelements, output, level);
+    }
+#endif
     int64_t *ostream = (int64_t *)output;
 
     int32_t ipos = 1, opos = 0;
@@ -791,6 +1186,48 @@ uint64_t decodeDoubleValue(const char *const input, int32_t *const ipos, uint8_t
   return diff;
 }
 
+#if __AVX2__
+static int32_t tsDecompressDoubleSIMD(const char *const input, const int32_t nelements, char *const output,
+                                      int8_t level) {
+  uint64_t *ostream = (uint64_t *)output;
+  uint8_t   flags = 0;
+  int32_t   ipos = 1;
+  int32_t   i = 0;
+
+  // every value takes at least one byte, so a full 8-byte load is in bounds while 8 more values follow
+  for (; i + 9 <= nelements; i++) {
+    if ((i & 0x01) == 0) {
+      flags = input[ipos++];
+    }
+    uint8_t  flag = flags & INT8MASK(4);
+    int32_t  nbytes = (flag & INT8MASK(3)) + 1;
+    uint64_t diff;
+    memcpy(&diff, input + ipos, LONG_BYTES);
+    ipos += nbytes;
+    diff &= (UINT64_MAX >> (64 - nbytes * BITS_PER_BYTE));
+    ostream[i] = diff << ((LONG_BYTES * BITS_PER_BYTE - nbytes * BITS_PER_BYTE) * (flag >> 3));
+    flags >>= 4;
+  }
+
+  for (; i < nelements; i++) {
+    if ((i & 0x01) == 0) {
+      flags = input[ipos++];
+    }
+    ostream[i] = decodeDoubleValue(input, &ipos, flags & INT8MASK(4));
+    flags >>= 4;
+  }
+
+#if __AVX512F__
+  if (level == DECOMP_SIMD_AVX512) {
+    tsPrefixXorI64AVX512(ostream, nelements);
+    return nelements * DOUBLE_BYTES;
+  }
+#endif
+  tsPrefixXorI64AVX2(ostream, nelements);
+  return nelements * DOUBLE_BYTES;
+}
+#endif
+
 int32_t tsDecompressDoubleImp(const char *const input, const int32_t nelements, char *const output) {
   // output stream
   double *ostream = (double *)output;
@@ -800,6 +1237,13 @@ int32_t tsDecompressDoubleImp(const char *const input, const int32_t nelements,
     return nelements * DOUBLE_BYTES;
   }
 
+#if __AVX2__
+  int8_t level = tsDecompSIMDLevel();
+  if (level != DECOMP_SIMD_NONE) {
+    return tsDecompressDoubleSIMD(input, nelements, output, level);
+  }
+#endif
+
   uint8_t  flags = 0;
   int32_t  ipos = 1;
   int32_t  opos = 0;
@@ -938,6 +1382,48 @@ uint32_t decodeFloatValue(const char *const input, int32_t *const ipos, uint8_t
   return diff;
 }
 
+#if __AVX2__
+static int32_t tsDecompressFloatSIMD(const char *const input, const int32_t nelements, char *const output,
+                                     int8_t level) {
+  uint32_t *ostream = (uint32_t *)output;
+  uint8_t   flags = 0;
+  int32_t   ipos = 1;
+  int32_t   i = 0;
+
+  // every value takes at least one byte, so a full 4-byte load is in bounds while 4 more values follow
+  for (; i + 5 <= nelements; i++) {
+    if ((i & 0x01) == 0) {
+      flags = input[ipos++];
+    }
+    uint8_t  flag = flags & INT8MASK(4);
+    int32_t  nbytes = (flag & INT8MASK(3)) + 1;
+    uint32_t diff;
+    memcpy(&diff, input + ipos, FLOAT_BYTES);
+    ipos += nbytes;
+    diff &= (UINT32_MAX >> (32 - nbytes * BITS_PER_BYTE));
+    ostream[i] = diff << ((FLOAT_BYTES * BITS_PER_BYTE - nbytes * BITS_PER_BYTE) * (flag >> 3));
+    flags >>= 4;
+  }
+
+  for (; i < nelements; i++) {
+    if ((i & 0x01) == 0) {
+      flags = input[ipos++];
+    }
+    ostream[i] = decodeFloatValue(input, &ipos, flags & INT8MASK(4));
+    flags >>= 4;
+  }
+
+#if __AVX512F__
+  if (level == DECOMP_SIMD_AVX512) {
+    tsPrefixXorI32AVX512(ostream, nelements);
+    return nelements * FLOAT_BYTES;
+  }
+#endif
+  tsPrefixXorI32AVX2(ostream, nelements);
+  return nelements * FLOAT_BYTES;
+}
+#endif
+
 int32_t tsDecompressFloatImp(const char *const input, const int32_t nelements, char *const output) {
   float *ostream = (float *)output;
 
@@ -946,6 +1432,13 @@ int32_t tsDecompressFloatImp(const char *const input, const int32_t nelements, c
     return nelements * FLOAT_BYTES;
   }
 
+#if __AVX2__
+  int8_t level = tsDecompSIMDLevel();
+  if (level != DECOMP_SIMD_NONE) {
+    return tsDecompressFloatSIMD(input, nelements, output, level);
+  }
+#endif
+
   uint8_t  flags = 0;
   int32_t  ipos = 1;
   int32_t  opos = 0;
@@ -2306,6 +2799,59 @@ int32_t tsDecompressDouble(void *pIn, int32_t nIn, int32_t nEle, void *pOut, int
 #endif
 }
 
+// Lossless float and double ==================================
+int32_t tsCompressFloatLossless(void *pIn, int32_t nIn, int32_t nEle, void *pOut, int32_t nOut, uint8_t cmprAlg,
+                                void *pBuf, int32_t nBuf) {
+  if (cmprAlg == ONE_STAGE_COMP) {
+    return tsCompressFloatImp(pIn, nEle, pOut);
+  } else if (cmprAlg == TWO_STAGE_COMP) {
+    int32_t len = tsCompressFloatImp(pIn, nEle, pBuf);
+    return tsCompressStringImp(pBuf, len, pOut, nOut);
+  } else {
+    ASSERTS(0, "compress algo invalid");
+    return -1;
+  }
+}
+
+int32_t tsDecompressFloatLossless(void *pIn, int32_t nIn, int32_t nEle, void *pOut, int32_t nOut, uint8_t cmprAlg,
+                                  void *pBuf, int32_t nBuf) {
+  if (cmprAlg == ONE_STAGE_COMP) {
+    return tsDecompressFloatImp(pIn, nEle, pOut);
+  } else if (cmprAlg == TWO_STAGE_COMP) {
+    if (tsDecompressStringImp(pIn, nIn, pBuf, nBuf) < 0) return -1;
+    return tsDecompressFloatImp(pBuf, nEle, pOut);
+  } else {
+    ASSERTS(0, "compress algo invalid");
+    return -1;
+  }
+}
+
+int32_t tsCompressDoubleLossless(void *pIn, int32_t nIn, int32_t nEle, void *pOut, int32_t nOut, uint8_t cmprAlg,
+                                 void *pBuf, int32_t nBuf) {
+  if (cmprAlg == ONE_STAGE_COMP) {
+    return tsCompressDoubleImp(pIn, nEle, pOut);
+  } else if (cmprAlg == TWO_STAGE_COMP) {
+    int32_t len = tsCompressDoubleImp(pIn, nEle, pBuf);
+    return tsCompressStringImp(pBuf, len, pOut, nOut);
+  } else {
+    ASSERTS(0, "compress algo invalid");
+    return -1;
+  }
+}
+
+int32_t tsDecompressDoubleLossless(void *pIn, int32_t nIn, int32_t nEle, void *pOut, int32_t nOut, uint8_t cmprAlg,
+                                   void *pBuf, int32_t nBuf) {
+  if (cmprAlg == ONE_STAGE_COMP) {
+    return tsDecompressDoubleImp(pIn, nEle, pOut);
+  } else if (cmprAlg == TWO_STAGE_COMP) {
+    if (tsDecompressStringImp(pIn, nIn, pBuf, nBuf) < 0) return -1;
+    return tsDecompressDoubleImp(pBuf, nEle, pOut);
+  } else {
+    ASSERTS(0, "compress algo invalid");
+    return -1;
+  }
+}
+
 // Binary =====================================================
 int32_t tsCompressString(void *pIn, int32_t nIn, int32_t nEle, void *pOut, int32_t nOut, uint8_t cmprAlg, void *pBuf,
                          int32_t nBuf) {
@@ -4,20 +4,42 @@
 #include "tcompression.h"
 #include "thash.h"
 #include "tlog.h"
+#include "tsched.h"
+#include "lz4.h"
 
 #define GET_DATA_PAYLOAD(_p)          ((char*)(_p)->pData + POINTER_BYTES)
 #define NO_IN_MEM_AVAILABLE_PAGES(_b) (listNEles((_b)->lruList) >= (_b)->inMemPages)
 
+#define WRITE_BATCH_SIZE  (512 * 1024)  // evicted pages are written to disk in batches of this size
+#define READ_AHEAD_PAGES  4             // pages read ahead once the loads of a buffer go page by page
+#define WRITE_MAX_THREADS 4             // threads shared by all the buffers of the process to write the batches
+
 typedef struct SPageDiskInfo {
   int64_t offset;
   int32_t length;
 } SPageDiskInfo, SFreeListItem;
 
+typedef struct SPageWrite {
+  int32_t length;
+  int64_t offset;  // position in file
+  int64_t pos;     // position in the data of the batch
+} SPageWrite;
+
+// evicted pages waiting to be written to disk
+typedef struct SWriteBatch {
+  int32_t id;
+  char*   pData;
+  int64_t size;
+  SArray* pWrites;  // SPageWrite
+} SWriteBatch;
+
 struct SPageInfo {
   SListNode* pn;  // point to list node struct
   void*      pData;
   int64_t    offset;
   int32_t    pageId;
+  int32_t    batchId;   // id of the batch that has the last written version of this page
+  int32_t    batchPos;  // position of this page in that batch
   int32_t    length : 29;
   bool       used : 1;   // set current page is in used
   bool       dirty : 1;  // set current buffer page is dirty or not
@@ -43,6 +65,19 @@ struct SDiskbasedBuf {
   bool      comp;              // compressed before flushed to disk
   uint64_t  nextPos;           // next page flush position
 
+  // write-behind: batch[fill] takes the evicted pages, while a thread of the write pool puts the other one on disk
+  SWriteBatch      batch[2];
+  int32_t          fill;
+  int32_t          batchId;   // id of the last started batch
+  int64_t          batchCap;  // max bytes in one batch
+  TdThreadMutex    mutex;
+  TdThreadCond     cond;
+  volatile int8_t  writing;  // batch[fill ^ 1] is queued or being written
+  volatile int32_t writeCode;
+
+  int32_t lastId;    // the page asked by getBufPage last time, to predict the next one
+  int32_t lastStep;  // the distance between the last two pages asked
+
   char*               id;           // for debug purpose
   bool                printStatis;  // Print statistics info when closing this buffer.
   SDiskbasedBufStatis statis;
@@ -64,29 +99,36 @@ static int32_t createDiskFile(SDiskbasedBuf* pBuf) {
   return TSDB_CODE_SUCCESS;
 }
 
-static char* doCompressData(void* data, int32_t srcSize, int32_t* dst, SDiskbasedBuf* pBuf) {  // do nothing
+// A page that LZ4 can not make smaller is kept as it is, so an on-disk length equal to the page size means raw data.
+static char* doCompressData(void* data, int32_t srcSize, int32_t* dst, SDiskbasedBuf* pBuf) {
+  *dst = srcSize;
   if (!pBuf->comp) {
-    *dst = srcSize;
     return data;
   }
 
-  *dst = tsCompressString(data, srcSize, 1, pBuf->assistBuf, srcSize, ONE_STAGE_COMP, NULL, 0);
+  int32_t len = LZ4_compress_default(data, pBuf->assistBuf, srcSize, srcSize - 1);
+  if (len <= 0) {
+    return data;
+  }
 
-  memcpy(data, pBuf->assistBuf, *dst);
-  return data;
+  *dst = len;
+  return pBuf->assistBuf;
 }
 
-static char* doDecompressData(void* data, int32_t srcSize, int32_t* dst, SDiskbasedBuf* pBuf) {  // do nothing
-  if (!pBuf->comp) {
-    *dst = srcSize;
-    return data;
+static int32_t doDecompressData(const char* data, int32_t srcSize, char* dst, SDiskbasedBuf* pBuf) {
+  if (srcSize == pBuf->pageSize) {
+    if (data != dst) {
+      memcpy(dst, data, srcSize);
+    }
+    return TSDB_CODE_SUCCESS;
   }
 
-  *dst = tsDecompressString(data, srcSize, 1, pBuf->assistBuf, pBuf->pageSize, ONE_STAGE_COMP, NULL, 0);
-  if (*dst > 0) {
-    memcpy(data, pBuf->assistBuf, *dst);
+  int32_t len = LZ4_decompress_safe(data, dst, srcSize, pBuf->pageSize);
+  if (len != pBuf->pageSize) {
+    uError("failed to decompress page, length:%d, decompressed:%d, %s", srcSize, len, pBuf->id);
+    return TSDB_CODE_FILE_CORRUPTED;
   }
-  return data;
+  return TSDB_CODE_SUCCESS;
 }
 
 static uint64_t allocatePositionInFile(SDiskbasedBuf* pBuf, size_t size) {
@@ -116,6 +158,152 @@ static void setPageNotInBuf(SPageInfo* pPageInfo) { pPageInfo->pData = NULL; }
 
 static FORCE_INLINE size_t getAllocPageSize(int32_t pageSize) { return pageSize + POINTER_BYTES + sizeof(SFilePage); }
 
+// Pages that are next to each other both in the batch and in the file go to disk in one write.
+static int32_t doWriteBatch(SDiskbasedBuf* pBuf, SWriteBatch* pBatch) {
+  int32_t num = (int32_t)taosArrayGetSize(pBatch->pWrites);
+  for (int32_t i = 0; i < num;) {
+    SPageWrite* pw = taosArrayGet(pBatch->pWrites, i);
+    int64_t     offset = pw->offset;
+    int64_t     pos = pw->pos;
+    int64_t     len = pw->length;
+
+    for (++i; i < num; ++i) {
+      pw = taosArrayGet(pBatch->pWrites, i);
+      if (pw->offset != offset + len || pw->pos != pos + len) {
+        break;
+      }
+      len += pw->length;
+    }
+
+    if (taosPWriteFile(pBuf->pFile, pBatch->pData + pos, len, offset) != len) {
+      return TAOS_SYSTEM_ERROR(errno);
+    }
+  }
+
+  return TSDB_CODE_SUCCESS;
+}
+
+// A bounded pool for the batches of all the buffers, so that the number of writer threads does not grow with the
+// number of buffers. Once its queue is full, the eviction that hands over a batch waits for a free slot.
+static SSchedQueue  writePool = {0};
+static TdThreadOnce writePoolInit = PTHREAD_ONCE_INIT;
+static int32_t      writePoolThreads = 0;
+
+static void initWritePool() {
+  int32_t numOfThreads = TMIN(TMAX((int32_t)tsNumOfCores / 4, 1), WRITE_MAX_THREADS);
+  if (taosInitScheduler(numOfThreads * 16, numOfThreads, "paged-buf-write", &writePool) != NULL) {
+    writePoolThreads = numOfThreads;
+  }
+}
+
+static void pagedBufWriteTaskFp(SSchedMsg* pMsg) {
+  SDiskbasedBuf* pBuf = pMsg->ahandle;
+  SWriteBatch*   pBatch = pMsg->thandle;
+
+  int32_t code = doWriteBatch(pBuf, pBatch);
+
+  // the buffer may be destroyed as soon as the lock is released
+  taosThreadMutexLock(&pBuf->mutex);
+  if (code != TSDB_CODE_SUCCESS) {
+    pBuf->writeCode = code;
+  }
+  pBuf->writing = 0;
+  taosThreadCondBroadcast(&pBuf->cond);
+  taosThreadMutexUnlock(&pBuf->mutex);
+}
+
+static void waitBatchWritten(SDiskbasedBuf* pBuf) {
+  taosThreadMutexLock(&pBuf->mutex);
+  while (pBuf->writing) {
+    taosThreadCondWait(&pBuf->cond, &pBuf->mutex);
+  }
+  taosThreadMutexUnlock(&pBuf->mutex);
+}
+
+static void resetWriteBatch(SDiskbasedBuf* pBuf, SWriteBatch* pBatch) {
+  pBatch->id = ++pBuf->batchId;
+  pBatch->size = 0;
+  taosArrayClear(pBatch->pWrites);
+}
+
+// Hand the filled batch over to the write pool and continue with the other one, once that one is on disk.
+static int32_t submitWriteBatch(SDiskbasedBuf* pBuf) {
+  taosThreadOnce(&writePoolInit, initWritePool);
+  if (writePoolThreads == 0) {  // write it in place
+    int32_t code = doWriteBatch(pBuf, &pBuf->batch[pBuf->fill]);
+    resetWriteBatch(pBuf, &pBuf->batch[pBuf->fill]);
+    return code;
+  }
+
+  taosThreadMutexLock(&pBuf->mutex);
+  while (pBuf->writing) {
+    taosThreadCondWait(&pBuf->cond, &pBuf->mutex);
+  }
+
+  int32_t code = pBuf->writeCode;
+  if (code == TSDB_CODE_SUCCESS) {
+    pBuf->writing = 1;
+  }
+  taosThreadMutexUnlock(&pBuf->mutex);
+  if (code != TSDB_CODE_SUCCESS) {
+    return code;
+  }
+
+  SSchedMsg msg = {.fp = pagedBufWriteTaskFp, .ahandle = pBuf, .thandle = &pBuf->batch[pBuf->fill]};
+  pBuf->fill ^= 1;
+  resetWriteBatch(pBuf, &pBuf->batch[pBuf->fill]);
+  taosScheduleTask(&writePool, &msg);
+  return code;
+}
+
+static int32_t writePageBehind(SDiskbasedBuf* pBuf, SPageInfo* pg, const char* data, int32_t size) {
+  if (pBuf->batch[0].pData == NULL) {
+    pBuf->batchCap = TMAX(WRITE_BATCH_SIZE, pBuf->pageSize);
+    for (int32_t i = 0; i < tListLen(pBuf->batch); ++i) {
+      pBuf->batch[i].pData = taosMemoryMalloc(pBuf->batchCap);
+      pBuf->batch[i].pWrites = taosArrayInit(64, sizeof(SPageWrite));
+      if (pBuf->batch[i].pData == NULL || pBuf->batch[i].pWrites == NULL) {
+        return TSDB_CODE_OUT_OF_MEMORY;
+      }
+      resetWriteBatch(pBuf, &pBuf->batch[i]);
+    }
+  }
+
+  SWriteBatch* pBatch = &pBuf->batch[pBuf->fill];
+  if (pBatch->size + size > pBuf->batchCap) {
+    int32_t code = submitWriteBatch(pBuf);
+    if (code != TSDB_CODE_SUCCESS) {
+      return code;
+    }
+    pBatch = &pBuf->batch[pBuf->fill];
+  }
+
+  SPageWrite pw = {.length = size, .offset = pg->offset, .pos = pBatch->size};
+  if (taosArrayPush(pBatch->pWrites, &pw) == NULL) {
+    return TSDB_CODE_OUT_OF_MEMORY;
+  }
+  memcpy(pBatch->pData + pBatch->size, data, size);
+  pBatch->size += size;
+
+  pg->batchId = pBatch->id;
+  pg->batchPos = (int32_t)pw.pos;
+  return TSDB_CODE_SUCCESS;
+}
+
+// the last written version of a page that is not on disk yet
+static const char* getPageBehind(SDiskbasedBuf* pBuf, const SPageInfo* pg) {
+  if (pg->batchId == 0) {
+    return NULL;
+  }
+
+  for (int32_t i = 0; i < tListLen(pBuf->batch); ++i) {
+    if (pBuf->batch[i].id == pg->batchId) {
+      return pBuf->batch[i].pData + pg->batchPos;
+    }
+  }
+  return NULL;
+}
+
 /**
  *   +--------------------------+-------------------+--------------+
  *   | PTR to SPageInfo (8bytes)| Payload (PageSize)| 2 Extra Bytes|
@@ -129,70 +317,40 @@ static char* doFlushPageToDisk(SDiskbasedBuf* pBuf, SPageInfo* pg) {
 
   int32_t size = pBuf->pageSize;
   char*   t = NULL;
-  if (pg->offset == -1 || pg->dirty) {
+  if (pg->dirty) {
     void* payload = GET_DATA_PAYLOAD(pg);
     t = doCompressData(payload, pBuf->pageSize, &size, pBuf);
     ASSERTS(size >= 0, "size is negative");
   }
 
-  // this page is flushed to disk for the first time
   if (pg->dirty) {
-    if (pg->offset == -1) {
-      ASSERTS(pg->dirty == true, "pg->dirty is false");
-
+    if (pg->offset == -1) {  // this page is flushed to disk for the first time
       pg->offset = allocatePositionInFile(pBuf, size);
       pBuf->nextPos += size;
-
-      int32_t ret = taosLSeekFile(pBuf->pFile, pg->offset, SEEK_SET);
-      if (ret == -1) {
-        terrno = TAOS_SYSTEM_ERROR(errno);
-        return NULL;
-      }
-
-      ret = (int32_t)taosWriteFile(pBuf->pFile, t, size);
-      if (ret != size) {
-        terrno = TAOS_SYSTEM_ERROR(errno);
-        return NULL;
-      }
-
-      if (pBuf->fileSize < pg->offset + size) {
-        pBuf->fileSize = pg->offset + size;
-      }
-
-      pBuf->statis.flushBytes += size;
-      pBuf->statis.flushPages += 1;
-    } else {
+    } else if (pg->length < size) {
       // length becomes greater, current space is not enough, allocate new place, otherwise, do nothing
-      if (pg->length < size) {
-        // 1. add current space to free list
-        SPageDiskInfo dinfo = {.length = pg->length, .offset = pg->offset};
-        taosArrayPush(pBuf->pFree, &dinfo);
-
-        // 2. allocate new position, and update the info
-        pg->offset = allocatePositionInFile(pBuf, size);
-        pBuf->nextPos += size;
-      }
+      // 1. add current space to free list
+      SPageDiskInfo dinfo = {.length = pg->length, .offset = pg->offset};
+      taosArrayPush(pBuf->pFree, &dinfo);
 
-      // 3. write to disk.
-      int32_t ret = taosLSeekFile(pBuf->pFile, pg->offset, SEEK_SET);
-      if (ret == -1) {
-        terrno = TAOS_SYSTEM_ERROR(errno);
-        return NULL;
-      }
-
-      ret = (int32_t)taosWriteFile(pBuf->pFile, t, size);
-      if (ret != size) {
-        terrno = TAOS_SYSTEM_ERROR(errno);
-        return NULL;
-      }
+      // 2. allocate new position, and update the info
+      pg->offset = allocatePositionInFile(pBuf, size);
+      pBuf->nextPos += size;
+    }
 
-      if (pBuf->fileSize < pg->offset + size) {
-        pBuf->fileSize = pg->offset + size;
-      }
+    // 3. write to disk in background.
+    int32_t code = writePageBehind(pBuf, pg, t, size);
+    if (code != TSDB_CODE_SUCCESS) {
+      terrno = code;
+      return NULL;
+    }
 
-      pBuf->statis.flushBytes += size;
-      pBuf->statis.flushPages += 1;
+    if (pBuf->fileSize < pg->offset + size) {
+      pBuf->fileSize = pg->offset + size;
     }
+
+    pBuf->statis.flushBytes += size;
+    pBuf->statis.flushPages += 1;
   } else {  // NOTE: the size may be -1, the this recycle page has not been flushed to disk yet.
     size = pg->length;
   }
@@ -226,27 +384,51 @@ static char* flushPageToDisk(SDiskbasedBuf* pBuf, SPageInfo* pg) {
   return p;
 }
 
-// load file block data in disk
+// load file block data in disk, or from the batch that has not been written yet
 static int32_t loadPageFromDisk(SDiskbasedBuf* pBuf, SPageInfo* pg) {
-  int32_t ret = taosLSeekFile(pBuf->pFile, pg->offset, SEEK_SET);
-  if (ret == -1) {
-    ret = TAOS_SYSTEM_ERROR(errno);
-    return ret;
+  char*       pPage = GET_DATA_PAYLOAD(pg);
+  const char* pData = getPageBehind(pBuf, pg);
+  if (pData == NULL) {
+    pData = (pg->length == pBuf->pageSize) ? pPage : pBuf->assistBuf;
+    if (taosPReadFile(pBuf->pFile, (void*)pData, pg->length, pg->offset) != pg->length) {
+      return TAOS_SYSTEM_ERROR(errno);
+    }
+
+    pBuf->statis.loadBytes += pg->length;
+    pBuf->statis.loadPages += 1;
   }
 
-  void* pPage = (void*)GET_DATA_PAYLOAD(pg);
-  ret = (int32_t)taosReadFile(pBuf->pFile, pPage, pg->length);
-  if (ret != pg->length) {
-    ret = TAOS_SYSTEM_ERROR(errno);
-    return ret;
+  return doDecompressData(pData, pg->length, pPage, pBuf);
+}
+
+// Loads that go page by page, forwards or backwards, are followed by reading the next pages ahead, so that they are in
+// the page cache by the time they are asked for.
+static void readAheadPages(SDiskbasedBuf* pBuf, int32_t id) {
+  int32_t step = id - pBuf->lastId;
+  if (step == 0) {
+    return;
   }
 
-  pBuf->statis.loadBytes += pg->length;
-  pBuf->statis.loadPages += 1;
+  bool inRun = (step == pBuf->lastStep);
+  pBuf->lastId = id;
+  pBuf->lastStep = step;
+  if (step != 1 && step != -1) {
+    return;
+  }
 
-  int32_t fullSize = 0;
-  doDecompressData(pPage, pg->length, &fullSize, pBuf);
-  return 0;
+  // the pages before the last one are already on their way
+  int32_t num = (int32_t)taosArrayGetSize(pBuf->pIdList);
+  for (int32_t i = inRun ? READ_AHEAD_PAGES : 1; i <= READ_AHEAD_PAGES; ++i) {
+    int32_t next = id + step * i;
+    if (next < 0 || next >= num) {
+      break;
+    }
+
+    SPageInfo* pi = taosArrayGetP(pBuf->pIdList, next);
+    if (pi->pData == NULL && pi->offset >= 0 && pi->length > 0 && getPageBehind(pBuf, pi) == NULL) {
+      taosReadAheadFile(pBuf->pFile, pi->offset, pi->length);
+    }
+  }
 }
 
 static SPageInfo* registerPage(SDiskbasedBuf* pBuf, int32_t pageId) {
@@ -257,6 +439,8 @@ static SPageInfo* registerPage(SDiskbasedBuf* pBuf, int32_t pageId) {
   ppi->pageId = pageId;
   ppi->pData = NULL;
   ppi->offset = -1;
+  ppi->batchId = 0;
+  ppi->batchPos = 0;
   ppi->length = -1;
   ppi->used = true;
   ppi->pn = NULL;
@@ -351,6 +535,9 @@ int32_t createDiskbasedBuf(SDiskbasedBuf** pBuf, int32_t pagesize, int32_t inMem
   pPBuf->fileSize = 0;
   pPBuf->pFree = taosArrayInit(4, sizeof(SFreeListItem));
   pPBuf->freePgList = tdListNew(POINTER_BYTES);
+  pPBuf->comp = true;
+  taosThreadMutexInit(&pPBuf->mutex, NULL);
+  taosThreadCondInit(&pPBuf->cond, NULL);
 
   // at least more than 2 pages must be in memory
   ASSERT(inMemBufSize >= pagesize * 2);
@@ -427,6 +614,10 @@ void* getBufPage(SDiskbasedBuf* pBuf, int32_t id) {
   SPageInfo** pi = taosHashGet(pBuf->all, &id, sizeof(int32_t));
   ASSERT(pi != NULL && *pi != NULL);
 
+  if (pBuf->pFile != NULL) {
+    readAheadPages(pBuf, id);
+  }
+
   if ((*pi)->pData != NULL) {  // it is in memory
     // no need to update the LRU list if only one page exists
     if (pBuf->numOfPages == 1) {
@@ -515,6 +706,9 @@ void destroyDiskbasedBuf(SDiskbasedBuf* pBuf) {
 
   dBufPrintStatis(pBuf);
 
+  // the batch in the write pool may still use the file, the pages in the other one are dropped with it
+  waitBatchWritten(pBuf);
+
   bool needRemoveFile = false;
   if (pBuf->pFile != NULL) {
     needRemoveFile = true;
@@ -568,6 +762,13 @@ void destroyDiskbasedBuf(SDiskbasedBuf* pBuf) {
   taosArrayDestroy(pBuf->emptyDummyIdList);
   taosArrayDestroy(pBuf->pFree);
 
+  for (int32_t i = 0; i < tListLen(pBuf->batch); ++i) {
+    taosMemoryFreeClear(pBuf->batch[i].pData);
+    taosArrayDestroy(pBuf->batch[i].pWrites);
+  }
+  taosThreadCondDestroy(&pBuf->cond);
+  taosThreadMutexDestroy(&pBuf->mutex);
+
   taosHashCleanup(pBuf->all);
 
   taosMemoryFreeClear(pBuf->id);
@@ -645,6 +846,13 @@ void dBufPrintStatis(const SDiskbasedBuf* pBuf) {
 }
 
 void clearDiskbasedBuf(SDiskbasedBuf* pBuf) {
+  waitBatchWritten(pBuf);
+  for (int32_t i = 0; i < tListLen(pBuf->batch); ++i) {
+    if (pBuf->batch[i].pData != NULL) {
+      resetWriteBatch(pBuf, &pBuf->batch[i]);
+    }
+  }
+
   size_t n = taosArrayGetSize(pBuf->pIdList);
   for (int32_t i = 0; i < n; ++i) {
     SPageInfo* pi = taosArrayGetP(pBuf->pIdList, i);
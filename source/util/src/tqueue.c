@@ -21,6 +21,114 @@
 int64_t tsRpcQueueMemoryAllowed = 0;
 int64_t tsRpcQueueMemoryUsed = 0;
 
+static void taosQueuePush(STaosQueue *queue, STaosQnode *pNode) {
+  atomic_store_ptr(&pNode->next, NULL);
+  STaosQnode *prev = atomic_exchange_ptr(&queue->tail, pNode);
+  atomic_store_ptr(&prev->next, pNode);
+}
+
+// a producer has swapped the tail but not yet linked its node, the window is a few instructions wide
+static STaosQnode *taosQueueWaitNext(STaosQnode *pNode) {
+  STaosQnode *next = NULL;
+  int32_t     nLoops = 0;
+
+  while ((next = atomic_load_ptr(&pNode->next)) == NULL) {
+    nLoops++;
+    if (nLoops > 1000) {
+      sched_yield();
+      nLoops = 0;
+    }
+  }
+
+  return next;
+}
+
+static bool taosQueueIsIdle(STaosQueue *queue) {
+  return queue->head == queue->stub && atomic_load_ptr(&queue->tail) == queue->stub;
+}
+
+// shall be called by one consumer at a time, returns NULL only if no item was pushed before the call
+static STaosQnode *taosQueuePop(STaosQueue *queue) {
+  STaosQnode *stub = queue->stub;
+  STaosQnode *head = queue->head;
+
+  if (head == NULL) return NULL;
+  if (head == stub) {
+    if (atomic_load_ptr(&queue->tail) == stub) return NULL;
+    head = taosQueueWaitNext(stub);
+    queue->head = head;
+  }
+
+  if (atomic_load_ptr(&queue->tail) == head) {
+    // head is the last node, put the stub behind it so that head can be detached
+    taosQueuePush(queue, stub);
+  }
+
+  queue->head = taosQueueWaitNext(head);
+  return head;
+}
+
+// pop the items pushed before the call and link them into a list, the number of items is returned
+static int32_t taosQueuePopAll(STaosQueue *queue, STaosQnode **ppStart, int64_t *pMem) {
+  STaosQnode *last = atomic_load_ptr(&queue->tail);
+  STaosQnode *start = NULL;
+  STaosQnode *prev = NULL;
+  STaosQnode *pNode = NULL;
+  int32_t     numOfItems = 0;
+  int64_t     memOfItems = 0;
+
+  while ((pNode = taosQueuePop(queue)) != NULL) {
+    if (prev == NULL) {
+      start = pNode;
+    } else {
+      prev->next = pNode;
+    }
+    prev = pNode;
+    numOfItems++;
+    memOfItems += pNode->size;
+    if (pNode == last) break;
+  }
+
+  if (prev != NULL) prev->next = NULL;
+  *ppStart = start;
+  *pMem = memOfItems;
+  return numOfItems;
+}
+
+void taosQsetWakeup(STaosQset *qset) {
+  int32_t sleepers = atomic_load_32(&qset->numOfSleepers);
+  while (sleepers > 0) {
+    int32_t old = atomic_val_compare_exchange_32(&qset->numOfSleepers, sleepers, sleepers - 1);
+    if (old == sleepers) {
+      tsem_post(&qset->sem);
+      break;
+    }
+    sleepers = old;
+  }
+}
+
+// withdraw a registration made before sleeping, if a waker has taken it already, consume its post
+static void taosQsetCancelWait(STaosQset *qset) {
+  int32_t sleepers = atomic_load_32(&qset->numOfSleepers);
+  while (sleepers > 0) {
+    int32_t old = atomic_val_compare_exchange_32(&qset->numOfSleepers, sleepers, sleepers - 1);
+    if (old == sleepers) return;
+    sleepers = old;
+  }
+
+  tsem_wait(&qset->sem);
+}
+
+static bool taosQsetTakeResume(STaosQset *qset) {
+  int32_t resumes = atomic_load_32(&qset->numOfResumes);
+  while (resumes > 0) {
+    int32_t old = atomic_val_compare_exchange_32(&qset->numOfResumes, resumes, resumes - 1);
+    if (old == resumes) return true;
+    resumes = old;
+  }
+  return false;
+}
+
 STaosQueue *taosOpenQueue() {
   STaosQueue *queue = taosMemoryCalloc(1, sizeof(STaosQueue));
   if (queue == NULL) {
@@ -28,7 +136,18 @@ STaosQueue *taosOpenQueue() {
     return NULL;
   }
 
+  queue->stub = taosMemoryCalloc(1, sizeof(STaosQnode));
+  if (queue->stub == NULL) {
+    taosMemoryFree(queue);
+    terrno = TSDB_CODE_OUT_OF_MEMORY;
+    return NULL;
+  }
+  queue->head = queue->stub;
+  queue->tail = queue->stub;
+
   if (taosThreadMutexInit(&queue->mutex, NULL) != 0) {
+    taosMemoryFree(queue->stub);
+    taosMemoryFree(queue);
     terrno = TSDB_CODE_OUT_OF_MEMORY;
     return NULL;
   }
@@ -48,22 +167,24 @@ void taosCloseQueue(STaosQueue *queue) {
   STaosQnode *pTemp;
   STaosQset  *qset;
 
+  // detach from the qset first, so that qset readers no longer look into the list
+  qset = queue->qset;
+  if (qset) {
+    taosRemoveFromQset(qset, queue);
+  }
+
   taosThreadMutexLock(&queue->mutex);
   STaosQnode *pNode = queue->head;
   queue->head = NULL;
-  qset = queue->qset;
   taosThreadMutexUnlock(&queue->mutex);
 
-  if (queue->qset) {
-    taosRemoveFromQset(qset, queue);
-  }
-
   while (pNode) {
     pTemp = pNode;
     pNode = pNode->next;
-    taosMemoryFree(pTemp);
+    if (pTemp != queue->stub) taosMemoryFree(pTemp);
   }
 
+  taosMemoryFree(queue->stub);
   taosThreadMutexDestroy(&queue->mutex);
   taosMemoryFree(queue);
 
@@ -72,42 +193,23 @@ void taosCloseQueue(STaosQueue *queue) {
 
 bool taosQueueEmpty(STaosQueue *queue) {
   if (queue == NULL) return true;
-
-  bool empty = false;
-  taosThreadMutexLock(&queue->mutex);
-  if (queue->head == NULL && queue->tail == NULL && queue->numOfItems == 0 && queue->memOfItems == 0) {
-    empty = true;
-  }
-  taosThreadMutexUnlock(&queue->mutex);
-
-  return empty;
+  return atomic_load_32(&queue->numOfItems) == 0 && atomic_load_64(&queue->memOfItems) == 0;
 }
 
 void taosUpdateItemSize(STaosQueue *queue, int32_t items) {
   if (queue == NULL) return;
-
-  taosThreadMutexLock(&queue->mutex);
-  queue->numOfItems -= items;
-  taosThreadMutexUnlock(&queue->mutex);
+  atomic_sub_fetch_32(&queue->numOfItems, items);
 }
 
 int32_t taosQueueItemSize(STaosQueue *queue) {
   if (queue == NULL) return 0;
 
-  taosThreadMutexLock(&queue->mutex);
-  int32_t numOfItems = queue->numOfItems;
-  taosThreadMutexUnlock(&queue->mutex);
-
-  uTrace("queue:%p, numOfItems:%d memOfItems:%" PRId64, queue, queue->numOfItems, queue->memOfItems);
+  int32_t numOfItems = atomic_load_32(&queue->numOfItems);
+  uTrace("queue:%p, numOfItems:%d memOfItems:%" PRId64, queue, numOfItems, atomic_load_64(&queue->memOfItems));
   return numOfItems;
 }
 
-int64_t taosQueueMemorySize(STaosQueue *queue) {
-  taosThreadMutexLock(&queue->mutex);
-  int64_t memOfItems = queue->memOfItems;
-  taosThreadMutexUnlock(&queue->mutex);
-  return memOfItems;
-}
+int64_t taosQueueMemorySize(STaosQueue *queue) { return atomic_load_64(&queue->memOfItems); }
 
 void *taosAllocateQitem(int32_t size, EQItype itype, int64_t dataSize) {
   STaosQnode *pNode = taosMemoryCalloc(1, sizeof(STaosQnode) + size);
@@ -155,26 +257,18 @@ void taosFreeQitem(void *pItem) {
 
 void taosWriteQitem(STaosQueue *queue, void *pItem) {
   STaosQnode *pNode = (STaosQnode *)(((char *)pItem) - sizeof(STaosQnode));
-  pNode->next = NULL;
 
-  taosThreadMutexLock(&queue->mutex);
+  // count the item before it becomes visible, so a reader never drives the counters negative
+  int32_t numOfItems = atomic_add_fetch_32(&queue->numOfItems, 1);
+  int64_t memOfItems = atomic_add_fetch_64(&queue->memOfItems, pNode->size);
+  taosQueuePush(queue, pNode);
+  uTrace("item:%p is put into queue:%p, items:%d mem:%" PRId64, pItem, queue, numOfItems, memOfItems);
 
-  if (queue->tail) {
-    queue->tail->next = pNode;
-    queue->tail = pNode;
-  } else {
-    queue->head = pNode;
-    queue->tail = pNode;
+  STaosQset *qset = atomic_load_ptr(&queue->qset);
+  if (qset) {
+    atomic_add_fetch_32(&qset->numOfItems, 1);
+    taosQsetWakeup(qset);
   }
-
-  queue->numOfItems++;
-  queue->memOfItems += pNode->size;
-  if (queue->qset) atomic_add_fetch_32(&queue->qset->numOfItems, 1);
-  uTrace("item:%p is put into queue:%p, items:%d mem:%" PRId64, pItem, queue, queue->numOfItems, queue->memOfItems);
-
-  taosThreadMutexUnlock(&queue->mutex);
-
-  if (queue->qset) tsem_post(&queue->qset->sem);
 }
 
 int32_t taosReadQitem(STaosQueue *queue, void **ppItem) {
@@ -183,17 +277,14 @@ int32_t taosReadQitem(STaosQueue *queue, void **ppItem) {
 
   taosThreadMutexLock(&queue->mutex);
 
-  if (queue->head) {
-    pNode = queue->head;
+  pNode = taosQueuePop(queue);
+  if (pNode) {
     *ppItem = pNode->item;
-    queue->head = pNode->next;
-    if (queue->head == NULL) queue->tail = NULL;
-    queue->numOfItems--;
-    queue->memOfItems -= pNode->size;
+    int32_t numOfItems = atomic_sub_fetch_32(&queue->numOfItems, 1);
+    int64_t memOfItems = atomic_sub_fetch_64(&queue->memOfItems, pNode->size);
     if (queue->qset) atomic_sub_fetch_32(&queue->qset->numOfItems, 1);
     code = 1;
-    uTrace("item:%p is read out from queue:%p, items:%d mem:%" PRId64, *ppItem, queue, queue->numOfItems,
-           queue->memOfItems);
+    uTrace("item:%p is read out from queue:%p, items:%d mem:%" PRId64, *ppItem, queue, numOfItems, memOfItems);
   }
 
   taosThreadMutexUnlock(&queue->mutex);
@@ -212,36 +303,27 @@ STaosQall *taosAllocateQall() {
 void taosFreeQall(STaosQall *qall) { taosMemoryFree(qall); }
 
 int32_t taosReadAllQitems(STaosQueue *queue, STaosQall *qall) {
-  int32_t numOfItems = 0;
-  bool    empty;
+  STaosQnode *start = NULL;
+  int64_t     memOfItems = 0;
+  int32_t     numOfItems = 0;
 
   taosThreadMutexLock(&queue->mutex);
 
-  empty = queue->head == NULL;
-  if (!empty) {
-    memset(qall, 0, sizeof(STaosQall));
-    qall->current = queue->head;
-    qall->start = queue->head;
-    qall->numOfItems = queue->numOfItems;
-    numOfItems = qall->numOfItems;
-
-    queue->head = NULL;
-    queue->tail = NULL;
-    queue->numOfItems = 0;
-    queue->memOfItems = 0;
+  numOfItems = taosQueuePopAll(queue, &start, &memOfItems);
+  if (numOfItems > 0) {
+    atomic_sub_fetch_32(&queue->numOfItems, numOfItems);
+    atomic_sub_fetch_64(&queue->memOfItems, memOfItems);
+    if (queue->qset) atomic_sub_fetch_32(&queue->qset->numOfItems, numOfItems);
     uTrace("read %d items from queue:%p, items:%d mem:%" PRId64, numOfItems, queue, queue->numOfItems,
            queue->memOfItems);
-    if (queue->qset) atomic_sub_fetch_32(&queue->qset->numOfItems, qall->numOfItems);
   }
 
   taosThreadMutexUnlock(&queue->mutex);
 
   // if source queue is empty, we set destination qall to empty too.
-  if (empty) {
-    qall->current = NULL;
-    qall->start = NULL;
-    qall->numOfItems = 0;
-  }
+  qall->current = start;
+  qall->start = start;
+  qall->numOfItems = numOfItems;
   return numOfItems;
 }
 
@@ -297,12 +379,12 @@ void taosCloseQset(STaosQset *qset) {
   uDebug("qset:%p is closed", qset);
 }
 
-// tsem_post 'qset->sem', so that reader threads waiting for it
-// resumes execution and return, should only be used to signal the
-// thread to exit.
+// make one reader thread return 0 once the queues are drained, should
+// only be used to signal the thread to exit.
 void taosQsetThreadResume(STaosQset *qset) {
   uDebug("qset:%p, it will exit", qset);
-  tsem_post(&qset->sem);
+  atomic_add_fetch_32(&qset->numOfResumes, 1);
+  taosQsetWakeup(qset);
 }
 
 int32_t taosAddIntoQset(STaosQset *qset, STaosQueue *queue, void *ahandle) {
@@ -317,11 +399,14 @@ int32_t taosAddIntoQset(STaosQset *qset, STaosQueue *queue, void *ahandle) {
 
   taosThreadMutexLock(&queue->mutex);
   atomic_add_fetch_32(&qset->numOfItems, queue->numOfItems);
-  queue->qset = qset;
+  atomic_store_ptr(&queue->qset, qset);
   taosThreadMutexUnlock(&queue->mutex);
 
   taosThreadMutexUnlock(&qset->mutex);
 
+  // items written before the queue joined the qset did not wake anyone
+  if (!taosQueueIsIdle(queue)) taosQsetWakeup(qset);
+
   uTrace("queue:%p is added into qset:%p", queue, qset);
   return 0;
 }
@@ -356,7 +441,7 @@ void taosRemoveFromQset(STaosQset *qset, STaosQueue *queue) {
 
       taosThreadMutexLock(&queue->mutex);
       atomic_sub_fetch_32(&qset->numOfItems, queue->numOfItems);
-      queue->qset = NULL;
+      atomic_store_ptr(&queue->qset, NULL);
       queue->next = NULL;
       taosThreadMutexUnlock(&queue->mutex);
     }
@@ -367,12 +452,10 @@ void taosRemoveFromQset(STaosQset *qset, STaosQueue *queue) {
   uDebug("queue:%p is removed from qset:%p", queue, qset);
 }
 
-int32_t taosReadQitemFromQset(STaosQset *qset, void **ppItem, SQueueInfo *qinfo) {
+int32_t taosTryReadQitemFromQset(STaosQset *qset, void **ppItem, SQueueInfo *qinfo) {
   STaosQnode *pNode = NULL;
   int32_t     code = 0;
 
-  tsem_wait(&qset->sem);
-
   taosThreadMutexLock(&qset->mutex);
 
   for (int32_t i = 0; i < qset->numOfQueues; ++i) {
@@ -380,26 +463,24 @@ int32_t taosReadQitemFromQset(STaosQset *qset, void **ppItem, SQueueInfo *qinfo)
     STaosQueue *queue = qset->current;
     if (queue) qset->current = queue->next;
     if (queue == NULL) break;
-    if (queue->head == NULL) continue;
+    if (taosQueueIsIdle(queue)) continue;
 
     taosThreadMutexLock(&queue->mutex);
 
-    if (queue->head) {
-      pNode = queue->head;
+    pNode = taosQueuePop(queue);
+    if (pNode) {
       *ppItem = pNode->item;
       qinfo->ahandle = queue->ahandle;
       qinfo->fp = queue->itemFp;
       qinfo->queue = queue;
       qinfo->timestamp = pNode->timestamp;
 
-      queue->head = pNode->next;
-      if (queue->head == NULL) queue->tail = NULL;
       // queue->numOfItems--;
-      queue->memOfItems -= pNode->size;
+      int64_t memOfItems = atomic_sub_fetch_64(&queue->memOfItems, pNode->size);
       atomic_sub_fetch_32(&qset->numOfItems, 1);
       code = 1;
       uTrace("item:%p is read out from queue:%p, items:%d mem:%" PRId64, *ppItem, queue, queue->numOfItems - 1,
-             queue->memOfItems);
+             memOfItems);
     }
 
     taosThreadMutexUnlock(&queue->mutex);
@@ -411,11 +492,12 @@ int32_t taosReadQitemFromQset(STaosQset *qset, void **ppItem, SQueueInfo *qinfo)
   return code;
 }
 
-int32_t taosReadAllQitemsFromQset(STaosQset *qset, STaosQall *qall, SQueueInfo *qinfo) {
+static int32_t taosReadAllQitemsFromQsetImp(STaosQset *qset, STaosQall *qall, SQueueInfo *qinfo) {
   STaosQueue *queue;
+  STaosQnode *start = NULL;
+  int64_t     memOfItems = 0;
   int32_t     code = 0;
 
-  tsem_wait(&qset->sem);
   taosThreadMutexLock(&qset->mutex);
 
   for (int32_t i = 0; i < qset->numOfQueues; ++i) {
@@ -423,29 +505,24 @@ int32_t taosReadAllQitemsFromQset(STaosQset *qset, STaosQall *qall, SQueueInfo *
     queue = qset->current;
     if (queue) qset->current = queue->next;
     if (queue == NULL) break;
-    if (queue->head == NULL) continue;
+    if (taosQueueIsIdle(queue)) continue;
 
     taosThreadMutexLock(&queue->mutex);
 
-    if (queue->head) {
-      qall->current = queue->head;
-      qall->start = queue->head;
-      qall->numOfItems = queue->numOfItems;
-      code = qall->numOfItems;
+    code = taosQueuePopAll(queue, &start, &memOfItems);
+    if (code > 0) {
+      qall->current = start;
+      qall->start = start;
+      qall->numOfItems = code;
       qinfo->ahandle = queue->ahandle;
       qinfo->fp = queue->itemsFp;
       qinfo->queue = queue;
 
-      queue->head = NULL;
-      queue->tail = NULL;
-      // queue->numOfItems = 0;
-      queue->memOfItems = 0;
+      // queue->numOfItems -= code;
+      atomic_sub_fetch_64(&queue->memOfItems, memOfItems);
       uTrace("read %d items from queue:%p, items:0 mem:%" PRId64, code, queue, queue->memOfItems);
 
-      atomic_sub_fetch_32(&qset->numOfItems, qall->numOfItems);
-      for (int32_t j = 1; j < qall->numOfItems; ++j) {
-        tsem_wait(&qset->sem);
-      }
+      atomic_sub_fetch_32(&qset->numOfItems, code);
     }
 
     taosThreadMutexUnlock(&queue->mutex);
@@ -457,6 +534,83 @@ int32_t taosReadAllQitemsFromQset(STaosQset *qset, STaosQall *qall, SQueueInfo *
   return code;
 }
 
+// Readers register in numOfSleepers and scan the queues once more before sleeping, writers only post the
+// semaphore if a reader is registered. A busy qset therefore costs no system call per item, and a burst
+// of items wakes one reader per item at most.
+int32_t taosReadQitemFromQset(STaosQset *qset, void **ppItem, SQueueInfo *qinfo) {
+  bool registered = false;
+
+  while (1) {
+    int32_t code = taosTryReadQitemFromQset(qset, ppItem, qinfo);
+    if (code == 0 && taosQsetTakeResume(qset)) code = -1;
+    if (code != 0) {
+      if (registered) taosQsetCancelWait(qset);
+      return code > 0 ? code : 0;
+    }
+
+    if (!registered) {
+      atomic_add_fetch_32(&qset->numOfSleepers, 1);
+      registered = true;
+    } else {
+      tsem_wait(&qset->sem);
+      registered = false;
+    }
+  }
+}
+
+int32_t taosReadAllQitemsFromQset(STaosQset *qset, STaosQall *qall, SQueueInfo *qinfo) {
+  bool registered = false;
+
+  while (1) {
+    int32_t code = taosReadAllQitemsFromQsetImp(qset, qall, qinfo);
+    if (code == 0 && taosQsetTakeResume(qset)) code = -1;
+    if (code != 0) {
+      if (registered) taosQsetCancelWait(qset);
+      return code > 0 ? code : 0;
+    }
+
+    if (!registered) {
+      atomic_add_fetch_32(&qset->numOfSleepers, 1);
+      registered = true;
+    } else {
+      tsem_wait(&qset->sem);
+      registered = false;
+    }
+  }
+}
+
+static bool taosQsetHasItems(STaosQset *qset) {
+  bool hasItems = false;
+
+  taosThreadMutexLock(&qset->mutex);
+  for (STaosQueue *queue = qset->head; queue != NULL; queue = queue->next) {
+    if (!taosQueueIsIdle(queue)) {
+      hasItems = true;
+      break;
+    }
+  }
+  taosThreadMutexUnlock(&qset->mutex);
+
+  return hasItems;
+}
+
+int32_t taosWaitQset(STaosQset *qset, FPending pendingFp, void *param) {
+  atomic_add_fetch_32(&qset->numOfSleepers, 1);
+
+  if (taosQsetHasItems(qset) || (pendingFp != NULL && (*pendingFp)(param))) {
+    taosQsetCancelWait(qset);
+    return 1;
+  }
+
+  if (taosQsetTakeResume(qset)) {
+    taosQsetCancelWait(qset);
+    return 0;
+  }
+
+  tsem_wait(&qset->sem);
+  return 1;
+}
+
 int32_t taosQallItemSize(STaosQall *qall) { return qall->numOfItems; }
 void    taosResetQitems(STaosQall *qall) { qall->current = qall->start; }
 int32_t taosGetQueueNumber(STaosQset *qset) { return qset->numOfQueues; }
@@ -20,6 +20,9 @@
 
 typedef void *(*ThreadFp)(void *param);
 
+#define QWORKER_DEQUE_INIT_SIZE 64
+#define QWORKER_MAX_HIGH_IN_ROW 8  // the low lane is looked at first after so many high lane items
+
 int32_t tQWorkerInit(SQWorkerPool *pool) {
   pool->qset = taosOpenQset();
   pool->workers = taosMemoryCalloc(pool->max, sizeof(SQWorker));
@@ -34,6 +37,9 @@ int32_t tQWorkerInit(SQWorkerPool *pool) {
     SQWorker *worker = pool->workers + i;
     worker->id = i;
     worker->pool = pool;
+    for (int32_t lane = 0; lane < QWORKER_LANE_MAX; ++lane) {
+      (void)taosThreadMutexInit(&worker->lanes[lane].mutex, NULL);
+    }
   }
 
   uInfo("worker:%s is initialized, min:%d max:%d", pool->name, pool->min, pool->max);
@@ -58,6 +64,18 @@ void tQWorkerCleanup(SQWorkerPool *pool) {
     }
   }
 
+  for (int32_t i = 0; i < pool->max; ++i) {
+    SQWorker *worker = pool->workers + i;
+    for (int32_t lane = 0; lane < QWORKER_LANE_MAX; ++lane) {
+      SQWorkDeque *deque = &worker->lanes[lane];
+      if (deque->size > 0) {
+        uWarn("worker:%s:%d, %d items left in lane %d", pool->name, worker->id, deque->size, lane);
+      }
+      taosMemoryFreeClear(deque->items);
+      taosThreadMutexDestroy(&deque->mutex);
+    }
+  }
+
   taosMemoryFreeClear(pool->workers);
   taosCloseQset(pool->qset);
   taosThreadMutexDestroy(&pool->mutex);
@@ -65,11 +83,144 @@ void tQWorkerCleanup(SQWorkerPool *pool) {
   uInfo("worker:%s is closed", pool->name);
 }
 
+static int32_t tQWorkerPushItem(SQWorkDeque *deque, SQWorkItem *pItem) {
+  int32_t code = 0;
+
+  taosThreadMutexLock(&deque->mutex);
+
+  if (deque->size >= deque->capacity) {
+    int32_t     capacity = deque->capacity > 0 ? deque->capacity * 2 : QWORKER_DEQUE_INIT_SIZE;
+    SQWorkItem *items = taosMemoryMalloc(capacity * sizeof(SQWorkItem));
+    if (items == NULL) {
+      terrno = TSDB_CODE_OUT_OF_MEMORY;
+      code = -1;
+      goto _OVER;
+    }
+
+    for (int32_t i = 0; i < deque->size; ++i) {
+      items[i] = deque->items[(deque->head + i) % deque->capacity];
+    }
+    taosMemoryFree(deque->items);
+    deque->items = items;
+    deque->capacity = capacity;
+    deque->head = 0;
+  }
+
+  deque->items[(deque->head + deque->size) % deque->capacity] = *pItem;
+  atomic_add_fetch_32(&deque->size, 1);
+
+_OVER:
+  taosThreadMutexUnlock(&deque->mutex);
+  return code;
+}
+
+static bool tQWorkerPopItem(SQWorkDeque *deque, SQWorkItem *pItem, bool steal) {
+  if (atomic_load_32(&deque->size) == 0) return false;
+
+  bool found = false;
+  taosThreadMutexLock(&deque->mutex);
+  if (deque->size > 0) {
+    if (steal) {
+      *pItem = deque->items[(deque->head + deque->size - 1) % deque->capacity];
+    } else {
+      *pItem = deque->items[deque->head];
+      deque->head = (deque->head + 1) % deque->capacity;
+    }
+    atomic_sub_fetch_32(&deque->size, 1);
+    found = true;
+  }
+  taosThreadMutexUnlock(&deque->mutex);
+
+  return found;
+}
+
+// own deque first, then steal from the other workers
+static bool tQWorkerGetItem(SQWorker *worker, int32_t lane, SQWorkItem *pItem) {
+  SQWorkerPool *pool = worker->pool;
+  if (tQWorkerPopItem(&worker->lanes[lane], pItem, false)) return true;
+
+  int32_t num = atomic_load_32(&pool->num);
+  for (int32_t i = 1; i < num; ++i) {
+    SQWorker *victim = pool->workers + (worker->id + i) % num;
+    if (tQWorkerPopItem(&victim->lanes[lane], pItem, true)) {
+      // the victim is busy and has more, let another idle worker come over
+      if (atomic_load_32(&victim->lanes[lane].size) > 0) taosQsetWakeup(pool->qset);
+      uTrace("worker:%s:%d, item:%p is stolen from worker:%d", pool->name, worker->id, pItem->pItem, victim->id);
+      return true;
+    }
+  }
+
+  return false;
+}
+
+// move up to one item per worker from the qset into the lanes of their home workers
+static int32_t tQWorkerFetchItems(SQWorker *worker) {
+  SQWorkerPool *pool = worker->pool;
+  int32_t       num = atomic_load_32(&pool->num);
+  int32_t       fetched = 0;
+  SQWorkItem    item = {0};
+
+  while (fetched < num && taosTryReadQitemFromQset(pool->qset, &item.pItem, &item.qinfo) != 0) {
+    SQWorker *home = worker;
+    int64_t   affinity = 0;
+
+    item.lane = QWORKER_LANE_HIGH;
+    if (pool->laneFp != NULL) {
+      item.lane = (*pool->laneFp)(item.pItem, &affinity);
+      if (item.lane < 0 || item.lane >= QWORKER_LANE_MAX) item.lane = QWORKER_LANE_LOW;
+      if (affinity != 0 && num > 0) home = pool->workers + (uint64_t)affinity % num;
+    }
+
+    if (tQWorkerPushItem(&home->lanes[item.lane], &item) != 0 &&
+        tQWorkerPushItem(&worker->lanes[item.lane], &item) != 0) {
+      uFatal("worker:%s:%d, failed to queue item:%p since %s", pool->name, worker->id, item.pItem, terrstr());
+      continue;
+    }
+
+    fetched++;
+    // the reading worker takes one item itself, every other one may keep an idle worker busy
+    if (home != worker || fetched > 1) taosQsetWakeup(pool->qset);
+  }
+
+  return fetched;
+}
+
+static bool tQWorkerNextItem(SQWorker *worker, SQWorkItem *pItem, int32_t *pFetched) {
+  bool highFirst = worker->highInRow < QWORKER_MAX_HIGH_IN_ROW;
+
+  *pFetched = 0;
+  if (highFirst && tQWorkerGetItem(worker, QWORKER_LANE_HIGH, pItem)) {
+    worker->highInRow++;
+    return true;
+  }
+
+  *pFetched = tQWorkerFetchItems(worker);
+  if (highFirst && *pFetched > 0 && tQWorkerGetItem(worker, QWORKER_LANE_HIGH, pItem)) {
+    worker->highInRow++;
+    return true;
+  }
+
+  worker->highInRow = 0;
+  if (tQWorkerGetItem(worker, QWORKER_LANE_LOW, pItem)) return true;
+  if (!highFirst && tQWorkerGetItem(worker, QWORKER_LANE_HIGH, pItem)) return true;
+
+  return false;
+}
+
+static bool tQWorkerHasPending(SQWorkerPool *pool) {
+  int32_t num = atomic_load_32(&pool->num);
+  for (int32_t i = 0; i < num; ++i) {
+    for (int32_t lane = 0; lane < QWORKER_LANE_MAX; ++lane) {
+      if (atomic_load_32(&pool->workers[i].lanes[lane].size) > 0) return true;
+    }
+  }
+  return false;
+}
+
 static void *tQWorkerThreadFp(SQWorker *worker) {
   SQWorkerPool *pool = worker->pool;
-  SQueueInfo    qinfo = {0};
-  void         *msg = NULL;
-  int32_t       code = 0;
+  SQWorkItem    item = {0};
+  int32_t       fetched = 0;
 
   taosBlockSIGPIPE();
   setThreadName(pool->name);
@@ -77,19 +228,24 @@ static void *tQWorkerThreadFp(SQWorker *worker) {
   uInfo("worker:%s:%d is running, thread:%08" PRId64, pool->name, worker->id, worker->pid);
 
   while (1) {
-    if (taosReadQitemFromQset(pool->qset, (void **)&msg, &qinfo) == 0) {
-      uInfo("worker:%s:%d qset:%p, got no message and exiting, thread:%08" PRId64, pool->name, worker->id, pool->qset,
-            worker->pid);
-      break;
+    if (!tQWorkerNextItem(worker, &item, &fetched)) {
+      if (fetched > 0) continue;
+      if (taosWaitQset(pool->qset, (FPending)tQWorkerHasPending, pool) == 0) {
+        uInfo("worker:%s:%d qset:%p, got no message and exiting, thread:%08" PRId64, pool->name, worker->id,
+              pool->qset, worker->pid);
+        break;
+      }
+      continue;
     }
 
-    if (qinfo.fp != NULL) {
-      qinfo.workerId = worker->id;
-      qinfo.threadNum = pool->num;
-      (*((FItem)qinfo.fp))(&qinfo, msg);
+    SQueueInfo *qinfo = &item.qinfo;
+    if (qinfo->fp != NULL) {
+      qinfo->workerId = worker->id;
+      qinfo->threadNum = pool->num;
+      (*((FItem)qinfo->fp))(qinfo, item.pItem);
     }
 
-    taosUpdateItemSize(qinfo.queue, 1);
+    taosUpdateItemSize(qinfo->queue, 1);
   }
 
   return NULL;
@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Decompression throughput of the scalar and SIMD decoders, in GB/s of decoded output.
+// usage: decompressBench [-n rows] [-l loops]
+
+#include "os.h"
+#include "tcompression.h"
+
+typedef int32_t (*FCodec)(void *pIn, int32_t nIn, int32_t nEle, void *pOut, int32_t nOut, uint8_t cmprAlg, void *pBuf,
+                          int32_t nBuf);
+
+typedef struct {
+  const char *name;
+  int32_t     bytes;
+  FCodec      compress;
+  FCodec      decompress;
+} SCodecCase;
+
+static void genData(const char *name, void *pData, int32_t nRows) {
+  int64_t v = 0;
+  double  d = 20.0;
+  for (int32_t i = 0; i < nRows; i++) {
+    if (strcmp(name, "bigint") == 0) {
+      v += taosRand() % 64;
+      ((int64_t *)pData)[i] = v;
+    } else if (strcmp(name, "int") == 0) {
+      ((int32_t *)pData)[i] = taosRand() % 4096;
+    } else if (strcmp(name, "timestamp") == 0) {
+      ((int64_t *)pData)[i] = 1600000000000 + (int64_t)i * 1000 + (taosRand() % 5 == 0 ? taosRand() % 10 : 0);
+    } else if (strcmp(name, "double") == 0) {
+      d += (taosRand() % 100) / 100.0;
+      ((double *)pData)[i] = d;
+    } else {
+      d += (taosRand() % 100) / 100.0;
+      ((float *)pData)[i] = (float)d;
+    }
+  }
+}
+
+static double benchOne(SCodecCase *pCase, char *pComp, int32_t len, int32_t nRows, char *pOut, char *pBuf, int32_t nBuf,
+                       int32_t loops) {
+  int32_t bytes = pCase->bytes * nRows;
+  int64_t st = taosGetTimestampUs();
+  for (int32_t i = 0; i < loops; i++) {
+    pCase->decompress(pComp, len, nRows, pOut, bytes, ONE_STAGE_COMP, pBuf, nBuf);
+  }
+  int64_t cost = taosGetTimestampUs() - st;
+  if (cost <= 0) cost = 1;
+  return (double)bytes * loops / cost / 1000.0;
+}
+
+int main(int argc, char *argv[]) {
+  int32_t nRows = 4096;
+  int32_t loops = 20000;
+  for (int32_t i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "-n") == 0 && i < argc - 1) {
+      nRows = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-l") == 0 && i < argc - 1) {
+      loops = atoi(argv[++i]);
+    } else {
+      printf("usage: %s [-n rows] [-l loops]\n", argv[0]);
+      return 0;
+    }
+  }
+
+  char sse42 = 0, avx = 0, fma = 0;
+  taosGetCpuInstructions(&sse42, &avx, &tsAVX2Enable, &fma, &tsAVX512Enable);
+  taosSeedRand((uint32_t)taosGetTimestampSec());
+
+  SCodecCase cases[] = {
+      {"bigint", sizeof(int64_t), tsCompressBigint, tsDecompressBigint},
+      {"int", sizeof(int32_t), tsCompressInt, tsDecompressInt},
+      {"timestamp", sizeof(int64_t), tsCompressTimestamp, tsDecompressTimestamp},
+      {"double", sizeof(double), tsCompressDouble, tsDecompressDouble},
+      {"float", sizeof(float), tsCompressFloat, tsDecompressFloat},
+  };
+
+  int32_t nBuf = sizeof(int64_t) * nRows * 2 + COMP_OVERFLOW_BYTES;
+  char   *pData = taosMemoryMalloc(nBuf);
+  char   *pComp = taosMemoryMalloc(nBuf);
+  char   *pOut = taosMemoryMalloc(nBuf);
+  char   *pBuf = taosMemoryMalloc(nBuf);
+  if (pData == NULL || pComp == NULL || pOut == NULL || pBuf == NULL) {
+    printf("failed to alloc %d bytes\n", nBuf);
+    return -1;
+  }
+
+  printf("rows:%d loops:%d avx2:%d avx512:%d\n", nRows, loops, tsAVX2Enable, tsAVX512Enable);
+  printf("%-10s %8s %12s %12s\n", "codec", "ratio", "scalar GB/s", "simd GB/s");
+  for (int32_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+    SCodecCase *pCase = &cases[i];
+    genData(pCase->name, pData, nRows);
+    int32_t len = pCase->compress(pData, pCase->bytes * nRows, nRows, pComp, nBuf, ONE_STAGE_COMP, pBuf, nBuf);
+
+    tsSIMDBuiltins = 0;
+    double scalar = benchOne(pCase, pComp, len, nRows, pOut, pBuf, nBuf, loops);
+    tsSIMDBuiltins = 1;
+    double simd = benchOne(pCase, pComp, len, nRows, pOut, pBuf, nBuf, loops);
+
+    printf("%-10s %8.2f %12.2f %12.2f\n", pCase->name, (double)pCase->bytes * nRows / len, scalar, simd);
+  }
+
+  taosMemoryFree(pData);
+  taosMemoryFree(pComp);
+  taosMemoryFree(pOut);
+  taosMemoryFree(pBuf);
+  return 0;
+}
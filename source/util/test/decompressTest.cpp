@@ -0,0 +1,146 @@
+#include <gtest/gtest.h>
+#include <stdlib.h>
+
+#include "tcompression.h"
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wwrite-strings"
+#pragma GCC diagnostic ignored "-Wunused-function"
+#pragma GCC diagnostic ignored "-Wunused-variable"
+#pragma GCC diagnostic ignored "-Wsign-compare"
+
+namespace {
+
+const int32_t kNumOfRows = 4099;  // not a multiple of any selector width, exercises the tails
+
+typedef int32_t (*CompFn)(void *, int32_t, int32_t, void *, int32_t, uint8_t, void *, int32_t);
+
+void genBigint(int64_t *pData, int32_t n, int32_t seed) {
+  taosSeedRand(seed);
+  int64_t v = taosRand();
+  for (int32_t i = 0; i < n; i++) {
+    switch (seed % 4) {
+      case 0:
+        v += taosRand() % 8;  // small deltas, wide selectors
+        break;
+      case 1:
+        v -= taosRand() % 100000;
+        break;
+      case 2:
+        v = ((int64_t)taosRand() << 31) ^ taosRand();  // incompressible, raw fallback
+        break;
+      default:
+        v = (i % 100 < 50) ? 7 : v + taosRand() % 3;  // long runs, selector 0/1
+        break;
+    }
+    pData[i] = v;
+  }
+}
+
+void genTimestamp(int64_t *pData, int32_t n, int32_t seed) {
+  taosSeedRand(seed);
+  int64_t ts = 1600000000000;
+  for (int32_t i = 0; i < n; i++) {
+    ts += (seed % 2) ? 1000 : (taosRand() % 2000 - 10);
+    pData[i] = ts;
+  }
+}
+
+template <typename T>
+void genReal(T *pData, int32_t n, int32_t seed) {
+  taosSeedRand(seed);
+  T v = 20.0;
+  for (int32_t i = 0; i < n; i++) {
+    if (seed % 2) {
+      v += (T)(taosRand() % 100) / 100;
+    } else if (taosRand() % 4 != 0) {
+      v = (T)(taosRand() % 8);
+    }
+    pData[i] = v;
+  }
+}
+
+// Decompress the same payload with SIMD builtins off and on and require identical output.
+void checkSame(CompFn compFn, CompFn decompFn, void *pIn, int32_t bytes, int32_t n) {
+  char   *pComp = (char *)taosMemoryMalloc(bytes * 2 + 64);
+  char   *pBuf = (char *)taosMemoryMalloc(bytes * 2 + 64);
+  char   *pScalar = (char *)taosMemoryCalloc(1, bytes + 64);
+  char   *pSimd = (char *)taosMemoryCalloc(1, bytes + 64);
+  int32_t len = compFn(pIn, bytes, n, pComp, bytes * 2 + 64, ONE_STAGE_COMP, pBuf, bytes * 2 + 64);
+  ASSERT_GT(len, 0);
+
+  char simd = tsSIMDBuiltins;
+  tsSIMDBuiltins = 0;
+  ASSERT_EQ(decompFn(pComp, len, n, pScalar, bytes, ONE_STAGE_COMP, pBuf, bytes * 2 + 64), bytes);
+  tsSIMDBuiltins = 1;
+  ASSERT_EQ(decompFn(pComp, len, n, pSimd, bytes, ONE_STAGE_COMP, pBuf, bytes * 2 + 64), bytes);
+  tsSIMDBuiltins = simd;
+
+  ASSERT_EQ(memcmp(pIn, pScalar, bytes), 0);
+  ASSERT_EQ(memcmp(pScalar, pSimd, bytes), 0);
+
+  taosMemoryFree(pComp);
+  taosMemoryFree(pBuf);
+  taosMemoryFree(pScalar);
+  taosMemoryFree(pSimd);
+}
+
+}  // namespace
+
+class DecompressTest : public ::testing::Test {
+ protected:
+  static void SetUpTestSuite() {
+    char sse42, avx, fma;
+    taosGetCpuInstructions(&sse42, &avx, &tsAVX2Enable, &fma, &tsAVX512Enable);
+  }
+};
+
+TEST_F(DecompressTest, bigint) {
+  int64_t *pData = (int64_t *)taosMemoryMalloc(sizeof(int64_t) * kNumOfRows);
+  for (int32_t seed = 0; seed < 16; seed++) {
+    genBigint(pData, kNumOfRows, seed);
+    checkSame(tsCompressBigint, tsDecompressBigint, pData, sizeof(int64_t) * kNumOfRows, kNumOfRows);
+  }
+  taosMemoryFree(pData);
+}
+
+TEST_F(DecompressTest, int) {
+  int64_t *pData = (int64_t *)taosMemoryMalloc(sizeof(int64_t) * kNumOfRows);
+  int32_t *pInt = (int32_t *)taosMemoryMalloc(sizeof(int32_t) * kNumOfRows);
+  for (int32_t seed = 0; seed < 16; seed++) {
+    genBigint(pData, kNumOfRows, seed);
+    for (int32_t i = 0; i < kNumOfRows; i++) pInt[i] = (int32_t)pData[i];
+    checkSame(tsCompressInt, tsDecompressInt, pInt, sizeof(int32_t) * kNumOfRows, kNumOfRows);
+  }
+  taosMemoryFree(pData);
+  taosMemoryFree(pInt);
+}
+
+TEST_F(DecompressTest, timestamp) {
+  int64_t *pData = (int64_t *)taosMemoryMalloc(sizeof(int64_t) * kNumOfRows);
+  for (int32_t seed = 0; seed < 16; seed++) {
+    genTimestamp(pData, kNumOfRows, seed);
+    checkSame(tsCompressTimestamp, tsDecompressTimestamp, pData, sizeof(int64_t) * kNumOfRows, kNumOfRows);
+  }
+  taosMemoryFree(pData);
+}
+
+TEST_F(DecompressTest, double) {
+  double *pData = (double *)taosMemoryMalloc(sizeof(double) * kNumOfRows);
+  for (int32_t seed = 0; seed < 16; seed++) {
+    genReal(pData, kNumOfRows, seed);
+    checkSame(tsCompressDouble, tsDecompressDouble, pData, sizeof(double) * kNumOfRows, kNumOfRows);
+  }
+  taosMemoryFree(pData);
+}
+
+TEST_F(DecompressTest, float) {
+  float *pData = (float *)taosMemoryMalloc(sizeof(float) * kNumOfRows);
+  for (int32_t seed = 0; seed < 16; seed++) {
+    genReal(pData, kNumOfRows, seed);
+    checkSame(tsCompressFloat, tsDecompressFloat, pData, sizeof(float) * kNumOfRows, kNumOfRows);
+  }
+  taosMemoryFree(pData);
+}
+
+#pragma GCC diagnostic pop
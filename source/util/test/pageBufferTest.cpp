@@ -1,6 +1,8 @@
 #include <gtest/gtest.h>
 #include <cassert>
 #include <iostream>
+#include <thread>
+#include <vector>
 
 #include "taos.h"
 #include "tpagedbuf.h"
@@ -157,6 +159,73 @@ void recyclePageTest() {
 
   destroyDiskbasedBuf(pBuf);
 }
+
+// every page is filled by its id, half of the pages compress well and the other half do not
+void fillPage(SFilePage* pPage, int32_t pageId, int32_t round) {
+  int32_t* p = (int32_t*)pPage->data;
+  uint32_t seed = pageId * 31 + round;
+  for (int32_t i = 0; i < 256 - 2; ++i) {
+    p[i] = (pageId % 2 == 0) ? pageId + round : (int32_t)taosRandR(&seed);
+  }
+}
+
+void checkPage(SFilePage* pPage, int32_t pageId, int32_t round) {
+  char buf[1024] = {0};
+  fillPage((SFilePage*)buf, pageId, round);
+  ASSERT_EQ(memcmp(pPage->data, ((SFilePage*)buf)->data, (256 - 2) * sizeof(int32_t)), 0);
+}
+
+void spillTest(bool comp) {
+  SDiskbasedBuf* pBuf = NULL;
+  int32_t        ret = createDiskbasedBuf(&pBuf, 1024, 4 * 1024, "1", TD_TMP_DIR_PATH);
+  ASSERT_EQ(ret, 0);
+  setBufPageCompressOnDisk(pBuf, comp);
+
+  // several write batches go to disk
+  const int32_t numOfPages = 2000;
+  for (int32_t i = 0; i < numOfPages; ++i) {
+    int32_t    pageId = 0;
+    SFilePage* pPage = static_cast<SFilePage*>(getNewBufPage(pBuf, &pageId));
+    ASSERT_EQ(pageId, i);
+    fillPage(pPage, pageId, 0);
+    setBufPageDirty(pPage, true);
+    releaseBufPage(pBuf, pPage);
+  }
+  ASSERT_FALSE(isAllDataInMemBuf(pBuf));
+
+  // update every third page, so that they are written again, maybe in another place
+  for (int32_t i = 0; i < numOfPages; i += 3) {
+    SFilePage* pPage = static_cast<SFilePage*>(getBufPage(pBuf, i));
+    ASSERT_TRUE(pPage != NULL);
+    checkPage(pPage, i, 0);
+    fillPage(pPage, i, 1);
+    setBufPageDirty(pPage, true);
+    releaseBufPage(pBuf, pPage);
+  }
+
+  // read forwards and backwards, as the pages are read ahead
+  for (int32_t i = 0; i < numOfPages; ++i) {
+    SFilePage* pPage = static_cast<SFilePage*>(getBufPage(pBuf, i));
+    ASSERT_TRUE(pPage != NULL);
+    checkPage(pPage, i, (i % 3 == 0) ? 1 : 0);
+    releaseBufPage(pBuf, pPage);
+  }
+  for (int32_t i = numOfPages - 1; i >= 0; --i) {
+    SFilePage* pPage = static_cast<SFilePage*>(getBufPage(pBuf, i));
+    ASSERT_TRUE(pPage != NULL);
+    checkPage(pPage, i, (i % 3 == 0) ? 1 : 0);
+    releaseBufPage(pBuf, pPage);
+  }
+
+  SDiskbasedBufStatis statis = getDBufStatis(pBuf);
+  if (comp) {
+    ASSERT_LT(statis.flushBytes, (int64_t)statis.flushPages * 1024);
+  } else {
+    ASSERT_EQ(statis.flushBytes, (int64_t)statis.flushPages * 1024);
+  }
+
+  destroyDiskbasedBuf(pBuf);
+}
 }  // namespace
 
 TEST(testCase, resultBufferTest) {
@@ -166,4 +235,20 @@ TEST(testCase, resultBufferTest) {
   recyclePageTest();
 }
 
+TEST(testCase, spillTest) {
+  spillTest(true);
+  spillTest(false);
+}
+
+// the buffers of concurrent queries share the threads that write their batches
+TEST(testCase, spillManyBuffersTest) {
+  std::vector<std::thread> threads;
+  for (int32_t i = 0; i < 16; ++i) {
+    threads.emplace_back(spillTest, i % 2 == 0);
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+}
+
 #pragma GCC diagnostic pop
\ No newline at end of file
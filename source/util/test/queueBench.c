@@ -0,0 +1,169 @@
+/*
+ * Copyright (c) 2019 TAOS Data, Inc. <jhtao@taosdata.com>
+ *
+ * This program is free software: you can use, redistribute, and/or modify
+ * it under the terms of the GNU Affero General Public License, version 3
+ * or later ("AGPL"), as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Throughput of a qset with one reader under 1 to 64 writer threads, in million items per second.
+// The mutex queue is the previous tqueue implementation: lock on every write and read, one post per item.
+// usage: queueBench [-n items] [-p max producers]
+
+#include "os.h"
+#include "tqueue.h"
+
+typedef struct SMutexNode {
+  struct SMutexNode *next;
+  int64_t            value;
+} SMutexNode;
+
+typedef struct {
+  TdThreadMutex mutex;
+  tsem_t        sem;
+  SMutexNode   *head;
+  SMutexNode   *tail;
+  int32_t       numOfItems;
+} SMutexQueue;
+
+typedef struct {
+  bool         lockFree;
+  int32_t      numOfItems;
+  STaosQueue  *queue;
+  SMutexQueue *mqueue;
+  TdThread     thread;
+} SProducer;
+
+static void mutexQueueWrite(SMutexQueue *mqueue, SMutexNode *pNode) {
+  pNode->next = NULL;
+  taosThreadMutexLock(&mqueue->mutex);
+  if (mqueue->tail) {
+    mqueue->tail->next = pNode;
+  } else {
+    mqueue->head = pNode;
+  }
+  mqueue->tail = pNode;
+  mqueue->numOfItems++;
+  taosThreadMutexUnlock(&mqueue->mutex);
+  tsem_post(&mqueue->sem);
+}
+
+static SMutexNode *mutexQueueRead(SMutexQueue *mqueue) {
+  tsem_wait(&mqueue->sem);
+  taosThreadMutexLock(&mqueue->mutex);
+  SMutexNode *pNode = mqueue->head;
+  if (pNode) {
+    mqueue->head = pNode->next;
+    if (mqueue->head == NULL) mqueue->tail = NULL;
+    mqueue->numOfItems--;
+  }
+  taosThreadMutexUnlock(&mqueue->mutex);
+  return pNode;
+}
+
+static void *producerFp(void *param) {
+  SProducer *pProducer = param;
+  for (int32_t i = 0; i < pProducer->numOfItems; i++) {
+    if (pProducer->lockFree) {
+      int64_t *pItem = taosAllocateQitem(sizeof(int64_t), DEF_QITEM, 0);
+      *pItem = i;
+      taosWriteQitem(pProducer->queue, pItem);
+    } else {
+      SMutexNode *pNode = taosMemoryMalloc(sizeof(SMutexNode));
+      pNode->value = i;
+      mutexQueueWrite(pProducer->mqueue, pNode);
+    }
+  }
+  return NULL;
+}
+
+static double benchOne(bool lockFree, int32_t numOfProducers, int32_t numOfItems) {
+  SMutexQueue mqueue = {0};
+  STaosQset  *qset = NULL;
+  STaosQueue *queue = NULL;
+
+  if (lockFree) {
+    qset = taosOpenQset();
+    queue = taosOpenQueue();
+    taosAddIntoQset(qset, queue, NULL);
+  } else {
+    taosThreadMutexInit(&mqueue.mutex, NULL);
+    tsem_init(&mqueue.sem, 0, 0);
+  }
+
+  SProducer *producers = taosMemoryCalloc(numOfProducers, sizeof(SProducer));
+  int32_t    itemsPerProducer = numOfItems / numOfProducers;
+  int32_t    total = itemsPerProducer * numOfProducers;
+
+  int64_t st = taosGetTimestampUs();
+  for (int32_t i = 0; i < numOfProducers; i++) {
+    SProducer *pProducer = &producers[i];
+    pProducer->lockFree = lockFree;
+    pProducer->numOfItems = itemsPerProducer;
+    pProducer->queue = queue;
+    pProducer->mqueue = &mqueue;
+    taosThreadCreate(&pProducer->thread, NULL, producerFp, pProducer);
+  }
+
+  // the calling thread is the single consumer
+  for (int32_t read = 0; read < total; read++) {
+    if (lockFree) {
+      void      *pItem = NULL;
+      SQueueInfo qinfo = {0};
+      taosReadQitemFromQset(qset, &pItem, &qinfo);
+      taosUpdateItemSize(queue, 1);
+      taosFreeQitem(pItem);
+    } else {
+      taosMemoryFree(mutexQueueRead(&mqueue));
+    }
+  }
+  int64_t cost = taosGetTimestampUs() - st;
+
+  for (int32_t i = 0; i < numOfProducers; i++) {
+    taosThreadJoin(producers[i].thread, NULL);
+  }
+  taosMemoryFree(producers);
+
+  if (lockFree) {
+    taosCloseQueue(queue);
+    taosCloseQset(qset);
+  } else {
+    taosThreadMutexDestroy(&mqueue.mutex);
+    tsem_destroy(&mqueue.sem);
+  }
+
+  if (cost <= 0) cost = 1;
+  return (double)total / cost;
+}
+
+int main(int argc, char *argv[]) {
+  int32_t numOfItems = 2000000;
+  int32_t maxProducers = 64;
+  for (int32_t i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "-n") == 0 && i < argc - 1) {
+      numOfItems = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-p") == 0 && i < argc - 1) {
+      maxProducers = atoi(argv[++i]);
+    } else {
+      printf("usage: %s [-n items] [-p max producers]\n", argv[0]);
+      return 0;
+    }
+  }
+
+  printf("items:%d\n", numOfItems);
+  printf("%-10s %12s %12s\n", "producers", "mutex M/s", "mpsc M/s");
+  for (int32_t p = 1; p <= maxProducers; p *= 2) {
+    double mutex = benchOne(false, p, numOfItems);
+    double mpsc = benchOne(true, p, numOfItems);
+    printf("%-10d %12.2f %12.2f\n", p, mutex, mpsc);
+  }
+
+  return 0;
+}
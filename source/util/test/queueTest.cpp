@@ -0,0 +1,128 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "tqueue.h"
+
+namespace {
+
+const int32_t kProducers = 8;
+const int32_t kItemsPerProducer = 20000;
+
+struct SItem {
+  int32_t producer;
+  int32_t seq;
+};
+
+void produce(STaosQueue *queue, int32_t producer) {
+  for (int32_t i = 0; i < kItemsPerProducer; i++) {
+    SItem *pItem = (SItem *)taosAllocateQitem(sizeof(SItem), DEF_QITEM, 0);
+    pItem->producer = producer;
+    pItem->seq = i;
+    taosWriteQitem(queue, pItem);
+  }
+}
+
+// items of one producer come out in the order they were written
+void checkItem(std::vector<int32_t> &next, SItem *pItem) {
+  ASSERT_EQ(pItem->seq, next[pItem->producer]);
+  next[pItem->producer]++;
+}
+
+}  // namespace
+
+TEST(queueTest, read_one_by_one) {
+  STaosQueue *queue = taosOpenQueue();
+  ASSERT_NE(queue, nullptr);
+  ASSERT_TRUE(taosQueueEmpty(queue));
+
+  std::vector<std::thread> producers;
+  for (int32_t p = 0; p < kProducers; p++) producers.emplace_back(produce, queue, p);
+
+  std::vector<int32_t> next(kProducers, 0);
+  int32_t              total = 0;
+  while (total < kProducers * kItemsPerProducer) {
+    void *pItem = NULL;
+    if (taosReadQitem(queue, &pItem) == 0) continue;
+    checkItem(next, (SItem *)pItem);
+    taosFreeQitem(pItem);
+    total++;
+  }
+
+  for (auto &t : producers) t.join();
+  ASSERT_TRUE(taosQueueEmpty(queue));
+  ASSERT_EQ(taosQueueItemSize(queue), 0);
+  ASSERT_EQ(taosQueueMemorySize(queue), 0);
+  taosCloseQueue(queue);
+}
+
+TEST(queueTest, read_all) {
+  STaosQueue *queue = taosOpenQueue();
+  STaosQall  *qall = taosAllocateQall();
+
+  std::vector<std::thread> producers;
+  for (int32_t p = 0; p < kProducers; p++) producers.emplace_back(produce, queue, p);
+
+  std::vector<int32_t> next(kProducers, 0);
+  int32_t              total = 0;
+  while (total < kProducers * kItemsPerProducer) {
+    int32_t num = taosReadAllQitems(queue, qall);
+    ASSERT_EQ(taosQallItemSize(qall), num);
+    for (int32_t i = 0; i < num; i++) {
+      void *pItem = NULL;
+      ASSERT_EQ(taosGetQitem(qall, &pItem), 1);
+      checkItem(next, (SItem *)pItem);
+      taosFreeQitem(pItem);
+    }
+    total += num;
+  }
+
+  for (auto &t : producers) t.join();
+  ASSERT_TRUE(taosQueueEmpty(queue));
+  taosFreeQall(qall);
+  taosCloseQueue(queue);
+}
+
+TEST(queueTest, qset_readers) {
+  const int32_t kQueues = 4;
+  const int32_t kReaders = 3;
+
+  STaosQset  *qset = taosOpenQset();
+  STaosQueue *queues[kQueues];
+  for (int32_t q = 0; q < kQueues; q++) {
+    queues[q] = taosOpenQueue();
+    ASSERT_EQ(taosAddIntoQset(qset, queues[q], NULL), 0);
+  }
+
+  std::atomic<int32_t>     consumed(0);
+  std::vector<std::thread> readers;
+  for (int32_t r = 0; r < kReaders; r++) {
+    readers.emplace_back([&]() {
+      while (1) {
+        void      *pItem = NULL;
+        SQueueInfo qinfo = {0};
+        if (taosReadQitemFromQset(qset, &pItem, &qinfo) == 0) break;
+        taosFreeQitem(pItem);
+        taosUpdateItemSize((STaosQueue *)qinfo.queue, 1);
+        consumed++;
+      }
+    });
+  }
+
+  std::vector<std::thread> producers;
+  for (int32_t p = 0; p < kProducers; p++) producers.emplace_back(produce, queues[p % kQueues], p);
+  for (auto &t : producers) t.join();
+
+  // readers drain the queues before they honour the resume
+  for (int32_t r = 0; r < kReaders; r++) taosQsetThreadResume(qset);
+  for (auto &t : readers) t.join();
+
+  ASSERT_EQ(consumed.load(), kProducers * kItemsPerProducer);
+  for (int32_t q = 0; q < kQueues; q++) {
+    ASSERT_TRUE(taosQueueEmpty(queues[q]));
+    taosCloseQueue(queues[q]);
+  }
+  taosCloseQset(qset);
+}
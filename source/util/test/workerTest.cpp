@@ -0,0 +1,113 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+
+#include "tworker.h"
+
+namespace {
+
+struct SJob {
+  int32_t lane;
+  int64_t affinity;
+  int32_t sleepMs;
+  int64_t doneTs;
+};
+
+std::atomic<int32_t> numOfDone(0);
+
+int32_t jobLane(void *pItem, int64_t *affinity) {
+  SJob *pJob = (SJob *)pItem;
+  *affinity = pJob->affinity;
+  return pJob->lane;
+}
+
+void processJob(SQueueInfo *pInfo, void *pItem) {
+  SJob *pJob = (SJob *)pItem;
+  if (pJob->sleepMs > 0) taosMsleep(pJob->sleepMs);
+  pJob->doneTs = taosGetTimestampMs();
+  numOfDone++;
+}
+
+SJob *newJob(int32_t lane, int64_t affinity, int32_t sleepMs) {
+  SJob *pJob = (SJob *)taosAllocateQitem(sizeof(SJob), DEF_QITEM, 0);
+  pJob->lane = lane;
+  pJob->affinity = affinity;
+  pJob->sleepMs = sleepMs;
+  pJob->doneTs = 0;
+  return pJob;
+}
+
+}  // namespace
+
+TEST(workerTest, lanes_and_stealing) {
+  SQWorkerPool pool = {0};
+  pool.name = "test-query";
+  pool.min = 4;
+  pool.max = 4;
+  pool.laneFp = jobLane;
+  ASSERT_EQ(tQWorkerInit(&pool), 0);
+
+  STaosQueue *queue = tQWorkerAllocQueue(&pool, NULL, processJob);
+  ASSERT_NE(queue, nullptr);
+
+  // heavy low lane jobs of one query, they all prefer the same worker
+  const int32_t kHeavy = 3;
+  const int32_t kLight = 200;
+  SJob         *heavy[kHeavy];
+  SJob         *light[kLight];
+  numOfDone = 0;
+
+  int64_t start = taosGetTimestampMs();
+  for (int32_t i = 0; i < kHeavy; i++) {
+    heavy[i] = newJob(QWORKER_LANE_LOW, 1, 300);
+    taosWriteQitem(queue, heavy[i]);
+  }
+  for (int32_t i = 0; i < kLight; i++) {
+    light[i] = newJob(QWORKER_LANE_HIGH, i + 2, 0);
+    taosWriteQitem(queue, light[i]);
+  }
+
+  while (numOfDone < kHeavy + kLight) taosMsleep(5);
+  ASSERT_TRUE(taosQueueEmpty(queue));
+
+  // the short jobs never wait behind all the heavy ones, and the heavy ones are spread by stealing
+  for (int32_t i = 0; i < kLight; i++) {
+    ASSERT_LT(light[i]->doneTs - start, 300 * kHeavy);
+  }
+  int64_t lastHeavy = 0;
+  for (int32_t i = 0; i < kHeavy; i++) lastHeavy = TMAX(lastHeavy, heavy[i]->doneTs);
+  ASSERT_LT(lastHeavy - start, 300 * kHeavy);
+
+  for (int32_t i = 0; i < kHeavy; i++) taosFreeQitem(heavy[i]);
+  for (int32_t i = 0; i < kLight; i++) taosFreeQitem(light[i]);
+
+  tQWorkerFreeQueue(&pool, queue);
+  tQWorkerCleanup(&pool);
+}
+
+TEST(workerTest, no_lane_function) {
+  SQWorkerPool pool = {0};
+  pool.name = "test-plain";
+  pool.min = 2;
+  pool.max = 2;
+  ASSERT_EQ(tQWorkerInit(&pool), 0);
+
+  STaosQueue *queue = tQWorkerAllocQueue(&pool, NULL, processJob);
+  ASSERT_NE(queue, nullptr);
+
+  const int32_t kJobs = 10000;
+  SJob        **jobs = (SJob **)taosMemoryCalloc(kJobs, sizeof(SJob *));
+  numOfDone = 0;
+  for (int32_t i = 0; i < kJobs; i++) {
+    jobs[i] = newJob(0, 0, 0);
+    taosWriteQitem(queue, jobs[i]);
+  }
+
+  while (numOfDone < kJobs) taosMsleep(5);
+  ASSERT_TRUE(taosQueueEmpty(queue));
+  for (int32_t i = 0; i < kJobs; i++) taosFreeQitem(jobs[i]);
+  taosMemoryFree(jobs);
+
+  tQWorkerFreeQueue(&pool, queue);
+  tQWorkerCleanup(&pool);
+}